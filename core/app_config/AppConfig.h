@@ -546,10 +546,12 @@ public:
     friend class BatcherUnittest;
     friend class EnterpriseSLSClientManagerUnittest;
     friend class FlusherRunnerUnittest;
+    friend class FlusherRunnerBenchmark;
     friend class PipelineUpdateUnittest;
     friend class ProcessorTagNativeUnittest;
     friend class EnterpriseConfigProviderUnittest;
     friend class PollingPreservedDirDepthUnittest;
+    friend class CheckpointManagerUnittest;
     friend class InputStaticFileUnittest;
     friend class LogInputReaderUnittest;
 #endif
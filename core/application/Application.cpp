@@ -34,6 +34,7 @@
 #include "common/TimeKeeper.h"
 #include "common/TimeUtil.h"
 #include "common/UUIDUtil.h"
+#include "common/dns/DNSCache.h"
 #include "common/version.h"
 #include "config/ConfigDiff.h"
 #include "config/InstanceConfigManager.h"
@@ -78,6 +79,10 @@ DEFINE_FLAG_INT32(tcmalloc_release_memory_interval, "force release memory held b
 DEFINE_FLAG_INT32(exit_flushout_duration, "exit process flushout duration", 20 * 1000);
 DEFINE_FLAG_INT32(queue_check_gc_interval_sec, "30s", 30);
 DEFINE_FLAG_INT32(config_server_lost_connection_timeout, "config server lost connection timeout, seconds", 3600);
+DEFINE_FLAG_INT32(container_event_min_apply_interval,
+                  "min interval between two applies of container changes found by runtime events, which pause the "
+                  "file server, seconds",
+                  3);
 #if defined(__ENTERPRISE__) && defined(__linux__) && !defined(__ANDROID__)
 DEFINE_FLAG_BOOL(enable_cgroup, "", false);
 #endif
@@ -305,7 +310,8 @@ void Application::Start() { // GCOVR_EXCL_START
     OnetimeConfigInfoManager::GetInstance()->LoadCheckpointFile();
 
     time_t curTime = 0, lastOnetimeConfigTimeoutCheckTime = 0, lastConfigCheckTime = 0, lastUpdateMetricTime = 0,
-           lastCheckTagsTime = 0, lastQueueGCTime = 0, lastCheckUnusedCheckpointsTime = 0, lastContainerCheckTime = 0;
+           lastCheckTagsTime = 0, lastQueueGCTime = 0, lastCheckUnusedCheckpointsTime = 0, lastContainerCheckTime = 0,
+           lastContainerApplyTime = 0;
     while (true) {
         curTime = time(NULL);
         if (curTime - lastCheckTagsTime >= INT32_FLAG(file_tags_update_interval)) {
@@ -379,10 +385,15 @@ void Application::Start() { // GCOVR_EXCL_START
         // 过渡使用
         EventDispatcher::GetInstance()->DumpCheckPointPeriod(curTime);
 
-        if (curTime - lastContainerCheckTime >= 3) {
+        // changes of runtime events are applied at once after a quiet period, while bursts of events are coalesced so
+        // that the file server is not paused more often than by the periodic check
+        bool hasEventDrivenChanges = ContainerManager::GetInstance()->HasEventDrivenChanges()
+            && curTime - lastContainerApplyTime >= INT32_FLAG(container_event_min_apply_interval);
+        if (curTime - lastContainerCheckTime >= 3 || hasEventDrivenChanges) {
             if (ContainerManager::GetInstance()->CheckContainerDiffForAllConfig()) {
                 FileServer::GetInstance()->Pause();
                 FileServer::GetInstance()->Resume(false, true);
+                lastContainerApplyTime = curTime;
             }
             lastContainerCheckTime = curTime;
         }
@@ -441,6 +452,7 @@ void Application::Exit() {
     ContainerManager::GetInstance()->Stop();
     FlusherRunner::GetInstance()->Stop();
     HttpSink::GetInstance()->Stop();
+    DnsCache::GetInstance()->Stop();
 
     // TODO: make it common
     FlusherSLS::RecycleResourceIfNotUsed();
@@ -352,7 +352,9 @@ bool CollectionPipeline::Init(CollectionConfig&& config) {
 
         vector<BoundedSenderQueueInterface*> senderQueues;
         for (const auto& flusher : mFlushers) {
-            senderQueues.push_back(SenderQueueManager::GetInstance()->GetQueue(flusher->GetQueueKey()));
+            for (auto key : flusher->GetQueueKeys()) {
+                senderQueues.push_back(SenderQueueManager::GetInstance()->GetQueue(key));
+            }
         }
         ProcessQueueManager::GetInstance()->SetDownStreamQueues(mContext.GetProcessQueueKey(), std::move(senderQueues));
     }
@@ -21,6 +21,7 @@
 #include <shared_mutex>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "common/http/AsynCurlRunner.h"
 #include "common/timer/Timer.h"
@@ -43,7 +44,8 @@ static shared_ptr<CollectionPipeline> sEmptyPipeline;
 void CollectionPipelineManager::UpdatePipelines(CollectionConfigDiff& diff) {
     // 过渡使用
     static bool isFileServerStarted = false;
-    bool isFileServerInputChanged = CheckIfFileServerUpdated(diff);
+    unordered_set<string> fileServerConfigNames;
+    bool isFileServerInputChanged = CheckIfFileServerUpdated(diff, fileServerConfigNames);
 
 #ifndef APSARA_UNIT_TEST_MAIN
 #if defined(__ENTERPRISE__) && defined(__linux__) && !defined(__ANDROID__)
@@ -53,7 +55,7 @@ void CollectionPipelineManager::UpdatePipelines(CollectionConfigDiff& diff) {
 #endif
 #endif
     if (isFileServerStarted && isFileServerInputChanged) {
-        FileServer::GetInstance()->Pause();
+        FileServer::GetInstance()->PauseForConfigUpdate(fileServerConfigNames);
     }
     // other threads only read mPipelineNameEntityMap, so we don't need to lock read here
     for (const auto& name : diff.mRemoved) {
@@ -149,7 +151,7 @@ void CollectionPipelineManager::UpdatePipelines(CollectionConfigDiff& diff) {
 
     if (isFileServerInputChanged) {
         if (isFileServerStarted) {
-            FileServer::GetInstance()->Resume(true, false);
+            FileServer::GetInstance()->ResumeForConfigUpdate(fileServerConfigNames);
         } else {
             FileServer::GetInstance()->Start();
             isFileServerStarted = true;
@@ -242,45 +244,49 @@ void CollectionPipelineManager::FlushAllBatch() {
     }
 }
 
-bool CollectionPipelineManager::CheckIfFileServerUpdated(CollectionConfigDiff& diff) {
+bool CollectionPipelineManager::CheckIfFileServerUpdated(CollectionConfigDiff& diff,
+                                                         unordered_set<string>& configNames) {
     // private method, no need to lock mPipelineNameEntityMapMutex
+    auto isFileInput = [](const string& inputType) {
+        return inputType == "input_file" || inputType == "input_container_stdio";
+    };
     for (const auto& name : diff.mRemoved) {
         auto pipeline = mPipelineNameEntityMap[name];
         if (pipeline) {
             auto inputs = pipeline->GetConfig()["inputs"];
             for (const auto& input : inputs) {
-                string inputType = input["Type"].asString();
-                if (inputType == "input_file" || inputType == "input_container_stdio") {
-                    return true;
+                if (isFileInput(input["Type"].asString())) {
+                    configNames.insert(name);
+                    break;
                 }
             }
         }
     }
     for (const auto& config : diff.mModified) {
-        string inputType = (*config.mInputs[0])["Type"].asString();
-        if (inputType == "input_file" || inputType == "input_container_stdio") {
-            return true;
+        if (isFileInput((*config.mInputs[0])["Type"].asString())) {
+            configNames.insert(config.mName);
+            continue;
         }
         auto oldPipeline = mPipelineNameEntityMap[config.mName];
         if (oldPipeline) {
             const Json::Value& oldInputs = oldPipeline->GetConfig()["inputs"];
             for (const auto& oldInput : oldInputs) {
-                string oldInputType = oldInput["Type"].asString();
-                if (oldInputType == "input_file" || oldInputType == "input_container_stdio") {
-                    return true;
+                if (isFileInput(oldInput["Type"].asString())) {
+                    configNames.insert(config.mName);
+                    break;
                 }
             }
         }
     }
     for (const auto& config : diff.mAdded) {
         for (const auto& input : config.mInputs) {
-            string inputType = (*input)["Type"].asString();
-            if (inputType == "input_file" || inputType == "input_container_stdio") {
-                return true;
+            if (isFileInput((*input)["Type"].asString())) {
+                configNames.insert(config.mName);
+                break;
             }
         }
     }
-    return false;
+    return !configNames.empty();
 }
 
 } // namespace logtail
@@ -22,6 +22,7 @@
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "collection_pipeline/CollectionPipeline.h"
@@ -66,7 +67,8 @@ private:
     virtual std::shared_ptr<CollectionPipeline> BuildPipeline(CollectionConfig&& config); // virtual for ut
     void FlushAllBatch();
     // TODO: 长期过渡使用
-    bool CheckIfFileServerUpdated(CollectionConfigDiff& diff);
+    // configNames: names of all file configs in the diff, used by per config file server reload
+    bool CheckIfFileServerUpdated(CollectionConfigDiff& diff, std::unordered_set<std::string>& configNames);
 
     mutable std::shared_mutex mPipelineNameEntityMapMutex;
     std::unordered_map<std::string, std::shared_ptr<CollectionPipeline>> mPipelineNameEntityMap;
@@ -30,6 +30,8 @@
 #include "plugin/creator/StaticProcessorCreator.h"
 #include "plugin/flusher/blackhole/FlusherBlackHole.h"
 #include "plugin/flusher/file/FlusherFile.h"
+#include "plugin/flusher/otlp/FlusherOTLP.h"
+#include "plugin/flusher/prometheus/FlusherPrometheus.h"
 #include "plugin/flusher/sls/FlusherSLS.h"
 #include "plugin/input/InputContainerStdio.h"
 #include "plugin/input/InputFile.h"
@@ -207,6 +209,8 @@ void PluginRegistry::LoadStaticPlugins() {
     RegisterFlusherCreator(new StaticFlusherCreator<FlusherSLS>());
     RegisterFlusherCreator(new StaticFlusherCreator<FlusherBlackHole>());
     RegisterFlusherCreator(new StaticFlusherCreator<FlusherFile>());
+    RegisterFlusherCreator(new StaticFlusherCreator<FlusherOTLP>());
+    RegisterFlusherCreator(new StaticFlusherCreator<FlusherPrometheus>());
 #if defined(__linux__) && !defined(__ENTERPRISE__)
     RegisterFlusherCreator(new StaticFlusherCreator<FlusherKafka>());
 #endif
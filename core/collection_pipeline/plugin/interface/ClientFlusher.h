@@ -0,0 +1,37 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "collection_pipeline/plugin/interface/Flusher.h"
+#include "collection_pipeline/queue/SenderQueueItem.h"
+
+namespace logtail {
+
+// A flusher sending the items of its sender queue through a client of its own (e.g. a kafka producer) instead of a
+// shared sink. Items are handed to it by the flusher runner, and it removes them from the queue (or sets them back
+// to idle for retry) once the client reports they are done.
+class ClientFlusher : public Flusher {
+public:
+    virtual ~ClientFlusher() = default;
+
+    // Returns false if @item is not sent, in which case it is already handled.
+    virtual bool SendItem(SenderQueueItem* item) = 0;
+
+    virtual SinkType GetSinkType() override { return SinkType::CLIENT; }
+};
+
+} // namespace logtail
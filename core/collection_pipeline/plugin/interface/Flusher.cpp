@@ -30,19 +30,19 @@ bool Flusher::Start() {
 
 bool Flusher::Stop(bool isPipelineRemoving) {
     // TODO: temporarily used here
-    SetPipelineForItemsWhenStop();
+    SetPipelineForItemsWhenStop(mQueueKey);
     SenderQueueManager::GetInstance()->DeleteQueue(mQueueKey);
     return true;
 }
 
-void Flusher::SetPipelineForItemsWhenStop() {
+void Flusher::SetPipelineForItemsWhenStop(QueueKey key) {
     if (HasContext()) {
         const auto& pipeline = CollectionPipelineManager::GetInstance()->FindConfigByName(mContext->GetConfigName());
         if (!pipeline) {
             LOG_ERROR(sLogger, ("failed to get pipeline context", "context not found")("action", "not set pipeline"));
             return;
         }
-        SenderQueueManager::GetInstance()->SetPipelineForItems(mQueueKey, pipeline);
+        SenderQueueManager::GetInstance()->SetPipelineForItems(key, pipeline);
     }
 }
 
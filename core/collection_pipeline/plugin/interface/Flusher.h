@@ -19,6 +19,7 @@
 #include <cstdint>
 
 #include <memory>
+#include <vector>
 
 #include "json/json.h"
 
@@ -44,6 +45,8 @@ public:
     virtual SinkType GetSinkType() { return SinkType::NONE; }
 
     QueueKey GetQueueKey() const { return mQueueKey; }
+    // all sender queues the flusher pushes to, which should be checked before events are sent to the flusher
+    virtual std::vector<QueueKey> GetQueueKeys() const { return {mQueueKey}; }
     void SetPluginID(const std::string& pluginID) { mPluginID = pluginID; }
     size_t GetFlusherIndex() { return mIndex; }
     void SetFlusherIndex(size_t idx) { mIndex = idx; }
@@ -53,7 +56,7 @@ protected:
     void GenerateQueueKey(const std::string& target);
     bool PushToQueue(std::unique_ptr<SenderQueueItem>&& item, uint32_t retryTimes = 500);
     void DealSenderQueueItemAfterSend(SenderQueueItem* item, bool keep);
-    void SetPipelineForItemsWhenStop();
+    void SetPipelineForItemsWhenStop(QueueKey key);
 
     QueueKey mQueueKey;
     std::string mPluginID;
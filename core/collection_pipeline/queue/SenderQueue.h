@@ -60,6 +60,7 @@ private:
     friend class SenderQueueUnittest;
     friend class SenderQueueManagerUnittest;
     friend class FlusherUnittest;
+    friend class FlusherKafkaUnittest;
 #endif
 };
 
@@ -151,11 +151,16 @@ bool SenderQueueManager::RemoveItem(QueueKey key, SenderQueueItem* item) {
 }
 
 void SenderQueueManager::DecreaseConcurrencyLimiterInSendingCnt(QueueKey key) {
-    lock_guard<mutex> lock(mQueueMux);
-    auto iter = mQueues.find(key);
-    if (iter != mQueues.end()) {
+    {
+        lock_guard<mutex> lock(mQueueMux);
+        auto iter = mQueues.find(key);
+        if (iter == mQueues.end()) {
+            return;
+        }
         iter->second.DecreaseSendingCnt();
     }
+    // items of the queue may have been held back by the concurrency limiter, which are available now
+    Trigger();
 }
 
 bool SenderQueueManager::IsAllQueueEmpty() const {
@@ -209,7 +214,7 @@ bool SenderQueueManager::IsValidToPush(QueueKey key) const {
 }
 
 bool SenderQueueManager::Wait(uint64_t ms) {
-    // TODO: use semaphore instead
+    // mValidToPop works as a binary semaphore, so that a trigger before waiting is not lost
     unique_lock<mutex> lock(mStateMux);
     mCond.wait_for(lock, chrono::milliseconds(ms), [this] { return mValidToPop; });
     if (mValidToPop) {
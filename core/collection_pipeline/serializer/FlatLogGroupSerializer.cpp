@@ -0,0 +1,140 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "collection_pipeline/serializer/FlatLogGroupSerializer.h"
+
+#include <cstring>
+
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "constants/TagConstants.h"
+#include "protobuf/sls/LogGroupSerializer.h"
+
+DECLARE_FLAG_INT32(max_send_log_group_size);
+
+using namespace std;
+
+namespace logtail {
+
+namespace {
+
+class FlatLogGroupWriter {
+public:
+    FlatLogGroupWriter(char* buf, size_t strOffset) : mBuf(buf), mStrOffset(strOffset) {}
+
+    void PackUint32(uint32_t v) {
+        mBuf[mCur++] = static_cast<char>(v);
+        mBuf[mCur++] = static_cast<char>(v >> 8);
+        mBuf[mCur++] = static_cast<char>(v >> 16);
+        mBuf[mCur++] = static_cast<char>(v >> 24);
+    }
+
+    void PackString(StringView s) {
+        PackUint32(static_cast<uint32_t>(mStrOffset));
+        PackUint32(static_cast<uint32_t>(s.size()));
+        if (!s.empty()) {
+            memcpy(mBuf + mStrOffset, s.data(), s.size());
+            mStrOffset += s.size();
+        }
+    }
+
+private:
+    char* mBuf = nullptr;
+    size_t mCur = 0;
+    size_t mStrOffset = 0;
+};
+
+} // namespace
+
+bool SerializeFlatLogGroup(const PipelineEventGroup& group,
+                           bool enableNanosecond,
+                           const string& logstore,
+                           string& res,
+                           string& errorMsg) {
+    const auto& events = group.GetEvents();
+    // the size limit applies to the protobuf log group the data used to be serialized to, the flat layout is larger
+    size_t contentCnt = 0, tagCnt = 0, strSize = logstore.size(), pbSize = GetStringSize(logstore.size());
+    for (const auto& e : events) {
+        if (!e.Is<LogEvent>()) {
+            errorMsg = "unsupported event type in event group";
+            return false;
+        }
+        const auto& logEvent = e.Cast<LogEvent>();
+        size_t contentSZ = 0, logSZ = 0;
+        for (const auto& kv : logEvent) {
+            ++contentCnt;
+            strSize += kv.first.size() + kv.second.size();
+            contentSZ += GetLogContentSize(kv.first.size(), kv.second.size());
+        }
+        pbSize += GetLogSize(contentSZ, enableNanosecond && logEvent.GetTimestampNanosecond(), logSZ);
+    }
+    StringView topic;
+    for (const auto& tag : group.GetTags()) {
+        if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+            topic = tag.second;
+            strSize += topic.size();
+            pbSize += GetStringSize(topic.size());
+        } else {
+            ++tagCnt;
+            strSize += tag.first.size() + tag.second.size();
+            pbSize += GetLogTagSize(tag.first.size(), tag.second.size());
+        }
+    }
+    if (pbSize > static_cast<size_t>(INT32_FLAG(max_send_log_group_size))) {
+        errorMsg = "log group exceeds size limit\tgroup size: " + ToString(pbSize)
+            + "\tsize limit: " + ToString(INT32_FLAG(max_send_log_group_size));
+        return false;
+    }
+    size_t strOffset = kFlatLogGroupHeaderSize + events.size() * kFlatLogSize + (contentCnt + tagCnt) * kFlatFieldSize;
+    size_t size = strOffset + strSize;
+
+    res.resize(size);
+    FlatLogGroupWriter writer(&res[0], strOffset);
+    writer.PackUint32(kFlatLogGroupMagic);
+    writer.PackUint32(static_cast<uint32_t>(events.size()));
+    writer.PackUint32(static_cast<uint32_t>(contentCnt));
+    writer.PackUint32(static_cast<uint32_t>(tagCnt));
+    writer.PackString(StringView(logstore));
+    writer.PackString(topic);
+    writer.PackUint32(0);
+    for (const auto& e : events) {
+        const auto& logEvent = e.Cast<LogEvent>();
+        writer.PackUint32(static_cast<uint32_t>(logEvent.GetTimestamp()));
+        if (enableNanosecond && logEvent.GetTimestampNanosecond()) {
+            writer.PackUint32(logEvent.GetTimestampNanosecond().value());
+            writer.PackUint32(kFlatLogFlagTimeNs);
+        } else {
+            writer.PackUint32(0);
+            writer.PackUint32(0);
+        }
+        writer.PackUint32(static_cast<uint32_t>(logEvent.Size()));
+    }
+    for (const auto& e : events) {
+        for (const auto& kv : e.Cast<LogEvent>()) {
+            writer.PackString(kv.first);
+            writer.PackString(kv.second);
+        }
+    }
+    for (const auto& tag : group.GetTags()) {
+        if (tag.first != LOG_RESERVED_KEY_TOPIC) {
+            writer.PackString(tag.first);
+            writer.PackString(tag.second);
+        }
+    }
+    return true;
+}
+
+} // namespace logtail
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+
+#include "models/PipelineEventGroup.h"
+
+namespace logtail {
+
+// Flat layout of a group of log events handed over to the Go pipeline, decoded by protocol.DecodeFlatLogGroup in Go.
+// All integers are little-endian uint32. Each string is an (offset, length) pair, where offset is relative to the
+// start of the buffer and points into the string area at the end, so that the Go side can slice every field out of a
+// single copy of the buffer instead of allocating one string per field.
+//
+//   header:   magic, log count, content count, tag count, category, topic, reserved
+//   logs:     log count * (time, time ns, flags, content count)
+//   contents: content count * (key, value), contents of each log following those of the previous log
+//   tags:     tag count * (key, value)
+//   strings
+const uint32_t kFlatLogGroupMagic = 0x31474C46; // "FLG1"
+const size_t kFlatLogGroupHeaderSize = 36;
+const size_t kFlatLogSize = 16;
+const size_t kFlatFieldSize = 16;
+const uint32_t kFlatLogFlagTimeNs = 1;
+
+bool SerializeFlatLogGroup(const PipelineEventGroup& group,
+                           bool enableNanosecond,
+                           const std::string& logstore,
+                           std::string& res,
+                           std::string& errorMsg);
+
+} // namespace logtail
@@ -26,20 +26,52 @@ using namespace std;
 
 namespace logtail {
 
-// Helper function to serialize common fields (tags and time)
+// Helper function to serialize common fields except tags, which are encoded once for the group
 template <typename WriterType>
-void SerializeCommonFields(const SizedMap& tags, uint64_t timestamp, WriterType& writer) {
-    // Serialize tags
-    for (const auto& tag : tags.mInner) {
-        writer.Key(tag.first.to_string().c_str());
-        writer.String(tag.second.to_string().c_str());
-    }
+void SerializeCommonFields(uint64_t timestamp, WriterType& writer) {
     // Serialize time
     writer.Key("__time__");
     writer.Uint64(timestamp);
 }
 
+bool JsonEventGroupSerializer::DoSerializeEach(const BatchedEvents& group,
+                                               string& res,
+                                               vector<size_t>& offsets,
+                                               string& errorMsg) {
+    auto inputSize = GetInputSize(group);
+    ADD_COUNTER(mInItemsTotal, 1);
+    ADD_COUNTER(mInItemSizeBytes, inputSize);
+
+    auto before = std::chrono::system_clock::now();
+    size_t beginSize = res.size();
+    auto ok = SerializeEach(group, res, offsets, errorMsg);
+    ADD_COUNTER(mTotalProcessMs, std::chrono::system_clock::now() - before);
+
+    if (ok) {
+        ADD_COUNTER(mOutItemsTotal, 1);
+        ADD_COUNTER(mOutItemSizeBytes, res.size() - beginSize);
+    } else {
+        ADD_COUNTER(mDiscardedItemsTotal, 1);
+        ADD_COUNTER(mDiscardedItemSizeBytes, inputSize);
+    }
+    return ok;
+}
+
 bool JsonEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, string& errorMsg) {
+    return SerializeEvents(group, res, nullptr, errorMsg);
+}
+
+bool JsonEventGroupSerializer::SerializeEach(const BatchedEvents& group,
+                                             string& res,
+                                             vector<size_t>& offsets,
+                                             string& errorMsg) {
+    return SerializeEvents(group, res, &offsets, errorMsg);
+}
+
+bool JsonEventGroupSerializer::SerializeEvents(const BatchedEvents& group,
+                                               string& res,
+                                               vector<size_t>* offsets,
+                                               string& errorMsg) const {
     if (group.mEvents.empty()) {
         errorMsg = "empty event group";
         return false;
@@ -60,39 +92,64 @@ bool JsonEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, str
         writer.Reset(jsonBuffer);
     };
 
+    // tags are the same for all events, so they are encoded once, as the beginning of each object
+    writer.StartObject();
+    for (const auto& tag : group.mTags.mInner) {
+        writer.Key(tag.first.to_string().c_str());
+        writer.String(tag.second.to_string().c_str());
+    }
+    string tagsPrefix(jsonBuffer.GetString(), jsonBuffer.GetSize());
+    if (!group.mTags.mInner.empty()) {
+        tagsPrefix.append(",");
+    }
+    size_t beginSize = res.size();
+    size_t offsetsBegin = 0;
+    if (offsets != nullptr) {
+        offsetsBegin = offsets->size();
+        offsets->resize(offsetsBegin + group.mEvents.size(), string::npos);
+    }
+    // appends the object serialized in jsonBuffer, which starts after '{', as the line of the i-th event
+    auto appendLine = [&](size_t i) {
+        res.append(tagsPrefix);
+        res.append(jsonBuffer.GetString() + 1, jsonBuffer.GetSize() - 1);
+        res.append("\n");
+        if (offsets != nullptr) {
+            (*offsets)[offsetsBegin + i] = res.size();
+        }
+    };
+
     // TODO: should support nano second
     switch (eventType) {
         case PipelineEvent::Type::LOG:
-            for (const auto& item : group.mEvents) {
-                const auto& e = item.Cast<LogEvent>();
+            for (size_t i = 0; i < group.mEvents.size(); ++i) {
+                const auto& e = group.mEvents[i].Cast<LogEvent>();
                 if (e.Empty()) {
                     continue;
                 }
                 resetBuffer();
 
                 writer.StartObject();
-                SerializeCommonFields(group.mTags, e.GetTimestamp(), writer);
+                SerializeCommonFields(e.GetTimestamp(), writer);
                 // contents
                 for (const auto& kv : e) {
                     writer.Key(kv.first.to_string().c_str());
                     writer.String(kv.second.to_string().c_str());
                 }
                 writer.EndObject();
-                res.append(jsonBuffer.GetString());
-                res.append("\n");
+                appendLine(i);
             }
             break;
         case PipelineEvent::Type::METRIC:
             // TODO: key should support custom key
-            for (const auto& item : group.mEvents) {
-                const auto& e = item.Cast<MetricEvent>();
+            for (size_t i = 0; i < group.mEvents.size(); ++i) {
+                const auto& e = group.mEvents[i].Cast<MetricEvent>();
                 if (e.Is<std::monostate>()) {
                     continue;
                 }
                 resetBuffer();
 
                 writer.StartObject();
-                SerializeCommonFields(group.mTags, e.GetTimestamp(), writer);
+                SerializeCommonFields(e.GetTimestamp(), writer);
                 // __labels__
                 writer.Key(METRIC_RESERVED_KEY_LABELS.c_str());
                 writer.StartObject();
@@ -123,36 +180,34 @@ bool JsonEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, str
                     writer.String(it->second.to_string().c_str());
                 }
                 writer.EndObject();
-                res.append(jsonBuffer.GetString());
-                res.append("\n");
+                appendLine(i);
             }
             break;
         case PipelineEvent::Type::RAW:
-            for (const auto& item : group.mEvents) {
-                const auto& e = item.Cast<RawEvent>();
+            for (size_t i = 0; i < group.mEvents.size(); ++i) {
+                const auto& e = group.mEvents[i].Cast<RawEvent>();
                 if (e.GetContent().empty()) {
                     continue;
                 }
                 resetBuffer();
 
                 writer.StartObject();
-                SerializeCommonFields(group.mTags, e.GetTimestamp(), writer);
+                SerializeCommonFields(e.GetTimestamp(), writer);
                 // content
                 writer.Key(DEFAULT_CONTENT_KEY.c_str());
                 writer.String(e.GetContent().to_string().c_str());
                 writer.EndObject();
-                res.append(jsonBuffer.GetString());
-                res.append("\n");
+                appendLine(i);
             }
             break;
         case PipelineEvent::Type::SPAN:
-            for (const auto& item : group.mEvents) {
-                const auto& e = item.Cast<SpanEvent>();
+            for (size_t i = 0; i < group.mEvents.size(); ++i) {
+                const auto& e = group.mEvents[i].Cast<SpanEvent>();
 
                 resetBuffer();
 
                 writer.StartObject();
-                SerializeCommonFields(group.mTags, e.GetTimestamp(), writer);
+                SerializeCommonFields(e.GetTimestamp(), writer);
 
                 writer.Key(DEFAULT_TRACE_TAG_TRACE_ID.data(), DEFAULT_TRACE_TAG_TRACE_ID.size());
                 writer.String(e.GetTraceId().data(), e.GetTraceId().size());
@@ -187,14 +242,23 @@ bool JsonEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, str
                 writer.EndObject();
 
                 writer.EndObject();
-                res.append(jsonBuffer.GetString());
-                res.append("\n");
+                appendLine(i);
             }
             break;
         default:
             break;
     }
-    return !res.empty();
+    if (offsets != nullptr) {
+        // events skipped end where the previous ones end
+        size_t end = beginSize;
+        for (size_t i = offsetsBegin; i < offsets->size(); ++i) {
+            if ((*offsets)[i] == string::npos) {
+                (*offsets)[i] = end;
+            }
+            end = (*offsets)[i];
+        }
+    }
+    return res.size() > beginSize;
 }
 
 } // namespace logtail
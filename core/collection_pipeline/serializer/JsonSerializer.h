@@ -27,8 +27,22 @@ class JsonEventGroupSerializer : public Serializer<BatchedEvents> {
 public:
     JsonEventGroupSerializer(Flusher* f) : Serializer<BatchedEvents>(f) {}
 
+    // Like DoSerialize, but also appends the end offset in @res of the line of each event of @group to @offsets, so
+    // that events can be sent one by one from @res. Events skipped (e.g. empty ones) have empty lines.
+    bool DoSerializeEach(const BatchedEvents& group,
+                         std::string& res,
+                         std::vector<size_t>& offsets,
+                         std::string& errorMsg);
+
 private:
     bool Serialize(BatchedEvents&& p, std::string& res, std::string& errorMsg) override;
+    virtual bool
+    SerializeEach(const BatchedEvents& group, std::string& res, std::vector<size_t>& offsets, std::string& errorMsg);
+
+    bool SerializeEvents(const BatchedEvents& group,
+                         std::string& res,
+                         std::vector<size_t>* offsets,
+                         std::string& errorMsg) const;
 };
 
 } // namespace logtail
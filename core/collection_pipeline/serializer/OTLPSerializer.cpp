@@ -0,0 +1,451 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "collection_pipeline/serializer/OTLPSerializer.h"
+
+#include <optional>
+
+#include "collection_pipeline/serializer/ProtobufWireFormat.h"
+#include "constants/Constants.h"
+#include "models/LogEvent.h"
+#include "models/MetricEvent.h"
+#include "models/RawEvent.h"
+#include "models/SpanEvent.h"
+
+using namespace std;
+
+namespace logtail {
+
+// see opentelemetry/proto/metrics/v1/metrics.proto
+static const uint64_t kAggregationTemporalityCumulative = 2;
+
+// AnyValue with string_value set
+static inline size_t StringAnyValueSize(size_t valueSZ) {
+    return LenFieldSize(valueSZ);
+}
+
+static inline void PackStringAnyValueField(uint32_t field, StringView value, string& output) {
+    PackLenFieldHeader(field, StringAnyValueSize(value.size()), output);
+    PackStringField(1, value, output);
+}
+
+// KeyValue with string value
+static inline size_t KeyValueSize(size_t keySZ, size_t valueSZ) {
+    return LenFieldSize(keySZ) + LenFieldSize(StringAnyValueSize(valueSZ));
+}
+
+static inline void PackKeyValueField(uint32_t field, StringView key, StringView value, string& output) {
+    PackLenFieldHeader(field, KeyValueSize(key.size(), value.size()), output);
+    PackStringField(1, key, output);
+    PackStringAnyValueField(2, value, output);
+}
+
+template <typename Iterator>
+static size_t AttributesSize(Iterator begin, Iterator end) {
+    size_t size = 0;
+    for (auto it = begin; it != end; ++it) {
+        size += LenFieldSize(KeyValueSize(it->first.size(), it->second.size()));
+    }
+    return size;
+}
+
+template <typename Iterator>
+static void PackAttributes(uint32_t field, Iterator begin, Iterator end, string& output) {
+    for (auto it = begin; it != end; ++it) {
+        PackKeyValueField(field, it->first, it->second, output);
+    }
+}
+
+static inline int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static inline bool IsHexId(StringView id) {
+    if (id.size() % 2 != 0) {
+        return false;
+    }
+    for (char c : id) {
+        if (HexValue(c) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// trace and span ids are kept in hex, while OTLP takes the bytes. Ids not in hex are sent as they are.
+static inline size_t IdFieldSize(StringView id) {
+    if (id.empty()) {
+        return 0;
+    }
+    return LenFieldSize(IsHexId(id) ? id.size() / 2 : id.size());
+}
+
+static inline void PackIdField(uint32_t field, StringView id, string& output) {
+    if (id.empty()) {
+        return;
+    }
+    if (!IsHexId(id)) {
+        PackStringField(field, id, output);
+        return;
+    }
+    PackLenFieldHeader(field, id.size() / 2, output);
+    for (size_t i = 0; i < id.size(); i += 2) {
+        output.push_back(static_cast<char>(HexValue(id[i]) << 4 | HexValue(id[i + 1])));
+    }
+}
+
+static inline size_t OptionalStringFieldSize(StringView value) {
+    return value.empty() ? 0 : LenFieldSize(value.size());
+}
+
+static inline void PackOptionalStringField(uint32_t field, StringView value, string& output) {
+    if (!value.empty()) {
+        PackStringField(field, value, output);
+    }
+}
+
+static inline uint64_t GetTimeUnixNano(time_t timestamp, const std::optional<uint32_t>& timestampNs) {
+    return static_cast<uint64_t>(timestamp) * 1000000000ULL + timestampNs.value_or(0);
+}
+
+static inline size_t ResourceSize(const BatchedEvents& group) {
+    return AttributesSize(group.mTags.mInner.begin(), group.mTags.mInner.end());
+}
+
+// the resource message of ResourceLogs, ResourceMetrics and ResourceSpans, whose field numbers are all 1
+static inline void PackResourceField(const BatchedEvents& group, size_t resourceSZ, string& output) {
+    PackLenFieldHeader(1, resourceSZ, output);
+    PackAttributes(1, group.mTags.mInner.begin(), group.mTags.mInner.end(), output);
+}
+
+bool OTLPEventGroupSerializer::Serialize(BatchedEvents&& group, string& res, string& errorMsg) {
+    if (group.mEvents.empty()) {
+        errorMsg = "empty event group";
+        return false;
+    }
+    res.clear();
+    switch (group.mEvents[0]->GetType()) {
+        case PipelineEvent::Type::LOG:
+        case PipelineEvent::Type::RAW:
+            SerializeLogs(group, res);
+            break;
+        case PipelineEvent::Type::METRIC:
+            SerializeMetrics(group, res);
+            break;
+        case PipelineEvent::Type::SPAN:
+            SerializeSpans(group, res);
+            break;
+        default:
+            // should not happen
+            errorMsg = "unsupported event type in event group";
+            return false;
+    }
+    if (res.empty()) {
+        errorMsg = "no event can be serialized";
+        return false;
+    }
+    return true;
+}
+
+// ExportLogsServiceRequest
+//   resource_logs = 1: ResourceLogs
+//     resource = 1: Resource
+//     scope_logs = 2: ScopeLogs
+//       log_records = 2: LogRecord
+//         time_unix_nano = 1, severity_text = 3, body = 5, attributes = 6
+void OTLPEventGroupSerializer::SerializeLogs(const BatchedEvents& group, string& res) const {
+    // calculate sizes first, where the size of each record is cached
+    vector<size_t> recordSZ(group.mEvents.size(), 0);
+    size_t scopeLogsSZ = 0;
+    for (size_t i = 0; i < group.mEvents.size(); ++i) {
+        const auto& e = group.mEvents[i];
+        size_t size = kFixed64FieldSize;
+        if (e.Is<LogEvent>()) {
+            const auto& logEvent = e.Cast<LogEvent>();
+            size += OptionalStringFieldSize(logEvent.GetLevel());
+            for (const auto& kv : logEvent) {
+                if (kv.first == DEFAULT_CONTENT_KEY) {
+                    size += LenFieldSize(StringAnyValueSize(kv.second.size()));
+                } else {
+                    size += LenFieldSize(KeyValueSize(kv.first.size(), kv.second.size()));
+                }
+            }
+        } else if (e.Is<RawEvent>()) {
+            size += LenFieldSize(StringAnyValueSize(e.Cast<RawEvent>().GetContent().size()));
+        } else {
+            continue;
+        }
+        recordSZ[i] = size;
+        scopeLogsSZ += LenFieldSize(size);
+    }
+    if (scopeLogsSZ == 0) {
+        return;
+    }
+    size_t resourceSZ = ResourceSize(group);
+    size_t resourceLogsSZ = LenFieldSize(resourceSZ) + LenFieldSize(scopeLogsSZ);
+    res.reserve(LenFieldSize(resourceLogsSZ));
+
+    PackLenFieldHeader(1, resourceLogsSZ, res);
+    PackResourceField(group, resourceSZ, res);
+    PackLenFieldHeader(2, scopeLogsSZ, res);
+    for (size_t i = 0; i < group.mEvents.size(); ++i) {
+        if (recordSZ[i] == 0) {
+            continue;
+        }
+        const auto& e = group.mEvents[i];
+        PackLenFieldHeader(2, recordSZ[i], res);
+        PackFixed64Field(1, GetTimeUnixNano(e->GetTimestamp(), e->GetTimestampNanosecond()), res);
+        if (e.Is<LogEvent>()) {
+            const auto& logEvent = e.Cast<LogEvent>();
+            PackOptionalStringField(3, logEvent.GetLevel(), res);
+            for (const auto& kv : logEvent) {
+                if (kv.first == DEFAULT_CONTENT_KEY) {
+                    PackStringAnyValueField(5, kv.second, res);
+                } else {
+                    PackKeyValueField(6, kv.first, kv.second, res);
+                }
+            }
+        } else {
+            PackStringAnyValueField(5, e.Cast<RawEvent>().GetContent(), res);
+        }
+    }
+}
+
+// ExportMetricsServiceRequest
+//   resource_metrics = 1: ResourceMetrics
+//     resource = 1: Resource
+//     scope_metrics = 2: ScopeMetrics
+//       metrics = 2: Metric
+//         name = 1, gauge = 5 (data_points = 1), sum = 7 (data_points = 1, temporality = 2, monotonic = 3)
+//           NumberDataPoint: time_unix_nano = 3, as_double = 4, attributes = 7
+// Each value of a metric event with multiple values is a metric named as <name>_<value key>, where counters are sums
+// and others are gauges.
+void OTLPEventGroupSerializer::SerializeMetrics(const BatchedEvents& group, string& res) const {
+    static const size_t kSumExtraSize = VarintFieldSize(kAggregationTemporalityCumulative) + VarintFieldSize(1);
+
+    // the data point size of each event is cached, which is the same for all values of the event
+    vector<size_t> dataPointSZ(group.mEvents.size(), 0);
+    size_t scopeMetricsSZ = 0;
+    for (size_t i = 0; i < group.mEvents.size(); ++i) {
+        const auto& e = group.mEvents[i];
+        if (!e.Is<MetricEvent>()) {
+            continue;
+        }
+        const auto& metricEvent = e.Cast<MetricEvent>();
+        size_t dpSZ = 2 * kFixed64FieldSize + AttributesSize(metricEvent.TagsBegin(), metricEvent.TagsEnd());
+        if (metricEvent.Is<UntypedSingleValue>()) {
+            size_t gaugeSZ = LenFieldSize(dpSZ);
+            scopeMetricsSZ += LenFieldSize(LenFieldSize(metricEvent.GetName().size()) + LenFieldSize(gaugeSZ));
+        } else if (metricEvent.Is<UntypedMultiDoubleValues>()) {
+            const auto* values = metricEvent.GetValue<UntypedMultiDoubleValues>();
+            if (values->ValuesSize() == 0) {
+                continue;
+            }
+            for (auto it = values->ValuesBegin(); it != values->ValuesEnd(); ++it) {
+                size_t nameSZ = metricEvent.GetName().size() + 1 + it->first.size();
+                size_t dataSZ = LenFieldSize(dpSZ);
+                if (it->second.MetricType == UntypedValueMetricType::MetricTypeCounter) {
+                    dataSZ += kSumExtraSize;
+                }
+                scopeMetricsSZ += LenFieldSize(LenFieldSize(nameSZ) + LenFieldSize(dataSZ));
+            }
+        } else {
+            continue;
+        }
+        dataPointSZ[i] = dpSZ;
+    }
+    if (scopeMetricsSZ == 0) {
+        return;
+    }
+    size_t resourceSZ = ResourceSize(group);
+    size_t resourceMetricsSZ = LenFieldSize(resourceSZ) + LenFieldSize(scopeMetricsSZ);
+    res.reserve(LenFieldSize(resourceMetricsSZ));
+
+    auto packDataPoint = [&res](const MetricEvent& e, size_t dpSZ, double value) {
+        PackLenFieldHeader(1, dpSZ, res);
+        PackFixed64Field(3, GetTimeUnixNano(e.GetTimestamp(), e.GetTimestampNanosecond()), res);
+        PackDoubleField(4, value, res);
+        PackAttributes(7, e.TagsBegin(), e.TagsEnd(), res);
+    };
+    PackLenFieldHeader(1, resourceMetricsSZ, res);
+    PackResourceField(group, resourceSZ, res);
+    PackLenFieldHeader(2, scopeMetricsSZ, res);
+    for (size_t i = 0; i < group.mEvents.size(); ++i) {
+        size_t dpSZ = dataPointSZ[i];
+        if (dpSZ == 0) {
+            continue;
+        }
+        const auto& metricEvent = group.mEvents[i].Cast<MetricEvent>();
+        StringView name = metricEvent.GetName();
+        if (metricEvent.Is<UntypedSingleValue>()) {
+            size_t gaugeSZ = LenFieldSize(dpSZ);
+            PackLenFieldHeader(2, LenFieldSize(name.size()) + LenFieldSize(gaugeSZ), res);
+            PackStringField(1, name, res);
+            PackLenFieldHeader(5, gaugeSZ, res);
+            packDataPoint(metricEvent, dpSZ, metricEvent.GetValue<UntypedSingleValue>()->mValue);
+            continue;
+        }
+        const auto* values = metricEvent.GetValue<UntypedMultiDoubleValues>();
+        for (auto it = values->ValuesBegin(); it != values->ValuesEnd(); ++it) {
+            size_t nameSZ = name.size() + 1 + it->first.size();
+            bool isSum = it->second.MetricType == UntypedValueMetricType::MetricTypeCounter;
+            size_t dataSZ = LenFieldSize(dpSZ) + (isSum ? kSumExtraSize : 0);
+            PackLenFieldHeader(2, LenFieldSize(nameSZ) + LenFieldSize(dataSZ), res);
+            PackLenFieldHeader(1, nameSZ, res);
+            res.append(name.data(), name.size());
+            res.push_back('_');
+            res.append(it->first.data(), it->first.size());
+            PackLenFieldHeader(isSum ? 7 : 5, dataSZ, res);
+            packDataPoint(metricEvent, dpSZ, it->second.Value);
+            if (isSum) {
+                PackVarintField(2, kAggregationTemporalityCumulative, res);
+                PackVarintField(3, 1, res);
+            }
+        }
+    }
+}
+
+// Span.Event: time_unix_nano = 1, name = 2, attributes = 3
+static inline size_t SpanInnerEventSize(const SpanEvent::InnerEvent& e) {
+    return kFixed64FieldSize + OptionalStringFieldSize(e.GetName()) + AttributesSize(e.TagsBegin(), e.TagsEnd());
+}
+
+// Span.Link: trace_id = 1, span_id = 2, trace_state = 3, attributes = 4
+static inline size_t SpanLinkSize(const SpanEvent::SpanLink& l) {
+    return IdFieldSize(l.GetTraceId()) + IdFieldSize(l.GetSpanId()) + OptionalStringFieldSize(l.GetTraceState())
+        + AttributesSize(l.TagsBegin(), l.TagsEnd());
+}
+
+// Status: code = 3
+static inline size_t SpanStatusSize(SpanEvent::StatusCode status) {
+    return status == SpanEvent::StatusCode::Unset ? 0 : VarintFieldSize(static_cast<uint64_t>(status));
+}
+
+// ExportTraceServiceRequest
+//   resource_spans = 1: ResourceSpans
+//     resource = 1: Resource
+//     scope_spans = 2: ScopeSpans
+//       scope = 1: InstrumentationScope (name = 1, version = 2)
+//       spans = 2: Span
+//         trace_id = 1, span_id = 2, trace_state = 3, parent_span_id = 4, name = 5, kind = 6,
+//         start_time_unix_nano = 7, end_time_unix_nano = 8, attributes = 9, events = 11, links = 13, status = 15
+// Adjacent spans with the same scope share one ScopeSpans.
+void OTLPEventGroupSerializer::SerializeSpans(const BatchedEvents& group, string& res) const {
+    vector<size_t> spanSZ(group.mEvents.size(), 0);
+    vector<ScopeSpansInfo> scopes;
+    for (size_t i = 0; i < group.mEvents.size(); ++i) {
+        const auto& e = group.mEvents[i];
+        if (!e.Is<SpanEvent>()) {
+            continue;
+        }
+        const auto& span = e.Cast<SpanEvent>();
+        size_t size = IdFieldSize(span.GetTraceId()) + IdFieldSize(span.GetSpanId())
+            + OptionalStringFieldSize(span.GetTraceState()) + IdFieldSize(span.GetParentSpanId())
+            + OptionalStringFieldSize(span.GetName()) + 2 * kFixed64FieldSize
+            + AttributesSize(span.TagsBegin(), span.TagsEnd());
+        if (span.GetKind() != SpanEvent::Kind::Unspecified) {
+            size += VarintFieldSize(static_cast<uint64_t>(span.GetKind()));
+        }
+        for (const auto& innerEvent : span.GetEvents()) {
+            size += LenFieldSize(SpanInnerEventSize(innerEvent));
+        }
+        for (const auto& link : span.GetLinks()) {
+            size += LenFieldSize(SpanLinkSize(link));
+        }
+        if (span.GetStatus() != SpanEvent::StatusCode::Unset) {
+            size += LenFieldSize(SpanStatusSize(span.GetStatus()));
+        }
+        spanSZ[i] = size;
+
+        StringView scopeName = span.GetScopeTag(SpanEvent::OTLP_SCOPE_NAME);
+        StringView scopeVersion = span.GetScopeTag(SpanEvent::OTLP_SCOPE_VERSION);
+        if (scopes.empty() || scopes.back().mScopeName != scopeName || scopes.back().mScopeVersion != scopeVersion) {
+            scopes.emplace_back();
+            scopes.back().mBegin = i;
+            scopes.back().mScopeName = scopeName;
+            scopes.back().mScopeVersion = scopeVersion;
+        }
+        scopes.back().mEnd = i + 1;
+        scopes.back().mSize += LenFieldSize(size);
+    }
+    if (scopes.empty()) {
+        return;
+    }
+    size_t resourceSZ = ResourceSize(group);
+    size_t resourceSpansSZ = LenFieldSize(resourceSZ);
+    for (auto& scope : scopes) {
+        size_t scopeSZ = OptionalStringFieldSize(scope.mScopeName) + OptionalStringFieldSize(scope.mScopeVersion);
+        scope.mSize += LenFieldSize(scopeSZ);
+        resourceSpansSZ += LenFieldSize(scope.mSize);
+    }
+    res.reserve(LenFieldSize(resourceSpansSZ));
+
+    PackLenFieldHeader(1, resourceSpansSZ, res);
+    PackResourceField(group, resourceSZ, res);
+    for (const auto& scope : scopes) {
+        PackLenFieldHeader(2, scope.mSize, res);
+        PackLenFieldHeader(
+            1, OptionalStringFieldSize(scope.mScopeName) + OptionalStringFieldSize(scope.mScopeVersion), res);
+        PackOptionalStringField(1, scope.mScopeName, res);
+        PackOptionalStringField(2, scope.mScopeVersion, res);
+        for (size_t i = scope.mBegin; i < scope.mEnd; ++i) {
+            if (spanSZ[i] == 0) {
+                continue;
+            }
+            const auto& span = group.mEvents[i].Cast<SpanEvent>();
+            PackLenFieldHeader(2, spanSZ[i], res);
+            PackIdField(1, span.GetTraceId(), res);
+            PackIdField(2, span.GetSpanId(), res);
+            PackOptionalStringField(3, span.GetTraceState(), res);
+            PackIdField(4, span.GetParentSpanId(), res);
+            PackOptionalStringField(5, span.GetName(), res);
+            if (span.GetKind() != SpanEvent::Kind::Unspecified) {
+                PackVarintField(6, static_cast<uint64_t>(span.GetKind()), res);
+            }
+            PackFixed64Field(7, span.GetStartTimeNs(), res);
+            PackFixed64Field(8, span.GetEndTimeNs(), res);
+            PackAttributes(9, span.TagsBegin(), span.TagsEnd(), res);
+            for (const auto& innerEvent : span.GetEvents()) {
+                PackLenFieldHeader(11, SpanInnerEventSize(innerEvent), res);
+                PackFixed64Field(1, innerEvent.GetTimestampNs(), res);
+                PackOptionalStringField(2, innerEvent.GetName(), res);
+                PackAttributes(3, innerEvent.TagsBegin(), innerEvent.TagsEnd(), res);
+            }
+            for (const auto& link : span.GetLinks()) {
+                PackLenFieldHeader(13, SpanLinkSize(link), res);
+                PackIdField(1, link.GetTraceId(), res);
+                PackIdField(2, link.GetSpanId(), res);
+                PackOptionalStringField(3, link.GetTraceState(), res);
+                PackAttributes(4, link.TagsBegin(), link.TagsEnd(), res);
+            }
+            if (span.GetStatus() != SpanEvent::StatusCode::Unset) {
+                PackLenFieldHeader(15, SpanStatusSize(span.GetStatus()), res);
+                PackVarintField(3, static_cast<uint64_t>(span.GetStatus()), res);
+            }
+        }
+    }
+}
+
+} // namespace logtail
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "collection_pipeline/serializer/Serializer.h"
+#include "common/StringView.h"
+
+namespace logtail {
+
+// Serializes a group of events to an OTLP export request in protobuf, i.e. ExportLogsServiceRequest for log and raw
+// events, ExportMetricsServiceRequest for metric events and ExportTraceServiceRequest for span events. Group tags are
+// the resource attributes.
+// The request is encoded directly from the events, the same way as LogGroupSerializer, so that no protobuf object is
+// built and no string is copied before being written to the result.
+// see for detail: https://github.com/open-telemetry/opentelemetry-proto
+class OTLPEventGroupSerializer : public Serializer<BatchedEvents> {
+public:
+    OTLPEventGroupSerializer(Flusher* f) : Serializer<BatchedEvents>(f) {}
+
+private:
+    struct ScopeSpansInfo {
+        size_t mBegin = 0;
+        size_t mEnd = 0;
+        size_t mSize = 0;
+        StringView mScopeName;
+        StringView mScopeVersion;
+    };
+
+    bool Serialize(BatchedEvents&& p, std::string& res, std::string& errorMsg) override;
+
+    void SerializeLogs(const BatchedEvents& group, std::string& res) const;
+    void SerializeMetrics(const BatchedEvents& group, std::string& res) const;
+    void SerializeSpans(const BatchedEvents& group, std::string& res) const;
+};
+
+} // namespace logtail
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <string>
+
+#include "common/StringView.h"
+
+namespace logtail {
+
+// Helpers for serializers which encode protobuf messages directly without building protobuf objects, see
+// https://protobuf.dev/programming-guides/encoding/
+// Field numbers of all messages encoded are less than 16, so each tag takes 1 byte.
+
+const uint32_t kWireTypeVarint = 0;
+const uint32_t kWireTypeFixed64 = 1;
+const uint32_t kWireTypeLen = 2;
+
+const size_t kFixed64FieldSize = 9;
+
+inline size_t VarintSize(uint64_t v) {
+    size_t size = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+inline void PackVarint(uint64_t v, std::string& output) {
+    while (v >= 0x80) {
+        output.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    output.push_back(static_cast<char>(v));
+}
+
+inline void PackTag(uint32_t field, uint32_t wireType, std::string& output) {
+    output.push_back(static_cast<char>(field << 3 | wireType));
+}
+
+inline size_t LenFieldSize(size_t len) {
+    return 1 + VarintSize(len) + len;
+}
+
+inline size_t VarintFieldSize(uint64_t v) {
+    return 1 + VarintSize(v);
+}
+
+inline void PackLenFieldHeader(uint32_t field, size_t len, std::string& output) {
+    PackTag(field, kWireTypeLen, output);
+    PackVarint(len, output);
+}
+
+inline void PackStringField(uint32_t field, StringView value, std::string& output) {
+    PackLenFieldHeader(field, value.size(), output);
+    output.append(value.data(), value.size());
+}
+
+inline void PackVarintField(uint32_t field, uint64_t value, std::string& output) {
+    PackTag(field, kWireTypeVarint, output);
+    PackVarint(value, output);
+}
+
+inline void PackFixed64Field(uint32_t field, uint64_t value, std::string& output) {
+    PackTag(field, kWireTypeFixed64, output);
+    for (size_t i = 0; i < 8; ++i) {
+        output.push_back(static_cast<char>(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+inline void PackDoubleField(uint32_t field, double value, std::string& output) {
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    PackFixed64Field(field, bits, output);
+}
+
+} // namespace logtail
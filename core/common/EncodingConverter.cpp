@@ -14,10 +14,19 @@
 
 #include "EncodingConverter.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
 #include "AlarmManager.h"
 #include "logger/Logger.h"
 #if defined(__linux__)
 #include <iconv.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 #elif defined(_MSC_VER)
 #include <Windows.h>
 #endif
@@ -25,32 +34,146 @@
 namespace logtail {
 
 #if defined(__linux__)
-static iconv_t mGbk2Utf8Cd = (iconv_t)-1;
+// UTF-8 of a GBK char, mLength is 0 if the bytes are not a valid GBK char.
+struct GbkChar {
+    char mBytes[3];
+    uint8_t mLength;
+};
+
+// Tables are filled from iconv once, so that conversion gives the same result as iconv does, and are read only
+// afterwards. Bytes below 0x80 are ASCII.
+static bool sGbkTableInited = false;
+// chars of a single byte, indexed by byte - 0x80
+static GbkChar sGbkSingleTable[128];
+// whether the byte starts a char of two bytes, indexed by byte - 0x80
+static bool sGbkLeadTable[128];
+// chars of two bytes, indexed by (lead - 0x80) * 256 + trail
+static std::unique_ptr<GbkChar[]> sGbkDoubleTable;
+
+static bool convertGbkCharByIconv(iconv_t cd, const char* src, size_t srcLength, GbkChar& gbkChar) {
+    char buf[8];
+    char* in = const_cast<char*>(src);
+    char* out = buf;
+    size_t outLeft = sizeof(buf);
+    size_t ret = iconv(cd, &in, &srcLength, &out, &outLeft);
+    int err = errno;
+    iconv(cd, NULL, NULL, NULL, NULL);
+    size_t length = sizeof(buf) - outLeft;
+    if (ret == (size_t)(-1) || srcLength != 0 || length == 0 || length > sizeof(gbkChar.mBytes)) {
+        errno = err;
+        return false;
+    }
+    memcpy(gbkChar.mBytes, buf, length);
+    gbkChar.mLength = static_cast<uint8_t>(length);
+    return true;
+}
+
+static void initGbkTable() {
+    iconv_t cd = iconv_open("UTF-8", "GBK");
+    if (cd == (iconv_t)(-1)) {
+        LOG_ERROR(sLogger, ("create Gbk2Utf8 iconv descriptor fail, errno", strerror(errno)));
+        return;
+    }
+    sGbkDoubleTable.reset(new GbkChar[128 * 256]());
+    for (int lead = 0; lead < 128; ++lead) {
+        char src[2] = {static_cast<char>(lead + 0x80), 0};
+        if (convertGbkCharByIconv(cd, src, 1, sGbkSingleTable[lead])) {
+            continue;
+        }
+        // a lead byte alone is an incomplete char
+        if (errno != EINVAL) {
+            continue;
+        }
+        sGbkLeadTable[lead] = true;
+        for (int trail = 0; trail < 256; ++trail) {
+            src[1] = static_cast<char>(trail);
+            convertGbkCharByIconv(cd, src, 2, sGbkDoubleTable[lead * 256 + trail]);
+        }
+    }
+    iconv_close(cd);
+    sGbkTableInited = true;
+}
+
+// Copies the leading ASCII bytes of @src to @des, at most @length bytes, and returns the number of bytes copied.
+static size_t copyAscii(const char* src, size_t length, char* des) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(chunk) != 0) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(des + i), chunk);
+    }
+#elif defined(__aarch64__)
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        if (vmaxvq_u8(chunk) >= 0x80) {
+            break;
+        }
+        vst1q_u8(reinterpret_cast<uint8_t*>(des + i), chunk);
+    }
+#endif
+    for (; i < length && static_cast<unsigned char>(src[i]) < 0x80; ++i) {
+        des[i] = src[i];
+    }
+    return i;
+}
+
+// Converts @src of @srcLength bytes into [des, desEnd), and returns the number of bytes written, or -1 if @src is
+// not valid GBK or @des is not large enough, the same as iconv fails.
+static ssize_t convertGbkLine(const char* src, size_t srcLength, char* des, const char* desEnd) {
+    size_t i = 0;
+    char* out = des;
+    while (true) {
+        size_t n = copyAscii(src + i, std::min(srcLength - i, static_cast<size_t>(desEnd - out)), out);
+        i += n;
+        out += n;
+        if (i == srcLength) {
+            break;
+        }
+        if (out == desEnd) {
+            return -1;
+        }
+        size_t index = static_cast<unsigned char>(src[i]) - 0x80;
+        const GbkChar* gbkChar = &sGbkSingleTable[index];
+        if (sGbkLeadTable[index]) {
+            if (i + 1 == srcLength) {
+                return -1;
+            }
+            gbkChar = &sGbkDoubleTable[index * 256 + static_cast<unsigned char>(src[i + 1])];
+            ++i;
+        }
+        ++i;
+        if (gbkChar->mLength == 0 || static_cast<size_t>(desEnd - out) < gbkChar->mLength) {
+            return -1;
+        }
+        out[0] = gbkChar->mBytes[0];
+        out[1] = gbkChar->mBytes[1];
+        if (gbkChar->mLength == 3) {
+            out[2] = gbkChar->mBytes[2];
+        }
+        out += gbkChar->mLength;
+    }
+    return out - des;
+}
 #endif
 
 EncodingConverter::EncodingConverter() {
 #if defined(__linux__)
-    mGbk2Utf8Cd = iconv_open("UTF-8", "GBK");
-    if (mGbk2Utf8Cd == (iconv_t)(-1))
-        LOG_ERROR(sLogger, ("create Gbk2Utf8 iconv descriptor fail, errno", strerror(errno)));
-    else
-        iconv(mGbk2Utf8Cd, NULL, NULL, NULL, NULL);
+    initGbkTable();
 #endif
 }
 
 EncodingConverter::~EncodingConverter() {
-#if defined(__linux__)
-    if (mGbk2Utf8Cd != (iconv_t)(-1))
-        iconv_close(mGbk2Utf8Cd);
-#endif
 }
 
 // TODO: Refactor it, do not use the output params to do calculations, set them before return.
 size_t EncodingConverter::ConvertGbk2Utf8(
     const char* src, size_t* srcLength, char* desOut, size_t desLength, const std::vector<long>& linePosVec) const {
 #if defined(__linux__)
-    if (src == NULL || *srcLength == 0 || mGbk2Utf8Cd == (iconv_t)(-1)) {
-        LOG_ERROR(sLogger, ("invalid iconv descriptor fail or invalid buffer pointer, cd", mGbk2Utf8Cd));
+    if (src == NULL || *srcLength == 0 || !sGbkTableInited) {
+        LOG_ERROR(sLogger, ("GBK table is not inited or invalid buffer pointer, table inited", sGbkTableInited));
         return 0;
     }
     size_t maxRequire = *srcLength * 2;
@@ -60,31 +183,24 @@ size_t EncodingConverter::ConvertGbk2Utf8(
     if (desLength < maxRequire + 1) {
         return 0;
     }
-    char* des = desOut;
-    des[*srcLength * 2] = '\0';
-    const char* originSrc = src;
-    char* originDes = des;
+    desOut[*srcLength * 2] = '\0';
+    const char* desEnd = desOut + desLength;
     size_t beginIndex = 0;
     size_t endIndex = *srcLength;
     size_t destIndex = 0;
-    size_t maxDestSize = desLength;
     for (size_t i = 0; i < linePosVec.size(); ++i) {
         endIndex = linePosVec[i];
-        src = originSrc + beginIndex;
-        des = originDes + destIndex;
         // include '\n'
-        *srcLength = endIndex - beginIndex + 1;
-        desLength = maxDestSize - destIndex;
-        size_t ret = iconv(mGbk2Utf8Cd, const_cast<char**>(&src), srcLength, &des, &desLength);
-        if (ret == (size_t)(-1)) {
-            LOG_ERROR(sLogger, ("convert GBK to UTF8 fail, errno", strerror(errno)));
-            iconv(mGbk2Utf8Cd, NULL, NULL, NULL, NULL); // Clear status.
+        size_t lineLength = endIndex - beginIndex + 1;
+        ssize_t ret = convertGbkLine(src + beginIndex, lineLength, desOut + destIndex, desEnd);
+        if (ret < 0) {
+            LOG_ERROR(sLogger, ("convert GBK to UTF8 fail", "invalid GBK sequence")("line offset", beginIndex));
             AlarmManager::GetInstance()->SendAlarmWarning(ENCODING_CONVERT_ALARM, "convert GBK to UTF8 fail");
             // use memcpy
-            memcpy(originDes + destIndex, originSrc + beginIndex, endIndex - beginIndex + 1);
-            destIndex += endIndex - beginIndex + 1;
+            memcpy(desOut + destIndex, src + beginIndex, lineLength);
+            destIndex += lineLength;
         } else {
-            destIndex = des - originDes;
+            destIndex += ret;
         }
         beginIndex = endIndex + 1;
     }
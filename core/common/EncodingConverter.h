@@ -48,7 +48,8 @@ public:
     //          This API design mimics snprintf.
     //
     // Different platforms have different implementations:
-    // - For Linux, ConvertGbk2Utf8 converts line by line according to @linePosVec.
+    // - For Linux, ConvertGbk2Utf8 converts line by line according to @linePosVec, through tables built from iconv
+    //   on construction, so the result is the same as iconv's.
     //   If there is error happened during converting, corresponding line will be copied
     //   to @des without converting.
     // - For Windows, ConvertGbk2Utf8 converts whole @src, if any errors happened,
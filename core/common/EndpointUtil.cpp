@@ -78,4 +78,26 @@ string GetHostFromEndpoint(const std::string& endpoint) {
     }
 }
 
+bool ParseHttpEndpoint(const string& endpoint, bool& httpsFlag, string& host, int32_t& port, string& path) {
+    string trimmedEndpoint = TrimString(endpoint);
+    httpsFlag = IsHttpsEndpoint(trimmedEndpoint);
+    auto bpos = trimmedEndpoint.find("://");
+    bpos = bpos == string::npos ? 0 : bpos + strlen("://");
+    auto epos = trimmedEndpoint.find('/', bpos);
+    string hostPort = trimmedEndpoint.substr(bpos, epos == string::npos ? string::npos : epos - bpos);
+    path = epos == string::npos ? "" : trimmedEndpoint.substr(epos);
+
+    auto ppos = hostPort.rfind(':');
+    if (ppos != string::npos && hostPort.find(']', ppos) == string::npos) {
+        if (!StringTo(hostPort.substr(ppos + 1), port) || port <= 0 || port > 65535) {
+            return false;
+        }
+        host = hostPort.substr(0, ppos);
+    } else {
+        port = httpsFlag ? 443 : 80;
+        host = hostPort;
+    }
+    return !host.empty();
+}
+
 } // namespace logtail
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <string>
 
 namespace logtail {
@@ -28,4 +30,11 @@ std::string StandardizeHost(const std::string& endpoint, const std::string& defa
 
 std::string GetHostFromEndpoint(const std::string& endpoint);
 
+// splits an http(s) url into its parts, the port defaults to 80 or 443 by the scheme and the path may be empty
+bool ParseHttpEndpoint(const std::string& endpoint,
+                       bool& httpsFlag,
+                       std::string& host,
+                       int32_t& port,
+                       std::string& path);
+
 } // namespace logtail
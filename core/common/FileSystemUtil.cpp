@@ -22,6 +22,7 @@
 #include <direct.h>
 #include <fcntl.h>
 #elif defined(__linux__)
+#include <fcntl.h>
 #include <fnmatch.h>
 #include <sys/statvfs.h>
 #endif
@@ -649,6 +650,14 @@ void Dir::Close() {
 #endif
 }
 
+int Dir::GetFd() const {
+#if defined(__linux__)
+    return IsOpened() ? dirfd(mDir) : -1;
+#elif defined(_MSC_VER)
+    return -1;
+#endif
+}
+
 PathStat::PathStat() {
 }
 
@@ -670,6 +679,18 @@ bool PathStat::stat(const std::string& path, PathStat& ps) {
 #endif
 }
 
+bool PathStat::statAt(int dirFd, const std::string& dirPath, const std::string& name, PathStat& ps) {
+    if (dirFd < 0) {
+        return stat(PathJoin(dirPath, name), ps);
+    }
+    ps.mPath = PathJoin(dirPath, name);
+#if defined(__linux__)
+    return (0 == ::fstatat(dirFd, name.c_str(), &(ps.mRawStat), 0));
+#elif defined(_MSC_VER)
+    return stat(ps.mPath, ps);
+#endif
+}
+
 bool PathStat::IsDir() const {
 #if defined(__linux__)
     return S_ISDIR(mRawStat.st_mode);
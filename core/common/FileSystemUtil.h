@@ -225,6 +225,10 @@ public:
 
     void Close();
 
+    // GetFd returns the fd of the opened directory for *at APIs, -1 if it is not opened or
+    // not supported (Windows).
+    int GetFd() const;
+
 private:
     std::string mDirPath;
 #if defined(__linux__)
@@ -255,6 +259,10 @@ public:
 
     // stat wrappers ::stat.
     static bool stat(const std::string& path, PathStat& ps);
+    // statAt stats @name in the directory opened as @dirFd (see Dir::GetFd) like stat,
+    // which saves the path walk of the full path. Falls back to stat on the joined
+    // path if @dirFd is -1.
+    static bool statAt(int dirFd, const std::string& dirPath, const std::string& name, PathStat& ps);
     bool IsDir() const;
     bool IsRegFile() const;
 
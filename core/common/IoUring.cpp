@@ -0,0 +1,221 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/IoUring.h"
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace logtail {
+
+#if defined(__linux__)
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+
+// Not in the headers of old build environments, values are part of the kernel ABI.
+static const uint8_t kOpRead = 22; // IORING_OP_READ, 5.6
+static const uint32_t kFeatSingleMmap = 1U << 0; // IORING_FEAT_SINGLE_MMAP, 5.4
+static const uint32_t kFeatRwCurPos = 1U << 3; // IORING_FEAT_RW_CUR_POS, added along with IORING_OP_READ
+
+template <class T>
+static T* ringPtr(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+bool IoUring::Init(uint32_t entries) {
+    if (IsInitialized()) {
+        return true;
+    }
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+        return false;
+    }
+    if (!(params.features & kFeatRwCurPos)) {
+        close(fd);
+        return false;
+    }
+    mRingFd = fd;
+    mSqEntries = params.sq_entries;
+
+    mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & kFeatSingleMmap;
+    if (singleMmap) {
+        mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+    }
+    mSqRingPtr = mmap(nullptr, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (mSqRingPtr == MAP_FAILED) {
+        mSqRingPtr = nullptr;
+        Close();
+        return false;
+    }
+    if (singleMmap) {
+        mCqRingPtr = mSqRingPtr;
+    } else {
+        mCqRingPtr
+            = mmap(nullptr, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (mCqRingPtr == MAP_FAILED) {
+            mCqRingPtr = nullptr;
+            Close();
+            return false;
+        }
+    }
+    mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    mSqesPtr = mmap(nullptr, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (mSqesPtr == MAP_FAILED) {
+        mSqesPtr = nullptr;
+        Close();
+        return false;
+    }
+
+    mSqHead = ringPtr<uint32_t>(mSqRingPtr, params.sq_off.head);
+    mSqTail = ringPtr<uint32_t>(mSqRingPtr, params.sq_off.tail);
+    mSqMask = ringPtr<uint32_t>(mSqRingPtr, params.sq_off.ring_mask);
+    mSqArray = ringPtr<uint32_t>(mSqRingPtr, params.sq_off.array);
+    mCqHead = ringPtr<uint32_t>(mCqRingPtr, params.cq_off.head);
+    mCqTail = ringPtr<uint32_t>(mCqRingPtr, params.cq_off.tail);
+    mCqMask = ringPtr<uint32_t>(mCqRingPtr, params.cq_off.ring_mask);
+    mCqes = ringPtr<void>(mCqRingPtr, params.cq_off.cqes);
+    return true;
+}
+
+void IoUring::Close() {
+    if (mSqesPtr != nullptr) {
+        munmap(mSqesPtr, mSqesSize);
+        mSqesPtr = nullptr;
+    }
+    if (mCqRingPtr != nullptr && mCqRingPtr != mSqRingPtr) {
+        munmap(mCqRingPtr, mCqRingSize);
+    }
+    mCqRingPtr = nullptr;
+    if (mSqRingPtr != nullptr) {
+        munmap(mSqRingPtr, mSqRingSize);
+        mSqRingPtr = nullptr;
+    }
+    if (mRingFd >= 0) {
+        close(mRingFd);
+        mRingFd = -1;
+    }
+    mSqEntries = 0;
+    mToSubmit = 0;
+}
+
+bool IoUring::PrepareRead(int fd, void* buf, uint32_t size, uint64_t offset, uint64_t userData) {
+    if (!IsInitialized()) {
+        return false;
+    }
+    uint32_t tail = *mSqTail; // only written by us
+    if (tail - __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE) >= mSqEntries) {
+        return false;
+    }
+    uint32_t index = tail & *mSqMask;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(mSqesPtr) + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = kOpRead;
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = size;
+    sqe->user_data = userData;
+    mSqArray[index] = index;
+    __atomic_store_n(mSqTail, tail + 1, __ATOMIC_RELEASE);
+    ++mToSubmit;
+    return true;
+}
+
+int IoUring::Submit(uint32_t waitCount) {
+    if (!IsInitialized()) {
+        return -EBADF;
+    }
+    unsigned flags = waitCount > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int ret = 0;
+    do {
+        ret = static_cast<int>(syscall(__NR_io_uring_enter, mRingFd, mToSubmit, waitCount, flags, nullptr, 0));
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        return -errno;
+    }
+    mToSubmit -= static_cast<uint32_t>(ret);
+    return ret;
+}
+
+int IoUring::WaitCompletions(uint32_t waitCount) {
+    if (!IsInitialized()) {
+        return -EBADF;
+    }
+    int ret = 0;
+    do {
+        ret = static_cast<int>(syscall(__NR_io_uring_enter, mRingFd, 0, waitCount, IORING_ENTER_GETEVENTS, nullptr, 0));
+    } while (ret < 0 && errno == EINTR);
+    return ret < 0 ? -errno : 0;
+}
+
+bool IoUring::PopCompletion(uint64_t& userData, int32_t& result) {
+    if (!IsInitialized()) {
+        return false;
+    }
+    uint32_t head = *mCqHead; // only written by us
+    if (head == __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(mCqes) + (head & *mCqMask);
+    userData = cqe->user_data;
+    result = cqe->res;
+    __atomic_store_n(mCqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+#else
+
+bool IoUring::Init(uint32_t entries) {
+    return false;
+}
+
+void IoUring::Close() {
+}
+
+bool IoUring::PrepareRead(int fd, void* buf, uint32_t size, uint64_t offset, uint64_t userData) {
+    return false;
+}
+
+int IoUring::Submit(uint32_t waitCount) {
+    return -1;
+}
+
+int IoUring::WaitCompletions(uint32_t waitCount) {
+    return -1;
+}
+
+bool IoUring::PopCompletion(uint64_t& userData, int32_t& result) {
+    return false;
+}
+
+#endif
+
+} // namespace logtail
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace logtail {
+
+// Minimal io_uring ring for file reads, driven by raw syscalls so that no liburing is needed. Init fails if the
+// kernel is older than 5.6 (no IORING_OP_READ) or io_uring is forbidden (e.g. by seccomp in containers), callers
+// should fall back to pread then. Not available on other platforms.
+// NOT thread-safe.
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring() { Close(); }
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    bool Init(uint32_t entries);
+    void Close();
+    bool IsInitialized() const { return mRingFd >= 0; }
+    uint32_t GetEntries() const { return mSqEntries; }
+
+    // Queues a read of @size bytes at @offset of @fd into @buf, which must stay valid until the read completes.
+    // Returns false if the submission queue is full.
+    bool PrepareRead(int fd, void* buf, uint32_t size, uint64_t offset, uint64_t userData);
+    // Submits all queued reads and waits for @waitCount completions at least.
+    // Returns the number of reads submitted, or -errno.
+    int Submit(uint32_t waitCount = 0);
+    // Waits for @waitCount completions at least without submitting. Unlike other methods, it can be called while
+    // another thread prepares and submits reads, since no state of this object is touched.
+    // Returns 0, or -errno.
+    int WaitCompletions(uint32_t waitCount);
+    // number of reads queued but not submitted yet
+    uint32_t GetPendingCount() const { return mToSubmit; }
+    // Pops one completion. @result is the bytes read or -errno.
+    bool PopCompletion(uint64_t& userData, int32_t& result);
+
+private:
+    int mRingFd = -1;
+    uint32_t mSqEntries = 0;
+    uint32_t mToSubmit = 0;
+
+    void* mSqRingPtr = nullptr;
+    size_t mSqRingSize = 0;
+    void* mCqRingPtr = nullptr;
+    size_t mCqRingSize = 0;
+    void* mSqesPtr = nullptr;
+    size_t mSqesSize = 0;
+
+    uint32_t* mSqHead = nullptr;
+    uint32_t* mSqTail = nullptr;
+    uint32_t* mSqMask = nullptr;
+    uint32_t* mSqArray = nullptr;
+    uint32_t* mCqHead = nullptr;
+    uint32_t* mCqTail = nullptr;
+    uint32_t* mCqMask = nullptr;
+    void* mCqes = nullptr;
+};
+
+} // namespace logtail
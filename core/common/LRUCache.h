@@ -39,6 +39,7 @@
 #include <stdexcept>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace lru11 {
 /*
@@ -235,4 +236,202 @@ private:
     size_t elasticity_;
 };
 
+/**
+ * Hit, miss and eviction counts of a cache, see ShardedCache::collectStats().
+ */
+struct CacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+};
+
+/**
+ *	A thread-safe LRU cache split into shards by the hash of the key, each
+ *shard being an independent LRU list guarded by its own lock, so that
+ *threads working on different keys seldom contend.
+ *
+ *	Same API as Cache, except that:
+ *		- capacity is approximate: maxSize and elasticity are divided among the
+ *shards, and the recency order is only kept inside a shard
+ *		- getRef() is not provided, the reference would outlive the shard lock
+ *		- cwalk() visits shard by shard, with one shard locked at a time
+ *
+ *	The shard count is rounded up to a power of 2, and lowered for small
+ *caches so that each shard holds at least kMinShardSize keys.
+ */
+template <class Key, class Value, class Lock = std::mutex, class Hash = std::hash<Key>>
+class ShardedCache {
+public:
+    typedef KeyValuePair<Key, Value> node_type;
+    typedef std::list<KeyValuePair<Key, Value>> list_type;
+    typedef std::unordered_map<Key, typename list_type::iterator, Hash> map_type;
+    typedef Lock lock_type;
+    using Guard = std::lock_guard<lock_type>;
+
+    static constexpr size_t kDefaultShardCount = 16;
+    static constexpr size_t kMinShardSize = 8;
+
+    explicit ShardedCache(size_t maxSize = 64, size_t elasticity = 10, size_t shardCount = kDefaultShardCount)
+        : shards_(roundShardCount(maxSize, shardCount)), maxSize_(maxSize), elasticity_(elasticity) {
+        size_t count = shards_.size();
+        while ((static_cast<size_t>(1) << shardBits_) < count) {
+            ++shardBits_;
+        }
+        for (auto& shard : shards_) {
+            shard.maxSize = (maxSize + count - 1) / count;
+            shard.elasticity = (elasticity + count - 1) / count;
+        }
+    }
+    virtual ~ShardedCache() = default;
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards_) {
+            Guard g(shard.lock);
+            total += shard.cache.size();
+        }
+        return total;
+    }
+    bool empty() const { return size() == 0; }
+    void clear() {
+        for (auto& shard : shards_) {
+            Guard g(shard.lock);
+            shard.cache.clear();
+            shard.keys.clear();
+        }
+    }
+    void insert(const Key& k, Value v) {
+        Shard& shard = shardOf(k);
+        Guard g(shard.lock);
+        const auto iter = shard.cache.find(k);
+        if (iter != shard.cache.end()) {
+            iter->second->value = std::move(v);
+            shard.keys.splice(shard.keys.begin(), shard.keys, iter->second);
+            return;
+        }
+        shard.keys.emplace_front(k, std::move(v));
+        shard.cache[k] = shard.keys.begin();
+        shard.prune();
+    }
+    void emplace(const Key& k, Value&& v) { insert(k, std::move(v)); }
+
+    bool tryGet(const Key& kIn, Value& vOut) { return tryGetCopy(kIn, vOut); }
+    bool tryGetCopy(const Key& kIn, Value& vOut) {
+        Shard& shard = shardOf(kIn);
+        Guard g(shard.lock);
+        const auto iter = shard.cache.find(kIn);
+        if (iter == shard.cache.end()) {
+            ++shard.stats.misses;
+            return false;
+        }
+        ++shard.stats.hits;
+        shard.keys.splice(shard.keys.begin(), shard.keys, iter->second);
+        vOut = iter->second->value;
+        return true;
+    }
+    Value get(const Key& k) { return getCopy(k); }
+    Value getCopy(const Key& k) {
+        Value v;
+        if (!tryGetCopy(k, v)) {
+            throw KeyNotFound();
+        }
+        return v;
+    }
+
+    bool remove(const Key& k) {
+        Shard& shard = shardOf(k);
+        Guard g(shard.lock);
+        auto iter = shard.cache.find(k);
+        if (iter == shard.cache.end()) {
+            return false;
+        }
+        shard.keys.erase(iter->second);
+        shard.cache.erase(iter);
+        return true;
+    }
+    bool contains(const Key& k) const {
+        const Shard& shard = shardOf(k);
+        Guard g(shard.lock);
+        return shard.cache.find(k) != shard.cache.end();
+    }
+
+    size_t getMaxSize() const { return maxSize_; }
+    size_t getElasticity() const { return elasticity_; }
+    size_t getMaxAllowedSize() const { return maxSize_ + elasticity_; }
+    size_t getShardCount() const { return shards_.size(); }
+    template <typename F>
+    void cwalk(F& f) const {
+        for (const auto& shard : shards_) {
+            Guard g(shard.lock);
+            std::for_each(shard.keys.begin(), shard.keys.end(), f);
+        }
+    }
+
+    /**
+     * returns the counts since the last call and resets them, lookups
+     * through tryGet(), tryGetCopy(), get() and getCopy() are counted
+     */
+    CacheStats collectStats() {
+        CacheStats total;
+        for (auto& shard : shards_) {
+            Guard g(shard.lock);
+            total.hits += shard.stats.hits;
+            total.misses += shard.stats.misses;
+            total.evictions += shard.stats.evictions;
+            shard.stats = CacheStats();
+        }
+        return total;
+    }
+
+private:
+    // aligned to avoid false sharing between the locks of adjacent shards
+    struct alignas(64) Shard {
+        mutable Lock lock;
+        map_type cache;
+        list_type keys;
+        size_t maxSize = 0;
+        size_t elasticity = 0;
+        CacheStats stats;
+
+        void prune() {
+            if (maxSize == 0 || cache.size() < maxSize + elasticity) {
+                return;
+            }
+            while (cache.size() > maxSize) {
+                cache.erase(keys.back().key);
+                keys.pop_back();
+                ++stats.evictions;
+            }
+        }
+    };
+
+    static size_t roundShardCount(size_t maxSize, size_t shardCount) {
+        size_t count = 1;
+        while (count < shardCount && (maxSize == 0 || maxSize / (count * 2) >= kMinShardSize)) {
+            count *= 2;
+        }
+        return count;
+    }
+
+    // the shard is picked by the high bits of the mixed hash, the shard map buckets by the low ones
+    size_t shardIndex(const Key& k) const {
+        if (shardBits_ == 0) {
+            return 0;
+        }
+        uint64_t h = static_cast<uint64_t>(hash_(k)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(h >> (64 - shardBits_));
+    }
+    Shard& shardOf(const Key& k) { return shards_[shardIndex(k)]; }
+    const Shard& shardOf(const Key& k) const { return shards_[shardIndex(k)]; }
+
+    ShardedCache(const ShardedCache&) = delete;
+    ShardedCache& operator=(const ShardedCache&) = delete;
+
+    std::vector<Shard> shards_;
+    size_t shardBits_ = 0;
+    Hash hash_;
+    size_t maxSize_;
+    size_t elasticity_;
+};
+
 } // namespace lru11
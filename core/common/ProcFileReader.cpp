@@ -0,0 +1,185 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/ProcFileReader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace logtail {
+
+ProcFileReader::ProcFileReader(std::filesystem::path procPath, size_t maxCachedPidDirs)
+    : mProcPath(std::move(procPath)), mMaxCachedPidDirs(maxCachedPidDirs) {
+}
+
+ProcFileReader::~ProcFileReader() {
+    std::lock_guard<std::mutex> lock(mMux);
+    closeAllLocked();
+}
+
+bool ProcFileReader::ReadPidFile(pid_t pid, const char* name, std::string& buffer, StringView& content) {
+    int fd = -1;
+    if (mMaxCachedPidDirs == 0) {
+        int procFd = mProcDirFd.load(std::memory_order_acquire);
+        if (procFd < 0) {
+            std::lock_guard<std::mutex> lock(mMux);
+            procFd = procDirFdLocked();
+            if (procFd < 0) {
+                return false;
+            }
+        }
+        char relPath[64];
+        snprintf(relPath, sizeof(relPath), "%d/%s", pid, name);
+        fd = openat(procFd, relPath, O_RDONLY | O_CLOEXEC);
+    } else {
+        std::lock_guard<std::mutex> lock(mMux);
+        bool cached = false;
+        int dirFd = pidDirFd(pid, cached);
+        if (dirFd >= 0) {
+            fd = openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+            // the cached dir belongs to an exited process, the pid may have been reused
+            if (fd < 0 && cached && (errno == ENOENT || errno == ESRCH)) {
+                close(dirFd);
+                mPidDirFds.erase(pid);
+                dirFd = pidDirFd(pid, cached);
+                if (dirFd >= 0) {
+                    fd = openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+                }
+            }
+        }
+    }
+    if (fd < 0) {
+        return false;
+    }
+    size_t size = 0;
+    bool res = readAll(fd, buffer, size);
+    close(fd);
+    if (!res) {
+        return false;
+    }
+    content = StringView(buffer.data(), size);
+    return true;
+}
+
+void ProcFileReader::RetainPids(const std::vector<pid_t>& pids) {
+    std::lock_guard<std::mutex> lock(mMux);
+    if (mPidDirFds.empty()) {
+        return;
+    }
+    std::unordered_set<pid_t> alive(pids.begin(), pids.end());
+    for (auto it = mPidDirFds.begin(); it != mPidDirFds.end();) {
+        if (alive.find(it->first) == alive.end()) {
+            close(it->second);
+            it = mPidDirFds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ProcFileReader::SetProcPath(const std::filesystem::path& procPath) {
+    std::lock_guard<std::mutex> lock(mMux);
+    if (procPath.native() == mProcPath.native()) {
+        return;
+    }
+    closeAllLocked();
+    mProcPath = procPath;
+}
+
+size_t ProcFileReader::CachedPidDirCount() const {
+    std::lock_guard<std::mutex> lock(mMux);
+    return mPidDirFds.size();
+}
+
+int ProcFileReader::procDirFdLocked() {
+    int fd = mProcDirFd.load(std::memory_order_relaxed);
+    if (fd < 0) {
+        fd = open(mProcPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        mProcDirFd.store(fd, std::memory_order_release);
+    }
+    return fd;
+}
+
+int ProcFileReader::pidDirFd(pid_t pid, bool& cached) {
+    auto it = mPidDirFds.find(pid);
+    if (it != mPidDirFds.end()) {
+        cached = true;
+        return it->second;
+    }
+    cached = false;
+    int procFd = procDirFdLocked();
+    if (procFd < 0) {
+        return -1;
+    }
+    char pidStr[16];
+    snprintf(pidStr, sizeof(pidStr), "%d", pid);
+    int dirFd = openat(procFd, pidStr, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        return -1;
+    }
+    if (mPidDirFds.size() >= mMaxCachedPidDirs) {
+        // cache is full, evict an arbitrary entry, it is reopened on its next read
+        auto victim = mPidDirFds.begin();
+        close(victim->second);
+        mPidDirFds.erase(victim);
+    }
+    mPidDirFds.emplace(pid, dirFd);
+    return dirFd;
+}
+
+void ProcFileReader::closeAllLocked() {
+    for (auto& [pid, fd] : mPidDirFds) {
+        close(fd);
+    }
+    mPidDirFds.clear();
+    int fd = mProcDirFd.exchange(-1);
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool ProcFileReader::readAll(int fd, std::string& buffer, size_t& size) {
+    if (buffer.size() < kInitialBufferSize) {
+        buffer.resize(kInitialBufferSize);
+    }
+    size = 0;
+    while (true) {
+        ssize_t n = read(fd, buffer.data() + size, buffer.size() - size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (n == 0) {
+            return true;
+        }
+        size += n;
+        if (size == buffer.size()) {
+            // content of /proc files is bounded in practice, the rest is dropped
+            if (buffer.size() >= kMaxFileSize) {
+                return true;
+            }
+            buffer.resize(std::min(buffer.size() * 2, kMaxFileSize));
+        }
+    }
+}
+
+} // namespace logtail
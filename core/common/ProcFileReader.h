@@ -0,0 +1,82 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/StringView.h"
+
+namespace logtail {
+
+// Reader of /proc/<pid>/<file> for collectors which scan every process periodically.
+// The /proc dir fd (and optionally the <pid> dir fds) are kept open across collection cycles, files are opened with
+// openat relative to them and read into a caller owned buffer which is reused, so no path is built and no memory is
+// allocated per file in steady state.
+// A cached <pid> dir fd of an exited process fails with ENOENT/ESRCH on openat, it is then reopened once, which also
+// covers pid reuse.
+// Thread-safe, the buffer must not be shared between threads. Without cached <pid> dir fds, reads take no lock once
+// the /proc dir is opened, so that threads sharing the reader do not serialize on it.
+// SetProcPath must not be called concurrently with reads then.
+class ProcFileReader {
+public:
+    // maxCachedPidDirs = 0 disables caching of <pid> dir fds, only the /proc dir fd is kept
+    explicit ProcFileReader(std::filesystem::path procPath, size_t maxCachedPidDirs = 0);
+    ~ProcFileReader();
+    ProcFileReader(const ProcFileReader&) = delete;
+    ProcFileReader& operator=(const ProcFileReader&) = delete;
+
+    // read the whole /proc/<pid>/<name>, content points into buffer and is valid until the next read with it
+    bool ReadPidFile(pid_t pid, const char* name, std::string& buffer, StringView& content);
+
+    // close cached <pid> dir fds of processes not in pids, should be called once per cycle with the current pid list
+    void RetainPids(const std::vector<pid_t>& pids);
+
+    // switch to another proc root, all cached fds are closed if it differs from the current one
+    void SetProcPath(const std::filesystem::path& procPath);
+
+    size_t CachedPidDirCount() const;
+
+    static constexpr size_t kInitialBufferSize = 4096;
+    static constexpr size_t kMaxFileSize = 1024 * 1024;
+
+private:
+    int procDirFdLocked();
+    int pidDirFd(pid_t pid, bool& cached);
+    void closeAllLocked();
+    static bool readAll(int fd, std::string& buffer, size_t& size);
+
+    std::filesystem::path mProcPath;
+    size_t mMaxCachedPidDirs;
+
+    mutable std::mutex mMux;
+    // written under mMux, read without it when <pid> dir fds are not cached
+    std::atomic_int mProcDirFd{-1};
+    std::unordered_map<pid_t, int> mPidDirFds;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ProcFileReaderUnittest;
+#endif
+};
+
+} // namespace logtail
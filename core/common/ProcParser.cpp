@@ -500,11 +500,10 @@ std::tuple<std::string, std::string> ProcParser::ProcsFilename(const std::string
 }
 
 bool ProcParser::ReadProcessStat(pid_t pid, ProcessStat& ps) const {
-    auto processStat = mProcPath / std::to_string(pid) / "stat";
-
-    std::string line;
-    if (FileReadResult::kOK != ReadFileContent(processStat.string(), line, kDefaultMaxFileSize)) {
-        LOG_WARNING(sLogger, ("read process stat", "fail")("file", processStat));
+    thread_local std::string sBuffer;
+    StringView line;
+    if (!mProcReader->ReadPidFile(pid, "stat", sBuffer, line)) {
+        LOG_WARNING(sLogger, ("read process stat", "fail")("file", procPidPath(pid, "stat")));
         return false;
     }
     return ParseProcessStat(pid, line, ps);
@@ -514,19 +513,23 @@ bool ProcParser::ReadProcessStat(pid_t pid, ProcessStat& ps) const {
 // 1 (cat) R 0 1 1 34816 1 4194560 1110 0 0 0 1 1 0 0 20 0 1 0 18938584 4505600 171 18446744073709551615 4194304 4238788
 // 140727020025920 0 0 0 0 0 0 0 0 0 17 3 0 0 0 0 0 6336016 6337300 21442560 140727020027760 140727020027777
 // 140727020027777 140727020027887 0
-bool ProcParser::ParseProcessStat(pid_t pid, const std::string& line, ProcessStat& ps) const {
+bool ProcParser::ParseProcessStat(pid_t pid, StringView line, ProcessStat& ps) const {
     ps.pid = pid;
     auto nameStartPos = line.find_first_of('(');
     auto nameEndPos = line.find_last_of(')');
-    if (nameStartPos == std::string::npos || nameEndPos == std::string::npos || nameStartPos >= nameEndPos) {
+    if (nameStartPos == StringView::npos || nameEndPos == StringView::npos || nameStartPos >= nameEndPos
+        || nameEndPos + 2 > line.size()) {
         LOG_WARNING(sLogger, ("can't find process name", pid)("stat", line));
         return false;
     }
     nameStartPos++; // 跳过左括号
-    ps.name = line.substr(nameStartPos, nameEndPos - nameStartPos);
-    StringView lineview = StringView(line).substr(nameEndPos + 2); // 跳过右括号及空格
+    ps.name.assign(line.data() + nameStartPos, nameEndPos - nameStartPos);
+    StringView lineview = line.substr(nameEndPos + 2); // 跳过右括号及空格
 
-    std::array<StringView, size_t(EnumProcessStat::_count)> words{};
+    constexpr const EnumProcessStat offset = EnumProcessStat::state; // 跳过pid, comm
+    constexpr const int minCount = EnumProcessStat::processor - offset + 1; // 37
+    // 只切分到需要的最后一个字段 processor
+    std::array<StringView, minCount> words{};
     StringViewSplitter splitter(lineview, " ");
     size_t i = 0;
     for (const auto& word : splitter) {
@@ -536,9 +539,7 @@ bool ProcParser::ParseProcessStat(pid_t pid, const std::string& line, ProcessSta
         words[i++] = word;
     }
 
-    constexpr const EnumProcessStat offset = EnumProcessStat::state; // 跳过pid, comm
-    constexpr const int minCount = EnumProcessStat::processor - offset + 1; // 37
-    if (words.size() < minCount) {
+    if (i < minCount) {
         LOG_WARNING(sLogger, ("unexpected item count", pid)("stat", line));
         return false;
     }
@@ -598,11 +599,10 @@ bool ProcParser::ParseProcessStat(pid_t pid, const std::string& line, ProcessSta
 
 // 读取 /proc/<pid>/status 文件
 bool ProcParser::ReadProcessStatus(pid_t pid, ProcessStatus& ps) const {
-    auto processStatus = mProcPath / std::to_string(pid) / "status";
-
-    std::string content;
-    if (FileReadResult::kOK != ReadFileContent(processStatus.string(), content, kDefaultMaxFileSize)) {
-        LOG_WARNING(sLogger, ("read process status", "fail")("file", processStatus));
+    thread_local std::string sBuffer;
+    StringView content;
+    if (!mProcReader->ReadPidFile(pid, "status", sBuffer, content)) {
+        LOG_WARNING(sLogger, ("read process status", "fail")("file", procPidPath(pid, "status")));
         return false;
     }
     return ParseProcessStatus(pid, content, ps);
@@ -624,10 +624,10 @@ bool ProcParser::ReadProcessStatus(pid_t pid, ProcessStatus& ps) const {
 // CapPrm:	0000000000000000
 // CapEff:	0000000000000000
 // ...
-bool ProcParser::ParseProcessStatus(pid_t pid, const std::string& content, ProcessStatus& ps) const {
+bool ProcParser::ParseProcessStatus(pid_t pid, StringView content, ProcessStatus& ps) const {
     ps.pid = pid;
 
-    StringViewSplitter lineSplitter(StringView(content), "\n");
+    StringViewSplitter lineSplitter(content, "\n");
     for (const auto& line : lineSplitter) {
         auto colonPos = line.find(':');
         if (colonPos == StringView::npos || colonPos == line.size() - 1) {
@@ -17,10 +17,12 @@
 #include <cstdint>
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
+#include "common/ProcFileReader.h"
 #include "common/StringView.h"
 #include "common/memory/SourceBuffer.h"
 
@@ -195,7 +197,8 @@ struct ProcessStatus {
 
 class ProcParser {
 public:
-    explicit ProcParser(const std::string& prefix) : mProcPath(prefix + "/proc") {}
+    explicit ProcParser(const std::string& prefix)
+        : mProcPath(prefix + "/proc"), mProcReader(std::make_shared<ProcFileReader>(mProcPath)) {}
     bool ParseProc(uint32_t pid, Proc& proc) const;
 
     std::string GetPIDCmdline(uint32_t pid) const;
@@ -203,9 +206,9 @@ public:
     std::string GetPIDEnviron(uint32_t pid) const;
     uint32_t GetPIDCWD(uint32_t pid, std::string& cwd) const;
     bool ReadProcessStat(pid_t pid, ProcessStat& ps) const;
-    bool ParseProcessStat(pid_t pid, const std::string& line, ProcessStat& ps) const;
+    bool ParseProcessStat(pid_t pid, StringView line, ProcessStat& ps) const;
     bool ReadProcessStatus(pid_t pid, ProcessStatus& ps) const;
-    bool ParseProcessStatus(pid_t pid, const std::string& content, ProcessStatus& ps) const;
+    bool ParseProcessStatus(pid_t pid, StringView content, ProcessStatus& ps) const;
     int64_t GetStatsKtime(ProcessStat& procStat) const;
     uid_t GetLoginUid(uint32_t pid) const;
 
@@ -243,6 +246,9 @@ private:
     static bool isValidContainerId(const StringView& id, bool bpfSource);
 
     std::filesystem::path mProcPath;
+    // shared by copies of the parser, stat/status of every pid are read through it with a thread local buffer,
+    // without locking since no pid dir fd is cached
+    std::shared_ptr<ProcFileReader> mProcReader;
 
     static constexpr size_t kContainerIdLength = 64;
     static constexpr size_t kBpfContainerIdLength = 31;
@@ -40,7 +40,7 @@ list(APPEND THIS_SOURCE_FILES_LIST ${CMAKE_SOURCE_DIR}/common/auth/AuthConfig.cp
 list(REMOVE_ITEM THIS_SOURCE_FILES_LIST ${CMAKE_SOURCE_DIR}/common/BoostRegexValidator.cpp ${CMAKE_SOURCE_DIR}/common/GetUUID.cpp)
 
 if(MSVC)
-    list(REMOVE_ITEM THIS_SOURCE_FILES_LIST ${CMAKE_SOURCE_DIR}/common/ProcParser.h ${CMAKE_SOURCE_DIR}/common/ProcParser.cpp)
+    list(REMOVE_ITEM THIS_SOURCE_FILES_LIST ${CMAKE_SOURCE_DIR}/common/ProcParser.h ${CMAKE_SOURCE_DIR}/common/ProcParser.cpp ${CMAKE_SOURCE_DIR}/common/ProcFileReader.h ${CMAKE_SOURCE_DIR}/common/ProcFileReader.cpp)
     if (ENABLE_ENTERPRISE)
         list(REMOVE_ITEM THIS_SOURCE_FILES_LIST ${CMAKE_SOURCE_DIR}/common/LinuxDaemonUtil.h ${CMAKE_SOURCE_DIR}/common/LinuxDaemonUtil.cpp)
     endif()
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/compression/SnappyCompressor.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <vector>
+
+using namespace std;
+
+namespace logtail {
+
+static const size_t kBlockSize = 1 << 16;
+static const uint32_t kHashBits = 14;
+// no match is looked for in the last bytes of a block, so that 4 bytes can always be loaded at the position tried
+static const size_t kInputMarginBytes = 15;
+
+static const uint8_t kTagLiteral = 0;
+static const uint8_t kTagCopy1 = 1;
+static const uint8_t kTagCopy2 = 2;
+static const uint8_t kTagCopy4 = 3;
+
+static inline uint32_t Load32(const char* p) {
+    uint32_t v = 0;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t Hash(uint32_t v) {
+    return (v * 0x1e35a7bd) >> (32 - kHashBits);
+}
+
+static void EmitLiteral(const char* data, size_t len, string& output) {
+    if (len == 0) {
+        return;
+    }
+    size_t n = len - 1;
+    if (n < 60) {
+        output.push_back(static_cast<char>(n << 2 | kTagLiteral));
+    } else {
+        uint8_t cnt = 0;
+        char bytes[4];
+        while (n > 0) {
+            bytes[cnt++] = static_cast<char>(n & 0xFF);
+            n >>= 8;
+        }
+        output.push_back(static_cast<char>((59 + cnt) << 2 | kTagLiteral));
+        output.append(bytes, cnt);
+    }
+    output.append(data, len);
+}
+
+// offset is always less than kBlockSize, and len is at least 4
+static void EmitCopy(size_t offset, size_t len, string& output) {
+    // copies with 2-byte offset can hold at most 64 bytes, and the last one must be at least 4 bytes long
+    while (len >= 68) {
+        output.push_back(static_cast<char>((64 - 1) << 2 | kTagCopy2));
+        output.push_back(static_cast<char>(offset & 0xFF));
+        output.push_back(static_cast<char>(offset >> 8));
+        len -= 64;
+    }
+    if (len > 64) {
+        output.push_back(static_cast<char>((60 - 1) << 2 | kTagCopy2));
+        output.push_back(static_cast<char>(offset & 0xFF));
+        output.push_back(static_cast<char>(offset >> 8));
+        len -= 60;
+    }
+    if (len < 12 && offset < 2048) {
+        output.push_back(static_cast<char>((offset >> 8) << 5 | (len - 4) << 2 | kTagCopy1));
+        output.push_back(static_cast<char>(offset & 0xFF));
+    } else {
+        output.push_back(static_cast<char>((len - 1) << 2 | kTagCopy2));
+        output.push_back(static_cast<char>(offset & 0xFF));
+        output.push_back(static_cast<char>(offset >> 8));
+    }
+}
+
+static void CompressBlock(const char* block, size_t blockLen, vector<uint16_t>& table, string& output) {
+    size_t nextEmit = 0;
+    if (blockLen >= kInputMarginBytes) {
+        fill(table.begin(), table.end(), 0);
+        size_t ipLimit = blockLen - kInputMarginBytes;
+        size_t ip = 1;
+        while (ip < ipLimit) {
+            uint32_t cur = Load32(block + ip);
+            uint32_t h = Hash(cur);
+            size_t candidate = table[h];
+            table[h] = static_cast<uint16_t>(ip);
+            if (Load32(block + candidate) != cur) {
+                // skip faster when no match has been found for long
+                ip += 1 + ((ip - nextEmit) >> 5);
+                continue;
+            }
+            EmitLiteral(block + nextEmit, ip - nextEmit, output);
+            size_t matched = 4;
+            while (ip + matched < blockLen && block[candidate + matched] == block[ip + matched]) {
+                ++matched;
+            }
+            EmitCopy(ip - candidate, matched, output);
+            ip += matched;
+            nextEmit = ip;
+            if (ip >= ipLimit) {
+                break;
+            }
+            table[Hash(Load32(block + ip - 1))] = static_cast<uint16_t>(ip - 1);
+        }
+    }
+    EmitLiteral(block + nextEmit, blockLen - nextEmit, output);
+}
+
+bool SnappyCompressor::Compress(const string& input, string& output, string& errorMsg) {
+    if (input.size() > UINT32_MAX) {
+        errorMsg = "input size is too large";
+        return false;
+    }
+    output.clear();
+    // the worst case of the reference implementation
+    output.reserve(32 + input.size() + input.size() / 6);
+    size_t n = input.size();
+    while (n >= 0x80) {
+        output.push_back(static_cast<char>(n | 0x80));
+        n >>= 7;
+    }
+    output.push_back(static_cast<char>(n));
+
+    vector<uint16_t> table(1 << kHashBits);
+    for (size_t pos = 0; pos < input.size(); pos += kBlockSize) {
+        CompressBlock(input.data() + pos, min(kBlockSize, input.size() - pos), table, output);
+    }
+    return true;
+}
+
+#ifdef APSARA_UNIT_TEST_MAIN
+bool SnappyCompressor::UnCompress(const string& input, string& output, string& errorMsg) {
+    const auto* p = reinterpret_cast<const uint8_t*>(input.data());
+    const auto* end = p + input.size();
+    uint64_t length = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (p == end) {
+            errorMsg = "invalid length";
+            return false;
+        }
+        uint8_t b = *p++;
+        length |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (b < 0x80) {
+            break;
+        }
+    }
+    if (length != output.size()) {
+        errorMsg = "length mismatch";
+        return false;
+    }
+
+    size_t op = 0;
+    while (p < end) {
+        uint8_t tag = *p++;
+        size_t len = 0;
+        size_t offset = 0;
+        switch (tag & 0x03) {
+            case kTagLiteral: {
+                len = (tag >> 2) + 1;
+                if (len > 60) {
+                    size_t cnt = len - 60;
+                    if (static_cast<size_t>(end - p) < cnt) {
+                        errorMsg = "invalid literal";
+                        return false;
+                    }
+                    len = 0;
+                    for (size_t i = 0; i < cnt; ++i) {
+                        len |= static_cast<size_t>(p[i]) << (8 * i);
+                    }
+                    len += 1;
+                    p += cnt;
+                }
+                if (static_cast<size_t>(end - p) < len || output.size() - op < len) {
+                    errorMsg = "invalid literal";
+                    return false;
+                }
+                memcpy(&output[op], p, len);
+                p += len;
+                op += len;
+                continue;
+            }
+            case kTagCopy1:
+                if (end - p < 1) {
+                    errorMsg = "invalid copy";
+                    return false;
+                }
+                len = ((tag >> 2) & 0x07) + 4;
+                offset = static_cast<size_t>(tag >> 5) << 8 | p[0];
+                p += 1;
+                break;
+            case kTagCopy2:
+                if (end - p < 2) {
+                    errorMsg = "invalid copy";
+                    return false;
+                }
+                len = (tag >> 2) + 1;
+                offset = static_cast<size_t>(p[0]) | static_cast<size_t>(p[1]) << 8;
+                p += 2;
+                break;
+            case kTagCopy4:
+                if (end - p < 4) {
+                    errorMsg = "invalid copy";
+                    return false;
+                }
+                len = (tag >> 2) + 1;
+                offset = static_cast<size_t>(Load32(reinterpret_cast<const char*>(p)));
+                p += 4;
+                break;
+        }
+        if (offset == 0 || offset > op || output.size() - op < len) {
+            errorMsg = "invalid copy";
+            return false;
+        }
+        // copies may overlap with their own output
+        for (size_t i = 0; i < len; ++i, ++op) {
+            output[op] = output[op - offset];
+        }
+    }
+    if (op != output.size()) {
+        errorMsg = "length mismatch";
+        return false;
+    }
+    return true;
+}
+#endif
+
+} // namespace logtail
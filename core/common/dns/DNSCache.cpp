@@ -15,6 +15,10 @@
 #include "DNSCache.h"
 
 #include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
 #if defined(__linux__)
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -23,14 +27,148 @@
 #include <ws2tcpip.h>
 #endif
 
+#include "logger/Logger.h"
+
 DEFINE_FLAG_INT32(dns_cache_ttl_sec, "", 600);
+DEFINE_FLAG_INT32(dns_cache_refresh_interval_sec, "interval to resolve hosts in dns cache in advance, seconds", 60);
+DEFINE_FLAG_INT32(dns_cache_negative_ttl_sec, "ttl of hosts failed to be resolved in dns cache, seconds", 10);
+
+using namespace std;
 
 namespace logtail {
-DnsCache::DnsCache(const int32_t ttlSeconds) : mUpdateTime(time(NULL)), mDnsTTL(ttlSeconds) {
+
+DnsCache::DnsCache(int32_t ttlSeconds, int32_t refreshIntervalSeconds, int32_t negativeTTLSeconds, Resolver resolver)
+    : mDnsTTL(ttlSeconds),
+      mRefreshInterval(refreshIntervalSeconds),
+      mNegativeTTL(negativeTTLSeconds),
+      mResolver(std::move(resolver)),
+      mEntries(make_shared<const EntryMap>()) {
+}
+
+bool DnsCache::GetIPFromDnsCache(const string& host, string& address) {
+    if (host.empty()) {
+        return false;
+    }
+    if (IsRawIp(host.c_str())) {
+        address = host;
+        return true;
+    }
+
+    auto entries = atomic_load(&mEntries);
+    int32_t curTime = time(nullptr);
+    auto itr = entries->find(host);
+    if (itr == entries->end()) {
+        Prefetch(host);
+        return false;
+    }
+    const auto& entry = itr->second;
+    if (entry.mAddress.empty()) {
+        if (curTime - entry.mResolveTime >= mNegativeTTL) {
+            Prefetch(host);
+        }
+        return false;
+    }
+    if (curTime - entry.mSuccessTime >= mDnsTTL) {
+        Prefetch(host);
+        return false;
+    }
+    if (curTime - entry.mResolveTime >= mRefreshInterval) {
+        // still valid, refreshed in advance
+        Prefetch(host);
+    }
+    address = entry.mAddress;
+    return true;
+}
+
+void DnsCache::Stop() {
+    {
+        lock_guard<mutex> lock(mPendingMux);
+        mIsStopped = true;
+    }
+    mCond.notify_one();
+    if (mThreadRes.valid()) {
+        mThreadRes.get();
+    }
+}
+
+void DnsCache::Prefetch(const string& host) {
+    {
+        lock_guard<mutex> lock(mPendingMux);
+        if (mIsStopped || !mPendingHosts.insert(host).second) {
+            return;
+        }
+        // started on demand, since dns cache is not used unless required
+        if (!mThreadRes.valid()) {
+            mThreadRes = async(launch::async, &DnsCache::Run, this);
+        }
+    }
+    mCond.notify_one();
+}
+
+void DnsCache::Run() {
+    unique_lock<mutex> lock(mPendingMux);
+    while (true) {
+        // also wakes up regularly to evict expired entries
+        mCond.wait_for(lock, chrono::seconds(1), [this] { return mIsStopped || !mPendingHosts.empty(); });
+        if (mIsStopped) {
+            break;
+        }
+        unordered_set<string> hosts;
+        hosts.swap(mPendingHosts);
+        lock.unlock();
+        Update(hosts);
+        lock.lock();
+    }
+}
+
+void DnsCache::Update(const unordered_set<string>& hosts) {
+    vector<pair<string, string>> resolved;
+    vector<string> failed;
+    for (const auto& host : hosts) {
+        string ip;
+        if (mResolver(host, ip)) {
+            resolved.emplace_back(host, std::move(ip));
+        } else {
+            LOG_DEBUG(sLogger, ("failed to resolve host", host));
+            failed.emplace_back(host);
+        }
+    }
+
+    auto current = atomic_load(&mEntries);
+    int32_t curTime = time(nullptr);
+    auto isExpired = [&](const Entry& entry) {
+        return entry.mAddress.empty() ? curTime - entry.mResolveTime >= mNegativeTTL
+                                      : curTime - entry.mSuccessTime >= mDnsTTL;
+    };
+    if (hosts.empty()
+        && none_of(current->begin(), current->end(), [&](const auto& item) { return isExpired(item.second); })) {
+        return;
+    }
+
+    // copy on write, so that readers are never blocked
+    auto entries = make_shared<EntryMap>(*current);
+    for (auto itr = entries->begin(); itr != entries->end();) {
+        if (isExpired(itr->second)) {
+            itr = entries->erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    for (auto& item : resolved) {
+        auto& entry = (*entries)[item.first];
+        entry.mAddress = std::move(item.second);
+        entry.mResolveTime = entry.mSuccessTime = curTime;
+    }
+    for (const auto& host : failed) {
+        // the last address resolved is kept until expired
+        (*entries)[host].mResolveTime = curTime;
+    }
+    atomic_store(&mEntries, shared_ptr<const EntryMap>(std::move(entries)));
 }
 
 // ParseHost only supports IPv4 now.
-bool DnsCache::ParseHost(const char* host, std::string& ip) {
+bool DnsCache::ParseHost(const std::string& hostStr, std::string& ip) {
+    const char* host = hostStr.c_str();
 #if defined(__linux__)
     struct sockaddr_in addr;
     memset(&addr, 0, sizeof(addr));
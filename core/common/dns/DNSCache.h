@@ -19,72 +19,60 @@
 #include <cstdint>
 #include <ctime>
 
-#include <map>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "common/Flags.h"
 
 DECLARE_FLAG_INT32(dns_cache_ttl_sec);
+DECLARE_FLAG_INT32(dns_cache_refresh_interval_sec);
+DECLARE_FLAG_INT32(dns_cache_negative_ttl_sec);
 
 namespace logtail {
 
+// DnsCache resolves hosts in a background thread, so that looking up the cache never blocks on dns.
+// The cache is an immutable snapshot replaced as a whole by the background thread after each round of resolution,
+// readers only take a reference of the current snapshot. Entries accessed are refreshed in advance every
+// dns_cache_refresh_interval_sec, and expire dns_cache_ttl_sec after the last successful resolution. Hosts failed to
+// be resolved are cached as well for dns_cache_negative_ttl_sec.
 class DnsCache {
-    int32_t mUpdateTime;
-    int32_t mDnsTTL;
-    std::mutex mDnsCacheLock;
-    std::map<std::string, std::pair<std::string, int32_t>> mDnsCacheData;
-
 public:
+    using Resolver = std::function<bool(const std::string& host, std::string& ip)>;
+
+    DnsCache(const DnsCache&) = delete;
+    DnsCache& operator=(const DnsCache&) = delete;
+
     static DnsCache* GetInstance() {
         static DnsCache singleton;
         return &singleton;
     }
 
-    bool UpdateHostInDnsCache(const std::string& host, std::string& address) {
-        int32_t currentTime = time(NULL);
-        bool status = false;
-        std::lock_guard<std::mutex> lock(mDnsCacheLock);
-
-        auto itr = mDnsCacheData.find(host);
-        if (itr == mDnsCacheData.end() || currentTime - (itr->second).second >= 3) {
-            if (ParseHost(host.c_str(), address)) {
-                status = true;
-                mDnsCacheData[host] = std::make_pair(address, currentTime);
-            } else {
-                if (itr == mDnsCacheData.end()) {
-                    status = false;
-                } else {
-                    mDnsCacheData[host] = std::make_pair((itr->second).first, currentTime);
-                }
-            }
-        }
-
-        return status;
-    }
-
-    bool GetIPFromDnsCache(const std::string& host, std::string& address) {
-        bool found = false;
-        {
-            std::lock_guard<std::mutex> lock(mDnsCacheLock);
-            if (!RemoveTimeOutDnsCache()) // not time out
-            {
-                auto itr = mDnsCacheData.find(host);
-                if (itr != mDnsCacheData.end()) {
-                    address = (itr->second).first;
-                    found = true;
-                }
-            }
-        }
-        if (!found) // time out or not found
-            return UpdateHostInDnsCache(host, address);
-        return found;
-    }
+    // returns false if the host is not resolved yet, which will be resolved in the background
+    bool GetIPFromDnsCache(const std::string& host, std::string& address);
+    void Stop();
 
 private:
-    DnsCache(const int32_t ttlSeconds = INT32_FLAG(dns_cache_ttl_sec));
-    ~DnsCache() = default;
-
-    bool IsRawIp(const char* host) {
+    struct Entry {
+        // empty if the host failed to be resolved
+        std::string mAddress;
+        int32_t mResolveTime = 0;
+        int32_t mSuccessTime = 0;
+    };
+    using EntryMap = std::unordered_map<std::string, Entry>;
+
+    DnsCache(int32_t ttlSeconds = INT32_FLAG(dns_cache_ttl_sec),
+             int32_t refreshIntervalSeconds = INT32_FLAG(dns_cache_refresh_interval_sec),
+             int32_t negativeTTLSeconds = INT32_FLAG(dns_cache_negative_ttl_sec),
+             Resolver resolver = ParseHost);
+    ~DnsCache() { Stop(); }
+
+    static bool IsRawIp(const char* host) {
         unsigned char c, *p;
         p = (unsigned char*)host;
         while ((c = (*p++)) != '\0') {
@@ -94,18 +82,29 @@ private:
         return true;
     }
 
-    bool ParseHost(const char* host, std::string& ip);
+    static bool ParseHost(const std::string& host, std::string& ip);
 
-    bool RemoveTimeOutDnsCache() {
-        int32_t currentTime = time(NULL);
-        bool isTimeOut = false;
-        if (currentTime - mUpdateTime >= mDnsTTL) {
-            isTimeOut = true;
-            mDnsCacheData.clear();
-            mUpdateTime = currentTime;
-        }
-        return isTimeOut;
-    }
+    void Prefetch(const std::string& host);
+    void Run();
+    void Update(const std::unordered_set<std::string>& hosts);
+
+    const int32_t mDnsTTL;
+    const int32_t mRefreshInterval;
+    const int32_t mNegativeTTL;
+    const Resolver mResolver;
+
+    // only replaced by the background thread, accessed with std::atomic_load and std::atomic_store
+    std::shared_ptr<const EntryMap> mEntries;
+
+    std::mutex mPendingMux;
+    std::condition_variable mCond;
+    std::unordered_set<std::string> mPendingHosts;
+    bool mIsStopped = false;
+    std::future<void> mThreadRes;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class DnsCacheUnittest;
+#endif
 };
 
 } // namespace logtail
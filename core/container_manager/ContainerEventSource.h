@@ -0,0 +1,50 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <functional>
+#include <string>
+
+namespace logtail {
+
+enum class ContainerEventType { CREATED, STARTED, STOPPED, DELETED };
+
+struct ContainerEvent {
+    std::string mContainerID;
+    ContainerEventType mType = ContainerEventType::CREATED;
+    // when the event happened in the runtime, in milliseconds since epoch
+    uint64_t mTimeMs = 0;
+};
+
+// Stream of container lifecycle events from the container runtime. Events only tell which containers have changed,
+// the container meta is still fetched from the go plugin.
+class ContainerEventSource {
+public:
+    virtual ~ContainerEventSource() = default;
+
+    // Blocks and passes each event to handler until the stream breaks or Stop is called.
+    // false if the stream cannot be set up or is broken, the caller may run it again later.
+    virtual bool Run(const std::function<void(const ContainerEvent&)>& handler) = 0;
+    // thread-safe, makes the ongoing and all later Run return
+    virtual void Stop() = 0;
+    // false if the runtime does not provide container events at all, no need to run again
+    virtual bool IsSupported() const = 0;
+};
+
+} // namespace logtail
@@ -3,7 +3,6 @@
 #include <ctime>
 
 #include <algorithm>
-#include <boost/regex.hpp>
 #include <chrono>
 
 #include "json/json.h"
@@ -12,8 +11,10 @@
 #include "app_config/AppConfig.h"
 #include "collection_pipeline/CollectionPipelineContext.h"
 #include "common/FileSystemUtil.h"
+#include "common/Flags.h"
 #include "common/JsonUtil.h"
 #include "common/StringTools.h"
+#include "common/TimeUtil.h"
 #include "constants/Constants.h"
 #include "constants/TagConstants.h"
 #include "container_manager/ContainerDiff.h"
@@ -22,6 +23,29 @@
 #include "go_pipeline/LogtailPlugin.h"
 #include "monitor/Monitor.h"
 #include "monitor/SelfMonitorServer.h"
+#include "monitor/metric_constants/MetricConstants.h"
+#if defined(__linux__)
+#include "container_manager/cri/CriContainerEventSource.h"
+#endif
+
+DEFINE_FLAG_BOOL(container_discovery_enable_event,
+                 "subscribe container events from the cri runtime to discover containers at once, polling is kept as "
+                 "fallback",
+                 true);
+DEFINE_FLAG_STRING(container_runtime_endpoint,
+                   "grpc endpoint of the cri runtime for container events",
+                   "unix:///run/containerd/containerd.sock");
+DEFINE_FLAG_INT32(container_discovery_polling_interval, "seconds between two container meta pollings", 3);
+DEFINE_FLAG_INT32(container_event_retry_interval_ms,
+                  "interval to fetch container meta again when a started container is not in the snapshot yet",
+                  200);
+DEFINE_FLAG_INT32(container_event_retry_timeout,
+                  "seconds to wait for a started container to show up in the snapshot before falling back to polling",
+                  10);
+DEFINE_FLAG_INT32(container_event_reconnect_interval, "seconds to wait before subscribing container events again", 10);
+DEFINE_FLAG_INT32(container_discovery_latency_timeout,
+                  "seconds to wait for the first read of a started container when measuring discovery latency",
+                  600);
 
 namespace logtail {
 
@@ -29,7 +53,18 @@ namespace logtail {
 static Json::Value SerializeRawContainerInfo(const std::shared_ptr<RawContainerInfo>& info);
 static std::shared_ptr<RawContainerInfo> DeserializeRawContainerInfo(const Json::Value& v);
 
-ContainerManager::ContainerManager() = default;
+ContainerManager::ContainerManager() {
+    WriteMetrics::GetInstance()->CreateMetricsRecordRef(
+        mMetricsRecordRef,
+        MetricCategory::METRIC_CATEGORY_RUNNER,
+        {{METRIC_LABEL_KEY_RUNNER_NAME, METRIC_LABEL_VALUE_RUNNER_NAME_CONTAINER_MANAGER}});
+    mContainerEventsTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_CONTAINER_EVENTS_TOTAL);
+    mDiscoveredContainersTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_CONTAINER_DISCOVERED_CONTAINERS_TOTAL);
+    mContainerDiscoveryLatencyMs = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_CONTAINER_DISCOVERY_LATENCY_MS);
+    mLastContainerDiscoveryLatencyMs
+        = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_CONTAINER_LAST_DISCOVERY_LATENCY_MS);
+    WriteMetrics::GetInstance()->CommitMetricsRecordRef(mMetricsRecordRef);
+}
 
 ContainerManager::~ContainerManager() = default;
 
@@ -45,13 +80,44 @@ void ContainerManager::Init() {
     mIsRunning = true;
     LOG_INFO(sLogger, ("ContainerManager", "init"));
     mThreadRes = std::async(std::launch::async, &ContainerManager::pollingLoop, this);
+    if (!mEventSource) {
+        mEventSource = createDefaultEventSource();
+    }
+    if (mEventSource) {
+        mEventThreadRes = std::async(std::launch::async, &ContainerManager::eventLoop, this);
+    }
+}
+
+std::unique_ptr<ContainerEventSource> ContainerManager::createDefaultEventSource() {
+#if defined(__linux__)
+    if (!BOOL_FLAG(container_discovery_enable_event)) {
+        return nullptr;
+    }
+    const std::string& endpoint = STRING_FLAG(container_runtime_endpoint);
+    const std::string unixScheme = "unix://";
+    // no cri runtime on this host, e.g. docker only
+    if (StartWith(endpoint, unixScheme) && !CheckExistance(endpoint.substr(unixScheme.size()))) {
+        LOG_INFO(sLogger, ("cri runtime endpoint not found, container events disabled", endpoint));
+        return nullptr;
+    }
+    return std::make_unique<CriContainerEventSource>(endpoint);
+#else
+    return nullptr;
+#endif
 }
 
 void ContainerManager::Stop() {
     if (!mIsRunning) {
         return;
     }
-    mIsRunning = false;
+    {
+        std::lock_guard<std::mutex> lock(mEventMux);
+        mIsRunning = false;
+    }
+    mEventCV.notify_all();
+    if (mEventSource) {
+        mEventSource->Stop();
+    }
     if (mThreadRes.valid()) {
         try {
             auto status = mThreadRes.wait_for(std::chrono::seconds(5));
@@ -64,6 +130,20 @@ void ContainerManager::Stop() {
             LOG_ERROR(sLogger, ("stop polling thread failed", ""));
         }
     }
+    if (mEventThreadRes.valid()) {
+        try {
+            auto status = mEventThreadRes.wait_for(std::chrono::seconds(5));
+            if (status == std::future_status::ready) {
+                LOG_INFO(sLogger, ("ContainerManager", "event thread stopped successfully"));
+                // a new source is created on the next init
+                mEventSource.reset();
+            } else {
+                LOG_WARNING(sLogger, ("ContainerManager", "event thread forced to stopped"));
+            }
+        } catch (...) {
+            LOG_ERROR(sLogger, ("stop event thread failed", ""));
+        }
+    }
 }
 
 void ContainerManager::pollingLoop() {
@@ -71,20 +151,26 @@ void ContainerManager::pollingLoop() {
     time_t lastUpdateDiffTime = 0;
     time_t lastSendAllMatchedContainerInfoTime = 0;
     bool first = true;
+    bool eventTriggered = false;
 
     while (true) {
         if (!mIsRunning) {
             break;
         }
         time_t now = time(nullptr);
+        drainContainerEvents(now);
         // 每1小时更新一次所有容器信息
         if (now - lastUpdateAllTime >= 3600) {
             refreshAllContainersSnapshot();
             lastUpdateAllTime = now;
-        } else if (now - lastUpdateDiffTime >= 1) {
-            incrementallyUpdateContainersSnapshot();
+        } else if (eventTriggered || now - lastUpdateDiffTime >= 1) {
+            // 由容器事件触发时立即拉取变更
+            if (incrementallyUpdateContainersSnapshot() && eventTriggered) {
+                mEventDrivenChanges = true;
+            }
             lastUpdateDiffTime = now;
         }
+        updateAwaitedContainers(now);
         if (first) {
             lastSendAllMatchedContainerInfoTime = now;
         } else {
@@ -94,9 +180,119 @@ void ContainerManager::pollingLoop() {
                 lastSendAllMatchedContainerInfoTime = now;
             }
         }
-        std::this_thread::sleep_for(std::chrono::seconds(3));
         first = false;
+        eventTriggered = waitForNextPolling();
+    }
+}
+
+bool ContainerManager::waitForNextPolling() {
+    auto timeout = mAwaitedContainers.empty()
+        ? std::chrono::milliseconds(INT32_FLAG(container_discovery_polling_interval) * 1000)
+        : std::chrono::milliseconds(INT32_FLAG(container_event_retry_interval_ms));
+    std::unique_lock<std::mutex> lock(mEventMux);
+    bool woken = mEventCV.wait_for(lock, timeout, [this]() { return !mPendingEvents.empty() || !mIsRunning; });
+    return woken || !mAwaitedContainers.empty();
+}
+
+void ContainerManager::drainContainerEvents(time_t now) {
+    std::vector<ContainerEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(mEventMux);
+        events.swap(mPendingEvents);
+    }
+    if (events.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mContainerStartTimesMux);
+    for (const auto& event : events) {
+        switch (event.mType) {
+            case ContainerEventType::STARTED:
+                mAwaitedContainers[event.mContainerID] = now + INT32_FLAG(container_event_retry_timeout);
+                mContainerStartTimes[event.mContainerID] = event.mTimeMs;
+                break;
+            case ContainerEventType::DELETED:
+                mAwaitedContainers.erase(event.mContainerID);
+                mContainerStartTimes.erase(event.mContainerID);
+                break;
+            default:
+                break;
+        }
+    }
+    mHasContainerStartTimes = !mContainerStartTimes.empty();
+}
+
+void ContainerManager::updateAwaitedContainers(time_t now) {
+    if (!mAwaitedContainers.empty()) {
+        std::lock_guard<std::mutex> lock(mContainerMapMutex);
+        for (auto it = mAwaitedContainers.begin(); it != mAwaitedContainers.end();) {
+            if (mContainerMap.find(it->first) != mContainerMap.end()) {
+                it = mAwaitedContainers.erase(it);
+            } else if (now >= it->second) {
+                LOG_WARNING(sLogger, ("started container not found in container meta", it->first));
+                it = mAwaitedContainers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // containers not matched by any config are never read
+    uint64_t expireTimeMs = (now - INT32_FLAG(container_discovery_latency_timeout)) * 1000ULL;
+    std::lock_guard<std::mutex> lock(mContainerStartTimesMux);
+    for (auto it = mContainerStartTimes.begin(); it != mContainerStartTimes.end();) {
+        if (it->second < expireTimeMs) {
+            it = mContainerStartTimes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    mHasContainerStartTimes = !mContainerStartTimes.empty();
+}
+
+void ContainerManager::eventLoop() {
+    while (mIsRunning) {
+        mEventSource->Run([this](const ContainerEvent& event) { OnContainerEvent(event); });
+        if (!mEventSource->IsSupported()) {
+            break;
+        }
+        // polling covers the gap until the stream is set up again
+        std::unique_lock<std::mutex> lock(mEventMux);
+        mEventCV.wait_for(lock, std::chrono::seconds(INT32_FLAG(container_event_reconnect_interval)), [this]() {
+            return !mIsRunning;
+        });
+    }
+}
+
+void ContainerManager::OnContainerEvent(const ContainerEvent& event) {
+    LOG_DEBUG(sLogger, ("container event", event.mContainerID)("type", static_cast<int>(event.mType)));
+    ADD_COUNTER(mContainerEventsTotal, 1);
+    {
+        std::lock_guard<std::mutex> lock(mEventMux);
+        mPendingEvents.push_back(event);
+    }
+    mEventCV.notify_all();
+}
+
+void ContainerManager::OnContainerFirstRead(const std::string& containerID) {
+    if (!mHasContainerStartTimes) {
+        return;
     }
+    uint64_t startTimeMs = 0;
+    {
+        std::lock_guard<std::mutex> lock(mContainerStartTimesMux);
+        auto it = mContainerStartTimes.find(containerID);
+        if (it == mContainerStartTimes.end()) {
+            return;
+        }
+        startTimeMs = it->second;
+        mContainerStartTimes.erase(it);
+        mHasContainerStartTimes = !mContainerStartTimes.empty();
+    }
+    uint64_t now = GetCurrentTimeInMilliSeconds();
+    uint64_t latencyMs = now > startTimeMs ? now - startTimeMs : 0;
+    ADD_COUNTER(mDiscoveredContainersTotal, 1);
+    ADD_COUNTER(mContainerDiscoveryLatencyMs, latencyMs);
+    SET_GAUGE(mLastContainerDiscoveryLatencyMs, latencyMs);
+    LOG_INFO(sLogger, ("container discovered", containerID)("latency ms", latencyMs));
 }
 
 void ContainerManager::ApplyContainerDiffs() {
@@ -195,12 +391,28 @@ bool ContainerManager::CheckContainerDiffForAllConfig() {
     if (!mIsRunning) {
         return false;
     }
+    mEventDrivenChanges = false;
     bool isUpdate = false;
+    std::unordered_set<std::string> changedContainerIDs;
+    bool fullMatch = false;
+    uint32_t lastUpdateTime = 0;
+    {
+        // the update time is read together with the changes it covers
+        std::lock_guard<std::mutex> lock(mContainerMapMutex);
+        changedContainerIDs.swap(mChangedContainerIDs);
+        fullMatch = mNeedFullMatch;
+        mNeedFullMatch = false;
+        lastUpdateTime = mLastUpdateTime;
+    }
+    if (fullMatch) {
+        mMatcher.Clear();
+    }
     auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
     for (auto itr = nameConfigMap.begin(); itr != nameConfigMap.end(); ++itr) {
         FileDiscoveryOptions* options = itr->second.first;
         if (options->IsContainerDiscoveryEnabled()) {
-            bool isCurrentConfigUpdate = checkContainerDiffForOneConfig(options, itr->second.second);
+            bool isCurrentConfigUpdate = checkContainerDiffForOneConfig(
+                options, itr->second.second, lastUpdateTime, fullMatch ? nullptr : &changedContainerIDs);
             if (isCurrentConfigUpdate) {
                 isUpdate = true;
             }
@@ -272,10 +484,14 @@ void ContainerManager::sendMatchedContainerInfo(std::vector<std::shared_ptr<Matc
 
 
 bool ContainerManager::checkContainerDiffForOneConfig(FileDiscoveryOptions* options,
-                                                      const CollectionPipelineContext* ctx) {
-    // If this config's container update time is newer than or equal to global update time,
-    // return the cached result if it exists
-    if (options->GetLastContainerUpdateTime() > mLastUpdateTime) {
+                                                      const CollectionPipelineContext* ctx,
+                                                      uint32_t lastUpdateTime,
+                                                      const std::unordered_set<std::string>* changedContainerIDs) {
+    // If this config's container update time is newer than global update time and nothing changed since, return the
+    // cached result if it exists. Changed containers are consumed once, so they are never skipped, the config may
+    // have been matched while they were being updated.
+    if (changedContainerIDs != nullptr && changedContainerIDs->empty()
+        && options->GetLastContainerUpdateTime() > lastUpdateTime) {
         return false;
     }
 
@@ -289,19 +505,29 @@ bool ContainerManager::checkContainerDiffForOneConfig(FileDiscoveryOptions* opti
     std::vector<std::string> removedList;
     std::vector<std::string> matchAddedList;
     ContainerDiff diff;
-    computeMatchedContainersDiff(*(options->GetFullContainerList()),
-                                 containerInfoMap,
-                                 options->GetContainerDiscoveryOptions().mContainerFilters,
-                                 options->GetContainerDiscoveryOptions().mIsStdio,
-                                 diff);
+    // a config never matched before, e.g. a new one, is matched against all containers
+    if (changedContainerIDs != nullptr && options->GetLastContainerUpdateTime() != 0) {
+        computeMatchedContainersDiff(*(options->GetFullContainerList()),
+                                     containerInfoMap,
+                                     options->GetContainerDiscoveryOptions().mContainerFilters,
+                                     options->GetContainerDiscoveryOptions().mIsStdio,
+                                     *changedContainerIDs,
+                                     diff);
+    } else {
+        computeMatchedContainersDiff(*(options->GetFullContainerList()),
+                                     containerInfoMap,
+                                     options->GetContainerDiscoveryOptions().mContainerFilters,
+                                     options->GetContainerDiscoveryOptions().mIsStdio,
+                                     diff);
+    }
 
     LOG_DEBUG(
         sLogger,
         ("diff", diff.ToString())("configName", ctx->GetConfigName())(
             "containerFilters", options->GetContainerDiscoveryOptions().mContainerFilters.ToString())(
             "fullContainerList", options->GetFullContainerList()->size())("containerInfos", containerInfos->size())(
-            "lastConfigContainerUpdateTime", options->GetLastContainerUpdateTime())("mLastUpdateTime",
-                                                                                    mLastUpdateTime));
+            "lastConfigContainerUpdateTime", options->GetLastContainerUpdateTime())("lastUpdateTime",
+                                                                                    lastUpdateTime));
 
     // Update the config's container update time when there are changes
     options->SetLastContainerUpdateTime(time(nullptr));
@@ -314,10 +540,10 @@ bool ContainerManager::checkContainerDiffForOneConfig(FileDiscoveryOptions* opti
     return true;
 }
 
-void ContainerManager::incrementallyUpdateContainersSnapshot() {
+bool ContainerManager::incrementallyUpdateContainersSnapshot() {
     std::string diffContainersMeta = LogtailPlugin::GetInstance()->GetDiffContainersMeta();
     if (diffContainersMeta.empty()) {
-        return;
+        return false;
     }
     LOG_DEBUG(sLogger, ("diffContainersMeta", diffContainersMeta));
 
@@ -325,7 +551,7 @@ void ContainerManager::incrementallyUpdateContainersSnapshot() {
     std::string errorMsg;
     if (!ParseJsonTable(diffContainersMeta, jsonParams, errorMsg)) {
         LOG_WARNING(sLogger, ("invalid docker container params", diffContainersMeta)("errorMsg", errorMsg));
-        return;
+        return false;
     }
     Json::Value updateContainers = jsonParams["Update"];
     Json::Value deleteContainers = jsonParams["Delete"];
@@ -339,7 +565,9 @@ void ContainerManager::incrementallyUpdateContainersSnapshot() {
         if (containerInfo && !containerInfo->mID.empty()) {
             {
                 std::lock_guard<std::mutex> lock(mContainerMapMutex);
+                mLastUpdateTime = time(nullptr);
                 mContainerMap[containerInfo->mID] = containerInfo;
+                mChangedContainerIDs.insert(containerInfo->mID);
             }
             updatedContainerIDs.push_back(containerInfo->mID);
             hasChanges = true;
@@ -351,6 +579,8 @@ void ContainerManager::incrementallyUpdateContainersSnapshot() {
         {
             std::lock_guard<std::mutex> lock(mContainerMapMutex);
             if (mContainerMap.erase(containerId) > 0) {
+                mLastUpdateTime = time(nullptr);
+                mChangedContainerIDs.insert(containerId);
                 hasChanges = true;
             }
         }
@@ -365,8 +595,10 @@ void ContainerManager::incrementallyUpdateContainersSnapshot() {
     }
 
     if (hasChanges) {
+        std::lock_guard<std::mutex> lock(mContainerMapMutex);
         mLastUpdateTime = time(nullptr);
     }
+    return hasChanges;
 }
 
 void ContainerManager::refreshAllContainersSnapshot() {
@@ -398,8 +630,10 @@ void ContainerManager::refreshAllContainersSnapshot() {
     {
         std::lock_guard<std::mutex> lock(mContainerMapMutex);
         mContainerMap.swap(tmpContainerMap);
+        mChangedContainerIDs.clear();
+        mNeedFullMatch = true;
+        mLastUpdateTime = time(nullptr);
     }
-    mLastUpdateTime = time(nullptr);
 
     // Update container info pointers in all configs to point to the new RawContainerInfo objects
     updateContainerInfoPointersInAllConfigs();
@@ -513,73 +747,6 @@ void ContainerManager::GetContainerStoppedEvents(std::vector<Event*>& eventVec)
 }
 
 
-bool IsMapLabelsMatch(const MatchCriteriaFilter& filter, const std::unordered_map<std::string, std::string>& labels) {
-    if (!filter.mIncludeFields.mFieldsMap.empty() || !filter.mIncludeFields.mFieldsRegMap.empty()) {
-        bool matchedFlag = false;
-        // 检查静态 include 标签
-        for (const auto& pair : filter.mIncludeFields.mFieldsMap) {
-            auto it = labels.find(pair.first);
-            if (it != labels.end() && (pair.second.empty() || it->second == pair.second)) {
-                matchedFlag = true;
-                break;
-            }
-        }
-        // 如果匹配，则不需要检查正则表达式
-        if (!matchedFlag) {
-            for (const auto& pair : filter.mIncludeFields.mFieldsRegMap) {
-                auto it = labels.find(pair.first);
-                if (it != labels.end() && boost::regex_search(it->second, *pair.second)) {
-                    matchedFlag = true;
-                    break;
-                }
-            }
-        }
-        // 如果没有匹配，返回 false
-        if (!matchedFlag) {
-            return false;
-        }
-    }
-
-    // 检查 exclude 标签
-    for (const auto& pair : filter.mExcludeFields.mFieldsMap) {
-        auto it = labels.find(pair.first);
-        if (it != labels.end() && (pair.second.empty() || it->second == pair.second)) {
-            return false;
-        }
-    }
-
-    // 检查 exclude 正则
-    for (const auto& pair : filter.mExcludeFields.mFieldsRegMap) {
-        auto it = labels.find(pair.first);
-        if (it != labels.end() && boost::regex_search(it->second, *pair.second)) {
-            return false;
-        }
-    }
-    return true;
-}
-
-
-bool IsK8sFilterMatch(const K8sFilter& filter, const K8sInfo& k8sInfo) {
-    if (k8sInfo.mPausedContainer) {
-        return false;
-    }
-    // 匹配命名空间
-    if (filter.mNamespaceReg && !boost::regex_search(k8sInfo.mNamespace, *filter.mNamespaceReg)) {
-        return false;
-    }
-    // 匹配 Pod 名称
-    if (filter.mPodReg && !boost::regex_search(k8sInfo.mPod, *filter.mPodReg)) {
-        return false;
-    }
-    // 匹配容器名称
-    if (filter.mContainerReg && !boost::regex_search(k8sInfo.mContainerName, *filter.mContainerReg)) {
-        return false;
-    }
-    // 确保 Labels 不为 nullptr，使用默认的空映射初始化
-    return IsMapLabelsMatch(filter.mK8sLabelFilter, k8sInfo.mLabels);
-}
-
-
 void ContainerManager::computeMatchedContainersDiff(
     std::set<std::string>& fullContainerIDList,
     const std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>>& matchList,
@@ -603,7 +770,7 @@ void ContainerManager::computeMatchedContainersDiff(
     for (auto& pair : matchList) {
         if (auto it = mContainerMap.find(pair.first); it != mContainerMap.end()) {
             // 更新为最新的 info
-            if (*pair.second != *it->second) {
+            if (pair.second != it->second && *pair.second != *it->second) {
                 diff.mModified.push_back(it->second);
             }
         }
@@ -613,32 +780,54 @@ void ContainerManager::computeMatchedContainersDiff(
     for (const auto& pair : mContainerMap) {
         // 如果 fullContainerIDList 中不存在该 id
         if (fullContainerIDList.find(pair.first) == fullContainerIDList.end()) {
-            if (!isStdio && pair.second->mStatus != "running") {
-                continue;
-            }
-
-            fullContainerIDList.insert(pair.first); // 加入到 fullContainerIDList
+            matchNewContainer(fullContainerIDList, pair.second, filters, isStdio, diff);
+        }
+    }
+}
 
-            bool isContainerLabelMatch = IsMapLabelsMatch(filters.mContainerLabelFilter, pair.second->mContainerLabels);
-            if (!isContainerLabelMatch) {
-                continue;
-            }
-            bool isEnvMatch = IsMapLabelsMatch(filters.mEnvFilter, pair.second->mEnv);
-            if (!isEnvMatch) {
-                continue;
-            }
-            bool isK8sMatch = IsK8sFilterMatch(filters.mK8SFilter, pair.second->mK8sInfo);
-            if (!isK8sMatch) {
-                continue;
+// 仅计算变化容器的差异，结果与全量计算一致
+void ContainerManager::computeMatchedContainersDiff(
+    std::set<std::string>& fullContainerIDList,
+    const std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>>& matchList,
+    const ContainerFilters& filters,
+    bool isStdio,
+    const std::unordered_set<std::string>& changedContainerIDs,
+    ContainerDiff& diff) {
+    for (const auto& id : changedContainerIDs) {
+        auto it = mContainerMap.find(id);
+        auto matched = matchList.find(id);
+        if (it == mContainerMap.end()) {
+            // 移除已删除的容器
+            if (fullContainerIDList.erase(id) > 0 && matched != matchList.end()) {
+                diff.mRemoved.push_back(id);
             }
-            // 检查标签和环境匹配
-            if (isContainerLabelMatch && isEnvMatch && isK8sMatch) {
-                diff.mAdded.push_back(pair.second); // 添加到变换列表
+            continue;
+        }
+        if (matched != matchList.end()) {
+            if (matched->second != it->second && *matched->second != *it->second) {
+                diff.mModified.push_back(it->second);
             }
+        } else if (fullContainerIDList.find(id) == fullContainerIDList.end()) {
+            matchNewContainer(fullContainerIDList, it->second, filters, isStdio, diff);
         }
     }
 }
 
+void ContainerManager::matchNewContainer(std::set<std::string>& fullContainerIDList,
+                                         const std::shared_ptr<RawContainerInfo>& container,
+                                         const ContainerFilters& filters,
+                                         bool isStdio,
+                                         ContainerDiff& diff) {
+    if (!isStdio && container->mStatus != "running") {
+        return;
+    }
+    fullContainerIDList.insert(container->mID); // 加入到 fullContainerIDList
+    // 检查标签、环境变量和 K8s 信息匹配
+    if (mMatcher.IsMatch(filters, *container)) {
+        diff.mAdded.push_back(container); // 添加到变换列表
+    }
+}
+
 // Serialize RawContainerInfo (complete fields)
 static Json::Value SerializeRawContainerInfo(const std::shared_ptr<RawContainerInfo>& info) {
     Json::Value v(Json::objectValue);
@@ -1017,9 +1206,11 @@ void ContainerManager::loadContainerInfoFromContainersFormat(const Json::Value&
     LOG_DEBUG(sLogger, ("recover containers from docker_path_config.json (v1.0.0)", tmp.size()));
 
     if (!tmp.empty()) {
+        uint32_t lastUpdateTime = 0;
         {
             std::lock_guard<std::mutex> lock(mContainerMapMutex);
             mContainerMap.swap(tmp);
+            lastUpdateTime = mLastUpdateTime;
         }
         // Apply containers to all existing configs
         auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
@@ -1030,7 +1221,7 @@ void ContainerManager::loadContainerInfoFromContainersFormat(const Json::Value&
         for (auto itr = nameConfigMap.begin(); itr != nameConfigMap.end(); ++itr) {
             FileDiscoveryOptions* options = itr->second.first;
             if (options->IsContainerDiscoveryEnabled()) {
-                checkContainerDiffForOneConfig(options, itr->second.second);
+                checkContainerDiffForOneConfig(options, itr->second.second, lastUpdateTime);
             }
         }
         LOG_INFO(sLogger, ("load container state from docker_path_config.json (v1.0.0)", configPath));
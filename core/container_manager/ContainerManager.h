@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <future>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -26,11 +28,14 @@
 #include "constants/TagConstants.h"
 #include "container_manager/ContainerDiff.h"
 #include "container_manager/ContainerDiscoveryOptions.h"
+#include "container_manager/ContainerEventSource.h"
+#include "container_manager/ContainerMatcher.h"
 #include "file_server/ContainerInfo.h"
 #include "file_server/FileDiscoveryOptions.h"
 #include "file_server/event/Event.h"
 #include "models/LogEvent.h"
 #include "models/PipelineEventGroup.h"
+#include "monitor/MetricManager.h"
 #include "monitor/Monitor.h"
 #include "monitor/SelfMonitorServer.h"
 #include "runner/ProcessorRunner.h"
@@ -47,6 +52,14 @@ public:
 
     void ApplyContainerDiffs();
     bool CheckContainerDiffForAllConfig();
+    // true if containers changed by runtime events are waiting to be matched, the caller should check them now
+    // instead of waiting for the next check interval
+    bool HasEventDrivenChanges() const { return mEventDrivenChanges; }
+
+    // called by the event thread, wakes the polling thread to fetch the changed containers at once
+    void OnContainerEvent(const ContainerEvent& event);
+    // called by a reader on its first read of a container file, records the discovery latency of the container
+    void OnContainerFirstRead(const std::string& containerID);
 
     void GetContainerStoppedEvents(std::vector<Event*>& eventVec);
     // Persist/restore container runtime state
@@ -63,10 +76,21 @@ public:
 
 private:
     void pollingLoop();
+    void eventLoop();
+    // returns true if woken by container events, or if started containers are still missing from the snapshot
+    bool waitForNextPolling();
+    void drainContainerEvents(time_t now);
+    void updateAwaitedContainers(time_t now);
     void refreshAllContainersSnapshot();
-    void incrementallyUpdateContainersSnapshot();
-
-    bool checkContainerDiffForOneConfig(FileDiscoveryOptions* options, const CollectionPipelineContext* ctx);
+    bool incrementallyUpdateContainersSnapshot();
+    static std::unique_ptr<ContainerEventSource> createDefaultEventSource();
+
+    // lastUpdateTime: update time of the snapshot, read together with changedContainerIDs
+    // changedContainerIDs: only these containers are matched if not null and the config has been matched before
+    bool checkContainerDiffForOneConfig(FileDiscoveryOptions* options,
+                                        const CollectionPipelineContext* ctx,
+                                        uint32_t lastUpdateTime,
+                                        const std::unordered_set<std::string>* changedContainerIDs = nullptr);
     void updateContainerInfoPointersInAllConfigs();
     void updateContainerInfoPointersForContainers(const std::vector<std::string>& containerIDs);
     void
@@ -75,6 +99,18 @@ private:
                                  const ContainerFilters& filters,
                                  bool isStdio,
                                  ContainerDiff& diff);
+    void
+    computeMatchedContainersDiff(std::set<std::string>& fullContainerIDList,
+                                 const std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>>& matchList,
+                                 const ContainerFilters& filters,
+                                 bool isStdio,
+                                 const std::unordered_set<std::string>& changedContainerIDs,
+                                 ContainerDiff& diff);
+    void matchNewContainer(std::set<std::string>& fullContainerIDList,
+                           const std::shared_ptr<RawContainerInfo>& container,
+                           const ContainerFilters& filters,
+                           bool isStdio,
+                           ContainerDiff& diff);
 
     void loadContainerInfoFromDetailFormat(const Json::Value& root, const std::string& configPath);
     void loadContainerInfoFromContainersFormat(const Json::Value& root, const std::string& configPath);
@@ -89,12 +125,40 @@ private:
     std::unordered_map<std::string, std::shared_ptr<ContainerDiff>> mConfigContainerDiffMap;
     std::unordered_map<std::string, std::shared_ptr<MatchedContainerInfo>> mConfigContainerResultMap;
     std::mutex mContainerMapMutex;
+    // containers updated or deleted since the last CheckContainerDiffForAllConfig, protected by mContainerMapMutex
+    std::unordered_set<std::string> mChangedContainerIDs;
+    // set when the snapshot is replaced as a whole, all containers are matched again
+    bool mNeedFullMatch = true;
+    ContainerMatcher mMatcher;
     std::vector<std::string> mStoppedContainerIDs;
     std::mutex mStoppedContainerIDsMutex;
 
+    // protected by mContainerMapMutex
     uint32_t mLastUpdateTime = 0;
     std::future<void> mThreadRes;
 
+    // null if container events are disabled or not available on this platform, polling only
+    std::unique_ptr<ContainerEventSource> mEventSource;
+    std::future<void> mEventThreadRes;
+    mutable std::mutex mEventMux;
+    std::condition_variable mEventCV;
+    // events not yet handled by the polling thread, protected by mEventMux
+    std::vector<ContainerEvent> mPendingEvents;
+    // started containers not yet in the snapshot -> deadline of fast retry, owned by the polling thread
+    std::unordered_map<std::string, time_t> mAwaitedContainers;
+    std::atomic_bool mEventDrivenChanges{false};
+    // started containers not yet read -> start time in ms
+    std::unordered_map<std::string, uint64_t> mContainerStartTimes;
+    std::mutex mContainerStartTimesMux;
+    // checked by readers before taking mContainerStartTimesMux
+    std::atomic_bool mHasContainerStartTimes{false};
+
+    MetricsRecordRef mMetricsRecordRef;
+    CounterPtr mContainerEventsTotal;
+    CounterPtr mDiscoveredContainersTotal;
+    CounterPtr mContainerDiscoveryLatencyMs;
+    IntGaugePtr mLastContainerDiscoveryLatencyMs;
+
     std::atomic<bool> mIsRunning{false};
     friend class ContainerManagerUnittest;
 
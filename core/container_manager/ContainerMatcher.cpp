@@ -0,0 +1,133 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "container_manager/ContainerMatcher.h"
+
+#include <algorithm>
+
+#include "common/Flags.h"
+
+DEFINE_FLAG_INT32(container_match_regex_cache_size,
+                  "max number of cached (regex, value) results of container filters, the cache is reset when full",
+                  100000);
+
+namespace logtail {
+
+bool ContainerMatcher::IsMatch(const ContainerFilters& filters, const RawContainerInfo& info) {
+    return IsMapLabelsMatch(filters.mContainerLabelFilter, info.mContainerLabels)
+        && IsMapLabelsMatch(filters.mEnvFilter, info.mEnv) && IsK8sFilterMatch(filters.mK8SFilter, info.mK8sInfo);
+}
+
+bool ContainerMatcher::IsMapLabelsMatch(const MatchCriteriaFilter& filter,
+                                        const std::unordered_map<std::string, std::string>& labels) {
+    if (!filter.mIncludeFields.mFieldsMap.empty() || !filter.mIncludeFields.mFieldsRegMap.empty()) {
+        bool matchedFlag = false;
+        // 检查静态 include 标签
+        for (const auto& pair : filter.mIncludeFields.mFieldsMap) {
+            auto it = labels.find(pair.first);
+            if (it != labels.end() && (pair.second.empty() || it->second == pair.second)) {
+                matchedFlag = true;
+                break;
+            }
+        }
+        // 如果匹配，则不需要检查正则表达式
+        if (!matchedFlag) {
+            for (const auto& pair : filter.mIncludeFields.mFieldsRegMap) {
+                auto it = labels.find(pair.first);
+                if (it != labels.end() && RegexSearch(*pair.second, it->second)) {
+                    matchedFlag = true;
+                    break;
+                }
+            }
+        }
+        // 如果没有匹配，返回 false
+        if (!matchedFlag) {
+            return false;
+        }
+    }
+
+    // 检查 exclude 标签
+    for (const auto& pair : filter.mExcludeFields.mFieldsMap) {
+        auto it = labels.find(pair.first);
+        if (it != labels.end() && (pair.second.empty() || it->second == pair.second)) {
+            return false;
+        }
+    }
+
+    // 检查 exclude 正则
+    for (const auto& pair : filter.mExcludeFields.mFieldsRegMap) {
+        auto it = labels.find(pair.first);
+        if (it != labels.end() && RegexSearch(*pair.second, it->second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ContainerMatcher::IsK8sFilterMatch(const K8sFilter& filter, const K8sInfo& k8sInfo) {
+    if (k8sInfo.mPausedContainer) {
+        return false;
+    }
+    // 匹配命名空间
+    if (filter.mNamespaceReg && !RegexSearch(*filter.mNamespaceReg, k8sInfo.mNamespace)) {
+        return false;
+    }
+    // 匹配 Pod 名称
+    if (filter.mPodReg && !RegexSearch(*filter.mPodReg, k8sInfo.mPod)) {
+        return false;
+    }
+    // 匹配容器名称
+    if (filter.mContainerReg && !RegexSearch(*filter.mContainerReg, k8sInfo.mContainerName)) {
+        return false;
+    }
+    return IsMapLabelsMatch(filter.mK8sLabelFilter, k8sInfo.mLabels);
+}
+
+bool ContainerMatcher::RegexSearch(const boost::regex& reg, const std::string& value) {
+    auto* results = &getResults(reg);
+    auto it = results->find(value);
+    if (it != results->end()) {
+        ++mHitCount;
+        return it->second;
+    }
+    ++mMissCount;
+    bool matched = boost::regex_search(value, reg);
+    if (mCachedCount >= static_cast<size_t>(INT32_FLAG(container_match_regex_cache_size))) {
+        Clear();
+        results = &getResults(reg);
+    }
+    results->emplace(value, matched);
+    ++mCachedCount;
+    return matched;
+}
+
+ContainerMatcher::ValueResults& ContainerMatcher::getResults(const boost::regex& reg) {
+    auto res = mRegexEntries.try_emplace(&reg, nullptr);
+    if (!res.second) {
+        const std::string& pattern = res.first->second->first;
+        if (std::equal(reg.begin(), reg.end(), pattern.begin(), pattern.end())) {
+            return res.first->second->second;
+        }
+    }
+    res.first->second = &*mRegexResults.try_emplace(reg.str()).first;
+    return res.first->second->second;
+}
+
+void ContainerMatcher::Clear() {
+    mRegexResults.clear();
+    mRegexEntries.clear();
+    mCachedCount = 0;
+}
+
+} // namespace logtail
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/regex.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "container_manager/ContainerDiscoveryOptions.h"
+#include "file_server/ContainerInfo.h"
+
+namespace logtail {
+
+// Evaluates ContainerFilters against containers. Results of regex filters are cached per (pattern, value), so that
+// configs sharing a pattern, and containers sharing a namespace, pod, container name or label value, run each regex
+// only once. Exact criteria are plain lookups in the container's maps and are not cached.
+// NOT thread-safe.
+class ContainerMatcher {
+public:
+    bool IsMatch(const ContainerFilters& filters, const RawContainerInfo& info);
+    bool IsMapLabelsMatch(const MatchCriteriaFilter& filter,
+                          const std::unordered_map<std::string, std::string>& labels);
+    bool IsK8sFilterMatch(const K8sFilter& filter, const K8sInfo& k8sInfo);
+    bool RegexSearch(const boost::regex& reg, const std::string& value);
+
+    // drops all cached results, e.g. when the container snapshot is fully refreshed
+    void Clear();
+
+    size_t GetCachedCount() const { return mCachedCount; }
+    size_t GetHitCount() const { return mHitCount; }
+    size_t GetMissCount() const { return mMissCount; }
+
+private:
+    using ValueResults = std::unordered_map<std::string, bool>;
+    using PatternEntry = std::pair<const std::string, ValueResults>;
+
+    ValueResults& getResults(const boost::regex& reg);
+
+    // pattern -> value -> result
+    std::unordered_map<std::string, ValueResults> mRegexResults;
+    // address of a regex -> its entry in mRegexResults, so that the pattern is neither copied nor hashed on each
+    // search. The pattern is compared in place on use, as the address may be reused once the regex is destroyed.
+    std::unordered_map<const boost::regex*, PatternEntry*> mRegexEntries;
+    size_t mCachedCount = 0;
+    size_t mHitCount = 0;
+    size_t mMissCount = 0;
+};
+
+} // namespace logtail
@@ -0,0 +1,112 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "container_manager/cri/CriContainerEventSource.h"
+
+#include "grpcpp/create_channel.h"
+#include "grpcpp/security/credentials.h"
+
+#include "common/TimeUtil.h"
+#include "logger/Logger.h"
+#include "protobuf/cri/api.grpc.pb.h"
+
+namespace logtail {
+
+bool CriContainerEventSource::Run(const std::function<void(const ContainerEvent&)>& handler) {
+    auto stub = runtime::v1::RuntimeService::NewStub(
+        grpc::CreateChannel(mEndpoint, grpc::InsecureChannelCredentials()));
+    grpc::ClientContext context;
+    {
+        std::lock_guard<std::mutex> lock(mMux);
+        if (mStopped) {
+            return false;
+        }
+        mContext = &context;
+    }
+
+    LOG_INFO(sLogger, ("subscribe container events", "start")("endpoint", mEndpoint));
+    runtime::v1::GetEventsRequest request;
+    runtime::v1::ContainerEventResponse response;
+    ContainerEvent event;
+    auto reader = stub->GetContainerEvents(&context, request);
+    while (reader->Read(&response)) {
+        if (ConvertEvent(response, event)) {
+            handler(event);
+        }
+    }
+    grpc::Status status = reader->Finish();
+
+    bool stopped = false;
+    {
+        std::lock_guard<std::mutex> lock(mMux);
+        mContext = nullptr;
+        stopped = mStopped;
+    }
+    if (stopped) {
+        LOG_INFO(sLogger, ("subscribe container events", "stopped")("endpoint", mEndpoint));
+        return false;
+    }
+    if (status.error_code() == grpc::StatusCode::UNIMPLEMENTED) {
+        mSupported = false;
+        LOG_INFO(sLogger,
+                 ("container events are not supported by the runtime", "fall back to polling")("endpoint", mEndpoint)(
+                     "message", status.error_message()));
+        return false;
+    }
+    if (!status.ok()) {
+        LOG_WARNING(sLogger,
+                    ("failed to subscribe container events", status.error_message())("code", status.error_code())(
+                        "endpoint", mEndpoint));
+        return false;
+    }
+    return true;
+}
+
+void CriContainerEventSource::Stop() {
+    std::lock_guard<std::mutex> lock(mMux);
+    mStopped = true;
+    if (mContext != nullptr) {
+        mContext->TryCancel();
+    }
+}
+
+bool CriContainerEventSource::ConvertEvent(const runtime::v1::ContainerEventResponse& response,
+                                           ContainerEvent& event) {
+    if (response.container_id().empty()) {
+        return false;
+    }
+    switch (response.container_event_type()) {
+        case runtime::v1::CONTAINER_CREATED_EVENT:
+            event.mType = ContainerEventType::CREATED;
+            break;
+        case runtime::v1::CONTAINER_STARTED_EVENT:
+            event.mType = ContainerEventType::STARTED;
+            break;
+        case runtime::v1::CONTAINER_STOPPED_EVENT:
+            event.mType = ContainerEventType::STOPPED;
+            break;
+        case runtime::v1::CONTAINER_DELETED_EVENT:
+            event.mType = ContainerEventType::DELETED;
+            break;
+        default:
+            return false;
+    }
+    event.mContainerID = response.container_id();
+    // created_at is in nanoseconds
+    event.mTimeMs = response.created_at() > 0 ? static_cast<uint64_t>(response.created_at()) / 1000000
+                                              : GetCurrentTimeInMilliSeconds();
+    return true;
+}
+
+} // namespace logtail
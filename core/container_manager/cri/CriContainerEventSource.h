@@ -0,0 +1,53 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "grpcpp/client_context.h"
+
+#include "container_manager/ContainerEventSource.h"
+#include "protobuf/cri/api.pb.h"
+
+namespace logtail {
+
+// Container events from RuntimeService.GetContainerEvents of a CRI runtime (containerd >= 1.7, cri-o >= 1.26).
+// Runtimes without the rpc reply UNIMPLEMENTED, after which the source reports itself as not supported.
+class CriContainerEventSource : public ContainerEventSource {
+public:
+    // endpoint: grpc target of the runtime, e.g. unix:///run/containerd/containerd.sock
+    explicit CriContainerEventSource(const std::string& endpoint) : mEndpoint(endpoint) {}
+
+    bool Run(const std::function<void(const ContainerEvent&)>& handler) override;
+    void Stop() override;
+    bool IsSupported() const override { return mSupported; }
+
+    static bool ConvertEvent(const runtime::v1::ContainerEventResponse& response, ContainerEvent& event);
+
+private:
+    std::string mEndpoint;
+    std::atomic_bool mSupported{true};
+
+    std::mutex mMux;
+    bool mStopped = false;
+    // context of the ongoing stream, protected by mMux
+    grpc::ClientContext* mContext = nullptr;
+};
+
+} // namespace logtail
@@ -169,6 +169,11 @@ compile_proto_grpc(
     "${CMAKE_CURRENT_SOURCE_DIR}/protobuf/forward"
     "loongsuite.proto"
 )
+compile_proto_grpc(
+    "${CMAKE_CURRENT_SOURCE_DIR}/protobuf/cri"
+    "${CMAKE_CURRENT_SOURCE_DIR}/protobuf/cri"
+    "api.proto"
+)
 endif()
 
 compile_proto(
@@ -181,6 +181,11 @@ EBPFServer::EBPFServer()
     mLossKernelEventsTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_EBPF_LOST_KERNEL_EVENTS_TOTAL);
     mConnectionCacheSize = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_EBPF_CONNECTION_CACHE_SIZE);
     mPushLogFailedTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_EBPF_LOST_LOG_EVENTS_TOTAL);
+    mTailSamplerBufferedSpans = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_EBPF_TAIL_SAMPLER_BUFFERED_SPANS);
+    mTailSamplerKeptSpansTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_EBPF_TAIL_SAMPLER_KEPT_SPANS_TOTAL);
+    mTailSamplerDroppedSpansTotal
+        = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_EBPF_TAIL_SAMPLER_DROPPED_SPANS_TOTAL);
+    mTailSamplerDecisionMs = mMetricsRecordRef.CreateTimeCounter(METRIC_RUNNER_EBPF_TAIL_SAMPLER_DECISION_TIME_MS);
 
     mProcessCacheManager = std::make_shared<ProcessCacheManager>(mEBPFAdapter,
                                                                  mHostName,
@@ -322,6 +327,10 @@ bool EBPFServer::startPluginInternal(const std::string& pipelineName,
                         mProcessCacheManager, mEBPFAdapter, mCommonEventQueue, &mEventPool);
                     mgr->SetMetrics(
                         mRecvKernelEventsTotal, mLossKernelEventsTotal, mConnectionCacheSize, mPushLogFailedTotal);
+                    mgr->SetTailSamplerMetrics(mTailSamplerBufferedSpans,
+                                               mTailSamplerKeptSpansTotal,
+                                               mTailSamplerDroppedSpansTotal,
+                                               mTailSamplerDecisionMs);
                     pluginMgr = mgr;
                 }
                 break;
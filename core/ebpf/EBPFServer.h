@@ -175,6 +175,10 @@ private:
     CounterPtr mLossKernelEventsTotal;
     IntGaugePtr mConnectionCacheSize;
     CounterPtr mPushLogFailedTotal;
+    IntGaugePtr mTailSamplerBufferedSpans;
+    CounterPtr mTailSamplerKeptSpansTotal;
+    CounterPtr mTailSamplerDroppedSpansTotal;
+    TimeCounterPtr mTailSamplerDecisionMs;
 
     int mUnifiedEpollFd = -1;
     std::vector<struct epoll_event> mEpollEvents;
@@ -17,7 +17,6 @@
 #include <boost/unordered/concurrent_flat_map.hpp>
 #include <chrono>
 #include <iterator>
-#include <mutex>
 
 #include "ProcessCacheValue.h"
 #include "common/TimeKeeper.h"
@@ -88,8 +87,7 @@ void ProcessCache::DecRef(const data_event_id& key, std::shared_ptr<ProcessCache
 }
 
 void ProcessCache::enqueueExpiredEntry(const data_event_id& key, std::shared_ptr<ProcessCacheValue>& value) {
-    std::lock_guard<std::mutex> lock(mCacheExpireQueueMutex);
-    mCacheExpireQueue.push_back({key, value});
+    mCacheExpireQueue.enqueue({key, value});
 }
 
 void ProcessCache::Clear() {
@@ -100,9 +98,14 @@ void ProcessCache::Clear() {
 }
 
 void ProcessCache::ClearExpiredCache() {
-    {
-        std::lock_guard<std::mutex> lock(mCacheExpireQueueMutex);
-        mCacheExpireQueueProcessing.swap(mCacheExpireQueue);
+    // drain everything enqueued so far before processing, so that entries re-enqueued below are only examined in the
+    // next round, which keeps the two-phase kDeletePending -> kDeleteReady -> kDeleted transition
+    ExitedEntry batch[kExpireDequeueBatchSize];
+    size_t count = 0;
+    while ((count = mCacheExpireQueue.try_dequeue_bulk(batch, kExpireDequeueBatchSize)) > 0) {
+        mCacheExpireQueueProcessing.insert(mCacheExpireQueueProcessing.end(),
+                                           std::make_move_iterator(batch),
+                                           std::make_move_iterator(batch + count));
     }
     if (mCacheExpireQueueProcessing.empty()) {
         return;
@@ -125,14 +128,15 @@ void ProcessCache::ClearExpiredCache() {
         if (entry.value->LifeStage() == ProcessCacheValue::LifeStage::kDeleteReady) {
             entry.value->SetLifeStage(ProcessCacheValue::LifeStage::kDeleted);
             LOG_DEBUG(sLogger, ("clear expired cache pid", entry.key.pid)("ktime", entry.key.time));
-            removeCache(entry.key);
+            mCacheKeysToRemove.emplace_back(entry.key);
         }
     }
+    for (const auto& key : mCacheKeysToRemove) {
+        removeCache(key);
+    }
+    mCacheKeysToRemove.clear();
     if (nextQueueSize > 0) {
-        mCacheExpireQueueProcessing.resize(nextQueueSize);
-        mCacheExpireQueue.insert(mCacheExpireQueue.end(),
-                                 std::make_move_iterator(mCacheExpireQueueProcessing.begin()),
-                                 std::make_move_iterator(mCacheExpireQueueProcessing.end()));
+        mCacheExpireQueue.enqueue_bulk(std::make_move_iterator(mCacheExpireQueueProcessing.begin()), nextQueueSize);
     }
     mCacheExpireQueueProcessing.clear();
 }
@@ -172,9 +176,7 @@ void ProcessCache::PrintDebugInfo() {
             LOG_ERROR(sLogger, ("[DUMP CACHE] pid", key.pid)("ktime", key.time));
         });
     }
-    for (const auto& entry : mCacheExpireQueue) {
-        LOG_ERROR(sLogger, ("[DUMP EXPIRE Q] pid", entry.key.pid)("ktime", entry.key.time));
-    }
+    LOG_ERROR(sLogger, ("[DUMP EXPIRE Q] size", mCacheExpireQueue.size_approx()));
 }
 
 } // namespace logtail
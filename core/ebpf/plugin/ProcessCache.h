@@ -19,10 +19,11 @@
 
 #include <boost/unordered/concurrent_flat_map_fwd.hpp>
 #include <memory>
-#include <mutex>
+#include <vector>
 
 #include "common/LogtailCommonFlags.h"
 #include "common/ProcParser.h"
+#include "common/queue/concurrentqueue.h"
 #include "ebpf/plugin/ProcessCacheValue.h"
 #include "ebpf/plugin/ProcessDataMap.h"
 
@@ -60,7 +61,7 @@ public:
 private:
     // thread-safe concurrent access
     void removeCache(const data_event_id& key);
-    // NOT thread-safe, only single write call, no contention with read
+    // thread-safe, lock-free multi-producer enqueue
     void enqueueExpiredEntry(const data_event_id& key, std::shared_ptr<ProcessCacheValue>& value);
 
     ProcParser mProcParser;
@@ -75,9 +76,12 @@ private:
         std::shared_ptr<ProcessCacheValue> value;
     };
 
-    std::mutex mCacheExpireQueueMutex;
-    std::vector<ExitedEntry> mCacheExpireQueue;
+    // DecRef may be called from any handler thread, so entries are pushed into a lock-free queue and drained in
+    // batches by the single gc caller. Lookups never touch this queue.
+    static constexpr size_t kExpireDequeueBatchSize = 256;
+    moodycamel::ConcurrentQueue<ExitedEntry> mCacheExpireQueue;
     std::vector<ExitedEntry> mCacheExpireQueueProcessing;
+    std::vector<data_event_id> mCacheKeysToRemove;
 
     int64_t mLastForceShrinkTimeSec = 0;
 };
@@ -53,6 +53,19 @@ DEFINE_FLAG_INT32(ebpf_networkobserver_max_connections, "maximum connections", 5
 DEFINE_FLAG_STRING(ebpf_networkobserver_enable_protocols, "enable application protocols, split by comma", "HTTP");
 DEFINE_FLAG_DOUBLE(ebpf_networkobserver_default_sample_rate, "ebpf network observer default sample rate", 1.0);
 DEFINE_FLAG_STRING(ebpf_networkobserver_agent_env, "deploy env: ACSK8S,Serverless,ECS_AUTO", "ACSK8S");
+DEFINE_FLAG_BOOL(ebpf_networkobserver_enable_tail_sampling,
+                 "decide sampling of records carrying w3c trace context per trace after they are complete",
+                 false);
+DEFINE_FLAG_INT32(ebpf_networkobserver_tail_sampling_wait_ms, "tail sampling decision window in ms", 1000);
+DEFINE_FLAG_DOUBLE(ebpf_networkobserver_tail_sampling_spans_per_sec,
+                   "tail sampling target output spans per second of all apps",
+                   1000.0);
+DEFINE_FLAG_INT32(ebpf_networkobserver_tail_sampling_slow_threshold_ms,
+                  "records slower than this are always kept by tail sampling",
+                  500);
+DEFINE_FLAG_INT32(ebpf_networkobserver_tail_sampling_max_buffered_spans,
+                  "max records buffered by tail sampling",
+                  100000);
 
 namespace logtail::ebpf {
 
@@ -207,20 +220,13 @@ NetworkObserverManager::NetworkObserverManager(const std::shared_ptr<ProcessCach
                   auto ip = sourceBuffer->CopyString(ctAttrs.Get<kIp>());
                   data->mTags.SetNoCopy<kIp>(StringView(ip.data, ip.size));
 
-                  auto appId = sourceBuffer->CopyString(appConfig->mAppId);
-                  data->mTags.SetNoCopy<kAppId>(StringView(appId.data, appId.size));
-
-                  auto appName = sourceBuffer->CopyString(appConfig->mAppName);
-                  data->mTags.SetNoCopy<kAppName>(StringView(appName.data, appName.size));
-
-                  auto workspace = sourceBuffer->CopyString(appConfig->mWorkspace);
-                  data->mTags.SetNoCopy<kAppName>(StringView(workspace.data, workspace.size));
-
-                  auto serviceId = sourceBuffer->CopyString(appConfig->mServiceId);
-                  data->mTags.SetNoCopy<kArmsServiceId>(StringView(serviceId.data, serviceId.size));
-
-                  auto language = sourceBuffer->CopyString(appConfig->mLanguage);
-                  data->mTags.SetNoCopy<kLanguage>(StringView(language.data, language.size));
+                  const auto& appAttrs = appConfig->mStaticAttrs;
+                  data->mAppAttrsBuffer = appAttrs.GetSourceBuffer();
+                  data->mTags.SetNoCopy<kAppId>(appAttrs.Get<kAppId>());
+                  data->mTags.SetNoCopy<kAppName>(appAttrs.Get<kAppName>());
+                  data->mTags.SetNoCopy<kWorkspace>(appAttrs.Get<kWorkspace>());
+                  data->mTags.SetNoCopy<kArmsServiceId>(appAttrs.Get<kArmsServiceId>());
+                  data->mTags.SetNoCopy<kLanguage>(appAttrs.Get<kLanguage>());
               }
 
               auto workloadKind = sourceBuffer->CopyString(ctAttrs.Get<kWorkloadKind>());
@@ -280,17 +286,12 @@ NetworkObserverManager::NetworkObserverManager(const std::shared_ptr<ProcessCach
               const auto& ctAttrs = connection->GetConnTrackerAttrs();
 
               {
-                  auto appId = sourceBuffer->CopyString(appConfig->mAppId);
-                  data->mTags.SetNoCopy<kAppId>(StringView(appId.data, appId.size));
-
-                  auto appName = sourceBuffer->CopyString(appConfig->mAppName);
-                  data->mTags.SetNoCopy<kAppName>(StringView(appName.data, appName.size));
-
-                  auto serviceId = sourceBuffer->CopyString(appConfig->mServiceId);
-                  data->mTags.SetNoCopy<kArmsServiceId>(StringView(serviceId.data, serviceId.size));
-
-                  auto workspace = sourceBuffer->CopyString(appConfig->mWorkspace);
-                  data->mTags.SetNoCopy<kWorkspace>(StringView(workspace.data, workspace.size));
+                  const auto& appAttrs = appConfig->mStaticAttrs;
+                  data->mAppAttrsBuffer = appAttrs.GetSourceBuffer();
+                  data->mTags.SetNoCopy<kAppId>(appAttrs.Get<kAppId>());
+                  data->mTags.SetNoCopy<kAppName>(appAttrs.Get<kAppName>());
+                  data->mTags.SetNoCopy<kArmsServiceId>(appAttrs.Get<kArmsServiceId>());
+                  data->mTags.SetNoCopy<kWorkspace>(appAttrs.Get<kWorkspace>());
 
                   auto host = sourceBuffer->CopyString(ctAttrs.Get<kHostNameIndex>());
                   data->mTags.SetNoCopy<kHostName>(StringView(host.data, host.size));
@@ -692,11 +693,7 @@ bool NetworkObserverManager::ConsumeNetMetricAggregateTree() { // handler
                 configName = appInfo->mConfigName;
                 pushMetricsTotal = appInfo->mPushMetricsTotal;
                 pushMetricGroupTotal = appInfo->mPushMetricGroupTotal;
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kAppId.MetricKey(), appInfo->mAppId);
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kAppName.MetricKey(), appInfo->mAppName);
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kWorkspace.MetricKey(), appInfo->mWorkspace);
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kArmsServiceId.MetricKey(), appInfo->mServiceId);
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kLanguage.MetricKey(), appInfo->mLanguage);
+                appInfo->mStaticAttrs.SetGroupTagsNoCopy(eventGroup, &DataTableSchema::ColMetricKey);
                 eventGroup.SetTagNoCopy(kIp.MetricKey(), group->mTags.Get<kIp>()); // pod ip
                 eventGroup.SetTagNoCopy(kHostName.MetricKey(), group->mTags.Get<kHostName>()); // pod name
                 init = true;
@@ -853,11 +850,7 @@ bool NetworkObserverManager::ConsumeMetricAggregateTree() { // handler
                 pushMetricGroupTotal = appInfo->mPushMetricGroupTotal;
 
                 // set common attrs ...
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kAppId.MetricKey(), appInfo->mAppId);
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kAppName.MetricKey(), appInfo->mAppName);
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kWorkspace.MetricKey(), appInfo->mWorkspace);
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kArmsServiceId.MetricKey(), appInfo->mServiceId);
-                COPY_AND_SET_TAG(eventGroup, sourceBuffer, kLanguage.MetricKey(), appInfo->mLanguage);
+                appInfo->mStaticAttrs.SetGroupTagsNoCopy(eventGroup, &DataTableSchema::ColMetricKey);
                 eventGroup.SetTagNoCopy(kIp.MetricKey(), group->mTags.Get<kIp>()); // pod ip
                 eventGroup.SetTagNoCopy(kHostName.MetricKey(), group->mTags.Get<kHostName>()); // pod ip
 
@@ -1038,11 +1031,7 @@ bool NetworkObserverManager::ConsumeSpanAggregateTree() { // handler
                     configName = appInfo->mConfigName;
                     pushSpansTotal = appInfo->mPushSpansTotal;
                     pushSpanGroupTotal = appInfo->mPushSpanGroupTotal;
-                    COPY_AND_SET_TAG(eventGroup, sourceBuffer, kAppId.SpanKey(), appInfo->mAppId);
-                    COPY_AND_SET_TAG(eventGroup, sourceBuffer, kAppName.SpanKey(), appInfo->mAppName);
-                    COPY_AND_SET_TAG(eventGroup, sourceBuffer, kWorkspace.SpanKey(), appInfo->mWorkspace);
-                    COPY_AND_SET_TAG(eventGroup, sourceBuffer, kArmsServiceId.SpanKey(), appInfo->mServiceId);
-                    COPY_AND_SET_TAG(eventGroup, sourceBuffer, kLanguage.MetricKey(), appInfo->mLanguage);
+                    appInfo->mStaticAttrs.SetGroupTagsNoCopy(eventGroup, &DataTableSchema::ColSpanKey);
                     COPY_AND_SET_TAG(eventGroup, sourceBuffer, kHostIp.SpanKey(), ctAttrs.Get<kIp>()); // pod ip
                     COPY_AND_SET_TAG(
                         eventGroup, sourceBuffer, kHostName.SpanKey(), ctAttrs.Get<kPodName>()); // pod name
@@ -1067,7 +1056,9 @@ bool NetworkObserverManager::ConsumeSpanAggregateTree() { // handler
                     LOG_DEBUG(sLogger, ("record span tags", "")(std::string(kConnTrackerTable.ColSpanKey(i)), sb.data));
                 }
 
-                spanEvent->SetTraceId(TraceIDToString(record->GetTraceId()));
+                // spans of a propagated trace are emitted with its trace id, so that they join the upstream trace
+                spanEvent->SetTraceId(record->HasTraceContext() ? TraceParentIDToString(record->GetTraceContext())
+                                                                : TraceIDToString(record->GetTraceId()));
                 spanEvent->SetSpanId(SpanIDToString(record->GetSpanId()));
                 spanEvent->SetStatus(record->IsError() ? SpanEvent::StatusCode::Error : SpanEvent::StatusCode::Ok);
                 auto role = ct->GetRole();
@@ -1166,6 +1157,20 @@ int NetworkObserverManager::Init() {
     mCidOffset = GuessContainerIdOffset();
     mConvergerManager = std::make_shared<AppConvergerManager>();
 
+    if (BOOL_FLAG(ebpf_networkobserver_enable_tail_sampling)) {
+        TailSamplerOptions opt;
+        opt.mDecisionWaitMs = INT32_FLAG(ebpf_networkobserver_tail_sampling_wait_ms);
+        opt.mSpansPerSecBudget = DOUBLE_FLAG(ebpf_networkobserver_tail_sampling_spans_per_sec);
+        opt.mSlowThresholdMs = INT32_FLAG(ebpf_networkobserver_tail_sampling_slow_threshold_ms);
+        opt.mMaxBufferedSpans = INT32_FLAG(ebpf_networkobserver_tail_sampling_max_buffered_spans);
+        mTailSampler = std::make_unique<TailSampler<std::shared_ptr<CommonEvent>>>(opt);
+        mTailSampler->SetMetrics(mTailSamplerBufferedSpans,
+                                 mTailSamplerKeptSpansTotal,
+                                 mTailSamplerDroppedSpansTotal,
+                                 mTailSamplerDecisionMs);
+        LOG_INFO(sLogger, ("tail sampling enabled, spans per sec", opt.mSpansPerSecBudget));
+    }
+
     const char* value = getenv("_cluster_id_");
     if (value != nullptr) {
         mClusterId = value;
@@ -1299,6 +1304,8 @@ int NetworkObserverManager::AddOrUpdateConfig(const CollectionPipelineContext* c
     newConfig->mQueueKey = ctx->GetProcessQueueKey();
     newConfig->mPluginIndex = index;
     newConfig->mConfigName = ctx->GetConfigName();
+    // records without propagated trace context are still head sampled, each of them would be a trace of its own
+    newConfig->mEnableTailSampling = mTailSampler != nullptr;
     mConvergerManager->RegisterApp(newConfig);
 
     WriteLock lk(mAppConfigLock);
@@ -1656,6 +1663,11 @@ void NetworkObserverManager::AcceptNetCtrlEvent(struct conn_ctrl_event_t* event)
 
 int NetworkObserverManager::SendEvents() {
     auto nowMs = TimeKeeper::GetInstance()->NowMs();
+    if (mTailSampler) {
+        mTailSampler->Flush(nowMs, mTailSampledRecords);
+        processTailSampledRecords();
+    }
+
     // consume log agg tree -- 2000ms
     if (nowMs - mLastSendLogTimeMs >= mSendLogIntervalMs) {
         LOG_DEBUG(sLogger, ("begin consume log agg tree", "log"));
@@ -1909,11 +1921,22 @@ int NetworkObserverManager::HandleEvent([[maybe_unused]] const std::shared_ptr<C
     auto* record = static_cast<L7Record*>(commonEvent.get());
     if (record) {
         auto appDetail = record->GetAppDetail();
-        if (appDetail->mEnableLog && record->ShouldSample()) {
-            processRecordAsLog(commonEvent, appDetail);
-        }
-        if (appDetail->mEnableSpan && record->ShouldSample()) {
-            processRecordAsSpan(commonEvent, appDetail);
+        if (mTailSampler && (appDetail->mEnableLog || appDetail->mEnableSpan) && record->HasTraceContext()) {
+            mTailSampler->Offer(record->GetTraceContext(),
+                                appDetail->mAppHash,
+                                record->GetLatencyMs(),
+                                record->IsError(),
+                                std::shared_ptr<CommonEvent>(commonEvent),
+                                TimeKeeper::GetInstance()->NowMs(),
+                                mTailSampledRecords);
+            processTailSampledRecords();
+        } else {
+            if (appDetail->mEnableLog && record->ShouldSample()) {
+                processRecordAsLog(commonEvent, appDetail);
+            }
+            if (appDetail->mEnableSpan && record->ShouldSample()) {
+                processRecordAsSpan(commonEvent, appDetail);
+            }
         }
         if (appDetail->mEnableMetric) {
             processRecordAsMetric(record, appDetail);
@@ -1922,6 +1945,20 @@ int NetworkObserverManager::HandleEvent([[maybe_unused]] const std::shared_ptr<C
     return 0;
 }
 
+void NetworkObserverManager::processTailSampledRecords() {
+    for (const auto& commonEvent : mTailSampledRecords) {
+        auto* record = static_cast<L7Record*>(commonEvent.get());
+        auto appDetail = record->GetAppDetail();
+        if (appDetail->mEnableLog) {
+            processRecordAsLog(commonEvent, appDetail);
+        }
+        if (appDetail->mEnableSpan) {
+            processRecordAsSpan(commonEvent, appDetail);
+        }
+    }
+    mTailSampledRecords.clear();
+}
+
 int NetworkObserverManager::Destroy() {
     if (!mInited) {
         return 0;
@@ -1952,6 +1989,10 @@ int NetworkObserverManager::Destroy() {
     mLostCtrlEventsTotal = 0;
     mLostDataEventsTotal = 0;
 
+    LOG_INFO(sLogger, ("destroy stage", "release tail sampler"));
+    mTailSampler.reset();
+    mTailSampledRecords.clear();
+
     LOG_INFO(sLogger, ("destroy stage", "clear agg tree"));
     mAppAggregator.Reset();
     mNetAggregator.Reset();
@@ -29,6 +29,7 @@
 #include "ebpf/util/Converger.h"
 #include "ebpf/util/FrequencyManager.h"
 #include "ebpf/util/sampler/Sampler.h"
+#include "ebpf/util/sampler/TailSampler.h"
 
 namespace logtail::ebpf {
 
@@ -123,6 +124,16 @@ public:
         mPushLogFailedTotal = std::move(lossLogsTotal);
     }
 
+    void SetTailSamplerMetrics(IntGaugePtr bufferedSpans,
+                               CounterPtr keptSpansTotal,
+                               CounterPtr droppedSpansTotal,
+                               TimeCounterPtr decisionMs) {
+        mTailSamplerBufferedSpans = std::move(bufferedSpans);
+        mTailSamplerKeptSpansTotal = std::move(keptSpansTotal);
+        mTailSamplerDroppedSpansTotal = std::move(droppedSpansTotal);
+        mTailSamplerDecisionMs = std::move(decisionMs);
+    }
+
     // periodically tasks ...
     bool ConsumeLogAggregateTree();
     bool ConsumeMetricAggregateTree();
@@ -206,6 +217,11 @@ private:
     SIZETAggTree<AppSpanGroup, std::shared_ptr<CommonEvent>> mSpanAggregator;
     SIZETAggTree<AppLogGroup, std::shared_ptr<CommonEvent>> mLogAggregator;
 
+    // only created when tail sampling is enabled, records kept by it are collected in mTailSampledRecords
+    void processTailSampledRecords();
+    std::unique_ptr<TailSampler<std::shared_ptr<CommonEvent>>> mTailSampler;
+    std::vector<std::shared_ptr<CommonEvent>> mTailSampledRecords;
+
     void updateConfigVersionAndWhitelist(std::vector<std::pair<std::string, uint64_t>>&& newCids,
                                          std::vector<std::string>&& expiredCids) {
         if (!newCids.empty() || !expiredCids.empty()) {
@@ -266,6 +282,10 @@ private:
     CounterPtr mLossKernelEventsTotal;
     IntGaugePtr mConnectionNum;
     CounterPtr mPushLogFailedTotal;
+    IntGaugePtr mTailSamplerBufferedSpans;
+    CounterPtr mTailSamplerKeptSpansTotal;
+    CounterPtr mTailSamplerDroppedSpansTotal;
+    TimeCounterPtr mTailSamplerDecisionMs;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class NetworkObserverManagerUnittest;
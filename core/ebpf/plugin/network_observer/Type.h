@@ -28,6 +28,7 @@ extern "C" {
 #include "common/HashUtil.h"
 #include "common/Lock.h"
 #include "ebpf/include/export.h"
+#include "ebpf/type/table/StaticDataRow.h"
 #include "ebpf/util/sampler/Sampler.h"
 #include "monitor/metric_models/MetricTypes.h"
 #include "monitor/metric_models/ReentrantMetricsRecord.h"
@@ -72,6 +73,12 @@ public:
         AttrHashCombine(mAppHash, hasher(mServiceId));
         AttrHashCombine(mAppHash, hasher(mLanguage));
 
+        mStaticAttrs.Set<kAppId>(mAppId);
+        mStaticAttrs.Set<kAppName>(mAppName);
+        mStaticAttrs.Set<kWorkspace>(mWorkspace);
+        mStaticAttrs.Set<kArmsServiceId>(mServiceId);
+        mStaticAttrs.Set<kLanguage>(mLanguage);
+
         if (metricMgr) {
             // init metrics
             MetricLabels eventTypeLabels = {{METRIC_LABEL_KEY_EVENT_TYPE, METRIC_LABEL_VALUE_EVENT_TYPE_METRIC}};
@@ -163,6 +170,8 @@ public:
     std::string mWorkspace;
     std::string mServiceId;
     std::string mLanguage;
+    // pre-encoded constant attributes, attached to event groups as tags without copy
+    StaticDataRow<&kAppStaticTable> mStaticAttrs;
 
     bool mEnableL7;
     bool mEnableLog;
@@ -173,6 +182,8 @@ public:
     // sampler ...
     double mSampleRate;
     std::shared_ptr<Sampler> mSampler;
+    // records carrying trace context are all kept by the parser and decided per trace by the tail sampler
+    bool mEnableTailSampling = false;
     // plugin queue key ...
     std::string mConfigName;
     QueueKey mQueueKey = 0;
@@ -14,6 +14,8 @@
 
 #include "HttpParser.h"
 
+#include <algorithm>
+#include <cctype>
 #include <map>
 
 #include "common/StringTools.h"
@@ -26,6 +28,7 @@ namespace logtail::ebpf {
 inline constexpr char kContentLength[] = "Content-Length";
 inline constexpr char kTransferEncoding[] = "Transfer-Encoding";
 inline constexpr char kUpgrade[] = "Upgrade";
+inline constexpr std::string_view kTraceParent = "traceparent";
 
 std::vector<std::shared_ptr<L7Record>>
 HTTPProtocolParser::Parse(struct conn_data_event_t* dataEvent,
@@ -36,8 +39,14 @@ HTTPProtocolParser::Parse(struct conn_data_event_t* dataEvent,
     record->SetEndTsNs(dataEvent->end_ts);
     record->SetStartTsNs(dataEvent->start_ts);
     auto spanId = GenerateSpanID();
+    // request headers are parsed once, for both the trace context and the request itself
+    std::string_view reqBuf(dataEvent->msg, dataEvent->request_len);
+    HTTPRequest req;
+    int reqRetval = dataEvent->request_len > 0 ? http::ParseHttpRequest(reqBuf, req) : -1;
+    // requests carrying trace context are kept here, the tail sampler decides on the whole trace later
+    bool tailSampled = appDetail->mEnableTailSampling && reqRetval >= 0 && http::ParseTraceContext(req, record);
     // slow request
-    if (record->GetLatencyMs() > 500 || appDetail->mSampler->ShouldSample(spanId)) {
+    if (tailSampled || record->GetLatencyMs() > 500 || appDetail->mSampler->ShouldSample(spanId)) {
         record->MarkSample();
     }
 
@@ -52,8 +61,7 @@ HTTPProtocolParser::Parse(struct conn_data_event_t* dataEvent,
     }
 
     if (dataEvent->request_len > 0) {
-        std::string_view buf(dataEvent->msg, dataEvent->request_len);
-        ParseState state = http::ParseRequest(buf, record, false);
+        ParseState state = http::ParseRequest(reqBuf, req, reqRetval, record, false);
         if (state != ParseState::kSuccess) {
             LOG_DEBUG(sLogger, ("[HTTPProtocolParser]: Parse HTTP request failed", int(state)));
             return {};
@@ -82,6 +90,25 @@ HeadersMap GetHTTPHeadersMap(const phr_header* headers, size_t numHeaders) {
     return result;
 }
 
+bool ParseTraceContext(const HTTPRequest& req, std::shared_ptr<HttpRecord>& result) {
+    for (size_t i = 0; i < req.mNumHeaders; ++i) {
+        std::string_view name(req.mHeaders[i].name, req.mHeaders[i].name_len);
+        if (name.size() != kTraceParent.size()
+            || !std::equal(name.begin(), name.end(), kTraceParent.begin(), [](char lhs, char rhs) {
+                   return std::tolower(static_cast<unsigned char>(lhs)) == rhs;
+               })) {
+            continue;
+        }
+        std::array<uint64_t, 4> traceId{};
+        if (!ParseTraceParent(std::string_view(req.mHeaders[i].value, req.mHeaders[i].value_len), traceId)) {
+            return false;
+        }
+        result->SetTraceContext(traceId);
+        return true;
+    }
+    return false;
+}
+
 int ParseHttpRequest(std::string_view& buf, HTTPRequest& result) {
     return phr_parse_request(buf.data(),
                              buf.size(),
@@ -102,6 +129,14 @@ const std::string kHttP1Prefix = "http1.";
 ParseState ParseRequest(std::string_view& buf, std::shared_ptr<HttpRecord>& result, bool forceSample) {
     HTTPRequest req;
     int retval = http::ParseHttpRequest(buf, req);
+    return ParseRequest(buf, req, retval, result, forceSample);
+}
+
+ParseState ParseRequest(std::string_view& buf,
+                        const HTTPRequest& req,
+                        int retval,
+                        std::shared_ptr<HttpRecord>& result,
+                        bool forceSample) {
     if (retval >= 0) {
         buf.remove_prefix(retval);
 
@@ -46,6 +46,12 @@ struct HTTPResponse {
 namespace http {
 
 ParseState ParseRequest(std::string_view& buf, std::shared_ptr<HttpRecord>& result, bool forceSample = false);
+// same as above with the headers already parsed into @req by ParseHttpRequest, which returned @retval
+ParseState ParseRequest(std::string_view& buf,
+                        const HTTPRequest& req,
+                        int retval,
+                        std::shared_ptr<HttpRecord>& result,
+                        bool forceSample = false);
 
 ParseState ParseRequestBody(std::string_view& buf, std::shared_ptr<HttpRecord>& result);
 
@@ -60,6 +66,9 @@ ParseState ParseContent(std::string_view& contentLenStr,
 ParseState
 ParseResponse(std::string_view& buf, std::shared_ptr<HttpRecord>& result, bool closed, bool forceSample = false);
 
+// look up the w3c traceparent header in the headers of a request parsed by ParseHttpRequest
+bool ParseTraceContext(const HTTPRequest& req, std::shared_ptr<HttpRecord>& result);
+
 int ParseHttpRequest(std::string_view& buf, HTTPRequest& result);
 } // namespace http
 
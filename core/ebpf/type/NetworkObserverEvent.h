@@ -69,6 +69,13 @@ public:
     const std::array<uint64_t, 2>& GetSpanId() { return mSpanId; }
     void SetTraceId(std::array<uint64_t, 4>&& traceId) { mTraceId = traceId; }
     void SetSpanId(std::array<uint64_t, 2>&& spanId) { mSpanId = spanId; }
+    // trace id propagated by the application, spans of the same request chain share it
+    [[nodiscard]] bool HasTraceContext() const { return mHasTraceContext; }
+    const std::array<uint64_t, 4>& GetTraceContext() const { return mTraceContext; }
+    void SetTraceContext(const std::array<uint64_t, 4>& traceId) {
+        mTraceContext = traceId;
+        mHasTraceContext = true;
+    }
 
 private:
     std::shared_ptr<Connection> mConnection;
@@ -78,6 +85,8 @@ private:
     bool mSample = false;
     mutable std::array<uint64_t, 4> mTraceId{};
     mutable std::array<uint64_t, 2> mSpanId{};
+    bool mHasTraceContext = false;
+    std::array<uint64_t, 4> mTraceContext{};
 };
 
 class HttpRecord : public L7Record {
@@ -180,6 +189,8 @@ public:
     virtual ~MetricData() {}
     explicit MetricData(std::shared_ptr<Connection>& conn) : mConnection(conn) {}
     std::shared_ptr<Connection> mConnection;
+    // keeps the app attributes referenced by tags alive, which are encoded once per AppDetail
+    std::shared_ptr<SourceBuffer> mAppAttrsBuffer;
 };
 
 class AppMetricData : public MetricData {
@@ -82,4 +82,15 @@ inline constexpr size_t kAppMetricsNum = std::size(kAppMetricsElements);
 
 inline constexpr auto kAppMetricsTable = DataTableSchema("app_metrics", "app metrics table", kAppMetricsElements);
 
+// attributes that are constant for an app, encoded once per AppDetail and shared by all groups of the app
+inline constexpr DataElement kAppStaticElements[] = {
+    kAppId,
+    kAppName,
+    kWorkspace,
+    kArmsServiceId,
+    kLanguage,
+};
+
+inline constexpr auto kAppStaticTable = DataTableSchema("app_static", "app constant attributes", kAppStaticElements);
+
 } // namespace logtail::ebpf
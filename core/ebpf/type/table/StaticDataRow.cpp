@@ -21,6 +21,7 @@ namespace logtail::ebpf {
 template class StaticDataRow<&kConnTrackerTable>;
 template class StaticDataRow<&kAppMetricsTable>;
 template class StaticDataRow<&kNetMetricsTable>;
+template class StaticDataRow<&kAppStaticTable>;
 
 template class StaticDataRow<&kProcessCacheTable>;
 
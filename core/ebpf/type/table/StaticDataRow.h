@@ -27,6 +27,7 @@
 #include "ebpf/type/table/NetTable.h"
 #include "ebpf/type/table/ProcessTable.h"
 #include "logger/Logger.h"
+#include "models/PipelineEventGroup.h"
 
 namespace logtail {
 namespace ebpf {
@@ -165,7 +166,16 @@ public:
         return schema->ColSpanKey(TIndex);
     }
 
-    std::shared_ptr<SourceBuffer> GetSourceBuffer() { return mSourceBuffer; }
+    std::shared_ptr<SourceBuffer> GetSourceBuffer() const { return mSourceBuffer; }
+
+    // set every column as a group tag without copying, the row's source buffer is attached to the group so that the
+    // values outlive the row itself
+    void SetGroupTagsNoCopy(PipelineEventGroup& group, StringView (DataTableSchema::*keyOf)(size_t) const) const {
+        group.AddSourceBuffer(mSourceBuffer);
+        for (size_t i = 0; i < schema->Size(); ++i) {
+            group.SetTagNoCopy((schema->*keyOf)(i), mRow[i]);
+        }
+    }
 
 private:
     std::shared_ptr<SourceBuffer> mSourceBuffer;
@@ -175,6 +185,7 @@ private:
 extern template class StaticDataRow<&kConnTrackerTable>;
 extern template class StaticDataRow<&kAppMetricsTable>;
 extern template class StaticDataRow<&kNetMetricsTable>;
+extern template class StaticDataRow<&kAppStaticTable>;
 
 extern template class StaticDataRow<&kProcessCacheTable>;
 
@@ -70,5 +70,40 @@ std::string SpanIDToString(const std::array<uint64_t, 2>& spanID) {
     return FromRandom64ID(spanID);
 }
 
+static bool ParseHex64(std::string_view value, uint64_t& result) {
+    result = 0;
+    for (char c : value) {
+        uint64_t digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else {
+            return false;
+        }
+        result = (result << 4) | digit;
+    }
+    return true;
+}
+
+// version "-" trace-id "-" parent-id "-" trace-flags, e.g. 00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01
+bool ParseTraceParent(std::string_view value, std::array<uint64_t, 4>& traceID) {
+    constexpr size_t kTraceParentLength = 55;
+    if (value.size() < kTraceParentLength || value[2] != '-' || value[35] != '-' || value[52] != '-') {
+        return false;
+    }
+    uint64_t high = 0;
+    uint64_t low = 0;
+    if (!ParseHex64(value.substr(3, 16), high) || !ParseHex64(value.substr(19, 16), low) || (high == 0 && low == 0)) {
+        return false;
+    }
+    traceID = {0, 0, high, low};
+    return true;
+}
+
+std::string TraceParentIDToString(const std::array<uint64_t, 4>& traceID) {
+    return FromRandom64ID(std::array<uint64_t, 2>{traceID[2], traceID[3]});
+}
+
 } // namespace ebpf
 } // namespace logtail
@@ -16,6 +16,8 @@
 
 
 #include <array>
+#include <string>
+#include <string_view>
 
 namespace logtail::ebpf {
 
@@ -24,5 +26,10 @@ std::array<uint64_t, 4> GenerateTraceID();
 std::array<uint64_t, 2> GenerateSpanID();
 std::string TraceIDToString(const std::array<uint64_t, 4>& traceID);
 std::string SpanIDToString(const std::array<uint64_t, 2>& spanID);
+// parse the trace id of a w3c traceparent header value, the 128 bit id is stored in the two low words so that the
+// randomness used by samplers is taken from its random part
+bool ParseTraceParent(std::string_view value, std::array<uint64_t, 4>& traceID);
+// format a trace id parsed by ParseTraceParent as the 32 hex digits of w3c trace context
+std::string TraceParentIDToString(const std::array<uint64_t, 4>& traceID);
 
 } // namespace logtail::ebpf
@@ -24,6 +24,10 @@ uint64_t TraceID64ToRandomness(const std::array<uint64_t, 2>& traceID) {
     return traceID[1] & kLeastHalfTraceIDThreasholdMask;
 }
 
+uint64_t TraceID64ToRandomness(const std::array<uint64_t, 4>& traceID) {
+    return traceID[3] & kLeastHalfTraceIDThreasholdMask;
+}
+
 
 constexpr double kMinSamplingProbability = (double)1.0 / double(kMaxAdjustedCount);
 constexpr uint64_t kAlwaysSampleThresHold = 0;
@@ -23,6 +23,11 @@
 
 namespace logtail::ebpf {
 
+uint64_t TraceID64ToRandomness(const std::array<uint64_t, 2>& traceID);
+uint64_t TraceID64ToRandomness(const std::array<uint64_t, 4>& traceID);
+uint64_t ProbabilityToThreshold(double fraction);
+double ThresholdToProbability(uint64_t threshold);
+
 class Sampler {
 public:
     [[nodiscard]] virtual bool ShouldSample(const std::array<uint64_t, 2>& traceID) const = 0;
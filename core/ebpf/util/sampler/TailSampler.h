@@ -0,0 +1,254 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/HashUtil.h"
+#include "ebpf/util/sampler/Sampler.h"
+#include "monitor/metric_models/MetricTypes.h"
+
+namespace logtail::ebpf {
+
+struct TailSamplerOptions {
+    // how long spans of a trace are buffered before the keep/drop decision
+    int64_t mDecisionWaitMs = 1000;
+    // total spans/sec budget shared by all services, error and slow traces are always kept but consume it first
+    double mSpansPerSecBudget = 1000;
+    double mSlowThresholdMs = 500;
+    // hard bound of buffered spans, the oldest traces are decided early when exceeded
+    size_t mMaxBufferedSpans = 100000;
+    size_t mMaxServices = 1024;
+    int64_t mRateAdjustIntervalMs = 1000;
+    double mMinSampleRate = 0.0001;
+};
+
+struct TraceIDHash {
+    size_t operator()(const std::array<uint64_t, 4>& traceId) const {
+        size_t result = 0UL;
+        for (auto word : traceId) {
+            AttrHashCombine(result, std::hash<uint64_t>{}(word));
+        }
+        return result;
+    }
+};
+
+// Tail-based sampler: spans are buffered per trace for a short window and the decision is made once latency and
+// status of the whole trace are known. Error and slow traces are always kept, the others are kept with a per service
+// rate which is adapted every interval so that the total output approaches the spans/sec budget, the budget left by
+// priority traces is split among services by max-min fairness.
+// NOT thread-safe, should be owned by a single handler thread.
+template <typename T>
+class TailSampler {
+public:
+    using TraceID = std::array<uint64_t, 4>;
+
+    explicit TailSampler(const TailSamplerOptions& options) : mOptions(options) {}
+
+    void SetMetrics(IntGaugePtr bufferedSpans,
+                    CounterPtr keptSpansTotal,
+                    CounterPtr droppedSpansTotal,
+                    TimeCounterPtr decisionLatency) {
+        mBufferedSpansGauge = std::move(bufferedSpans);
+        mKeptSpansTotal = std::move(keptSpansTotal);
+        mDroppedSpansTotal = std::move(droppedSpansTotal);
+        mDecisionLatency = std::move(decisionLatency);
+    }
+
+    // buffer a finished span, spans of traces decided early because of the memory bound are appended to kept
+    void Offer(const TraceID& traceId,
+               size_t serviceKey,
+               double latencyMs,
+               bool isError,
+               T&& span,
+               int64_t nowMs,
+               std::vector<T>& kept) {
+        if (mLastAdjustMs == 0) {
+            mLastAdjustMs = nowMs;
+        }
+        auto it = mTraces.find(traceId);
+        if (it == mTraces.end()) {
+            it = mTraces.emplace(traceId, TraceEntry{{}, serviceKey, nowMs, 0, false}).first;
+            mArrivalOrder.emplace_back(traceId, nowMs);
+        }
+        auto& entry = it->second;
+        entry.mSpans.emplace_back(std::move(span));
+        entry.mMaxLatencyMs = std::max(entry.mMaxLatencyMs, latencyMs);
+        entry.mHasError |= isError;
+        ++mBufferedSpans;
+
+        while (mBufferedSpans > mOptions.mMaxBufferedSpans && !mArrivalOrder.empty()) {
+            decideFront(nowMs, kept);
+        }
+        SET_GAUGE(mBufferedSpansGauge, mBufferedSpans);
+    }
+
+    // decide all traces whose window has elapsed
+    void Flush(int64_t nowMs, std::vector<T>& kept) {
+        while (!mArrivalOrder.empty() && nowMs - mArrivalOrder.front().second >= mOptions.mDecisionWaitMs) {
+            decideFront(nowMs, kept);
+        }
+        if (mLastAdjustMs != 0 && nowMs - mLastAdjustMs >= mOptions.mRateAdjustIntervalMs) {
+            adjustRates(nowMs);
+        }
+        SET_GAUGE(mBufferedSpansGauge, mBufferedSpans);
+    }
+
+    // decide every buffered trace regardless of its window
+    void FlushAll(int64_t nowMs, std::vector<T>& kept) {
+        while (!mArrivalOrder.empty()) {
+            decideFront(nowMs, kept);
+        }
+        SET_GAUGE(mBufferedSpansGauge, mBufferedSpans);
+    }
+
+    [[nodiscard]] size_t BufferedSpans() const { return mBufferedSpans; }
+    [[nodiscard]] size_t BufferedTraces() const { return mTraces.size(); }
+    [[nodiscard]] size_t ServiceCount() const { return mServices.size(); }
+    [[nodiscard]] uint64_t KeptSpans() const { return mKeptSpans; }
+    [[nodiscard]] uint64_t DroppedSpans() const { return mDroppedSpans; }
+    [[nodiscard]] double ServiceSampleRate(size_t serviceKey) const {
+        auto it = mServices.find(serviceKey);
+        return it == mServices.end() ? 1.0 : it->second.mRate;
+    }
+
+private:
+    struct TraceEntry {
+        std::vector<T> mSpans;
+        size_t mServiceKey;
+        int64_t mFirstSeenMs;
+        double mMaxLatencyMs;
+        bool mHasError;
+    };
+
+    struct ServiceState {
+        double mRate = 1.0;
+        // spans of normal traces decided during the current interval
+        uint64_t mNormalSpans = 0;
+        int64_t mLastActiveMs = 0;
+    };
+
+    void decideFront(int64_t nowMs, std::vector<T>& kept) {
+        auto [traceId, firstSeenMs] = mArrivalOrder.front();
+        mArrivalOrder.pop_front();
+        auto it = mTraces.find(traceId);
+        if (it == mTraces.end() || it->second.mFirstSeenMs != firstSeenMs) {
+            return;
+        }
+        decide(traceId, it->second, nowMs, kept);
+        mTraces.erase(it);
+    }
+
+    void decide(const TraceID& traceId, TraceEntry& entry, int64_t nowMs, std::vector<T>& kept) {
+        size_t spanCount = entry.mSpans.size();
+        bool keep = false;
+        if (entry.mHasError || entry.mMaxLatencyMs >= mOptions.mSlowThresholdMs) {
+            mPrioritySpansInInterval += spanCount;
+            keep = true;
+        } else {
+            double rate = mOptions.mMinSampleRate;
+            auto it = mServices.find(entry.mServiceKey);
+            if (it == mServices.end() && mServices.size() < mOptions.mMaxServices) {
+                it = mServices.emplace(entry.mServiceKey, ServiceState{}).first;
+            }
+            // services beyond the tracking limit are sampled at the minimum rate
+            if (it != mServices.end()) {
+                it->second.mNormalSpans += spanCount;
+                it->second.mLastActiveMs = nowMs;
+                rate = it->second.mRate;
+            }
+            keep = TraceID64ToRandomness(traceId) >= ProbabilityToThreshold(rate);
+        }
+
+        if (keep) {
+            for (auto& span : entry.mSpans) {
+                kept.emplace_back(std::move(span));
+            }
+            mKeptSpans += spanCount;
+            ADD_COUNTER(mKeptSpansTotal, spanCount);
+        } else {
+            mDroppedSpans += spanCount;
+            ADD_COUNTER(mDroppedSpansTotal, spanCount);
+        }
+        if (mDecisionLatency) {
+            mDecisionLatency->Add(std::chrono::milliseconds(nowMs - entry.mFirstSeenMs));
+        }
+        mBufferedSpans -= spanCount;
+    }
+
+    void adjustRates(int64_t nowMs) {
+        double elapsedSec = double(nowMs - mLastAdjustMs) / 1000.0;
+        mLastAdjustMs = nowMs;
+        double remaining = std::max(0.0, mOptions.mSpansPerSecBudget - double(mPrioritySpansInInterval) / elapsedSec);
+        mPrioritySpansInInterval = 0;
+
+        // max-min fair share of the remaining budget: services sending less than their share keep everything, the
+        // unused part is redistributed to the heavier ones
+        std::vector<std::pair<double, ServiceState*>> active;
+        for (auto it = mServices.begin(); it != mServices.end();) {
+            auto& state = it->second;
+            if (state.mNormalSpans == 0) {
+                if (nowMs - state.mLastActiveMs > mOptions.mRateAdjustIntervalMs * 60) {
+                    it = mServices.erase(it);
+                    continue;
+                }
+            } else {
+                active.emplace_back(double(state.mNormalSpans) / elapsedSec, &state);
+            }
+            ++it;
+        }
+        std::sort(active.begin(), active.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+        size_t left = active.size();
+        for (auto& [observed, state] : active) {
+            double share = remaining / double(left--);
+            double alloc = std::min(observed, share);
+            remaining -= alloc;
+            double target = std::clamp(alloc / observed, mOptions.mMinSampleRate, 1.0);
+            // smooth to avoid oscillation between intervals
+            state->mRate = std::clamp((state->mRate + target) / 2, mOptions.mMinSampleRate, 1.0);
+            state->mNormalSpans = 0;
+        }
+    }
+
+    TailSamplerOptions mOptions;
+    std::unordered_map<TraceID, TraceEntry, TraceIDHash> mTraces;
+    // traces in first seen order, entries of traces decided early are skipped lazily
+    std::deque<std::pair<TraceID, int64_t>> mArrivalOrder;
+    std::unordered_map<size_t, ServiceState> mServices;
+    size_t mBufferedSpans = 0;
+    uint64_t mPrioritySpansInInterval = 0;
+    int64_t mLastAdjustMs = 0;
+    uint64_t mKeptSpans = 0;
+    uint64_t mDroppedSpans = 0;
+
+    IntGaugePtr mBufferedSpansGauge;
+    CounterPtr mKeptSpansTotal;
+    CounterPtr mDroppedSpansTotal;
+    TimeCounterPtr mDecisionLatency;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class TailSamplerUnittest;
+#endif
+};
+
+} // namespace logtail::ebpf
@@ -237,6 +237,22 @@ void ConfigManager::RemoveHandler(const string& dir, bool delete_flag) {
 
 // this functions should only be called when register base dir
 bool ConfigManager::RegisterHandlers() {
+    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
+    return RegisterHandlers(nameConfigMap);
+}
+
+bool ConfigManager::RegisterHandlers(const unordered_set<string>& configNames) {
+    unordered_map<string, FileDiscoveryConfig> nameConfigMap;
+    for (const auto& name : configNames) {
+        auto config = FileServer::GetInstance()->GetFileDiscoveryConfig(name);
+        if (config.first != nullptr) {
+            nameConfigMap[name] = config;
+        }
+    }
+    return RegisterHandlers(nameConfigMap);
+}
+
+bool ConfigManager::RegisterHandlers(const unordered_map<string, FileDiscoveryConfig>& nameConfigMap) {
     if (mSharedHandler == NULL) {
         mSharedHandler = new NormalEventHandler();
     }
@@ -244,7 +260,6 @@ bool ConfigManager::RegisterHandlers() {
     // Build and sort path items from all configs.
     vector<PathItem> sortedPaths; // 所有精确路径（按原始 basePath 排序）
     vector<PathItem> wildcardPaths; // 所有通配符路径
-    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
     BuildAndSortPathItems(nameConfigMap, sortedPaths, wildcardPaths);
 
     // Check if has container config
@@ -974,6 +989,71 @@ void ConfigManager::ClearFilePipelineMatchCache() {
     mCacheFileAllConfigMap.clear();
 }
 
+// cached key is path + '<' + name, returns false if it cannot be split unambiguously
+static bool SplitCachedFileKey(const string& key, string& path, string& name) {
+    size_t nameStart = key.rfind(PATH_SEPARATOR[0]);
+    size_t pos = key.find('<', nameStart == string::npos ? 0 : nameStart);
+    if (pos == string::npos || key.find('<', pos + 1) != string::npos) {
+        return false;
+    }
+    path = key.substr(0, pos);
+    name = key.substr(pos + 1);
+    return true;
+}
+
+void ConfigManager::ClearFilePipelineMatchCache(const vector<FileDiscoveryConfig>& configs) {
+    if (configs.empty()) {
+        return;
+    }
+    unordered_set<const FileDiscoveryOptions*> options;
+    for (const auto& config : configs) {
+        options.insert(config.first);
+    }
+    string path, name;
+    auto isRelated = [&](const string& key) {
+        if (!SplitCachedFileKey(key, path, name)) {
+            return true;
+        }
+        for (const auto& config : configs) {
+            if (config.first->IsMatch(path, name)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    size_t cleared = 0;
+    {
+        ScopedSpinLock lock(mCacheFileConfigMapLock);
+        for (auto iter = mCacheFileConfigMap.begin(); iter != mCacheFileConfigMap.end();) {
+            if (options.count(iter->second.first.first) > 0 || isRelated(iter->first)) {
+                iter = mCacheFileConfigMap.erase(iter);
+                ++cleared;
+            } else {
+                ++iter;
+            }
+        }
+    }
+    {
+        ScopedSpinLock allLock(mCacheFileAllConfigMapLock);
+        for (auto iter = mCacheFileAllConfigMap.begin(); iter != mCacheFileAllConfigMap.end();) {
+            bool related = false;
+            for (const auto& config : iter->second.first) {
+                if (options.count(config.first) > 0) {
+                    related = true;
+                    break;
+                }
+            }
+            if (related || isRelated(iter->first)) {
+                iter = mCacheFileAllConfigMap.erase(iter);
+                ++cleared;
+            } else {
+                ++iter;
+            }
+        }
+    }
+    LOG_INFO(sLogger, ("clear file pipeline match cache, config count", configs.size())("cleared", cleared));
+}
+
 #ifdef APSARA_UNIT_TEST_MAIN
 void ConfigManager::CleanEnviroments() {
     for (std::unordered_map<std::string, EventHandler*>::iterator iter = mDirEventHandlerMap.begin();
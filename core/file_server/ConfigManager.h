@@ -20,6 +20,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -257,6 +258,9 @@ public:
                               int32_t depth);
     bool RegisterHandlers(const std::string& basePath, const FileDiscoveryConfig& config);
     bool RegisterHandlers();
+    // register dirs of the given configs only, used by per config update
+    bool RegisterHandlers(const std::unordered_set<std::string>& configNames);
+    bool RegisterHandlers(const std::unordered_map<std::string, FileDiscoveryConfig>& nameConfigMap);
     bool RegisterHandlersRecursively(const std::string& dir, const FileDiscoveryConfig& config, bool checkTimeout);
     // 废弃，蚂蚁
     // /**
@@ -417,6 +421,10 @@ public:
     // void RemoveAllConfigs();
 
     void ClearFilePipelineMatchCache();
+    // ClearFilePipelineMatchCache clears match results related to @configs only, i.e. results which contain one of
+    // them or whose path is matched by one of them. It must be called with the old configs before they are removed
+    // and with the new configs after they are added.
+    void ClearFilePipelineMatchCache(const std::vector<FileDiscoveryConfig>& configs);
 
     void ClearConfigMatchCache();
 
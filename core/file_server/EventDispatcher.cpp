@@ -28,6 +28,7 @@
 #include <limits.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "app_config/AppConfig.h"
@@ -196,16 +197,19 @@ bool EventDispatcher::RegisterEventHandler(const string& path,
                     sLogger,
                     ("ignore replace handler",
                      "both path and inode of dir is registered, handler is sharedHandler")("path", path)("wd", wd));
+                mWdDirInfoMap[wd]->mConfigNames.insert(config.second->GetConfigName());
                 return true;
             } else if (ConfigManager::GetInstance()->GetSharedHandler() == mWdDirInfoMap[wd]->mHandler) {
                 LOG_DEBUG(sLogger,
                           ("replace handler", "both path and inode of dir is registered, just replace EventHandler")(
                               "path", path)("wd", wd));
                 mWdDirInfoMap[wd]->mHandler = handler;
+                mWdDirInfoMap[wd]->mConfigNames.insert(config.second->GetConfigName());
                 return true;
             } else {
                 LOG_DEBUG(sLogger, ("still use current hander, dir", path)("inode", inode)("wd", wd));
                 handler = mWdDirInfoMap[wd]->mHandler;
+                mWdDirInfoMap[wd]->mConfigNames.insert(config.second->GetConfigName());
                 return true;
             }
         }
@@ -313,6 +317,7 @@ bool EventDispatcher::RegisterEventHandler(const string& path,
     LOG_INFO(sLogger,
              ("add a new watcher for dir", path)("wd", wd)("dir inode", inode)("isSymbolicLink", isSymbolicLink));
     DirInfo* dirInfo = new DirInfo(path, inode, isSymbolicLink, handler);
+    dirInfo->mConfigNames.insert(config.second->GetConfigName());
     AddOneToOneMapEntry(dirInfo, wd);
     ++mWatchNum;
     AddExistedFileEvents(path, wd);
@@ -628,7 +633,7 @@ EventDispatcher::ValidateCheckpointResult EventDispatcher::validateCheckpoint(
     return ValidateCheckpointResult::kDevInodeNotFound;
 }
 
-void EventDispatcher::AddExistedCheckPointFileEvents() {
+void EventDispatcher::AddExistedCheckPointFileEvents(const unordered_set<string>* configNames) {
     // All checkpoint will be add into event queue or be deleted
     // This operation will delete not existed file's check point
     map<DevInode, SplitedFilePath> cachePathDevInodeMap;
@@ -653,6 +658,12 @@ void EventDispatcher::AddExistedCheckPointFileEvents() {
     // Load exactly once checkpoints and create events from them.
     // Because they are not in v1 checkpoint manager, no need to delete them.
     auto exactlyOnceConfigs = FileServer::GetInstance()->GetExactlyOnceConfigs();
+    if (configNames != nullptr) {
+        exactlyOnceConfigs.erase(remove_if(exactlyOnceConfigs.begin(),
+                                           exactlyOnceConfigs.end(),
+                                           [configNames](const string& name) { return configNames->count(name) == 0; }),
+                                 exactlyOnceConfigs.end());
+    }
     if (!exactlyOnceConfigs.empty()) {
         static auto* sCptMV2 = CheckpointManagerV2::GetInstance();
         auto exactlyOnceCpts = sCptMV2->ScanCheckpoints(exactlyOnceConfigs);
@@ -821,8 +832,8 @@ void EventDispatcher::CheckSymbolicLink() {
     }
 }
 
-void EventDispatcher::ReadInotifyEvents(vector<Event*>& eventVec) {
-    mEventListener->ReadEvents(eventVec);
+void EventDispatcher::ReadInotifyEvents(vector<Event*>& eventVec, int32_t& coalescedCount) {
+    mEventListener->ReadEvents(eventVec, coalescedCount);
 }
 
 vector<pair<string, EventHandler*>> EventDispatcher::FindAllSubDirAndHandler(const string& baseDir) {
@@ -1008,6 +1019,49 @@ void EventDispatcher::DumpAllHandlersMeta(bool remove) {
     LOG_INFO(sLogger, ("save log reader status", "succeeded"));
 }
 
+void EventDispatcher::DumpHandlersMeta(const unordered_set<string>& configNames, vector<string>& configDirs) {
+    for (auto it = mWdDirInfoMap.begin(); it != mWdDirInfoMap.end(); ++it) {
+        auto* dirInfo = it->second;
+        auto* handler = dynamic_cast<CreateModifyHandler*>(dirInfo->mHandler);
+        bool detached = handler != nullptr && handler->DetachModifyHandlers(configNames);
+        // dirs without readers, e.g. empty or intermediate dirs, are also owned by the configs which registered them
+        size_t ownerCnt = dirInfo->mConfigNames.size();
+        for (const auto& name : configNames) {
+            dirInfo->mConfigNames.erase(name);
+        }
+        if (detached || dirInfo->mConfigNames.size() != ownerCnt) {
+            configDirs.push_back(dirInfo->mPath);
+        }
+    }
+    LOG_INFO(sLogger, ("save log reader status", "succeeded")("config dir count", configDirs.size()));
+}
+
+void EventDispatcher::UnregisterUnmatchedDirs(const vector<string>& dirs) {
+    size_t unregistered = 0;
+    for (const auto& path : dirs) {
+        auto pathIter = mPathWdMap.find(path);
+        if (pathIter == mPathWdMap.end()) {
+            continue;
+        }
+        auto* dirInfo = mWdDirInfoMap[pathIter->second];
+        // registered again by the new configs, or still registered by unchanged configs
+        if (!dirInfo->mConfigNames.empty()) {
+            continue;
+        }
+        auto* handler = dirInfo->mHandler;
+        auto* createModifyHandler = dynamic_cast<CreateModifyHandler*>(handler);
+        if (createModifyHandler != nullptr && createModifyHandler->HasModifyHandler()) {
+            continue;
+        }
+        UnregisterEventHandler(path);
+        ConfigManager::GetInstance()->RemoveHandler(path, false);
+        // the shared handler is skipped by ConfigManager::DeleteHandlers
+        ConfigManager::GetInstance()->AddHandlerToDelete(handler);
+        ++unregistered;
+    }
+    LOG_INFO(sLogger, ("unregister unmatched dirs", "succeeded")("dir count", unregistered));
+}
+
 void EventDispatcher::ProcessHandlerTimeOut() {
     MapType<int, DirInfo*>::Type::iterator mapIter = mWdDirInfoMap.begin();
     for (; mapIter != mWdDirInfoMap.end(); ++mapIter) {
@@ -71,6 +71,8 @@ struct DirInfo {
     uint64_t mInode;
     bool mIsSymbolicLink;
     EventHandler* mHandler;
+    // configs which registered this dir, used to find dirs to unregister when configs are updated
+    std::unordered_set<std::string> mConfigNames;
 
     DirInfo() : mPath(std::string()), mInode(0), mIsSymbolicLink(false), mHandler(NULL) {}
     DirInfo(const std::string& path, uint64_t inode, bool isSymbolicLink, EventHandler* handler)
@@ -198,6 +200,11 @@ public:
     // virtual void ExtraWork() = 0;
 
     void DumpAllHandlersMeta(bool);
+    // Dump and detach readers of the given configs only, handlers of other configs keep their readers.
+    // Directories registered by the configs or whose modify handlers are detached are appended to configDirs.
+    void DumpHandlersMeta(const std::unordered_set<std::string>& configNames, std::vector<std::string>& configDirs);
+    // Unregister directories which are no more registered by any config, should be called after configs are updated.
+    void UnregisterUnmatchedDirs(const std::vector<std::string>& dirs);
     std::vector<std::pair<std::string, EventHandler*> > FindAllSubDirAndHandler(const std::string& baseDir);
     void UnregisterAllDir(const std::string& basePath);
     bool IsRegistered(int wd, std::string& path);
@@ -210,10 +217,11 @@ public:
     void PropagateTimeout(const std::string& path);
     void HandleTimeout();
 
-    void ReadInotifyEvents(std::vector<Event*>& eventVec);
+    void ReadInotifyEvents(std::vector<Event*>& eventVec, int32_t& coalescedCount);
 
     void ProcessHandlerTimeOut();
-    void AddExistedCheckPointFileEvents();
+    // configNames: only exactly once checkpoints of these configs are scanned, nullptr for all configs
+    void AddExistedCheckPointFileEvents(const std::unordered_set<std::string>* configNames = nullptr);
 
     void DumpInotifyWatcherDirs();
 
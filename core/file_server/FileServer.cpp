@@ -29,6 +29,9 @@
 #include "plugin/input/InputFile.h"
 
 DEFINE_FLAG_BOOL(enable_polling_discovery, "", true);
+DEFINE_FLAG_BOOL(file_server_incremental_reload,
+                 "only detach and reattach readers of updated configs instead of all readers on config update",
+                 true);
 
 using namespace std;
 
@@ -39,6 +42,10 @@ FileServer::FileServer() {
         mMetricsRecordRef,
         MetricCategory::METRIC_CATEGORY_RUNNER,
         {{METRIC_LABEL_KEY_RUNNER_NAME, METRIC_LABEL_VALUE_RUNNER_NAME_FILE_SERVER}});
+    mConfigUpdateTotal = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_FILE_CONFIG_UPDATE_TOTAL);
+    mConfigUpdateStallTimeMs = mMetricsRecordRef.CreateCounter(METRIC_RUNNER_FILE_CONFIG_UPDATE_STALL_TIME_MS);
+    mLastConfigUpdateStallTimeMs
+        = mMetricsRecordRef.CreateIntGauge(METRIC_RUNNER_FILE_LAST_CONFIG_UPDATE_STALL_TIME_MS);
 }
 
 // 启动文件服务，包括加载配置、处理检查点、注册事件等
@@ -80,6 +87,80 @@ void FileServer::Pause(bool isConfigUpdate) {
     }
 }
 
+// 按配置暂停文件服务，只转储并卸载变更配置的reader并清理相关缓存，其他配置的reader保持不变
+void FileServer::PauseForConfigUpdate(const unordered_set<string>& configNames) {
+    mConfigUpdatePauseTime = GetCurrentTimeInMilliSeconds();
+    if (!BOOL_FLAG(file_server_incremental_reload)) {
+        Pause(true);
+        return;
+    }
+    PauseInner();
+    // old configs are still alive here, they are removed by the pipelines later
+    auto oldConfigs = getFileDiscoveryConfigs(configNames);
+    mConfigUpdateDirs.clear();
+    EventDispatcher::GetInstance()->DumpHandlersMeta(configNames, mConfigUpdateDirs);
+    EventDispatcher::GetInstance()->ClearBrokenLinkSet();
+    PollingDirFile::GetInstance()->ClearCache(oldConfigs);
+    ConfigManager::GetInstance()->ClearFilePipelineMatchCache(oldConfigs);
+}
+
+// 按配置恢复文件服务，只为变更配置注册目录并恢复其reader
+void FileServer::ResumeForConfigUpdate(const unordered_set<string>& configNames) {
+    if (!BOOL_FLAG(file_server_incremental_reload)) {
+        Resume(true, false);
+        recordConfigUpdateStall();
+        return;
+    }
+    auto newConfigs = getFileDiscoveryConfigs(configNames);
+    PollingDirFile::GetInstance()->ClearCache(newConfigs);
+    ConfigManager::GetInstance()->ClearFilePipelineMatchCache(newConfigs);
+    // container diffs may also touch unchanged configs, their dirs must be registered as well
+    bool containerUpdated = ContainerManager::GetInstance()->CheckContainerDiffForAllConfig();
+    if (containerUpdated) {
+        ContainerManager::GetInstance()->ApplyContainerDiffs();
+        ContainerManager::GetInstance()->SaveContainerInfo();
+    }
+    LOG_INFO(sLogger,
+             ("file server resume for config update", "starts")("config count", configNames.size())(
+                 "isContainerUpdate", containerUpdated));
+    if (containerUpdated) {
+        ConfigManager::GetInstance()->RegisterHandlers();
+    } else {
+        ConfigManager::GetInstance()->RegisterHandlers(configNames);
+    }
+    EventDispatcher::GetInstance()->UnregisterUnmatchedDirs(mConfigUpdateDirs);
+    mConfigUpdateDirs.clear();
+    LOG_INFO(sLogger, ("watch dirs", "succeeded"));
+    EventDispatcher::GetInstance()->AddExistedCheckPointFileEvents(&configNames);
+    LogInput::GetInstance()->Resume();
+    if (BOOL_FLAG(enable_polling_discovery)) {
+        PollingModify::GetInstance()->Resume();
+        PollingDirFile::GetInstance()->Resume();
+    }
+    recordConfigUpdateStall();
+    LOG_INFO(sLogger, ("file server resume for config update", "succeeded"));
+}
+
+vector<FileDiscoveryConfig> FileServer::getFileDiscoveryConfigs(const unordered_set<string>& names) const {
+    vector<FileDiscoveryConfig> res;
+    ReadLock lock(mReadWriteLock);
+    for (const auto& name : names) {
+        auto itr = mPipelineNameFileDiscoveryConfigsMap.find(name);
+        if (itr != mPipelineNameFileDiscoveryConfigsMap.end()) {
+            res.push_back(itr->second);
+        }
+    }
+    return res;
+}
+
+void FileServer::recordConfigUpdateStall() {
+    auto stallMs = GetCurrentTimeInMilliSeconds() - mConfigUpdatePauseTime;
+    ADD_COUNTER(mConfigUpdateTotal, 1);
+    ADD_COUNTER(mConfigUpdateStallTimeMs, stallMs);
+    SET_GAUGE(mLastConfigUpdateStallTimeMs, stallMs);
+    LOG_INFO(sLogger, ("file ingestion stalled by config update, cost", ToString(stallMs) + "ms"));
+}
+
 // 暂停文件服务的内部实现，记录日志并处理暂停逻辑
 void FileServer::PauseInner() {
     LOG_INFO(sLogger, ("file server pause", "starts"));
@@ -18,7 +18,9 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "collection_pipeline/CollectionPipelineContext.h"
 #include "common/Lock.h"
@@ -44,6 +46,11 @@ public:
 
     void Start();
     void Pause(bool isConfigUpdate = true);
+    // Per config update: only readers, watches and caches of the given configs are detached in pause and reattached
+    // in resume, readers of other configs keep their state. Must be called in pairs, with the names of all removed,
+    // modified and added file configs. Falls back to Pause/Resume if file_server_incremental_reload is off.
+    void PauseForConfigUpdate(const std::unordered_set<std::string>& configNames);
+    void ResumeForConfigUpdate(const std::unordered_set<std::string>& configNames);
 
     // for plugin
     FileDiscoveryConfig GetFileDiscoveryConfig(const std::string& name) const;
@@ -102,6 +109,8 @@ private:
     ~FileServer() = default;
 
     void PauseInner();
+    std::vector<FileDiscoveryConfig> getFileDiscoveryConfigs(const std::unordered_set<std::string>& names) const;
+    void recordConfigUpdateStall();
 
     mutable ReadWriteLock mReadWriteLock;
 
@@ -119,6 +128,13 @@ private:
     std::unordered_map<std::string, uint32_t> mPipelineNameEOConcurrencyMap;
 
     mutable MetricsRecordRef mMetricsRecordRef;
+    CounterPtr mConfigUpdateTotal;
+    CounterPtr mConfigUpdateStallTimeMs;
+    IntGaugePtr mLastConfigUpdateStallTimeMs;
+
+    uint64_t mConfigUpdatePauseTime = 0;
+    // dirs registered by the configs of the ongoing config update, or whose readers are detached by it
+    std::vector<std::string> mConfigUpdateDirs;
 };
 
 } // namespace logtail
@@ -29,6 +29,7 @@
 #include "file_server/FileDiscoveryOptions.h"
 #include "logger/Logger.h"
 #include "monitor/AlarmManager.h"
+#include "protobuf/sls/checkpoint.pb.h"
 
 using namespace std;
 DECLARE_FLAG_STRING(check_point_filename);
@@ -40,6 +41,12 @@ DEFINE_FLAG_INT32(check_point_version, "now check point version xx.xx.xx such as
 DEFINE_FLAG_INT32(check_point_dump_interval, "default 15 min", 15 * 60);
 DEFINE_FLAG_INT32(check_point_max_count, "max check point count", 100000);
 DEFINE_FLAG_INT32(checkpoint_find_max_file_count, "", 1000);
+// off by default: the checkpoint file is migrated to the store on the first dump and removed once the store is
+// loaded on a later start, so versions without the store would find no checkpoint after a rollback. To downgrade
+// after turning it on, turn it off and let one dump happen first, the store is migrated back to the checkpoint file.
+DEFINE_FLAG_BOOL(checkpoint_enable_incremental_store,
+                 "dump file checkpoints incrementally to a binary store instead of rewriting the whole checkpoint file",
+                 false);
 
 namespace logtail {
 
@@ -130,6 +137,24 @@ void CheckPointManager::AddDirCheckPoint(const string& dirname) {
 void CheckPointManager::LoadCheckPoint() {
     Json::Value root;
     ParseConfResult cptRes = ParseConfig(AppConfig::GetInstance()->GetCheckPointFilePath(), root);
+    int32_t storeVersion = NO_CHECKPOINT_VERSION;
+    CheckPointStore::Snapshot storeRecords;
+    // the store is read even if the checkpoint file exists, so that the next dump only writes differences
+    bool storeLoaded = readStore(storeVersion, storeRecords);
+    // checkpoint file is newer than the store if both exist, i.e. the store is just enabled or failed to be written
+    if (cptRes == CONFIG_NOT_EXIST && storeLoaded) {
+        loadStoreRecords(storeVersion, storeRecords);
+        // the store is proven readable, the checkpoint file kept when migrating to it is no longer needed
+        string migratedFile = getMigratedCheckPointFilePath();
+        if (CheckExistance(migratedFile) && remove(migratedFile.c_str()) == 0) {
+            LOG_INFO(sLogger, ("migrated checkpoint file removed", migratedFile));
+        }
+        return;
+    }
+    // the store fails to be loaded after migration, fall back to the checkpoint file kept at that time
+    if (cptRes == CONFIG_NOT_EXIST) {
+        cptRes = ParseConfig(getMigratedCheckPointFilePath(), root);
+    }
     // if new checkpoint file not exist, check old checkpoint file.
     if (cptRes == CONFIG_NOT_EXIST && AppConfig::GetInstance()->GetCheckPointFilePath() != GetCheckPointFileName()) {
         cptRes = ParseConfig(GetCheckPointFileName(), root);
@@ -338,6 +363,35 @@ void CheckPointManager::LoadFileCheckPoint(const Json::Value& root) {
 }
 bool CheckPointManager::DumpCheckPointToLocal() {
     mLastDumpTime = time(NULL);
+    mReaderCount = mDevInodeCheckPointPtrMap.size();
+    vector<CheckPoint*> checkPoints = getCheckPointsToDump();
+    if (BOOL_FLAG(checkpoint_enable_incremental_store)) {
+        if (openStore() && dumpCheckPointToStore(checkPoints)) {
+            return true;
+        }
+        // checkpoint file takes precedence over the store on next load
+        LOG_WARNING(sLogger, ("failed to dump checkpoint to store", "dump to checkpoint file instead"));
+    }
+    return dumpCheckPointToFile(checkPoints);
+}
+
+vector<CheckPoint*> CheckPointManager::getCheckPointsToDump() {
+    vector<CheckPoint*> checkPoints;
+    checkPoints.reserve(mDevInodeCheckPointPtrMap.size());
+    for (auto it = mDevInodeCheckPointPtrMap.begin(); it != mDevInodeCheckPointPtrMap.end(); ++it) {
+        checkPoints.push_back(it->second.get());
+    }
+    if (checkPoints.size() > (size_t)INT32_FLAG(check_point_max_count)) {
+        sort(checkPoints.begin(), checkPoints.end(), CheckPointManager::CheckPointCmpByUpdateTime);
+        checkPoints.resize(INT32_FLAG(check_point_max_count));
+        LOG_WARNING(sLogger, ("Too many check point", mDevInodeCheckPointPtrMap.size()));
+        AlarmManager::GetInstance()->SendAlarmWarning(
+            CHECKPOINT_ALARM, "Too many check point:" + ToString(mDevInodeCheckPointPtrMap.size()));
+    }
+    return checkPoints;
+}
+
+bool CheckPointManager::dumpCheckPointToFile(const vector<CheckPoint*>& checkPoints) {
     string checkPointFile = AppConfig::GetInstance()->GetCheckPointFilePath();
     string checkPointTempFile = checkPointFile + ".bak";
 
@@ -348,71 +402,28 @@ bool CheckPointManager::DumpCheckPointToLocal() {
     }
 
     Json::Value root;
-    mReaderCount = mDevInodeCheckPointPtrMap.size();
-    if (mDevInodeCheckPointPtrMap.size() <= (size_t)INT32_FLAG(check_point_max_count)) {
-        CheckPointManager::DevInodeCheckPointHashMap::iterator it;
-        for (it = mDevInodeCheckPointPtrMap.begin(); it != mDevInodeCheckPointPtrMap.end(); ++it) {
-            CheckPoint* checkPointPtr = it->second.get();
-            Json::Value leaf;
-            leaf["file_name"] = Json::Value(checkPointPtr->mFileName);
-            leaf["resolved_file_name"] = Json::Value(checkPointPtr->mResolvedFileName);
-            leaf["real_file_name"] = Json::Value(checkPointPtr->mRealFileName);
-            leaf["offset"] = Json::Value(ToString(checkPointPtr->mOffset));
-            leaf["sig_size"] = Json::Value(Json::UInt(checkPointPtr->mSignatureSize));
-            leaf["sig_hash"] = Json::Value(Json::UInt64(checkPointPtr->mSignatureHash));
-            leaf["update_time"] = Json::Value(checkPointPtr->mLastUpdateTime);
-            leaf["inode"] = Json::Value(Json::UInt64(checkPointPtr->mDevInode.inode));
-            leaf["dev"] = Json::Value(Json::UInt64(checkPointPtr->mDevInode.dev));
-            leaf["file_open"] = Json::Value(checkPointPtr->mFileOpenFlag ? 1 : 0);
-            leaf["container_stopped"] = Json::Value(checkPointPtr->mContainerStopped ? 1 : 0);
-            leaf["container_id"] = Json::Value(checkPointPtr->mContainerID);
-            leaf["last_force_read"] = Json::Value(checkPointPtr->mLastForceRead ? 1 : 0);
-            leaf["config_name"] = Json::Value(checkPointPtr->mConfigName);
-            // forward compatible
-            leaf["sig"] = Json::Value(string(""));
-            leaf["idx_in_reader_array"] = Json::Value(checkPointPtr->mIdxInReaderArray);
-            // use filename + dev + inode + configName to prevent same filename conflict
-            root[checkPointPtr->mFileName + "*" + ToString(checkPointPtr->mDevInode.dev) + "*"
-                 + ToString(checkPointPtr->mDevInode.inode) + "*" + checkPointPtr->mConfigName]
-                = leaf;
-        }
-    } else {
-        vector<CheckPoint*> sortedCheckPointVec;
-        CheckPointManager::DevInodeCheckPointHashMap::iterator it;
-        for (it = mDevInodeCheckPointPtrMap.begin(); it != mDevInodeCheckPointPtrMap.end(); ++it) {
-            sortedCheckPointVec.push_back(it->second.get());
-        }
-        sort(sortedCheckPointVec.begin(), sortedCheckPointVec.end(), CheckPointManager::CheckPointCmpByUpdateTime);
-        for (int32_t i = 0; i < INT32_FLAG(check_point_max_count); ++i) {
-            CheckPoint* checkPointPtr = sortedCheckPointVec[i];
-            Json::Value leaf;
-            leaf["file_name"] = Json::Value(checkPointPtr->mFileName);
-            leaf["real_file_name"] = Json::Value(checkPointPtr->mRealFileName);
-            leaf["offset"] = Json::Value(ToString(checkPointPtr->mOffset));
-            leaf["sig_size"] = Json::Value(Json::UInt(checkPointPtr->mSignatureSize));
-            leaf["sig_hash"] = Json::Value(Json::UInt64(checkPointPtr->mSignatureHash));
-            leaf["update_time"] = Json::Value(checkPointPtr->mLastUpdateTime);
-            leaf["inode"] = Json::Value(Json::UInt64(checkPointPtr->mDevInode.inode));
-            leaf["dev"] = Json::Value(Json::UInt64(checkPointPtr->mDevInode.dev));
-            leaf["file_open"] = Json::Value(checkPointPtr->mFileOpenFlag ? 1 : 0);
-            leaf["container_stopped"] = Json::Value(checkPointPtr->mContainerStopped ? 1 : 0);
-            leaf["container_id"] = Json::Value(checkPointPtr->mContainerID);
-            leaf["last_force_read"] = Json::Value(checkPointPtr->mLastForceRead ? 1 : 0);
-            leaf["config_name"] = Json::Value(checkPointPtr->mConfigName);
-            // forward compatible
-            leaf["sig"] = Json::Value(string(""));
-            leaf["idx_in_reader_array"] = Json::Value(checkPointPtr->mIdxInReaderArray);
-            // use filename + dev + inode + configName to prevent same filename conflict
-            root[checkPointPtr->mFileName + "*" + ToString(checkPointPtr->mDevInode.dev) + "*"
-                 + ToString(checkPointPtr->mDevInode.inode) + "*" + checkPointPtr->mConfigName]
-                = leaf;
-        }
-        LOG_WARNING(sLogger, ("Too many check point", mDevInodeCheckPointPtrMap.size()));
-        AlarmManager::GetInstance()->SendAlarmWarning(
-            CHECKPOINT_ALARM, "Too many check point:" + ToString(mDevInodeCheckPointPtrMap.size()));
+    for (CheckPoint* checkPointPtr : checkPoints) {
+        Json::Value leaf;
+        leaf["file_name"] = Json::Value(checkPointPtr->mFileName);
+        leaf["resolved_file_name"] = Json::Value(checkPointPtr->mResolvedFileName);
+        leaf["real_file_name"] = Json::Value(checkPointPtr->mRealFileName);
+        leaf["offset"] = Json::Value(ToString(checkPointPtr->mOffset));
+        leaf["sig_size"] = Json::Value(Json::UInt(checkPointPtr->mSignatureSize));
+        leaf["sig_hash"] = Json::Value(Json::UInt64(checkPointPtr->mSignatureHash));
+        leaf["update_time"] = Json::Value(checkPointPtr->mLastUpdateTime);
+        leaf["inode"] = Json::Value(Json::UInt64(checkPointPtr->mDevInode.inode));
+        leaf["dev"] = Json::Value(Json::UInt64(checkPointPtr->mDevInode.dev));
+        leaf["file_open"] = Json::Value(checkPointPtr->mFileOpenFlag ? 1 : 0);
+        leaf["container_stopped"] = Json::Value(checkPointPtr->mContainerStopped ? 1 : 0);
+        leaf["container_id"] = Json::Value(checkPointPtr->mContainerID);
+        leaf["last_force_read"] = Json::Value(checkPointPtr->mLastForceRead ? 1 : 0);
+        leaf["config_name"] = Json::Value(checkPointPtr->mConfigName);
+        // forward compatible
+        leaf["sig"] = Json::Value(string(""));
+        leaf["idx_in_reader_array"] = Json::Value(checkPointPtr->mIdxInReaderArray);
+        root[getCheckPointKey(*checkPointPtr)] = leaf;
     }
 
-
     Json::Value dirJson;
     for (unordered_map<string, DirCheckPointPtr>::iterator it = mDirNameMap.begin(); it != mDirNameMap.end(); ++it) {
         DirCheckPoint* ptr = it->second.get();
@@ -458,10 +469,159 @@ bool CheckPointManager::DumpCheckPointToLocal() {
     LOG_DEBUG(sLogger,
               ("dump checkpoint, version", INT32_FLAG(check_point_version))(
                   "file check point", mDevInodeCheckPointPtrMap.size())("dir check point", mDirNameMap.size()));
+    if (!BOOL_FLAG(checkpoint_enable_incremental_store) && CheckPointStore::Exists(getCheckPointStorePath())) {
+        // migrated back to checkpoint file
+        mStore.reset();
+        if (CheckPointStore::Destroy(getCheckPointStorePath())) {
+            LOG_INFO(sLogger, ("checkpoint store removed", getCheckPointStorePath()));
+        }
+        remove(getMigratedCheckPointFilePath().c_str());
+    }
+    return true;
+}
 
+bool CheckPointManager::dumpCheckPointToStore(const vector<CheckPoint*>& checkPoints) {
+    CheckPointStore::Snapshot records;
+    records.reserve(checkPoints.size() + mDirNameMap.size());
+    FileCheckpointPB filePB;
+    for (CheckPoint* checkPointPtr : checkPoints) {
+        filePB.Clear();
+        filePB.set_file_name(checkPointPtr->mFileName);
+        filePB.set_resolved_file_name(checkPointPtr->mResolvedFileName);
+        filePB.set_real_file_name(checkPointPtr->mRealFileName);
+        filePB.set_offset(checkPointPtr->mOffset);
+        filePB.set_sig_size(checkPointPtr->mSignatureSize);
+        filePB.set_sig_hash(checkPointPtr->mSignatureHash);
+        filePB.set_update_time(checkPointPtr->mLastUpdateTime);
+        filePB.set_dev(checkPointPtr->mDevInode.dev);
+        filePB.set_inode(checkPointPtr->mDevInode.inode);
+        filePB.set_file_open(checkPointPtr->mFileOpenFlag);
+        filePB.set_container_stopped(checkPointPtr->mContainerStopped);
+        filePB.set_container_id(checkPointPtr->mContainerID);
+        filePB.set_last_force_read(checkPointPtr->mLastForceRead);
+        filePB.set_config_name(checkPointPtr->mConfigName);
+        filePB.set_idx_in_reader_array(checkPointPtr->mIdxInReaderArray);
+        filePB.SerializeToString(&records[CheckPointStore::kFileKeyPrefix + getCheckPointKey(*checkPointPtr)]);
+    }
+    DirCheckpointPB dirPB;
+    for (auto it = mDirNameMap.begin(); it != mDirNameMap.end(); ++it) {
+        dirPB.Clear();
+        dirPB.set_update_time(it->second->mUpdateTime);
+        for (const auto& subDir : it->second->mSubDir) {
+            dirPB.add_sub_dir(subDir);
+        }
+        dirPB.SerializeToString(&records[CheckPointStore::kDirKeyPrefix + it->first]);
+    }
+    if (!mStore->Write(INT32_FLAG(check_point_version), records)) {
+        return false;
+    }
+    string checkPointFile = AppConfig::GetInstance()->GetCheckPointFilePath();
+    if (CheckExistance(checkPointFile)) {
+        // migrated to the store, the checkpoint file is kept aside until the store is loaded on a later start
+        string migratedFile = getMigratedCheckPointFilePath();
+#if defined(_MSC_VER)
+        remove(migratedFile.c_str());
+#endif
+        if (rename(checkPointFile.c_str(), migratedFile.c_str()) == 0) {
+            LOG_INFO(sLogger, ("checkpoint file kept after migrated to store", migratedFile));
+        } else {
+            LOG_WARNING(sLogger, ("failed to rename checkpoint file, errno", errno)("file", checkPointFile));
+        }
+    }
+    LOG_DEBUG(sLogger,
+              ("dump checkpoint to store, version", INT32_FLAG(check_point_version))(
+                  "file check point", checkPoints.size())("dir check point", mDirNameMap.size())(
+                  "put", mStore->GetLastPutCount())("delete", mStore->GetLastDeleteCount()));
     return true;
 }
 
+string CheckPointManager::getCheckPointKey(const CheckPoint& checkPoint) {
+    // use filename + dev + inode + configName to prevent same filename conflict
+    return checkPoint.mFileName + "*" + ToString(checkPoint.mDevInode.dev) + "*" + ToString(checkPoint.mDevInode.inode)
+        + "*" + checkPoint.mConfigName;
+}
+
+string CheckPointManager::getCheckPointStorePath() {
+    return AppConfig::GetInstance()->GetCheckPointFilePath() + "_store";
+}
+
+string CheckPointManager::getMigratedCheckPointFilePath() {
+    return AppConfig::GetInstance()->GetCheckPointFilePath() + ".migrated";
+}
+
+bool CheckPointManager::openStore() {
+    if (!mStore || mStore->GetPath() != getCheckPointStorePath()) {
+        mStore.reset(new CheckPointStore(getCheckPointStorePath()));
+    }
+    return mStore->Open();
+}
+
+bool CheckPointManager::readStore(int32_t& version, CheckPointStore::Snapshot& records) {
+    if (BOOL_FLAG(checkpoint_enable_incremental_store)) {
+        return openStore() && mStore->Load(version, records);
+    }
+    // the store is disabled, it is read once and removed after the first dump to checkpoint file
+    if (!CheckPointStore::Exists(getCheckPointStorePath())) {
+        return false;
+    }
+    CheckPointStore store(getCheckPointStorePath());
+    return store.Open() && store.Load(version, records);
+}
+
+void CheckPointManager::loadStoreRecords(int32_t version, const CheckPointStore::Snapshot& records) {
+    mLoadVersion = version;
+    mReaderCount = 0;
+    FileCheckpointPB filePB;
+    DirCheckpointPB dirPB;
+    for (const auto& record : records) {
+        const string& key = record.first;
+        if (StartWith(key, CheckPointStore::kDirKeyPrefix)) {
+            string dirname = key.substr(CheckPointStore::kDirKeyPrefix.size());
+            if (!dirPB.ParseFromString(record.second)) {
+                LOG_ERROR(sLogger, ("failed to parse dir checkpoint", dirname));
+                continue;
+            }
+            if (dirPB.update_time() < (time(NULL) - INT32_FLAG(file_check_point_time_out))) {
+                LOG_INFO(sLogger,
+                         ("load timeout dir check point, ignore", dirname)(ToString(dirPB.update_time()), time(NULL)));
+                continue;
+            }
+            DirCheckPointPtr dir(new DirCheckPoint(dirname));
+            // keep the persisted time, so that the record is not rewritten by the next dump
+            dir->mUpdateTime = dirPB.update_time();
+            dir->mSubDir.insert(dirPB.sub_dir().begin(), dirPB.sub_dir().end());
+            mDirNameMap.insert(make_pair(dirname, dir));
+        } else if (StartWith(key, CheckPointStore::kFileKeyPrefix)) {
+            ++mReaderCount;
+            if (!filePB.ParseFromString(record.second)) {
+                LOG_ERROR(sLogger, ("failed to parse file checkpoint", key));
+                AlarmManager::GetInstance()->SendAlarmWarning(CHECKPOINT_ALARM,
+                                                              "failed to parse file checkpoint in store:" + key);
+                continue;
+            }
+            CheckPoint* ptr = new CheckPoint(filePB.file_name(),
+                                             filePB.resolved_file_name(),
+                                             filePB.offset(),
+                                             filePB.sig_size(),
+                                             filePB.sig_hash(),
+                                             DevInode(filePB.dev(), filePB.inode()),
+                                             filePB.config_name(),
+                                             filePB.real_file_name(),
+                                             filePB.file_open(),
+                                             filePB.container_stopped(),
+                                             filePB.container_id(),
+                                             filePB.last_force_read());
+            ptr->mLastUpdateTime = filePB.update_time();
+            ptr->mIdxInReaderArray = filePB.has_idx_in_reader_array() ? filePB.idx_in_reader_array()
+                                                                       : LogFileReader::CHECKPOINT_IDX_UNDEFINED;
+            AddCheckPoint(ptr);
+        }
+    }
+    LOG_INFO(sLogger,
+             ("load checkpoint from store, version", mLoadVersion)(
+                 "file check point", mDevInodeCheckPointPtrMap.size())("dir check point", mDirNameMap.size()));
+}
+
 int32_t CheckPointManager::GetReaderCount() {
     return mReaderCount;
 }
@@ -28,6 +28,7 @@
 #include "common/DevInode.h"
 #include "common/EncodingConverter.h"
 #include "common/SplitedFilePath.h"
+#include "file_server/checkpoint/CheckPointStore.h"
 #include "file_server/reader/LogFileReader.h"
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -125,9 +126,21 @@ private:
     int32_t mLastDumpTime;
     int32_t mLoadVersion;
     int32_t mReaderCount;
+    // incremental binary store, replaces the json checkpoint file if checkpoint_enable_incremental_store is on
+    std::unique_ptr<CheckPointStore> mStore;
     CheckPointManager()
         : mLastCheckTime(time(NULL)), mLastDumpTime(time(NULL)), mLoadVersion(NO_CHECKPOINT_VERSION), mReaderCount(0) {}
 
+    std::vector<CheckPoint*> getCheckPointsToDump();
+    bool dumpCheckPointToFile(const std::vector<CheckPoint*>& checkPoints);
+    bool dumpCheckPointToStore(const std::vector<CheckPoint*>& checkPoints);
+    bool openStore();
+    bool readStore(int32_t& version, CheckPointStore::Snapshot& records);
+    void loadStoreRecords(int32_t version, const CheckPointStore::Snapshot& records);
+    static std::string getCheckPointKey(const CheckPoint& checkPoint);
+    static std::string getCheckPointStorePath();
+    static std::string getMigratedCheckPointFilePath();
+
 public:
     bool CheckVersion();
     void AddCheckPoint(CheckPoint* checkPointPtr);
@@ -158,6 +171,7 @@ public:
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ConfigUpdatorUnittest;
+    friend class CheckpointManagerUnittest;
     void RemoveLocalCheckPoint();
     void PrintStatus();
 #endif
@@ -0,0 +1,152 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/checkpoint/CheckPointStore.h"
+
+#include <memory>
+
+#include "leveldb/write_batch.h"
+
+#include "common/FileSystemUtil.h"
+#include "common/HashUtil.h"
+#include "common/StringTools.h"
+#include "logger/Logger.h"
+#include "monitor/AlarmManager.h"
+
+namespace logtail {
+
+const std::string CheckPointStore::kFileKeyPrefix = "f:";
+const std::string CheckPointStore::kDirKeyPrefix = "d:";
+const std::string CheckPointStore::kVersionKey = "version";
+
+static void logStoreError(const std::string& op, const std::string& path, const leveldb::Status& s) {
+    LOG_ERROR(sLogger, ("error when access checkpoint store", op)("path", path)("status", s.ToString()));
+    AlarmManager::GetInstance()->SendAlarmWarning(CHECKPOINT_ALARM,
+                                                  "error when access checkpoint store, op:" + op
+                                                      + ", status:" + s.ToString());
+}
+
+bool CheckPointStore::Open() {
+    if (mDatabase != nullptr) {
+        return true;
+    }
+    if (!Mkdirs(ParentPath(mPath))) {
+        LOG_ERROR(sLogger, ("open check point store dir error", mPath));
+        return false;
+    }
+    leveldb::Options options;
+    options.create_if_missing = true;
+    leveldb::Status s = leveldb::DB::Open(options, mPath, &mDatabase);
+    if (!s.ok()) {
+        logStoreError("open", mPath, s);
+        mDatabase = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void CheckPointStore::Close() {
+    if (mDatabase != nullptr) {
+        delete mDatabase;
+        mDatabase = nullptr;
+    }
+    mPersistedDigests.clear();
+}
+
+bool CheckPointStore::Load(int32_t& version, Snapshot& records) {
+    if (mDatabase == nullptr) {
+        return false;
+    }
+    bool hasVersion = false;
+    mPersistedDigests.clear();
+    std::unique_ptr<leveldb::Iterator> iter(mDatabase->NewIterator(leveldb::ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        std::string key = iter->key().ToString();
+        std::string value = iter->value().ToString();
+        mPersistedDigests[key] = HashString(value);
+        if (key == kVersionKey) {
+            hasVersion = StringTo(value, version);
+            continue;
+        }
+        records.emplace(std::move(key), std::move(value));
+    }
+    if (!iter->status().ok()) {
+        logStoreError("load", mPath, iter->status());
+        mPersistedDigests.clear();
+        return false;
+    }
+    return hasVersion;
+}
+
+bool CheckPointStore::Write(int32_t version, const Snapshot& records) {
+    mLastPutCount = 0;
+    mLastDeleteCount = 0;
+    if (mDatabase == nullptr) {
+        return false;
+    }
+    leveldb::WriteBatch batch;
+    std::unordered_map<std::string, uint64_t> digests;
+    digests.reserve(records.size() + 1);
+    auto putIfChanged = [&](const std::string& key, const std::string& value) {
+        uint64_t digest = HashString(value);
+        if (!isPersisted(key, digest)) {
+            batch.Put(key, value);
+            ++mLastPutCount;
+        }
+        digests.emplace(key, digest);
+    };
+    putIfChanged(kVersionKey, ToString(version));
+    for (const auto& record : records) {
+        putIfChanged(record.first, record.second);
+    }
+    for (const auto& persisted : mPersistedDigests) {
+        if (digests.find(persisted.first) == digests.end()) {
+            batch.Delete(persisted.first);
+            ++mLastDeleteCount;
+        }
+    }
+    if (mLastPutCount == 0 && mLastDeleteCount == 0) {
+        return true;
+    }
+    // one fsync for the whole batch
+    leveldb::WriteOptions options;
+    options.sync = true;
+    leveldb::Status s = mDatabase->Write(options, &batch);
+    if (!s.ok()) {
+        logStoreError("write", mPath, s);
+        return false;
+    }
+    mPersistedDigests.swap(digests);
+    return true;
+}
+
+bool CheckPointStore::isPersisted(const std::string& key, uint64_t digest) const {
+    auto it = mPersistedDigests.find(key);
+    return it != mPersistedDigests.end() && it->second == digest;
+}
+
+bool CheckPointStore::Exists(const std::string& path) {
+    return CheckExistance(path);
+}
+
+bool CheckPointStore::Destroy(const std::string& path) {
+    leveldb::Status s = leveldb::DestroyDB(path, leveldb::Options());
+    if (!s.ok()) {
+        logStoreError("destroy", path, s);
+        return false;
+    }
+    return true;
+}
+
+} // namespace logtail
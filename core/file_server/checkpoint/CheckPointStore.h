@@ -0,0 +1,75 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "leveldb/db.h"
+
+namespace logtail {
+
+// Binary store of file and dir checkpoints in leveldb. Each dump passes the full snapshot, which is still serialized
+// and hashed as a whole, but only records changed since the last load or write are put and records missing from the
+// snapshot are deleted, all in one synced write batch, so the bytes written to disk per dump scale with the number of
+// changed checkpoints instead of all checkpoints.
+// NOT thread-safe, owned by CheckPointManager.
+class CheckPointStore {
+public:
+    // record key -> serialized record
+    typedef std::unordered_map<std::string, std::string> Snapshot;
+
+    static const std::string kFileKeyPrefix;
+    static const std::string kDirKeyPrefix;
+    static const std::string kVersionKey;
+
+    explicit CheckPointStore(const std::string& path) : mPath(path) {}
+    ~CheckPointStore() { Close(); }
+
+    bool Open();
+    void Close();
+    bool IsOpen() const { return mDatabase != nullptr; }
+    const std::string& GetPath() const { return mPath; }
+
+    // Loads all records, version key excluded. Returns false if the store holds no snapshot (version key is absent)
+    // or fails to be read.
+    bool Load(int32_t& version, Snapshot& records);
+    // Persists the snapshot incrementally.
+    bool Write(int32_t version, const Snapshot& records);
+
+    size_t GetLastPutCount() const { return mLastPutCount; }
+    size_t GetLastDeleteCount() const { return mLastDeleteCount; }
+
+    static bool Exists(const std::string& path);
+    static bool Destroy(const std::string& path);
+
+private:
+    bool isPersisted(const std::string& key, uint64_t digest) const;
+
+    std::string mPath;
+    leveldb::DB* mDatabase = nullptr;
+    // record key -> digest of the persisted value
+    std::unordered_map<std::string, uint64_t> mPersistedDigests;
+    size_t mLastPutCount = 0;
+    size_t mLastDeleteCount = 0;
+};
+
+} // namespace logtail
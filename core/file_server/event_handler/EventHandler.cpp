@@ -214,6 +214,23 @@ ModifyHandler* CreateModifyHandler::GetOrCreateModifyHandler(const std::string&
     return pHanlder;
 }
 
+bool CreateModifyHandler::DetachModifyHandlers(const std::unordered_set<std::string>& configNames) {
+    bool detached = false;
+    for (auto iter = mModifyHandlerPtrMap.begin(); iter != mModifyHandlerPtrMap.end();) {
+        if (configNames.find(iter->first) == configNames.end()) {
+            ++iter;
+            continue;
+        }
+        // same order as EventDispatcher::DumpAllHandlersMeta, normal readers overwrite rotator ones
+        iter->second->DumpReaderMeta(true, true);
+        iter->second->DumpReaderMeta(false, true);
+        ConfigManager::GetInstance()->AddHandlerToDelete(iter->second);
+        iter = mModifyHandlerPtrMap.erase(iter);
+        detached = true;
+    }
+    return detached;
+}
+
 CreateModifyHandler::~CreateModifyHandler() {
     for (ModifyHandlerMap::iterator iter = mModifyHandlerPtrMap.begin(); iter != mModifyHandlerPtrMap.end(); ++iter) {
         delete iter->second;
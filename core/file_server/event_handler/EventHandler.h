@@ -20,6 +20,7 @@
 #include <deque>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "file_server/reader/LogFileReader.h"
 
@@ -173,6 +174,11 @@ public:
     bool IsAllFileRead() override;
 
     ModifyHandler* GetOrCreateModifyHandler(const std::string& configName, const FileDiscoveryConfig& pConfig);
+    // Dump readers of the given configs to checkpoints and detach their modify handlers, which are deleted later by
+    // ConfigManager::DeleteHandlers. Readers of other configs in this directory are not touched.
+    // @return true if any modify handler is detached.
+    bool DetachModifyHandlers(const std::unordered_set<std::string>& configNames);
+    bool HasModifyHandler() const { return !mModifyHandlerPtrMap.empty(); }
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class CreateModifyHandlerUnittest;
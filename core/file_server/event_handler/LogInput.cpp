@@ -53,6 +53,10 @@ DEFINE_FLAG_INT32(dump_inotify_watcher_interval, "seconds", 180);
 DEFINE_FLAG_INT32(clear_config_match_interval, "seconds", 600);
 DEFINE_FLAG_INT32(check_block_event_interval, "seconds", 1);
 DEFINE_FLAG_INT32(read_local_event_interval, "seconds", 60);
+DEFINE_FLAG_INT32(max_inotify_event_queue_size,
+                  "inotify events are not read while the event queue holds more events than this",
+                  100000);
+DEFINE_FLAG_INT32(log_input_event_batch_size, "max number of events processed between two reads of events", 64);
 DEFINE_FLAG_BOOL(force_close_file_on_container_stopped,
                  "whether close file handler immediately when associate container stopped",
                  false);
@@ -90,6 +94,12 @@ void LogInput::Start() {
         = FileServer::GetInstance()->GetMetricsRecordRef().CreateIntGauge(METRIC_RUNNER_FILE_ACTIVE_READERS_TOTAL);
     mEnableFileIncludedByMultiConfigs = FileServer::GetInstance()->GetMetricsRecordRef().CreateIntGauge(
         METRIC_RUNNER_FILE_ENABLE_FILE_INCLUDED_BY_MULTI_CONFIGS_FLAG);
+    mRawEventsTotal
+        = FileServer::GetInstance()->GetMetricsRecordRef().CreateCounter(METRIC_RUNNER_FILE_RAW_EVENTS_TOTAL);
+    mCoalescedEventsTotal
+        = FileServer::GetInstance()->GetMetricsRecordRef().CreateCounter(METRIC_RUNNER_FILE_COALESCED_EVENTS_TOTAL);
+    mPendingEventsTotal
+        = FileServer::GetInstance()->GetMetricsRecordRef().CreateIntGauge(METRIC_RUNNER_FILE_PENDING_EVENTS_TOTAL);
 
     mThreadRes = async(launch::async, &LogInput::ProcessLoop, this);
 }
@@ -123,9 +133,20 @@ void LogInput::TryReadEvents(bool forceRead) {
         return;
 
     int64_t curMicroSeconds = GetCurrentTimeInMicroSeconds();
-    if (forceRead || curMicroSeconds - mLastReadEventMicroSeconds >= INT64_FLAG(read_fs_events_interval)) {
+    bool queueFull = mInotifyEventQueue.size() >= (size_t)INT32_FLAG(max_inotify_event_queue_size);
+    if (queueFull != mInotifyReadBlocked) {
+        mInotifyReadBlocked = queueFull;
+        LOG_WARNING(sLogger,
+                    ("inotify event reading", queueFull ? "paused" : "resumed")("event queue size",
+                                                                                mInotifyEventQueue.size()));
+    }
+    if (!queueFull
+        && (forceRead || curMicroSeconds - mLastReadEventMicroSeconds >= INT64_FLAG(read_fs_events_interval))) {
         vector<Event*> inotifyEvents;
-        EventDispatcher::GetInstance()->ReadInotifyEvents(inotifyEvents);
+        int32_t coalescedCount = 0;
+        EventDispatcher::GetInstance()->ReadInotifyEvents(inotifyEvents, coalescedCount);
+        ADD_COUNTER(mRawEventsTotal, coalescedCount);
+        ADD_COUNTER(mCoalescedEventsTotal, coalescedCount);
         if (inotifyEvents.size() > 0) {
             PushEventQueue(inotifyEvents);
         }
@@ -378,14 +399,20 @@ void LogInput::ProcessLoop() {
     while (true) {
         ReadLock lock(mAccessMainThreadRWL);
         TryReadEvents(false);
-        Event* ev = PopEventQueue();
-        if (ev != NULL) {
+        // process a batch of events before reading again, so that modify events pile up and get coalesced
+        int32_t batchCount = 0;
+        Event* ev = NULL;
+        while (batchCount < INT32_FLAG(log_input_event_batch_size) && !mInteruptFlag
+               && (ev = PopEventQueue()) != NULL) {
+            ++batchCount;
             ++mEventProcessCount;
             if (mIdleFlag) {
                 delete ev;
             } else
                 ProcessEvent(dispatcher, ev);
-        } else {
+        }
+        SET_GAUGE(mPendingEventsTotal, mInotifyEventQueue.size());
+        if (batchCount == 0) {
             unique_lock<mutex> lock(mFeedbackMux);
             mFeedbackCV.wait_for(lock, chrono::microseconds(INT32_FLAG(log_input_thread_wait_interval)));
         }
@@ -465,6 +492,7 @@ void LogInput::ProcessLoop() {
 }
 
 void LogInput::PushEventQueue(std::vector<Event*>& eventVec) {
+    ADD_COUNTER(mRawEventsTotal, eventVec.size());
     for (std::vector<Event*>::iterator iter = eventVec.begin(); iter != eventVec.end(); ++iter) {
         string key;
         key.append((*iter)->GetSource())
@@ -479,6 +507,7 @@ void LogInput::PushEventQueue(std::vector<Event*>& eventVec) {
         int64_t hashKey = HashSignatureString(key.c_str(), key.size());
         if ((*iter)->GetType() == EVENT_MODIFY) {
             if (mModifyEventSet.find(hashKey) != mModifyEventSet.end()) {
+                ADD_COUNTER(mCoalescedEventsTotal, 1);
                 delete (*iter);
                 *iter = NULL;
                 continue;
@@ -491,6 +520,7 @@ void LogInput::PushEventQueue(std::vector<Event*>& eventVec) {
 }
 
 void LogInput::PushEventQueue(Event* ev) {
+    ADD_COUNTER(mRawEventsTotal, 1);
     string key;
     key.append(ev->GetSource())
         .append(">")
@@ -504,6 +534,7 @@ void LogInput::PushEventQueue(Event* ev) {
     int64_t hashKey = HashSignatureString(key.c_str(), key.size());
     if (ev->GetType() == EVENT_MODIFY) {
         if (mModifyEventSet.find(hashKey) != mModifyEventSet.end()) {
+            ADD_COUNTER(mCoalescedEventsTotal, 1);
             delete ev;
             return;
         } else
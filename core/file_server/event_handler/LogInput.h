@@ -70,8 +70,11 @@ private:
     Event* PopEventQueue();
     void UpdateCriticalMetric(int32_t curTime);
 
+    // modify events of a file already in the queue are coalesced into the queued one. Inotify events are not read
+    // while the queue holds max_inotify_event_queue_size events, they are kept by the kernel meanwhile.
     std::queue<Event*> mInotifyEventQueue;
     std::unordered_set<int64_t> mModifyEventSet;
+    bool mInotifyReadBlocked = false;
     ReadWriteLock mAccessMainThreadRWL;
     int32_t mCheckBaseDirInterval;
     int32_t mCheckSymbolicLinkInterval;
@@ -86,6 +89,9 @@ private:
     IntGaugePtr mRegisterdHandlersTotal;
     IntGaugePtr mActiveReadersTotal;
     IntGaugePtr mEnableFileIncludedByMultiConfigs;
+    CounterPtr mRawEventsTotal;
+    CounterPtr mCoalescedEventsTotal;
+    IntGaugePtr mPendingEventsTotal;
 
     std::atomic_int mLastReadEventTime{0};
     std::future<void> mThreadRes;
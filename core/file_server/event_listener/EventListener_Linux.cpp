@@ -18,6 +18,8 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <unordered_map>
+
 #include "common/ErrorUtil.h"
 #include "common/Flags.h"
 #include "file_server/EventDispatcher.h"
@@ -49,8 +51,9 @@ bool logtail::EventListener::RemoveWatch(int wd) {
     return inotify_rm_watch(mInotifyFd, wd) != -1;
 }
 
-int32_t logtail::EventListener::ReadEvents(std::vector<logtail::Event*>& eventVec) {
+int32_t logtail::EventListener::ReadEvents(std::vector<logtail::Event*>& eventVec, int32_t& coalescedCount) {
     eventVec.clear();
+    coalescedCount = 0;
     if (mInotifyFd < 0) {
         return 0;
     }
@@ -77,6 +80,8 @@ int32_t logtail::EventListener::ReadEvents(std::vector<logtail::Event*>& eventVe
     s_lastHalfEventSize = 0;
     if (BOOL_FLAG(fs_events_inotify_enable)) {
         static EventDispatcher* dispatcher = EventDispatcher::GetInstance();
+        // (wd, name) -> whether a pure modify event of the file is already in eventVec since its last other event
+        std::unordered_map<std::string, bool> modifiedFiles;
         int n = 0;
         struct inotify_event* event;
         while (n < len) {
@@ -112,10 +117,20 @@ int32_t logtail::EventListener::ReadEvents(std::vector<logtail::Event*>& eventVe
                 etype |= event->mask & IN_MOVED_FROM ? EVENT_MOVE_FROM : 0;
                 etype |= event->mask & IN_MOVED_TO ? EVENT_MOVE_TO : 0;
                 etype |= event->mask & IN_DELETE ? EVENT_DELETE : 0;
+                const char* name = event->len > 0 ? event->name : "";
+                if (etype != 0) {
+                    // coalesce modify events of the same file, the reader reads to the end anyway
+                    bool& modified = modifiedFiles[std::to_string(event->wd).append("/").append(name)];
+                    if (etype == EVENT_MODIFY && modified) {
+                        ++coalescedCount;
+                        n += sizeof(struct inotify_event) + event->len;
+                        continue;
+                    }
+                    modified = etype == EVENT_MODIFY;
+                }
                 std::string path;
                 if (etype != 0 && dispatcher->IsRegistered(event->wd, path))
-                    eventVec.push_back(
-                        new Event(path, event->len > 0 ? event->name : "", etype, event->wd, event->cookie));
+                    eventVec.push_back(new Event(path, name, etype, event->wd, event->cookie));
             }
             n += sizeof(struct inotify_event) + event->len;
         }
@@ -44,7 +44,9 @@ public:
     int AddWatch(const char* dir);
     bool RemoveWatch(int wd);
 
-    int32_t ReadEvents(std::vector<Event*>& eventVec);
+    // modify events of the same file in one read are coalesced into the first one, the number of coalesced events
+    // is returned in coalescedCount
+    int32_t ReadEvents(std::vector<Event*>& eventVec, int32_t& coalescedCount);
 
 private:
     EventListener() = default;
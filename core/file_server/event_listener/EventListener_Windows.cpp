@@ -44,7 +44,8 @@ bool EventListener::RemoveWatch(int wd) {
     return 0;
 }
 
-int32_t EventListener::ReadEvents(std::vector<Event*>& eventVec) {
+int32_t EventListener::ReadEvents(std::vector<Event*>& eventVec, int32_t& coalescedCount) {
+    coalescedCount = 0;
     return 0;
 }
 
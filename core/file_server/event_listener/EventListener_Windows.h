@@ -40,7 +40,7 @@ public:
     int AddWatch(const char* dir);
     bool RemoveWatch(int wd);
 
-    int32_t ReadEvents(std::vector<Event*>& eventVec);
+    int32_t ReadEvents(std::vector<Event*>& eventVec, int32_t& coalescedCount);
 
 private:
     EventListener() = default;
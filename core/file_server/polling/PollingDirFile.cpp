@@ -46,8 +46,14 @@ DEFINE_FLAG_INT32(dirfile_check_interval_ms, "dir file check interval, ms", 5000
 // Windows only supports polling, check more frequently.
 DEFINE_FLAG_INT32(dirfile_check_interval_ms, "dir file check interval, ms", 1000);
 #endif
-DEFINE_FLAG_INT32(dirfile_stat_count, "sleep when dir file stat count up to", 100);
-DEFINE_FLAG_INT32(dirfile_stat_sleep, "sleep time when dir file stat up to 1000, ms", 30);
+DEFINE_FLAG_INT32(dirfile_stat_count,
+                  "max dir file stat count of all polling threads in every dirfile_stat_sleep",
+                  100);
+DEFINE_FLAG_INT32(dirfile_stat_sleep, "window of dirfile_stat_count, ms", 30);
+DEFINE_FLAG_INT32(polling_dir_thread_count, "number of threads polling dirs in parallel, including polling thread", 4);
+DEFINE_FLAG_INT32(polling_dir_entries_cache_limit,
+                  "dirs with more entries than this are always listed again, 0 disables reusing listed entries",
+                  10000);
 DEFINE_FLAG_INT32(polling_dir_upperlimit, "try to remove unchanged dir if dir count is up to", 500000);
 DEFINE_FLAG_INT32(polling_file_upperlimit, "try to remove unchanged file if file count is up to", 500000);
 DEFINE_FLAG_INT32(polling_dir_timeout, "remove unchanged dir if modify time is older than time", 12 * 3600);
@@ -74,9 +80,46 @@ void PollingDirFile::Start() {
     mPollingFileCacheSize
         = FileServer::GetInstance()->GetMetricsRecordRef().CreateIntGauge(METRIC_RUNNER_FILE_POLLING_FILE_CACHE_SIZE);
     mRuningFlag = true;
+    StartScanWorkers();
     mThreadPtr = CreateThread([this]() { Polling(); });
 }
 
+void PollingDirFile::ClearCache(const std::vector<FileDiscoveryConfig>& configs) {
+    if (configs.empty()) {
+        return;
+    }
+    auto isMatched = [&configs](const string& path, const string& name) {
+        for (const auto& config : configs) {
+            if (config.first->IsMatch(path, name)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    ScopedSpinLock lock(mCacheLock);
+    mDirEntriesCacheMap.clear();
+    size_t dirCount = mDirCacheMap.size();
+    size_t fileCount = mFileCacheMap.size();
+    for (auto iter = mDirCacheMap.begin(); iter != mDirCacheMap.end();) {
+        if (isMatched(iter->first, "")) {
+            iter = mDirCacheMap.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    for (auto iter = mFileCacheMap.begin(); iter != mFileCacheMap.end();) {
+        size_t pos = iter->first.rfind(PATH_SEPARATOR[0]);
+        if (pos == string::npos || isMatched(iter->first.substr(0, pos), iter->first.substr(pos + 1))) {
+            iter = mFileCacheMap.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    LOG_INFO(sLogger,
+             ("clear polling cache, config count", configs.size())("cleared dir count", dirCount - mDirCacheMap.size())(
+                 "cleared file count", fileCount - mFileCacheMap.size()));
+}
+
 void PollingDirFile::Stop() {
     mRuningFlag = false;
     if (mThreadPtr != nullptr) {
@@ -86,6 +129,7 @@ void PollingDirFile::Stop() {
             LOG_ERROR(sLogger, ("stop polling dir file thread failed", ToString((int)mThreadPtr->GetState())));
         }
     }
+    StopScanWorkers();
     LOG_INFO(sLogger, ("PollingDirFile", "stop"));
 }
 
@@ -103,15 +147,14 @@ void PollingDirFile::Resume() {
     LOG_INFO(sLogger, ("polling discovery resume", "succeeded"));
 }
 
-void PollingDirFile::CheckConfigPollingStatCount(const int32_t lastStatCount,
-                                                 const FileDiscoveryConfig& config,
-                                                 bool isDockerConfig) {
-    auto diffCount = mStatCount - lastStatCount;
+void PollingDirFile::CheckConfigPollingStatCount(const PollingRoot& root) {
+    int32_t diffCount = root.mStatCount;
     if (diffCount <= INT32_FLAG(polling_max_stat_count_per_config))
         return;
 
+    const FileDiscoveryConfig& config = root.mConfig;
     std::string msgBase = "The polling stat count of this ";
-    if (isDockerConfig)
+    if (root.mIsDockerConfig)
         msgBase += "docker ";
     msgBase += "config has exceeded limit";
 
@@ -126,10 +169,12 @@ void PollingDirFile::CheckConfigPollingStatCount(const int32_t lastStatCount,
 
     LOG_WARNING(
         sLogger,
-        (msgBase, diffCount)(pathsStr, mStatCount)(config.second->GetProjectName(), config.second->GetLogstoreName()));
+        (msgBase, diffCount)(pathsStr, mStatCount.load())(config.second->GetProjectName(),
+                                                          config.second->GetLogstoreName()));
     AlarmManager::GetInstance()->SendAlarmError(STAT_LIMIT_ALARM,
                                                 msgBase + ", current count: " + ToString(diffCount)
-                                                    + " total count:" + ToString(mStatCount) + " paths: " + pathsStr,
+                                                    + " total count:" + ToString(mStatCount.load())
+                                                    + " paths: " + pathsStr,
                                                 config.second->GetRegion(),
                                                 config.second->GetProjectName(),
                                                 config.second->GetConfigName(),
@@ -169,6 +214,8 @@ void PollingDirFile::PollingIteration() {
         SET_GAUGE(mPollingFileCacheSize, mFileCacheMap.size());
     }
 
+    // Roots are submitted in order, their subtrees are scanned by all polling threads.
+    vector<shared_ptr<PollingRoot>> roots;
     // 处理所有精确路径（已按 basePath 深度排序）
     for (auto& pathItem : sortedPaths) {
         if (!mRuningFlag || mHoldOnFlag)
@@ -188,13 +235,15 @@ void PollingDirFile::PollingIteration() {
                 continue;
             }
 
-            int32_t lastConfigStatCount = mStatCount;
-            if (!PollingNormalConfigPath(pathItem.config, pathItem.path, string(), baseDirStat, 0)) {
-                LOG_DEBUG(
-                    sLogger,
-                    ("logPath in config not exist", pathItem.path)(ctx->GetProjectName(), ctx->GetLogstoreName()));
-            }
-            CheckConfigPollingStatCount(lastConfigStatCount, pathItem.config, false);
+            auto root = make_shared<PollingRoot>(pathItem.config, false);
+            roots.push_back(root);
+            RunOrSubmitScan([this, root, path = pathItem.path, baseDirStat]() {
+                if (!PollingNormalConfigPath(root, path, string(), baseDirStat, 0)) {
+                    LOG_DEBUG(sLogger,
+                              ("logPath in config not exist", path)(root->mConfig.second->GetProjectName(),
+                                                                    root->mConfig.second->GetLogstoreName()));
+                }
+            });
         } else {
             // 容器：使用 pathItem 中保存的索引直接访问对应的 realBaseDir
             const auto& containerInfos = config->GetContainerInfo();
@@ -217,13 +266,16 @@ void PollingDirFile::PollingIteration() {
                                                                                     ctx->GetLogstoreName()));
                         continue;
                     }
-                    int32_t lastConfigStatCount = mStatCount;
-                    if (!PollingNormalConfigPath(pathItem.config, realBaseDir, string(), baseDirStat, 0)) {
-                        LOG_DEBUG(sLogger,
-                                  ("docker logPath in config not exist", realBaseDir)(ctx->GetProjectName(),
-                                                                                      ctx->GetLogstoreName()));
-                    }
-                    CheckConfigPollingStatCount(lastConfigStatCount, pathItem.config, true);
+                    auto root = make_shared<PollingRoot>(pathItem.config, true);
+                    roots.push_back(root);
+                    RunOrSubmitScan([this, root, realBaseDir, baseDirStat]() {
+                        if (!PollingNormalConfigPath(root, realBaseDir, string(), baseDirStat, 0)) {
+                            LOG_DEBUG(sLogger,
+                                      ("docker logPath in config not exist",
+                                       realBaseDir)(root->mConfig.second->GetProjectName(),
+                                                    root->mConfig.second->GetLogstoreName()));
+                        }
+                    });
                 }
             }
         }
@@ -236,19 +288,22 @@ void PollingDirFile::PollingIteration() {
         if (mStatCount > INT32_FLAG(polling_max_stat_count))
             break;
 
-        const CollectionPipelineContext* ctx = pathItem.config.second;
         const FileDiscoveryOptions* config = pathItem.config.first;
+        const BasePathInfo* pathInfo = pathItem.pathInfo;
 
         if (!config->IsContainerDiscoveryEnabled()) {
             // 非容器：直接使用 basePath
-            int32_t lastConfigStatCount = mStatCount;
-            const string& startPath = pathItem.pathInfo->wildcardPaths[0];
-            if (!PollingWildcardConfigPath(pathItem.config, *pathItem.pathInfo, startPath, 0)) {
-                LOG_DEBUG(sLogger,
-                          ("can not find matched path in config, Wildcard begin logPath",
-                           startPath)(ctx->GetProjectName(), ctx->GetLogstoreName()));
-            }
-            CheckConfigPollingStatCount(lastConfigStatCount, pathItem.config, false);
+            auto root = make_shared<PollingRoot>(pathItem.config, false);
+            roots.push_back(root);
+            RunOrSubmitScan([this, root, pathInfo]() {
+                const string& startPath = pathInfo->wildcardPaths[0];
+                if (!PollingWildcardConfigPath(root, *pathInfo, startPath, 0)) {
+                    LOG_DEBUG(sLogger,
+                              ("can not find matched path in config, Wildcard begin logPath",
+                               startPath)(root->mConfig.second->GetProjectName(),
+                                          root->mConfig.second->GetLogstoreName()));
+                }
+            });
         } else {
             // 容器：使用 pathItem 中保存的索引直接访问对应的 realBaseDir
             const auto& containerInfos = config->GetContainerInfo();
@@ -264,17 +319,24 @@ void PollingDirFile::PollingIteration() {
                     if (realBaseDir.empty())
                         continue;
 
-                    int32_t lastConfigStatCount = mStatCount;
-                    if (!PollingWildcardConfigPath(pathItem.config, *pathItem.pathInfo, realBaseDir, 0)) {
-                        LOG_DEBUG(sLogger,
-                                  ("can not find matched path in config, Wildcard begin logPath ",
-                                   realBaseDir)(ctx->GetProjectName(), ctx->GetLogstoreName()));
-                    }
-                    CheckConfigPollingStatCount(lastConfigStatCount, pathItem.config, true);
+                    auto root = make_shared<PollingRoot>(pathItem.config, true);
+                    roots.push_back(root);
+                    RunOrSubmitScan([this, root, pathInfo, realBaseDir]() {
+                        if (!PollingWildcardConfigPath(root, *pathInfo, realBaseDir, 0)) {
+                            LOG_DEBUG(sLogger,
+                                      ("can not find matched path in config, Wildcard begin logPath ",
+                                       realBaseDir)(root->mConfig.second->GetProjectName(),
+                                                    root->mConfig.second->GetLogstoreName()));
+                        }
+                    });
                 }
             }
         }
     }
+    WaitForScans();
+    for (const auto& root : roots) {
+        CheckConfigPollingStatCount(*root);
+    }
 
     // Add collected new files to PollingModify.
     PollingModify::GetInstance()->AddNewFile(mNewFileVec);
@@ -338,56 +400,65 @@ bool PollingDirFile::CheckAndUpdateFileMatchCache(const string& fileDir,
 
     bool newFlag = false;
     string filePath = PathJoin(fileDir, fileName);
-    FileCheckCacheMap::iterator iter = mFileCacheMap.find(filePath);
     int32_t curTime = time(NULL);
-    if (iter == mFileCacheMap.end()) {
-        bool matchFlag = needFindBestMatch
-            ? ConfigManager::GetInstance()->FindBestMatch(fileDir, fileName).first != nullptr
-            : true;
-
-        DirFileCache& fileCache = mFileCacheMap[filePath];
-        fileCache.SetConfigMatched(matchFlag);
-        fileCache.SetExceedPreservedDirDepth(exceedPreservedDirDepth);
-        fileCache.SetCheckRound(mCurrentRound);
-        fileCache.SetLastModifyTime(modifyTime);
-
-        // Files found at round 1 or too old are considered as old data.
-        if (mCurrentRound == 1 || curTime - sec > INT32_FLAG(polling_file_first_watch_timeout)) {
-            newFlag = false;
-        } else {
-            newFlag = true;
-            fileCache.SetLastEventTime(curTime);
-        }
-        fileCache.SetEventFlag(newFlag);
-        return matchFlag && newFlag;
-    }
-
-    // If the file is not overtime, repush it to PollingModify thread regularly (by default, 10s).
-    // Mainly for case that file is deleted and recreated after a while.
-    // In detail, it can avoid data missing when following things happen:
-    // 1. File is created, and PollingDirFile add it to cache and push it to PollingModify.
-    // 2. File is deleted, PollingModify removes it.
-    // 3. File is recreated, because PollingDirFile already caches it, new flag will
-    //    not be set.
-    // 4. Now, PollingModify will not generate MODIFY event for the file because the file
-    //    is not existing in polling file list. **We lose the file**.
-    if ((curTime - sec < INT32_FLAG(polling_file_first_watch_timeout))
-        && (!iter->second.HasEventFlag()
-            || (curTime - iter->second.GetLastEventTime() >= INT32_FLAG(polling_modify_repush_interval)))) {
+    {
+        ScopedSpinLock lock(mCacheLock);
+        FileCheckCacheMap::iterator iter = mFileCacheMap.find(filePath);
+        if (iter != mFileCacheMap.end()) {
+            // If the file is not overtime, repush it to PollingModify thread regularly (by default, 10s).
+            // Mainly for case that file is deleted and recreated after a while.
+            // In detail, it can avoid data missing when following things happen:
+            // 1. File is created, and PollingDirFile add it to cache and push it to PollingModify.
+            // 2. File is deleted, PollingModify removes it.
+            // 3. File is recreated, because PollingDirFile already caches it, new flag will
+            //    not be set.
+            // 4. Now, PollingModify will not generate MODIFY event for the file because the file
+            //    is not existing in polling file list. **We lose the file**.
+            if ((curTime - sec < INT32_FLAG(polling_file_first_watch_timeout))
+                && (!iter->second.HasEventFlag()
+                    || (curTime - iter->second.GetLastEventTime() >= INT32_FLAG(polling_modify_repush_interval)))) {
+                newFlag = true;
+                iter->second.SetEventFlag(newFlag);
+                iter->second.SetLastEventTime(curTime);
+            }
+            iter->second.SetCheckRound(mCurrentRound);
+            iter->second.SetLastModifyTime(modifyTime);
+            return iter->second.HasMatchedConfig() && newFlag;
+        }
+    }
+
+    // only symbolic links need it, and only when the file is first found. It is called out of the lock, so that the
+    // scans of other directories are not blocked meanwhile.
+    bool matchFlag
+        = needFindBestMatch ? ConfigManager::GetInstance()->FindBestMatch(fileDir, fileName).first != nullptr : true;
+    ScopedSpinLock lock(mCacheLock);
+    if (mFileCacheMap.find(filePath) != mFileCacheMap.end()) {
+        // found by another scan meanwhile, which has handled it
+        return false;
+    }
+    DirFileCache& fileCache = mFileCacheMap[filePath];
+    fileCache.SetConfigMatched(matchFlag);
+    fileCache.SetExceedPreservedDirDepth(exceedPreservedDirDepth);
+    fileCache.SetCheckRound(mCurrentRound);
+    fileCache.SetLastModifyTime(modifyTime);
+
+    // Files found at round 1 or too old are considered as old data.
+    if (mCurrentRound == 1 || curTime - sec > INT32_FLAG(polling_file_first_watch_timeout)) {
+        newFlag = false;
+    } else {
         newFlag = true;
-        iter->second.SetEventFlag(newFlag);
-        iter->second.SetLastEventTime(curTime);
+        fileCache.SetLastEventTime(curTime);
     }
-    iter->second.SetCheckRound(mCurrentRound);
-    iter->second.SetLastModifyTime(modifyTime);
-    return iter->second.HasMatchedConfig() && newFlag;
+    fileCache.SetEventFlag(newFlag);
+    return matchFlag && newFlag;
 }
 
-bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
+bool PollingDirFile::PollingNormalConfigPath(const shared_ptr<PollingRoot>& root,
                                              const string& srcPath,
                                              const string& obj,
                                              const fsutil::PathStat& statBuf,
                                              int depth) {
+    const FileDiscoveryConfig& pConfig = root->mConfig;
     if (pConfig.first->mMaxDirSearchDepth >= 0 && depth > pConfig.first->mMaxDirSearchDepth) {
         return false;
     }
@@ -436,24 +507,24 @@ bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
         }
         return true;
     }
+    auto entries = ListDirEntries(dir, dirPath, &statBuf);
     int32_t nowStatCount = 0;
-    fsutil::Entry ent;
-    while ((ent = dir.ReadNext(false))) {
+    for (const auto& ent : *entries) {
         if (!mRuningFlag || mHoldOnFlag)
             break;
 
-        if (++mStatCount % INT32_FLAG(dirfile_stat_count) == 0) {
-            usleep(INT32_FLAG(dirfile_stat_sleep) * 1000);
-        }
+        WaitForStatQuota();
+        ++mStatCount;
+        ++root->mStatCount;
 
         if (mStatCount > INT32_FLAG(polling_max_stat_count)) {
             LOG_WARNING(sLogger,
-                        ("total dir's polling stat count is exceeded", nowStatCount)(dirPath, mStatCount)(
+                        ("total dir's polling stat count is exceeded", nowStatCount)(dirPath, mStatCount.load())(
                             pConfig.second->GetProjectName(), pConfig.second->GetLogstoreName()));
             AlarmManager::GetInstance()->SendAlarmError(
                 STAT_LIMIT_ALARM,
                 string("total dir's polling stat count is exceeded, now count:") + ToString(nowStatCount)
-                    + " total count:" + ToString(mStatCount) + " path: " + dirPath
+                    + " total count:" + ToString(mStatCount.load()) + " path: " + dirPath
                     + " project:" + pConfig.second->GetProjectName() + " logstore:" + pConfig.second->GetLogstoreName(),
                 pConfig.second->GetRegion(),
                 pConfig.second->GetProjectName(),
@@ -464,12 +535,12 @@ bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
 
         if (++nowStatCount > INT32_FLAG(polling_max_stat_count_per_dir)) {
             LOG_WARNING(sLogger,
-                        ("this dir's polling stat count is exceeded", nowStatCount)(dirPath, mStatCount)(
+                        ("this dir's polling stat count is exceeded", nowStatCount)(dirPath, mStatCount.load())(
                             pConfig.second->GetProjectName(), pConfig.second->GetLogstoreName()));
             AlarmManager::GetInstance()->SendAlarmError(
                 STAT_LIMIT_ALARM,
                 string("this dir's polling stat count is exceeded, now count:") + ToString(nowStatCount)
-                    + " total count:" + ToString(mStatCount) + " path: " + dirPath
+                    + " total count:" + ToString(mStatCount.load()) + " path: " + dirPath
                     + " project:" + pConfig.second->GetProjectName() + " logstore:" + pConfig.second->GetLogstoreName(),
                 pConfig.second->GetRegion(),
                 pConfig.second->GetProjectName(),
@@ -510,7 +581,7 @@ bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
 
         // Mainly for symbolic (Linux), we need to use stat to dig out the real type.
         fsutil::PathStat buf;
-        if (!fsutil::PathStat::stat(item, buf)) {
+        if (!fsutil::PathStat::statAt(dir.GetFd(), dirPath, entName, buf)) {
             LOG_DEBUG(sLogger, ("get file info error", item.c_str())("errno", errno));
             continue;
         }
@@ -521,10 +592,13 @@ bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
         // We should check file type again to make sure that the original file which linked by
         // a symbolic file is DIR or REG.
         if (buf.IsDir() && (!needCheckDirMatch || !pConfig.first->IsDirectoryInBlacklist(item))) {
-            PollingNormalConfigPath(pConfig, dirPath, entName, buf, depth + 1);
+            RunOrSubmitScan([this, root, dirPath, entName, buf, depth]() {
+                PollingNormalConfigPath(root, dirPath, entName, buf, depth + 1);
+            });
         } else if (buf.IsRegFile()) {
             if (CheckAndUpdateFileMatchCache(dirPath, entName, buf, needFindBestMatch, exceedPreservedDirDepth)) {
                 LOG_DEBUG(sLogger, ("add to modify event", entName)("round", mCurrentRound));
+                lock_guard<mutex> lock(mNewFileMux);
                 mNewFileVec.push_back(SplitedFilePath(dirPath, entName));
             }
         } else {
@@ -540,10 +614,11 @@ bool PollingDirFile::PollingNormalConfigPath(const FileDiscoveryConfig& pConfig,
 // PollingWildcardConfigPath will iterate wildcardPaths one by one, and according to
 // corresponding value in constWildcardPaths, call PollingNormalConfigPath or call
 // PollingWildcardConfigPath recursively.
-bool PollingDirFile::PollingWildcardConfigPath(const FileDiscoveryConfig& pConfig,
+bool PollingDirFile::PollingWildcardConfigPath(const shared_ptr<PollingRoot>& root,
                                                const BasePathInfo& pathInfo,
                                                const string& dirPath,
                                                int depth) {
+    const FileDiscoveryConfig& pConfig = root->mConfig;
     if (AppConfig::GetInstance()->IsHostPathMatchBlacklist(dirPath)) {
         LOG_INFO(sLogger, ("ignore path matching host path blacklist", dirPath));
         return false;
@@ -586,9 +661,9 @@ bool PollingDirFile::PollingWildcardConfigPath(const FileDiscoveryConfig& pConfi
         // call PollingNormalConfigPath to iterate remaining content.
         // Otherwise, call PollingWildcardConfigPath to deal with remaining parts.
         if (finish) {
-            PollingNormalConfigPath(pConfig, item, string(), baseDirStat, 0);
+            PollingNormalConfigPath(root, item, string(), baseDirStat, 0);
         } else {
-            PollingWildcardConfigPath(pConfig, pathInfo, item, depth + 1);
+            PollingWildcardConfigPath(root, pathInfo, item, depth + 1);
         }
         return true;
     }
@@ -613,9 +688,11 @@ bool PollingDirFile::PollingWildcardConfigPath(const FileDiscoveryConfig& pConfi
         }
         return true;
     }
-    fsutil::Entry ent;
+    fsutil::PathStat dirStat;
+    bool hasDirStat = dir.GetFd() >= 0 && fsutil::PathStat::fstat(dir.GetFd(), dirStat, false);
+    auto entries = ListDirEntries(dir, dirPath, hasDirStat ? &dirStat : nullptr);
     int32_t dirCount = 0;
-    while ((ent = dir.ReadNext(false))) {
+    for (const auto& ent : *entries) {
         if (!mRuningFlag || mHoldOnFlag)
             break;
 
@@ -634,16 +711,17 @@ bool PollingDirFile::PollingWildcardConfigPath(const FileDiscoveryConfig& pConfi
             break;
         }
 
-        if (++mStatCount % INT32_FLAG(dirfile_stat_count) == 0)
-            usleep(INT32_FLAG(dirfile_stat_sleep) * 1000);
+        WaitForStatQuota();
+        ++mStatCount;
+        ++root->mStatCount;
 
         if (mStatCount > INT32_FLAG(polling_max_stat_count)) {
             LOG_WARNING(sLogger,
-                        ("total dir's polling stat count is exceeded",
-                         "")(dirPath, mStatCount)(pConfig.second->GetProjectName(), pConfig.second->GetLogstoreName()));
+                        ("total dir's polling stat count is exceeded", "")(dirPath, mStatCount.load())(
+                            pConfig.second->GetProjectName(), pConfig.second->GetLogstoreName()));
             AlarmManager::GetInstance()->SendAlarmError(
                 STAT_LIMIT_ALARM,
-                string("total dir's polling stat count is exceeded, total count:" + ToString(mStatCount)
+                string("total dir's polling stat count is exceeded, total count:" + ToString(mStatCount.load())
                        + " path: " + dirPath + " project:" + pConfig.second->GetProjectName()
                        + " logstore:" + pConfig.second->GetLogstoreName()),
                 pConfig.second->GetRegion(),
@@ -656,7 +734,7 @@ bool PollingDirFile::PollingWildcardConfigPath(const FileDiscoveryConfig& pConfi
         auto entName = ent.Name();
         string item = PathJoin(dirPath, entName);
         fsutil::PathStat buf;
-        if (!fsutil::PathStat::stat(item, buf)) {
+        if (!fsutil::PathStat::statAt(dir.GetFd(), dirPath, entName, buf)) {
             LOG_WARNING(sLogger, ("get file info fail", item.c_str())("errno", GetErrno()));
             continue;
         }
@@ -680,11 +758,15 @@ bool PollingDirFile::PollingWildcardConfigPath(const FileDiscoveryConfig& pConfi
                 }
             }
             if (fnmatch(&(pathInfo.wildcardPaths[depth + 1].at(dirIndex)), entName.c_str(), FNM_PATHNAME) == 0) {
+                // the result of a subtree scanned by another thread is unknown, it is only used for logging
+                hasMatchFlag = true;
                 if (finish) {
-                    hasMatchFlag = true;
-                    PollingNormalConfigPath(pConfig, item, string(), buf, 0);
+                    RunOrSubmitScan(
+                        [this, root, item, buf]() { PollingNormalConfigPath(root, item, string(), buf, 0); });
                 } else {
-                    hasMatchFlag |= PollingWildcardConfigPath(pConfig, pathInfo, item, depth + 1);
+                    RunOrSubmitScan([this, root, &pathInfo, item, depth]() {
+                        PollingWildcardConfigPath(root, pathInfo, item, depth + 1);
+                    });
                 }
             }
         }
@@ -791,6 +873,13 @@ void PollingDirFile::ClearUnavailableFileAndDir() {
                 ++iter;
         }
 
+        for (auto iter = mDirEntriesCacheMap.begin(); iter != mDirEntriesCacheMap.end();) {
+            if (mCurrentRound - iter->second.mLastCheckRound > (uint64_t)INT32_FLAG(delete_dir_file_round)) {
+                iter = mDirEntriesCacheMap.erase(iter);
+            } else
+                ++iter;
+        }
+
         // Files need not to generate delete event, it is PollingModify's responsibility.
         for (auto iter = mFileCacheMap.begin(); iter != mFileCacheMap.end();) {
             if (mCurrentRound - iter->second.GetLastCheckRound() > (uint64_t)INT32_FLAG(delete_dir_file_round)) {
@@ -804,6 +893,141 @@ void PollingDirFile::ClearUnavailableFileAndDir() {
         PollingEventQueue::GetInstance()->PushEvent(eventVec);
 }
 
+void PollingDirFile::StartScanWorkers() {
+    lock_guard<mutex> lock(mScanTaskMux);
+    mScanWorkerStop = false;
+    for (int32_t i = 1; i < INT32_FLAG(polling_dir_thread_count); ++i) {
+        mScanWorkers.emplace_back([this]() { ScanWorkerLoop(); });
+    }
+}
+
+void PollingDirFile::StopScanWorkers() {
+    vector<thread> workers;
+    {
+        lock_guard<mutex> lock(mScanTaskMux);
+        mScanWorkerStop = true;
+        workers.swap(mScanWorkers);
+    }
+    mScanTaskCV.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void PollingDirFile::ScanWorkerLoop() {
+    unique_lock<mutex> lock(mScanTaskMux);
+    while (true) {
+        mScanTaskCV.wait(lock, [this]() { return mScanWorkerStop || !mScanTasks.empty(); });
+        if (mScanWorkerStop) {
+            return;
+        }
+        auto task = std::move(mScanTasks.front());
+        mScanTasks.pop_front();
+        ++mRunningScanCount;
+        lock.unlock();
+        task();
+        lock.lock();
+        --mRunningScanCount;
+        mScanDoneCV.notify_all();
+    }
+}
+
+void PollingDirFile::RunOrSubmitScan(function<void()>&& task) {
+    {
+        lock_guard<mutex> lock(mScanTaskMux);
+        // at most one queued task per worker, so that the queue is bounded and stays short
+        if (!mScanWorkerStop && mScanTasks.size() < mScanWorkers.size()) {
+            mScanTasks.emplace_back(std::move(task));
+            mScanTaskCV.notify_one();
+            return;
+        }
+    }
+    task();
+}
+
+void PollingDirFile::WaitForScans() {
+    unique_lock<mutex> lock(mScanTaskMux);
+    while (true) {
+        if (!mScanTasks.empty()) {
+            auto task = std::move(mScanTasks.front());
+            mScanTasks.pop_front();
+            ++mRunningScanCount;
+            lock.unlock();
+            task();
+            lock.lock();
+            --mRunningScanCount;
+            continue;
+        }
+        if (mRunningScanCount == 0) {
+            return;
+        }
+        mScanDoneCV.wait(lock);
+    }
+}
+
+void PollingDirFile::WaitForStatQuota() {
+    unique_lock<mutex> lock(mStatQuotaMux);
+    auto now = chrono::steady_clock::now();
+    if (now >= mStatQuotaWindowEnd) {
+        mStatQuotaCount = 0;
+        mStatQuotaWindowEnd = now + chrono::milliseconds(INT32_FLAG(dirfile_stat_sleep));
+    }
+    while (mStatQuotaCount >= INT32_FLAG(dirfile_stat_count)) {
+        auto windowEnd = mStatQuotaWindowEnd;
+        lock.unlock();
+        this_thread::sleep_until(windowEnd);
+        lock.lock();
+        now = chrono::steady_clock::now();
+        if (now >= mStatQuotaWindowEnd) {
+            mStatQuotaCount = 0;
+            mStatQuotaWindowEnd = now + chrono::milliseconds(INT32_FLAG(dirfile_stat_sleep));
+        }
+    }
+    ++mStatQuotaCount;
+}
+
+// The mtime of a directory changes when an entry is added, removed or renamed, so the entries listed in previous
+// round are still valid if it is unchanged. Entries listed in the same second as the last change are not reused,
+// since filesystems with coarse timestamps may not update the mtime for changes within that second.
+shared_ptr<const vector<fsutil::Entry>>
+PollingDirFile::ListDirEntries(fsutil::Dir& dir, const string& dirPath, const fsutil::PathStat* statBuf) {
+    int64_t modifyTime = -1;
+    int64_t sec = 0;
+    if (statBuf != nullptr && INT32_FLAG(polling_dir_entries_cache_limit) > 0) {
+        int64_t nsec = 0;
+        statBuf->GetLastWriteTime(sec, nsec);
+        modifyTime = NANO_CONVERTING * sec + nsec;
+        ScopedSpinLock lock(mCacheLock);
+        auto iter = mDirEntriesCacheMap.find(dirPath);
+        if (iter != mDirEntriesCacheMap.end()) {
+            if (iter->second.mModifyTime == modifyTime) {
+                iter->second.mLastCheckRound = mCurrentRound;
+                return iter->second.mEntries;
+            }
+            mDirEntriesCacheMap.erase(iter);
+        }
+    }
+
+    // entries beyond the per dir limit are never visited
+    auto entries = make_shared<vector<fsutil::Entry>>();
+    size_t maxCount = static_cast<size_t>(INT32_FLAG(polling_max_stat_count_per_dir)) + 1;
+    fsutil::Entry ent;
+    while (entries->size() < maxCount && (ent = dir.ReadNext(false))) {
+        entries->push_back(std::move(ent));
+    }
+    if (modifyTime >= 0 && entries->size() <= static_cast<size_t>(INT32_FLAG(polling_dir_entries_cache_limit))
+        && time(nullptr) - sec >= 2) {
+        ScopedSpinLock lock(mCacheLock);
+        auto& cache = mDirEntriesCacheMap[dirPath];
+        cache.mModifyTime = modifyTime;
+        cache.mLastCheckRound = mCurrentRound;
+        cache.mEntries = entries;
+    }
+    return entries;
+}
+
 PollingDirFile::PollingDirFile() {
     mStatCount = 0;
     mCurrentRound = 0;
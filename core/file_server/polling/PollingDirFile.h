@@ -15,8 +15,17 @@
  */
 
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 
+#include "common/FileSystemUtil.h"
 #include "common/Lock.h"
 #include "common/LogRunnable.h"
 #include "common/Thread.h"
@@ -26,10 +35,6 @@
 
 namespace logtail {
 
-namespace fsutil {
-class PathStat;
-}
-
 class PollingDirFile : public LogRunnable {
 public:
     static PollingDirFile* GetInstance() {
@@ -48,18 +53,57 @@ public:
     void ClearCache() {
         mDirCacheMap.clear();
         mFileCacheMap.clear();
+        mDirEntriesCacheMap.clear();
         mStatCount = 0;
         mNewFileVec.clear();
         mCurrentRound = 0;
     }
+    // ClearCache clears cache items matched by @configs only, other items keep their status.
+    // It is called with both old and new configs when only some configs have been updated.
+    void ClearCache(const std::vector<FileDiscoveryConfig>& configs);
 
 private:
+    // A base directory to poll in current round, shared by the tasks scanning its subtrees.
+    struct PollingRoot {
+        PollingRoot(const FileDiscoveryConfig& config, bool isDockerConfig)
+            : mConfig(config), mIsDockerConfig(isDockerConfig) {}
+
+        FileDiscoveryConfig mConfig;
+        bool mIsDockerConfig;
+        std::atomic_int32_t mStatCount{0};
+    };
+
+    // Entries of a directory listed in previous round, reused while the mtime of the directory is unchanged.
+    struct DirEntriesCache {
+        int64_t mModifyTime = 0;
+        uint64_t mLastCheckRound = 0;
+        std::shared_ptr<const std::vector<fsutil::Entry>> mEntries;
+    };
+
     PollingDirFile();
     ~PollingDirFile();
 
     void Polling();
     void PollingIteration();
 
+    // Subtrees are scanned by polling_dir_thread_count threads, including the polling thread.
+    void StartScanWorkers();
+    void StopScanWorkers();
+    void ScanWorkerLoop();
+    // RunOrSubmitScan hands @task to an idle worker, or runs it in the calling thread if all workers are busy.
+    void RunOrSubmitScan(std::function<void()>&& task);
+    // WaitForScans runs queued tasks in the calling thread until all submitted tasks are done.
+    void WaitForScans();
+
+    // WaitForStatQuota blocks until a stat is allowed, at most dirfile_stat_count stats are done by all
+    // threads in every dirfile_stat_sleep ms.
+    void WaitForStatQuota();
+
+    // ListDirEntries lists the entries of @dir, which is opened. The entries listed in previous round are reused
+    // if the mtime of the directory in @statBuf is unchanged, @statBuf can be null if it is unknown.
+    std::shared_ptr<const std::vector<fsutil::Entry>>
+    ListDirEntries(fsutil::Dir& dir, const std::string& dirPath, const fsutil::PathStat* statBuf);
+
     // PollingNormalConfigPath polls config with normal base path recursively.
     // @config: config to poll.
     // @srcPath+@obj: directory path to poll, for base directory, @obj is empty.
@@ -67,7 +111,7 @@ private:
     // @depth: the depth of current level, used to detect max depth.
     // @return: it is used only by first call, returns true if poll successfully or
     //   error can be handled, otherwise false is returned.
-    bool PollingNormalConfigPath(const FileDiscoveryConfig& config,
+    bool PollingNormalConfigPath(const std::shared_ptr<PollingRoot>& root,
                                  const std::string& srcPath,
                                  const std::string& obj,
                                  const fsutil::PathStat& statBuf,
@@ -76,7 +120,7 @@ private:
     // PollingWildcardConfigPath polls config with wildcard base path recursively.
     // It will use PollingNormalConfigPath to poll if the path becomes normal.
     // @return true if at least one directory was found during polling.
-    bool PollingWildcardConfigPath(const FileDiscoveryConfig& pConfig,
+    bool PollingWildcardConfigPath(const std::shared_ptr<PollingRoot>& root,
                                    const BasePathInfo& pathInfo,
                                    const std::string& dirPath,
                                    int depth);
@@ -113,10 +157,9 @@ private:
     // By default, it will be called every 600s (flag polling_check_timeout_interval).
     void ClearTimeoutFileAndDir();
 
-    // CheckConfigPollingStatCount checks if the stat count of @config exceeds limit.
+    // CheckConfigPollingStatCount checks if the stat count of @root exceeds limit.
     // If true, logs and alarms.
-    void
-    CheckConfigPollingStatCount(const int32_t lastStatCount, const FileDiscoveryConfig& config, bool isDockerConfig);
+    void CheckConfigPollingStatCount(const PollingRoot& root);
 
 private:
     PTMutex mPollingThreadLock;
@@ -136,10 +179,26 @@ private:
     DirCheckCacheMap mDirCacheMap;
     FileCheckCacheMap mFileCacheMap;
 
+    // Listed entries of directories, protected by mCacheLock.
+    std::unordered_map<std::string, DirEntriesCache> mDirEntriesCacheMap;
+
     // Record how much times stat is called, if it exceeds limit, stop polling.
-    int32_t mStatCount;
+    std::atomic_int32_t mStatCount;
     // Record new files found in current round, will be pushed to PollingModify.
+    std::mutex mNewFileMux;
     std::vector<SplitedFilePath> mNewFileVec;
+
+    std::vector<std::thread> mScanWorkers;
+    std::mutex mScanTaskMux;
+    std::condition_variable mScanTaskCV;
+    std::condition_variable mScanDoneCV;
+    std::deque<std::function<void()>> mScanTasks;
+    size_t mRunningScanCount = 0;
+    bool mScanWorkerStop = false;
+
+    std::mutex mStatQuotaMux;
+    int32_t mStatQuotaCount = 0;
+    std::chrono::steady_clock::time_point mStatQuotaWindowEnd;
     // The sequence number of current round, uint64_t is used to avoid overflow.
     uint64_t mCurrentRound;
 
@@ -0,0 +1,151 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/reader/FileReadAheadManager.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include "common/Flags.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_BOOL(enable_file_read_ahead,
+                 "read ahead the next chunk of files with more data through io_uring, linux 5.6+ only",
+                 false);
+DEFINE_FLAG_INT32(file_read_ahead_max_inflight, "max number of file read ahead requests in flight", 32);
+
+using namespace std;
+
+namespace logtail {
+
+FileReadAhead::~FileReadAhead() {
+    if (mFd >= 0) {
+        close(mFd);
+    }
+}
+
+FileReadAheadManager::~FileReadAheadManager() {
+    lock_guard<mutex> lock(mMux);
+    // buffers must outlive the reads in flight
+    while (!mInflightMap.empty() && mRing.Submit(1) >= 0) {
+        reapCompletions();
+    }
+    mRing.Close();
+}
+
+bool FileReadAheadManager::IsEnabled() {
+    if (!BOOL_FLAG(enable_file_read_ahead)) {
+        return false;
+    }
+    lock_guard<mutex> lock(mMux);
+    if (!mInited) {
+        mInited = true;
+        uint32_t entries = static_cast<uint32_t>(max(INT32_FLAG(file_read_ahead_max_inflight), 1));
+        if (mRing.Init(entries)) {
+            LOG_INFO(sLogger, ("file read ahead", "enabled")("io_uring entries", mRing.GetEntries()));
+        } else {
+            LOG_WARNING(sLogger, ("file read ahead", "disabled, io_uring is unavailable")("errno", errno));
+        }
+    }
+    return mRing.IsInitialized();
+}
+
+shared_ptr<FileReadAhead> FileReadAheadManager::Submit(int fd, int64_t offset, size_t size) {
+    if (!IsEnabled() || fd < 0 || size == 0) {
+        return nullptr;
+    }
+    lock_guard<mutex> lock(mMux);
+    // completions are reaped by the waiting thread if any
+    if (!mWaiting) {
+        reapCompletions();
+    }
+    // the ring is sized by the flag on first use
+    size_t maxInflight = min(static_cast<size_t>(INT32_FLAG(file_read_ahead_max_inflight)),
+                             static_cast<size_t>(mRing.GetEntries()));
+    if (mInflightMap.size() >= maxInflight) {
+        return nullptr;
+    }
+    auto readAhead = make_shared<FileReadAhead>(offset, size);
+    readAhead->mFd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (readAhead->mFd < 0) {
+        return nullptr;
+    }
+    uint64_t id = ++mNextId;
+    if (!mRing.PrepareRead(readAhead->mFd, readAhead->mBuffer.get(), static_cast<uint32_t>(size), offset, id)) {
+        return nullptr;
+    }
+    // the read stays queued if it cannot be submitted now (e.g. EAGAIN), and is submitted along with the next one,
+    // which is safe since it reads the duplicated fd
+    mRing.Submit();
+    mInflightMap.emplace(id, readAhead);
+    return readAhead;
+}
+
+int32_t FileReadAheadManager::Wait(FileReadAhead& readAhead) {
+    unique_lock<mutex> lock(mMux);
+    while (!readAhead.mDone) {
+        if (mWaiting) {
+            mCond.wait(lock);
+            continue;
+        }
+        reapCompletions();
+        if (readAhead.mDone) {
+            break;
+        }
+        if (mRing.GetPendingCount() > 0 && mRing.Submit() <= 0) {
+            // the read is kept in flight, since the kernel may still write into its buffer once submitted later
+            return -EIO;
+        }
+        // other readers can submit meanwhile, their completions are reaped by this thread
+        mWaiting = true;
+        lock.unlock();
+        int ret = mRing.WaitCompletions(1);
+        lock.lock();
+        mWaiting = false;
+        reapCompletions();
+        mCond.notify_all();
+        if (ret < 0 && !readAhead.mDone) {
+            return -EIO;
+        }
+    }
+    return readAhead.mResult;
+}
+
+size_t FileReadAheadManager::GetInflightCount() {
+    lock_guard<mutex> lock(mMux);
+    if (!mWaiting) {
+        reapCompletions();
+    }
+    return mInflightMap.size();
+}
+
+void FileReadAheadManager::reapCompletions() {
+    uint64_t id = 0;
+    int32_t result = 0;
+    while (mRing.PopCompletion(id, result)) {
+        auto iter = mInflightMap.find(id);
+        if (iter == mInflightMap.end()) {
+            continue;
+        }
+        iter->second->mResult = result;
+        iter->second->mDone = true;
+        close(iter->second->mFd);
+        iter->second->mFd = -1;
+        mInflightMap.erase(iter);
+    }
+}
+
+} // namespace logtail
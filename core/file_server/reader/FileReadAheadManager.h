@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/IoUring.h"
+
+namespace logtail {
+
+// A read of the next chunk of a file, issued before the reader asks for it.
+struct FileReadAhead {
+    FileReadAhead(int64_t offset, size_t size) : mOffset(offset), mSize(size), mBuffer(new char[size]) {}
+    ~FileReadAhead();
+
+    // duplicate of the file fd held until the read completes, so that the fd number of the read cannot be reused by
+    // another file or socket after the reader closes its file while the read is still queued or in flight
+    int mFd = -1;
+    int64_t mOffset;
+    size_t mSize;
+    std::unique_ptr<char[]> mBuffer;
+    // bytes read or -errno, valid when mDone is true
+    int32_t mResult = 0;
+    bool mDone = false;
+};
+
+// Reads ahead the next chunk of files that have more data through one io_uring, so that the reads of many files are
+// in flight together and overlap with the reader thread handling other files, instead of each blocking the thread
+// in pread when the file is read. Disabled (and readers use pread only) if enable_file_read_ahead is off or io_uring
+// is unavailable.
+class FileReadAheadManager {
+public:
+    FileReadAheadManager(const FileReadAheadManager&) = delete;
+    FileReadAheadManager& operator=(const FileReadAheadManager&) = delete;
+
+    static FileReadAheadManager* GetInstance() {
+        static FileReadAheadManager instance;
+        return &instance;
+    }
+
+    bool IsEnabled();
+    // Returns null if disabled or too many reads are in flight.
+    std::shared_ptr<FileReadAhead> Submit(int fd, int64_t offset, size_t size);
+    // Waits for @readAhead to complete and returns its result.
+    int32_t Wait(FileReadAhead& readAhead);
+
+    size_t GetInflightCount();
+
+private:
+    FileReadAheadManager() = default;
+    ~FileReadAheadManager();
+
+    // pops all completions available, must hold mMux and no thread is waiting in the ring
+    void reapCompletions();
+
+    std::mutex mMux;
+    // only one thread waits for completions in the ring, others wait for it to reap on mCond
+    std::condition_variable mCond;
+    bool mWaiting = false;
+    bool mInited = false;
+    IoUring mRing;
+    uint64_t mNextId = 0;
+    // requests are kept until completed, even if the reader drops them, since the kernel writes into their buffers
+    std::unordered_map<uint64_t, std::shared_ptr<FileReadAhead>> mInflightMap;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FileReadAheadManagerUnittest;
+#endif
+};
+
+} // namespace logtail
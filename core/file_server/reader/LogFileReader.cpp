@@ -48,6 +48,7 @@
 #include "common/TimeUtil.h"
 #include "common/UUIDUtil.h"
 #include "constants/Constants.h"
+#include "container_manager/ContainerManager.h"
 #include "file_server/ConfigManager.h"
 #include "file_server/FileServer.h"
 #include "file_server/checkpoint/CheckPointManager.h"
@@ -1003,6 +1004,10 @@ bool LogFileReader::ReadLog(LogBuffer& logBuffer, const Event* event) {
             }
             logBuffer.exactlyOnceCheckpoint = mEOOption->selectedCheckpoint;
         }
+        if (!mContainerFirstReadReported && !mContainerID.empty()) {
+            ContainerManager::GetInstance()->OnContainerFirstRead(mContainerID);
+            mContainerFirstReadReported = true;
+        }
     }
     if (!tryRollback && !moreData) {
         // For the scenario: log rotation, the last line needs to be read by timeout, which is a normal situation.
@@ -1024,6 +1029,9 @@ bool LogFileReader::ReadLog(LogBuffer& logBuffer, const Event* event) {
         BlockedEventManager::GetInstance()->UpdateBlockEvent(
             GetQueueKey(), GetConfigName(), *event, mDevInode, time(NULL) + mReaderConfig.first->mFlushTimeoutSecs);
     }
+    if (moreData) {
+        submitReadAhead();
+    }
     logBuffer.rawBuffer = Trim(logBuffer.rawBuffer, kNullSv);
     return moreData;
 }
@@ -1251,6 +1259,7 @@ void LogFileReader::CloseFilePtr(bool& isDeleted) {
             }
         }
 
+        mReadAhead.reset();
         if (mLogFileOp.Close() != 0) {
             int fd = mLogFileOp.GetFd();
             LOG_WARNING(
@@ -1894,20 +1903,60 @@ LogFileReader::ReadFile(LogFileOperator& op, void* buf, size_t size, int64_t& of
         return 0;
     }
 
+    size_t readAheadBytes = 0;
+    if (mReadAhead && &op == &mLogFileOp) {
+        readAheadBytes = takeReadAhead(buf, size, offset);
+    }
     int nbytes = 0;
-    nbytes = op.Pread(buf, 1, size, offset);
+    if (readAheadBytes < size) {
+        // data appended after the read ahead is read now
+        nbytes = op.Pread((char*)buf + readAheadBytes, 1, size - readAheadBytes, offset + readAheadBytes);
+    }
     if (nbytes < 0) {
         LOG_ERROR(sLogger,
                   ("Pread fail to read log file", mHostLogPath)("mLastFilePos", mLastFilePos)("size", size)("offset",
                                                                                                             offset));
-        return 0;
+        if (readAheadBytes == 0) {
+            return 0;
+        }
+        nbytes = 0;
     }
     // }
+    nbytes += readAheadBytes;
 
     *((char*)buf + nbytes) = '\0';
     return nbytes;
 }
 
+void LogFileReader::submitReadAhead() {
+    mReadAhead.reset();
+    // reads replayed from exactly once checkpoints have their own offsets and lengths
+    if (mEOOption || !mLogFileOp.IsOpen() || mCache.size() >= BUFFER_SIZE) {
+        return;
+    }
+    auto* manager = FileReadAheadManager::GetInstance();
+    if (!manager->IsEnabled()) {
+        return;
+    }
+    // the next read starts after the cache and fills the rest of the buffer, see ReadUTF8
+    mReadAhead = manager->Submit(mLogFileOp.GetFd(), GetLastReadPos(), BUFFER_SIZE - mCache.size());
+}
+
+size_t LogFileReader::takeReadAhead(void* buf, size_t size, int64_t offset) {
+    auto readAhead = std::move(mReadAhead);
+    // e.g. the file is truncated, or the read is not the next chunk
+    if (readAhead->mOffset != offset) {
+        return 0;
+    }
+    int32_t result = FileReadAheadManager::GetInstance()->Wait(*readAhead);
+    if (result <= 0) {
+        return 0;
+    }
+    size_t bytes = std::min(size, static_cast<size_t>(result));
+    memcpy(buf, readAhead->mBuffer.get(), bytes);
+    return bytes;
+}
+
 LogFileReader::FileCompareResult LogFileReader::CompareToFile(const string& filePath) {
     LogFileOperator logFileOp;
     logFileOp.Open(filePath.c_str());
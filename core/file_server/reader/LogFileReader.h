@@ -39,6 +39,7 @@
 #include "file_server/MultilineOptions.h"
 #include "file_server/checkpoint/RangeCheckpoint.h"
 #include "file_server/event/Event.h"
+#include "file_server/reader/FileReadAheadManager.h"
 #include "file_server/reader/FileReaderOptions.h"
 #include "logger/Logger.h"
 #include "protobuf/sls/sls_logs.pb.h"
@@ -523,6 +524,8 @@ protected:
     time_t mDeletedTime = 0;
     bool mContainerStopped = false;
     std::string mContainerID;
+    // whether the first read of a container file has been reported to ContainerManager
+    bool mContainerFirstReadReported = false;
     time_t mContainerStoppedTime = 0;
     time_t mReadStoppedContainerAlarmTime = 0;
     int32_t mReadDelayTime = 0;
@@ -537,6 +540,8 @@ protected:
     // bool mMarkOffsetFlag = false;
     // std::string mTimeFormat; // for backward reading
     LogFileOperator mLogFileOp; // encapsulate fuse & non-fuse mode
+    // read of the next chunk issued after a read leaving more data, see FileReadAheadManager
+    std::shared_ptr<FileReadAhead> mReadAhead;
     // std::string mFuseTrimedFilename;
     LogFileReaderPtrArray* mReaderArray = nullptr;
     // uint64_t mLogstoreKey;
@@ -635,6 +640,10 @@ private:
     // Update current checkpoint's read offset and length after success read.
     void setExactlyOnceCheckpointAfterRead(size_t readSize);
 
+    void submitReadAhead();
+    // Copies the data of mReadAhead into @buf if it is read at @offset, returns the bytes copied.
+    size_t takeReadAhead(void* buf, size_t size, int64_t offset);
+
     // Return primary key of current reader by combining meta.
     //
     // Conflict resolve: file signature will be stored in primary checkpoint.
@@ -55,6 +55,7 @@ LogtailPlugin::LogtailPlugin() {
     mStopFun = NULL;
     mStartFun = NULL;
     mLoadGlobalConfigFun = NULL;
+    mProcessFlatLogGroupFun = NULL;
     mPluginValid = false;
     mPluginAlarmConfig.mLogstore = "logtail_alarm";
     mPluginAlarmConfig.mAliuid = STRING_FLAG(logtail_profile_aliuid);
@@ -418,6 +419,12 @@ bool LogtailPlugin::LoadPluginBase() {
             LOG_ERROR(sLogger, ("load ProcessLogGroup error, Message", error));
             return mPluginValid;
         }
+        // Be compatible with old Go plugin system, which only accepts log group in protobuf.
+        mProcessFlatLogGroupFun = (ProcessFlatLogGroupFun)loader.LoadMethod("ProcessFlatLogGroup", error);
+        if (!error.empty()) {
+            LOG_WARNING(sLogger, ("load ProcessFlatLogGroup failed", error)("use ProcessLogGroup instead", ""));
+            mProcessFlatLogGroupFun = NULL;
+        }
         // 获取golang部分指标信息
         mGetGoMetricsFun = (GetGoMetricsFun)loader.LoadMethod("GetGoMetrics", error);
         if (!error.empty()) {
@@ -515,6 +522,29 @@ void LogtailPlugin::ProcessLogGroup(const std::string& configName,
 #endif
 }
 
+void LogtailPlugin::ProcessFlatLogGroup(const std::string& configName,
+                                        const std::string& logGroup,
+                                        const std::string& packId) {
+    if (logGroup.empty() || !(mPluginValid && mProcessFlatLogGroupFun != NULL)) {
+        return;
+    }
+    std::string realConfigName = configName + "/2";
+    std::string packIdPrefix = ToHexString(HashString(packId));
+    GoString goConfigName;
+    GoSlice goLog;
+    GoString goPackId;
+    goConfigName.n = realConfigName.size();
+    goConfigName.p = realConfigName.c_str();
+    goPackId.n = packIdPrefix.size();
+    goPackId.p = packIdPrefix.c_str();
+    goLog.len = goLog.cap = logGroup.length();
+    goLog.data = (void*)logGroup.c_str();
+    GoInt rst = mProcessFlatLogGroupFun(goConfigName, goLog, goPackId);
+    if (rst != (GoInt)0) {
+        LOG_WARNING(sLogger, ("process flat loggroup error", configName)("result", rst));
+    }
+}
+
 void LogtailPlugin::GetGoMetrics(std::vector<std::map<std::string, std::string>>& metircsList,
                                  const string& metricType) {
     if (mGetGoMetricsFun != nullptr) {
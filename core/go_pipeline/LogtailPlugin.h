@@ -143,6 +143,7 @@ typedef GoInt (*InitPluginBaseFun)();
 typedef GoInt (*InitPluginBaseV2Fun)(GoString cfg);
 typedef GoInt (*ProcessLogsFun)(GoString c, GoSlice l, GoString p, GoString t, GoSlice tags);
 typedef GoInt (*ProcessLogGroupFun)(GoString c, GoSlice l, GoString p);
+typedef GoInt (*ProcessFlatLogGroupFun)(GoString c, GoSlice l, GoString p);
 typedef struct innerContainerMeta* (*GetContainerMetaFun)(GoString containerID);
 typedef char* (*GetAllContainerMetaFun)();
 typedef char* (*GetDiffContainerMetaFun)();
@@ -218,6 +219,11 @@ public:
 
     void ProcessLogGroup(const std::string& configName, const std::string& logGroup, const std::string& packId);
 
+    // log group in the layout of SerializeFlatLogGroup, only available when the Go plugin system exports
+    // ProcessFlatLogGroup
+    bool IsFlatLogGroupSupported() const { return mProcessFlatLogGroupFun != NULL; }
+    void ProcessFlatLogGroup(const std::string& configName, const std::string& logGroup, const std::string& packId);
+
     static int IsValidToSend(long long logstoreKey);
 
     static int SendPb(const char* configName,
@@ -264,6 +270,7 @@ private:
     logtail::FlusherSLS mPluginContainerConfig;
     ProcessLogsFun mProcessLogsFun;
     ProcessLogGroupFun mProcessLogGroupFun;
+    ProcessFlatLogGroupFun mProcessFlatLogGroupFun;
     GetContainerMetaFun mGetContainerMetaFun;
     GetAllContainerMetaFun mGetAllContainerMetaFun;
     GetDiffContainerMetaFun mGetDiffContainerMetaFun;
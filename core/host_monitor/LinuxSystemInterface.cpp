@@ -18,6 +18,8 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <mutex>
 #include <string>
@@ -37,14 +39,34 @@ using namespace std::chrono;
 #include <iostream>
 
 #include "common/FileSystemUtil.h"
+#include "common/Flags.h"
 #include "common/StringTools.h"
 #include "host_monitor/Constants.h"
 #include "host_monitor/SystemInformationTools.h"
 #include "host_monitor/common/FastFieldParser.h"
 #include "logger/Logger.h"
 
+DEFINE_FLAG_INT32(host_monitor_max_cached_proc_dir_fds,
+                  "max /proc/<pid> dir fds kept open across process collection cycles, 0 to disable",
+                  4096);
+
 namespace logtail {
 
+LinuxSystemInterface::LinuxSystemInterface()
+    : mProcParser(""),
+      mProcReader(PROCESS_DIR, static_cast<size_t>(std::max(0, INT32_FLAG(host_monitor_max_cached_proc_dir_fds)))),
+      mDcgmCollector(LIB_DCGM) {
+}
+
+bool LinuxSystemInterface::readProcPidFile(pid_t pid, const std::filesystem::path& name, StringView& content) {
+    thread_local std::string sBuffer;
+#ifdef APSARA_UNIT_TEST_MAIN
+    // PROCESS_DIR is only switched by unittests, the reader keeps the path given at construction otherwise
+    mProcReader.SetProcPath(PROCESS_DIR);
+#endif
+    return mProcReader.ReadPidFile(pid, name.c_str(), sBuffer, content);
+}
+
 bool LinuxSystemInterface::GetHostSystemStat(vector<string>& lines, string& errorMessage) {
     errorMessage.clear();
     if (!CheckExistance(PROCESS_DIR / PROCESS_STAT)) {
@@ -584,14 +606,14 @@ bool LinuxSystemInterface::GetProcessListInformationOnce(ProcessListInformation&
         return false;
     }
 
+    mProcReader.RetainPids(processListInfo.pids);
     return true;
 }
 
 bool LinuxSystemInterface::GetProcessInformationOnce(pid_t pid, ProcessInformation& processInfo) {
-    auto processStat = PROCESS_DIR / std::to_string(pid) / PROCESS_STAT;
-    std::string line;
-    if (FileReadResult::kOK != ReadFileContent(processStat.string(), line, kDefaultMaxFileSize)) {
-        LOG_ERROR(sLogger, ("read process stat", "fail")("file", processStat));
+    StringView line;
+    if (!readProcPidFile(pid, PROCESS_STAT, line)) {
+        LOG_ERROR(sLogger, ("read process stat", "fail")("file", PROCESS_DIR / std::to_string(pid) / PROCESS_STAT));
         return false;
     }
     mProcParser.ParseProcessStat(pid, line, processInfo.stat);
@@ -1105,85 +1127,74 @@ bool LinuxSystemInterface::GetNetInterfaceInformationOnce(NetInterfaceInformatio
 }
 
 bool LinuxSystemInterface::GetProcessCmdlineStringOnce(pid_t pid, ProcessCmdlineString& cmdline) {
-    auto processCMDline = PROCESS_DIR / std::to_string(pid) / PROCESS_CMDLINE;
     cmdline.cmdline.clear();
 
-    std::ifstream file(static_cast<std::string>(processCMDline));
-
-    if (!file.is_open()) {
-        LOG_ERROR(sLogger, ("open process cmdline file", "fail")("file", processCMDline));
+    StringView content;
+    if (!readProcPidFile(pid, PROCESS_CMDLINE, content)) {
+        LOG_ERROR(sLogger,
+                  ("open process cmdline file", "fail")("file", PROCESS_DIR / std::to_string(pid) / PROCESS_CMDLINE));
         return false;
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        cmdline.cmdline.push_back(line);
+    // same as std::getline, a trailing newline does not produce an empty line
+    while (!content.empty()) {
+        auto pos = content.find('\n');
+        cmdline.cmdline.emplace_back(content.substr(0, pos));
+        if (pos == StringView::npos) {
+            break;
+        }
+        content.remove_prefix(pos + 1);
     }
 
     return true;
 }
 
 bool LinuxSystemInterface::GetProcessStatmOnce(pid_t pid, ProcessMemoryInformation& processMemory) {
-    auto processStatm = PROCESS_DIR / std::to_string(pid) / PROCESS_STATM;
-    std::vector<std::string> processStatmString;
-
-    std::ifstream file(static_cast<std::string>(processStatm));
-
-    if (!file.is_open()) {
-        LOG_ERROR(sLogger, ("open process statm file", "fail")("file", processStatm));
+    StringView content;
+    if (!readProcPidFile(pid, PROCESS_STATM, content)) {
+        LOG_ERROR(sLogger, ("open process statm file", "fail")("file", PROCESS_DIR / std::to_string(pid) / PROCESS_STATM));
         return false;
     }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        processStatmString.push_back(line);
+    if (content.empty()) {
+        return false;
     }
-    file.close();
 
-    if (!processStatmString.empty()) {
-        const std::string& input = processStatmString.front();
-
-        FastFieldParser parser(input);
-        std::vector<uint64_t> memValues;
-        memValues.reserve(3);
-
-        auto iter = parser.begin();
-        auto end = parser.end();
-        for (size_t i = 0; i < 3 && iter != end; ++i, ++iter) {
-            uint64_t value;
-            memValues.push_back(StringTo(*iter, value) ? value : 0);
+    // size resident shared text lib data dt, only the first 3 fields are needed
+    FastFieldParser parser(content.substr(0, content.find('\n')));
+    std::array<uint64_t, 3> memValues{};
+    size_t count = 0;
+    for (auto iter = parser.begin(); count < memValues.size() && iter != parser.end(); ++iter, ++count) {
+        if (!StringTo(*iter, memValues[count])) {
+            memValues[count] = 0;
         }
-
-        if (memValues.size() >= 3) {
-            processMemory.size = memValues[0] * PAGE_SIZE;
-            processMemory.resident = memValues[1] * PAGE_SIZE;
-            processMemory.share = memValues[2] * PAGE_SIZE;
-        } else {
-            return false;
-        }
-    } else {
+    }
+    if (count < memValues.size()) {
         return false;
     }
+    processMemory.size = memValues[0] * PAGE_SIZE;
+    processMemory.resident = memValues[1] * PAGE_SIZE;
+    processMemory.share = memValues[2] * PAGE_SIZE;
 
     return true;
 }
 
 bool LinuxSystemInterface::GetProcessCredNameOnce(pid_t pid, ProcessCredName& processCredName) {
-    auto processStatus = PROCESS_DIR / std::to_string(pid) / PROCESS_STATUS;
-
-    std::ifstream file(static_cast<std::string>(processStatus));
-
-    if (!file.is_open()) {
-        LOG_ERROR(sLogger, ("open process status file", "fail")("file", processStatus));
+    StringView content;
+    if (!readProcPidFile(pid, PROCESS_STATUS, content)) {
+        LOG_ERROR(sLogger,
+                  ("open process status file", "fail")("file", PROCESS_DIR / std::to_string(pid) / PROCESS_STATUS));
         return false;
     }
 
-    std::string line;
     ProcessCred cred{};
     bool getUID = false;
     bool getGID = false;
     bool getName = false;
-    while (std::getline(file, line) && !(getUID && getGID && getName)) {
+    // Name, Uid and Gid are in the first lines of status, stop as soon as all of them are found
+    while (!content.empty() && !(getUID && getGID && getName)) {
+        auto pos = content.find('\n');
+        StringView line = content.substr(0, pos);
+        content.remove_prefix(pos == StringView::npos ? content.size() : pos + 1);
         FastFieldParser parser(line, '\t');
 
         auto firstField = parser.GetField(0);
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "common/ProcFileReader.h"
 #include "common/ProcParser.h"
 #include "host_monitor/Constants.h"
 #include "host_monitor/SystemInformationTools.h"
@@ -34,7 +35,7 @@ public:
     }
 
 private:
-    explicit LinuxSystemInterface() : mProcParser(""), mDcgmCollector(LIB_DCGM) {}
+    explicit LinuxSystemInterface();
     ~LinuxSystemInterface() = default;
 
     bool GetSystemInformationOnce(SystemInformation& systemInfo) override;
@@ -71,8 +72,11 @@ private:
     bool GetNetStateByNetLink(NetState& netState);
     bool GetHostNetDev(std::vector<std::string>& lines, std::string& errorMessage);
     bool GetInterfaceConfig(InterfaceConfig& interfaceConfig, const std::string& name);
+    // content is valid until the next call on the same thread
+    bool readProcPidFile(pid_t pid, const std::filesystem::path& name, StringView& content);
 
     ProcParser mProcParser;
+    ProcFileReader mProcReader;
     DCGMCollector mDcgmCollector;
 };
 } // namespace logtail
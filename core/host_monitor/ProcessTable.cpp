@@ -0,0 +1,276 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "host_monitor/ProcessTable.h"
+
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#include <cstring>
+
+#include <algorithm>
+
+#include "common/Flags.h"
+#include "host_monitor/Constants.h"
+#include "host_monitor/SystemInterface.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_BOOL(host_monitor_enable_process_event,
+                 "follow process creation and exit by netlink proc connector instead of scanning /proc every "
+                 "collection, falls back to scanning when not available",
+                 true);
+DEFINE_FLAG_INT32(host_monitor_process_event_resync_interval,
+                  "interval of full /proc rescan in process event mode, seconds",
+                  600);
+
+namespace logtail {
+
+// the first rescans verify that events are delivered at all, e.g. they are not in a non-initial pid namespace
+static const std::chrono::seconds kProcessEventVerifyInterval{60};
+static const int kMaxProcessEventPollFailures = 3;
+
+bool NetlinkProcessEventSource::Open() {
+    mFd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (mFd < 0) {
+        LOG_INFO(sLogger, ("failed to create proc connector socket", strerror(errno)));
+        return false;
+    }
+    sockaddr_nl addr{};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid = 0;
+    if (bind(mFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        LOG_INFO(sLogger, ("failed to bind proc connector socket", strerror(errno)));
+        Close();
+        return false;
+    }
+    // a fork storm between two collections should not overflow the socket
+    int rcvBuf = 4 * 1024 * 1024;
+    setsockopt(mFd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+    if (!subscribe(true)) {
+        LOG_INFO(sLogger, ("failed to subscribe proc connector", strerror(errno)));
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void NetlinkProcessEventSource::Close() {
+    if (mFd >= 0) {
+        subscribe(false);
+        close(mFd);
+        mFd = -1;
+    }
+}
+
+bool NetlinkProcessEventSource::subscribe(bool enable) {
+    alignas(nlmsghdr) char buf[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+    auto* hdr = reinterpret_cast<nlmsghdr*>(buf);
+    hdr->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+    hdr->nlmsg_type = NLMSG_DONE;
+    hdr->nlmsg_pid = 0;
+    auto* msg = reinterpret_cast<cn_msg*>(NLMSG_DATA(hdr));
+    msg->id.idx = CN_IDX_PROC;
+    msg->id.val = CN_VAL_PROC;
+    msg->len = sizeof(proc_cn_mcast_op);
+    proc_cn_mcast_op op = enable ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+    memcpy(msg->data, &op, sizeof(op));
+    return send(mFd, buf, hdr->nlmsg_len, 0) == static_cast<ssize_t>(hdr->nlmsg_len);
+}
+
+bool NetlinkProcessEventSource::Poll(std::vector<ProcessEvent>& events) {
+    if (mFd < 0) {
+        return false;
+    }
+    alignas(nlmsghdr) char buf[16384];
+    while (true) {
+        ssize_t n = recv(mFd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            if (errno == ENOBUFS) {
+                // events are lost, the socket is still usable
+                LOG_WARNING(sLogger, ("proc connector socket overflow", "rescan process list"));
+                return false;
+            }
+            LOG_WARNING(sLogger, ("failed to receive from proc connector socket", strerror(errno)));
+            Close();
+            return false;
+        }
+        int len = static_cast<int>(n);
+        for (auto* hdr = reinterpret_cast<nlmsghdr*>(buf); NLMSG_OK(hdr, len); hdr = NLMSG_NEXT(hdr, len)) {
+            if (hdr->nlmsg_type == NLMSG_ERROR || hdr->nlmsg_type == NLMSG_NOOP) {
+                continue;
+            }
+            auto* msg = reinterpret_cast<cn_msg*>(NLMSG_DATA(hdr));
+            if (msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC) {
+                continue;
+            }
+            auto* ev = reinterpret_cast<proc_event*>(msg->data);
+            switch (ev->what) {
+                case proc_event::PROC_EVENT_FORK:
+                    // thread creation is reported as fork too
+                    if (ev->event_data.fork.child_pid == ev->event_data.fork.child_tgid) {
+                        events.push_back({ProcessEventType::kFork, ev->event_data.fork.child_tgid});
+                    }
+                    break;
+                case proc_event::PROC_EVENT_EXEC:
+                    events.push_back({ProcessEventType::kExec, ev->event_data.exec.process_tgid});
+                    break;
+                case proc_event::PROC_EVENT_EXIT:
+                    if (ev->event_data.exit.process_pid == ev->event_data.exit.process_tgid) {
+                        events.push_back({ProcessEventType::kExit, ev->event_data.exit.process_tgid});
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+ProcessTable::ProcessTable(std::unique_ptr<ProcessEventSource> source) : mSource(std::move(source)) {
+    if (mSource && !mSource->Open()) {
+        fallbackToPolling("process event source is not available");
+    }
+}
+
+ProcessTable::~ProcessTable() {
+    if (mSource) {
+        mSource->Close();
+    }
+}
+
+std::unique_ptr<ProcessEventSource> ProcessTable::CreateDefaultEventSource() {
+    // events are in the pid namespace of the agent, which only matches the default proc root
+    if (!BOOL_FLAG(host_monitor_enable_process_event) || PROCESS_DIR != "/proc") {
+        return nullptr;
+    }
+    return std::make_unique<NetlinkProcessEventSource>();
+}
+
+bool ProcessTable::GetPids(time_t now, std::vector<pid_t>& pids, std::vector<pid_t>& changed, time_t& collectTime) {
+    changed.clear();
+    mLastRescan = false;
+    if (!mSource) {
+        ProcessListInformation processListInfo;
+        if (!SystemInterface::GetInstance()->GetProcessListInformation(now, processListInfo)) {
+            return false;
+        }
+        pids = std::move(processListInfo.pids);
+        collectTime = processListInfo.collectTime;
+        mLastRescan = true;
+        return true;
+    }
+
+    mEvents.clear();
+    if (mSource->Poll(mEvents)) {
+        mPollFailures = 0;
+    } else if (++mPollFailures >= kMaxProcessEventPollFailures) {
+        fallbackToPolling("failed to poll process events");
+        return GetPids(now, pids, changed, collectTime);
+    } else {
+        mNeedRescan = true;
+    }
+    for (const auto& event : mEvents) {
+        if (event.type == ProcessEventType::kExit) {
+            mPids.erase(event.pid);
+            mChanged.erase(event.pid);
+        } else {
+            mPids.insert(event.pid);
+            mChanged.insert(event.pid);
+        }
+    }
+    mEventsSinceRescan += mEvents.size();
+    // events are consumed just now
+    collectTime = time(nullptr);
+
+    auto steadyNow = std::chrono::steady_clock::now();
+    auto interval = mEventsVerified ? std::chrono::seconds(INT32_FLAG(host_monitor_process_event_resync_interval))
+                                    : kProcessEventVerifyInterval;
+    if (mNeedRescan || steadyNow - mLastRescanTime >= interval) {
+        if (!rescan(now, collectTime)) {
+            return false;
+        }
+        if (!mSource) {
+            // fell back during the rescan, the pids are from the scan anyway
+            mLastRescan = true;
+        }
+    }
+
+    pids.assign(mPids.begin(), mPids.end());
+    std::sort(pids.begin(), pids.end());
+    changed.assign(mChanged.begin(), mChanged.end());
+    mChanged.clear();
+    return true;
+}
+
+bool ProcessTable::rescan(time_t now, time_t& collectTime) {
+    ProcessListInformation processListInfo;
+    if (!SystemInterface::GetInstance()->GetProcessListInformation(now, processListInfo)) {
+        return false;
+    }
+    collectTime = processListInfo.collectTime;
+    std::unordered_set<pid_t> scanned(processListInfo.pids.begin(), processListInfo.pids.end());
+    if (!mNeedRescan) {
+        // periodic rescan, compare with the table maintained by events
+        size_t drift = 0;
+        for (auto pid : scanned) {
+            drift += mPids.find(pid) == mPids.end();
+        }
+        for (auto pid : mPids) {
+            drift += scanned.find(pid) == scanned.end();
+        }
+        if (drift > 0) {
+            if (mEventsSinceRescan == 0) {
+                fallbackToPolling("process list changed but no process event is delivered");
+            } else {
+                LOG_INFO(sLogger, ("process table drift fixed by rescan", drift));
+            }
+        }
+        if (mEventsSinceRescan > 0) {
+            mEventsVerified = true;
+        }
+    }
+    mPids.swap(scanned);
+    mChanged.clear();
+    mNeedRescan = false;
+    mLastRescan = true;
+    mEventsSinceRescan = 0;
+    mLastRescanTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+void ProcessTable::fallbackToPolling(const char* reason) {
+    LOG_INFO(sLogger, ("process event mode is disabled, fall back to scanning /proc", reason));
+    if (mSource) {
+        mSource->Close();
+        mSource.reset();
+    }
+    mPids.clear();
+    mChanged.clear();
+}
+
+} // namespace logtail
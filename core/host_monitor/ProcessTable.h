@@ -0,0 +1,106 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace logtail {
+
+enum class ProcessEventType { kFork, kExec, kExit };
+
+struct ProcessEvent {
+    ProcessEventType type;
+    pid_t pid;
+};
+
+class ProcessEventSource {
+public:
+    virtual ~ProcessEventSource() = default;
+
+    // false if events are not available on this host, the caller falls back to polling
+    virtual bool Open() = 0;
+    virtual void Close() = 0;
+    // non-blocking, appends all pending process (not thread) events.
+    // false if events have been lost (e.g. socket buffer overflow) or the source is broken, the caller should resync
+    virtual bool Poll(std::vector<ProcessEvent>& events) = 0;
+};
+
+// Process creation and exit events from the netlink proc connector, needs CAP_NET_ADMIN and is only delivered in the
+// initial pid namespace.
+class NetlinkProcessEventSource : public ProcessEventSource {
+public:
+    ~NetlinkProcessEventSource() override { Close(); }
+
+    bool Open() override;
+    void Close() override;
+    bool Poll(std::vector<ProcessEvent>& events) override;
+
+private:
+    bool subscribe(bool enable);
+
+    int mFd = -1;
+};
+
+// Incremental table of live pids. In event mode the table is built by a full /proc scan once and then maintained by
+// process events, so the cost of a collection scales with process churn instead of the total process count. A full
+// rescan is done again when events are lost and every resync interval. Falls back to scanning /proc on every call
+// when no event source is available.
+// NOT thread-safe, each collector owns its own table.
+class ProcessTable {
+public:
+    // source can be null, which means polling mode
+    explicit ProcessTable(std::unique_ptr<ProcessEventSource> source);
+    ~ProcessTable();
+
+    // pids: all live processes; changed: processes created or exec'ed since the last call, empty after a rescan;
+    // collectTime: when the pids are actually collected, which can differ from now if the process list is memoized
+    bool GetPids(time_t now, std::vector<pid_t>& pids, std::vector<pid_t>& changed, time_t& collectTime);
+
+    [[nodiscard]] bool IsEventDriven() const { return mSource != nullptr; }
+    // true if pids of the last GetPids come from a full /proc scan
+    [[nodiscard]] bool IsLastRescan() const { return mLastRescan; }
+
+    static std::unique_ptr<ProcessEventSource> CreateDefaultEventSource();
+
+private:
+    bool rescan(time_t now, time_t& collectTime);
+    void fallbackToPolling(const char* reason);
+
+    std::unique_ptr<ProcessEventSource> mSource;
+    std::unordered_set<pid_t> mPids;
+    std::unordered_set<pid_t> mChanged;
+    std::vector<ProcessEvent> mEvents;
+    std::chrono::steady_clock::time_point mLastRescanTime;
+    bool mNeedRescan = true;
+    bool mLastRescan = false;
+    // set once a rescan proves that events are delivered
+    bool mEventsVerified = false;
+    size_t mEventsSinceRescan = 0;
+    int mPollFailures = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ProcessTableUnittest;
+#endif
+};
+
+} // namespace logtail
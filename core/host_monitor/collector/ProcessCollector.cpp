@@ -43,6 +43,8 @@ DEFINE_FLAG_INT32(basic_host_monitor_process_collect_interval,
 
 // topN进行的缓存为55s
 const std::chrono::seconds ProcessSortInterval{55};
+// 进程事件模式下，全量排序后保留 topN * factor 个候选进程
+const size_t ProcessSortCandidateFactor = 4;
 
 const std::string ProcessCollector::sName = "process";
 const std::string kMetricLabelProcess = "valueTag";
@@ -81,7 +83,8 @@ static inline void GetProcessCpuSorted(std::vector<std::pair<pid_t, ProcessCpuIn
               });
 }
 
-ProcessCollector::ProcessCollector() : mTopN(INT32_FLAG(host_monitor_process_report_top_N)) {
+ProcessCollector::ProcessCollector()
+    : mProcessTable(ProcessTable::CreateDefaultEventSource()), mTopN(INT32_FLAG(host_monitor_process_report_top_N)) {
 }
 
 bool ProcessCollector::Init(HostMonitorContext& collectContext) {
@@ -98,18 +101,30 @@ bool ProcessCollector::Init(HostMonitorContext& collectContext) {
 }
 
 bool ProcessCollector::Collect(HostMonitorContext& collectContext, PipelineEventGroup* groupPtr) {
-    ProcessListInformation processListInfo;
-
-    if (!SystemInterface::GetInstance()->GetProcessListInformation(collectContext.GetMetricTime(), processListInfo)) {
+    std::vector<pid_t> changedPids;
+    time_t collectTime = 0;
+    if (!mProcessTable.GetPids(collectContext.GetMetricTime(), pids, changedPids, collectTime)) {
         return false;
     }
 
-    pids = processListInfo.pids;
+    // 进程事件模式下，只在全量排序时读取所有进程的cpu信息，两次全量排序之间只读取上次的候选进程和新创建的进程
+    auto steadyNow = std::chrono::steady_clock::now();
+    bool fullSort = !mProcessTable.IsEventDriven() || mSortPids.empty()
+        || steadyNow >= mProcessSortCollectTime + ProcessSortInterval;
+    const std::vector<pid_t>* readPids = &pids;
+    if (!fullSort) {
+        // 新建和exec的进程首次读取时cpu使用率为0，保留为候选进程直到下次全量排序
+        mSortPids.insert(mSortPids.end(), changedPids.begin(), changedPids.end());
+        std::sort(mSortPids.begin(), mSortPids.end());
+        mSortPids.erase(std::unique(mSortPids.begin(), mSortPids.end()), mSortPids.end());
+        readPids = &mSortPids;
+    }
+
     std::vector<ProcessAllStat> allPidStats;
     std::vector<std::pair<pid_t, ProcessCpuInformation>> cpuInfos;
 
     // 获取所有进程的cpu信息
-    for (auto pid : pids) {
+    for (auto pid : *readPids) {
         ProcessCpuInformation info;
         if (!GetProcessCpuInformation(collectContext.mCollectTime, pid, info)) {
             continue;
@@ -119,6 +134,19 @@ bool ProcessCollector::Collect(HostMonitorContext& collectContext, PipelineEvent
 
     // 对所有进程的cpu信息进行排序
     GetProcessCpuSorted(cpuInfos);
+    if (fullSort && mProcessTable.IsEventDriven()) {
+        mSortPids.clear();
+        for (size_t i = 0; i < std::min(mTopN * ProcessSortCandidateFactor, cpuInfos.size()); i++) {
+            mSortPids.push_back(cpuInfos[i].first);
+        }
+        mProcessSortCollectTime = steadyNow;
+    } else if (!fullSort) {
+        // 移除已退出的候选进程
+        mSortPids.clear();
+        for (const auto& cpuInfo : cpuInfos) {
+            mSortPids.push_back(cpuInfo.first);
+        }
+    }
 
     // 取cpu排名前mTopN的进程，获取每一个进程的信息
     for (size_t i = 0; i < std::min(static_cast<size_t>(mTopN), cpuInfos.size()); i++) {
@@ -185,7 +213,7 @@ bool ProcessCollector::Collect(HostMonitorContext& collectContext, PipelineEvent
     if (!metricEvent) {
         return false;
     }
-    metricEvent->SetTimestamp(processListInfo.collectTime, 0);
+    metricEvent->SetTimestamp(collectTime, 0);
     metricEvent->SetValue<UntypedMultiDoubleValues>(metricEvent);
     auto* multiDoubleValues = metricEvent->MutableValue<UntypedMultiDoubleValues>();
     struct MetricDef {
@@ -206,7 +234,7 @@ bool ProcessCollector::Collect(HostMonitorContext& collectContext, PipelineEvent
     // 每个pid一条记录上报
     for (size_t i = 0; i < mTopN && i < pushMerticList.size(); i++) {
         MetricEvent* metricEventEachPid = groupPtr->AddMetricEvent(true);
-        metricEventEachPid->SetTimestamp(processListInfo.collectTime, 0);
+        metricEventEachPid->SetTimestamp(collectTime, 0);
         metricEventEachPid->SetValue<UntypedMultiDoubleValues>(metricEventEachPid);
         auto* multiDoubleValuesEachPid = metricEventEachPid->MutableValue<UntypedMultiDoubleValues>();
         // 上传每一个pid对应的值
@@ -515,13 +543,14 @@ bool ProcessCollector::ReadProcessStat(time_t now, pid_t pid, ProcessInformation
 
 void ProcessCollector::ClearProcessCpuTimeCache() {
     try {
-        // 清除超时的cache
+        // 清除超时的cache，进程事件模式下非候选进程只在全量排序时更新，需要保留到下一次全量排序
         const auto now = std::chrono::steady_clock::now();
+        const auto expire = mProcessTable.IsEventDriven() ? ProcessSortInterval * 2 : ProcessSortInterval;
         auto it = cpuTimeCache.begin();
 
         while (it != cpuTimeCache.end()) {
             // 检查当前元素是否超时
-            if (now - it->second.lastTime > ProcessSortInterval) {
+            if (now - it->second.lastTime > expire) {
                 // 超时，删除该元素
                 it = cpuTimeCache.erase(it);
             } else {
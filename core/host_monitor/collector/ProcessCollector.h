@@ -18,6 +18,7 @@
 
 #include "common/ProcParser.h"
 #include "host_monitor/HostMonitorContext.h"
+#include "host_monitor/ProcessTable.h"
 #include "host_monitor/SystemInterface.h"
 #include "host_monitor/collector/BaseCollector.h"
 #include "host_monitor/collector/MetricCalculate.h"
@@ -72,6 +73,9 @@ protected:
 
 private:
     std::vector<pid_t> pids;
+    ProcessTable mProcessTable;
+    // in process event mode, candidates of the last full cpu ranking and processes created or exec'd since, re-read
+    // until the next full ranking
     std::vector<pid_t> mSortPids;
     int mSelfPid = 0;
     int mParentPid = 0;
@@ -22,6 +22,7 @@
 #include <sched.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <memory>
 #include <queue>
 #include <string>
@@ -46,11 +47,17 @@ DEFINE_FLAG_INT32(process_collect_silent_count, "number of process scanned betwe
 namespace logtail {
 
 const size_t ProcessTopN = 20;
+// in process event mode, all processes are only re-ranked by cpu at this interval
+const std::chrono::seconds ProcessSortInterval{55};
+// candidates kept from a full ranking, so that processes slightly below top N can still get in before the next one
+const size_t ProcessSortCandidateFactor = 4;
 
 const std::string ProcessEntityCollector::sName = "process_entity";
 
 ProcessEntityCollector::ProcessEntityCollector()
-    : mProcParser(""), mProcessSilentCount(INT32_FLAG(process_collect_silent_count)) {
+    : mProcParser(""),
+      mProcessTable(ProcessTable::CreateDefaultEventSource()),
+      mProcessSilentCount(INT32_FLAG(process_collect_silent_count)) {
 }
 
 system_clock::time_point ProcessEntityCollector::TicksToUnixTime(int64_t startTicks) {
@@ -144,15 +151,37 @@ time_t ProcessEntityCollector::GetSortedProcess(std::vector<ExtendedProcessStatP
 
     int readCount = 0;
     std::unordered_map<pid_t, ExtendedProcessStatPtr> newProcessStat;
-    ProcessListInformation processListInfo;
-    if (!SystemInterface::GetInstance()->GetProcessListInformation(collectTime.mMetricTime, processListInfo)) {
+    std::vector<pid_t> pids;
+    std::vector<pid_t> changedPids;
+    time_t listCollectTime = 0;
+    if (!mProcessTable.GetPids(collectTime.mMetricTime, pids, changedPids, listCollectTime)) {
         LOG_ERROR(sLogger, ("failed to get process list information", "skip collect"));
         return 0;
     }
-    CollectTime shiftCollectTime{collectTime.GetShiftSteadyTime(processListInfo.collectTime),
-                                 processListInfo.collectTime};
+    CollectTime shiftCollectTime{collectTime.GetShiftSteadyTime(listCollectTime), listCollectTime};
 
-    for (const auto& pid : processListInfo.pids) {
+    // in process event mode, only the candidates of the last full ranking and the processes created since are
+    // re-read between two full rankings, stats of the others are carried over
+    bool fullSort = !mProcessTable.IsEventDriven() || mSortPids.empty()
+        || shiftCollectTime.mScheduleTime >= mProcessSortTime + ProcessSortInterval;
+    const std::vector<pid_t>* readPids = &pids;
+    if (!fullSort) {
+        for (auto pid : pids) {
+            auto prev = mPrevProcessStat.find(pid);
+            if (prev != mPrevProcessStat.end()) {
+                newProcessStat.emplace(pid, prev->second);
+            }
+        }
+        // new and exec'd processes get no cpu percent before their second read, so they stay candidates until the
+        // next full ranking instead of only being read once
+        mSortPids.insert(mSortPids.end(), changedPids.begin(), changedPids.end());
+        std::sort(mSortPids.begin(), mSortPids.end());
+        mSortPids.erase(std::unique(mSortPids.begin(), mSortPids.end()), mSortPids.end());
+        readPids = &mSortPids;
+    }
+    size_t queueSize = fullSort && mProcessTable.IsEventDriven() ? topN * ProcessSortCandidateFactor : topN;
+
+    for (const auto& pid : *readPids) {
         if (pid == 0) {
             continue;
         }
@@ -169,7 +198,7 @@ time_t ProcessEntityCollector::GetSortedProcess(std::vector<ExtendedProcessStatP
         if (!isFirstCollect) {
             queue.emplace(ptr, ptr->cpuInfo.percent);
         }
-        if (queue.size() > topN) {
+        if (queue.size() > queueSize) {
             queue.pop();
         }
     }
@@ -181,6 +210,24 @@ time_t ProcessEntityCollector::GetSortedProcess(std::vector<ExtendedProcessStatP
         queue.pop();
     }
     std::reverse(processStats.begin(), processStats.end());
+    if (fullSort) {
+        mSortPids.clear();
+        if (mProcessTable.IsEventDriven()) {
+            for (const auto& stat : processStats) {
+                mSortPids.push_back(stat->stat.pid);
+            }
+            mProcessSortTime = shiftCollectTime.mScheduleTime;
+        }
+        if (processStats.size() > topN) {
+            processStats.resize(topN);
+        }
+    } else {
+        // drop candidates which have exited
+        mSortPids.erase(std::remove_if(mSortPids.begin(),
+                                       mSortPids.end(),
+                                       [&](pid_t pid) { return newProcessStat.find(pid) == newProcessStat.end(); }),
+                        mSortPids.end());
+    }
 
     if (processStats.empty()) {
         LOG_INFO(sLogger, ("first collect Process Cpu info", "empty"));
@@ -188,8 +235,7 @@ time_t ProcessEntityCollector::GetSortedProcess(std::vector<ExtendedProcessStatP
     LOG_DEBUG(sLogger, ("collect Process Cpu info, top", processStats.size()));
 
     mPrevProcessStat = std::move(newProcessStat);
-    mProcessSortTime = collectTime.GetShiftSteadyTime(processListInfo.collectTime);
-    return processListInfo.collectTime;
+    return listCollectTime;
 }
 
 ExtendedProcessStatPtr
@@ -31,6 +31,7 @@
 #include "common/StringView.h"
 #include "constants/EntityConstants.h"
 #include "host_monitor/HostMonitorContext.h"
+#include "host_monitor/ProcessTable.h"
 #include "host_monitor/collector/BaseCollector.h"
 
 using namespace std::chrono;
@@ -80,6 +81,10 @@ private:
     std::chrono::steady_clock::time_point mProcessSortTime;
     std::unordered_map<pid_t, ExtendedProcessStatPtr> mPrevProcessStat;
     ProcParser mProcParser;
+    ProcessTable mProcessTable;
+    // in process event mode, candidates of the last full ranking and processes created or exec'd since, re-read until
+    // the next full ranking
+    std::vector<pid_t> mSortPids;
 
     const int mProcessSilentCount;
 
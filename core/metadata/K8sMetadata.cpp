@@ -18,8 +18,10 @@
 
 #include <ctime>
 
+#include <algorithm>
 #include <chrono>
 #include <future>
+#include <iterator>
 #include <memory>
 #include <thread>
 
@@ -39,6 +41,14 @@ using namespace std;
 
 DEFINE_FLAG_STRING(ipv4_cluster_cidrs, "cluster cidr", "");
 DEFINE_FLAG_BOOL(disable_k8s_meta, "disable k8s metadata", false);
+DEFINE_FLAG_INT32(k8s_metadata_cache_ttl, "seconds before a cached pod info is refreshed", 600);
+DEFINE_FLAG_INT32(k8s_metadata_negative_cache_ttl,
+                  "seconds before an ip or container id unknown to the metadata server is queried again",
+                  60);
+DEFINE_FLAG_INT32(k8s_metadata_max_batch_size, "max number of keys in one request to the metadata server", 200);
+DEFINE_FLAG_INT32(k8s_metadata_max_pending_keys,
+                  "max number of keys waiting to be queried, new keys are dropped when full",
+                  10000);
 
 namespace logtail {
 
@@ -86,7 +96,10 @@ K8sMetadata::~K8sMetadata() {
 }
 
 K8sMetadata::K8sMetadata(size_t ipCacheSize, size_t cidCacheSize, size_t externalIpCacheSize)
-    : mIpCache(ipCacheSize, 20), mContainerCache(cidCacheSize, 20), mExternalIpCache(externalIpCacheSize, 20) {
+    : mIpCache(ipCacheSize, 20),
+      mContainerCache(cidCacheSize, 20),
+      mExternalIpCache(externalIpCacheSize, 20),
+      mMissingCidCache(cidCacheSize, 20) {
     mServiceHost = STRING_FLAG(k8s_metadata_server_name);
     mServicePort = INT32_FLAG(k8s_metadata_server_port);
     const char* value = getenv("_node_ip_");
@@ -127,6 +140,13 @@ K8sMetadata::K8sMetadata(size_t ipCacheSize, size_t cidCacheSize, size_t externa
     mExternalIpCacheSize = mRef.CreateIntGauge(METRIC_RUNNER_METADATA_EXTERNAL_IP_CACHE_SIZE);
     mRequestMetaServerTotal = mRef.CreateCounter(METRIC_RUNNER_METADATA_REQUEST_REMOTE_TOTAL);
     mRequestMetaServerFailedTotal = mRef.CreateCounter(METRIC_RUNNER_METADATA_REQUEST_REMOTE_FAILED_TOTAL);
+    mMissingCidCacheSize = mRef.CreateIntGauge(METRIC_RUNNER_METADATA_MISSING_CID_CACHE_SIZE);
+    mPendingQueryKeys = mRef.CreateIntGauge(METRIC_RUNNER_METADATA_PENDING_QUERY_KEYS);
+    mNegativeCacheHitTotal = mRef.CreateCounter(METRIC_RUNNER_METADATA_NEGATIVE_CACHE_HIT_TOTAL);
+    mDroppedQueryKeysTotal = mRef.CreateCounter(METRIC_RUNNER_METADATA_DROPPED_QUERY_KEYS_TOTAL);
+    mCacheHitTotal = mRef.CreateCounter(METRIC_RUNNER_METADATA_CACHE_HIT_TOTAL);
+    mCacheMissTotal = mRef.CreateCounter(METRIC_RUNNER_METADATA_CACHE_MISS_TOTAL);
+    mCacheEvictionTotal = mRef.CreateCounter(METRIC_RUNNER_METADATA_CACHE_EVICTION_TOTAL);
     WriteMetrics::GetInstance()->CommitMetricsRecordRef(mRef);
 
     // batch query metadata ...
@@ -182,15 +202,7 @@ bool ContainerInfoIsExpired(const std::shared_ptr<K8sPodInfo>& info) {
     if (info == nullptr) {
         return false;
     }
-    std::time_t now = std::time(0);
-    std::chrono::system_clock::time_point th1 = std::chrono::system_clock::from_time_t(info->mTimestamp);
-    std::chrono::system_clock::time_point th2 = std::chrono::system_clock::from_time_t(now);
-    std::chrono::duration<double> diff = th2 - th1;
-    double seconds_diff = diff.count();
-    if (seconds_diff > 600) { // 10 minutes in seconds
-        return true;
-    }
-    return false;
+    return std::time(nullptr) - info->mTimestamp > INT32_FLAG(k8s_metadata_cache_ttl);
 }
 
 bool K8sMetadata::FromContainerJson(const Json::Value& json,
@@ -340,7 +352,7 @@ bool K8sMetadata::SendRequestToOperator(const std::string& urlHost,
     ADD_COUNTER(mRequestMetaServerTotal, 1);
 #ifdef APSARA_UNIT_TEST_MAIN
     mRequest = request.get();
-    bool success = false;
+    bool success = mSendRequestInUnitTest && SendHttpRequest(std::move(request), res);
 #else
     bool success = SendHttpRequest(std::move(request), res);
 #endif
@@ -387,6 +399,9 @@ std::vector<std::string> K8sMetadata::GetByContainerIdsFromServer(std::vector<st
     std::vector<std::string> res;
     std::string reqBody = KeysToReqBody(containerIds);
     status = SendRequestToOperator(mServiceHost, reqBody, PodInfoType::ContainerIdInfo, res);
+    if (status) {
+        UpdateMissingCidCache(containerIds, res);
+    }
     return res;
 }
 
@@ -410,7 +425,9 @@ void K8sMetadata::SetIpCache(const std::string& key, const std::shared_ptr<K8sPo
 
 void K8sMetadata::SetExternalIpCache(const std::string& ip) {
     LOG_DEBUG(sLogger, (ip, "is external, inset into cache ..."));
-    mExternalIpCache.insert(ip, uint8_t(0));
+    mExternalIpCache.insert(ip, std::time(nullptr));
+    // the negative cache short-circuits refreshes, so a stale pod info would otherwise be served until evicted
+    mIpCache.remove(ip);
 }
 
 void K8sMetadata::UpdateExternalIpCache(const std::vector<std::string>& queryIps,
@@ -427,6 +444,36 @@ void K8sMetadata::UpdateExternalIpCache(const std::vector<std::string>& queryIps
     }
 }
 
+void K8sMetadata::UpdateMissingCidCache(const std::vector<std::string>& queryCids,
+                                        const std::vector<std::string>& retCids) {
+    std::unordered_set<std::string> found(retCids.begin(), retCids.end());
+    std::time_t now = std::time(nullptr);
+    for (const auto& cid : queryCids) {
+        if (!found.count(cid)) {
+            LOG_DEBUG(sLogger, (cid, "mark as missing container id"));
+            mMissingCidCache.insert(cid, now);
+            mContainerCache.remove(cid);
+        }
+    }
+}
+
+bool K8sMetadata::IsNegativeCached(lru11::ShardedCache<std::string, std::time_t>& cache,
+                                   const std::string& key) {
+    std::time_t markTime = 0;
+    if (!cache.tryGetCopy(key, markTime)) {
+        return false;
+    }
+    if (std::time(nullptr) - markTime >= INT32_FLAG(k8s_metadata_negative_cache_ttl)) {
+        cache.remove(key);
+        return false;
+    }
+    return true;
+}
+
+bool K8sMetadata::IsMissingContainerId(const std::string& containerId) const {
+    return IsNegativeCached(mMissingCidCache, containerId);
+}
+
 std::vector<std::string> K8sMetadata::GetByIpsFromServer(std::vector<std::string>& ips, bool& status, bool force) {
     std::vector<std::string> res;
     std::string reqBody = KeysToReqBody(ips);
@@ -445,6 +492,10 @@ std::shared_ptr<K8sPodInfo> K8sMetadata::GetInfoByContainerIdFromCache(const Str
     std::shared_ptr<K8sPodInfo> info;
     bool isValid = mContainerCache.tryGetCopy(cid, info);
     if (isValid) {
+        if (ContainerInfoIsExpired(info)) {
+            // refresh in background, the stale info is still better than none
+            AsyncQueryMetadata(PodInfoType::ContainerIdInfo, containerId);
+        }
         return info;
     }
     return nullptr;
@@ -458,13 +509,16 @@ std::shared_ptr<K8sPodInfo> K8sMetadata::GetInfoByIpFromCache(const StringView&
     std::shared_ptr<K8sPodInfo> info;
     bool isValid = mIpCache.tryGetCopy(ip, info);
     if (isValid) {
+        if (ContainerInfoIsExpired(info)) {
+            AsyncQueryMetadata(PodInfoType::IpInfo, ipv);
+        }
         return info;
     }
     return nullptr;
 }
 
 bool K8sMetadata::IsExternalIp(const StringView& ip) const {
-    return mExternalIpCache.contains(std::string(ip));
+    return IsNegativeCached(mExternalIpCache, std::string(ip));
 }
 
 bool K8sMetadata::IsClusterIpForIPv4(uint32_t ip) const {
@@ -489,11 +543,19 @@ void K8sMetadata::AsyncQueryMetadata(PodInfoType type, const StringView& str) {
         return;
     }
     std::string key = std::string(str);
+    if (type == PodInfoType::IpInfo ? IsNegativeCached(mExternalIpCache, key) : IsMissingContainerId(key)) {
+        ADD_COUNTER(mNegativeCacheHitTotal, 1);
+        return;
+    }
     std::unique_lock<std::mutex> lock(mStateMux);
     if (mPendingKeys.find(key) != mPendingKeys.end()) {
         // already in query queue ...
         return;
     }
+    if (mPendingKeys.size() >= static_cast<size_t>(INT32_FLAG(k8s_metadata_max_pending_keys))) {
+        ADD_COUNTER(mDroppedQueryKeysTotal, 1);
+        return;
+    }
     mPendingKeys.insert(key);
     if (type == PodInfoType::IpInfo) {
         mBatchKeys.push_back(key);
@@ -523,6 +585,17 @@ void K8sMetadata::DetectNetwork() {
         SET_GAUGE(mCidCacheSize, mContainerCache.size());
         SET_GAUGE(mIpCacheSize, mIpCache.size());
         SET_GAUGE(mExternalIpCacheSize, mExternalIpCache.size());
+        SET_GAUGE(mMissingCidCacheSize, mMissingCidCache.size());
+        for (auto* cache : {&mContainerCache, &mIpCache}) {
+            auto stats = cache->collectStats();
+            ADD_COUNTER(mCacheHitTotal, stats.hits);
+            ADD_COUNTER(mCacheMissTotal, stats.misses);
+            ADD_COUNTER(mCacheEvictionTotal, stats.evictions);
+        }
+        {
+            std::lock_guard<std::mutex> stateLock(mStateMux);
+            SET_GAUGE(mPendingQueryKeys, mPendingKeys.size());
+        }
         if (mIsValid) {
             continue;
         }
@@ -558,21 +631,36 @@ void K8sMetadata::ProcessBatch() {
         }
     };
 
+    auto takeBatch = [](std::vector<std::string>& from, std::vector<std::string>& to) {
+        size_t maxSize = static_cast<size_t>(std::max(INT32_FLAG(k8s_metadata_max_batch_size), 1));
+        if (from.size() <= maxSize) {
+            to.swap(from);
+            return;
+        }
+        to.assign(std::make_move_iterator(from.begin()), std::make_move_iterator(from.begin() + maxSize));
+        from.erase(from.begin(), from.begin() + maxSize);
+    };
+
+    bool hasBacklog = false;
     while (mFlag) {
         std::vector<std::string> keysToProcess;
         std::vector<std::string> cidKeysToProcess;
         {
             std::unique_lock<std::mutex> lock(mStateMux);
-            // merge requests in 100ms
-            mCv.wait_for(lock, chrono::milliseconds(100));
+            // merge requests in 100ms, keys left by the last round are processed at once
+            if (!hasBacklog) {
+                mCv.wait_for(lock, chrono::milliseconds(100));
+            }
+            hasBacklog = false;
             if (!mFlag) {
                 break;
             }
             if (!mIsValid || (mBatchKeys.empty() && mBatchCids.empty())) {
                 continue;
             }
-            keysToProcess.swap(mBatchKeys);
-            cidKeysToProcess.swap(mBatchCids);
+            takeBatch(mBatchKeys, keysToProcess);
+            takeBatch(mBatchCids, cidKeysToProcess);
+            hasBacklog = !mBatchKeys.empty() || !mBatchCids.empty();
         }
 
         batchProcessor([this](auto&& items, bool& status) { GetByIpsFromServer(items, status); },
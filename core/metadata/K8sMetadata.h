@@ -55,11 +55,17 @@ using HostMetadataPostHandler = std::function<bool(uint32_t pluginIndex, std::ve
 
 struct K8sMetadataHttpRequest;
 
+// Entries of the pod caches are refreshed in background once older than k8s_metadata_cache_ttl, the stale entry is
+// still returned meanwhile. Ips and container ids unknown to the metadata server are kept in negative caches for
+// k8s_metadata_negative_cache_ttl, so that repeated misses do not query the server again. Each key is queried by at
+// most one request at a time, in batches of at most k8s_metadata_max_batch_size keys.
 class K8sMetadata {
 private:
-    lru11::Cache<std::string, std::shared_ptr<K8sPodInfo>, std::mutex> mIpCache;
-    lru11::Cache<std::string, std::shared_ptr<K8sPodInfo>, std::mutex> mContainerCache;
-    lru11::Cache<std::string, uint8_t, std::mutex> mExternalIpCache;
+    lru11::ShardedCache<std::string, std::shared_ptr<K8sPodInfo>> mIpCache;
+    lru11::ShardedCache<std::string, std::shared_ptr<K8sPodInfo>> mContainerCache;
+    // negative caches, key -> time when the server reported it as unknown
+    mutable lru11::ShardedCache<std::string, std::time_t> mExternalIpCache;
+    mutable lru11::ShardedCache<std::string, std::time_t> mMissingCidCache;
 
     std::string mServiceHost;
     int32_t mServicePort;
@@ -71,15 +77,24 @@ private:
     IntGaugePtr mExternalIpCacheSize;
     CounterPtr mRequestMetaServerTotal;
     CounterPtr mRequestMetaServerFailedTotal;
+    IntGaugePtr mMissingCidCacheSize;
+    IntGaugePtr mPendingQueryKeys;
+    CounterPtr mNegativeCacheHitTotal;
+    CounterPtr mDroppedQueryKeysTotal;
+    // lookups of the pod caches
+    CounterPtr mCacheHitTotal;
+    CounterPtr mCacheMissTotal;
+    CounterPtr mCacheEvictionTotal;
 
     void ProcessBatch();
 
     mutable std::mutex mStateMux;
-    std::unordered_set<std::string> mPendingKeys; // 增加上限
+    // keys queued or being queried, at most k8s_metadata_max_pending_keys
+    std::unordered_set<std::string> mPendingKeys;
 
     mutable std::condition_variable mCv;
-    std::vector<std::string> mBatchKeys; // 增加上限
-    std::vector<std::string> mBatchCids; // 增加上限
+    std::vector<std::string> mBatchKeys;
+    std::vector<std::string> mBatchCids;
     std::atomic_bool mEnable = false;
     bool mFlag = false;
     std::thread mQueryThread;
@@ -106,6 +121,9 @@ private:
     void SetContainerCache(const std::string& key, const std::shared_ptr<K8sPodInfo>& info);
     void SetExternalIpCache(const std::string&);
     void UpdateExternalIpCache(const std::vector<std::string>& queryIps, const std::vector<std::string>& retIps);
+    void UpdateMissingCidCache(const std::vector<std::string>& queryCids, const std::vector<std::string>& retCids);
+    bool IsMissingContainerId(const std::string& containerId) const;
+    static bool IsNegativeCached(lru11::ShardedCache<std::string, std::time_t>& cache, const std::string& key);
     bool FromInfoJson(const Json::Value& json, K8sPodInfo& info);
     bool FromContainerJson(const Json::Value& json, std::shared_ptr<ContainerData> data, PodInfoType infoType);
     void HandleMetadataResponse(PodInfoType infoType,
@@ -156,6 +174,8 @@ public:
     friend class K8sMetadataHttpRequest;
 #ifdef APSARA_UNIT_TEST_MAIN
     HttpRequest* mRequest;
+    // requests are only sent to a local stand-in server in tests
+    bool mSendRequestInUnitTest = false;
     friend class k8sMetadataUnittest;
     friend class ConnectionUnittest;
     friend class ConnectionManagerUnittest;
@@ -223,6 +223,12 @@ extern const std::string METRIC_PLUGIN_FLUSHER_SLS_PROJECT_QUOTA_ERROR_TOTAL;
 extern const std::string METRIC_PLUGIN_FLUSHER_SLS_SEQUENCE_ID_ERROR_TOTAL;
 extern const std::string METRIC_PLUGIN_FLUSHER_SLS_REQUEST_EXPRIRED_ERROR_TOTAL;
 
+/**********************************************************
+ *   flusher_kafka_native
+ **********************************************************/
+extern const std::string METRIC_PLUGIN_FLUSHER_KAFKA_OUT_QUEUE_MESSAGES;
+extern const std::string METRIC_PLUGIN_FLUSHER_KAFKA_TOTAL_DELIVERY_TIME_MS;
+
 //////////////////////////////////////////////////////////////////////////
 // component
 //////////////////////////////////////////////////////////////////////////
@@ -300,6 +306,7 @@ extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_PROMETHEUS;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_EBPF_SERVER;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_K8S_METADATA;
 extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_STATIC_FILE_SERVER;
+extern const std::string METRIC_LABEL_VALUE_RUNNER_NAME_CONTAINER_MANAGER;
 
 // metric keys
 extern const std::string& METRIC_RUNNER_IN_EVENTS_TOTAL;
@@ -340,12 +347,26 @@ extern const std::string METRIC_RUNNER_FILE_ENABLE_FILE_INCLUDED_BY_MULTI_CONFIG
 extern const std::string METRIC_RUNNER_FILE_POLLING_MODIFY_CACHE_SIZE;
 extern const std::string METRIC_RUNNER_FILE_POLLING_DIR_CACHE_SIZE;
 extern const std::string METRIC_RUNNER_FILE_POLLING_FILE_CACHE_SIZE;
+extern const std::string METRIC_RUNNER_FILE_CONFIG_UPDATE_TOTAL;
+extern const std::string METRIC_RUNNER_FILE_CONFIG_UPDATE_STALL_TIME_MS;
+extern const std::string METRIC_RUNNER_FILE_LAST_CONFIG_UPDATE_STALL_TIME_MS;
+extern const std::string METRIC_RUNNER_FILE_RAW_EVENTS_TOTAL;
+extern const std::string METRIC_RUNNER_FILE_COALESCED_EVENTS_TOTAL;
+extern const std::string METRIC_RUNNER_FILE_PENDING_EVENTS_TOTAL;
 
 /**********************************************************
  *   static file server
  **********************************************************/
 extern const std::string METRIC_RUNNER_STATIC_FILE_SERVER_ACTIVE_INPUTS_COUNT;
 
+/**********************************************************
+ *   container manager
+ **********************************************************/
+extern const std::string METRIC_RUNNER_CONTAINER_EVENTS_TOTAL;
+extern const std::string METRIC_RUNNER_CONTAINER_DISCOVERED_CONTAINERS_TOTAL;
+extern const std::string METRIC_RUNNER_CONTAINER_DISCOVERY_LATENCY_MS;
+extern const std::string METRIC_RUNNER_CONTAINER_LAST_DISCOVERY_LATENCY_MS;
+
 /**********************************************************
  *   ebpf server
  **********************************************************/
@@ -359,6 +380,10 @@ extern const std::string METRIC_RUNNER_EBPF_POLL_KERNEL_EVENTS_TOTAL;
 extern const std::string METRIC_RUNNER_EBPF_LOST_KERNEL_EVENTS_TOTAL;
 extern const std::string METRIC_RUNNER_EBPF_CONNECTION_CACHE_SIZE;
 extern const std::string METRIC_RUNNER_EBPF_LOST_LOG_EVENTS_TOTAL;
+extern const std::string METRIC_RUNNER_EBPF_TAIL_SAMPLER_BUFFERED_SPANS;
+extern const std::string METRIC_RUNNER_EBPF_TAIL_SAMPLER_KEPT_SPANS_TOTAL;
+extern const std::string METRIC_RUNNER_EBPF_TAIL_SAMPLER_DROPPED_SPANS_TOTAL;
+extern const std::string METRIC_RUNNER_EBPF_TAIL_SAMPLER_DECISION_TIME_MS;
 
 /**********************************************************
  *   k8s metadata
@@ -368,6 +393,13 @@ extern const std::string METRIC_RUNNER_METADATA_IP_CACHE_SIZE;
 extern const std::string METRIC_RUNNER_METADATA_EXTERNAL_IP_CACHE_SIZE;
 extern const std::string METRIC_RUNNER_METADATA_REQUEST_REMOTE_TOTAL;
 extern const std::string METRIC_RUNNER_METADATA_REQUEST_REMOTE_FAILED_TOTAL;
+extern const std::string METRIC_RUNNER_METADATA_MISSING_CID_CACHE_SIZE;
+extern const std::string METRIC_RUNNER_METADATA_PENDING_QUERY_KEYS;
+extern const std::string METRIC_RUNNER_METADATA_NEGATIVE_CACHE_HIT_TOTAL;
+extern const std::string METRIC_RUNNER_METADATA_DROPPED_QUERY_KEYS_TOTAL;
+extern const std::string METRIC_RUNNER_METADATA_CACHE_HIT_TOTAL;
+extern const std::string METRIC_RUNNER_METADATA_CACHE_MISS_TOTAL;
+extern const std::string METRIC_RUNNER_METADATA_CACHE_EVICTION_TOTAL;
 
 /**********************************************************
  *   timer
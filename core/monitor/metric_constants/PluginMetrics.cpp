@@ -170,4 +170,10 @@ const string METRIC_PLUGIN_FLUSHER_SLS_PROJECT_QUOTA_ERROR_TOTAL = "project_quot
 const string METRIC_PLUGIN_FLUSHER_SLS_SEQUENCE_ID_ERROR_TOTAL = "sequence_id_error_total";
 const string METRIC_PLUGIN_FLUSHER_SLS_REQUEST_EXPRIRED_ERROR_TOTAL = "request_exprired_error_total";
 
+/**********************************************************
+ *   flusher_kafka_native
+ **********************************************************/
+const string METRIC_PLUGIN_FLUSHER_KAFKA_OUT_QUEUE_MESSAGES = "out_queue_messages";
+const string METRIC_PLUGIN_FLUSHER_KAFKA_TOTAL_DELIVERY_TIME_MS = "total_delivery_time_ms";
+
 } // namespace logtail
@@ -32,6 +32,7 @@ const string METRIC_LABEL_VALUE_RUNNER_NAME_PROMETHEUS = "prometheus_runner";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_EBPF_SERVER = "ebpf_runner";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_K8S_METADATA = "k8s_metadata_runner";
 const string METRIC_LABEL_VALUE_RUNNER_NAME_STATIC_FILE_SERVER = "static_file_server";
+const string METRIC_LABEL_VALUE_RUNNER_NAME_CONTAINER_MANAGER = "container_manager";
 
 // metric keys
 const string& METRIC_RUNNER_IN_EVENTS_TOTAL = METRIC_IN_EVENTS_TOTAL;
@@ -72,12 +73,26 @@ const string METRIC_RUNNER_FILE_ENABLE_FILE_INCLUDED_BY_MULTI_CONFIGS_FLAG = "en
 const string METRIC_RUNNER_FILE_POLLING_MODIFY_CACHE_SIZE = "polling_modify_cache_size";
 const string METRIC_RUNNER_FILE_POLLING_DIR_CACHE_SIZE = "polling_dir_cache_size";
 const string METRIC_RUNNER_FILE_POLLING_FILE_CACHE_SIZE = "polling_file_cache_size";
+const string METRIC_RUNNER_FILE_CONFIG_UPDATE_TOTAL = "config_update_total";
+const string METRIC_RUNNER_FILE_CONFIG_UPDATE_STALL_TIME_MS = "config_update_stall_time_ms";
+const string METRIC_RUNNER_FILE_LAST_CONFIG_UPDATE_STALL_TIME_MS = "last_config_update_stall_time_ms";
+const string METRIC_RUNNER_FILE_RAW_EVENTS_TOTAL = "raw_events_total";
+const string METRIC_RUNNER_FILE_COALESCED_EVENTS_TOTAL = "coalesced_events_total";
+const string METRIC_RUNNER_FILE_PENDING_EVENTS_TOTAL = "pending_events_total";
 
 /**********************************************************
  *   static file server
  **********************************************************/
 const string METRIC_RUNNER_STATIC_FILE_SERVER_ACTIVE_INPUTS_COUNT = "active_inputs_count";
 
+/**********************************************************
+ *   container manager
+ **********************************************************/
+const string METRIC_RUNNER_CONTAINER_EVENTS_TOTAL = "container_events_total";
+const string METRIC_RUNNER_CONTAINER_DISCOVERED_CONTAINERS_TOTAL = "discovered_containers_total";
+const string METRIC_RUNNER_CONTAINER_DISCOVERY_LATENCY_MS = "container_discovery_latency_ms";
+const string METRIC_RUNNER_CONTAINER_LAST_DISCOVERY_LATENCY_MS = "last_container_discovery_latency_ms";
+
 /**********************************************************
  *   ebpf server
  **********************************************************/
@@ -91,6 +106,10 @@ const string METRIC_RUNNER_EBPF_POLL_KERNEL_EVENTS_TOTAL = "poll_kernel_event_to
 const string METRIC_RUNNER_EBPF_LOST_KERNEL_EVENTS_TOTAL = "lost_kernel_event_total";
 const string METRIC_RUNNER_EBPF_CONNECTION_CACHE_SIZE = "connection_cache_size";
 const string METRIC_RUNNER_EBPF_LOST_LOG_EVENTS_TOTAL = "lost_log_event_total";
+const string METRIC_RUNNER_EBPF_TAIL_SAMPLER_BUFFERED_SPANS = "tail_sampler_buffered_spans";
+const string METRIC_RUNNER_EBPF_TAIL_SAMPLER_KEPT_SPANS_TOTAL = "tail_sampler_kept_spans_total";
+const string METRIC_RUNNER_EBPF_TAIL_SAMPLER_DROPPED_SPANS_TOTAL = "tail_sampler_dropped_spans_total";
+const string METRIC_RUNNER_EBPF_TAIL_SAMPLER_DECISION_TIME_MS = "tail_sampler_decision_time_ms";
 
 /**********************************************************
  *   k8s metadata
@@ -100,6 +119,13 @@ const string METRIC_RUNNER_METADATA_IP_CACHE_SIZE = "ip_cache_size";
 const string METRIC_RUNNER_METADATA_EXTERNAL_IP_CACHE_SIZE = "external_ip_cache_size";
 const string METRIC_RUNNER_METADATA_REQUEST_REMOTE_TOTAL = "request_metadata_server_total";
 const string METRIC_RUNNER_METADATA_REQUEST_REMOTE_FAILED_TOTAL = "request_metadata_server_failed_total";
+const string METRIC_RUNNER_METADATA_MISSING_CID_CACHE_SIZE = "missing_cid_cache_size";
+const string METRIC_RUNNER_METADATA_PENDING_QUERY_KEYS = "pending_query_keys";
+const string METRIC_RUNNER_METADATA_NEGATIVE_CACHE_HIT_TOTAL = "negative_cache_hit_total";
+const string METRIC_RUNNER_METADATA_DROPPED_QUERY_KEYS_TOTAL = "dropped_query_keys_total";
+const string METRIC_RUNNER_METADATA_CACHE_HIT_TOTAL = "cache_hit_total";
+const string METRIC_RUNNER_METADATA_CACHE_MISS_TOTAL = "cache_miss_total";
+const string METRIC_RUNNER_METADATA_CACHE_EVICTION_TOTAL = "cache_eviction_total";
 
 
 } // namespace logtail
@@ -0,0 +1,255 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/flusher/file/BufferedFileWriter.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(_MSC_VER)
+#include <io.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+
+#include "common/ErrorUtil.h"
+#include "common/FileSystemUtil.h"
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+
+BufferedFileWriter::BufferedFileWriter(const string& filePath,
+                                       uint32_t maxFileSize,
+                                       uint32_t maxFiles,
+                                       uint32_t bufferSize,
+                                       uint32_t flushIntervalMs,
+                                       uint32_t syncIntervalSecs)
+    : mFilePath(filePath),
+      mMaxFileSize(maxFileSize),
+      mMaxFiles(maxFiles),
+      mBufferSize(max(bufferSize, 1U)),
+      mFlushInterval(max(flushIntervalMs, 1U)),
+      mSyncInterval(syncIntervalSecs) {
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+    Stop();
+}
+
+bool BufferedFileWriter::Start(string& errorMsg) {
+    if (mMaxFileSize == 0) {
+        errorMsg = "param MaxFileSize must be greater than 0";
+        return false;
+    }
+    error_code ec;
+    filesystem::path path(mFilePath);
+    if (path.has_parent_path()) {
+        filesystem::create_directories(path.parent_path(), ec);
+    }
+    // the same as spdlog's rotating file sink with rotate_on_open
+    if (filesystem::exists(path, ec) && filesystem::file_size(path, ec) > 0) {
+        Rotate();
+    }
+    if (!OpenFile()) {
+        errorMsg = "failed to open file " + mFilePath + ": " + ErrnoToString(GetErrno());
+        return false;
+    }
+    mBuffer.reserve(mBufferSize);
+    mWritingBuffer.reserve(mBufferSize);
+    mLastSyncTime = chrono::steady_clock::now();
+    mIsRunning = true;
+    mThreadRes = async(launch::async, &BufferedFileWriter::Run, this);
+    return true;
+}
+
+void BufferedFileWriter::Stop() {
+    {
+        lock_guard<mutex> lock(mMux);
+        if (!mIsRunning) {
+            return;
+        }
+        mIsRunning = false;
+    }
+    mFlushCV.notify_one();
+    mWritableCV.notify_all();
+    mThreadRes.get();
+}
+
+void BufferedFileWriter::Write(const string& line) {
+    {
+        unique_lock<mutex> lock(mMux);
+        mWritableCV.wait(lock, [this]() { return mBuffer.size() < mBufferSize || !mIsRunning; });
+        if (!mIsRunning) {
+            LOG_WARNING(sLogger,
+                        ("failed to write to file", "writer stopped")("action", "discard data")("file", mFilePath));
+            return;
+        }
+        mBuffer.append(line).push_back('\n');
+        if (mBuffer.size() < mBufferSize) {
+            return;
+        }
+    }
+    mFlushCV.notify_one();
+}
+
+void BufferedFileWriter::Flush() {
+    {
+        lock_guard<mutex> lock(mMux);
+        mFlushRequested = true;
+    }
+    mFlushCV.notify_one();
+}
+
+void BufferedFileWriter::Run() {
+    LOG_INFO(sLogger, ("buffered file writer", "started")("file", mFilePath));
+    bool isRunning = true;
+    while (isRunning) {
+        {
+            unique_lock<mutex> lock(mMux);
+            mFlushCV.wait_for(lock, mFlushInterval, [this]() {
+                return mBuffer.size() >= mBufferSize || mFlushRequested || !mIsRunning;
+            });
+            mWritingBuffer.swap(mBuffer);
+            mFlushRequested = false;
+            isRunning = mIsRunning;
+        }
+        mWritableCV.notify_all();
+        if (!mWritingBuffer.empty()) {
+            WriteToFile(mWritingBuffer);
+            mWritingBuffer.clear();
+        }
+        if (mSyncInterval.count() > 0 && mHasUnsyncedData
+            && (!isRunning || chrono::steady_clock::now() - mLastSyncTime >= mSyncInterval)) {
+            Sync();
+        }
+    }
+    if (mFile != nullptr) {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+    LOG_INFO(sLogger, ("buffered file writer", "stopped")("file", mFilePath));
+}
+
+void BufferedFileWriter::WriteToFile(const string& data) {
+    if (mFile == nullptr && !OpenFile()) {
+        LOG_ERROR(sLogger,
+                  ("failed to open file", ErrnoToString(GetErrno()))("action", "discard data")("file", mFilePath)(
+                      "size", data.size()));
+        return;
+    }
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t len = data.size() - pos;
+        if (mFileSize + len > mMaxFileSize) {
+            // write the lines that fit into the current file, and rotate before a line that does not fit, unless the
+            // line alone exceeds the max file size
+            size_t end = string::npos;
+            if (mFileSize < mMaxFileSize) {
+                end = data.rfind('\n', pos + mMaxFileSize - mFileSize - 1);
+            }
+            if (end != string::npos && end >= pos) {
+                len = end + 1 - pos;
+            } else if (mFileSize > 0) {
+                Rotate();
+                if (!OpenFile()) {
+                    LOG_ERROR(sLogger,
+                              ("failed to open file", ErrnoToString(GetErrno()))("action", "discard data")(
+                                  "file", mFilePath)("size", data.size() - pos));
+                    return;
+                }
+                continue;
+            } else {
+                end = data.find('\n', pos);
+                len = (end == string::npos ? data.size() : end + 1) - pos;
+            }
+        }
+        if (fwrite(data.data() + pos, 1, len, mFile) != len) {
+            LOG_ERROR(sLogger,
+                      ("failed to write to file", ErrnoToString(GetErrno()))("action", "discard data")(
+                          "file", mFilePath)("size", len));
+        }
+        mFileSize += len;
+        pos += len;
+    }
+    mHasUnsyncedData = true;
+}
+
+bool BufferedFileWriter::OpenFile() {
+    mFile = FileWriteOnlyOpen(mFilePath.c_str(), "wb");
+    mFileSize = 0;
+    if (mFile == nullptr) {
+        return false;
+    }
+    // data is already buffered
+    setvbuf(mFile, nullptr, _IONBF, 0);
+    return true;
+}
+
+void BufferedFileWriter::Rotate() {
+    if (mFile != nullptr) {
+        if (mSyncInterval.count() > 0 && mHasUnsyncedData) {
+            Sync();
+        }
+        fclose(mFile);
+        mFile = nullptr;
+    }
+    error_code ec;
+    for (uint32_t i = mMaxFiles; i > 0; --i) {
+        string src = GetRotatedFileName(i - 1);
+        if (!filesystem::exists(src, ec)) {
+            continue;
+        }
+        string target = GetRotatedFileName(i);
+        filesystem::remove(target, ec);
+        filesystem::rename(src, target, ec);
+        if (ec) {
+            LOG_WARNING(sLogger, ("failed to rotate file", ec.message())("from", src)("to", target));
+        }
+    }
+}
+
+void BufferedFileWriter::Sync() {
+    if (mFile == nullptr) {
+        return;
+    }
+#if defined(__linux__)
+    if (fdatasync(fileno(mFile)) != 0) {
+#elif defined(_MSC_VER)
+    if (_commit(_fileno(mFile)) != 0) {
+#endif
+        LOG_WARNING(sLogger, ("failed to sync file", ErrnoToString(GetErrno()))("file", mFilePath));
+    }
+    mHasUnsyncedData = false;
+    mLastSyncTime = chrono::steady_clock::now();
+}
+
+// the same as spdlog::sinks::rotating_file_sink::calc_filename
+string BufferedFileWriter::GetRotatedFileName(uint32_t index) const {
+    if (index == 0) {
+        return mFilePath;
+    }
+    size_t extPos = mFilePath.rfind('.');
+    size_t dirPos = mFilePath.find_last_of("/\\");
+    if (extPos == string::npos || extPos == 0 || extPos == mFilePath.size() - 1
+        || (dirPos != string::npos && dirPos >= extPos - 1)) {
+        return mFilePath + "." + to_string(index);
+    }
+    return mFilePath.substr(0, extPos) + "." + to_string(index) + mFilePath.substr(extPos);
+}
+
+} // namespace logtail
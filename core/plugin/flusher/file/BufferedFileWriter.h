@@ -0,0 +1,86 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+
+namespace logtail {
+
+// Appends lines to a file with size-based rotation, named the same as spdlog's rotating file sink, i.e. a.log is
+// rotated to a.1.log, a.1.log to a.2.log, and so on.
+// Lines are appended to an in-memory buffer and written by a dedicated thread in large writes, either when the buffer
+// is full or every flush interval, so that callers do not make a syscall for each line. Callers are blocked when the
+// buffer is full and the previous buffer is still being written. The file is synced by fdatasync every sync interval
+// if it is not 0.
+class BufferedFileWriter {
+public:
+    BufferedFileWriter(const std::string& filePath,
+                       uint32_t maxFileSize,
+                       uint32_t maxFiles,
+                       uint32_t bufferSize,
+                       uint32_t flushIntervalMs,
+                       uint32_t syncIntervalSecs);
+    ~BufferedFileWriter();
+
+    bool Start(std::string& errorMsg);
+    void Stop();
+    void Write(const std::string& line);
+    void Flush();
+
+private:
+    void Run();
+    void WriteToFile(const std::string& data);
+    bool OpenFile();
+    void Rotate();
+    void Sync();
+    std::string GetRotatedFileName(uint32_t index) const;
+
+    const std::string mFilePath;
+    const uint32_t mMaxFileSize;
+    const uint32_t mMaxFiles;
+    const size_t mBufferSize;
+    const std::chrono::milliseconds mFlushInterval;
+    const std::chrono::seconds mSyncInterval;
+
+    std::mutex mMux;
+    std::condition_variable mFlushCV;
+    std::condition_variable mWritableCV;
+    std::string mBuffer;
+    bool mFlushRequested = false;
+    bool mIsRunning = false;
+    std::future<void> mThreadRes;
+
+    // accessed only by the writing thread after started
+    std::string mWritingBuffer;
+    FILE* mFile = nullptr;
+    size_t mFileSize = 0;
+    bool mHasUnsyncedData = false;
+    std::chrono::steady_clock::time_point mLastSyncTime;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class BufferedFileWriterUnittest;
+#endif
+};
+
+} // namespace logtail
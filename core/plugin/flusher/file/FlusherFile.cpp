@@ -42,23 +42,91 @@ bool FlusherFile::Init(const Json::Value& config, [[maybe_unused]] Json::Value&
     // MaxFiles
     GetMandatoryUIntParam(config, "MaxFiles", mMaxFiles, errorMsg);
 
-    // create file writer
-    mThreadPool = std::make_shared<spdlog::details::thread_pool>(10, 1);
-    try {
-        mFileSink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(mFilePath, mMaxFileSize, mMaxFiles, true);
-    } catch (const spdlog::spdlog_ex& e) {
-        PARAM_ERROR_RETURN(mContext->GetLogger(),
-                           mContext->GetAlarm(),
-                           e.what(),
-                           sName,
-                           mContext->GetConfigName(),
-                           mContext->GetProjectName(),
-                           mContext->GetLogstoreName(),
-                           mContext->GetRegion());
+    // EnableBufferedWrite
+    if (!GetOptionalBoolParam(config, "EnableBufferedWrite", mEnableBufferedWrite, errorMsg)) {
+        PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                              mContext->GetAlarm(),
+                              errorMsg,
+                              mEnableBufferedWrite,
+                              sName,
+                              mContext->GetConfigName(),
+                              mContext->GetProjectName(),
+                              mContext->GetLogstoreName(),
+                              mContext->GetRegion());
+    }
+
+    if (mEnableBufferedWrite) {
+        // BufferSizeBytes
+        if (!GetOptionalUIntParam(config, "BufferSizeBytes", mBufferSizeBytes, errorMsg)) {
+            PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                                  mContext->GetAlarm(),
+                                  errorMsg,
+                                  mBufferSizeBytes,
+                                  sName,
+                                  mContext->GetConfigName(),
+                                  mContext->GetProjectName(),
+                                  mContext->GetLogstoreName(),
+                                  mContext->GetRegion());
+        }
+
+        // FlushIntervalMs
+        if (!GetOptionalUIntParam(config, "FlushIntervalMs", mFlushIntervalMs, errorMsg)) {
+            PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                                  mContext->GetAlarm(),
+                                  errorMsg,
+                                  mFlushIntervalMs,
+                                  sName,
+                                  mContext->GetConfigName(),
+                                  mContext->GetProjectName(),
+                                  mContext->GetLogstoreName(),
+                                  mContext->GetRegion());
+        }
+
+        // FdatasyncIntervalSecs
+        if (!GetOptionalUIntParam(config, "FdatasyncIntervalSecs", mFdatasyncIntervalSecs, errorMsg)) {
+            PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                                  mContext->GetAlarm(),
+                                  errorMsg,
+                                  mFdatasyncIntervalSecs,
+                                  sName,
+                                  mContext->GetConfigName(),
+                                  mContext->GetProjectName(),
+                                  mContext->GetLogstoreName(),
+                                  mContext->GetRegion());
+        }
+
+        mBufferedWriter = make_unique<BufferedFileWriter>(
+            mFilePath, mMaxFileSize, mMaxFiles, mBufferSizeBytes, mFlushIntervalMs, mFdatasyncIntervalSecs);
+        if (!mBufferedWriter->Start(errorMsg)) {
+            PARAM_ERROR_RETURN(mContext->GetLogger(),
+                               mContext->GetAlarm(),
+                               errorMsg,
+                               sName,
+                               mContext->GetConfigName(),
+                               mContext->GetProjectName(),
+                               mContext->GetLogstoreName(),
+                               mContext->GetRegion());
+        }
+    } else {
+        // create file writer
+        mThreadPool = std::make_shared<spdlog::details::thread_pool>(10, 1);
+        try {
+            mFileSink
+                = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(mFilePath, mMaxFileSize, mMaxFiles, true);
+        } catch (const spdlog::spdlog_ex& e) {
+            PARAM_ERROR_RETURN(mContext->GetLogger(),
+                               mContext->GetAlarm(),
+                               e.what(),
+                               sName,
+                               mContext->GetConfigName(),
+                               mContext->GetProjectName(),
+                               mContext->GetLogstoreName(),
+                               mContext->GetRegion());
+        }
+        mFileWriter = std::make_shared<spdlog::async_logger>(
+            sName, mFileSink, mThreadPool, spdlog::async_overflow_policy::block);
+        mFileWriter->set_pattern("%v");
     }
-    mFileWriter
-        = std::make_shared<spdlog::async_logger>(sName, mFileSink, mThreadPool, spdlog::async_overflow_policy::block);
-    mFileWriter->set_pattern("%v");
 
     mGroupSerializer = make_unique<JsonEventGroupSerializer>(this);
     mSendCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_OUT_EVENT_GROUPS_TOTAL);
@@ -68,6 +136,13 @@ bool FlusherFile::Init(const Json::Value& config, [[maybe_unused]] Json::Value&
     return true;
 }
 
+bool FlusherFile::Stop(bool isPipelineRemoving) {
+    if (mBufferedWriter) {
+        mBufferedWriter->Stop();
+    }
+    return Flusher::Stop(isPipelineRemoving);
+}
+
 bool FlusherFile::Send(PipelineEventGroup&& g) {
     return SerializeAndPush(std::move(g));
 }
@@ -77,6 +152,9 @@ bool FlusherFile::Flush([[maybe_unused]] size_t key) {
 }
 
 bool FlusherFile::FlushAll() {
+    if (mBufferedWriter) {
+        mBufferedWriter->Flush();
+    }
     return true;
 }
 
@@ -96,8 +174,12 @@ bool FlusherFile::SerializeAndPush(PipelineEventGroup&& group) {
         if (!serializedData.empty() && serializedData.back() == '\n') {
             serializedData.pop_back();
         }
-        mFileWriter->info(serializedData);
-        mFileWriter->flush();
+        if (mBufferedWriter) {
+            mBufferedWriter->Write(serializedData);
+        } else {
+            mFileWriter->info(serializedData);
+            mFileWriter->flush();
+        }
     } else {
         LOG_ERROR(sLogger, ("serialize pipeline event group error", errorMsg));
     }
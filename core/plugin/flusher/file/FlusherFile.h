@@ -25,6 +25,7 @@
 #include "collection_pipeline/batch/Batcher.h"
 #include "collection_pipeline/plugin/interface/Flusher.h"
 #include "collection_pipeline/serializer/JsonSerializer.h"
+#include "plugin/flusher/file/BufferedFileWriter.h"
 
 namespace logtail {
 
@@ -34,6 +35,7 @@ public:
 
     const std::string& Name() const override { return sName; }
     bool Init(const Json::Value& config, Json::Value& optionalGoPipeline) override;
+    bool Stop(bool isPipelineRemoving) override;
     bool Send(PipelineEventGroup&& g) override;
     bool Flush(size_t key) override;
     bool FlushAll() override;
@@ -47,6 +49,11 @@ private:
     std::string mFilePath;
     uint32_t mMaxFileSize = 1024 * 1024 * 10;
     uint32_t mMaxFiles = 10;
+    bool mEnableBufferedWrite = false;
+    uint32_t mBufferSizeBytes = 1024 * 1024;
+    uint32_t mFlushIntervalMs = 1000;
+    uint32_t mFdatasyncIntervalSecs = 0;
+    std::unique_ptr<BufferedFileWriter> mBufferedWriter;
     std::unique_ptr<EventGroupSerializer> mGroupSerializer;
 
     CounterPtr mSendCnt;
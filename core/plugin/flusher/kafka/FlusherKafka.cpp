@@ -16,14 +16,21 @@
 
 #include "plugin/flusher/kafka/FlusherKafka.h"
 
+#include <chrono>
 #include <cstring>
 
+#include <algorithm>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "collection_pipeline/CollectionPipeline.h"
 #include "collection_pipeline/batch/BatchedEvents.h"
 #include "collection_pipeline/queue/SenderQueueManager.h"
+#include "common/Flags.h"
 #include "common/ParamExtractor.h"
+#include "common/StringTools.h"
 #include "common/StringView.h"
 #include "logger/Logger.h"
 #include "models/LogEvent.h"
@@ -32,10 +39,23 @@
 #include "monitor/metric_constants/MetricConstants.h"
 #include "plugin/flusher/kafka/KafkaConstant.h"
 
+DECLARE_FLAG_INT32(discard_send_fail_interval);
+
 using namespace std;
 
 namespace logtail {
 
+static bool IsRetriable(KafkaProducer::ErrorType type) {
+    switch (type) {
+        case KafkaProducer::ErrorType::QUEUE_FULL:
+        case KafkaProducer::ErrorType::NETWORK_ERROR:
+        case KafkaProducer::ErrorType::SERVER_ERROR:
+            return true;
+        default:
+            return false;
+    }
+}
+
 const std::string FlusherKafka::sName = "flusher_kafka_native";
 
 FlusherKafka::FlusherKafka() : mProducer(std::make_unique<KafkaProducer>()) {
@@ -110,7 +130,15 @@ bool FlusherKafka::Init(const Json::Value& config, Json::Value& optionalGoPipeli
 
     mExpandedTopic = mTopicFormatter.GetTemplate();
     GenerateQueueKey(mExpandedTopic);
-    SenderQueueManager::GetInstance()->CreateQueue(mQueueKey, mPluginID, mExpandedTopic, *mContext);
+    // the concurrency shrinks when deliveries fail, e.g. when brokers are overloaded
+    mConcurrencyLimiter = make_shared<ConcurrencyLimiter>(sName + "#quota#topic#" + mExpandedTopic,
+                                                          AppConfig::GetInstance()->GetSendRequestConcurrency());
+    SenderQueueManager::GetInstance()->CreateQueue(mQueueKey,
+                                                   mPluginID,
+                                                   mExpandedTopic,
+                                                   *mContext,
+                                                   {{"topic", mConcurrencyLimiter}},
+                                                   mKafkaConfig.MaxSendRate);
 
     mSendCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_OUT_EVENT_GROUPS_TOTAL);
     mSuccessCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_SUCCESS_TOTAL);
@@ -121,6 +149,9 @@ bool FlusherKafka::Init(const Json::Value& config, Json::Value& optionalGoPipeli
     mUnauthErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_UNAUTH_ERROR_TOTAL);
     mParamsErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_PARAMS_ERROR_TOTAL);
     mOtherErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_OTHER_ERROR_TOTAL);
+    mRetryCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_RETRY_TOTAL);
+    mOutQueueMessages = GetMetricsRecordRef().CreateIntGauge(METRIC_PLUGIN_FLUSHER_KAFKA_OUT_QUEUE_MESSAGES);
+    mTotalDeliveryTimeMs = GetMetricsRecordRef().CreateTimeCounter(METRIC_PLUGIN_FLUSHER_KAFKA_TOTAL_DELIVERY_TIME_MS);
 
     LOG_INFO(mContext->GetLogger(),
              ("FlusherKafka initialized successfully", "")("configured_topic", mKafkaConfig.Topic)(
@@ -135,6 +166,11 @@ bool FlusherKafka::Start() {
 }
 
 bool FlusherKafka::Stop(bool isPipelineRemoving) {
+    // items in the sender queue can only be sent before the producer is closed, those left are discarded then
+    {
+        unique_lock<mutex> lock(mItemCntMux);
+        mItemCntCond.wait_for(lock, chrono::milliseconds(KAFKA_FLUSH_TIMEOUT_MS), [this]() { return mItemCnt == 0; });
+    }
     if (mProducer) {
         mProducer->Close();
     }
@@ -142,7 +178,7 @@ bool FlusherKafka::Stop(bool isPipelineRemoving) {
 }
 
 bool FlusherKafka::Send(PipelineEventGroup&& g) {
-    return SerializeAndSend(std::move(g));
+    return SerializeAndPush(std::move(g));
 }
 
 bool FlusherKafka::Flush(size_t key) {
@@ -156,76 +192,231 @@ bool FlusherKafka::FlushAll() {
     return Flush(0);
 }
 
-bool FlusherKafka::SerializeAndSend(PipelineEventGroup&& group) {
+bool FlusherKafka::SerializeAndPush(PipelineEventGroup&& group) {
     if (!mProducer) {
         LOG_ERROR(mContext->GetLogger(), ("kafka producer not initialized", ""));
         return false;
     }
 
-    auto events = std::move(group.MutableEvents());
+    BatchedEvents batchedEvents;
+    batchedEvents.mEvents = std::move(group.MutableEvents());
+    if (batchedEvents.mEvents.empty()) {
+        return true;
+    }
+    batchedEvents.mTags = std::move(group.GetSizedTags());
+    batchedEvents.mSourceBuffers.emplace_back(group.GetSourceBuffer());
+    batchedEvents.mExactlyOnceCheckpoint = group.GetExactlyOnceCheckpoint();
+
+    // all events of the group are serialized into one payload, and each message is a slice of it
+    auto payload = std::make_shared<std::string>();
+    payload->reserve(mLastPayloadSize.load(std::memory_order_relaxed));
+    std::vector<size_t> offsets;
+    offsets.reserve(batchedEvents.mEvents.size());
+    std::string errorMsg;
+    if (!mSerializer->DoSerializeEach(batchedEvents, *payload, offsets, errorMsg)) {
+        LOG_ERROR(mContext->GetLogger(),
+                  ("failed to serialize events", errorMsg)("topic", mExpandedTopic)("action", "discard data"));
+        mContext->GetAlarm().SendAlarmCritical(SERIALIZE_FAIL_ALARM,
+                                               "failed to serialize events: " + errorMsg + "\taction: discard data",
+                                               mContext->GetRegion(),
+                                               mContext->GetProjectName(),
+                                               mContext->GetConfigName(),
+                                               mContext->GetLogstoreName());
+        mDiscardCnt->Add(batchedEvents.mEvents.size());
+        return false;
+    }
+    mLastPayloadSize.store(payload->size(), std::memory_order_relaxed);
 
+    // messages are grouped by topic, so that each topic is looked up once for the group
     const bool isDynamicTopic = mTopicFormatter.IsDynamic();
-    const auto& sizedTags = group.GetSizedTags();
-    auto& sourceBuffer = group.GetSourceBuffer();
-    auto& checkpoint = group.GetExactlyOnceCheckpoint();
+    std::vector<KafkaTopicMessages> topicMessages;
+    std::unordered_map<std::string, size_t> topicIndexMap;
+    if (!isDynamicTopic) {
+        topicMessages.push_back({mExpandedTopic, {}});
+    }
+    size_t messageCnt = 0;
+    std::string topic;
+    size_t discardCnt = 0;
+    size_t begin = 0;
+    for (size_t i = 0; i < batchedEvents.mEvents.size(); ++i) {
+        const auto& event = batchedEvents.mEvents[i];
+        size_t end = offsets[i];
+        if (end == begin) {
+            // skipped by the serializer, e.g. empty events
+            ++discardCnt;
+            continue;
+        }
+        KafkaProducer::BatchMessage message{begin, end - begin, std::string()};
+        begin = end;
+        if (mKafkaConfig.PartitionerType == PARTITIONER_HASH) {
+            message.key = GeneratePartitionKey(event);
+        }
+        ++messageCnt;
+        if (!isDynamicTopic) {
+            topicMessages[0].mMessages.emplace_back(std::move(message));
+            continue;
+        }
+        if (!mTopicFormatter.Format(event, batchedEvents.mTags.mInner, topic)) {
+            topic = mExpandedTopic;
+            LOG_ERROR(mContext->GetLogger(), ("Failed to format dynamic topic from template", mExpandedTopic));
+        }
+        auto res = topicIndexMap.try_emplace(topic, topicMessages.size());
+        if (res.second) {
+            topicMessages.push_back({topic, {}});
+        }
+        topicMessages[res.first->second].mMessages.emplace_back(std::move(message));
+    }
 
-    bool allSuccess = true;
-    std::string serializedData;
-    std::string errorMsg;
+    if (discardCnt > 0) {
+        LOG_ERROR(mContext->GetLogger(),
+                  ("failed to serialize events", "empty events")("count", discardCnt)("action", "discard data"));
+        mContext->GetAlarm().SendAlarmCritical(SERIALIZE_FAIL_ALARM,
+                                               "failed to serialize events: empty events\taction: discard data",
+                                               mContext->GetRegion(),
+                                               mContext->GetProjectName(),
+                                               mContext->GetConfigName(),
+                                               mContext->GetLogstoreName());
+        mDiscardCnt->Add(discardCnt);
+    }
 
-    for (auto& event : events) {
-        errorMsg.clear();
-        serializedData.clear();
+    if (messageCnt == 0) {
+        return discardCnt == 0;
+    }
+    // the item is removed from the sender queue once all messages are delivered, so that a slow broker holds back
+    // the process queue instead of piling messages up in the producer
+    auto item = make_unique<KafkaSenderQueueItem>(std::move(payload),
+                                                  std::move(topicMessages),
+                                                  this,
+                                                  mQueueKey,
+                                                  std::move(batchedEvents.mExactlyOnceCheckpoint));
+    {
+        lock_guard<mutex> lock(mItemCntMux);
+        ++mItemCnt;
+    }
+    if (!PushToQueue(std::move(item))) {
+        DecreaseItemCnt();
+        mDiscardCnt->Add(messageCnt);
+        return false;
+    }
+    return discardCnt == 0;
+}
 
-        std::string topic = mExpandedTopic;
-        if (isDynamicTopic) {
-            if (!mTopicFormatter.Format(event, group.GetTags(), topic)) {
-                topic = mExpandedTopic;
-                LOG_ERROR(mContext->GetLogger(), ("Failed to format dynamic topic from template", mExpandedTopic));
-            }
+bool FlusherKafka::SendItem(SenderQueueItem* item) {
+    auto* data = static_cast<KafkaSenderQueueItem*>(item);
+    data->mLastSendTime = chrono::system_clock::now();
+    {
+        lock_guard<mutex> lock(data->mMux);
+        // one more for the sending itself, so that the item is not done before all messages are produced
+        data->mInflightCnt = data->GetMessageCount() + 1;
+        data->mRetryMessages.clear();
+    }
+    for (size_t i = 0; i < data->mTopicMessages.size(); ++i) {
+        const auto& topicMessages = data->mTopicMessages[i];
+        mSendCnt->Add(topicMessages.mMessages.size());
+        mProducer->ProduceBatchAsync(
+            topicMessages.mTopic,
+            data->mPayload,
+            topicMessages.mMessages,
+            [this, data, i](size_t index, bool success, const KafkaProducer::ErrorInfo& errorInfo) {
+                OnMessageDone(data, i, index, success, errorInfo);
+            });
+    }
+    SET_GAUGE(mOutQueueMessages, mProducer->GetOutQueueLength());
+    {
+        lock_guard<mutex> lock(data->mMux);
+        if (--data->mInflightCnt > 0) {
+            return true;
         }
+    }
+    OnItemDone(data);
+    return true;
+}
 
-        std::string partitionKey;
-        if (mKafkaConfig.PartitionerType == PARTITIONER_HASH) {
-            partitionKey = GeneratePartitionKey(event);
+void FlusherKafka::OnMessageDone(KafkaSenderQueueItem* item,
+                                 size_t topicIndex,
+                                 size_t index,
+                                 bool success,
+                                 const KafkaProducer::ErrorInfo& errorInfo) {
+    HandleDeliveryResult(success, errorInfo);
+    {
+        lock_guard<mutex> lock(item->mMux);
+        if (!success) {
+            if (IsRetriable(errorInfo.type)) {
+                item->mRetryMessages.emplace_back(topicIndex, index);
+            } else {
+                ++item->mDiscardCnt;
+                mDiscardCnt->Add(1);
+            }
         }
-
-        BatchedEvents batchedEvents;
-        batchedEvents.mEvents.reserve(1);
-        batchedEvents.mEvents.emplace_back(std::move(event));
-        batchedEvents.mTags = sizedTags;
-        batchedEvents.mSourceBuffers.emplace_back(sourceBuffer);
-        batchedEvents.mExactlyOnceCheckpoint = checkpoint;
-
-        if (!mSerializer->DoSerialize(std::move(batchedEvents), serializedData, errorMsg)) {
-            LOG_ERROR(mContext->GetLogger(),
-                      ("failed to serialize events", errorMsg)("topic", topic)("action", "discard data"));
-            mContext->GetAlarm().SendAlarmCritical(SERIALIZE_FAIL_ALARM,
-                                                   "failed to serialize events: " + errorMsg + "\taction: discard data",
-                                                   mContext->GetRegion(),
-                                                   mContext->GetProjectName(),
-                                                   mContext->GetConfigName(),
-                                                   mContext->GetLogstoreName());
-            mDiscardCnt->Add(1);
-            allSuccess = false;
-            continue;
+        if (--item->mInflightCnt > 0) {
+            return;
         }
+    }
+    OnItemDone(item);
+}
 
-        mSendCnt->Add(1);
+void FlusherKafka::OnItemDone(KafkaSenderQueueItem* item) {
+    auto curSystemTime = chrono::system_clock::now();
+    mTotalDeliveryTimeMs->Add(curSystemTime - item->mLastSendTime);
+    SenderQueueManager::GetInstance()->DecreaseConcurrencyLimiterInSendingCnt(item->mQueueKey);
 
-        size_t bytes = serializedData.size();
-        mProducer->ProduceAsync(
-            topic,
-            std::move(serializedData),
-            [this, bytes](bool success, const KafkaProducer::ErrorInfo& errorInfo) {
-                if (success) {
-                    LOG_DEBUG(mContext->GetLogger(), ("kafka message queued", bytes));
+    if (item->mRetryMessages.empty()) {
+        mConcurrencyLimiter->OnSuccess(curSystemTime);
+    } else {
+        mConcurrencyLimiter->OnFail(curSystemTime);
+        if (chrono::duration_cast<chrono::seconds>(curSystemTime - item->mFirstEnqueTime).count()
+            < INT32_FLAG(discard_send_fail_interval)) {
+            // only messages failed for transient reasons are sent again, after a backoff from 100ms to 10s
+            sort(item->mRetryMessages.begin(), item->mRetryMessages.end());
+            vector<KafkaTopicMessages> topicMessages;
+            size_t lastTopicIndex = item->mTopicMessages.size();
+            for (const auto& retryMessage : item->mRetryMessages) {
+                auto& messages = item->mTopicMessages[retryMessage.first];
+                if (retryMessage.first != lastTopicIndex) {
+                    topicMessages.push_back({messages.mTopic, {}});
+                    lastTopicIndex = retryMessage.first;
                 }
-                HandleDeliveryResult(success, errorInfo);
-            },
-            partitionKey);
+                topicMessages.back().mMessages.emplace_back(std::move(messages.mMessages[retryMessage.second]));
+            }
+            item->mTopicMessages = std::move(topicMessages);
+            const int64_t kInitialBackoffMs = 100;
+            const int64_t kMaxBackoffMs = 10000;
+            int64_t shift = min(item->mTryCnt - 1, 7U);
+            item->mQuickFailNextRetryTime
+                = curSystemTime + chrono::milliseconds(min(kInitialBackoffMs << shift, kMaxBackoffMs));
+            mRetryCnt->Add(1);
+            DealSenderQueueItemAfterSend(item, true);
+            return;
+        }
+        item->mDiscardCnt += item->mRetryMessages.size();
+        mDiscardCnt->Add(item->mRetryMessages.size());
+        LOG_WARNING(mContext->GetLogger(),
+                    ("failed to deliver kafka messages", "retry timeout")("count", item->mRetryMessages.size())(
+                        "try cnt", item->mTryCnt)("action", "discard data"));
+        mContext->GetAlarm().SendAlarmCritical(SEND_DATA_FAIL_ALARM,
+                                               "failed to deliver kafka messages after retrying for "
+                                                   + ToString(INT32_FLAG(discard_send_fail_interval))
+                                                   + " seconds\taction: discard data",
+                                               mContext->GetRegion(),
+                                               mContext->GetProjectName(),
+                                               mContext->GetConfigName(),
+                                               mKafkaConfig.Topic);
+    }
+    if (item->mDiscardCnt == 0 && item->mExactlyOnceCheckpoint) {
+        // the range is committed only when all events of it are delivered, otherwise it is read again on restart
+        item->mExactlyOnceCheckpoint->Commit();
+        item->mExactlyOnceCheckpoint->IncreaseSequenceID();
     }
-    return allSuccess;
+    DecreaseItemCnt();
+    DealSenderQueueItemAfterSend(item, false);
+}
+
+void FlusherKafka::DecreaseItemCnt() {
+    {
+        lock_guard<mutex> lock(mItemCntMux);
+        --mItemCnt;
+    }
+    mItemCntCond.notify_all();
 }
 
 void FlusherKafka::HandleDeliveryResult(bool success, const KafkaProducer::ErrorInfo& errorInfo) {
@@ -233,6 +424,9 @@ void FlusherKafka::HandleDeliveryResult(bool success, const KafkaProducer::Error
 
     if (success) {
         mSuccessCnt->Add(1);
+    } else if (errorInfo.type == KafkaProducer::ErrorType::QUEUE_FULL) {
+        // the producer queue is full when brokers are slow, the message is sent again later
+        LOG_DEBUG(mContext->GetLogger(), ("kafka producer queue is full", "retry later")("topic", mKafkaConfig.Topic));
     } else {
         LOG_ERROR(mContext->GetLogger(),
                   ("kafka message delivery failed", errorInfo.message)("topic", mKafkaConfig.Topic)("error_code",
@@ -251,9 +445,6 @@ void FlusherKafka::HandleDeliveryResult(bool success, const KafkaProducer::Error
             case KafkaProducer::ErrorType::PARAMS_ERROR:
                 mParamsErrorCnt->Add(1);
                 break;
-            case KafkaProducer::ErrorType::QUEUE_FULL:
-                mDiscardCnt->Add(1);
-                break;
             case KafkaProducer::ErrorType::OTHER_ERROR:
             default:
                 mOtherErrorCnt->Add(1);
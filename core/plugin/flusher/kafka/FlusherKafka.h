@@ -17,12 +17,14 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
-#include "collection_pipeline/plugin/interface/Flusher.h"
+#include "collection_pipeline/limiter/ConcurrencyLimiter.h"
+#include "collection_pipeline/plugin/interface/ClientFlusher.h"
 #include "collection_pipeline/serializer/JsonSerializer.h"
 #include "common/FormattedString.h"
 #include "common/StringView.h"
@@ -31,10 +33,11 @@
 #include "monitor/MetricManager.h"
 #include "plugin/flusher/kafka/KafkaConfig.h"
 #include "plugin/flusher/kafka/KafkaProducer.h"
+#include "plugin/flusher/kafka/KafkaSenderQueueItem.h"
 
 namespace logtail {
 
-class FlusherKafka : public Flusher {
+class FlusherKafka : public ClientFlusher {
 public:
     static const std::string sName;
 
@@ -48,20 +51,38 @@ public:
     bool Send(PipelineEventGroup&& g) override;
     bool Flush(size_t key) override;
     bool FlushAll() override;
+    bool SendItem(SenderQueueItem* item) override;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     void SetProducerForTest(std::unique_ptr<KafkaProducer> producer) { mProducer = std::move(producer); }
-    void SetSerializerForTest(std::unique_ptr<EventGroupSerializer> serializer) { mSerializer = std::move(serializer); }
+    void SetSerializerForTest(std::unique_ptr<JsonEventGroupSerializer> serializer) {
+        mSerializer = std::move(serializer);
+    }
 #endif
 
 private:
-    bool SerializeAndSend(PipelineEventGroup&& group);
+    bool SerializeAndPush(PipelineEventGroup&& group);
+    void OnMessageDone(KafkaSenderQueueItem* item,
+                       size_t topicIndex,
+                       size_t index,
+                       bool success,
+                       const KafkaProducer::ErrorInfo& errorInfo);
+    // called once all messages of @item are reported, @item is either removed or set back to idle for retry
+    void OnItemDone(KafkaSenderQueueItem* item);
     void HandleDeliveryResult(bool success, const KafkaProducer::ErrorInfo& errorInfo);
+    void DecreaseItemCnt();
     std::string GeneratePartitionKey(const PipelineEventPtr& event) const;
 
     KafkaConfig mKafkaConfig;
     std::unique_ptr<KafkaProducer> mProducer;
-    std::unique_ptr<EventGroupSerializer> mSerializer;
+    std::unique_ptr<JsonEventGroupSerializer> mSerializer;
+    // size of the payload of the last group, to reserve for the next one
+    std::atomic<size_t> mLastPayloadSize{0};
+    std::shared_ptr<ConcurrencyLimiter> mConcurrencyLimiter;
+    // items pushed to the sender queue and not removed yet, Stop waits on mItemCntCond for them to be sent
+    size_t mItemCnt = 0;
+    std::mutex mItemCntMux;
+    std::condition_variable mItemCntCond;
 
     FormattedString mTopicFormatter;
     std::string mExpandedTopic;
@@ -75,6 +96,9 @@ private:
     CounterPtr mUnauthErrorCnt;
     CounterPtr mParamsErrorCnt;
     CounterPtr mOtherErrorCnt;
+    CounterPtr mRetryCnt;
+    IntGaugePtr mOutQueueMessages;
+    TimeCounterPtr mTotalDeliveryTimeMs;
 
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -51,6 +51,9 @@ struct KafkaConfig {
     uint32_t MaxRetries = 3;
     uint32_t RetryBackoffMs = 100;
 
+    // bytes per second sent, applied by the sender queue, 0 for unlimited
+    uint32_t MaxSendRate = 0;
+
     std::string Compression;
     int32_t CompressionLevel = -1;
 
@@ -100,6 +103,7 @@ struct KafkaConfig {
         GetOptionalUIntParam(config, "QueueBufferingMaxMessages", QueueBufferingMaxMessages, errorMsg);
         GetOptionalStringParam(config, "PartitionerType", PartitionerType, errorMsg);
         GetOptionalListParam<std::string>(config, "HashKeys", HashKeys, errorMsg);
+        GetOptionalUIntParam(config, "MaxSendRate", MaxSendRate, errorMsg);
 
         GetOptionalStringParam(config, "Compression", Compression, errorMsg);
         GetOptionalIntParam(config, "CompressionLevel", CompressionLevel, errorMsg);
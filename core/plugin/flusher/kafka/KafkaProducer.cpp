@@ -19,6 +19,8 @@
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "common/StringTools.h"
@@ -31,9 +33,26 @@ namespace logtail {
 
 namespace {
 
+// shared by the messages of a batch
+struct ProducerBatch {
+    std::shared_ptr<std::string> payload;
+    KafkaProducer::BatchCallback callback;
+};
+
 struct ProducerContext {
     KafkaProducer::Callback callback;
     KafkaProducer::ErrorInfo errorInfo;
+    // set for messages of a batch, whose callback is the one of the batch
+    std::shared_ptr<ProducerBatch> batch;
+    size_t index = 0;
+
+    void Report(bool success, const KafkaProducer::ErrorInfo& errorInfo) const {
+        if (batch) {
+            batch->callback(index, success, errorInfo);
+        } else if (callback) {
+            callback(success, errorInfo);
+        }
+    }
 };
 
 } // namespace
@@ -96,6 +115,8 @@ public:
 
     void ReleaseContext(ProducerContext* ctx) {
         ctx->callback = nullptr;
+        ctx->batch.reset();
+        ctx->index = 0;
         ctx->errorInfo = {KafkaProducer::ErrorType::SUCCESS, "", 0};
         std::lock_guard<std::mutex> lock(mContextPoolMutex);
         if (mContextPool.size() < kMaxContextCache) {
@@ -165,23 +186,11 @@ public:
                       std::string&& value,
                       KafkaProducer::Callback callback,
                       const std::string& key) {
-        rd_kafka_headers_t* headers = nullptr;
-        if (mHeadersTemplate) {
-            headers = rd_kafka_headers_copy(mHeadersTemplate);
-            if (!headers) {
-                LOG_ERROR(sLogger, ("failed to copy kafka headers template", ""));
-            }
-        }
-
-        rd_kafka_t* producer = nullptr;
-        {
-            std::lock_guard<std::mutex> lock(mProducerMutex);
-            producer = mProducer;
-        }
+        // the producer and the headers template are destroyed by Close, so they are used under the lock
+        std::unique_lock<std::mutex> lock(mProducerMutex);
+        rd_kafka_t* producer = mProducer;
         if (!producer) {
-            if (headers) {
-                rd_kafka_headers_destroy(headers);
-            }
+            lock.unlock();
             KafkaProducer::ErrorInfo errorInfo;
             errorInfo.type = KafkaProducer::ErrorType::OTHER_ERROR;
             errorInfo.message = "producer not initialized";
@@ -189,6 +198,13 @@ public:
             callback(false, errorInfo);
             return;
         }
+        rd_kafka_headers_t* headers = nullptr;
+        if (mHeadersTemplate) {
+            headers = rd_kafka_headers_copy(mHeadersTemplate);
+            if (!headers) {
+                LOG_ERROR(sLogger, ("failed to copy kafka headers template", ""));
+            }
+        }
 
         auto* context = GetContext();
         context->callback = std::move(callback);
@@ -231,6 +247,7 @@ public:
                                     RD_KAFKA_V_OPAQUE(context),
                                     RD_KAFKA_V_END);
         }
+        lock.unlock();
 
         if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
             LOG_ERROR(sLogger,
@@ -250,6 +267,97 @@ public:
         }
     }
 
+    void ProduceBatchAsync(const std::string& topic,
+                           const std::shared_ptr<std::string>& payload,
+                           const std::vector<KafkaProducer::BatchMessage>& messages,
+                           KafkaProducer::BatchCallback callback) {
+        // the producer, its topics and the headers template are destroyed by Close, so they are used under the lock,
+        // and the callbacks of messages failed to produce are called after it is released
+        std::unique_lock<std::mutex> lock(mProducerMutex);
+        rd_kafka_t* producer = mProducer;
+        if (!producer) {
+            lock.unlock();
+            KafkaProducer::ErrorInfo errorInfo;
+            errorInfo.type = KafkaProducer::ErrorType::OTHER_ERROR;
+            errorInfo.message = "producer not initialized";
+            errorInfo.code = 0;
+            for (size_t i = 0; i < messages.size(); ++i) {
+                callback(i, false, errorInfo);
+            }
+            return;
+        }
+
+        auto batch = std::make_shared<ProducerBatch>();
+        batch->payload = payload;
+        batch->callback = std::move(callback);
+        rd_kafka_topic_t* rkt = GetTopic(producer, topic);
+        std::vector<std::pair<size_t, KafkaProducer::ErrorInfo>> failures;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            const auto& message = messages[i];
+            rd_kafka_headers_t* headers = nullptr;
+            if (mHeadersTemplate) {
+                headers = rd_kafka_headers_copy(mHeadersTemplate);
+                if (!headers) {
+                    LOG_ERROR(sLogger, ("failed to copy kafka headers template", ""));
+                }
+            }
+            auto* context = GetContext();
+            context->batch = batch;
+            context->index = i;
+
+            // no RD_KAFKA_MSG_F_COPY, the payload is kept by the context until the message is delivered
+            char* value = const_cast<char*>(payload->data()) + message.offset;
+            const char* key = message.key.empty() ? nullptr : message.key.data();
+            rd_kafka_resp_err_t err;
+            if (rkt) {
+                err = rd_kafka_producev(producer,
+                                        RD_KAFKA_V_RKT(rkt),
+                                        RD_KAFKA_V_PARTITION(RD_KAFKA_PARTITION_UA),
+                                        RD_KAFKA_V_MSGFLAGS(0),
+                                        RD_KAFKA_V_KEY(key, message.key.size()),
+                                        RD_KAFKA_V_VALUE(value, message.size),
+                                        RD_KAFKA_V_HEADERS(headers),
+                                        RD_KAFKA_V_OPAQUE(context),
+                                        RD_KAFKA_V_END);
+            } else {
+                err = rd_kafka_producev(producer,
+                                        RD_KAFKA_V_TOPIC(topic.c_str()),
+                                        RD_KAFKA_V_PARTITION(RD_KAFKA_PARTITION_UA),
+                                        RD_KAFKA_V_MSGFLAGS(0),
+                                        RD_KAFKA_V_KEY(key, message.key.size()),
+                                        RD_KAFKA_V_VALUE(value, message.size),
+                                        RD_KAFKA_V_HEADERS(headers),
+                                        RD_KAFKA_V_OPAQUE(context),
+                                        RD_KAFKA_V_END);
+            }
+
+            if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+                LOG_ERROR(sLogger,
+                          ("rd_kafka_producev error", rd_kafka_err2str(err))("code", static_cast<int>(err))(
+                              "topic", topic)("value_size", message.size));
+                if (headers) {
+                    rd_kafka_headers_destroy(headers);
+                }
+                KafkaProducer::ErrorInfo errorInfo;
+                errorInfo.type = KafkaProducer::MapKafkaError(err);
+                errorInfo.message = rd_kafka_err2str(err);
+                errorInfo.code = static_cast<int>(err);
+                failures.emplace_back(i, std::move(errorInfo));
+                ReleaseContext(context);
+            }
+        }
+        lock.unlock();
+
+        for (const auto& failure : failures) {
+            batch->callback(failure.first, false, failure.second);
+        }
+    }
+
+    size_t GetOutQueueLength() {
+        std::lock_guard<std::mutex> lock(mProducerMutex);
+        return mProducer ? static_cast<size_t>(rd_kafka_outq_len(mProducer)) : 0;
+    }
+
     bool Flush(int timeoutMs) {
         if (!mProducer) {
             return false;
@@ -272,6 +380,17 @@ public:
         std::lock_guard<std::mutex> lock(mProducerMutex);
         if (mProducer) {
             rd_kafka_flush(mProducer, 3000);
+            // messages still undelivered are purged, so that their delivery reports are served before the producer
+            // is destroyed and their callers are not left waiting
+            rd_kafka_purge(mProducer, RD_KAFKA_PURGE_F_QUEUE | RD_KAFKA_PURGE_F_INFLIGHT);
+            rd_kafka_poll(mProducer, 0);
+            {
+                std::lock_guard<std::mutex> topicLock(mTopicMutex);
+                for (auto& item : mTopics) {
+                    rd_kafka_topic_destroy(item.second);
+                }
+                mTopics.clear();
+            }
             rd_kafka_destroy(mProducer);
             mProducer = nullptr;
         }
@@ -563,6 +682,29 @@ private:
         return true;
     }
 
+    // Returns the cached handle of @topic, so that producing to it does not look up the topic by name each time.
+    // Returns null if it cannot be created or too many topics are cached (e.g. too many dynamic topics), and the
+    // topic is looked up by name then.
+    rd_kafka_topic_t* GetTopic(rd_kafka_t* producer, const std::string& topic) {
+        std::lock_guard<std::mutex> lock(mTopicMutex);
+        auto iter = mTopics.find(topic);
+        if (iter != mTopics.end()) {
+            return iter->second;
+        }
+        if (mTopics.size() >= kMaxTopicCache) {
+            return nullptr;
+        }
+        rd_kafka_topic_t* rkt = rd_kafka_topic_new(producer, topic.c_str(), nullptr);
+        if (!rkt) {
+            LOG_WARNING(sLogger,
+                        ("failed to create kafka topic handle",
+                         rd_kafka_err2str(rd_kafka_last_error()))("topic", topic));
+            return nullptr;
+        }
+        mTopics.emplace(topic, rkt);
+        return rkt;
+    }
+
     bool InitProducer() {
         rd_kafka_conf_set_dr_msg_cb(mConf, KafkaProducer::DeliveryReportCallback);
         rd_kafka_conf_set_opaque(mConf, this);
@@ -632,6 +774,9 @@ private:
     std::vector<ProducerContext*> mContextPool;
     std::mutex mContextPoolMutex;
     static constexpr size_t kMaxContextCache = 65536;
+    std::unordered_map<std::string, rd_kafka_topic_t*> mTopics;
+    std::mutex mTopicMutex;
+    static constexpr size_t kMaxTopicCache = 1024;
 };
 
 void KafkaProducer::DeliveryReportCallback(rd_kafka_t* rk, const rd_kafka_message_t* rkmessage, void* opaque) {
@@ -641,13 +786,13 @@ void KafkaProducer::DeliveryReportCallback(rd_kafka_t* rk, const rd_kafka_messag
     }
 
     if (rkmessage->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
-        context->callback(true, {KafkaProducer::ErrorType::SUCCESS, "", 0});
+        context->Report(true, {KafkaProducer::ErrorType::SUCCESS, "", 0});
     } else {
         KafkaProducer::ErrorInfo errorInfo;
         errorInfo.type = KafkaProducer::MapKafkaError(rkmessage->err);
         errorInfo.message = rd_kafka_err2str(rkmessage->err);
         errorInfo.code = static_cast<int>(rkmessage->err);
-        context->callback(false, errorInfo);
+        context->Report(false, errorInfo);
     }
 
     auto* producerImpl = static_cast<KafkaProducer::Impl*>(rd_kafka_opaque(rk));
@@ -674,6 +819,17 @@ void KafkaProducer::ProduceAsync(const std::string& topic,
     mImpl->ProduceAsync(topic, std::move(value), std::move(callback), key);
 }
 
+void KafkaProducer::ProduceBatchAsync(const std::string& topic,
+                                      const std::shared_ptr<std::string>& payload,
+                                      const std::vector<BatchMessage>& messages,
+                                      BatchCallback callback) {
+    mImpl->ProduceBatchAsync(topic, payload, messages, std::move(callback));
+}
+
+size_t KafkaProducer::GetOutQueueLength() {
+    return mImpl->GetOutQueueLength();
+}
+
 bool KafkaProducer::Flush(int timeoutMs) {
     return mImpl->Flush(timeoutMs);
 }
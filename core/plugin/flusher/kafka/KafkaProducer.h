@@ -20,6 +20,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "plugin/flusher/kafka/KafkaConstant.h"
 
@@ -38,6 +39,15 @@ public:
     };
 
     using Callback = std::function<void(bool success, const ErrorInfo& errorInfo)>;
+    // @index is the index of the message in the batch
+    using BatchCallback = std::function<void(size_t index, bool success, const ErrorInfo& errorInfo)>;
+
+    // A message of a batch, whose value is the slice [offset, offset + size) of the payload of the batch.
+    struct BatchMessage {
+        size_t offset;
+        size_t size;
+        std::string key;
+    };
 
     KafkaProducer();
     virtual ~KafkaProducer();
@@ -48,6 +58,14 @@ public:
                               std::string&& value,
                               Callback callback,
                               const std::string& key = std::string());
+    // Produces @messages to @topic without copying their values, @payload is kept until all of them are delivered.
+    // @callback is called once for each message.
+    virtual void ProduceBatchAsync(const std::string& topic,
+                                   const std::shared_ptr<std::string>& payload,
+                                   const std::vector<BatchMessage>& messages,
+                                   BatchCallback callback);
+    // Returns the number of messages waiting to be sent or acknowledged by brokers.
+    virtual size_t GetOutQueueLength();
     virtual bool Flush(int timeoutMs);
     virtual void Close();
 
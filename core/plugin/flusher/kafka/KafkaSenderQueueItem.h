@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "collection_pipeline/queue/SenderQueueItem.h"
+#include "file_server/checkpoint/RangeCheckpoint.h"
+#include "plugin/flusher/kafka/KafkaProducer.h"
+
+namespace logtail {
+
+struct KafkaTopicMessages {
+    std::string mTopic;
+    std::vector<KafkaProducer::BatchMessage> mMessages;
+};
+
+// The messages of an event group. The item stays in the sender queue until all of them are delivered, so that a slow
+// broker fills the queue and holds back the process queue.
+struct KafkaSenderQueueItem : public SenderQueueItem {
+    // serialized events of the group, each message is a slice of it. It is kept by the producer until the messages
+    // are delivered, so mData is left empty.
+    std::shared_ptr<std::string> mPayload;
+    // messages not delivered yet
+    std::vector<KafkaTopicMessages> mTopicMessages;
+    RangeCheckpointPtr mExactlyOnceCheckpoint;
+
+    // state of the current send, updated by delivery reports
+    std::mutex mMux;
+    size_t mInflightCnt = 0;
+    // topic index and message index of the messages to retry
+    std::vector<std::pair<size_t, size_t>> mRetryMessages;
+    // messages discarded in all sends, the checkpoint is committed only if none is
+    size_t mDiscardCnt = 0;
+
+    KafkaSenderQueueItem(std::shared_ptr<std::string>&& payload,
+                         std::vector<KafkaTopicMessages>&& topicMessages,
+                         Flusher* flusher,
+                         QueueKey key,
+                         RangeCheckpointPtr&& exactlyOnceCheckpoint = RangeCheckpointPtr())
+        : SenderQueueItem(std::string(), payload->size(), flusher, key),
+          mPayload(std::move(payload)),
+          mTopicMessages(std::move(topicMessages)),
+          mExactlyOnceCheckpoint(std::move(exactlyOnceCheckpoint)) {}
+
+    KafkaSenderQueueItem(const KafkaSenderQueueItem& item)
+        : SenderQueueItem(item),
+          mPayload(item.mPayload),
+          mTopicMessages(item.mTopicMessages),
+          mExactlyOnceCheckpoint(item.mExactlyOnceCheckpoint) {}
+
+    SenderQueueItem* Clone() override { return new KafkaSenderQueueItem(*this); }
+
+    size_t GetMessageCount() const {
+        size_t cnt = 0;
+        for (const auto& item : mTopicMessages) {
+            cnt += item.mMessages.size();
+        }
+        return cnt;
+    }
+};
+
+} // namespace logtail
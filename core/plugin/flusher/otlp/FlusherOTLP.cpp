@@ -0,0 +1,362 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/flusher/otlp/FlusherOTLP.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "app_config/AppConfig.h"
+#include "collection_pipeline/batch/FlushStrategy.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "common/EndpointUtil.h"
+#include "common/Flags.h"
+#include "common/ParamExtractor.h"
+#include "common/StringTools.h"
+#include "common/compression/CompressorFactory.h"
+#include "common/http/Constant.h"
+#include "logger/Logger.h"
+#include "monitor/AlarmManager.h"
+#include "monitor/metric_constants/MetricConstants.h"
+
+DEFINE_FLAG_INT32(otlp_flusher_batch_max_size_bytes,
+                  "max size of an otlp export request before compression(bytes)",
+                  4 * 1024 * 1024);
+DEFINE_FLAG_INT32(otlp_flusher_batch_min_size_bytes, "otlp flusher batch size limit(bytes)", 512 * 1024);
+DEFINE_FLAG_INT32(otlp_flusher_batch_min_cnt, "otlp flusher batch event count limit", 4000);
+DEFINE_FLAG_INT32(otlp_flusher_batch_timeout_secs, "otlp flusher batch timeout(second)", 3);
+
+DECLARE_FLAG_INT32(discard_send_fail_interval);
+
+using namespace std;
+
+namespace logtail {
+
+static const string CONTENT_ENCODING = "Content-Encoding";
+
+const string FlusherOTLP::sName = "flusher_otlp_native";
+
+bool FlusherOTLP::Init(const Json::Value& config, Json::Value& optionalGoPipeline) {
+    string errorMsg;
+
+    // Endpoint
+    if (!GetMandatoryStringParam(config, "Endpoint", mEndpoint, errorMsg)) {
+        PARAM_ERROR_RETURN(mContext->GetLogger(),
+                           mContext->GetAlarm(),
+                           errorMsg,
+                           sName,
+                           mContext->GetConfigName(),
+                           mContext->GetProjectName(),
+                           mContext->GetLogstoreName(),
+                           mContext->GetRegion());
+    }
+    if (!ParseEndpoint()) {
+        PARAM_ERROR_RETURN(mContext->GetLogger(),
+                           mContext->GetAlarm(),
+                           "string param Endpoint is not a valid url",
+                           sName,
+                           mContext->GetConfigName(),
+                           mContext->GetProjectName(),
+                           mContext->GetLogstoreName(),
+                           mContext->GetRegion());
+    }
+
+    // Headers
+    if (!GetOptionalMapParam(config, "Headers", mHeaders, errorMsg)) {
+        PARAM_WARNING_IGNORE(mContext->GetLogger(),
+                             mContext->GetAlarm(),
+                             errorMsg,
+                             sName,
+                             mContext->GetConfigName(),
+                             mContext->GetProjectName(),
+                             mContext->GetLogstoreName(),
+                             mContext->GetRegion());
+    }
+
+    // Batch
+    const char* key = "Batch";
+    const Json::Value* itr = config.find(key, key + strlen(key));
+    if (itr && !itr->isObject()) {
+        PARAM_WARNING_IGNORE(mContext->GetLogger(),
+                             mContext->GetAlarm(),
+                             "param Batch is not of type object",
+                             sName,
+                             mContext->GetConfigName(),
+                             mContext->GetProjectName(),
+                             mContext->GetLogstoreName(),
+                             mContext->GetRegion());
+        itr = nullptr;
+    }
+    DefaultFlushStrategyOptions strategy{static_cast<uint32_t>(INT32_FLAG(otlp_flusher_batch_max_size_bytes)),
+                                         static_cast<uint32_t>(INT32_FLAG(otlp_flusher_batch_min_size_bytes)),
+                                         static_cast<uint32_t>(INT32_FLAG(otlp_flusher_batch_min_cnt)),
+                                         static_cast<uint32_t>(INT32_FLAG(otlp_flusher_batch_timeout_secs))};
+    if (!mBatcher.Init(itr ? *itr : Json::Value(), this, strategy)) {
+        return false;
+    }
+
+    // CompressType
+    // The body is sent with Content-Encoding, which lz4 blocks are not valid for, so lz4 is replaced with zstd.
+    string compressType;
+    if (GetOptionalStringParam(config, "CompressType", compressType, errorMsg) && compressType == "lz4") {
+        PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                              mContext->GetAlarm(),
+                              "lz4 is not supported by otlp receivers",
+                              "zstd",
+                              sName,
+                              mContext->GetConfigName(),
+                              mContext->GetProjectName(),
+                              mContext->GetLogstoreName(),
+                              mContext->GetRegion());
+        Json::Value tmp(config);
+        tmp["CompressType"] = "zstd";
+        mCompressor = CompressorFactory::GetInstance()->Create(tmp, *mContext, sName, mPluginID, CompressType::ZSTD);
+    } else {
+        mCompressor
+            = CompressorFactory::GetInstance()->Create(config, *mContext, sName, mPluginID, CompressType::ZSTD);
+    }
+
+    mGroupSerializer = make_unique<OTLPEventGroupSerializer>(this);
+
+    // MaxSendRate
+    if (!GetOptionalUIntParam(config, "MaxSendRate", mMaxSendRate, errorMsg)) {
+        PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                              mContext->GetAlarm(),
+                              errorMsg,
+                              mMaxSendRate,
+                              sName,
+                              mContext->GetConfigName(),
+                              mContext->GetProjectName(),
+                              mContext->GetLogstoreName(),
+                              mContext->GetRegion());
+    }
+
+    GenerateQueueKey(mEndpoint);
+    mConcurrencyLimiter = make_shared<ConcurrencyLimiter>(sName + "#quota#endpoint#" + mEndpoint,
+                                                          AppConfig::GetInstance()->GetSendRequestConcurrency());
+    SenderQueueManager::GetInstance()->CreateQueue(
+        mQueueKey, mPluginID, mEndpoint, *mContext, {{"endpoint", mConcurrencyLimiter}}, mMaxSendRate);
+
+    mSendCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_OUT_EVENT_GROUPS_TOTAL);
+    mSendDoneCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_SEND_DONE_TOTAL);
+    mSuccessCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_SUCCESS_TOTAL);
+    mRetryCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_RETRY_TOTAL);
+    mDiscardCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_DISCARD_TOTAL);
+    mNetworkErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_NETWORK_ERROR_TOTAL);
+    mServerErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_SERVER_ERROR_TOTAL);
+    mUnauthErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_UNAUTH_ERROR_TOTAL);
+    mParamsErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_PARAMS_ERROR_TOTAL);
+    mOtherErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_OTHER_ERROR_TOTAL);
+
+    return true;
+}
+
+bool FlusherOTLP::Send(PipelineEventGroup&& g) {
+    vector<BatchedEventsList> res;
+    mBatcher.Add(std::move(g), res);
+    return SerializeAndPush(std::move(res));
+}
+
+bool FlusherOTLP::Flush(size_t key) {
+    BatchedEventsList res;
+    mBatcher.FlushQueue(key, res);
+    return SerializeAndPush(std::move(res));
+}
+
+bool FlusherOTLP::FlushAll() {
+    vector<BatchedEventsList> res;
+    mBatcher.FlushAll(res);
+    return SerializeAndPush(std::move(res));
+}
+
+bool FlusherOTLP::BuildRequest(SenderQueueItem* item,
+                               unique_ptr<HttpSinkRequest>& req,
+                               bool* keepItem,
+                               string* errMsg) {
+    ADD_COUNTER(mSendCnt, 1);
+
+    auto data = static_cast<OTLPSenderQueueItem*>(item);
+    map<string, string> header(mHeaders.begin(), mHeaders.end());
+    header[CONTENT_TYPE] = TYPE_LOG_PROTOBUF;
+    if (mCompressor) {
+        header[CONTENT_ENCODING] = CompressTypeToString(mCompressor->GetCompressType());
+    }
+    req = make_unique<HttpSinkRequest>(
+        HTTP_POST, mHttpsFlag, mHost, mPort, GetPath(data->mSignalType), "", header, data->mData, item);
+    return true;
+}
+
+void FlusherOTLP::OnSendDone(const HttpResponse& response, SenderQueueItem* item) {
+    ADD_COUNTER(mSendDoneCnt, 1);
+
+    auto curSystemTime = chrono::system_clock::now();
+    int32_t statusCode = response.GetStatusCode();
+    if (statusCode >= 200 && statusCode < 300) {
+        LOG_DEBUG(sLogger,
+                  ("send data to otlp receiver succeeded, item address", item)("endpoint", mEndpoint)(
+                      "config", mContext->GetConfigName())("try cnt", item->mTryCnt));
+        mConcurrencyLimiter->OnSuccess(curSystemTime);
+        SenderQueueManager::GetInstance()->DecreaseConcurrencyLimiterInSendingCnt(item->mQueueKey);
+        ADD_COUNTER(mSuccessCnt, 1);
+        DealSenderQueueItemAfterSend(item, false);
+        return;
+    }
+
+    // retriable responses are defined in https://opentelemetry.io/docs/specs/otlp/#failures-1
+    bool retry = false;
+    string failDetail;
+    if (statusCode == 0) {
+        failDetail = "network error";
+        retry = true;
+        mConcurrencyLimiter->OnFail(curSystemTime);
+        ADD_COUNTER(mNetworkErrorCnt, 1);
+    } else if (statusCode == 429 || statusCode == 502 || statusCode == 503 || statusCode == 504) {
+        failDetail = "server error";
+        retry = true;
+        mConcurrencyLimiter->OnFail(curSystemTime);
+        ADD_COUNTER(mServerErrorCnt, 1);
+    } else if (statusCode == 401 || statusCode == 403) {
+        failDetail = "write unauthorized";
+        ADD_COUNTER(mUnauthErrorCnt, 1);
+    } else if (statusCode >= 400 && statusCode < 500) {
+        failDetail = "invalid parameters";
+        ADD_COUNTER(mParamsErrorCnt, 1);
+    } else {
+        failDetail = "other error";
+        ADD_COUNTER(mOtherErrorCnt, 1);
+    }
+    if (chrono::duration_cast<chrono::seconds>(curSystemTime - item->mFirstEnqueTime).count()
+        > INT32_FLAG(discard_send_fail_interval)) {
+        retry = false;
+    }
+
+    LOG_WARNING(sLogger,
+                ("failed to send request", failDetail)("operation", retry ? "retry later" : "discard data")(
+                    "status code", statusCode)("item address", item)("endpoint", mEndpoint)(
+                    "config", mContext->GetConfigName())("try cnt", item->mTryCnt));
+    SenderQueueManager::GetInstance()->DecreaseConcurrencyLimiterInSendingCnt(item->mQueueKey);
+    if (retry) {
+        ADD_COUNTER(mRetryCnt, 1);
+        DealSenderQueueItemAfterSend(item, true);
+    } else {
+        ADD_COUNTER(mDiscardCnt, 1);
+        AlarmManager::GetInstance()->SendAlarmCritical(SEND_DATA_FAIL_ALARM,
+                                                       "failed to send request: " + failDetail
+                                                           + "\toperation: discard data\tstatusCode: "
+                                                           + ToString(statusCode) + "\tconfig: "
+                                                           + mContext->GetConfigName() + "\tendpoint: " + mEndpoint,
+                                                       mContext->GetRegion(),
+                                                       mContext->GetProjectName(),
+                                                       mContext->GetConfigName(),
+                                                       mContext->GetLogstoreName());
+        DealSenderQueueItemAfterSend(item, false);
+    }
+}
+
+bool FlusherOTLP::ParseEndpoint() {
+    string basePath;
+    if (!ParseHttpEndpoint(mEndpoint, mHttpsFlag, mHost, mPort, basePath)) {
+        return false;
+    }
+    while (!basePath.empty() && basePath.back() == '/') {
+        basePath.pop_back();
+    }
+    mLogsPath = basePath + "/v1/logs";
+    mMetricsPath = basePath + "/v1/metrics";
+    mTracesPath = basePath + "/v1/traces";
+    return true;
+}
+
+bool FlusherOTLP::SerializeAndPush(vector<BatchedEventsList>&& groupLists) {
+    bool allSucceeded = true;
+    for (auto& groupList : groupLists) {
+        allSucceeded = SerializeAndPush(std::move(groupList)) && allSucceeded;
+    }
+    return allSucceeded;
+}
+
+bool FlusherOTLP::SerializeAndPush(BatchedEventsList&& groupList) {
+    bool allSucceeded = true;
+    string serializedData, compressedData, errorMsg;
+    for (auto& group : groupList) {
+        if (group.mEvents.empty()) {
+            continue;
+        }
+        OTLPSignalType signalType = OTLPSignalType::LOGS;
+        switch (group.mEvents[0]->GetType()) {
+            case PipelineEvent::Type::METRIC:
+                signalType = OTLPSignalType::METRICS;
+                break;
+            case PipelineEvent::Type::SPAN:
+                signalType = OTLPSignalType::TRACES;
+                break;
+            default:
+                break;
+        }
+        if (!mGroupSerializer->DoSerialize(std::move(group), serializedData, errorMsg)) {
+            LOG_WARNING(mContext->GetLogger(),
+                        ("failed to serialize event group",
+                         errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
+            mContext->GetAlarm().SendAlarmWarning(SERIALIZE_FAIL_ALARM,
+                                                  "failed to serialize event group: " + errorMsg
+                                                      + "\taction: discard data\tplugin: " + sName
+                                                      + "\tconfig: " + mContext->GetConfigName(),
+                                                  mContext->GetRegion(),
+                                                  mContext->GetProjectName(),
+                                                  mContext->GetConfigName(),
+                                                  mContext->GetLogstoreName());
+            allSucceeded = false;
+            continue;
+        }
+        if (mCompressor) {
+            if (!mCompressor->DoCompress(serializedData, compressedData, errorMsg)) {
+                LOG_WARNING(mContext->GetLogger(),
+                            ("failed to compress event group",
+                             errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
+                mContext->GetAlarm().SendAlarmWarning(COMPRESS_FAIL_ALARM,
+                                                      "failed to compress event group: " + errorMsg
+                                                          + "\taction: discard data\tplugin: " + sName
+                                                          + "\tconfig: " + mContext->GetConfigName(),
+                                                      mContext->GetRegion(),
+                                                      mContext->GetProjectName(),
+                                                      mContext->GetConfigName(),
+                                                      mContext->GetLogstoreName());
+                allSucceeded = false;
+                continue;
+            }
+        } else {
+            compressedData.swap(serializedData);
+        }
+        size_t rawSize = mCompressor ? serializedData.size() : compressedData.size();
+        allSucceeded = Flusher::PushToQueue(make_unique<OTLPSenderQueueItem>(
+                           std::move(compressedData), rawSize, this, mQueueKey, signalType))
+            && allSucceeded;
+    }
+    return allSucceeded;
+}
+
+const string& FlusherOTLP::GetPath(OTLPSignalType type) const {
+    switch (type) {
+        case OTLPSignalType::METRICS:
+            return mMetricsPath;
+        case OTLPSignalType::TRACES:
+            return mTracesPath;
+        default:
+            return mLogsPath;
+    }
+}
+
+} // namespace logtail
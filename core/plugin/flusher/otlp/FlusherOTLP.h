@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "json/json.h"
+
+#include "collection_pipeline/batch/Batcher.h"
+#include "collection_pipeline/limiter/ConcurrencyLimiter.h"
+#include "collection_pipeline/plugin/interface/HttpFlusher.h"
+#include "collection_pipeline/serializer/OTLPSerializer.h"
+#include "common/compression/Compressor.h"
+#include "models/PipelineEventGroup.h"
+#include "monitor/MetricManager.h"
+#include "plugin/flusher/otlp/OTLPSenderQueueItem.h"
+
+namespace logtail {
+
+// Exports events to an OTLP receiver over HTTP in protobuf, see
+// https://opentelemetry.io/docs/specs/otlp/#otlphttp
+class FlusherOTLP : public HttpFlusher {
+public:
+    static const std::string sName;
+
+    const std::string& Name() const override { return sName; }
+    bool Init(const Json::Value& config, Json::Value& optionalGoPipeline) override;
+    bool Send(PipelineEventGroup&& g) override;
+    bool Flush(size_t key) override;
+    bool FlushAll() override;
+    bool BuildRequest(SenderQueueItem* item,
+                      std::unique_ptr<HttpSinkRequest>& req,
+                      bool* keepItem,
+                      std::string* errMsg) override;
+    void OnSendDone(const HttpResponse& response, SenderQueueItem* item) override;
+
+    std::string mEndpoint;
+    std::unordered_map<std::string, std::string> mHeaders;
+    uint32_t mMaxSendRate = 0;
+
+private:
+    bool ParseEndpoint();
+    bool SerializeAndPush(std::vector<BatchedEventsList>&& groupLists);
+    bool SerializeAndPush(BatchedEventsList&& groupList);
+    const std::string& GetPath(OTLPSignalType type) const;
+
+    bool mHttpsFlag = false;
+    std::string mHost;
+    int32_t mPort = 0;
+    std::string mLogsPath;
+    std::string mMetricsPath;
+    std::string mTracesPath;
+
+    Batcher<> mBatcher;
+    std::unique_ptr<OTLPEventGroupSerializer> mGroupSerializer;
+    std::unique_ptr<Compressor> mCompressor;
+    std::shared_ptr<ConcurrencyLimiter> mConcurrencyLimiter;
+
+    CounterPtr mSendCnt;
+    CounterPtr mSendDoneCnt;
+    CounterPtr mSuccessCnt;
+    CounterPtr mRetryCnt;
+    CounterPtr mDiscardCnt;
+    CounterPtr mNetworkErrorCnt;
+    CounterPtr mServerErrorCnt;
+    CounterPtr mUnauthErrorCnt;
+    CounterPtr mParamsErrorCnt;
+    CounterPtr mOtherErrorCnt;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FlusherOTLPUnittest;
+#endif
+};
+
+} // namespace logtail
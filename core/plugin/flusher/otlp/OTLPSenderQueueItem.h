@@ -0,0 +1,37 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "collection_pipeline/queue/SenderQueueItem.h"
+
+namespace logtail {
+
+enum class OTLPSignalType { LOGS, METRICS, TRACES };
+
+struct OTLPSenderQueueItem : public SenderQueueItem {
+    // decides the path the request is posted to
+    OTLPSignalType mSignalType = OTLPSignalType::LOGS;
+
+    OTLPSenderQueueItem(std::string&& data, size_t rawSize, Flusher* flusher, QueueKey key, OTLPSignalType signalType)
+        : SenderQueueItem(std::move(data), rawSize, flusher, key), mSignalType(signalType) {}
+
+    SenderQueueItem* Clone() override { return new OTLPSenderQueueItem(*this); }
+};
+
+} // namespace logtail
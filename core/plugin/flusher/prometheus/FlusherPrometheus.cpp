@@ -0,0 +1,472 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/flusher/prometheus/FlusherPrometheus.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "collection_pipeline/batch/FlushStrategy.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "collection_pipeline/serializer/ProtobufWireFormat.h"
+#include "common/EndpointUtil.h"
+#include "common/Flags.h"
+#include "common/ParamExtractor.h"
+#include "common/StringTools.h"
+#include "common/compression/CompressorFactory.h"
+#include "common/http/Constant.h"
+#include "common/version.h"
+#include "logger/Logger.h"
+#include "monitor/AlarmManager.h"
+#include "monitor/metric_constants/MetricConstants.h"
+
+DEFINE_FLAG_INT32(prometheus_flusher_batch_max_size_bytes,
+                  "max size of a remote write request before sharding and compression(bytes)",
+                  8 * 1024 * 1024);
+DEFINE_FLAG_INT32(prometheus_flusher_batch_min_size_bytes, "prometheus flusher batch size limit(bytes)", 1024 * 1024);
+DEFINE_FLAG_INT32(prometheus_flusher_batch_min_cnt, "prometheus flusher batch event count limit", 8000);
+DEFINE_FLAG_INT32(prometheus_flusher_batch_timeout_secs, "prometheus flusher batch timeout(second)", 3);
+DEFINE_FLAG_INT32(prometheus_flusher_shard_cnt, "default number of shards of each prometheus flusher", 4);
+DEFINE_FLAG_INT32(prometheus_flusher_shard_max_concurrency,
+                  "max number of requests sent at the same time by each prometheus flusher shard",
+                  1);
+DEFINE_FLAG_INT32(prometheus_flusher_series_ttl_secs,
+                  "time after which series not seen are evicted from prometheus flusher series cache(second)",
+                  600);
+
+DECLARE_FLAG_INT32(discard_send_fail_interval);
+
+using namespace std;
+
+namespace logtail {
+
+static const string CONTENT_ENCODING = "Content-Encoding";
+static const string REMOTE_WRITE_VERSION = "X-Prometheus-Remote-Write-Version";
+
+const string FlusherPrometheus::sName = "flusher_prometheus_native";
+
+bool FlusherPrometheus::Init(const Json::Value& config, Json::Value& optionalGoPipeline) {
+    string errorMsg;
+
+    // Endpoint
+    if (!GetMandatoryStringParam(config, "Endpoint", mEndpoint, errorMsg)) {
+        PARAM_ERROR_RETURN(mContext->GetLogger(),
+                           mContext->GetAlarm(),
+                           errorMsg,
+                           sName,
+                           mContext->GetConfigName(),
+                           mContext->GetProjectName(),
+                           mContext->GetLogstoreName(),
+                           mContext->GetRegion());
+    }
+    if (!ParseHttpEndpoint(mEndpoint, mHttpsFlag, mHost, mPort, mPath)) {
+        PARAM_ERROR_RETURN(mContext->GetLogger(),
+                           mContext->GetAlarm(),
+                           "string param Endpoint is not a valid url",
+                           sName,
+                           mContext->GetConfigName(),
+                           mContext->GetProjectName(),
+                           mContext->GetLogstoreName(),
+                           mContext->GetRegion());
+    }
+    if (mPath.empty()) {
+        mPath = "/";
+    }
+
+    // Headers
+    if (!GetOptionalMapParam(config, "Headers", mHeaders, errorMsg)) {
+        PARAM_WARNING_IGNORE(mContext->GetLogger(),
+                             mContext->GetAlarm(),
+                             errorMsg,
+                             sName,
+                             mContext->GetConfigName(),
+                             mContext->GetProjectName(),
+                             mContext->GetLogstoreName(),
+                             mContext->GetRegion());
+    }
+
+    // ShardCount
+    mShardCnt = static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_shard_cnt));
+    if (!GetOptionalUIntParam(config, "ShardCount", mShardCnt, errorMsg)) {
+        mShardCnt = static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_shard_cnt));
+        PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                              mContext->GetAlarm(),
+                              errorMsg,
+                              mShardCnt,
+                              sName,
+                              mContext->GetConfigName(),
+                              mContext->GetProjectName(),
+                              mContext->GetLogstoreName(),
+                              mContext->GetRegion());
+    } else if (mShardCnt == 0) {
+        mShardCnt = static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_shard_cnt));
+        PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                              mContext->GetAlarm(),
+                              "uint param ShardCount is 0",
+                              mShardCnt,
+                              sName,
+                              mContext->GetConfigName(),
+                              mContext->GetProjectName(),
+                              mContext->GetLogstoreName(),
+                              mContext->GetRegion());
+    }
+
+    // Batch
+    const char* key = "Batch";
+    const Json::Value* itr = config.find(key, key + strlen(key));
+    if (itr && !itr->isObject()) {
+        PARAM_WARNING_IGNORE(mContext->GetLogger(),
+                             mContext->GetAlarm(),
+                             "param Batch is not of type object",
+                             sName,
+                             mContext->GetConfigName(),
+                             mContext->GetProjectName(),
+                             mContext->GetLogstoreName(),
+                             mContext->GetRegion());
+        itr = nullptr;
+    }
+    DefaultFlushStrategyOptions strategy{static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_batch_max_size_bytes)),
+                                         static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_batch_min_size_bytes)),
+                                         static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_batch_min_cnt)),
+                                         static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_batch_timeout_secs))};
+    if (!mBatcher.Init(itr ? *itr : Json::Value(), this, strategy)) {
+        return false;
+    }
+
+    // remote write only accepts snappy
+    mCompressor = CompressorFactory::GetInstance()->Create(
+        Json::Value(), *mContext, sName, mPluginID, CompressType::SNAPPY);
+
+    // MaxSendRate
+    if (!GetOptionalUIntParam(config, "MaxSendRate", mMaxSendRate, errorMsg)) {
+        PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                              mContext->GetAlarm(),
+                              errorMsg,
+                              mMaxSendRate,
+                              sName,
+                              mContext->GetConfigName(),
+                              mContext->GetProjectName(),
+                              mContext->GetLogstoreName(),
+                              mContext->GetRegion());
+    }
+
+    // the rate limit is shared evenly by all shards
+    uint32_t shardMaxSendRate = mMaxSendRate == 0 ? 0 : max(mMaxSendRate / mShardCnt, 1U);
+    GenerateQueueKey(mEndpoint);
+    const string& queueName = QueueKeyManager::GetInstance()->GetName(mQueueKey);
+    for (uint32_t i = 0; i < mShardCnt; ++i) {
+        auto shard = make_unique<Shard>();
+        shard->mQueueKey
+            = i == 0 ? mQueueKey : QueueKeyManager::GetInstance()->GetKey(queueName + "#shard#" + ToString(i));
+        shard->mConcurrencyLimiter = make_shared<ConcurrencyLimiter>(
+            sName + "#quota#endpoint#" + mEndpoint + "#shard#" + ToString(i),
+            static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_shard_max_concurrency)),
+            1,
+            100);
+        SenderQueueManager::GetInstance()->CreateQueue(shard->mQueueKey,
+                                                       mPluginID,
+                                                       mEndpoint,
+                                                       *mContext,
+                                                       {{"endpoint", shard->mConcurrencyLimiter}},
+                                                       shardMaxSendRate);
+        mShards.emplace_back(std::move(shard));
+    }
+
+    mSendCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_OUT_EVENT_GROUPS_TOTAL);
+    mSendDoneCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_SEND_DONE_TOTAL);
+    mSuccessCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_SUCCESS_TOTAL);
+    mRetryCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_RETRY_TOTAL);
+    mDiscardCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_DISCARD_TOTAL);
+    mNetworkErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_NETWORK_ERROR_TOTAL);
+    mServerErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_SERVER_ERROR_TOTAL);
+    mUnauthErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_UNAUTH_ERROR_TOTAL);
+    mParamsErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_PARAMS_ERROR_TOTAL);
+    mOtherErrorCnt = GetMetricsRecordRef().CreateCounter(METRIC_PLUGIN_FLUSHER_OTHER_ERROR_TOTAL);
+
+    return true;
+}
+
+bool FlusherPrometheus::Start() {
+    for (const auto& shard : mShards) {
+        SenderQueueManager::GetInstance()->ReuseQueue(shard->mQueueKey);
+    }
+    return true;
+}
+
+bool FlusherPrometheus::Stop(bool isPipelineRemoving) {
+    for (const auto& shard : mShards) {
+        SetPipelineForItemsWhenStop(shard->mQueueKey);
+        SenderQueueManager::GetInstance()->DeleteQueue(shard->mQueueKey);
+    }
+    return true;
+}
+
+bool FlusherPrometheus::Send(PipelineEventGroup&& g) {
+    vector<BatchedEventsList> res;
+    mBatcher.Add(std::move(g), res);
+    return SerializeAndPush(std::move(res));
+}
+
+bool FlusherPrometheus::Flush(size_t key) {
+    BatchedEventsList res;
+    mBatcher.FlushQueue(key, res);
+    return SerializeAndPush(std::move(res));
+}
+
+bool FlusherPrometheus::FlushAll() {
+    vector<BatchedEventsList> res;
+    mBatcher.FlushAll(res);
+    return SerializeAndPush(std::move(res));
+}
+
+bool FlusherPrometheus::BuildRequest(SenderQueueItem* item,
+                                     unique_ptr<HttpSinkRequest>& req,
+                                     bool* keepItem,
+                                     string* errMsg) {
+    static const string userAgent = string("ilogtail/") + ILOGTAIL_VERSION;
+
+    ADD_COUNTER(mSendCnt, 1);
+
+    map<string, string> header(mHeaders.begin(), mHeaders.end());
+    header[CONTENT_TYPE] = TYPE_LOG_PROTOBUF;
+    header[CONTENT_ENCODING] = CompressTypeToString(mCompressor->GetCompressType());
+    header[REMOTE_WRITE_VERSION] = "0.1.0";
+    header[USER_AGENT] = userAgent;
+    req = make_unique<HttpSinkRequest>(HTTP_POST, mHttpsFlag, mHost, mPort, mPath, "", header, item->mData, item);
+    return true;
+}
+
+void FlusherPrometheus::OnSendDone(const HttpResponse& response, SenderQueueItem* item) {
+    ADD_COUNTER(mSendDoneCnt, 1);
+
+    auto* shard = GetShard(item->mQueueKey);
+    auto curSystemTime = chrono::system_clock::now();
+    int32_t statusCode = response.GetStatusCode();
+    if (statusCode >= 200 && statusCode < 300) {
+        LOG_DEBUG(sLogger,
+                  ("send data to prometheus remote write receiver succeeded, item address",
+                   item)("endpoint", mEndpoint)("config", mContext->GetConfigName())("try cnt", item->mTryCnt));
+        if (shard) {
+            shard->mConcurrencyLimiter->OnSuccess(curSystemTime);
+        }
+        SenderQueueManager::GetInstance()->DecreaseConcurrencyLimiterInSendingCnt(item->mQueueKey);
+        ADD_COUNTER(mSuccessCnt, 1);
+        DealSenderQueueItemAfterSend(item, false);
+        return;
+    }
+
+    // retriable responses are defined in https://prometheus.io/docs/specs/prw/remote_write_spec/#retries-backoff
+    bool retry = false;
+    string failDetail;
+    if (statusCode == 0) {
+        failDetail = "network error";
+        retry = true;
+        ADD_COUNTER(mNetworkErrorCnt, 1);
+    } else if (statusCode == 429 || statusCode >= 500) {
+        failDetail = "server error";
+        retry = true;
+        ADD_COUNTER(mServerErrorCnt, 1);
+    } else if (statusCode == 401 || statusCode == 403) {
+        failDetail = "write unauthorized";
+        ADD_COUNTER(mUnauthErrorCnt, 1);
+    } else if (statusCode >= 400 && statusCode < 500) {
+        failDetail = "invalid parameters";
+        ADD_COUNTER(mParamsErrorCnt, 1);
+    } else {
+        failDetail = "other error";
+        ADD_COUNTER(mOtherErrorCnt, 1);
+    }
+    if (retry && shard) {
+        shard->mConcurrencyLimiter->OnFail(curSystemTime);
+    }
+    if (chrono::duration_cast<chrono::seconds>(curSystemTime - item->mFirstEnqueTime).count()
+        > INT32_FLAG(discard_send_fail_interval)) {
+        retry = false;
+    }
+
+    LOG_WARNING(sLogger,
+                ("failed to send request", failDetail)("operation", retry ? "retry later" : "discard data")(
+                    "status code", statusCode)("item address", item)("endpoint", mEndpoint)(
+                    "config", mContext->GetConfigName())("try cnt", item->mTryCnt));
+    SenderQueueManager::GetInstance()->DecreaseConcurrencyLimiterInSendingCnt(item->mQueueKey);
+    if (retry) {
+        ADD_COUNTER(mRetryCnt, 1);
+        DealSenderQueueItemAfterSend(item, true);
+    } else {
+        ADD_COUNTER(mDiscardCnt, 1);
+        AlarmManager::GetInstance()->SendAlarmCritical(SEND_DATA_FAIL_ALARM,
+                                                       "failed to send request: " + failDetail
+                                                           + "\toperation: discard data\tstatusCode: "
+                                                           + ToString(statusCode) + "\tconfig: "
+                                                           + mContext->GetConfigName() + "\tendpoint: " + mEndpoint,
+                                                       mContext->GetRegion(),
+                                                       mContext->GetProjectName(),
+                                                       mContext->GetConfigName(),
+                                                       mContext->GetLogstoreName());
+        DealSenderQueueItemAfterSend(item, false);
+    }
+}
+
+vector<QueueKey> FlusherPrometheus::GetQueueKeys() const {
+    vector<QueueKey> res;
+    for (const auto& shard : mShards) {
+        res.push_back(shard->mQueueKey);
+    }
+    return res;
+}
+
+bool FlusherPrometheus::SerializeAndPush(vector<BatchedEventsList>&& groupLists) {
+    bool allSucceeded = true;
+    for (auto& groupList : groupLists) {
+        allSucceeded = SerializeAndPush(std::move(groupList)) && allSucceeded;
+    }
+    return allSucceeded;
+}
+
+bool FlusherPrometheus::SerializeAndPush(BatchedEventsList&& groupList) {
+    vector<vector<Sample>> shardSamples(mShards.size());
+    size_t skippedCnt = 0;
+    auto addSample = [&](const MetricEvent& e, StringView suffix, double value) {
+        uint64_t hash = PrometheusSeriesCache::GetSeriesHash(e, suffix);
+        int64_t timestampMs = static_cast<int64_t>(e.GetTimestamp()) * 1000
+            + static_cast<int64_t>(e.GetTimestampNanosecond().value_or(0) / 1000000);
+        shardSamples[hash % mShards.size()].push_back({hash, &e, suffix, value, timestampMs});
+    };
+    for (const auto& group : groupList) {
+        for (const auto& e : group.mEvents) {
+            if (!e.Is<MetricEvent>()) {
+                ++skippedCnt;
+                continue;
+            }
+            const auto& metricEvent = e.Cast<MetricEvent>();
+            if (metricEvent.Is<UntypedSingleValue>()) {
+                addSample(metricEvent, StringView(), metricEvent.GetValue<UntypedSingleValue>()->mValue);
+            } else if (metricEvent.Is<UntypedMultiDoubleValues>()) {
+                const auto* values = metricEvent.GetValue<UntypedMultiDoubleValues>();
+                for (auto it = values->ValuesBegin(); it != values->ValuesEnd(); ++it) {
+                    addSample(metricEvent, it->first, it->second.Value);
+                }
+            } else {
+                ++skippedCnt;
+            }
+        }
+    }
+    if (skippedCnt > 0) {
+        LOG_WARNING(mContext->GetLogger(),
+                    ("events other than metrics with values are not supported", "discard data")(
+                        "event cnt", skippedCnt)("plugin", sName)("config", mContext->GetConfigName()));
+    }
+
+    bool allSucceeded = true;
+    string serializedData, compressedData, errorMsg;
+    for (size_t i = 0; i < mShards.size(); ++i) {
+        if (shardSamples[i].empty()) {
+            continue;
+        }
+        SerializeWriteRequest(*mShards[i], shardSamples[i], serializedData);
+        if (!mCompressor->DoCompress(serializedData, compressedData, errorMsg)) {
+            LOG_WARNING(mContext->GetLogger(),
+                        ("failed to compress write request",
+                         errorMsg)("action", "discard data")("plugin", sName)("config", mContext->GetConfigName()));
+            mContext->GetAlarm().SendAlarmWarning(COMPRESS_FAIL_ALARM,
+                                                  "failed to compress write request: " + errorMsg
+                                                      + "\taction: discard data\tplugin: " + sName
+                                                      + "\tconfig: " + mContext->GetConfigName(),
+                                                  mContext->GetRegion(),
+                                                  mContext->GetProjectName(),
+                                                  mContext->GetConfigName(),
+                                                  mContext->GetLogstoreName());
+            allSucceeded = false;
+            continue;
+        }
+        allSucceeded = Flusher::PushToQueue(make_unique<SenderQueueItem>(
+                           std::move(compressedData), serializedData.size(), this, mShards[i]->mQueueKey))
+            && allSucceeded;
+    }
+    return allSucceeded;
+}
+
+// WriteRequest: timeseries = 1
+// TimeSeries: labels = 1, samples = 2
+// Sample: value = 1, timestamp = 2
+void FlusherPrometheus::SerializeWriteRequest(Shard& shard, const vector<Sample>& samples, string& res) {
+    struct TimeSeries {
+        // nullptr if the labels are not interned, in which case they are in mOwnedLabels
+        const string* mLabels = nullptr;
+        string mOwnedLabels;
+        vector<const Sample*> mSamples;
+        size_t mSize = 0;
+    };
+
+    time_t now = time(nullptr);
+    lock_guard<mutex> lock(shard.mMux);
+    if (now - shard.mLastEvictTime >= INT32_FLAG(prometheus_flusher_series_ttl_secs)) {
+        shard.mSeriesCache.EvictExpired(now, static_cast<uint32_t>(INT32_FLAG(prometheus_flusher_series_ttl_secs)));
+        shard.mLastEvictTime = now;
+    }
+
+    // samples of the same series are put into one TimeSeries, in the order the series first appear
+    vector<TimeSeries> series;
+    unordered_map<const string*, size_t> seriesIndex;
+    for (const auto& sample : samples) {
+        const string* labels
+            = shard.mSeriesCache.GetLabels(sample.mSeriesHash, *sample.mEvent, sample.mSuffix, now);
+        if (labels == nullptr) {
+            series.emplace_back();
+            PrometheusSeriesCache::EncodeLabels(*sample.mEvent, sample.mSuffix, series.back().mOwnedLabels);
+            series.back().mSamples.push_back(&sample);
+            continue;
+        }
+        auto inserted = seriesIndex.try_emplace(labels, series.size());
+        if (inserted.second) {
+            series.emplace_back();
+            series.back().mLabels = labels;
+        }
+        series[inserted.first->second].mSamples.push_back(&sample);
+    }
+
+    size_t requestSize = 0;
+    for (auto& item : series) {
+        item.mSize = item.mLabels ? item.mLabels->size() : item.mOwnedLabels.size();
+        for (const auto* sample : item.mSamples) {
+            item.mSize += LenFieldSize(kFixed64FieldSize + VarintFieldSize(sample->mTimestampMs));
+        }
+        requestSize += LenFieldSize(item.mSize);
+    }
+    res.clear();
+    res.reserve(requestSize);
+    for (const auto& item : series) {
+        PackLenFieldHeader(1, item.mSize, res);
+        res.append(item.mLabels ? *item.mLabels : item.mOwnedLabels);
+        for (const auto* sample : item.mSamples) {
+            PackLenFieldHeader(2, kFixed64FieldSize + VarintFieldSize(sample->mTimestampMs), res);
+            PackDoubleField(1, sample->mValue, res);
+            PackVarintField(2, sample->mTimestampMs, res);
+        }
+    }
+}
+
+FlusherPrometheus::Shard* FlusherPrometheus::GetShard(QueueKey key) const {
+    for (const auto& shard : mShards) {
+        if (shard->mQueueKey == key) {
+            return shard.get();
+        }
+    }
+    return nullptr;
+}
+
+} // namespace logtail
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "json/json.h"
+
+#include "collection_pipeline/batch/Batcher.h"
+#include "collection_pipeline/limiter/ConcurrencyLimiter.h"
+#include "collection_pipeline/plugin/interface/HttpFlusher.h"
+#include "common/compression/Compressor.h"
+#include "models/MetricEvent.h"
+#include "models/PipelineEventGroup.h"
+#include "monitor/MetricManager.h"
+#include "plugin/flusher/prometheus/PrometheusSeriesCache.h"
+
+namespace logtail {
+
+// Writes metric events to a prometheus compatible storage via remote write 1.0, see
+// https://prometheus.io/docs/specs/prw/remote_write_spec/
+// As prometheus does, series are spread over several shards by their hashes. Each shard has its own sender queue,
+// which sends one request at a time by default, so that samples of a series are always written in order.
+class FlusherPrometheus : public HttpFlusher {
+public:
+    static const std::string sName;
+
+    const std::string& Name() const override { return sName; }
+    bool Init(const Json::Value& config, Json::Value& optionalGoPipeline) override;
+    bool Start() override;
+    bool Stop(bool isPipelineRemoving) override;
+    bool Send(PipelineEventGroup&& g) override;
+    bool Flush(size_t key) override;
+    bool FlushAll() override;
+    bool BuildRequest(SenderQueueItem* item,
+                      std::unique_ptr<HttpSinkRequest>& req,
+                      bool* keepItem,
+                      std::string* errMsg) override;
+    void OnSendDone(const HttpResponse& response, SenderQueueItem* item) override;
+    std::vector<QueueKey> GetQueueKeys() const override;
+
+    std::string mEndpoint;
+    std::unordered_map<std::string, std::string> mHeaders;
+    uint32_t mShardCnt = 0;
+    uint32_t mMaxSendRate = 0;
+
+private:
+    struct Shard {
+        QueueKey mQueueKey = 0;
+        std::shared_ptr<ConcurrencyLimiter> mConcurrencyLimiter;
+        // guards the series cache, since batches may be serialized by several threads at the same time
+        std::mutex mMux;
+        PrometheusSeriesCache mSeriesCache;
+        time_t mLastEvictTime = 0;
+    };
+
+    struct Sample {
+        uint64_t mSeriesHash = 0;
+        const MetricEvent* mEvent = nullptr;
+        StringView mSuffix;
+        double mValue = 0.0;
+        int64_t mTimestampMs = 0;
+    };
+
+    bool SerializeAndPush(std::vector<BatchedEventsList>&& groupLists);
+    bool SerializeAndPush(BatchedEventsList&& groupList);
+    void SerializeWriteRequest(Shard& shard, const std::vector<Sample>& samples, std::string& res);
+    Shard* GetShard(QueueKey key) const;
+
+    bool mHttpsFlag = false;
+    std::string mHost;
+    int32_t mPort = 0;
+    std::string mPath;
+
+    Batcher<> mBatcher;
+    std::unique_ptr<Compressor> mCompressor;
+    std::vector<std::unique_ptr<Shard>> mShards;
+
+    CounterPtr mSendCnt;
+    CounterPtr mSendDoneCnt;
+    CounterPtr mSuccessCnt;
+    CounterPtr mRetryCnt;
+    CounterPtr mDiscardCnt;
+    CounterPtr mNetworkErrorCnt;
+    CounterPtr mServerErrorCnt;
+    CounterPtr mUnauthErrorCnt;
+    CounterPtr mParamsErrorCnt;
+    CounterPtr mOtherErrorCnt;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FlusherPrometheusUnittest;
+    friend class FlusherPrometheusBenchmark;
+#endif
+};
+
+} // namespace logtail
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/flusher/prometheus/PrometheusSeriesCache.h"
+
+#include <xxhash/xxhash.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "collection_pipeline/serializer/ProtobufWireFormat.h"
+#include "prometheus/Constants.h"
+
+using namespace std;
+
+namespace logtail {
+
+// the name label is always taken from the metric name
+static inline bool IsLabel(const pair<StringView, StringView>& tag) {
+    return !tag.second.empty() && tag.first != prometheus::NAME;
+}
+
+// reads a Label message, i.e. name = 1, value = 2, from a labels field encoded by EncodeLabels
+static inline void ReadLabel(const char*& p, StringView& name, StringView& value) {
+    auto readLen = [&p]() {
+        size_t len = 0;
+        for (uint32_t shift = 0;; shift += 7) {
+            auto b = static_cast<uint8_t>(*p++);
+            len |= static_cast<size_t>(b & 0x7F) << shift;
+            if (b < 0x80) {
+                return len;
+            }
+        }
+    };
+    ++p;
+    readLen();
+    ++p;
+    size_t len = readLen();
+    name = StringView(p, len);
+    p += len;
+    ++p;
+    len = readLen();
+    value = StringView(p, len);
+    p += len;
+}
+
+uint64_t PrometheusSeriesCache::GetSeriesHash(const MetricEvent& e, StringView suffix) {
+    StringView name = e.GetName();
+    uint64_t hash = XXH64(name.data(), name.size(), 0);
+    if (!suffix.empty()) {
+        hash = XXH64(suffix.data(), suffix.size(), hash);
+    }
+    uint64_t tagsHash = 0;
+    for (auto it = e.TagsBegin(); it != e.TagsEnd(); ++it) {
+        if (!IsLabel(*it)) {
+            continue;
+        }
+        tagsHash += XXH64(it->second.data(), it->second.size(), XXH64(it->first.data(), it->first.size(), 0));
+    }
+    return XXH64(&tagsHash, sizeof(tagsHash), hash);
+}
+
+void PrometheusSeriesCache::EncodeLabels(const MetricEvent& e, StringView suffix, string& res) {
+    string name = e.GetName().to_string();
+    if (!suffix.empty()) {
+        name.push_back('_');
+        name.append(suffix.data(), suffix.size());
+    }
+    vector<pair<StringView, StringView>> labels;
+    labels.reserve(e.TagsSize() + 1);
+    labels.emplace_back(prometheus::NAME, name);
+    for (auto it = e.TagsBegin(); it != e.TagsEnd(); ++it) {
+        if (IsLabel(*it)) {
+            labels.emplace_back(it->first, it->second);
+        }
+    }
+    // labels must be sorted by name, see https://prometheus.io/docs/specs/prw/remote_write_spec/#labels
+    sort(labels.begin(), labels.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    res.clear();
+    for (const auto& label : labels) {
+        PackLenFieldHeader(1, LenFieldSize(label.first.size()) + LenFieldSize(label.second.size()), res);
+        PackStringField(1, label.first, res);
+        PackStringField(2, label.second, res);
+    }
+}
+
+const string* PrometheusSeriesCache::GetLabels(uint64_t hash, const MetricEvent& e, StringView suffix, time_t now) {
+    auto res = mSeries.try_emplace(hash);
+    auto& series = res.first->second;
+    if (res.second) {
+        EncodeLabels(e, suffix, series.mLabels);
+        mDataSize += series.mLabels.size();
+    } else if (!IsSameSeries(series.mLabels, e, suffix)) {
+        return nullptr;
+    }
+    series.mLastSeenTime = now;
+    return &series.mLabels;
+}
+
+size_t PrometheusSeriesCache::EvictExpired(time_t now, uint32_t ttlSecs) {
+    size_t cnt = 0;
+    for (auto it = mSeries.begin(); it != mSeries.end();) {
+        if (now - it->second.mLastSeenTime >= static_cast<time_t>(ttlSecs)) {
+            mDataSize -= it->second.mLabels.size();
+            it = mSeries.erase(it);
+            ++cnt;
+        } else {
+            ++it;
+        }
+    }
+    return cnt;
+}
+
+// compares the encoded labels with the series in place, so that nothing is allocated for a series already interned
+bool PrometheusSeriesCache::IsSameSeries(const string& labels, const MetricEvent& e, StringView suffix) {
+    StringView metricName = e.GetName();
+    size_t labelCnt = 0;
+    const char* p = labels.data();
+    const char* end = p + labels.size();
+    while (p < end) {
+        StringView name, value;
+        ReadLabel(p, name, value);
+        ++labelCnt;
+        if (name == prometheus::NAME) {
+            if (suffix.empty()) {
+                if (value != metricName) {
+                    return false;
+                }
+            } else if (value.size() != metricName.size() + 1 + suffix.size()
+                       || value.substr(0, metricName.size()) != metricName || value[metricName.size()] != '_'
+                       || value.substr(metricName.size() + 1) != suffix) {
+                return false;
+            }
+            continue;
+        }
+        auto isSameLabel = [&](const auto& tag) { return tag.first == name && tag.second == value; };
+        if (find_if(e.TagsBegin(), e.TagsEnd(), isSameLabel) == e.TagsEnd()) {
+            return false;
+        }
+    }
+    return labelCnt == 1 + static_cast<size_t>(count_if(e.TagsBegin(), e.TagsEnd(), IsLabel));
+}
+
+} // namespace logtail
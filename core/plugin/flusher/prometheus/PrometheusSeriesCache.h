@@ -0,0 +1,62 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+#include <string>
+#include <unordered_map>
+
+#include "common/StringView.h"
+#include "models/MetricEvent.h"
+
+namespace logtail {
+
+// Interns the label set of each series in its encoded form, i.e. the labels field of a remote write TimeSeries, so
+// that the labels are sorted and encoded once for each series rather than once for each sample. A series is the
+// metric name, optionally suffixed by the key of a multi-value metric, plus the non-empty event tags.
+// Not thread-safe.
+class PrometheusSeriesCache {
+public:
+    // The hash ignores the order of the tags, so that the same series is always sent in the same shard.
+    static uint64_t GetSeriesHash(const MetricEvent& e, StringView suffix);
+    static void EncodeLabels(const MetricEvent& e, StringView suffix, std::string& res);
+
+    // Returns the encoded labels of the series, which stay valid until the next call to EvictExpired. Returns nullptr
+    // in the rare case that the hash is already taken by another series.
+    const std::string* GetLabels(uint64_t hash, const MetricEvent& e, StringView suffix, time_t now);
+    // Evicts series not seen for ttlSecs, and returns the number of series evicted.
+    size_t EvictExpired(time_t now, uint32_t ttlSecs);
+
+    size_t Size() const { return mSeries.size(); }
+    // bytes of the encoded labels interned
+    size_t DataSize() const { return mDataSize; }
+
+private:
+    struct Series {
+        std::string mLabels;
+        time_t mLastSeenTime = 0;
+    };
+
+    static bool IsSameSeries(const std::string& labels, const MetricEvent& e, StringView suffix);
+
+    std::unordered_map<uint64_t, Series> mSeries;
+    size_t mDataSize = 0;
+};
+
+} // namespace logtail
@@ -0,0 +1,158 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "plugin/flusher/sls/DiskBufferSegment.h"
+
+#include <cstring>
+
+#include <chrono>
+#include <thread>
+
+#include "common/ErrorUtil.h"
+#include "common/FileSystemUtil.h"
+#include "logger/Logger.h"
+
+using namespace std;
+
+namespace logtail {
+
+static bool ReadWholeFile(const string& filePath, string& content) {
+    FILE* fin = nullptr;
+    for (int retryTimes = 1;; ++retryTimes) {
+        fin = FileReadOnlyOpen(filePath.c_str(), "rb");
+        if (fin != nullptr) {
+            break;
+        }
+        if (retryTimes >= 3) {
+            return false;
+        }
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    fseek(fin, 0, SEEK_END);
+    auto size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(fin);
+        return false;
+    }
+    content.resize(size);
+    // the size may change if the file is still being written, then only the complete records read are used
+    content.resize(fread(content.data(), 1, size, fin));
+    fclose(fin);
+    return true;
+}
+
+const int32_t DiskBufferSegment::BUFFER_META_BASE_SIZE = 65536;
+const string DiskBufferSegment::ACK_FILE_SUFFIX = ".ack";
+
+DiskBufferSegment::~DiskBufferSegment() {
+    if (mAckFile != nullptr) {
+        fclose(mAckFile);
+    }
+}
+
+bool DiskBufferSegment::Load(size_t headerSize, string& errorMsg) {
+    mContent.clear();
+    mRecords.clear();
+    mHasTruncatedTail = false;
+    if (!ReadWholeFile(mFilePath, mContent)) {
+        errorMsg = ErrnoToString(GetErrno());
+        return false;
+    }
+    size_t pos = headerSize;
+    while (pos < mContent.size()) {
+        if (mContent.size() - pos < sizeof(EncryptionStateMeta)) {
+            mHasTruncatedTail = true;
+            break;
+        }
+        Record record;
+        memcpy(&record.mMeta, mContent.data() + pos, sizeof(EncryptionStateMeta));
+        int32_t encodedInfoSize = record.mMeta.mEncodedInfoSize;
+        if (encodedInfoSize > BUFFER_META_BASE_SIZE) {
+            encodedInfoSize -= BUFFER_META_BASE_SIZE;
+            record.mPbMeta = true;
+        }
+        if (record.mMeta.mEncryptionSize < 0 || encodedInfoSize < 0 || record.mMeta.mLogDataSize < 0) {
+            mHasTruncatedTail = true;
+            break;
+        }
+        record.mOffset = pos;
+        record.mEncodedInfoOffset = pos + sizeof(EncryptionStateMeta);
+        record.mEncodedInfoSize = encodedInfoSize;
+        record.mEncryptionOffset = record.mEncodedInfoOffset + record.mEncodedInfoSize;
+        if (record.mEncryptionOffset > mContent.size()
+            || mContent.size() - record.mEncryptionOffset < static_cast<size_t>(record.mMeta.mEncryptionSize)) {
+            mHasTruncatedTail = true;
+            break;
+        }
+        pos = record.mEncryptionOffset + record.mMeta.mEncryptionSize;
+        mRecords.emplace_back(record);
+    }
+    LoadAcks();
+    return true;
+}
+
+bool DiskBufferSegment::IsAcked(const Record& record) const {
+    return record.mMeta.mHandled == 1 || mAckedOffsets.find(record.mOffset) != mAckedOffsets.end();
+}
+
+bool DiskBufferSegment::Ack(const Record& record) {
+    if (mAckFile == nullptr) {
+        mAckFile = FileAppendOpen(GetAckFilePath(mFilePath).c_str(), "ab");
+        if (mAckFile == nullptr) {
+            LOG_ERROR(sLogger,
+                      ("failed to open ack file of buffer file", ErrnoToString(GetErrno()))("file", mFilePath));
+            return false;
+        }
+    }
+    int64_t offset = record.mOffset;
+    // flushed at once, so that the record is not resent after restart
+    if (fwrite(&offset, sizeof(offset), 1, mAckFile) != 1 || fflush(mAckFile) != 0) {
+        LOG_ERROR(sLogger,
+                  ("failed to write ack file of buffer file", ErrnoToString(GetErrno()))("file", mFilePath));
+        return false;
+    }
+    mAckedOffsets.insert(offset);
+    return true;
+}
+
+void DiskBufferSegment::Remove() {
+    if (mAckFile != nullptr) {
+        fclose(mAckFile);
+        mAckFile = nullptr;
+    }
+    RemoveFiles(mFilePath);
+}
+
+void DiskBufferSegment::RemoveFiles(const string& filePath) {
+    remove(filePath.c_str());
+    remove(GetAckFilePath(filePath).c_str());
+}
+
+void DiskBufferSegment::LoadAcks() {
+    mAckedOffsets.clear();
+    string content;
+    string ackFilePath = GetAckFilePath(mFilePath);
+    if (!CheckExistance(ackFilePath) || !ReadWholeFile(ackFilePath, content)) {
+        return;
+    }
+    // a partially written offset at the end is ignored, and the record is resent
+    for (size_t pos = 0; pos + sizeof(int64_t) <= content.size(); pos += sizeof(int64_t)) {
+        int64_t offset = 0;
+        memcpy(&offset, content.data() + pos, sizeof(offset));
+        mAckedOffsets.insert(offset);
+    }
+}
+
+} // namespace logtail
@@ -0,0 +1,90 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace logtail {
+
+struct EncryptionStateMeta {
+    int32_t mLogDataSize;
+    int32_t mEncryptionSize;
+    int32_t mEncodedInfoSize;
+    int32_t mTimeStamp;
+    int32_t mHandled;
+    int32_t mRetryTime;
+};
+
+// A buffer file is an append-only segment which consists of a header followed by records, each of which is an
+// EncryptionStateMeta, the encoded buffer meta and the encrypted data.
+// The whole segment is read in one go and indexed when loaded. Records that have been handled are acked by appending
+// their offsets to a sidecar file named <segment>.ack, so that the segment itself is never modified after written.
+// mHandled in the meta is still honored for buffer files written by older versions.
+class DiskBufferSegment {
+public:
+    static const int32_t BUFFER_META_BASE_SIZE;
+    static const std::string ACK_FILE_SUFFIX;
+
+    struct Record {
+        EncryptionStateMeta mMeta;
+        size_t mOffset = 0;
+        size_t mEncodedInfoOffset = 0;
+        size_t mEncodedInfoSize = 0;
+        // true if the encoded info is LogtailBufferMeta in protobuf, otherwise project name for old buffer files
+        bool mPbMeta = false;
+        size_t mEncryptionOffset = 0;
+    };
+
+    explicit DiskBufferSegment(const std::string& filePath) : mFilePath(filePath) {}
+    DiskBufferSegment(const DiskBufferSegment&) = delete;
+    DiskBufferSegment& operator=(const DiskBufferSegment&) = delete;
+    ~DiskBufferSegment();
+
+    bool Load(size_t headerSize, std::string& errorMsg);
+    const std::vector<Record>& GetRecords() const { return mRecords; }
+    std::string GetEncodedInfo(const Record& record) const {
+        return mContent.substr(record.mEncodedInfoOffset, record.mEncodedInfoSize);
+    }
+    const char* GetEncryption(const Record& record) const { return mContent.data() + record.mEncryptionOffset; }
+    bool IsAcked(const Record& record) const;
+    bool Ack(const Record& record);
+    // true if the segment is corrupted, i.e. there are bytes after the last complete record
+    bool HasTruncatedTail() const { return mHasTruncatedTail; }
+    void Remove();
+
+    static std::string GetAckFilePath(const std::string& filePath) { return filePath + ACK_FILE_SUFFIX; }
+    static void RemoveFiles(const std::string& filePath);
+
+private:
+    void LoadAcks();
+
+    const std::string mFilePath;
+    std::string mContent;
+    std::vector<Record> mRecords;
+    bool mHasTruncatedTail = false;
+    std::unordered_set<int64_t> mAckedOffsets;
+    FILE* mAckFile = nullptr;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class DiskBufferSegmentUnittest;
+#endif
+};
+
+} // namespace logtail
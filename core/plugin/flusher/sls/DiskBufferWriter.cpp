@@ -31,6 +31,7 @@
 #include "common/TimeUtil.h"
 #include "logger/Logger.h"
 #include "monitor/AlarmManager.h"
+#include "plugin/flusher/sls/DiskBufferSegment.h"
 #include "plugin/flusher/sls/FlusherSLS.h"
 #include "plugin/flusher/sls/SLSClientManager.h"
 #include "plugin/flusher/sls/SLSConstant.h"
@@ -50,6 +51,7 @@ DEFINE_FLAG_INT32(send_retry_sleep_interval, "sleep microseconds when sync send
 DEFINE_FLAG_INT32(buffer_check_period, "check logtail local storage buffer period", 60);
 DEFINE_FLAG_INT32(unauthorized_wait_interval, "", 1);
 DEFINE_FLAG_INT32(send_retrytimes, "how many times should retry if PostLogStoreLogs operation fail", 3);
+DEFINE_FLAG_INT32(buffer_file_send_concurrency, "max count of buffer files sent concurrently", 4);
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
 
@@ -103,8 +105,8 @@ static const string& GetSLSCompressTypeString(sls_logs::SlsCompressType compress
     }
 }
 
-const int32_t DiskBufferWriter::BUFFER_META_BASE_SIZE = 65536;
 const size_t DiskBufferWriter::BUFFER_META_MAX_SIZE = 1 * 1024 * 1024;
+const size_t DiskBufferWriter::BUFFER_FILE_WRITE_BUFFER_SIZE = 1 * 1024 * 1024;
 
 void DiskBufferWriter::Init() {
     mBufferDivideTime = time(NULL);
@@ -195,8 +197,20 @@ void DiskBufferWriter::BufferWriterThread() {
                 delete *itr;
             }
             res.clear();
+            // write errors of buffered records only surface here
+            if (mBufferFile != nullptr && fflush(mBufferFile) != 0) {
+                string errorStr = ErrnoToString(GetErrno());
+                AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                               string("flush file error:") + GetBufferFileName()
+                                                                   + ", error:" + errorStr);
+                LOG_ERROR(sLogger,
+                          ("flush buffer file", "fail")("filename", GetBufferFileName())("errorStr", errorStr));
+                // records after a partially written one cannot be read, so write them to a new file
+                CreateNewFile();
+            }
         }
     }
+    CloseBufferFile();
 }
 
 void DiskBufferWriter::BufferSenderThread() {
@@ -215,40 +229,18 @@ void DiskBufferWriter::BufferSenderThread() {
         // mIsSendingBuffer = true;
         int32_t fileToSendCount = int32_t(filesToSend.size());
         int32_t bufferFileNumValue = AppConfig::GetInstance()->GetNumOfBufferFile();
+        vector<string> fileNames;
         for (int32_t i = (fileToSendCount > bufferFileNumValue ? fileToSendCount - bufferFileNumValue : 0);
-             i < fileToSendCount && mIsSendBufferThreadRunning;
+             i < fileToSendCount;
              ++i) {
-            string fileName = GetBufferFilePath() + filesToSend[i];
-            unordered_map<string, string> kvMap;
-            if (FileEncryption::CheckHeader(fileName, kvMap)) {
-                int32_t keyVersion = -1;
-                if (kvMap.find(STRING_FLAG(file_encryption_field_key_version)) != kvMap.end()) {
-                    if (!StringTo(kvMap[STRING_FLAG(file_encryption_field_key_version)], keyVersion)) {
-                        LOG_ERROR(sLogger,
-                                  ("convert key_version to int32_t fail",
-                                   kvMap[STRING_FLAG(file_encryption_field_key_version)]));
-                    }
-                }
-                if (keyVersion >= 1 && keyVersion <= FileEncryption::GetInstance()->GetDefaultKeyVersion()) {
-                    LOG_INFO(sLogger, ("check local encryption file", fileName)("key_version", keyVersion));
-                    SendEncryptionBuffer(fileName, keyVersion);
-                } else {
-                    remove(fileName.c_str());
-                    LOG_ERROR(sLogger,
-                              ("invalid key_version in header",
-                               kvMap[STRING_FLAG(file_encryption_field_key_version)])("delete bufffer file", fileName));
-                    AlarmManager::GetInstance()->SendAlarmCritical(
-                        DISCARD_SECONDARY_ALARM, "key version in buffer file invalid, delete file: " + fileName);
-                }
-            } else {
-                remove(fileName.c_str());
-                LOG_WARNING(sLogger, ("check header of buffer file failed, delete file", fileName));
-                AlarmManager::GetInstance()->SendAlarmCritical(
-                    DISCARD_SECONDARY_ALARM, "check header of buffer file failed, delete file: " + fileName);
-            }
+            fileNames.emplace_back(GetBufferFilePath() + filesToSend[i]);
         }
+        SendBufferFiles(fileNames);
 #ifdef __ENTERPRISE__
-        mCandidateHostsInfos.clear();
+        {
+            lock_guard<mutex> hostsLock(mCandidateHostsInfosMux);
+            mCandidateHostsInfos.clear();
+        }
 #endif
         // mIsSendingBuffer = false;
         lock.lock();
@@ -258,6 +250,60 @@ void DiskBufferWriter::BufferSenderThread() {
     }
 }
 
+// buffer files are independent of each other, so they are sent concurrently to speed up replaying after a long outage
+void DiskBufferWriter::SendBufferFiles(const std::vector<std::string>& fileNames) {
+    atomic_size_t next = 0;
+    auto sendBufferFiles = [&]() {
+        for (size_t i = next++; i < fileNames.size() && IsSendBufferThreadRunning(); i = next++) {
+            SendBufferFile(fileNames[i]);
+        }
+    };
+    size_t concurrency = min(static_cast<size_t>(max(INT32_FLAG(buffer_file_send_concurrency), 1)), fileNames.size());
+    vector<future<void>> res;
+    for (size_t i = 1; i < concurrency; ++i) {
+        res.emplace_back(async(launch::async, sendBufferFiles));
+    }
+    sendBufferFiles();
+    for (auto& r : res) {
+        r.get();
+    }
+}
+
+void DiskBufferWriter::SendBufferFile(const std::string& fileName) {
+    unordered_map<string, string> kvMap;
+    if (FileEncryption::CheckHeader(fileName, kvMap)) {
+        int32_t keyVersion = -1;
+        if (kvMap.find(STRING_FLAG(file_encryption_field_key_version)) != kvMap.end()) {
+            if (!StringTo(kvMap[STRING_FLAG(file_encryption_field_key_version)], keyVersion)) {
+                LOG_ERROR(sLogger,
+                          ("convert key_version to int32_t fail",
+                           kvMap[STRING_FLAG(file_encryption_field_key_version)]));
+            }
+        }
+        if (keyVersion >= 1 && keyVersion <= FileEncryption::GetInstance()->GetDefaultKeyVersion()) {
+            LOG_INFO(sLogger, ("check local encryption file", fileName)("key_version", keyVersion));
+            SendEncryptionBuffer(fileName, keyVersion);
+        } else {
+            DiskBufferSegment::RemoveFiles(fileName);
+            LOG_ERROR(sLogger,
+                      ("invalid key_version in header",
+                       kvMap[STRING_FLAG(file_encryption_field_key_version)])("delete bufffer file", fileName));
+            AlarmManager::GetInstance()->SendAlarmCritical(
+                DISCARD_SECONDARY_ALARM, "key version in buffer file invalid, delete file: " + fileName);
+        }
+    } else {
+        DiskBufferSegment::RemoveFiles(fileName);
+        LOG_WARNING(sLogger, ("check header of buffer file failed, delete file", fileName));
+        AlarmManager::GetInstance()->SendAlarmCritical(
+            DISCARD_SECONDARY_ALARM, "check header of buffer file failed, delete file: " + fileName);
+    }
+}
+
+bool DiskBufferWriter::IsSendBufferThreadRunning() const {
+    lock_guard<mutex> lock(mBufferSenderThreadRunningMux);
+    return mIsSendBufferThreadRunning;
+}
+
 void DiskBufferWriter::SetBufferFilePath(const std::string& bufferfilepath) {
     lock_guard<mutex> lock(mBufferFileLock);
     if (bufferfilepath == "") {
@@ -317,6 +363,15 @@ bool DiskBufferWriter::LoadFileToSend(time_t timeLine, std::vector<std::string>&
     while ((ent = dir.ReadNext())) {
         string filename = ent.Name();
         if (filename.find(GetSendBufferFileNamePrefix()) == 0) {
+            if (EndWith(filename, DiskBufferSegment::ACK_FILE_SUFFIX)) {
+                // the buffer file may be removed before its ack file when the process exits
+                string bufferFileName
+                    = bufferFilePath + filename.substr(0, filename.size() - DiskBufferSegment::ACK_FILE_SUFFIX.size());
+                if (!CheckExistance(bufferFileName)) {
+                    remove((bufferFilePath + filename).c_str());
+                }
+                continue;
+            }
             int32_t filetime{};
             if (!StringTo(filename.substr(GetSendBufferFileNamePrefix().size()), filetime)) {
                 LOG_INFO(sLogger, ("can not get file time from file name", filename));
@@ -331,109 +386,18 @@ bool DiskBufferWriter::LoadFileToSend(time_t timeLine, std::vector<std::string>&
     return true;
 }
 
-bool DiskBufferWriter::ReadNextEncryption(int32_t& pos,
-                                          const std::string& filename,
-                                          std::string& encryption,
-                                          EncryptionStateMeta& meta,
-                                          bool& readResult,
-                                          sls_logs::LogtailBufferMeta& bufferMeta) {
-    bufferMeta.Clear();
-    readResult = false;
-    encryption.clear();
-    int retryTimes = 0;
-
-    FILE* fin = NULL;
-    while (true) {
-        retryTimes++;
-        fin = FileReadOnlyOpen(filename.c_str(), "rb");
-        if (fin)
-            break;
-        if (retryTimes >= 3) {
-            string errorStr = ErrnoToString(GetErrno());
-            AlarmManager::GetInstance()->SendAlarmCritical(
-                SECONDARY_READ_WRITE_ALARM, string("open file error:") + filename + ",error:" + errorStr);
-            LOG_ERROR(sLogger, ("open file error", filename)("error", errorStr));
-            return false;
-        }
-        usleep(5000);
-    }
-    fseek(fin, 0, SEEK_END);
-    auto const currentSize = ftell(fin);
-    if (currentSize == pos) {
-        fclose(fin);
-        return false;
-    }
-    fseek(fin, pos, SEEK_SET);
-    auto nbytes = fread(static_cast<void*>(&meta), sizeof(char), sizeof(meta), fin);
-    if (nbytes != sizeof(meta)) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(
-            SECONDARY_READ_WRITE_ALARM,
-            string("read encryption file meta error:") + filename + ", error:" + errorStr
-                + ", meta.mEncryptionSize:" + ToString(meta.mEncryptionSize) + ", nbytes: " + ToString(nbytes)
-                + ", pos: " + ToString(pos) + ", ftell: " + ToString(currentSize));
-        LOG_ERROR(sLogger,
-                  ("read encryption file meta error",
-                   filename)("error", errorStr)("nbytes", nbytes)("pos", pos)("ftell", currentSize));
-        fclose(fin);
-        return false;
-    }
-
-    bool pbMeta = false;
-    int32_t encodedInfoSize = meta.mEncodedInfoSize;
-    if (encodedInfoSize > BUFFER_META_BASE_SIZE) {
-        encodedInfoSize -= BUFFER_META_BASE_SIZE;
-        pbMeta = true;
-    }
-
-    if (meta.mEncryptionSize < 0 || encodedInfoSize < 0) {
-        AlarmManager::GetInstance()->SendAlarmCritical(
-            SECONDARY_READ_WRITE_ALARM,
-            string("meta of encryption file invalid:" + filename + ", meta.mEncryptionSize:"
-                   + ToString(meta.mEncryptionSize) + ", meta.mEncodedInfoSize:" + ToString(meta.mEncodedInfoSize)));
-        LOG_ERROR(sLogger,
-                  ("meta of encryption file invalid", filename)("meta.mEncryptionSize", meta.mEncryptionSize)(
-                      "meta.mEncodedInfoSize", meta.mEncodedInfoSize));
-        fclose(fin);
-        return false;
-    }
-
-    pos += sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
-    if ((time(NULL) - meta.mTimeStamp) > INT32_FLAG(log_expire_time) || meta.mHandled == 1) {
-        fclose(fin);
-        if (meta.mHandled != 1) {
-            LOG_WARNING(sLogger, ("timeout buffer file, meta.mTimeStamp", meta.mTimeStamp));
-            AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
-                                                           "buffer file timeout (1day), delete file: " + filename);
-        }
-        return true;
-    }
-
-    char* buffer = new char[encodedInfoSize + 1];
-    nbytes = fread(buffer, sizeof(char), encodedInfoSize, fin);
-    if (nbytes != static_cast<size_t>(encodedInfoSize)) {
-        fclose(fin);
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(
-            SECONDARY_READ_WRITE_ALARM,
-            string("read projectname from file error:") + filename + ", error:" + errorStr
-                + ", meta.mEncodedInfoSize:" + ToString(meta.mEncodedInfoSize) + ", nbytes:" + ToString(nbytes));
-        LOG_ERROR(sLogger,
-                  ("read encodedInfo from file error",
-                   filename)("error", errorStr)("meta.mEncodedInfoSize", meta.mEncodedInfoSize)("nbytes", nbytes));
-        delete[] buffer;
-        return true;
-    }
-    string encodedInfo = string(buffer, encodedInfoSize);
-    delete[] buffer;
-    if (pbMeta) {
+bool DiskBufferWriter::ReadBufferMeta(const std::string& filename,
+                                      const DiskBufferSegment& segment,
+                                      const DiskBufferSegment::Record& record,
+                                      sls_logs::LogtailBufferMeta& bufferMeta) {
+    string encodedInfo = segment.GetEncodedInfo(record);
+    if (record.mPbMeta) {
         if (!bufferMeta.ParseFromString(encodedInfo)) {
-            fclose(fin);
             AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
                                                            string("parse buffer meta from file error:") + filename);
             LOG_ERROR(sLogger, ("parse buffer meta from file error", filename)("buffer meta", encodedInfo));
             bufferMeta.Clear();
-            return true;
+            return false;
         }
     } else {
         bufferMeta.set_project(encodedInfo);
@@ -454,55 +418,55 @@ bool DiskBufferWriter::ReadNextEncryption(int32_t& pos,
     if (!bufferMeta.has_endpoint()) {
         bufferMeta.set_endpoint("");
     }
+    return true;
+}
 
-    buffer = new char[meta.mEncryptionSize + 1];
-    nbytes = fread(buffer, sizeof(char), meta.mEncryptionSize, fin);
-    if (nbytes != static_cast<size_t>(meta.mEncryptionSize)) {
-        fclose(fin);
-        string errorStr = ErrnoToString(GetErrno());
+void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t keyVersion) {
+    DiskBufferSegment segment(filename);
+    string errorMsg;
+    if (!segment.Load(INT32_FLAG(file_encryption_header_length), errorMsg)) {
+        AlarmManager::GetInstance()->SendAlarmCritical(
+            SECONDARY_READ_WRITE_ALARM, string("open file error:") + filename + ",error:" + errorMsg);
+        LOG_ERROR(sLogger, ("open file error", filename)("error", errorMsg));
+        return;
+    }
+    if (segment.HasTruncatedTail()) {
         AlarmManager::GetInstance()->SendAlarmCritical(
             SECONDARY_READ_WRITE_ALARM,
-            string("read encryption from file error:") + filename + ",error:" + errorStr
-                + ",meta.mEncryptionSize:" + ToString(meta.mEncryptionSize) + ", nbytes:" + ToString(nbytes),
-            bufferMeta.region(),
-            bufferMeta.project(),
-            "",
-            bufferMeta.logstore());
+            string("buffer file truncated:") + filename
+                + ", record count:" + ToString(segment.GetRecords().size()));
         LOG_ERROR(sLogger,
-                  ("read encryption from file error",
-                   filename)("error", errorStr)("meta.mEncryptionSize", meta.mEncryptionSize)("nbytes", nbytes));
-        delete[] buffer;
-        return true;
+                  ("buffer file truncated", filename)("action", "discard the incomplete record")(
+                      "record count", segment.GetRecords().size()));
     }
-    encryption = string(buffer, meta.mEncryptionSize);
-    readResult = true;
-    delete[] buffer;
-    fclose(fin);
-    return true;
-}
 
-void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t keyVersion) {
-    string encryption;
-    string logData;
-    EncryptionStateMeta meta;
-    bool readResult;
     bool writeBack = false;
-    int32_t pos = INT32_FLAG(file_encryption_header_length);
-    sls_logs::LogtailBufferMeta bufferMeta;
     int32_t discardCount = 0;
-    while (ReadNextEncryption(pos, filename, encryption, meta, readResult, bufferMeta)) {
-        logData.clear();
+    for (const auto& record : segment.GetRecords()) {
+        if (segment.IsAcked(record)) {
+            continue;
+        }
+        const auto& meta = record.mMeta;
+        sls_logs::LogtailBufferMeta bufferMeta;
+        string logData;
         bool sendResult = false;
-        if (!readResult || !CheckBufferMetaValidation(filename, bufferMeta)) {
-            if (meta.mHandled == 1)
-                continue;
+        if ((time(NULL) - meta.mTimeStamp) > INT32_FLAG(log_expire_time)) {
+            LOG_WARNING(sLogger, ("timeout buffer file, meta.mTimeStamp", meta.mTimeStamp));
+            AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
+                                                           "buffer file timeout (1day), delete file: " + filename);
             sendResult = true;
             discardCount++;
-        }
-        if (!sendResult) {
-            char* des = new char[meta.mLogDataSize];
-            if (!FileEncryption::GetInstance()->Decrypt(
-                    encryption.c_str(), meta.mEncryptionSize, des, meta.mLogDataSize, keyVersion)) {
+        } else if (!ReadBufferMeta(filename, segment, record, bufferMeta)
+                   || !CheckBufferMetaValidation(filename, bufferMeta)) {
+            sendResult = true;
+            discardCount++;
+        } else {
+            logData.resize(meta.mLogDataSize);
+            if (!FileEncryption::GetInstance()->Decrypt(segment.GetEncryption(record),
+                                                        meta.mEncryptionSize,
+                                                        logData.data(),
+                                                        meta.mLogDataSize,
+                                                        keyVersion)) {
                 sendResult = true;
                 discardCount++;
                 LOG_ERROR(sLogger,
@@ -517,11 +481,10 @@ void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t
                     "",
                     bufferMeta.logstore());
             } else {
-                if (bufferMeta.has_logstore())
-                    logData = string(des, meta.mLogDataSize);
-                else {
+                if (!bufferMeta.has_logstore()) {
                     // compatible to old buffer file (logGroup string), convert to LZ4 compressed
-                    string logGroupStr = string(des, meta.mLogDataSize);
+                    string logGroupStr = std::move(logData);
+                    logData.clear();
                     sls_logs::LogGroup logGroup;
                     if (!logGroup.ParseFromString(logGroupStr)) {
                         sendResult = true;
@@ -634,31 +597,21 @@ void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t
                     }
                 }
             }
-            delete[] des;
         }
-        if (sendResult)
-            meta.mHandled = 1;
         LOG_DEBUG(sLogger,
                   ("send LogGroup from local buffer file", filename)("rawsize", bufferMeta.rawsize())("sendResult",
                                                                                                       sendResult));
-        WriteBackMeta(pos - meta.mEncryptionSize - sizeof(meta)
-                          - (meta.mEncodedInfoSize > BUFFER_META_BASE_SIZE
-                                 ? (meta.mEncodedInfoSize - BUFFER_META_BASE_SIZE)
-                                 : meta.mEncodedInfoSize),
-                      (char*)&meta,
-                      sizeof(meta),
-                      filename);
-        if (!sendResult)
+        // records handled are acked instead of being marked in the buffer file, and those failed to be acked are
+        // resent next time
+        if (!sendResult || !segment.Ack(record)) {
             writeBack = true;
-        {
-            lock_guard<mutex> lock(mBufferSenderThreadRunningMux);
-            if (!mIsSendBufferThreadRunning) {
-                return;
-            }
+        }
+        if (!IsSendBufferThreadRunning()) {
+            return;
         }
     }
     if (!writeBack) {
-        remove(filename.c_str());
+        segment.Remove();
         if (discardCount > 0) {
             LOG_ERROR(sLogger, ("send buffer file, discard LogGroup count", discardCount)("delete file", filename));
             AlarmManager::GetInstance()->SendAlarmCritical(DISCARD_SECONDARY_ALARM,
@@ -671,6 +624,8 @@ void DiskBufferWriter::SendEncryptionBuffer(const std::string& filename, int32_t
 
 // file is not really created when call CreateNewFile(), file created happened when SendToBufferFile() first called
 bool DiskBufferWriter::CreateNewFile() {
+    // the current buffer file must be completely written before it can be sent
+    CloseBufferFile();
     vector<string> filesToSend;
     int64_t currentTime = time(NULL);
     if (!LoadFileToSend(currentTime, filesToSend))
@@ -679,7 +634,7 @@ bool DiskBufferWriter::CreateNewFile() {
     for (int32_t i = 0; i < (int32_t)filesToSend.size() - bufferFileNumValue; ++i) {
         string fileName = GetBufferFilePath() + filesToSend[i];
         if (CheckExistance(fileName)) {
-            remove(fileName.c_str());
+            DiskBufferSegment::RemoveFiles(fileName);
             LOG_ERROR(sLogger,
                       ("buffer file count exceed limit",
                        "file created earlier will be cleaned, and new file will create for new log data")("delete file",
@@ -693,51 +648,18 @@ bool DiskBufferWriter::CreateNewFile() {
     return true;
 }
 
-bool DiskBufferWriter::WriteBackMeta(int32_t pos, const void* buf, int32_t length, const string& filename) {
-    // TODO: Why not use fopen or fstream???
-    // TODO: Make sure and merge them.
-#if defined(__linux__)
-    int fd = open(filename.c_str(), O_WRONLY);
-    if (fd < 0) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("open secondary file for write meta fail:") + filename
-                                                           + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("open file error", filename));
-        return false;
-    }
-    lseek(fd, pos, SEEK_SET);
-    if (write(fd, buf, length) < 0) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("write secondary file for write meta fail:") + filename
-                                                           + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("can not write back meta", filename));
-    }
-    close(fd);
-    return true;
-#elif defined(_MSC_VER)
-    FILE* f = FileWriteOnlyOpen(filename.c_str(), "wb");
-    if (!f) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("open secondary file for write meta fail:") + filename
-                                                           + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("open file error", filename));
-        return false;
-    }
-    fseek(f, pos, SEEK_SET);
-    auto nbytes = fwrite(buf, 1, length, f);
-    if (nbytes != length) {
-        string errorStr = ErrnoToString(GetErrno());
-        AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
-                                                       string("write secondary file for write meta fail:") + filename
-                                                           + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("can not write back meta", filename));
+void DiskBufferWriter::CloseBufferFile() {
+    if (mBufferFile != nullptr) {
+        // records still in the write buffer are written on close
+        if (fclose(mBufferFile) != 0) {
+            string errorStr = ErrnoToString(GetErrno());
+            AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
+                                                           string("close file error:") + GetBufferFileName()
+                                                               + ", error:" + errorStr);
+            LOG_ERROR(sLogger, ("close buffer file", "fail")("filename", GetBufferFileName())("errorStr", errorStr));
+        }
+        mBufferFile = nullptr;
     }
-    fclose(f);
-    return true;
-#endif
 }
 
 string DiskBufferWriter::GetBufferFileHeader() {
@@ -749,15 +671,9 @@ string DiskBufferWriter::GetBufferFileHeader() {
     return (STRING_FLAG(file_encryption_magic_number) + reserve + nullHeader);
 }
 
-bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
-    auto data = static_cast<SLSSenderQueueItem*>(dataPtr);
-    auto flusher = static_cast<const FlusherSLS*>(data->mFlusher);
-    string bufferFileName = GetBufferFileName();
-    if (bufferFileName.empty()) {
-        CreateNewFile();
-        bufferFileName = GetBufferFileName();
-    }
-    // if file not exist, create it new
+bool DiskBufferWriter::OpenBufferFile(const std::string& bufferFileName,
+                                      const FlusherSLS* flusher,
+                                      const SLSSenderQueueItem* data) {
     FILE* fout = FileAppendOpen(bufferFileName.c_str(), "ab");
     if (!fout) {
         string errorStr = ErrnoToString(GetErrno());
@@ -771,7 +687,9 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
         LOG_ERROR(sLogger, ("open buffer file error", bufferFileName));
         return false;
     }
-
+    // records are written in large writes, and flushed after each batch
+    setvbuf(fout, nullptr, _IOFBF, BUFFER_FILE_WRITE_BUFFER_SIZE);
+    fseek(fout, 0, SEEK_END);
     if (ftell(fout) == (streampos)0) {
         string header = GetBufferFileHeader();
         auto nbytes = fwrite(header.c_str(), 1, header.size(), fout);
@@ -789,11 +707,28 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
             return false;
         }
     }
+    mBufferFile = fout;
+    return true;
+}
+
+bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
+    auto data = static_cast<SLSSenderQueueItem*>(dataPtr);
+    auto flusher = static_cast<const FlusherSLS*>(data->mFlusher);
+    string bufferFileName = GetBufferFileName();
+    if (bufferFileName.empty()) {
+        CreateNewFile();
+        bufferFileName = GetBufferFileName();
+    }
+    // the buffer file is kept open until a new one is created, and if file not exist, create it new
+    if (mBufferFile == nullptr) {
+        if (!OpenBufferFile(bufferFileName, flusher, data)) {
+            return false;
+        }
+    }
 
     char* des;
     int32_t desLength;
     if (!FileEncryption::GetInstance()->Encrypt(data->mData.c_str(), data->mData.size(), des, desLength)) {
-        fclose(fout);
         LOG_ERROR(sLogger, ("encrypt error, project_name", flusher->mProject));
         AlarmManager::GetInstance()->SendAlarmCritical(ENCRYPT_DECRYPT_FAIL_ALARM,
                                                        string("encrypt error, project_name:" + flusher->mProject),
@@ -825,19 +760,18 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
 
     EncryptionStateMeta meta;
     int32_t encodedInfoSize = encodedInfo.size();
-    meta.mEncodedInfoSize = encodedInfoSize + BUFFER_META_BASE_SIZE;
+    meta.mEncodedInfoSize = encodedInfoSize + DiskBufferSegment::BUFFER_META_BASE_SIZE;
     meta.mLogDataSize = data->mData.size();
     meta.mTimeStamp = time(NULL);
     meta.mHandled = 0;
     meta.mRetryTime = 0;
     meta.mEncryptionSize = desLength;
-    char* buffer = new char[sizeof(meta) + encodedInfoSize + meta.mEncryptionSize];
-    memcpy(buffer, (char*)&meta, sizeof(meta));
-    memcpy(buffer + sizeof(meta), encodedInfo.c_str(), encodedInfoSize);
-    memcpy(buffer + sizeof(meta) + encodedInfoSize, des, desLength);
-    delete[] des;
+    // the record is coalesced with others in the buffer of the file
     const auto bytesToWrite = sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
-    auto nbytes = fwrite(buffer, 1, bytesToWrite, fout);
+    auto nbytes = fwrite((char*)&meta, 1, sizeof(meta), mBufferFile);
+    nbytes += fwrite(encodedInfo.c_str(), 1, encodedInfoSize, mBufferFile);
+    nbytes += fwrite(des, 1, desLength, mBufferFile);
+    delete[] des;
     if (nbytes != bytesToWrite) {
         string errorStr = ErrnoToString(GetErrno());
         AlarmManager::GetInstance()->SendAlarmCritical(SECONDARY_READ_WRITE_ALARM,
@@ -850,14 +784,12 @@ bool DiskBufferWriter::SendToBufferFile(SenderQueueItem* dataPtr) {
         LOG_ERROR(
             sLogger,
             ("write meta of buffer file", "fail")("filename", bufferFileName)("errorStr", errorStr)("nbytes", nbytes));
-        delete[] buffer;
-        fclose(fout);
+        // records after a partially written one cannot be read, so write them to a new file
+        CreateNewFile();
         return false;
     }
-    delete[] buffer;
-    if (ftell(fout) > AppConfig::GetInstance()->GetLocalFileSize())
+    if (ftell(mBufferFile) > AppConfig::GetInstance()->GetLocalFileSize())
         CreateNewFile();
-    fclose(fout);
     LOG_DEBUG(sLogger, ("write buffer file", bufferFileName));
     return true;
 }
@@ -867,7 +799,11 @@ SLSResponse DiskBufferWriter::SendBufferFileData(const sls_logs::LogtailBufferMe
                                                  std::string& domain,
                                                  std::string& ip,
                                                  bool useIPFlag) {
-    RateLimiter::FlowControl(bufferMeta.rawsize(), mSendLastTime, mSendLastByte, false);
+    {
+        // buffer files are sent concurrently, but the flow is limited as a whole
+        lock_guard<mutex> lock(mSendFlowControlMux);
+        RateLimiter::FlowControl(bufferMeta.rawsize(), mSendLastTime, mSendLastByte, false);
+    }
     string region = bufferMeta.region();
 #ifdef __ENTERPRISE__
     // old buffer file which record the endpoint
@@ -904,7 +840,10 @@ SLSResponse DiskBufferWriter::SendBufferFileData(const sls_logs::LogtailBufferMe
     }
     auto info = EnterpriseSLSClientManager::GetInstance()->GetCandidateHostsInfo(
         region, bufferMeta.project(), GetEndpointMode(bufferMeta.endpointmode()));
-    mCandidateHostsInfos.insert(info);
+    {
+        lock_guard<mutex> lock(mCandidateHostsInfosMux);
+        mCandidateHostsInfos.insert(info);
+    }
 
     domain = info->GetCurrentHost();
     if (domain.empty()) {
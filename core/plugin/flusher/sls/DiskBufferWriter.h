@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdio>
 #include <ctime>
 
 #include <atomic>
@@ -29,6 +30,7 @@
 
 #include "collection_pipeline/queue/SenderQueueItem.h"
 #include "common/SafeQueue.h"
+#include "plugin/flusher/sls/DiskBufferSegment.h"
 #include "plugin/flusher/sls/SLSClientManager.h"
 #include "plugin/flusher/sls/SLSResponse.h"
 #include "protobuf/sls/logtail_buffer_meta.pb.h"
@@ -40,6 +42,9 @@
 
 namespace logtail {
 
+class FlusherSLS;
+struct SLSSenderQueueItem;
+
 class DiskBufferWriter {
 public:
     DiskBufferWriter(const DiskBufferWriter&) = delete;
@@ -56,23 +61,17 @@ public:
     bool PushToDiskBuffer(SenderQueueItem* item, uint32_t retryTimes);
 
 private:
-    static const int32_t BUFFER_META_BASE_SIZE;
     static const size_t BUFFER_META_MAX_SIZE;
-
-    struct EncryptionStateMeta {
-        int32_t mLogDataSize;
-        int32_t mEncryptionSize;
-        int32_t mEncodedInfoSize;
-        int32_t mTimeStamp;
-        int32_t mHandled;
-        int32_t mRetryTime;
-    };
+    static const size_t BUFFER_FILE_WRITE_BUFFER_SIZE;
 
     DiskBufferWriter() = default;
     ~DiskBufferWriter() = default;
 
     void BufferWriterThread();
     void BufferSenderThread();
+    void SendBufferFiles(const std::vector<std::string>& fileNames);
+    void SendBufferFile(const std::string& fileName);
+    bool IsSendBufferThreadRunning() const;
 
     SLSResponse SendBufferFileData(const sls_logs::LogtailBufferMeta& bufferMeta,
                                    const std::string& logData,
@@ -80,15 +79,14 @@ private:
                                    std::string& ip,
                                    bool useIPFlag);
     bool SendToBufferFile(SenderQueueItem* dataPtr);
+    bool OpenBufferFile(const std::string& bufferFileName, const FlusherSLS* flusher, const SLSSenderQueueItem* data);
+    void CloseBufferFile();
     bool LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSend);
     bool CreateNewFile();
-    bool WriteBackMeta(const int32_t pos, const void* buf, int32_t length, const std::string& filename);
-    bool ReadNextEncryption(int32_t& pos,
-                            const std::string& filename,
-                            std::string& encryption,
-                            EncryptionStateMeta& meta,
-                            bool& readResult,
-                            sls_logs::LogtailBufferMeta& bufferMeta);
+    bool ReadBufferMeta(const std::string& filename,
+                        const DiskBufferSegment& segment,
+                        const DiskBufferSegment::Record& record,
+                        sls_logs::LogtailBufferMeta& bufferMeta);
     void SendEncryptionBuffer(const std::string& filename, int32_t keyVersion);
     void SetBufferFilePath(const std::string& bufferfilepath);
     std::string GetBufferFilePath();
@@ -121,18 +119,26 @@ private:
         }
     };
 
+    std::mutex mCandidateHostsInfosMux;
     std::unordered_set<std::shared_ptr<CandidateHostsInfo>, PointerHash, PointerEqual> mCandidateHostsInfos;
 #endif
 
     mutable std::mutex mBufferFileLock;
     std::string mBufferFilePath;
     std::string mBufferFileName;
+    // accessed only by the buffer writer thread
+    FILE* mBufferFile = nullptr;
 
     volatile time_t mBufferDivideTime = 0;
     int64_t mCheckPeriod = 0;
 
+    std::mutex mSendFlowControlMux;
     int64_t mSendLastTime = 0;
     int32_t mSendLastByte = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class DiskBufferWriterBenchmark;
+#endif
 };
 
 } // namespace logtail
@@ -18,6 +18,7 @@
 
 #include "app_config/AppConfig.h"
 #include "application/Application.h"
+#include "collection_pipeline/plugin/interface/ClientFlusher.h"
 #include "collection_pipeline/plugin/interface/HttpFlusher.h"
 #include "collection_pipeline/queue/QueueKeyManager.h"
 #include "collection_pipeline/queue/SenderQueueItem.h"
@@ -31,6 +32,9 @@
 #include "runner/sink/http/HttpSink.h"
 
 DEFINE_FLAG_INT32(flusher_runner_exit_timeout_sec, "", 60);
+DEFINE_FLAG_INT32(flusher_runner_sending_cnt_wait_ms,
+                  "max time to wait for a request to be done when global send concurrency is exceeded, ms",
+                  100);
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
 
@@ -98,6 +102,7 @@ void FlusherRunner::UpdateSendFlowControl() {
 void FlusherRunner::Stop() {
     mIsFlush = true;
     SenderQueueManager::GetInstance()->Trigger();
+    mHttpSendingCntCV.notify_all();
     if (!mThreadRes.valid()) {
         return;
     }
@@ -110,15 +115,24 @@ void FlusherRunner::Stop() {
 }
 
 void FlusherRunner::DecreaseHttpSendingCnt() {
-    --mHttpSendingCnt;
+    {
+        // decreased under the lock, so that the notification cannot be lost between the check and the wait in
+        // PushToHttpSink
+        lock_guard<mutex> lock(mHttpSendingCntMux);
+        --mHttpSendingCnt;
+    }
+    mHttpSendingCntCV.notify_one();
     SenderQueueManager::GetInstance()->Trigger();
 }
 
 bool FlusherRunner::PushToHttpSink(SenderQueueItem* item, bool withLimit) {
-    // TODO: use semaphore instead
-    while (withLimit && !Application::GetInstance()->IsExiting()
-           && GetSendingBufferCount() >= AppConfig::GetInstance()->GetSendRequestGlobalConcurrency()) {
-        this_thread::sleep_for(chrono::milliseconds(10));
+    if (withLimit) {
+        unique_lock<mutex> lock(mHttpSendingCntMux);
+        while (!Application::GetInstance()->IsExiting()
+               && GetSendingBufferCount() >= AppConfig::GetInstance()->GetSendRequestGlobalConcurrency()) {
+            // woken up by DecreaseHttpSendingCnt, the timeout is only for exiting and the change of the concurrency
+            mHttpSendingCntCV.wait_for(lock, chrono::milliseconds(INT32_FLAG(flusher_runner_sending_cnt_wait_ms)));
+        }
     }
 
     unique_ptr<HttpSinkRequest> req;
@@ -228,6 +242,8 @@ bool FlusherRunner::Dispatch(SenderQueueItem* item) {
             } else {
                 return PushToHttpSink(item);
             }
+        case SinkType::CLIENT:
+            return static_cast<ClientFlusher*>(item->mFlusher)->SendItem(item);
         default:
             SenderQueueManager::GetInstance()->RemoveItem(item->mQueueKey, item);
             return false;
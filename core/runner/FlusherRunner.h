@@ -19,7 +19,9 @@
 #include <cstdint>
 
 #include <atomic>
+#include <condition_variable>
 #include <future>
+#include <mutex>
 
 #include "collection_pipeline/plugin/interface/Flusher.h"
 #include "collection_pipeline/queue/SenderQueueItem.h"
@@ -63,6 +65,10 @@ private:
     std::atomic_bool mIsFlush = false;
 
     std::atomic_int32_t mHttpSendingCnt{0};
+    // notified whenever a request sent by http sink is done, so that PushToHttpSink can be woken up at once when the
+    // global send concurrency is no longer exceeded
+    std::mutex mHttpSendingCntMux;
+    std::condition_variable mHttpSendingCntCV;
 
     // TODO: temporarily here
     int32_t mLastCheckSendClientTime = 0;
@@ -85,6 +91,7 @@ private:
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class PluginRegistryUnittest;
     friend class FlusherRunnerUnittest;
+    friend class FlusherRunnerBenchmark;
     friend class InstanceConfigManagerUnittest;
     friend class PipelineUpdateUnittest;
 #endif
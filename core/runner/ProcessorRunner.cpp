@@ -17,6 +17,7 @@
 #include "app_config/AppConfig.h"
 #include "batch/TimeoutFlushManager.h"
 #include "collection_pipeline/CollectionPipelineManager.h"
+#include "collection_pipeline/serializer/FlatLogGroupSerializer.h"
 #include "common/Flags.h"
 #include "go_pipeline/LogtailPlugin.h"
 #include "models/EventPool.h"
@@ -143,17 +144,23 @@ void ProcessorRunner::Run(uint32_t threadNo) {
         pipeline->Process(eventGroupList, item->mInputIndex);
 
         if (pipeline->IsFlushingThroughGoPipeline()) {
-            // TODO:
-            // 1. allow all event types to be sent to Go pipelines
-            // 2. use event group protobuf instead
+            // TODO: allow all event types to be sent to Go pipelines
             if (isLog) {
+                bool isFlat = LogtailPlugin::GetInstance()->IsFlatLogGroupSupported();
                 for (auto& group : eventGroupList) {
                     string res, errorMsg;
-                    if (!Serialize(group,
-                                   pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond,
-                                   pipeline->GetContext().GetLogstoreName(),
-                                   res,
-                                   errorMsg)) {
+                    bool serialized = isFlat
+                        ? SerializeFlatLogGroup(group,
+                                                pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond,
+                                                pipeline->GetContext().GetLogstoreName(),
+                                                res,
+                                                errorMsg)
+                        : Serialize(group,
+                                    pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond,
+                                    pipeline->GetContext().GetLogstoreName(),
+                                    res,
+                                    errorMsg);
+                    if (!serialized) {
                         LOG_WARNING(pipeline->GetContext().GetLogger(),
                                     ("failed to serialize event group",
                                      errorMsg)("action", "discard data")("config", configName));
@@ -167,10 +174,17 @@ void ProcessorRunner::Run(uint32_t threadNo) {
                             pipeline->GetContext().GetLogstoreName());
                         continue;
                     }
-                    LogtailPlugin::GetInstance()->ProcessLogGroup(
-                        pipeline->GetContext().GetConfigName(),
-                        res,
-                        group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                    if (isFlat) {
+                        LogtailPlugin::GetInstance()->ProcessFlatLogGroup(
+                            pipeline->GetContext().GetConfigName(),
+                            res,
+                            group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                    } else {
+                        LogtailPlugin::GetInstance()->ProcessLogGroup(
+                            pipeline->GetContext().GetConfigName(),
+                            res,
+                            group.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
+                    }
                 }
             }
         } else {
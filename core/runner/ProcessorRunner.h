@@ -68,6 +68,10 @@ private:
     thread_local static CounterPtr sInEventsCnt;
     thread_local static CounterPtr sInGroupDataSizeBytes;
     thread_local static IntGaugePtr sLastRunTime;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FlatLogGroupSerializerBenchmark;
+#endif
 };
 
 } // namespace logtail
@@ -14,6 +14,8 @@
 
 #include "runner/sink/http/HttpSink.h"
 
+#include <algorithm>
+#include <functional>
 #include <optional>
 
 #include "app_config/AppConfig.h"
@@ -22,6 +24,7 @@
 #include "collection_pipeline/queue/SenderQueueItem.h"
 #include "common/Flags.h"
 #include "common/StringTools.h"
+#include "common/dns/DNSCache.h"
 #include "common/http/Curl.h"
 #include "logger/Logger.h"
 #include "monitor/metric_constants/MetricConstants.h"
@@ -31,6 +34,12 @@
 #endif
 
 DEFINE_FLAG_INT32(http_sink_exit_timeout_sec, "", 5);
+DEFINE_FLAG_INT32(http_sink_event_loop_cnt,
+                  "count of event loops in http sink, requests to the same destination are sent by the same loop",
+                  1);
+DEFINE_FLAG_BOOL(enable_http_sink_dns_cache,
+                 "connect to the address in dns cache if resolved, so that sending is never blocked by dns",
+                 false);
 
 using namespace std;
 
@@ -46,10 +55,20 @@ HttpSink* HttpSink::GetInstance() {
 }
 
 bool HttpSink::Init() {
-    mClient = curl_multi_init();
-    if (mClient == nullptr) {
-        LOG_ERROR(sLogger, ("failed to init http sink", "failed to init curl multi client"));
-        return false;
+    size_t loopCnt = max(INT32_FLAG(http_sink_event_loop_cnt), 1);
+    for (size_t i = 0; i < loopCnt; ++i) {
+        auto loop = make_unique<EventLoop>();
+        loop->mIndex = i;
+        loop->mClient = curl_multi_init();
+        if (loop->mClient == nullptr) {
+            LOG_ERROR(sLogger, ("failed to init http sink", "failed to init curl multi client"));
+            for (auto& item : mEventLoops) {
+                curl_multi_cleanup(item->mClient);
+            }
+            mEventLoops.clear();
+            return false;
+        }
+        mEventLoops.emplace_back(std::move(loop));
     }
 
     WriteMetrics::GetInstance()->CreateMetricsRecordRef(
@@ -71,30 +90,53 @@ bool HttpSink::Init() {
     // TODO: should be dynamic
     SET_GAUGE(mSendConcurrency, AppConfig::GetInstance()->GetSendRequestGlobalConcurrency());
 
-    mThreadRes = async(launch::async, &HttpSink::Run, this);
+    for (auto& loop : mEventLoops) {
+        loop->mThreadRes = async(launch::async, &HttpSink::Run, this, ref(*loop));
+    }
     return true;
 }
 
 void HttpSink::Stop() {
     mIsFlush = true;
-    if (!mThreadRes.valid()) {
-        return;
+    // all loops are stopped within the timeout as a whole
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(INT32_FLAG(http_sink_exit_timeout_sec));
+    for (auto& loop : mEventLoops) {
+        if (!loop->mThreadRes.valid()) {
+            continue;
+        }
+        future_status s = loop->mThreadRes.wait_until(deadline);
+        if (s == future_status::ready) {
+            LOG_INFO(sLogger, ("http sink", "stopped successfully")("loop", loop->mIndex));
+        } else {
+            LOG_WARNING(sLogger, ("http sink", "forced to stopped")("loop", loop->mIndex));
+        }
+    }
+}
+
+bool HttpSink::AddRequest(unique_ptr<HttpSinkRequest>&& request) {
+    if (mEventLoops.empty()) {
+        // not initialized
+        return Sink<HttpSinkRequest>::AddRequest(std::move(request));
     }
-    future_status s = mThreadRes.wait_for(chrono::seconds(INT32_FLAG(http_sink_exit_timeout_sec)));
-    if (s == future_status::ready) {
-        LOG_INFO(sLogger, ("http sink", "stopped successfully"));
-    } else {
-        LOG_WARNING(sLogger, ("http sink", "forced to stopped"));
+    GetEventLoop(*request).mQueue.Push(std::move(request));
+    return true;
+}
+
+HttpSink::EventLoop& HttpSink::GetEventLoop(const HttpSinkRequest& request) {
+    if (mEventLoops.size() == 1) {
+        return *mEventLoops[0];
     }
+    size_t key = hash<string>()(request.mHost) * 31 + static_cast<size_t>(request.mPort);
+    return *mEventLoops[key % mEventLoops.size()];
 }
 
-void HttpSink::Run() {
-    LOG_INFO(sLogger, ("http sink", "started"));
+void HttpSink::Run(EventLoop& loop) {
+    LOG_INFO(sLogger, ("http sink", "started")("loop", loop.mIndex));
     while (true) {
         SET_GAUGE(mLastRunTime,
                   chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count());
         unique_ptr<HttpSinkRequest> request;
-        if (mQueue.WaitAndPop(request, 500)) {
+        if (loop.mQueue.WaitAndPop(request, 500)) {
             ADD_COUNTER(mInItemsTotal, 1);
             LOG_TRACE(sLogger,
                       ("got item from flusher runner, item address", request->mItem)(
@@ -104,24 +146,24 @@ void HttpSink::Run() {
                                                                                - request->mEnqueTime)
                                        .count())
                               + "ms")("try cnt", ToString(request->mTryCnt)));
-            if (!AddRequestToClient(std::move(request))) {
+            if (!AddRequestToClient(loop, std::move(request))) {
                 continue;
             }
             ADD_GAUGE(mSendingItemsTotal, 1);
-        } else if (mIsFlush && mQueue.Empty()) {
+        } else if (mIsFlush && loop.mQueue.Empty()) {
             break;
         } else {
             continue;
         }
-        DoRun();
+        DoRun(loop);
     }
-    auto mc = curl_multi_cleanup(mClient);
+    auto mc = curl_multi_cleanup(loop.mClient);
     if (mc != CURLM_OK) {
         LOG_ERROR(sLogger, ("failed to cleanup curl multi handle", "exit anyway")("errMsg", curl_multi_strerror(mc)));
     }
 }
 
-bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
+bool HttpSink::AddRequestToClient(EventLoop& loop, unique_ptr<HttpSinkRequest>&& request) {
     curl_slist* headers = nullptr;
     CURL* curl = CreateCurlHandler(request->mMethod,
                                    request->mHTTPSFlag,
@@ -152,10 +194,30 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
     }
 
     request->mPrivateData = headers;
+    curl_slist_free_all(request->mResolveList);
+    request->mResolveList = nullptr;
+    // unlike replacing the host with ip, the host is still used for tls and the Host header. Entries of CURLOPT_RESOLVE
+    // stay in the dns cache of the multi handle until replaced or removed, so they are only sent when the pinned ip
+    // changes, and removed once the host is no longer in DnsCache so that curl resolves it by itself again.
+    string hostPort = request->mHost + ":" + ToString(request->mPort);
+    string ip;
+    if (!BOOL_FLAG(enable_http_sink_dns_cache) || !DnsCache::GetInstance()->GetIPFromDnsCache(request->mHost, ip)
+        || ip == request->mHost) {
+        ip.clear();
+    }
+    auto pinned = loop.mPinnedHosts.find(hostPort);
+    if (!ip.empty() && (pinned == loop.mPinnedHosts.end() || pinned->second != ip)) {
+        request->mResolveList = curl_slist_append(nullptr, (hostPort + ":" + ip).c_str());
+    } else if (ip.empty() && pinned != loop.mPinnedHosts.end()) {
+        request->mResolveList = curl_slist_append(nullptr, ("-" + hostPort).c_str());
+    }
+    if (request->mResolveList) {
+        curl_easy_setopt(curl, CURLOPT_RESOLVE, request->mResolveList);
+    }
     curl_easy_setopt(curl, CURLOPT_PRIVATE, request.get());
     request->mLastSendTime = chrono::system_clock::now();
 
-    auto res = curl_multi_add_handle(mClient, curl);
+    auto res = curl_multi_add_handle(loop.mClient, curl);
     if (res != CURLM_OK) {
         request->mItem->mStatus = SendingStatus::IDLE;
         request->mResponse.SetNetworkStatus(NetworkCode::Other, "failed to add the easy curl handle to multi_handle");
@@ -170,29 +232,36 @@ bool HttpSink::AddRequestToClient(unique_ptr<HttpSinkRequest>&& request) {
                       "sending cnt", ToString(FlusherRunner::GetInstance()->GetSendingBufferCount())));
         return false;
     }
+    if (request->mResolveList) {
+        if (ip.empty()) {
+            loop.mPinnedHosts.erase(hostPort);
+        } else {
+            loop.mPinnedHosts[hostPort] = ip;
+        }
+    }
     // let sink destruct the request
     request.release();
     return true;
 }
 
-void HttpSink::DoRun() {
+void HttpSink::DoRun(EventLoop& loop) {
     CURLMcode mc;
     int runningHandlers = 1;
     while (runningHandlers) {
         auto curTime = chrono::system_clock::now();
         SET_GAUGE(mLastRunTime, chrono::duration_cast<chrono::seconds>(curTime.time_since_epoch()).count());
-        if ((mc = curl_multi_perform(mClient, &runningHandlers)) != CURLM_OK) {
+        if ((mc = curl_multi_perform(loop.mClient, &runningHandlers)) != CURLM_OK) {
             LOG_ERROR(
                 sLogger,
                 ("failed to call curl_multi_perform", "sleep 100ms and retry")("errMsg", curl_multi_strerror(mc)));
             this_thread::sleep_for(chrono::milliseconds(100));
             continue;
         }
-        HandleCompletedRequests(runningHandlers);
+        HandleCompletedRequests(loop, runningHandlers);
 
         unique_ptr<HttpSinkRequest> request;
         bool hasRequest = false;
-        while (mQueue.TryPop(request)) {
+        while (loop.mQueue.TryPop(request)) {
             ADD_COUNTER(mInItemsTotal, 1);
             LOG_TRACE(sLogger,
                       ("got item from flusher runner, item address", request->mItem)(
@@ -202,7 +271,7 @@ void HttpSink::DoRun() {
                                                                                - request->mEnqueTime)
                                        .count())
                               + "ms")("try cnt", ToString(request->mTryCnt)));
-            if (AddRequestToClient(std::move(request))) {
+            if (AddRequestToClient(loop, std::move(request))) {
                 ++runningHandlers;
                 ADD_GAUGE(mSendingItemsTotal, 1);
                 hasRequest = true;
@@ -219,7 +288,7 @@ void HttpSink::DoRun() {
             1, 0
         };
         long curlTimeout = -1;
-        if ((mc = curl_multi_timeout(mClient, &curlTimeout)) != CURLM_OK) {
+        if ((mc = curl_multi_timeout(loop.mClient, &curlTimeout)) != CURLM_OK) {
             LOG_WARNING(
                 sLogger,
                 ("failed to call curl_multi_timeout", "use default timeout 1s")("errMsg", curl_multi_strerror(mc)));
@@ -240,7 +309,7 @@ void HttpSink::DoRun() {
         FD_ZERO(&fdread);
         FD_ZERO(&fdwrite);
         FD_ZERO(&fdexcep);
-        if ((mc = curl_multi_fdset(mClient, &fdread, &fdwrite, &fdexcep, &maxfd)) != CURLM_OK) {
+        if ((mc = curl_multi_fdset(loop.mClient, &fdread, &fdwrite, &fdexcep, &maxfd)) != CURLM_OK) {
             LOG_ERROR(sLogger, ("failed to call curl_multi_fdset", "sleep 100ms")("errMsg", curl_multi_strerror(mc)));
         }
         if (maxfd == -1) {
@@ -253,9 +322,9 @@ void HttpSink::DoRun() {
     }
 }
 
-void HttpSink::HandleCompletedRequests(int& runningHandlers) {
+void HttpSink::HandleCompletedRequests(EventLoop& loop, int& runningHandlers) {
     int msgsLeft = 0;
-    CURLMsg* msg = curl_multi_info_read(mClient, &msgsLeft);
+    CURLMsg* msg = curl_multi_info_read(loop.mClient, &msgsLeft);
     while (msg) {
         if (msg->msg == CURLMSG_DONE) {
             bool requestReused = false;
@@ -300,7 +369,7 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                             request->mPrivateData = nullptr;
                         }
                         ++request->mTryCnt;
-                        AddRequestToClient(unique_ptr<HttpSinkRequest>(request));
+                        AddRequestToClient(loop, unique_ptr<HttpSinkRequest>(request));
                         ++runningHandlers;
                         ADD_GAUGE(mSendingItemsTotal, 1);
                         requestReused = true;
@@ -323,7 +392,7 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                     SUB_GAUGE(mSendingItemsTotal, 1);
                     break;
             }
-            curl_multi_remove_handle(mClient, handler);
+            curl_multi_remove_handle(loop.mClient, handler);
             curl_easy_cleanup(handler);
             if (!requestReused) {
                 if (request->mPrivateData) {
@@ -332,7 +401,7 @@ void HttpSink::HandleCompletedRequests(int& runningHandlers) {
                 delete request;
             }
         }
-        msg = curl_multi_info_read(mClient, &msgsLeft);
+        msg = curl_multi_info_read(loop.mClient, &msgsLeft);
     }
 }
 
@@ -19,7 +19,11 @@
 #include <atomic>
 #include <condition_variable>
 #include <future>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "curl/multi.h"
 
@@ -38,19 +42,30 @@ public:
 
     bool Init() override;
     void Stop() override;
+    bool AddRequest(std::unique_ptr<HttpSinkRequest>&& request) override;
 
 private:
+    // Each event loop drives its own curl multi handle in its own thread. Requests to the same destination are always
+    // sent by the same loop, so that connections to the destination are reused.
+    struct EventLoop {
+        size_t mIndex = 0;
+        CURLM* mClient = nullptr;
+        SafeQueue<std::unique_ptr<HttpSinkRequest>> mQueue;
+        std::future<void> mThreadRes;
+        // host:port -> ip pinned in the dns cache of mClient via CURLOPT_RESOLVE, which curl never expires by itself
+        std::unordered_map<std::string, std::string> mPinnedHosts;
+    };
+
     HttpSink() = default;
     ~HttpSink() = default;
 
-    void Run();
-    bool AddRequestToClient(std::unique_ptr<HttpSinkRequest>&& request);
-    void DoRun();
-    void HandleCompletedRequests(int& runningHandlers);
-
-    CURLM* mClient = nullptr;
+    void Run(EventLoop& loop);
+    bool AddRequestToClient(EventLoop& loop, std::unique_ptr<HttpSinkRequest>&& request);
+    void DoRun(EventLoop& loop);
+    void HandleCompletedRequests(EventLoop& loop, int& runningHandlers);
+    EventLoop& GetEventLoop(const HttpSinkRequest& request);
 
-    std::future<void> mThreadRes;
+    std::vector<std::unique_ptr<EventLoop>> mEventLoops;
     std::atomic_bool mIsFlush = false;
 
     mutable MetricsRecordRef mMetricsRecordRef;
@@ -66,6 +81,7 @@ private:
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class FlusherRunnerUnittest;
     friend class HttpSinkMock;
+    friend class HttpSinkBenchmark;
 #endif
 };
 
@@ -18,6 +18,8 @@
 
 #include <optional>
 
+#include "curl/curl.h"
+
 #include "collection_pipeline/queue/SenderQueueItem.h"
 #include "common/http/HttpRequest.h"
 
@@ -25,6 +27,8 @@ namespace logtail {
 
 struct HttpSinkRequest : public AsynHttpRequest {
     SenderQueueItem* mItem = nullptr;
+    // for CURLOPT_RESOLVE, which must be valid until the request is done
+    curl_slist* mResolveList = nullptr;
 
     HttpSinkRequest(const std::string& method,
                     bool httpsFlag,
@@ -53,6 +57,7 @@ struct HttpSinkRequest : public AsynHttpRequest {
                           std::nullopt,
                           std::move(socket)),
           mItem(item) {}
+    ~HttpSinkRequest() override { curl_slist_free_all(mResolveList); }
 
     bool IsContextValid() const override { return true; }
     void OnSendDone(HttpResponse& response) override {}
@@ -18,6 +18,7 @@
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(checkpoint_find_max_file_count);
+DECLARE_FLAG_BOOL(checkpoint_enable_incremental_store);
 
 namespace logtail {
 
@@ -30,14 +31,79 @@ public:
         bfs::remove_all(kTestRootDir);
         bfs::create_directories(kTestRootDir);
         AppConfig::GetInstance()->SetLoongcollectorConfDir(kTestRootDir);
+        AppConfig::GetInstance()->mCheckPointFilePath = (bfs::path(kTestRootDir) / "checkpoint").string();
     }
 
     static void TearDownTestCase() { bfs::remove_all(kTestRootDir); }
 
     void TestSearchFilePathByDevInodeInDirectory();
+    void TestIncrementalStore();
+    void TestMigrateFromCheckPointFile();
+    void TestMigrateFromCheckPointFileWithStoreLost();
+    void TestMigrateToCheckPointFile();
+
+protected:
+    void TearDown() override {
+        BOOL_FLAG(checkpoint_enable_incremental_store) = false;
+        restart();
+        bfs::remove_all(CheckPointManager::getCheckPointStorePath());
+        bfs::remove(AppConfig::GetInstance()->GetCheckPointFilePath());
+        bfs::remove(CheckPointManager::getMigratedCheckPointFilePath());
+    }
+
+    // checkpoints are cleared after each dump, and the store is reopened on restart
+    void restart() {
+        auto* manager = CheckPointManager::Instance();
+        manager->RemoveAllCheckPoint();
+        manager->mStore.reset();
+    }
+
+    void addCheckPoint(uint64_t inode, int64_t offset) {
+        auto* cpt = new CheckPoint("/var/log/" + std::to_string(inode) + ".log",
+                                   "/var/log/" + std::to_string(inode) + ".log",
+                                   offset,
+                                   1024,
+                                   inode * 7,
+                                   DevInode(1, inode),
+                                   "config",
+                                   "/var/log/" + std::to_string(inode) + ".log",
+                                   true,
+                                   false,
+                                   "",
+                                   false);
+        cpt->mLastUpdateTime = 1700000000;
+        CheckPointManager::Instance()->AddCheckPoint(cpt);
+    }
+
+    void verifyCheckPoints(size_t count, int64_t offsetBase) {
+        auto* manager = CheckPointManager::Instance();
+        APSARA_TEST_EQUAL(count, manager->GetAllFileCheckPoint().size());
+        for (uint64_t inode = 1; inode <= count; ++inode) {
+            CheckPointPtr cpt;
+            APSARA_TEST_TRUE(manager->GetCheckPoint(DevInode(1, inode), "config", cpt));
+            APSARA_TEST_EQUAL(offsetBase + static_cast<int64_t>(inode), cpt->mOffset);
+            APSARA_TEST_EQUAL(inode * 7, cpt->mSignatureHash);
+            APSARA_TEST_EQUAL(1024U, cpt->mSignatureSize);
+            APSARA_TEST_TRUE(cpt->mFileOpenFlag);
+        }
+        DirCheckPointPtr dir;
+        APSARA_TEST_TRUE(manager->GetDirCheckPoint("/var/log", dir));
+        APSARA_TEST_EQUAL(1U, dir->mSubDir.count("/var/log/app"));
+    }
+
+    void addAll(size_t count, int64_t offsetBase) {
+        for (uint64_t inode = 1; inode <= count; ++inode) {
+            addCheckPoint(inode, offsetBase + inode);
+        }
+        CheckPointManager::Instance()->AddDirCheckPoint("/var/log/app");
+    }
 };
 
 UNIT_TEST_CASE(CheckpointManagerUnittest, TestSearchFilePathByDevInodeInDirectory);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestIncrementalStore);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestMigrateFromCheckPointFile);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestMigrateFromCheckPointFileWithStoreLost);
+UNIT_TEST_CASE(CheckpointManagerUnittest, TestMigrateToCheckPointFile);
 
 void CheckpointManagerUnittest::TestSearchFilePathByDevInodeInDirectory() {
     const std::string kRotateFileName = "test.log.5";
@@ -96,6 +162,105 @@ void CheckpointManagerUnittest::TestSearchFilePathByDevInodeInDirectory() {
     }
 }
 
+void CheckpointManagerUnittest::TestIncrementalStore() {
+    BOOL_FLAG(checkpoint_enable_incremental_store) = true;
+    auto* manager = CheckPointManager::Instance();
+    addAll(10, 0);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    // version + file checkpoints + dir checkpoint
+    APSARA_TEST_EQUAL(12U, manager->mStore->GetLastPutCount());
+    APSARA_TEST_FALSE(bfs::exists(AppConfig::GetInstance()->GetCheckPointFilePath()));
+
+    restart();
+    manager->LoadCheckPoint();
+    verifyCheckPoints(10, 0);
+    APSARA_TEST_EQUAL(10, manager->GetReaderCount());
+
+    // unchanged checkpoints are not written again
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_EQUAL(0U, manager->mStore->GetLastPutCount());
+    APSARA_TEST_EQUAL(0U, manager->mStore->GetLastDeleteCount());
+
+    // only changed checkpoints are written, released ones are deleted
+    manager->RemoveAllCheckPoint();
+    for (uint64_t inode = 2; inode <= 9; ++inode) {
+        addCheckPoint(inode, inode);
+    }
+    addCheckPoint(1, 100);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_EQUAL(1U, manager->mStore->GetLastPutCount());
+    // file checkpoint 10 and the dir checkpoint
+    APSARA_TEST_EQUAL(2U, manager->mStore->GetLastDeleteCount());
+
+    restart();
+    manager->LoadCheckPoint();
+    APSARA_TEST_EQUAL(9U, manager->GetAllFileCheckPoint().size());
+    CheckPointPtr cpt;
+    APSARA_TEST_TRUE(manager->GetCheckPoint(DevInode(1, 1), "config", cpt));
+    APSARA_TEST_EQUAL(100, cpt->mOffset);
+    APSARA_TEST_FALSE(manager->GetCheckPoint(DevInode(1, 10), "config", cpt));
+}
+
+void CheckpointManagerUnittest::TestMigrateFromCheckPointFile() {
+    auto* manager = CheckPointManager::Instance();
+    BOOL_FLAG(checkpoint_enable_incremental_store) = false;
+    addAll(5, 10);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_TRUE(bfs::exists(AppConfig::GetInstance()->GetCheckPointFilePath()));
+    APSARA_TEST_FALSE(bfs::exists(CheckPointManager::getCheckPointStorePath()));
+
+    BOOL_FLAG(checkpoint_enable_incremental_store) = true;
+    restart();
+    manager->LoadCheckPoint();
+    verifyCheckPoints(5, 10);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_FALSE(bfs::exists(AppConfig::GetInstance()->GetCheckPointFilePath()));
+    // kept until the store is loaded
+    APSARA_TEST_TRUE(bfs::exists(CheckPointManager::getMigratedCheckPointFilePath()));
+
+    restart();
+    manager->LoadCheckPoint();
+    verifyCheckPoints(5, 10);
+    APSARA_TEST_FALSE(bfs::exists(CheckPointManager::getMigratedCheckPointFilePath()));
+}
+
+void CheckpointManagerUnittest::TestMigrateFromCheckPointFileWithStoreLost() {
+    auto* manager = CheckPointManager::Instance();
+    BOOL_FLAG(checkpoint_enable_incremental_store) = false;
+    addAll(5, 30);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+
+    BOOL_FLAG(checkpoint_enable_incremental_store) = true;
+    restart();
+    manager->LoadCheckPoint();
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+
+    // the store is lost before it is ever loaded, checkpoints are recovered from the migrated checkpoint file
+    restart();
+    bfs::remove_all(CheckPointManager::getCheckPointStorePath());
+    manager->LoadCheckPoint();
+    verifyCheckPoints(5, 30);
+}
+
+void CheckpointManagerUnittest::TestMigrateToCheckPointFile() {
+    auto* manager = CheckPointManager::Instance();
+    addAll(5, 20);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_TRUE(bfs::exists(CheckPointManager::getCheckPointStorePath()));
+
+    BOOL_FLAG(checkpoint_enable_incremental_store) = false;
+    restart();
+    manager->LoadCheckPoint();
+    verifyCheckPoints(5, 20);
+    APSARA_TEST_TRUE(manager->DumpCheckPointToLocal());
+    APSARA_TEST_TRUE(bfs::exists(AppConfig::GetInstance()->GetCheckPointFilePath()));
+    APSARA_TEST_FALSE(bfs::exists(CheckPointManager::getCheckPointStorePath()));
+
+    restart();
+    manager->LoadCheckPoint();
+    verifyCheckPoints(5, 20);
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
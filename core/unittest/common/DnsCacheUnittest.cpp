@@ -0,0 +1,183 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "common/dns/DNSCache.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class DnsCacheUnittest : public ::testing::Test {
+public:
+    void TestResolveInBackground();
+    void TestRawIp();
+    void TestNegativeCache();
+    void TestRefresh();
+    void TestExpire();
+
+protected:
+    void SetUp() override {
+        mResolveCnt = 0;
+        mFail = false;
+        mAddress = "1.1.1.1";
+    }
+
+private:
+    DnsCache::Resolver GetResolver() {
+        return [this]([[maybe_unused]] const string& host, string& ip) {
+            ++mResolveCnt;
+            if (mFail) {
+                return false;
+            }
+            lock_guard<mutex> lock(mMux);
+            ip = mAddress;
+            return true;
+        };
+    }
+
+    void SetAddress(const string& address) {
+        lock_guard<mutex> lock(mMux);
+        mAddress = address;
+    }
+
+    // waits until the hosts are resolved in the background and the snapshot is replaced
+    void WaitForResolution(int resolveCnt) {
+        for (int i = 0; i < 200 && mResolveCnt < resolveCnt; ++i) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        this_thread::sleep_for(chrono::milliseconds(50));
+    }
+
+    atomic_int mResolveCnt = 0;
+    atomic_bool mFail = false;
+    mutex mMux;
+    string mAddress;
+};
+
+void DnsCacheUnittest::TestResolveInBackground() {
+    DnsCache cache(600, 60, 10, GetResolver());
+    string ip;
+    // not blocked
+    APSARA_TEST_FALSE(cache.GetIPFromDnsCache("example.com", ip));
+    WaitForResolution(1);
+    APSARA_TEST_EQUAL(1, mResolveCnt.load());
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+    APSARA_TEST_EQUAL("1.1.1.1", ip);
+    // cached
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+    this_thread::sleep_for(chrono::milliseconds(100));
+    APSARA_TEST_EQUAL(1, mResolveCnt.load());
+
+    // after stopped, no more resolution
+    cache.Stop();
+    APSARA_TEST_FALSE(cache.GetIPFromDnsCache("another.com", ip));
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+    this_thread::sleep_for(chrono::milliseconds(100));
+    APSARA_TEST_EQUAL(1, mResolveCnt.load());
+}
+
+void DnsCacheUnittest::TestRawIp() {
+    DnsCache cache(600, 60, 10, GetResolver());
+    string ip;
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("127.0.0.1", ip));
+    APSARA_TEST_EQUAL("127.0.0.1", ip);
+    APSARA_TEST_FALSE(cache.GetIPFromDnsCache("", ip));
+    APSARA_TEST_EQUAL(0, mResolveCnt.load());
+}
+
+void DnsCacheUnittest::TestNegativeCache() {
+    {
+        DnsCache cache(600, 60, 10, GetResolver());
+        mFail = true;
+        string ip;
+        APSARA_TEST_FALSE(cache.GetIPFromDnsCache("example.com", ip));
+        WaitForResolution(1);
+        APSARA_TEST_EQUAL(1, mResolveCnt.load());
+        // not resolved again within negative ttl
+        APSARA_TEST_FALSE(cache.GetIPFromDnsCache("example.com", ip));
+        this_thread::sleep_for(chrono::milliseconds(100));
+        APSARA_TEST_EQUAL(1, mResolveCnt.load());
+    }
+    {
+        mResolveCnt = 0;
+        DnsCache cache(600, 60, 0, GetResolver());
+        string ip;
+        APSARA_TEST_FALSE(cache.GetIPFromDnsCache("example.com", ip));
+        WaitForResolution(1);
+        APSARA_TEST_EQUAL(1, mResolveCnt.load());
+        // resolved again after negative ttl
+        mFail = false;
+        APSARA_TEST_FALSE(cache.GetIPFromDnsCache("example.com", ip));
+        WaitForResolution(2);
+        APSARA_TEST_EQUAL(2, mResolveCnt.load());
+        APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+        APSARA_TEST_EQUAL("1.1.1.1", ip);
+    }
+}
+
+void DnsCacheUnittest::TestRefresh() {
+    DnsCache cache(600, 0, 10, GetResolver());
+    string ip;
+    APSARA_TEST_FALSE(cache.GetIPFromDnsCache("example.com", ip));
+    WaitForResolution(1);
+
+    // refreshed in advance, the old address is returned meanwhile
+    SetAddress("2.2.2.2");
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+    APSARA_TEST_EQUAL("1.1.1.1", ip);
+    WaitForResolution(2);
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+    APSARA_TEST_EQUAL("2.2.2.2", ip);
+
+    // the last address is kept if failed to refresh
+    mFail = true;
+    int cnt = mResolveCnt;
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+    WaitForResolution(cnt + 1);
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+    APSARA_TEST_EQUAL("2.2.2.2", ip);
+}
+
+void DnsCacheUnittest::TestExpire() {
+    DnsCache cache(2, 60, 10, GetResolver());
+    string ip;
+    APSARA_TEST_FALSE(cache.GetIPFromDnsCache("example.com", ip));
+    WaitForResolution(1);
+    APSARA_TEST_TRUE(cache.GetIPFromDnsCache("example.com", ip));
+
+    // evicted by the background thread
+    mFail = true;
+    for (int i = 0; i < 50 && !atomic_load(&cache.mEntries)->empty(); ++i) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    APSARA_TEST_TRUE(atomic_load(&cache.mEntries)->empty());
+    APSARA_TEST_FALSE(cache.GetIPFromDnsCache("example.com", ip));
+}
+
+UNIT_TEST_CASE(DnsCacheUnittest, TestResolveInBackground)
+UNIT_TEST_CASE(DnsCacheUnittest, TestRawIp)
+UNIT_TEST_CASE(DnsCacheUnittest, TestNegativeCache)
+UNIT_TEST_CASE(DnsCacheUnittest, TestRefresh)
+UNIT_TEST_CASE(DnsCacheUnittest, TestExpire)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,132 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iconv.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/EncodingConverter.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Converts 512KB chunks of GBK logs, like LogFileReader::ReadGBK does, by iconv line by line and by
+// EncodingConverter.
+class EncodingConverterBenchmark : public testing::Test {
+public:
+    void TestConvert_Ascii();
+    void TestConvert_Mixed();
+    void TestConvert_Chinese();
+
+private:
+    void TestConvert(const string& line);
+
+    static const size_t kChunkSize = 512 * 1024;
+    static const size_t kRound = 200;
+};
+
+void EncodingConverterBenchmark::TestConvert(const string& line) {
+    string chunk;
+    while (chunk.size() + line.size() <= kChunkSize) {
+        chunk += line;
+    }
+    vector<long> linePosVec;
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        if (chunk[i] == '\n') {
+            linePosVec.push_back(i);
+        }
+    }
+    size_t srcLength = chunk.size();
+    size_t desLength
+        = EncodingConverter::GetInstance()->ConvertGbk2Utf8(chunk.data(), &srcLength, nullptr, 0, linePosVec) + 1;
+    string iconvResult(desLength, '\0');
+    string result(desLength, '\0');
+    size_t iconvSize = 0;
+    size_t resultSize = 0;
+
+    iconv_t cd = iconv_open("UTF-8", "GBK");
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t round = 0; round < kRound; ++round) {
+        size_t beginIndex = 0;
+        char* out = &iconvResult[0];
+        size_t outLeft = desLength;
+        for (long endIndex : linePosVec) {
+            char* in = &chunk[beginIndex];
+            size_t inLeft = endIndex - beginIndex + 1;
+            iconv(cd, &in, &inLeft, &out, &outLeft);
+            beginIndex = endIndex + 1;
+        }
+        iconvSize = out - iconvResult.data();
+    }
+    auto end = chrono::high_resolution_clock::now();
+    iconv_close(cd);
+    double iconvElapsed = chrono::duration<double>(end - start).count();
+
+    start = chrono::high_resolution_clock::now();
+    for (size_t round = 0; round < kRound; ++round) {
+        srcLength = chunk.size();
+        resultSize = EncodingConverter::GetInstance()->ConvertGbk2Utf8(
+            chunk.data(), &srcLength, &result[0], desLength, linePosVec);
+    }
+    end = chrono::high_resolution_clock::now();
+    double elapsed = chrono::duration<double>(end - start).count();
+
+    double totalMB = static_cast<double>(chunk.size()) * kRound / 1024 / 1024;
+    cout << "iconv line by line: " << totalMB / iconvElapsed << " MB/s" << endl;
+    cout << "EncodingConverter: " << totalMB / elapsed << " MB/s" << endl;
+    APSARA_TEST_EQUAL(iconvSize, resultSize);
+    APSARA_TEST_TRUE(memcmp(iconvResult.data(), result.data(), resultSize) == 0);
+}
+
+// 1 core
+// iconv line by line: 545 MB/s
+// EncodingConverter: 10044 MB/s
+void EncodingConverterBenchmark::TestConvert_Ascii() {
+    TestConvert("2025-01-01 12:00:00.123 [INFO] [main.cpp:100] request done, method:GET, uri:/api/v1/logs, "
+                "status:200, latency:12ms, client:10.0.0.1\n");
+}
+
+// 1 core
+// iconv line by line: 455 MB/s
+// EncodingConverter: 2402 MB/s
+void EncodingConverterBenchmark::TestConvert_Mixed() {
+    // "请求完成" and "用户" in GBK
+    TestConvert("2025-01-01 12:00:00.123 [INFO] [main.cpp:100] \xc7\xeb\xc7\xf3\xcd\xea\xb3\xc9, method:GET, "
+                "uri:/api/v1/logs, status:200, latency:12ms, \xd3\xc3\xbb\xa7:10.0.0.1\n");
+}
+
+// 1 core
+// iconv line by line: 240 MB/s
+// EncodingConverter: 440 MB/s
+void EncodingConverterBenchmark::TestConvert_Chinese() {
+    // "可观测性采集器" in GBK
+    string line;
+    for (int i = 0; i < 10; ++i) {
+        line += "\xbf\xc9\xb9\xdb\xb2\xe2\xd0\xd4\xb2\xc9\xbc\xaf\xc6\xf7";
+    }
+    TestConvert(line + "\n");
+}
+
+UNIT_TEST_CASE(EncodingConverterBenchmark, TestConvert_Ascii)
+UNIT_TEST_CASE(EncodingConverterBenchmark, TestConvert_Mixed)
+UNIT_TEST_CASE(EncodingConverterBenchmark, TestConvert_Chinese)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -12,9 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <random>
+
 #include "common/EncodingConverter.h"
 #include "unittest/Unittest.h"
 #if defined(__linux__)
+#include <iconv.h>
+
 #include "unittest/UnittestHelper.h"
 #endif
 
@@ -23,9 +27,24 @@ namespace logtail {
 class EncodingConverterUnittest : public ::testing::Test {
 public:
     void ConvertGbk2Utf8();
+#if defined(__linux__)
+    void ConvertGbk2Utf8MultiLines();
+    void ConvertGbk2Utf8AllChars();
+    void ConvertGbk2Utf8RandomLines();
+
+private:
+    // converts @src by iconv line by line, the same as ConvertGbk2Utf8 did before using tables
+    std::string ConvertByIconv(const std::string& src, const std::vector<long>& linePosVec);
+    std::string Convert(const std::string& src, const std::vector<long>& linePosVec);
+#endif
 };
 
 APSARA_UNIT_TEST_CASE(EncodingConverterUnittest, ConvertGbk2Utf8, 0);
+#if defined(__linux__)
+APSARA_UNIT_TEST_CASE(EncodingConverterUnittest, ConvertGbk2Utf8MultiLines, 0);
+APSARA_UNIT_TEST_CASE(EncodingConverterUnittest, ConvertGbk2Utf8AllChars, 0);
+APSARA_UNIT_TEST_CASE(EncodingConverterUnittest, ConvertGbk2Utf8RandomLines, 0);
+#endif
 
 void EncodingConverterUnittest::ConvertGbk2Utf8() {
     char gbkStr[] = "ilogtail\xbf\xc9\xb9\xdb\xb2\xe2\xd0\xd4\xb2\xc9\xbc\xaf\xc6\xf7";
@@ -41,6 +60,111 @@ void EncodingConverterUnittest::ConvertGbk2Utf8() {
     APSARA_TEST_STREQ("ilogtail可观测性采集器", destChar.get());
 }
 
+#if defined(__linux__)
+std::string EncodingConverterUnittest::ConvertByIconv(const std::string& src, const std::vector<long>& linePosVec) {
+    iconv_t cd = iconv_open("UTF-8", "GBK");
+    std::string des(src.size() * 2 + 1, '\0');
+    size_t beginIndex = 0;
+    size_t destIndex = 0;
+    for (long endIndex : linePosVec) {
+        char* in = const_cast<char*>(src.data()) + beginIndex;
+        size_t inLeft = endIndex - beginIndex + 1;
+        char* out = &des[destIndex];
+        size_t outLeft = des.size() - destIndex;
+        if (iconv(cd, &in, &inLeft, &out, &outLeft) == (size_t)(-1)) {
+            iconv(cd, NULL, NULL, NULL, NULL);
+            memcpy(&des[destIndex], src.data() + beginIndex, endIndex - beginIndex + 1);
+            destIndex += endIndex - beginIndex + 1;
+        } else {
+            destIndex = out - des.data();
+        }
+        beginIndex = endIndex + 1;
+    }
+    iconv_close(cd);
+    des.resize(destIndex);
+    return des;
+}
+
+std::string EncodingConverterUnittest::Convert(const std::string& src, const std::vector<long>& linePosVec) {
+    size_t srcLen = src.size();
+    size_t requireSize
+        = EncodingConverter::GetInstance()->ConvertGbk2Utf8(src.data(), &srcLen, nullptr, 0, linePosVec) + 1;
+    std::string des(requireSize, '\0');
+    size_t actualSize
+        = EncodingConverter::GetInstance()->ConvertGbk2Utf8(src.data(), &srcLen, &des[0], requireSize, linePosVec);
+    des.resize(actualSize);
+    return des;
+}
+
+void EncodingConverterUnittest::ConvertGbk2Utf8MultiLines() {
+    // the third line has an invalid byte, and the last line ends with an incomplete char
+    std::string gbkStr = "2024-01-01 ilogtail\n"
+                         "\xbf\xc9\xb9\xdb\xb2\xe2\xd0\xd4 observability\n"
+                         "invalid \xff\xbf\xc9\n"
+                         "\xb2\xc9\xbc\xaf\xc6\xf7\n"
+                         "incomplete \xb2";
+    std::vector<long> linePosVec;
+    for (size_t i = 0; i < gbkStr.size(); ++i) {
+        if (gbkStr[i] == '\n') {
+            linePosVec.push_back(i);
+        }
+    }
+    linePosVec.push_back(gbkStr.size() - 1);
+    APSARA_TEST_EQUAL(std::string("2024-01-01 ilogtail\n"
+                                  "可观测性 observability\n"
+                                  "invalid \xff\xbf\xc9\n"
+                                  "采集器\n"
+                                  "incomplete \xb2"),
+                      Convert(gbkStr, linePosVec));
+    APSARA_TEST_EQUAL(ConvertByIconv(gbkStr, linePosVec), Convert(gbkStr, linePosVec));
+}
+
+void EncodingConverterUnittest::ConvertGbk2Utf8AllChars() {
+    // every sequence of one and two bytes as a line
+    std::string gbkStr;
+    std::vector<long> linePosVec;
+    for (int lead = 0; lead < 256; ++lead) {
+        gbkStr += static_cast<char>(lead);
+        linePosVec.push_back(gbkStr.size() - 1);
+        for (int trail = 0; trail < 256; ++trail) {
+            gbkStr += static_cast<char>(lead);
+            gbkStr += static_cast<char>(trail);
+            linePosVec.push_back(gbkStr.size() - 1);
+        }
+    }
+    APSARA_TEST_TRUE(ConvertByIconv(gbkStr, linePosVec) == Convert(gbkStr, linePosVec));
+}
+
+void EncodingConverterUnittest::ConvertGbk2Utf8RandomLines() {
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> kindDist(0, 99);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    std::uniform_int_distribution<int> asciiDist(0x20, 0x7e);
+    std::uniform_int_distribution<int> leadDist(0x81, 0xfe);
+    std::uniform_int_distribution<int> trailDist(0x40, 0xfe);
+    for (int round = 0; round < 100; ++round) {
+        std::string gbkStr;
+        std::vector<long> linePosVec;
+        while (gbkStr.size() < 64 * 1024) {
+            int kind = kindDist(generator);
+            if (kind < 2) {
+                gbkStr += '\n';
+                linePosVec.push_back(gbkStr.size() - 1);
+            } else if (kind < 3) {
+                gbkStr += static_cast<char>(byteDist(generator));
+            } else if (kind < 50) {
+                gbkStr += static_cast<char>(leadDist(generator));
+                gbkStr += static_cast<char>(trailDist(generator));
+            } else {
+                gbkStr += static_cast<char>(asciiDist(generator));
+            }
+        }
+        linePosVec.push_back(gbkStr.size() - 1);
+        APSARA_TEST_TRUE(ConvertByIconv(gbkStr, linePosVec) == Convert(gbkStr, linePosVec));
+    }
+}
+#endif
+
 } // namespace logtail
 
 int main(int argc, char** argv) {
@@ -0,0 +1,166 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/LRUCache.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class ShardedLRUCacheUnittest : public ::testing::Test {
+public:
+    void TestShardCount();
+    void TestInsertAndGet();
+    void TestCapacity();
+    void TestStats();
+    void TestConcurrentAccess();
+};
+
+void ShardedLRUCacheUnittest::TestShardCount() {
+    {
+        lru11::ShardedCache<string, int> cache(1024, 20);
+        APSARA_TEST_EQUAL(16U, cache.getShardCount());
+    }
+    {
+        // shards of small caches hold at least kMinShardSize keys
+        lru11::ShardedCache<string, int> cache(32, 0);
+        APSARA_TEST_EQUAL(4U, cache.getShardCount());
+    }
+    {
+        lru11::ShardedCache<string, int> cache(10, 0);
+        APSARA_TEST_EQUAL(1U, cache.getShardCount());
+    }
+    {
+        // rounded up to a power of 2
+        lru11::ShardedCache<string, int> cache(1024, 0, 5);
+        APSARA_TEST_EQUAL(8U, cache.getShardCount());
+    }
+}
+
+void ShardedLRUCacheUnittest::TestInsertAndGet() {
+    lru11::ShardedCache<string, int> cache(1024, 20);
+    APSARA_TEST_TRUE(cache.empty());
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    cache.insert("a", 3);
+    APSARA_TEST_EQUAL(2U, cache.size());
+    APSARA_TEST_TRUE(cache.contains("a"));
+    APSARA_TEST_EQUAL(3, cache.get("a"));
+
+    int value = 0;
+    APSARA_TEST_TRUE(cache.tryGetCopy("b", value));
+    APSARA_TEST_EQUAL(2, value);
+    APSARA_TEST_FALSE(cache.tryGetCopy("c", value));
+    bool thrown = false;
+    try {
+        cache.getCopy("c");
+    } catch (const lru11::KeyNotFound&) {
+        thrown = true;
+    }
+    APSARA_TEST_TRUE(thrown);
+
+    APSARA_TEST_TRUE(cache.remove("a"));
+    APSARA_TEST_FALSE(cache.remove("a"));
+    APSARA_TEST_FALSE(cache.contains("a"));
+    cache.clear();
+    APSARA_TEST_TRUE(cache.empty());
+}
+
+void ShardedLRUCacheUnittest::TestCapacity() {
+    {
+        // single shard, exact LRU order
+        lru11::ShardedCache<string, int> cache(8, 2);
+        for (int i = 0; i < 9; ++i) {
+            cache.insert(to_string(i), i);
+        }
+        APSARA_TEST_EQUAL(9U, cache.size());
+        int value = 0;
+        APSARA_TEST_TRUE(cache.tryGet("0", value));
+        cache.insert("9", 9);
+        APSARA_TEST_EQUAL(8U, cache.size());
+        APSARA_TEST_TRUE(cache.contains("0"));
+        APSARA_TEST_FALSE(cache.contains("1"));
+        APSARA_TEST_FALSE(cache.contains("2"));
+    }
+    {
+        // approximate global capacity
+        lru11::ShardedCache<string, int> cache(1024, 32);
+        for (int i = 0; i < 100000; ++i) {
+            cache.insert(to_string(i), i);
+        }
+        APSARA_TEST_TRUE(cache.size() >= 1024U - 16 * 8);
+        APSARA_TEST_TRUE(cache.size() <= cache.getMaxAllowedSize());
+        APSARA_TEST_TRUE(cache.contains("99999"));
+        APSARA_TEST_FALSE(cache.contains("0"));
+    }
+}
+
+void ShardedLRUCacheUnittest::TestStats() {
+    lru11::ShardedCache<string, int> cache(8, 0);
+    for (int i = 0; i < 10; ++i) {
+        cache.insert(to_string(i), i);
+    }
+    int value = 0;
+    cache.tryGet("9", value);
+    cache.tryGet("0", value);
+    cache.contains("9");
+    auto stats = cache.collectStats();
+    APSARA_TEST_EQUAL(1U, stats.hits);
+    APSARA_TEST_EQUAL(1U, stats.misses);
+    APSARA_TEST_EQUAL(2U, stats.evictions);
+
+    stats = cache.collectStats();
+    APSARA_TEST_EQUAL(0U, stats.hits);
+    APSARA_TEST_EQUAL(0U, stats.misses);
+    APSARA_TEST_EQUAL(0U, stats.evictions);
+}
+
+void ShardedLRUCacheUnittest::TestConcurrentAccess() {
+    lru11::ShardedCache<string, int> cache(256, 16);
+    vector<thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, t]() {
+            int value = 0;
+            for (int i = 0; i < 10000; ++i) {
+                string key = to_string((t * 10000 + i) % 1000);
+                if (i % 4 == 0) {
+                    cache.insert(key, i);
+                } else {
+                    cache.tryGetCopy(key, value);
+                }
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    auto stats = cache.collectStats();
+    APSARA_TEST_EQUAL(8U * 7500U, stats.hits + stats.misses);
+    APSARA_TEST_TRUE(cache.size() <= cache.getMaxAllowedSize());
+}
+
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestShardCount)
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestInsertAndGet)
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestCapacity)
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestStats)
+UNIT_TEST_CASE(ShardedLRUCacheUnittest, TestConcurrentAccess)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,224 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/ProcFileReader.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+
+class ProcFileReaderUnittest : public ::testing::Test {
+public:
+    void TestReadPidFile();
+    void TestReadLargeFile();
+    void TestCachedPidDirs();
+    void TestSetProcPath();
+    void TestConcurrentRead();
+    void TestReadBenchmark();
+
+protected:
+    void SetUp() override {
+        mProcDir = std::filesystem::absolute("ProcFileReaderUnittestDir") / "proc";
+        std::filesystem::create_directories(mProcDir);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(mProcDir.parent_path()); }
+
+    void createPidFile(int pid, const std::string& name, const std::string& content) {
+        auto pidDir = mProcDir / std::to_string(pid);
+        std::filesystem::create_directories(pidDir);
+        std::ofstream(pidDir / name, std::ios::trunc) << content;
+    }
+
+    std::filesystem::path mProcDir;
+};
+
+void ProcFileReaderUnittest::TestReadPidFile() {
+    createPidFile(1, "stat", "1 (init) S 0 1 1 0 -1 4194560");
+    ProcFileReader reader(mProcDir);
+    std::string buffer;
+    StringView content;
+    APSARA_TEST_TRUE(reader.ReadPidFile(1, "stat", buffer, content));
+    APSARA_TEST_EQUAL("1 (init) S 0 1 1 0 -1 4194560", content.to_string());
+    APSARA_TEST_EQUAL(ProcFileReader::kInitialBufferSize, buffer.size());
+    APSARA_TEST_FALSE(reader.ReadPidFile(1, "status", buffer, content));
+    APSARA_TEST_FALSE(reader.ReadPidFile(2, "stat", buffer, content));
+    APSARA_TEST_EQUAL(0UL, reader.CachedPidDirCount());
+}
+
+void ProcFileReaderUnittest::TestReadLargeFile() {
+    std::string cmdline(ProcFileReader::kInitialBufferSize * 3 + 1, 'a');
+    createPidFile(1, "cmdline", cmdline);
+    ProcFileReader reader(mProcDir);
+    std::string buffer;
+    StringView content;
+    APSARA_TEST_TRUE(reader.ReadPidFile(1, "cmdline", buffer, content));
+    APSARA_TEST_EQUAL(cmdline, content.to_string());
+
+    std::string huge(ProcFileReader::kMaxFileSize + 100, 'b');
+    createPidFile(1, "cmdline", huge);
+    APSARA_TEST_TRUE(reader.ReadPidFile(1, "cmdline", buffer, content));
+    APSARA_TEST_EQUAL(ProcFileReader::kMaxFileSize, content.size());
+}
+
+void ProcFileReaderUnittest::TestCachedPidDirs() {
+    createPidFile(1, "stat", "1");
+    createPidFile(2, "stat", "2");
+    createPidFile(3, "stat", "3");
+    ProcFileReader reader(mProcDir, 2);
+    std::string buffer;
+    StringView content;
+    APSARA_TEST_TRUE(reader.ReadPidFile(1, "stat", buffer, content));
+    APSARA_TEST_TRUE(reader.ReadPidFile(2, "stat", buffer, content));
+    APSARA_TEST_EQUAL(2UL, reader.CachedPidDirCount());
+    // bounded
+    APSARA_TEST_TRUE(reader.ReadPidFile(3, "stat", buffer, content));
+    APSARA_TEST_EQUAL("3", content.to_string());
+    APSARA_TEST_EQUAL(2UL, reader.CachedPidDirCount());
+
+    reader.RetainPids({3});
+    APSARA_TEST_EQUAL(1UL, reader.CachedPidDirCount());
+
+    // process exited and the pid is reused, the stale cached dir is reopened
+    std::filesystem::remove_all(mProcDir / "3");
+    createPidFile(3, "stat", "3 reused");
+    APSARA_TEST_TRUE(reader.ReadPidFile(3, "stat", buffer, content));
+    APSARA_TEST_EQUAL("3 reused", content.to_string());
+    std::filesystem::remove_all(mProcDir / "3");
+    APSARA_TEST_FALSE(reader.ReadPidFile(3, "stat", buffer, content));
+    APSARA_TEST_EQUAL(0UL, reader.CachedPidDirCount());
+}
+
+void ProcFileReaderUnittest::TestSetProcPath() {
+    createPidFile(1, "stat", "1");
+    ProcFileReader reader("/nonexistent", 16);
+    std::string buffer;
+    StringView content;
+    APSARA_TEST_FALSE(reader.ReadPidFile(1, "stat", buffer, content));
+    reader.SetProcPath(mProcDir);
+    APSARA_TEST_TRUE(reader.ReadPidFile(1, "stat", buffer, content));
+    APSARA_TEST_EQUAL(1UL, reader.CachedPidDirCount());
+    reader.SetProcPath(mProcDir);
+    APSARA_TEST_EQUAL(1UL, reader.CachedPidDirCount());
+    reader.SetProcPath("/nonexistent");
+    APSARA_TEST_EQUAL(0UL, reader.CachedPidDirCount());
+}
+
+void ProcFileReaderUnittest::TestConcurrentRead() {
+    for (int pid = 1; pid <= 8; ++pid) {
+        createPidFile(pid, "stat", std::to_string(pid) + " (proc) S");
+    }
+    // uncached, shared by threads like the default reader of ProcParser
+    ProcFileReader reader(mProcDir);
+    std::atomic_int failures{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            std::string buffer;
+            StringView content;
+            for (int round = 0; round < 1000; ++round) {
+                int pid = round % 8 + 1;
+                if (!reader.ReadPidFile(pid, "stat", buffer, content)
+                    || content.to_string() != std::to_string(pid) + " (proc) S") {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    APSARA_TEST_EQUAL(0, failures.load());
+}
+
+void ProcFileReaderUnittest::TestReadBenchmark() {
+    // synthetic /proc tree with 5000 processes, every cycle reads stat, statm and status of all of them
+    const int pidCount = 5000;
+    const int cycles = 10;
+    const std::string stat = "1813 (ilogtail) S 1811 1811 1811 0 -1 1077936192 1378102 0 848 0 643169 334268 0 0 20 0 55 "
+                             "0 1304 1707982848 46314 18446744073709551615 4227072 53627809 140730946407792 0 0 0 "
+                             "65536 0 4281570 0 0 0 17 26 0 0 24 0 0 66246848 67456896 101158912 140730946416312 "
+                             "140730946416341 140730946416341 140730946416603 0\n";
+    std::string status;
+    for (int i = 0; i < 55; ++i) {
+        status += "Field" + std::to_string(i) + ":\t0\t0\t0\t0\n";
+    }
+    std::vector<int> pids;
+    for (int pid = 1; pid <= pidCount; ++pid) {
+        createPidFile(pid, "stat", stat);
+        createPidFile(pid, "statm", "416988 46661 13498 12061 0 160061 0\n");
+        createPidFile(pid, "status", status);
+        pids.push_back(pid);
+    }
+    const char* files[] = {"stat", "statm", "status"};
+
+    size_t total = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int c = 0; c < cycles; ++c) {
+        for (int pid : pids) {
+            for (const char* name : files) {
+                std::ifstream file(mProcDir / std::to_string(pid) / name);
+                std::vector<std::string> lines;
+                std::string line;
+                while (std::getline(file, line)) {
+                    lines.push_back(line);
+                }
+                total += lines.size();
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << "[ifstream getline] elapsed: " << elapsed.count() << " seconds, lines: " << total << std::endl;
+
+    for (size_t maxCached : {size_t(0), size_t(pidCount)}) {
+        ProcFileReader reader(mProcDir, maxCached);
+        std::string buffer;
+        StringView content;
+        size_t bytes = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int c = 0; c < cycles; ++c) {
+            for (int pid : pids) {
+                for (const char* name : files) {
+                    APSARA_TEST_TRUE(reader.ReadPidFile(pid, name, buffer, content));
+                    bytes += content.size();
+                }
+            }
+            reader.RetainPids(pids);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        elapsed = end - start;
+        std::cout << "[ProcFileReader] cached pid dirs: " << maxCached << " elapsed: " << elapsed.count()
+                  << " seconds, bytes: " << bytes << std::endl;
+    }
+}
+
+UNIT_TEST_CASE(ProcFileReaderUnittest, TestReadPidFile)
+UNIT_TEST_CASE(ProcFileReaderUnittest, TestReadLargeFile)
+UNIT_TEST_CASE(ProcFileReaderUnittest, TestCachedPidDirs)
+UNIT_TEST_CASE(ProcFileReaderUnittest, TestSetProcPath)
+UNIT_TEST_CASE(ProcFileReaderUnittest, TestConcurrentRead)
+UNIT_TEST_CASE(ProcFileReaderUnittest, TestReadBenchmark)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -89,6 +89,7 @@ void CompressorFactoryUnittest::TestCreate() {
 void CompressorFactoryUnittest::TestCompressTypeToString() {
     APSARA_TEST_STREQ("lz4", CompressTypeToString(CompressType::LZ4).data());
     APSARA_TEST_STREQ("zstd", CompressTypeToString(CompressType::ZSTD).data());
+    APSARA_TEST_STREQ("snappy", CompressTypeToString(CompressType::SNAPPY).data());
     APSARA_TEST_STREQ("none", CompressTypeToString(CompressType::NONE).data());
 }
 
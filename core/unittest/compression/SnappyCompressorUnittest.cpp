@@ -0,0 +1,87 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/compression/SnappyCompressor.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class SnappyCompressorUnittest : public ::testing::Test {
+public:
+    void TestCompress();
+    void TestCompressLargeInput();
+};
+
+void SnappyCompressorUnittest::TestCompress() {
+    SnappyCompressor compressor(CompressType::SNAPPY);
+    {
+        string output, errorMsg;
+        APSARA_TEST_TRUE(compressor.DoCompress("", output, errorMsg));
+        APSARA_TEST_EQUAL(string(1, '\0'), output);
+    }
+    {
+        // too short to be matched, so it is written as a single literal
+        string output, errorMsg;
+        APSARA_TEST_TRUE(compressor.DoCompress("hello world", output, errorMsg));
+        APSARA_TEST_EQUAL(string("\x0b\x28hello world"), output);
+    }
+    {
+        string input = "hello world";
+        for (size_t i = 0; i < 5; ++i) {
+            input += input;
+        }
+        string output, errorMsg;
+        APSARA_TEST_TRUE(compressor.DoCompress(input, output, errorMsg));
+        APSARA_TEST_TRUE(output.size() < input.size() / 4);
+        string decompressed;
+        decompressed.resize(input.size());
+        APSARA_TEST_TRUE(compressor.UnCompress(output, decompressed, errorMsg));
+        APSARA_TEST_EQUAL(input, decompressed);
+    }
+}
+
+void SnappyCompressorUnittest::TestCompressLargeInput() {
+    // spans several blocks with both long literals and long copies
+    SnappyCompressor compressor(CompressType::SNAPPY);
+    string input;
+    uint32_t seed = 1;
+    while (input.size() < 300 * 1024) {
+        seed = seed * 1103515245 + 12345;
+        if (seed % 3 == 0) {
+            input.append(200, static_cast<char>('a' + seed % 26));
+        } else {
+            for (size_t i = 0; i < 100; ++i) {
+                seed = seed * 1103515245 + 12345;
+                input.push_back(static_cast<char>(seed >> 16));
+            }
+            input += "http_requests_total{method=\"GET\",status=\"200\"}";
+        }
+    }
+    string output, errorMsg;
+    APSARA_TEST_TRUE(compressor.DoCompress(input, output, errorMsg));
+    APSARA_TEST_TRUE(output.size() < input.size());
+    string decompressed;
+    decompressed.resize(input.size());
+    APSARA_TEST_TRUE(compressor.UnCompress(output, decompressed, errorMsg));
+    APSARA_TEST_EQUAL(input, decompressed);
+}
+
+UNIT_TEST_CASE(SnappyCompressorUnittest, TestCompress)
+UNIT_TEST_CASE(SnappyCompressorUnittest, TestCompressLargeInput)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -15,10 +15,16 @@
 
 #include <algorithm>
 #include <boost/regex.hpp>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -27,16 +33,72 @@
 
 #include "common/FileSystemUtil.h"
 #include "common/JsonUtil.h"
+#include "common/Flags.h"
 #include "common/RuntimeUtil.h"
+#include "common/TimeUtil.h"
 #include "container_manager/ContainerDiscoveryOptions.h"
 #include "container_manager/ContainerManager.h"
+#include "file_server/FileServer.h"
 #include "unittest/Unittest.h"
 #include "unittest/pipeline/LogtailPluginMock.h"
 
 using namespace std;
 
+DECLARE_FLAG_INT32(container_discovery_polling_interval);
+DECLARE_FLAG_INT32(container_discovery_latency_timeout);
+
 namespace logtail {
 
+class FakeContainerEventSource : public ContainerEventSource {
+public:
+    bool Run(const std::function<void(const ContainerEvent&)>& handler) override {
+        std::unique_lock<std::mutex> lock(mMux);
+        mRunning = true;
+        mCV.notify_all();
+        while (!mStopped) {
+            if (mEvents.empty()) {
+                mCV.wait(lock);
+                continue;
+            }
+            std::vector<ContainerEvent> events;
+            events.swap(mEvents);
+            lock.unlock();
+            for (const auto& event : events) {
+                handler(event);
+            }
+            lock.lock();
+        }
+        mRunning = false;
+        return false;
+    }
+
+    void Stop() override {
+        std::lock_guard<std::mutex> lock(mMux);
+        mStopped = true;
+        mCV.notify_all();
+    }
+
+    bool IsSupported() const override { return true; }
+
+    void Push(const ContainerEvent& event) {
+        std::lock_guard<std::mutex> lock(mMux);
+        mEvents.push_back(event);
+        mCV.notify_all();
+    }
+
+    bool WaitRunning(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mMux);
+        return mCV.wait_for(lock, timeout, [this]() { return mRunning; });
+    }
+
+private:
+    std::mutex mMux;
+    std::condition_variable mCV;
+    std::vector<ContainerEvent> mEvents;
+    bool mRunning = false;
+    bool mStopped = false;
+};
+
 class ContainerManagerUnittest : public testing::Test {
 public:
     void TestcomputeMatchedContainersDiff() const;
@@ -52,6 +114,12 @@ public:
     void TestLoadContainerInfoVersionHandling() const;
     void TestSaveContainerInfoWithVersion() const;
     void TestContainerMatchingConsistency() const;
+    void TestIncrementalMatch() const;
+    void TestIncrementalUpdateDuringDiffCheck() const;
+    void TestRegexResultCache() const;
+    void TestMatchBenchmark() const;
+    void TestEventDrivenDiscovery() const;
+    void TestAwaitedContainers() const;
     void runTestFile(const std::string& testFilePath) const;
 
 private:
@@ -1339,6 +1407,326 @@ void ContainerManagerUnittest::parseLabelFilters(const Json::Value& filtersJson,
     }
 }
 
+static std::shared_ptr<RawContainerInfo>
+makeBenchContainer(size_t idx, const std::string& ns, const std::string& app, const std::string& status = "running") {
+    auto info = std::make_shared<RawContainerInfo>();
+    info->mID = "container-" + std::to_string(idx);
+    info->mStatus = status;
+    info->mK8sInfo.mNamespace = ns;
+    info->mK8sInfo.mPod = app + "-pod-" + std::to_string(idx);
+    info->mK8sInfo.mContainerName = app;
+    info->mK8sInfo.mLabels["app"] = app;
+    info->mEnv["ENV"] = idx % 3 == 0 ? "test" : "prod";
+    info->mContainerLabels["io.kubernetes.container.name"] = app;
+    return info;
+}
+
+static ContainerFilters makeBenchFilters(size_t idx) {
+    ContainerFilters filters;
+    filters.mK8SFilter.mNamespaceReg = std::make_shared<boost::regex>("^ns-" + std::to_string(idx % 10) + "$");
+    filters.mK8SFilter.mPodReg = std::make_shared<boost::regex>("^app-" + std::to_string(idx % 20) + "-pod-.*");
+    filters.mK8SFilter.mK8sLabelFilter.mIncludeFields.mFieldsMap["app"] = "app-" + std::to_string(idx % 20);
+    filters.mEnvFilter.mExcludeFields.mFieldsRegMap["ENV"] = std::make_shared<boost::regex>("^test$");
+    return filters;
+}
+
+static std::vector<std::string> diffIDs(const std::vector<std::shared_ptr<RawContainerInfo>>& containers) {
+    std::vector<std::string> ids;
+    for (const auto& c : containers) {
+        ids.push_back(c->mID);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void ContainerManagerUnittest::TestIncrementalMatch() const {
+    ContainerManager containerManager;
+    for (size_t i = 0; i < 100; ++i) {
+        auto c = makeBenchContainer(i, "ns-" + std::to_string(i % 10), "app-" + std::to_string(i % 20));
+        containerManager.mContainerMap[c->mID] = c;
+    }
+    auto filters = makeBenchFilters(3);
+
+    // initial full match
+    std::set<std::string> fullList;
+    std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>> matchList;
+    {
+        ContainerDiff diff;
+        containerManager.computeMatchedContainersDiff(fullList, matchList, filters, false, diff);
+        APSARA_TEST_EQUAL(100U, fullList.size());
+        for (const auto& c : diff.mAdded) {
+            matchList[c->mID] = c;
+        }
+        APSARA_TEST_EQUAL(3U, matchList.size());
+    }
+
+    // churn: add, modify a matched one, delete a matched one, start a created one
+    std::unordered_set<std::string> changed;
+    auto added = makeBenchContainer(100, "ns-3", "app-3");
+    containerManager.mContainerMap[added->mID] = added;
+    changed.insert(added->mID);
+    auto created = makeBenchContainer(102, "ns-3", "app-3", "created");
+    containerManager.mContainerMap[created->mID] = created;
+    changed.insert(created->mID);
+    auto matchedIt = matchList.begin();
+    auto modified = std::make_shared<RawContainerInfo>(*matchedIt->second);
+    modified->mLogPath = "/new/log/path";
+    containerManager.mContainerMap[modified->mID] = modified;
+    changed.insert(modified->mID);
+    ++matchedIt;
+    containerManager.mContainerMap.erase(matchedIt->first);
+    changed.insert(matchedIt->first);
+    // unchanged container updated with an equal copy
+    auto sameIt = std::next(matchedIt);
+    containerManager.mContainerMap[sameIt->first] = std::make_shared<RawContainerInfo>(*sameIt->second);
+    changed.insert(sameIt->first);
+
+    auto fullList2 = fullList;
+    ContainerDiff fullDiff;
+    containerManager.computeMatchedContainersDiff(fullList2, matchList, filters, false, fullDiff);
+    ContainerDiff incDiff;
+    containerManager.computeMatchedContainersDiff(fullList, matchList, filters, false, changed, incDiff);
+
+    APSARA_TEST_EQUAL(fullList2, fullList);
+    APSARA_TEST_EQUAL(diffIDs(fullDiff.mAdded), diffIDs(incDiff.mAdded));
+    APSARA_TEST_EQUAL(std::vector<std::string>({added->mID}), diffIDs(incDiff.mAdded));
+    APSARA_TEST_EQUAL(diffIDs(fullDiff.mModified), diffIDs(incDiff.mModified));
+    APSARA_TEST_EQUAL(std::vector<std::string>({modified->mID}), diffIDs(incDiff.mModified));
+    APSARA_TEST_EQUAL(fullDiff.mRemoved, incDiff.mRemoved);
+    APSARA_TEST_EQUAL(std::vector<std::string>({matchedIt->first}), incDiff.mRemoved);
+    APSARA_TEST_EQUAL(0U, fullList.count(created->mID));
+}
+
+void ContainerManagerUnittest::TestIncrementalUpdateDuringDiffCheck() const {
+    ContainerManager containerManager;
+    containerManager.mIsRunning = true;
+    FileDiscoveryOptions options;
+    options.SetEnableContainerDiscoveryFlag(true);
+    options.SetContainerInfo(std::make_shared<std::vector<ContainerInfo>>());
+    CollectionPipelineContext ctx;
+    ctx.SetConfigName("test_config");
+    FileServer::GetInstance()->AddFileDiscoveryConfig("test_config", &options, &ctx);
+
+    // initial full match of the config
+    containerManager.CheckContainerDiffForAllConfig();
+    APSARA_TEST_NOT_EQUAL(0U, options.GetLastContainerUpdateTime());
+
+    // a container is updated while the config is being matched, the match finishes after the update
+    LogtailPluginMock::GetInstance()->SetUpDiffContainersMeta(R"({
+        "Update": [
+            {
+                "ID": "interleaved",
+                "Status": "running",
+                "UpperDir": "/var/lib/docker/containers/interleaved",
+                "LogPath": "/var/lib/docker/containers/interleaved/logs"
+            }
+        ]
+    })");
+    APSARA_TEST_TRUE(containerManager.incrementallyUpdateContainersSnapshot());
+    options.SetLastContainerUpdateTime(time(nullptr) + 10);
+
+    // the change is still matched by the next diff check instead of being skipped with the config
+    APSARA_TEST_TRUE(containerManager.CheckContainerDiffForAllConfig());
+    auto diff = containerManager.mConfigContainerDiffMap["test_config"];
+    APSARA_TEST_TRUE(diff != nullptr);
+    APSARA_TEST_EQUAL(std::vector<std::string>({"interleaved"}), diffIDs(diff->mAdded));
+    APSARA_TEST_TRUE(containerManager.mChangedContainerIDs.empty());
+
+    // nothing changed since
+    APSARA_TEST_FALSE(containerManager.CheckContainerDiffForAllConfig());
+
+    FileServer::GetInstance()->RemoveFileDiscoveryConfig("test_config");
+    LogtailPluginMock::GetInstance()->SetUpDiffContainersMeta("");
+    containerManager.mIsRunning = false;
+}
+
+void ContainerManagerUnittest::TestRegexResultCache() const {
+    ContainerMatcher matcher;
+    // different regex objects with the same pattern share results
+    boost::regex reg1("^kube-.*");
+    boost::regex reg2("^kube-.*");
+    APSARA_TEST_TRUE(matcher.RegexSearch(reg1, "kube-system"));
+    APSARA_TEST_TRUE(matcher.RegexSearch(reg2, "kube-system"));
+    APSARA_TEST_FALSE(matcher.RegexSearch(reg2, "default"));
+    APSARA_TEST_EQUAL(1U, matcher.GetHitCount());
+    APSARA_TEST_EQUAL(2U, matcher.GetMissCount());
+    APSARA_TEST_EQUAL(2U, matcher.GetCachedCount());
+
+    boost::regex reg3("default");
+    APSARA_TEST_TRUE(matcher.RegexSearch(reg3, "default"));
+    APSARA_TEST_EQUAL(3U, matcher.GetCachedCount());
+
+    // a regex destroyed and another pattern created at the same address, as on config reload
+    std::optional<boost::regex> reg4("^kube-.*");
+    APSARA_TEST_TRUE(matcher.RegexSearch(*reg4, "kube-public"));
+    reg4.emplace("default");
+    APSARA_TEST_FALSE(matcher.RegexSearch(*reg4, "kube-public"));
+    APSARA_TEST_TRUE(matcher.RegexSearch(*reg4, "default"));
+    APSARA_TEST_EQUAL(5U, matcher.GetCachedCount());
+
+    matcher.Clear();
+    APSARA_TEST_EQUAL(0U, matcher.GetCachedCount());
+    APSARA_TEST_TRUE(matcher.RegexSearch(reg1, "kube-system"));
+    APSARA_TEST_EQUAL(6U, matcher.GetMissCount());
+}
+
+void ContainerManagerUnittest::TestMatchBenchmark() const {
+    const size_t configCount = 400;
+    const size_t containerCount = 200;
+    ContainerManager containerManager;
+    for (size_t i = 0; i < containerCount; ++i) {
+        auto c = makeBenchContainer(i, "ns-" + std::to_string(i % 10), "app-" + std::to_string(i % 20));
+        containerManager.mContainerMap[c->mID] = c;
+    }
+    std::vector<ContainerFilters> filters;
+    for (size_t i = 0; i < configCount; ++i) {
+        filters.push_back(makeBenchFilters(i));
+    }
+    std::vector<std::set<std::string>> fullLists(configCount);
+    std::vector<std::unordered_map<std::string, std::shared_ptr<RawContainerInfo>>> matchLists(configCount);
+
+    // every config against every container, as done before on each diff
+    size_t uncachedMatched = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < configCount; ++i) {
+        for (const auto& pair : containerManager.mContainerMap) {
+            ContainerMatcher matcher;
+            uncachedMatched += matcher.IsMatch(filters[i], *pair.second);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << "[full match, no cache] configs: " << configCount << " containers: " << containerCount
+              << " elapsed: " << elapsed.count() << " seconds" << std::endl;
+
+    size_t matched = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < configCount; ++i) {
+        ContainerDiff diff;
+        containerManager.computeMatchedContainersDiff(fullLists[i], matchLists[i], filters[i], false, diff);
+        for (const auto& c : diff.mAdded) {
+            matchLists[i][c->mID] = c;
+        }
+        matched += diff.mAdded.size();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    elapsed = end - start;
+    APSARA_TEST_EQUAL(uncachedMatched, matched);
+    std::cout << "[full match, regex cache] elapsed: " << elapsed.count()
+              << " seconds, cached: " << containerManager.mMatcher.GetCachedCount() << std::endl;
+
+    // pod churn: a few containers replaced
+    std::unordered_set<std::string> changed;
+    for (size_t i = 0; i < 5; ++i) {
+        containerManager.mContainerMap.erase("container-" + std::to_string(i));
+        changed.insert("container-" + std::to_string(i));
+        auto c = makeBenchContainer(
+            containerCount + i, "ns-" + std::to_string(i % 10), "app-" + std::to_string(i % 20));
+        containerManager.mContainerMap[c->mID] = c;
+        changed.insert(c->mID);
+    }
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < configCount; ++i) {
+        ContainerDiff diff;
+        containerManager.computeMatchedContainersDiff(fullLists[i], matchLists[i], filters[i], false, changed, diff);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    elapsed = end - start;
+    std::cout << "[incremental match] changed: " << changed.size() << " elapsed: " << elapsed.count() << " seconds"
+              << std::endl;
+    for (size_t i = 0; i < configCount; ++i) {
+        APSARA_TEST_EQUAL(containerCount, fullLists[i].size());
+    }
+}
+
+void ContainerManagerUnittest::TestEventDrivenDiscovery() const {
+    int32_t pollingInterval = INT32_FLAG(container_discovery_polling_interval);
+    // only the first polling round is done within the test
+    INT32_FLAG(container_discovery_polling_interval) = 60;
+    LogtailPluginMock::GetInstance()->SetUpContainersMeta("");
+    LogtailPluginMock::GetInstance()->SetUpDiffContainersMeta(R"({
+        "Update": [
+            {
+                "ID": "event1",
+                "UpperDir": "/var/lib/docker/containers/event1",
+                "LogPath": "/var/lib/docker/containers/event1/logs"
+            }
+        ]
+    })");
+
+    ContainerManager containerManager;
+    auto* source = new FakeContainerEventSource();
+    containerManager.mEventSource.reset(source);
+    containerManager.Init();
+    APSARA_TEST_TRUE(source->WaitRunning(std::chrono::seconds(5)));
+
+    ContainerEvent event;
+    event.mContainerID = "event1";
+    event.mType = ContainerEventType::STARTED;
+    event.mTimeMs = GetCurrentTimeInMilliSeconds();
+    source->Push(event);
+
+    // discovered long before the next polling round
+    bool discovered = false;
+    for (int i = 0; i < 50 && !discovered; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::lock_guard<std::mutex> lock(containerManager.mContainerMapMutex);
+        discovered = containerManager.mContainerMap.find("event1") != containerManager.mContainerMap.end();
+    }
+    APSARA_TEST_TRUE(discovered);
+    APSARA_TEST_TRUE(containerManager.HasEventDrivenChanges());
+    APSARA_TEST_EQUAL(1U, containerManager.mContainerEventsTotal->GetValue());
+
+    containerManager.OnContainerFirstRead("event1");
+    APSARA_TEST_EQUAL(1U, containerManager.mDiscoveredContainersTotal->GetValue());
+    APSARA_TEST_TRUE(containerManager.mLastContainerDiscoveryLatencyMs->GetValue() < 5000);
+    // only the first read counts
+    containerManager.OnContainerFirstRead("event1");
+    APSARA_TEST_EQUAL(1U, containerManager.mDiscoveredContainersTotal->GetValue());
+
+    containerManager.Stop();
+    APSARA_TEST_TRUE(containerManager.mEventSource == nullptr);
+    LogtailPluginMock::GetInstance()->SetUpDiffContainersMeta("");
+    INT32_FLAG(container_discovery_polling_interval) = pollingInterval;
+}
+
+void ContainerManagerUnittest::TestAwaitedContainers() const {
+    ContainerManager containerManager;
+    time_t now = time(nullptr);
+    uint64_t nowMs = now * 1000ULL;
+
+    ContainerEvent event;
+    event.mType = ContainerEventType::STARTED;
+    event.mContainerID = "found";
+    event.mTimeMs = nowMs;
+    containerManager.OnContainerEvent(event);
+    event.mContainerID = "missing";
+    containerManager.OnContainerEvent(event);
+    event.mContainerID = "deleted";
+    containerManager.OnContainerEvent(event);
+    event.mContainerID = "stale";
+    event.mTimeMs = nowMs - (INT32_FLAG(container_discovery_latency_timeout) + 1) * 1000ULL;
+    containerManager.OnContainerEvent(event);
+    event.mContainerID = "deleted";
+    event.mType = ContainerEventType::DELETED;
+    containerManager.OnContainerEvent(event);
+    containerManager.drainContainerEvents(now);
+    APSARA_TEST_EQUAL(3U, containerManager.mAwaitedContainers.size());
+
+    containerManager.mContainerMap["found"] = std::make_shared<RawContainerInfo>();
+    containerManager.updateAwaitedContainers(now);
+    // missing containers are retried shortly
+    APSARA_TEST_EQUAL(2U, containerManager.mAwaitedContainers.size());
+    APSARA_TEST_TRUE(containerManager.mAwaitedContainers.find("missing") != containerManager.mAwaitedContainers.end());
+    APSARA_TEST_TRUE(containerManager.waitForNextPolling());
+    // start time of a container never read expires
+    APSARA_TEST_EQUAL(2U, containerManager.mContainerStartTimes.size());
+
+    // give up retrying after the timeout
+    containerManager.updateAwaitedContainers(now + 3600);
+    APSARA_TEST_TRUE(containerManager.mAwaitedContainers.empty());
+}
+
 UNIT_TEST_CASE(ContainerManagerUnittest, TestcomputeMatchedContainersDiff)
 UNIT_TEST_CASE(ContainerManagerUnittest, TestrefreshAllContainersSnapshot)
 UNIT_TEST_CASE(ContainerManagerUnittest, TestincrementallyUpdateContainersSnapshot)
@@ -1352,6 +1740,12 @@ UNIT_TEST_CASE(ContainerManagerUnittest, TestLoadContainerInfoFromContainersForm
 UNIT_TEST_CASE(ContainerManagerUnittest, TestLoadContainerInfoVersionHandling)
 UNIT_TEST_CASE(ContainerManagerUnittest, TestSaveContainerInfoWithVersion)
 UNIT_TEST_CASE(ContainerManagerUnittest, TestContainerMatchingConsistency)
+UNIT_TEST_CASE(ContainerManagerUnittest, TestIncrementalMatch)
+UNIT_TEST_CASE(ContainerManagerUnittest, TestIncrementalUpdateDuringDiffCheck)
+UNIT_TEST_CASE(ContainerManagerUnittest, TestRegexResultCache)
+UNIT_TEST_CASE(ContainerManagerUnittest, TestMatchBenchmark)
+UNIT_TEST_CASE(ContainerManagerUnittest, TestEventDrivenDiscovery)
+UNIT_TEST_CASE(ContainerManagerUnittest, TestAwaitedContainers)
 
 } // namespace logtail
 
@@ -0,0 +1,180 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "grpcpp/server.h"
+#include "grpcpp/server_builder.h"
+
+#include "common/FileSystemUtil.h"
+#include "container_manager/cri/CriContainerEventSource.h"
+#include "protobuf/cri/api.grpc.pb.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// local cri runtime which streams the given events, then holds the stream until the client cancels it
+class FakeRuntimeService : public runtime::v1::RuntimeService::Service {
+public:
+    explicit FakeRuntimeService(std::vector<runtime::v1::ContainerEventResponse> events) : mEvents(std::move(events)) {}
+
+    grpc::Status GetContainerEvents(grpc::ServerContext* context,
+                                    const runtime::v1::GetEventsRequest*,
+                                    grpc::ServerWriter<runtime::v1::ContainerEventResponse>* writer) override {
+        for (const auto& event : mEvents) {
+            writer->Write(event);
+        }
+        while (!context->IsCancelled()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return grpc::Status::CANCELLED;
+    }
+
+private:
+    std::vector<runtime::v1::ContainerEventResponse> mEvents;
+};
+
+// runtime without container events
+class LegacyRuntimeService : public runtime::v1::RuntimeService::Service {};
+
+class CriContainerEventSourceUnittest : public testing::Test {
+public:
+    void TestReceiveEvents();
+    void TestUnimplemented();
+    void TestRuntimeUnavailable();
+    void TestConvertEvent();
+
+protected:
+    void SetUp() override {
+        mSocketPath = GetProcessExecutionDir() + "cri_event_test.sock";
+        remove(mSocketPath.c_str());
+        mEndpoint = "unix://" + mSocketPath;
+    }
+
+    void TearDown() override {
+        if (mServer) {
+            mServer->Shutdown(std::chrono::system_clock::now());
+            mServer.reset();
+        }
+        remove(mSocketPath.c_str());
+    }
+
+    void startServer(grpc::Service* service) {
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort(mEndpoint, grpc::InsecureServerCredentials());
+        builder.RegisterService(service);
+        mServer = builder.BuildAndStart();
+        APSARA_TEST_TRUE_FATAL(mServer != nullptr);
+    }
+
+    std::string mSocketPath;
+    std::string mEndpoint;
+    std::unique_ptr<grpc::Server> mServer;
+};
+
+static runtime::v1::ContainerEventResponse
+makeEvent(const std::string& id, runtime::v1::ContainerEventType type, int64_t createdAt) {
+    runtime::v1::ContainerEventResponse event;
+    event.set_container_id(id);
+    event.set_container_event_type(type);
+    event.set_created_at(createdAt);
+    return event;
+}
+
+void CriContainerEventSourceUnittest::TestReceiveEvents() {
+    FakeRuntimeService service({makeEvent("c1", runtime::v1::CONTAINER_CREATED_EVENT, 1700000000000000000),
+                                makeEvent("c1", runtime::v1::CONTAINER_STARTED_EVENT, 1700000001000000000),
+                                makeEvent("c2", runtime::v1::CONTAINER_DELETED_EVENT, 1700000002000000000)});
+    startServer(&service);
+
+    CriContainerEventSource source(mEndpoint);
+    std::mutex mux;
+    std::condition_variable cv;
+    std::vector<ContainerEvent> received;
+    auto res = std::async(std::launch::async, [&]() {
+        return source.Run([&](const ContainerEvent& event) {
+            std::lock_guard<std::mutex> lock(mux);
+            received.push_back(event);
+            cv.notify_all();
+        });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mux);
+        APSARA_TEST_TRUE(cv.wait_for(lock, std::chrono::seconds(10), [&]() { return received.size() == 3; }));
+    }
+    // the stream is held by the runtime until stopped
+    APSARA_TEST_EQUAL(std::future_status::timeout, res.wait_for(std::chrono::milliseconds(100)));
+    source.Stop();
+    APSARA_TEST_EQUAL(std::future_status::ready, res.wait_for(std::chrono::seconds(10)));
+    APSARA_TEST_FALSE(res.get());
+    APSARA_TEST_TRUE(source.IsSupported());
+
+    APSARA_TEST_EQUAL("c1", received[0].mContainerID);
+    APSARA_TEST_TRUE(ContainerEventType::CREATED == received[0].mType);
+    APSARA_TEST_EQUAL(1700000000000ULL, received[0].mTimeMs);
+    APSARA_TEST_TRUE(ContainerEventType::STARTED == received[1].mType);
+    APSARA_TEST_EQUAL(1700000001000ULL, received[1].mTimeMs);
+    APSARA_TEST_EQUAL("c2", received[2].mContainerID);
+    APSARA_TEST_TRUE(ContainerEventType::DELETED == received[2].mType);
+
+    // a stopped source never runs again
+    APSARA_TEST_FALSE(source.Run([](const ContainerEvent&) {}));
+}
+
+void CriContainerEventSourceUnittest::TestUnimplemented() {
+    LegacyRuntimeService service;
+    startServer(&service);
+
+    CriContainerEventSource source(mEndpoint);
+    size_t count = 0;
+    APSARA_TEST_FALSE(source.Run([&](const ContainerEvent&) { ++count; }));
+    APSARA_TEST_EQUAL(0U, count);
+    APSARA_TEST_FALSE(source.IsSupported());
+}
+
+void CriContainerEventSourceUnittest::TestRuntimeUnavailable() {
+    CriContainerEventSource source(mEndpoint);
+    APSARA_TEST_FALSE(source.Run([](const ContainerEvent&) {}));
+    // may come up later
+    APSARA_TEST_TRUE(source.IsSupported());
+}
+
+void CriContainerEventSourceUnittest::TestConvertEvent() {
+    ContainerEvent event;
+    APSARA_TEST_FALSE(
+        CriContainerEventSource::ConvertEvent(makeEvent("", runtime::v1::CONTAINER_STARTED_EVENT, 1), event));
+    APSARA_TEST_TRUE(
+        CriContainerEventSource::ConvertEvent(makeEvent("c1", runtime::v1::CONTAINER_STOPPED_EVENT, 0), event));
+    APSARA_TEST_TRUE(ContainerEventType::STOPPED == event.mType);
+    // missing created_at is filled with the receive time
+    APSARA_TEST_TRUE(event.mTimeMs > 0);
+}
+
+UNIT_TEST_CASE(CriContainerEventSourceUnittest, TestReceiveEvents)
+UNIT_TEST_CASE(CriContainerEventSourceUnittest, TestUnimplemented)
+UNIT_TEST_CASE(CriContainerEventSourceUnittest, TestRuntimeUnavailable)
+UNIT_TEST_CASE(CriContainerEventSourceUnittest, TestConvertEvent)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "common/Flags.h"
+#include "file_server/ConfigManager.h"
 #include "file_server/EventDispatcher.h"
 #include "file_server/event/Event.h"
 #include "file_server/event_handler/EventHandler.h"
@@ -145,11 +146,36 @@ public:
             }
         }
     }
+
+    void TestUnregisterDirsOfRemovedConfig() {
+        LOG_INFO(sLogger, ("TestUnregisterDirsOfRemovedConfig() begin", time(NULL)));
+        auto* dispatcher = EventDispatcher::GetInstance();
+        // an empty dir registered by the removed config only, which has no reader and keeps the shared handler
+        auto* emptyDir = dispatcher->mWdDirInfoMap[0];
+        emptyDir->mHandler = ConfigManager::GetInstance()->GetSharedHandler();
+        emptyDir->mConfigNames.insert("removed");
+        std::string emptyDirPath = emptyDir->mPath;
+        // a dir registered by both the removed config and another config
+        dispatcher->mWdDirInfoMap[1]->mConfigNames = {"removed", "other"};
+        // a dir registered by another config only
+        dispatcher->mWdDirInfoMap[2]->mConfigNames.insert("other");
+
+        std::vector<std::string> configDirs;
+        dispatcher->DumpHandlersMeta({"removed"}, configDirs);
+        APSARA_TEST_EQUAL_FATAL(2UL, configDirs.size());
+        dispatcher->UnregisterUnmatchedDirs(configDirs);
+        APSARA_TEST_FALSE(dispatcher->IsRegistered(emptyDirPath));
+        APSARA_TEST_TRUE(dispatcher->IsRegistered(dispatcher->mWdDirInfoMap[1]->mPath));
+        APSARA_TEST_EQUAL(std::unordered_set<std::string>({"other"}), dispatcher->mWdDirInfoMap[1]->mConfigNames);
+        APSARA_TEST_TRUE(dispatcher->IsRegistered(dispatcher->mWdDirInfoMap[2]->mPath));
+        ConfigManager::GetInstance()->DeleteHandlers();
+    }
 };
 
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestFindAllSubDirAndHandler, 0);
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestUnregisterAllDir, 0);
 APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestStopAllDir, 0);
+APSARA_UNIT_TEST_CASE(EventDispatcherDirUnittest, TestUnregisterDirsOfRemovedConfig, 0);
 } // end of namespace logtail
 
 int main(int argc, char** argv) {
@@ -38,6 +38,7 @@ public:
     void TestSpanIDUniqueness();
     void TestTraceIDConversion();
     void TestSpanIDConversion();
+    void TestParseTraceParent();
     void TraceIDBenchmark();
     void FromTraceIDBenchmark();
 
@@ -152,6 +153,21 @@ void CommonUtilUnittest::TestTraceIDConversion() {
     APSARA_TEST_EQUAL(hexString, expected);
 }
 
+void CommonUtilUnittest::TestParseTraceParent() {
+    std::array<uint64_t, 4> traceId = {};
+    APSARA_TEST_TRUE(ParseTraceParent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01", traceId));
+    APSARA_TEST_EQUAL(0UL, traceId[0]);
+    APSARA_TEST_EQUAL(0UL, traceId[1]);
+    APSARA_TEST_EQUAL(0x4bf92f3577b34da6UL, traceId[2]);
+    APSARA_TEST_EQUAL(0xa3ce929d0e0e4736UL, traceId[3]);
+
+    APSARA_TEST_FALSE(ParseTraceParent("", traceId));
+    APSARA_TEST_FALSE(ParseTraceParent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7", traceId));
+    APSARA_TEST_FALSE(ParseTraceParent("00-00000000000000000000000000000000-00f067aa0ba902b7-01", traceId));
+    APSARA_TEST_FALSE(ParseTraceParent("00-4bf92f3577b34da6a3ce929d0e0e473x-00f067aa0ba902b7-01", traceId));
+    APSARA_TEST_FALSE(ParseTraceParent("00_4bf92f3577b34da6a3ce929d0e0e4736_00f067aa0ba902b7_01", traceId));
+}
+
 void CommonUtilUnittest::TestSpanIDConversion() {
     // 创建一个已知的 SpanID 数组
     std::array<uint64_t, 2> spanId = {};
@@ -327,6 +343,7 @@ UNIT_TEST_CASE(CommonUtilUnittest, TestSpanIDFormat);
 UNIT_TEST_CASE(CommonUtilUnittest, TestSpanIDUniqueness);
 UNIT_TEST_CASE(CommonUtilUnittest, TestTraceIDConversion);
 UNIT_TEST_CASE(CommonUtilUnittest, TestSpanIDConversion);
+UNIT_TEST_CASE(CommonUtilUnittest, TestParseTraceParent);
 
 UNIT_TEST_CASE(CommonUtilUnittest, TraceIDBenchmark);
 UNIT_TEST_CASE(CommonUtilUnittest, FromTraceIDBenchmark);
@@ -0,0 +1,167 @@
+// Copyright 2025 LoongCollector Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ebpf/plugin/ProcessCache.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+using namespace logtail;
+
+// Mixed lookup/churn workload: several handler threads keep looking up live processes (as AttachProcessData does for
+// every network/file event), while one writer keeps adding processes and releasing them (exec/clone/exit) and runs gc.
+class ProcessCacheBenchmark : public testing::Test {
+public:
+    void TestMixedLookupAndChurn_1Reader();
+    void TestMixedLookupAndChurn_4Readers();
+    void TestMixedLookupAndChurn_16Readers();
+
+private:
+    void runProcessCache(size_t readers);
+    void runMutexMap(size_t readers);
+
+    static constexpr size_t kLivePids = 10000;
+    static constexpr size_t kLookupsPerReader = 2000000;
+};
+
+void ProcessCacheBenchmark::runProcessCache(size_t readers) {
+    ProcParser procParser("/");
+    ProcessCache cache(65536, procParser);
+    for (size_t i = 0; i < kLivePids; ++i) {
+        auto value = std::make_shared<ProcessCacheValue>();
+        cache.AddCache({static_cast<uint32_t>(i), i}, value);
+    }
+
+    atomic_bool stop = false;
+    atomic_size_t churned = 0;
+    thread writer([&]() {
+        uint32_t pid = kLivePids;
+        while (!stop) {
+            data_event_id key{pid, pid};
+            auto value = std::make_shared<ProcessCacheValue>();
+            cache.AddCache(key, value);
+            cache.DecRef(key, value);
+            if (++pid % 1000 == 0) {
+                cache.ClearExpiredCache();
+            }
+            ++churned;
+        }
+    });
+
+    auto start = std::chrono::high_resolution_clock::now();
+    vector<thread> lookups;
+    for (size_t t = 0; t < readers; ++t) {
+        lookups.emplace_back([&, t]() {
+            size_t hit = 0;
+            for (size_t i = 0; i < kLookupsPerReader; ++i) {
+                uint64_t pid = (i * 7 + t) % kLivePids;
+                hit += cache.Lookup({static_cast<uint32_t>(pid), pid}) != nullptr;
+            }
+            APSARA_TEST_EQUAL(kLookupsPerReader, hit);
+        });
+    }
+    for (auto& t : lookups) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    stop = true;
+    writer.join();
+    std::chrono::duration<double> elapsed = end - start;
+    cout << "[ProcessCache] readers: " << readers << " elapsed: " << elapsed.count()
+         << " seconds, lookups/s: " << readers * kLookupsPerReader / elapsed.count() << ", churn: " << churned.load()
+         << endl;
+}
+
+void ProcessCacheBenchmark::runMutexMap(size_t readers) {
+    mutex mux;
+    unordered_map<uint64_t, std::shared_ptr<ProcessCacheValue>> cache;
+    vector<uint64_t> expireQueue;
+    for (size_t i = 0; i < kLivePids; ++i) {
+        cache[i] = std::make_shared<ProcessCacheValue>();
+    }
+
+    atomic_bool stop = false;
+    atomic_size_t churned = 0;
+    thread writer([&]() {
+        uint64_t pid = kLivePids;
+        while (!stop) {
+            {
+                lock_guard<mutex> lock(mux);
+                cache[pid] = std::make_shared<ProcessCacheValue>();
+                expireQueue.push_back(pid);
+            }
+            if (++pid % 1000 == 0) {
+                lock_guard<mutex> lock(mux);
+                for (auto key : expireQueue) {
+                    cache.erase(key);
+                }
+                expireQueue.clear();
+            }
+            ++churned;
+        }
+    });
+
+    auto start = std::chrono::high_resolution_clock::now();
+    vector<thread> lookups;
+    for (size_t t = 0; t < readers; ++t) {
+        lookups.emplace_back([&, t]() {
+            size_t hit = 0;
+            for (size_t i = 0; i < kLookupsPerReader; ++i) {
+                uint64_t pid = (i * 7 + t) % kLivePids;
+                lock_guard<mutex> lock(mux);
+                auto it = cache.find(pid);
+                hit += it != cache.end() && it->second != nullptr;
+            }
+            APSARA_TEST_EQUAL(kLookupsPerReader, hit);
+        });
+    }
+    for (auto& t : lookups) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    stop = true;
+    writer.join();
+    std::chrono::duration<double> elapsed = end - start;
+    cout << "[mutex unordered_map] readers: " << readers << " elapsed: " << elapsed.count()
+         << " seconds, lookups/s: " << readers * kLookupsPerReader / elapsed.count() << ", churn: " << churned.load()
+         << endl;
+}
+
+void ProcessCacheBenchmark::TestMixedLookupAndChurn_1Reader() {
+    runProcessCache(1);
+    runMutexMap(1);
+}
+
+void ProcessCacheBenchmark::TestMixedLookupAndChurn_4Readers() {
+    runProcessCache(4);
+    runMutexMap(4);
+}
+
+void ProcessCacheBenchmark::TestMixedLookupAndChurn_16Readers() {
+    runProcessCache(16);
+    runMutexMap(16);
+}
+
+UNIT_TEST_CASE(ProcessCacheBenchmark, TestMixedLookupAndChurn_1Reader)
+UNIT_TEST_CASE(ProcessCacheBenchmark, TestMixedLookupAndChurn_4Readers)
+UNIT_TEST_CASE(ProcessCacheBenchmark, TestMixedLookupAndChurn_16Readers)
+
+UNIT_TEST_MAIN
@@ -20,6 +20,7 @@
 #include "ebpf/protocol/ProtocolParser.h"
 #include "ebpf/protocol/http/HttpParser.h"
 #include "ebpf/protocol/mysql/MysqlParser.h"
+#include "ebpf/util/TraceId.h"
 #include "logger/Logger.h"
 #include "unittest/Unittest.h"
 
@@ -37,6 +38,7 @@ public:
     void TestParsePartialRequests();
     void TestProtocolParserManager();
     void TestHttpParserEdgeCases();
+    void TestParseHttpTraceContext();
 
     void RequestBenchmark();
     void RequestWithoutBodyBenchmark();
@@ -87,6 +89,31 @@ void ProtocolParserUnittest::TestParseHttp() {
     APSARA_TEST_EQUAL(state, ParseState::kNeedsMoreData);
 }
 
+void ProtocolParserUnittest::TestParseHttpTraceContext() {
+    const std::string input = "GET /index.html HTTP/1.1\r\nHost: www.cmonitor.ai\r\n"
+                              "TraceParent: 00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01\r\n\r\n";
+    std::shared_ptr<HttpRecord> result = std::make_shared<HttpRecord>(nullptr, nullptr);
+    std::string_view buf(input);
+    HTTPRequest req;
+    int retval = http::ParseHttpRequest(buf, req);
+    APSARA_TEST_TRUE(http::ParseTraceContext(req, result));
+    APSARA_TEST_TRUE(result->HasTraceContext());
+    APSARA_TEST_EQUAL(0xa3ce929d0e0e4736UL, result->GetTraceContext()[3]);
+    APSARA_TEST_EQUAL("4bf92f3577b34da6a3ce929d0e0e4736", TraceParentIDToString(result->GetTraceContext()));
+    // the request is parsed from the same headers
+    APSARA_TEST_EQUAL(ParseState::kSuccess, http::ParseRequest(buf, req, retval, result, true));
+    APSARA_TEST_EQUAL("/index.html", result->GetPath());
+    APSARA_TEST_EQUAL("GET", result->GetMethod());
+
+    const std::string noContext = "GET /index.html HTTP/1.1\r\nHost: www.cmonitor.ai\r\n\r\n";
+    result = std::make_shared<HttpRecord>(nullptr, nullptr);
+    std::string_view noContextBuf(noContext);
+    HTTPRequest noContextReq;
+    http::ParseHttpRequest(noContextBuf, noContextReq);
+    APSARA_TEST_FALSE(http::ParseTraceContext(noContextReq, result));
+    APSARA_TEST_FALSE(result->HasTraceContext());
+}
+
 void ProtocolParserUnittest::TestParseHttpResponse() {
     const std::string input = "HTTP/1.1 200 OK\r\n"
                               "Content-Type: text/html\r\n"
@@ -450,6 +477,7 @@ UNIT_TEST_CASE(ProtocolParserUnittest, TestParseInvalidRequests);
 UNIT_TEST_CASE(ProtocolParserUnittest, TestParsePartialRequests);
 UNIT_TEST_CASE(ProtocolParserUnittest, TestProtocolParserManager);
 UNIT_TEST_CASE(ProtocolParserUnittest, TestHttpParserEdgeCases);
+UNIT_TEST_CASE(ProtocolParserUnittest, TestParseHttpTraceContext);
 UNIT_TEST_CASE(ProtocolParserUnittest, TestParseMysqlQuery);
 UNIT_TEST_CASE(ProtocolParserUnittest, TestParseMysqlResponse);
 UNIT_TEST_CASE(ProtocolParserUnittest, RequestBenchmark);
@@ -43,6 +43,7 @@ public:
     void TestProcessTable();
     void TestNetTable();
     void TestCompileOperations();
+    void TestSetGroupTagsNoCopy();
 
 protected:
     void SetUp() override {}
@@ -86,10 +87,35 @@ void TableUnittest::TestCompileOperations() {
     APSARA_TEST_EQUAL(tb.Get<kRemoteIp>(), "hhh");
 }
 
+void TableUnittest::TestSetGroupTagsNoCopy() {
+    StaticDataRow<&kAppStaticTable> row;
+    row.Set<kAppId>(std::string("id"));
+    row.Set<kAppName>(std::string("name"));
+    row.Set<kWorkspace>(std::string("ws"));
+    row.Set<kArmsServiceId>(std::string("sid"));
+    row.Set<kLanguage>(std::string("java"));
+
+    PipelineEventGroup metricGroup(std::make_shared<SourceBuffer>());
+    row.SetGroupTagsNoCopy(metricGroup, &DataTableSchema::ColMetricKey);
+    APSARA_TEST_EQUAL(kAppStaticTable.Size(), metricGroup.GetTags().size());
+    APSARA_TEST_EQUAL(metricGroup.GetTag(kAppId.MetricKey()), "id");
+    APSARA_TEST_EQUAL(metricGroup.GetTag(kAppName.MetricKey()), "name");
+    APSARA_TEST_EQUAL(metricGroup.GetTag(kLanguage.MetricKey()), "java");
+    // values are referenced, not copied
+    APSARA_TEST_EQUAL(metricGroup.GetTag(kAppId.MetricKey()).data(), row.Get<kAppId>().data());
+    APSARA_TEST_EQUAL(1U, metricGroup.GetExtraSourceBuffers().count(row.GetSourceBuffer()));
+
+    PipelineEventGroup spanGroup(std::make_shared<SourceBuffer>());
+    row.SetGroupTagsNoCopy(spanGroup, &DataTableSchema::ColSpanKey);
+    APSARA_TEST_EQUAL(spanGroup.GetTag(kWorkspace.SpanKey()), "ws");
+    APSARA_TEST_EQUAL(spanGroup.GetTag(kArmsServiceId.SpanKey()), "sid");
+}
+
 // 注册新增的测试用例
 UNIT_TEST_CASE(TableUnittest, TestProcessTable);
 UNIT_TEST_CASE(TableUnittest, TestNetTable);
 UNIT_TEST_CASE(TableUnittest, TestCompileOperations);
+UNIT_TEST_CASE(TableUnittest, TestSetGroupTagsNoCopy);
 
 
 } // namespace ebpf
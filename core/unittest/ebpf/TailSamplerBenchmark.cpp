@@ -0,0 +1,73 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ebpf/util/TraceId.h"
+#include "ebpf/util/sampler/TailSampler.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+namespace ebpf {
+
+class TailSamplerBenchmark : public testing::Test {
+public:
+    void TestReplay();
+};
+
+void TailSamplerBenchmark::TestReplay() {
+    TailSamplerOptions opt;
+    opt.mSpansPerSecBudget = 5000;
+    TailSampler<int> sampler(opt);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> service(0, 49);
+    std::uniform_real_distribution<double> ratio(0, 1);
+    std::vector<int> kept;
+    kept.reserve(1000000);
+
+    // replay 100s of traffic at 10k spans/s over 50 services, 1% errors and 1% slow spans
+    const int total = 1000000;
+    size_t maxBuffered = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < total; ++i) {
+        int64_t now = 1 + i / 10;
+        double r = ratio(gen);
+        sampler.Offer(GenerateTraceID(), service(gen), r < 0.01 ? 1000 : 1, r > 0.99, int(i), now, kept);
+        if (i % 1000 == 0) {
+            sampler.Flush(now, kept);
+            maxBuffered = std::max(maxBuffered, sampler.BufferedSpans());
+        }
+    }
+    sampler.FlushAll(total / 10 + 1, kept);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    double keptRatio = double(sampler.KeptSpans()) / double(total);
+    std::cout << "[TailSampler] replay elapsed: " << elapsed.count() << " seconds, spans/s: " << total / elapsed.count()
+              << ", kept ratio: " << keptRatio << ", max buffered spans: " << maxBuffered << std::endl;
+    APSARA_TEST_EQUAL(uint64_t(total), sampler.KeptSpans() + sampler.DroppedSpans());
+    // budget is 50% of the input, errors and slow spans take 2%
+    APSARA_TEST_TRUE(keptRatio > 0.4);
+    APSARA_TEST_TRUE(keptRatio < 0.65);
+}
+
+UNIT_TEST_CASE(TailSamplerBenchmark, TestReplay);
+
+} // namespace ebpf
+} // namespace logtail
+
+UNIT_TEST_MAIN
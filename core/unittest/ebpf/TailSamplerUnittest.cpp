@@ -0,0 +1,140 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <vector>
+
+#include "ebpf/util/TraceId.h"
+#include "ebpf/util/sampler/TailSampler.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+namespace ebpf {
+
+class TailSamplerUnittest : public testing::Test {
+public:
+    void TestDecisionWindow();
+    void TestKeepErrorAndSlow();
+    void TestMemoryBound();
+    void TestAdaptiveRate();
+};
+
+void TailSamplerUnittest::TestDecisionWindow() {
+    TailSamplerOptions opt;
+    opt.mDecisionWaitMs = 1000;
+    TailSampler<int> sampler(opt);
+    std::vector<int> kept;
+    auto traceId = GenerateTraceID();
+    sampler.Offer(traceId, 1, 10, false, 1, 1000, kept);
+    sampler.Offer(traceId, 1, 20, false, 2, 1500, kept);
+    APSARA_TEST_EQUAL(2UL, sampler.BufferedSpans());
+    APSARA_TEST_EQUAL(1UL, sampler.BufferedTraces());
+
+    sampler.Flush(1999, kept);
+    APSARA_TEST_EQUAL(2UL, sampler.BufferedSpans());
+    APSARA_TEST_TRUE(kept.empty());
+
+    // initial rate is 1, so the whole trace is kept
+    sampler.Flush(2000, kept);
+    APSARA_TEST_EQUAL(0UL, sampler.BufferedSpans());
+    APSARA_TEST_EQUAL(2UL, kept.size());
+    APSARA_TEST_EQUAL(2UL, sampler.KeptSpans());
+}
+
+void TailSamplerUnittest::TestKeepErrorAndSlow() {
+    TailSamplerOptions opt;
+    opt.mDecisionWaitMs = 0;
+    opt.mSpansPerSecBudget = 0;
+    opt.mSlowThresholdMs = 500;
+    opt.mMinSampleRate = 0;
+    TailSampler<int> sampler(opt);
+    std::vector<int> kept;
+    int64_t now = 1;
+    // drive the normal rate of the service down to 0
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            sampler.Offer(GenerateTraceID(), 1, 1, false, 0, now, kept);
+        }
+        now += opt.mRateAdjustIntervalMs;
+        sampler.Flush(now, kept);
+    }
+    APSARA_TEST_TRUE(sampler.ServiceSampleRate(1) < 0.001);
+
+    kept.clear();
+    for (int i = 0; i < 100; ++i) {
+        sampler.Offer(GenerateTraceID(), 1, 1, true, 1, now, kept);
+        sampler.Offer(GenerateTraceID(), 1, 600, false, 2, now, kept);
+        sampler.Offer(GenerateTraceID(), 1, 1, false, 3, now, kept);
+    }
+    sampler.Flush(now, kept);
+    size_t errors = std::count(kept.begin(), kept.end(), 1);
+    size_t slows = std::count(kept.begin(), kept.end(), 2);
+    size_t normals = std::count(kept.begin(), kept.end(), 3);
+    APSARA_TEST_EQUAL(100UL, errors);
+    APSARA_TEST_EQUAL(100UL, slows);
+    APSARA_TEST_TRUE(normals < 5UL);
+}
+
+void TailSamplerUnittest::TestMemoryBound() {
+    TailSamplerOptions opt;
+    opt.mDecisionWaitMs = 10000;
+    opt.mMaxBufferedSpans = 10;
+    TailSampler<int> sampler(opt);
+    std::vector<int> kept;
+    for (int i = 0; i < 100; ++i) {
+        sampler.Offer(GenerateTraceID(), 1, 1, false, int(i), 1, kept);
+        APSARA_TEST_TRUE(sampler.BufferedSpans() <= 10UL);
+    }
+    // oldest traces are decided first
+    APSARA_TEST_EQUAL(90UL, kept.size());
+    APSARA_TEST_EQUAL(0, kept.front());
+    APSARA_TEST_EQUAL(10UL, sampler.BufferedTraces());
+    sampler.FlushAll(2, kept);
+    APSARA_TEST_EQUAL(0UL, sampler.BufferedSpans());
+    APSARA_TEST_EQUAL(100UL, kept.size());
+}
+
+void TailSamplerUnittest::TestAdaptiveRate() {
+    TailSamplerOptions opt;
+    opt.mDecisionWaitMs = 0;
+    opt.mSpansPerSecBudget = 110;
+    TailSampler<int> sampler(opt);
+    std::vector<int> kept;
+    int64_t now = 1;
+    // heavy service sends 1000 spans/s, light one sends 10 spans/s
+    for (int round = 0; round < 30; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            sampler.Offer(GenerateTraceID(), 1, 1, false, 0, now, kept);
+        }
+        for (int i = 0; i < 10; ++i) {
+            sampler.Offer(GenerateTraceID(), 2, 1, false, 0, now, kept);
+        }
+        now += opt.mRateAdjustIntervalMs;
+        sampler.Flush(now, kept);
+    }
+    APSARA_TEST_EQUAL(2UL, sampler.ServiceCount());
+    APSARA_TEST_TRUE(sampler.ServiceSampleRate(2) > 0.99);
+    APSARA_TEST_TRUE(sampler.ServiceSampleRate(1) > 0.09);
+    APSARA_TEST_TRUE(sampler.ServiceSampleRate(1) < 0.11);
+}
+
+UNIT_TEST_CASE(TailSamplerUnittest, TestDecisionWindow);
+UNIT_TEST_CASE(TailSamplerUnittest, TestKeepErrorAndSlow);
+UNIT_TEST_CASE(TailSamplerUnittest, TestMemoryBound);
+UNIT_TEST_CASE(TailSamplerUnittest, TestAdaptiveRate);
+
+} // namespace ebpf
+} // namespace logtail
+
+UNIT_TEST_MAIN
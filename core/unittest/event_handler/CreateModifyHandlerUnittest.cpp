@@ -43,18 +43,23 @@ public:
         : ModifyHandler(configName, pConfig) {}
     virtual void Handle(const Event& event) { ++handle_count; }
     virtual void HandleTimeOut() { ++handle_timeout_count; }
-    virtual bool DumpReaderMeta(bool isRotatorReader, bool checkConfigFlag) { return true; }
+    virtual bool DumpReaderMeta(bool isRotatorReader, bool checkConfigFlag) {
+        ++dump_count;
+        return true;
+    }
     void Reset() {
         handle_count = 0;
         handle_timeout_count = 0;
     }
     int handle_count = 0;
     int handle_timeout_count = 0;
+    int dump_count = 0;
 };
 
 class CreateModifyHandlerUnittest : public ::testing::Test {
 public:
     void TestHandleContainerStoppedEvent();
+    void TestDetachModifyHandlers();
 
 protected:
     static void SetUpTestCase() {
@@ -197,10 +202,36 @@ void CreateModifyHandlerUnittest::TestHandleContainerStoppedEvent() {
     APSARA_TEST_EQUAL_FATAL(pHanlder->handle_count, 2);
 }
 
+void CreateModifyHandlerUnittest::TestDetachModifyHandlers() {
+    CreateModifyHandler createModifyHandler(&mCreateHandler);
+    const std::string otherConfigName = "##1.0##project-0$config-1";
+    // released by ConfigManager::DeleteHandlers after detached
+    MockModifyHandler* pHandler = new MockModifyHandler(mConfigName, mConfig);
+    // released by ~CreateModifyHandler
+    MockModifyHandler* pOtherHandler = new MockModifyHandler(otherConfigName, mConfig);
+    createModifyHandler.mModifyHandlerPtrMap.insert(std::make_pair(mConfigName, pHandler));
+    createModifyHandler.mModifyHandlerPtrMap.insert(std::make_pair(otherConfigName, pOtherHandler));
+
+    APSARA_TEST_FALSE(createModifyHandler.DetachModifyHandlers({"not_exist"}));
+    APSARA_TEST_EQUAL(2U, createModifyHandler.mModifyHandlerPtrMap.size());
+
+    APSARA_TEST_TRUE(createModifyHandler.DetachModifyHandlers({mConfigName}));
+    // both rotator and normal readers are dumped
+    APSARA_TEST_EQUAL(2, pHandler->dump_count);
+    APSARA_TEST_EQUAL(0, pOtherHandler->dump_count);
+    APSARA_TEST_EQUAL(1U, createModifyHandler.mModifyHandlerPtrMap.size());
+    APSARA_TEST_TRUE(createModifyHandler.mModifyHandlerPtrMap.find(otherConfigName)
+                     != createModifyHandler.mModifyHandlerPtrMap.end());
+    APSARA_TEST_TRUE(createModifyHandler.HasModifyHandler());
+    APSARA_TEST_FALSE(createModifyHandler.DetachModifyHandlers({mConfigName}));
+    ConfigManager::GetInstance()->DeleteHandlers();
+}
+
 std::string CreateModifyHandlerUnittest::gRootDir;
 std::string CreateModifyHandlerUnittest::gLogName;
 
 UNIT_TEST_CASE(CreateModifyHandlerUnittest, TestHandleContainerStoppedEvent);
+UNIT_TEST_CASE(CreateModifyHandlerUnittest, TestDetachModifyHandlers);
 } // end of namespace logtail
 
 int main(int argc, char** argv) {
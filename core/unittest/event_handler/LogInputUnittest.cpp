@@ -16,18 +16,23 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <filesystem>
+#include <fstream>
 #include <memory>
 #include <string>
 
 #include "common/FileSystemUtil.h"
 #include "common/Flags.h"
+#include "file_server/EventDispatcher.h"
 #include "file_server/event/Event.h"
 #include "file_server/event_handler/LogInput.h"
+#include "file_server/event_listener/EventListener.h"
 #include "file_server/polling/PollingEventQueue.h"
 #include "unittest/Unittest.h"
 using namespace std;
 
 DECLARE_FLAG_STRING(ilogtail_config);
+DECLARE_FLAG_INT32(max_inotify_event_queue_size);
 
 namespace logtail {
 class LogInputUnittest : public ::testing::Test {
@@ -37,6 +42,7 @@ protected:
         LogInput::GetInstance()->mModifyEventSet.clear();
         std::queue<Event*> empty;
         std::swap(LogInput::GetInstance()->mInotifyEventQueue, empty);
+        LogInput::GetInstance()->mInotifyReadBlocked = false;
     }
 
 public:
@@ -64,10 +70,72 @@ public:
         Event* ev = LogInput::GetInstance()->PopEventQueue();
         delete ev;
     }
+
+    void TestEventQueueBound() {
+        LOG_INFO(sLogger, ("TestEventQueueBound() begin", time(NULL)));
+        int32_t maxQueueSize = INT32_FLAG(max_inotify_event_queue_size);
+        INT32_FLAG(max_inotify_event_queue_size) = 2;
+        for (int i = 0; i < 3; ++i) {
+            PollingEventQueue::GetInstance()->PushEvent(new Event("/source", "object" + to_string(i), EVENT_CREATE, 0));
+        }
+        LogInput::GetInstance()->TryReadEvents(true);
+        APSARA_TEST_EQUAL_FATAL(LogInput::GetInstance()->mInotifyEventQueue.size(), 3L);
+        LogInput::GetInstance()->TryReadEvents(true);
+        APSARA_TEST_TRUE(LogInput::GetInstance()->mInotifyReadBlocked);
+
+        for (int i = 0; i < 2; ++i) {
+            delete LogInput::GetInstance()->PopEventQueue();
+        }
+        LogInput::GetInstance()->TryReadEvents(true);
+        APSARA_TEST_FALSE(LogInput::GetInstance()->mInotifyReadBlocked);
+        INT32_FLAG(max_inotify_event_queue_size) = maxQueueSize;
+    }
+
+#if defined(__linux__)
+    void TestInotifyModifyCoalescing() {
+        LOG_INFO(sLogger, ("TestInotifyModifyCoalescing() begin", time(NULL)));
+        filesystem::path dir = filesystem::temp_directory_path() / "log_input_unittest_coalescing";
+        filesystem::remove_all(dir);
+        filesystem::create_directories(dir);
+        {
+            ofstream(dir / "a.log");
+            ofstream(dir / "b.log");
+        }
+        EventDispatcher::GetInstance();
+        EventListener* listener = EventListener::GetInstance();
+        if (!listener->IsInit()) {
+            APSARA_TEST_TRUE_FATAL(listener->Init());
+        }
+        int wd = listener->AddWatch(dir.string().c_str());
+        APSARA_TEST_TRUE_FATAL(EventListener::IsValidID(wd));
+
+        // interleaved writes, which the kernel does not merge
+        ofstream a(dir / "a.log", ios::app);
+        ofstream b(dir / "b.log", ios::app);
+        for (int i = 0; i < 50; ++i) {
+            a << "line" << endl;
+            b << "line" << endl;
+        }
+        vector<Event*> events;
+        int32_t coalescedCount = 0;
+        listener->ReadEvents(events, coalescedCount);
+        APSARA_TEST_EQUAL(98, coalescedCount);
+        for (auto* ev : events) {
+            delete ev;
+        }
+
+        listener->RemoveWatch(wd);
+        filesystem::remove_all(dir);
+    }
+#endif
 };
 
 APSARA_UNIT_TEST_CASE(LogInputUnittest, TestTryReadEventsPollingEvents, 0);
 APSARA_UNIT_TEST_CASE(LogInputUnittest, TestTryReadEventsDuplicatedEvents, 0);
+APSARA_UNIT_TEST_CASE(LogInputUnittest, TestEventQueueBound, 0);
+#if defined(__linux__)
+APSARA_UNIT_TEST_CASE(LogInputUnittest, TestInotifyModifyCoalescing, 0);
+#endif
 } // end of namespace logtail
 
 int main(int argc, char** argv) {
@@ -0,0 +1,184 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/FileSystemUtil.h"
+#include "common/RuntimeUtil.h"
+#include "plugin/flusher/file/BufferedFileWriter.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class BufferedFileWriterUnittest : public ::testing::Test {
+public:
+    void TestRotateOnStart();
+    void TestFlushBySize();
+    void TestFlushByInterval();
+    void TestFlush();
+    void TestRotate();
+    void TestLineExceedingMaxFileSize();
+    void TestConcurrentWrite();
+    void TestGetRotatedFileName();
+
+protected:
+    void SetUp() override {
+        mDir = filesystem::path(GetProcessExecutionDir()) / "BufferedFileWriterUnittestDir";
+        filesystem::remove_all(mDir);
+        mFilePath = (mDir / "test.log").string();
+    }
+
+    void TearDown() override { filesystem::remove_all(mDir); }
+
+private:
+    string ReadContent(const string& path) {
+        string content;
+        ReadFile(path, content);
+        return content;
+    }
+
+    filesystem::path mDir;
+    string mFilePath;
+};
+
+void BufferedFileWriterUnittest::TestRotateOnStart() {
+    filesystem::create_directories(mDir);
+    OverwriteFile(mFilePath, "old\n");
+    BufferedFileWriter writer(mFilePath, 1024, 2, 1024, 1000, 0);
+    string errorMsg;
+    APSARA_TEST_TRUE(writer.Start(errorMsg));
+    APSARA_TEST_EQUAL("old\n", ReadContent((mDir / "test.1.log").string()));
+    APSARA_TEST_EQUAL("", ReadContent(mFilePath));
+    writer.Stop();
+}
+
+void BufferedFileWriterUnittest::TestFlushBySize() {
+    BufferedFileWriter writer(mFilePath, 1024, 2, 16, 60000, 0);
+    string errorMsg;
+    APSARA_TEST_TRUE(writer.Start(errorMsg));
+    writer.Write("short");
+    this_thread::sleep_for(chrono::milliseconds(100));
+    APSARA_TEST_EQUAL("", ReadContent(mFilePath));
+    writer.Write("long enough line");
+    this_thread::sleep_for(chrono::milliseconds(100));
+    APSARA_TEST_EQUAL("short\nlong enough line\n", ReadContent(mFilePath));
+    writer.Stop();
+}
+
+void BufferedFileWriterUnittest::TestFlushByInterval() {
+    BufferedFileWriter writer(mFilePath, 1024, 2, 1024, 50, 1);
+    string errorMsg;
+    APSARA_TEST_TRUE(writer.Start(errorMsg));
+    writer.Write("line");
+    this_thread::sleep_for(chrono::milliseconds(200));
+    APSARA_TEST_EQUAL("line\n", ReadContent(mFilePath));
+    writer.Stop();
+    APSARA_TEST_FALSE(writer.mHasUnsyncedData);
+}
+
+void BufferedFileWriterUnittest::TestFlush() {
+    BufferedFileWriter writer(mFilePath, 1024, 2, 1024, 60000, 0);
+    string errorMsg;
+    APSARA_TEST_TRUE(writer.Start(errorMsg));
+    writer.Write("line1");
+    writer.Flush();
+    this_thread::sleep_for(chrono::milliseconds(100));
+    APSARA_TEST_EQUAL("line1\n", ReadContent(mFilePath));
+
+    writer.Write("line2");
+    writer.Stop();
+    APSARA_TEST_EQUAL("line1\nline2\n", ReadContent(mFilePath));
+    // discarded after stopped
+    writer.Write("line3");
+    APSARA_TEST_EQUAL("line1\nline2\n", ReadContent(mFilePath));
+}
+
+void BufferedFileWriterUnittest::TestRotate() {
+    // each line is 10 bytes, and at most 3 lines fit into a file
+    BufferedFileWriter writer(mFilePath, 35, 2, 1024, 60000, 0);
+    string errorMsg;
+    APSARA_TEST_TRUE(writer.Start(errorMsg));
+    for (char c = 'a'; c < 'h'; ++c) {
+        writer.Write(string(9, c));
+    }
+    writer.Stop();
+    APSARA_TEST_EQUAL("aaaaaaaaa\nbbbbbbbbb\nccccccccc\n", ReadContent((mDir / "test.2.log").string()));
+    APSARA_TEST_EQUAL("ddddddddd\neeeeeeeee\nfffffffff\n", ReadContent((mDir / "test.1.log").string()));
+    APSARA_TEST_EQUAL("ggggggggg\n", ReadContent(mFilePath));
+
+    // the oldest file is removed
+    BufferedFileWriter writer2(mFilePath, 35, 2, 1024, 60000, 0);
+    APSARA_TEST_TRUE(writer2.Start(errorMsg));
+    writer2.Stop();
+    APSARA_TEST_EQUAL("ddddddddd\neeeeeeeee\nfffffffff\n", ReadContent((mDir / "test.2.log").string()));
+    APSARA_TEST_EQUAL("ggggggggg\n", ReadContent((mDir / "test.1.log").string()));
+    APSARA_TEST_FALSE(filesystem::exists(mDir / "test.3.log"));
+}
+
+void BufferedFileWriterUnittest::TestLineExceedingMaxFileSize() {
+    BufferedFileWriter writer(mFilePath, 10, 1, 1024, 60000, 0);
+    string errorMsg;
+    APSARA_TEST_TRUE(writer.Start(errorMsg));
+    writer.Write("a");
+    writer.Write(string(20, 'b'));
+    writer.Stop();
+    APSARA_TEST_EQUAL("a\n", ReadContent((mDir / "test.1.log").string()));
+    APSARA_TEST_EQUAL(string(20, 'b') + "\n", ReadContent(mFilePath));
+}
+
+void BufferedFileWriterUnittest::TestConcurrentWrite() {
+    BufferedFileWriter writer(mFilePath, 1024 * 1024 * 1024, 1, 4096, 10, 0);
+    string errorMsg;
+    APSARA_TEST_TRUE(writer.Start(errorMsg));
+    vector<thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&writer]() {
+            for (size_t j = 0; j < 10000; ++j) {
+                writer.Write("hello world");
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    writer.Stop();
+    APSARA_TEST_EQUAL(4U * 10000U * 12U, ReadContent(mFilePath).size());
+}
+
+void BufferedFileWriterUnittest::TestGetRotatedFileName() {
+    APSARA_TEST_EQUAL("/dir/test.log", BufferedFileWriter("/dir/test.log", 1, 1, 1, 1, 0).GetRotatedFileName(0));
+    APSARA_TEST_EQUAL("/dir/test.3.log", BufferedFileWriter("/dir/test.log", 1, 1, 1, 1, 0).GetRotatedFileName(3));
+    APSARA_TEST_EQUAL("/dir/test.1", BufferedFileWriter("/dir/test", 1, 1, 1, 1, 0).GetRotatedFileName(1));
+    APSARA_TEST_EQUAL("/dir/.test.1", BufferedFileWriter("/dir/.test", 1, 1, 1, 1, 0).GetRotatedFileName(1));
+    APSARA_TEST_EQUAL("/dir.d/test.1", BufferedFileWriter("/dir.d/test", 1, 1, 1, 1, 0).GetRotatedFileName(1));
+    APSARA_TEST_EQUAL("test..1", BufferedFileWriter("test.", 1, 1, 1, 1, 0).GetRotatedFileName(1));
+}
+
+UNIT_TEST_CASE(BufferedFileWriterUnittest, TestRotateOnStart)
+UNIT_TEST_CASE(BufferedFileWriterUnittest, TestFlushBySize)
+UNIT_TEST_CASE(BufferedFileWriterUnittest, TestFlushByInterval)
+UNIT_TEST_CASE(BufferedFileWriterUnittest, TestFlush)
+UNIT_TEST_CASE(BufferedFileWriterUnittest, TestRotate)
+UNIT_TEST_CASE(BufferedFileWriterUnittest, TestLineExceedingMaxFileSize)
+UNIT_TEST_CASE(BufferedFileWriterUnittest, TestConcurrentWrite)
+UNIT_TEST_CASE(BufferedFileWriterUnittest, TestGetRotatedFileName)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,186 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include <filesystem>
+#include <string>
+
+#include "common/FileSystemUtil.h"
+#include "common/RuntimeUtil.h"
+#include "plugin/flusher/sls/DiskBufferSegment.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class DiskBufferSegmentUnittest : public ::testing::Test {
+public:
+    void TestLoad();
+    void TestLoadTruncated();
+    void TestAck();
+    void TestRemove();
+
+protected:
+    void SetUp() override {
+        mDir = filesystem::path(GetProcessExecutionDir()) / "DiskBufferSegmentUnittestDir";
+        filesystem::remove_all(mDir);
+        filesystem::create_directories(mDir);
+        mFilePath = (mDir / "logtail_buffer_file_1").string();
+    }
+
+    void TearDown() override { filesystem::remove_all(mDir); }
+
+private:
+    static constexpr size_t kHeaderSize = 16;
+
+    static void AppendRecord(string& content, const string& encodedInfo, const string& encryption, bool pbMeta) {
+        EncryptionStateMeta meta{};
+        meta.mLogDataSize = encryption.size();
+        meta.mEncryptionSize = encryption.size();
+        meta.mEncodedInfoSize = encodedInfo.size() + (pbMeta ? DiskBufferSegment::BUFFER_META_BASE_SIZE : 0);
+        meta.mTimeStamp = 1700000000;
+        content.append(reinterpret_cast<const char*>(&meta), sizeof(meta)).append(encodedInfo).append(encryption);
+    }
+
+    filesystem::path mDir;
+    string mFilePath;
+};
+
+void DiskBufferSegmentUnittest::TestLoad() {
+    string content(kHeaderSize, 'h');
+    AppendRecord(content, "meta1", "data1", true);
+    AppendRecord(content, "project", "data22", false);
+    OverwriteFile(mFilePath, content);
+
+    DiskBufferSegment segment(mFilePath);
+    string errorMsg;
+    APSARA_TEST_TRUE(segment.Load(kHeaderSize, errorMsg));
+    APSARA_TEST_FALSE(segment.HasTruncatedTail());
+    const auto& records = segment.GetRecords();
+    APSARA_TEST_EQUAL(2U, records.size());
+
+    APSARA_TEST_EQUAL(kHeaderSize, records[0].mOffset);
+    APSARA_TEST_TRUE(records[0].mPbMeta);
+    APSARA_TEST_EQUAL("meta1", segment.GetEncodedInfo(records[0]));
+    APSARA_TEST_EQUAL("data1", string(segment.GetEncryption(records[0]), records[0].mMeta.mEncryptionSize));
+
+    APSARA_TEST_EQUAL(kHeaderSize + sizeof(EncryptionStateMeta) + 10, records[1].mOffset);
+    APSARA_TEST_FALSE(records[1].mPbMeta);
+    APSARA_TEST_EQUAL("project", segment.GetEncodedInfo(records[1]));
+    APSARA_TEST_EQUAL("data22", string(segment.GetEncryption(records[1]), records[1].mMeta.mEncryptionSize));
+
+    // empty segment
+    OverwriteFile(mFilePath, string(kHeaderSize, 'h'));
+    APSARA_TEST_TRUE(segment.Load(kHeaderSize, errorMsg));
+    APSARA_TEST_TRUE(segment.GetRecords().empty());
+    APSARA_TEST_FALSE(segment.HasTruncatedTail());
+
+    // not existing
+    DiskBufferSegment notExisting((mDir / "not_existing").string());
+    APSARA_TEST_FALSE(notExisting.Load(kHeaderSize, errorMsg));
+}
+
+void DiskBufferSegmentUnittest::TestLoadTruncated() {
+    string content(kHeaderSize, 'h');
+    AppendRecord(content, "meta1", "data1", true);
+    AppendRecord(content, "meta2", "data2", true);
+    DiskBufferSegment segment(mFilePath);
+    string errorMsg;
+
+    // incomplete data
+    OverwriteFile(mFilePath, content.substr(0, content.size() - 1));
+    APSARA_TEST_TRUE(segment.Load(kHeaderSize, errorMsg));
+    APSARA_TEST_TRUE(segment.HasTruncatedTail());
+    APSARA_TEST_EQUAL(1U, segment.GetRecords().size());
+
+    // incomplete meta
+    OverwriteFile(mFilePath, content.substr(0, kHeaderSize + sizeof(EncryptionStateMeta) + 10 + 3));
+    APSARA_TEST_TRUE(segment.Load(kHeaderSize, errorMsg));
+    APSARA_TEST_TRUE(segment.HasTruncatedTail());
+    APSARA_TEST_EQUAL(1U, segment.GetRecords().size());
+
+    // invalid meta
+    string invalid = content;
+    int32_t size = -1;
+    memcpy(invalid.data() + kHeaderSize + sizeof(EncryptionStateMeta) + 10 + 4, &size, sizeof(size));
+    OverwriteFile(mFilePath, invalid);
+    APSARA_TEST_TRUE(segment.Load(kHeaderSize, errorMsg));
+    APSARA_TEST_TRUE(segment.HasTruncatedTail());
+    APSARA_TEST_EQUAL(1U, segment.GetRecords().size());
+}
+
+void DiskBufferSegmentUnittest::TestAck() {
+    string content(kHeaderSize, 'h');
+    AppendRecord(content, "meta1", "data1", true);
+    AppendRecord(content, "meta2", "data2", true);
+    AppendRecord(content, "meta3", "data3", true);
+    // handled by older versions
+    reinterpret_cast<EncryptionStateMeta*>(content.data() + kHeaderSize)->mHandled = 1;
+    OverwriteFile(mFilePath, content);
+
+    string errorMsg;
+    {
+        DiskBufferSegment segment(mFilePath);
+        APSARA_TEST_TRUE(segment.Load(kHeaderSize, errorMsg));
+        const auto& records = segment.GetRecords();
+        APSARA_TEST_TRUE(segment.IsAcked(records[0]));
+        APSARA_TEST_FALSE(segment.IsAcked(records[1]));
+        APSARA_TEST_FALSE(segment.IsAcked(records[2]));
+        APSARA_TEST_TRUE(segment.Ack(records[2]));
+        APSARA_TEST_TRUE(segment.IsAcked(records[2]));
+    }
+    // the segment itself is not modified
+    string current;
+    ReadFile(mFilePath, current);
+    APSARA_TEST_EQUAL(content, current);
+    {
+        // partially written ack is ignored
+        FILE* f = fopen(DiskBufferSegment::GetAckFilePath(mFilePath).c_str(), "ab");
+        fwrite("abc", 1, 3, f);
+        fclose(f);
+
+        DiskBufferSegment segment(mFilePath);
+        APSARA_TEST_TRUE(segment.Load(kHeaderSize, errorMsg));
+        const auto& records = segment.GetRecords();
+        APSARA_TEST_TRUE(segment.IsAcked(records[0]));
+        APSARA_TEST_FALSE(segment.IsAcked(records[1]));
+        APSARA_TEST_TRUE(segment.IsAcked(records[2]));
+    }
+}
+
+void DiskBufferSegmentUnittest::TestRemove() {
+    string content(kHeaderSize, 'h');
+    AppendRecord(content, "meta1", "data1", true);
+    OverwriteFile(mFilePath, content);
+
+    DiskBufferSegment segment(mFilePath);
+    string errorMsg;
+    APSARA_TEST_TRUE(segment.Load(kHeaderSize, errorMsg));
+    APSARA_TEST_TRUE(segment.Ack(segment.GetRecords()[0]));
+    APSARA_TEST_TRUE(filesystem::exists(DiskBufferSegment::GetAckFilePath(mFilePath)));
+    segment.Remove();
+    APSARA_TEST_FALSE(filesystem::exists(mFilePath));
+    APSARA_TEST_FALSE(filesystem::exists(DiskBufferSegment::GetAckFilePath(mFilePath)));
+}
+
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestLoad)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestLoadTruncated)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestAck)
+UNIT_TEST_CASE(DiskBufferSegmentUnittest, TestRemove)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
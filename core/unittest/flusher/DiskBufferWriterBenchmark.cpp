@@ -0,0 +1,160 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef APSARA_UNIT_TEST_MAIN
+#define APSARA_UNIT_TEST_MAIN
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "Flags.h"
+#include "collection_pipeline/queue/SLSSenderQueueItem.h"
+#include "common/FileEncryption.h"
+#include "plugin/flusher/sls/DiskBufferSegment.h"
+#include "plugin/flusher/sls/DiskBufferWriter.h"
+#include "plugin/flusher/sls/FlusherSLS.h"
+#include "protobuf/sls/logtail_buffer_meta.pb.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(file_encryption_header_length);
+
+using namespace std;
+
+namespace logtail {
+
+// Measures the throughput of writing sender queue items to buffer files, and that of replaying buffer files, i.e.
+// reading, indexing and decrypting the records without sending them, with one thread and with several threads each
+// replaying different buffer files. Files are written to /dev/shm so that the disk itself is not measured.
+class DiskBufferWriterBenchmark : public ::testing::Test {
+public:
+    void TestWriteAndReplay();
+
+protected:
+    void SetUp() override {
+        filesystem::remove_all(kDir);
+        filesystem::create_directories(kDir);
+        mFlusher.mProject = "test_project";
+        mFlusher.mLogstore = "test_logstore";
+        mFlusher.mAliuid = "123456789";
+    }
+
+    void TearDown() override { filesystem::remove_all(kDir); }
+
+private:
+    double Write(vector<string>& fileNames);
+    double Replay(const vector<string>& fileNames, size_t concurrency, size_t& recordCnt);
+
+    static constexpr const char* kDir = "/dev/shm/disk_buffer_writer_benchmark";
+    static const size_t kSegmentCnt = 16;
+    static const size_t kRecordCntPerSegment = 1000;
+    static const size_t kRecordSize = 16 * 1024;
+
+    FlusherSLS mFlusher;
+};
+
+double DiskBufferWriterBenchmark::Write(vector<string>& fileNames) {
+    auto writer = DiskBufferWriter::GetInstance();
+    writer->SetBufferFilePath(kDir);
+    string data(kRecordSize, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 31 + i / 7);
+    }
+    vector<SLSSenderQueueItem> items;
+    items.reserve(kRecordCntPerSegment);
+    for (size_t i = 0; i < kRecordCntPerSegment; ++i) {
+        items.emplace_back(string(data), data.size() * 4, &mFlusher, 0, mFlusher.mLogstore);
+    }
+
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < kSegmentCnt; ++i) {
+        // buffer files are named by the time created, which is the same within a second
+        fileNames.emplace_back(writer->GetBufferFilePath() + "logtail_buffer_file_" + to_string(i));
+        writer->CloseBufferFile();
+        writer->SetBufferFileName(fileNames.back());
+        for (auto& item : items) {
+            APSARA_TEST_TRUE(writer->SendToBufferFile(&item));
+        }
+    }
+    writer->CloseBufferFile();
+    return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+}
+
+double DiskBufferWriterBenchmark::Replay(const vector<string>& fileNames, size_t concurrency, size_t& recordCnt) {
+    auto writer = DiskBufferWriter::GetInstance();
+    atomic_size_t next = 0;
+    atomic_size_t cnt = 0;
+    auto replay = [&]() {
+        for (size_t i = next++; i < fileNames.size(); i = next++) {
+            DiskBufferSegment segment(fileNames[i]);
+            string errorMsg;
+            if (!segment.Load(INT32_FLAG(file_encryption_header_length), errorMsg)) {
+                continue;
+            }
+            for (const auto& record : segment.GetRecords()) {
+                sls_logs::LogtailBufferMeta bufferMeta;
+                string logData(record.mMeta.mLogDataSize, '\0');
+                if (writer->ReadBufferMeta(fileNames[i], segment, record, bufferMeta)
+                    && FileEncryption::GetInstance()->Decrypt(segment.GetEncryption(record),
+                                                              record.mMeta.mEncryptionSize,
+                                                              logData.data(),
+                                                              record.mMeta.mLogDataSize,
+                                                              FileEncryption::GetInstance()->GetDefaultKeyVersion())) {
+                    ++cnt;
+                }
+            }
+        }
+    };
+    auto start = chrono::high_resolution_clock::now();
+    vector<future<void>> res;
+    for (size_t i = 1; i < concurrency; ++i) {
+        res.emplace_back(async(launch::async, replay));
+    }
+    replay();
+    for (auto& r : res) {
+        r.get();
+    }
+    recordCnt = cnt;
+    return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+}
+
+void DiskBufferWriterBenchmark::TestWriteAndReplay() {
+    vector<string> fileNames;
+    double writeElapsed = Write(fileNames);
+    size_t bytes = 0;
+    for (const auto& fileName : fileNames) {
+        bytes += filesystem::file_size(fileName);
+    }
+    size_t recordCnt = kSegmentCnt * kRecordCntPerSegment;
+    cout << "write: " << recordCnt / writeElapsed << " records/s, " << bytes / writeElapsed / 1024 / 1024 << " MB/s"
+         << endl;
+
+    for (size_t concurrency : {1, 4}) {
+        size_t replayedCnt = 0;
+        double replayElapsed = Replay(fileNames, concurrency, replayedCnt);
+        APSARA_TEST_EQUAL(recordCnt, replayedCnt);
+        cout << "replay with " << concurrency << " thread(s): " << recordCnt / replayElapsed << " records/s, "
+             << bytes / replayElapsed / 1024 / 1024 << " MB/s" << endl;
+    }
+}
+
+UNIT_TEST_CASE(DiskBufferWriterBenchmark, TestWriteAndReplay)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef APSARA_UNIT_TEST_MAIN
+#define APSARA_UNIT_TEST_MAIN
+#endif
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "collection_pipeline/CollectionPipeline.h"
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "models/PipelineEventGroup.h"
+#include "plugin/flusher/file/FlusherFile.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Compares the throughput of FlusherFile writing through spdlog, which makes a write for each group, and writing
+// through BufferedFileWriter. Files are written to /dev/shm so that the sink itself rather than the disk is measured.
+class FlusherFileBenchmark : public ::testing::Test {
+public:
+    void TestWrite();
+
+protected:
+    void SetUp() override {
+        mContext.SetConfigName("test_config");
+        mContext.SetPipeline(mPipeline);
+        filesystem::remove_all(kDir);
+        filesystem::create_directories(kDir);
+    }
+
+    void TearDown() override {
+        filesystem::remove_all(kDir);
+        SenderQueueManager::GetInstance()->Clear();
+    }
+
+private:
+    PipelineEventGroup CreateGroup();
+    double Write(bool enableBufferedWrite, const string& fileName);
+
+    static constexpr const char* kDir = "/dev/shm/flusher_file_benchmark";
+    static const size_t kGroupCnt = 20000;
+    static const size_t kEventCntPerGroup = 100;
+
+    CollectionPipeline mPipeline;
+    CollectionPipelineContext mContext;
+};
+
+PipelineEventGroup FlusherFileBenchmark::CreateGroup() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(string("host.name"), string("host-1"));
+    for (size_t i = 0; i < kEventCntPerGroup; ++i) {
+        auto* event = group.AddLogEvent();
+        event->SetTimestamp(1700000000);
+        event->SetContent(string("content"), "GET /api/v1/orders?id=" + to_string(i) + " 200 12ms");
+        event->SetContent(string("method"), string("GET"));
+        event->SetContent(string("status"), string("200"));
+    }
+    return group;
+}
+
+double FlusherFileBenchmark::Write(bool enableBufferedWrite, const string& fileName) {
+    Json::Value config, optionalGoPipeline;
+    config["FilePath"] = string(kDir) + "/" + fileName;
+    config["MaxFileSize"] = 1024 * 1024 * 1024;
+    config["MaxFiles"] = 2;
+    config["EnableBufferedWrite"] = enableBufferedWrite;
+    FlusherFile flusher;
+    flusher.SetContext(mContext);
+    flusher.CreateMetricsRecordRef(FlusherFile::sName, "1");
+    APSARA_TEST_TRUE(flusher.Init(config, optionalGoPipeline));
+    flusher.CommitMetricsRecordRef();
+
+    vector<PipelineEventGroup> groups;
+    groups.reserve(kGroupCnt);
+    for (size_t i = 0; i < kGroupCnt; ++i) {
+        groups.emplace_back(CreateGroup());
+    }
+    auto start = chrono::high_resolution_clock::now();
+    for (auto& group : groups) {
+        flusher.Send(std::move(group));
+    }
+    flusher.Stop(true);
+    return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+}
+
+void FlusherFileBenchmark::TestWrite() {
+    double spdlogElapsed = Write(false, "spdlog.log");
+    double bufferedElapsed = Write(true, "buffered.log");
+
+    size_t eventCnt = kGroupCnt * kEventCntPerGroup;
+    size_t bytes = filesystem::file_size(string(kDir) + "/buffered.log");
+    cout << "spdlog: " << kGroupCnt / spdlogElapsed << " groups/s, " << eventCnt / spdlogElapsed << " events/s, "
+         << bytes / spdlogElapsed / 1024 / 1024 << " MB/s" << endl;
+    cout << "buffered: " << kGroupCnt / bufferedElapsed << " groups/s, " << eventCnt / bufferedElapsed
+         << " events/s, " << bytes / bufferedElapsed / 1024 / 1024 << " MB/s" << endl;
+}
+
+UNIT_TEST_CASE(FlusherFileBenchmark, TestWrite)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
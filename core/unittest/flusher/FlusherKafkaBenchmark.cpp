@@ -0,0 +1,186 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef APSARA_UNIT_TEST_MAIN
+#define APSARA_UNIT_TEST_MAIN
+#endif
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/batch/BatchedEvents.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "collection_pipeline/serializer/JsonSerializer.h"
+#include "models/PipelineEventGroup.h"
+#include "plugin/flusher/kafka/FlusherKafka.h"
+#include "plugin/flusher/kafka/KafkaProducer.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Completes each message at once, copying its value as librdkafka does with RD_KAFKA_MSG_F_COPY.
+class CountingKafkaProducer : public KafkaProducer {
+public:
+    bool Init(const KafkaConfig& config) override { return true; }
+
+    void ProduceAsync(const std::string& topic,
+                      std::string&& value,
+                      Callback callback,
+                      const std::string& key = std::string()) override {
+        mCopy.assign(value.data(), value.size());
+        ++mMessageCnt;
+        callback(true, {ErrorType::SUCCESS, "", 0});
+    }
+
+    void ProduceBatchAsync(const std::string& topic,
+                           const std::shared_ptr<std::string>& payload,
+                           const std::vector<BatchMessage>& messages,
+                           BatchCallback callback) override {
+        for (size_t i = 0; i < messages.size(); ++i) {
+            ++mMessageCnt;
+            callback(i, true, {ErrorType::SUCCESS, "", 0});
+        }
+    }
+
+    bool Flush(int timeoutMs) override { return true; }
+    void Close() override {}
+
+    size_t mMessageCnt = 0;
+
+private:
+    std::string mCopy;
+};
+
+// Sends groups of log events through FlusherKafka to a producer completing messages at once, and the same events
+// the way FlusherKafka did before, serializing and producing each event on its own.
+class FlusherKafkaBenchmark : public ::testing::Test {
+public:
+    void TestSend_StaticTopic();
+    void TestSend_DynamicTopic();
+
+protected:
+    void SetUp() override {
+        mContext.SetConfigName("test_config");
+        mFlusher = make_unique<FlusherKafka>();
+        auto producer = make_unique<CountingKafkaProducer>();
+        mProducer = producer.get();
+        mFlusher->SetProducerForTest(std::move(producer));
+        mFlusher->SetContext(mContext);
+        mFlusher->CreateMetricsRecordRef(FlusherKafka::sName, "1");
+    }
+
+    void TearDown() override {
+        mFlusher->Stop(true);
+        mFlusher->CommitMetricsRecordRef();
+        SenderQueueManager::GetInstance()->Clear();
+    }
+
+private:
+    void TestSend(const string& topic);
+    PipelineEventGroup CreateGroup();
+    double SendPerEvent();
+
+    static const size_t kGroupCnt = 2000;
+    static const size_t kEventCntPerGroup = 100;
+
+    CollectionPipelineContext mContext;
+    unique_ptr<FlusherKafka> mFlusher;
+    CountingKafkaProducer* mProducer = nullptr;
+};
+
+PipelineEventGroup FlusherKafkaBenchmark::CreateGroup() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(string("__hostname__"), string("host-1"));
+    group.SetTag(string("__path__"), string("/var/log/app/access.log"));
+    for (size_t i = 0; i < kEventCntPerGroup; ++i) {
+        auto* event = group.AddLogEvent();
+        event->SetTimestamp(1700000000);
+        event->SetContent(string("application"), string(i % 2 == 0 ? "order" : "payment"));
+        event->SetContent(string("method"), string("GET"));
+        event->SetContent(string("uri"), string("/api/v1/orders?id=") + to_string(i));
+        event->SetContent(string("status"), string("200"));
+        event->SetContent(string("latency"), string("12ms"));
+    }
+    return group;
+}
+
+double FlusherKafkaBenchmark::SendPerEvent() {
+    JsonEventGroupSerializer serializer(mFlusher.get());
+    string serializedData;
+    string errorMsg;
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < kGroupCnt; ++i) {
+        auto group = CreateGroup();
+        auto events = std::move(group.MutableEvents());
+        for (auto& event : events) {
+            serializedData.clear();
+            BatchedEvents batchedEvents;
+            batchedEvents.mEvents.emplace_back(std::move(event));
+            batchedEvents.mTags = group.GetSizedTags();
+            batchedEvents.mSourceBuffers.emplace_back(group.GetSourceBuffer());
+            serializer.DoSerialize(std::move(batchedEvents), serializedData, errorMsg);
+            mProducer->ProduceAsync(string("topic"), std::move(serializedData), [](bool, const auto&) {});
+        }
+    }
+    return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+}
+
+void FlusherKafkaBenchmark::TestSend(const string& topic) {
+    Json::Value config;
+    config["Brokers"].append("test.mock.brokers");
+    config["Topic"] = topic;
+    Json::Value optionalGoPipeline;
+    APSARA_TEST_TRUE_FATAL(mFlusher->Init(config, optionalGoPipeline));
+
+    double perEventElapsed = SendPerEvent();
+    mProducer->mMessageCnt = 0;
+    auto start = chrono::high_resolution_clock::now();
+    vector<SenderQueueItem*> items;
+    for (size_t i = 0; i < kGroupCnt; ++i) {
+        mFlusher->Send(CreateGroup());
+        // sends the item as the flusher runner does
+        items.clear();
+        SenderQueueManager::GetInstance()->GetAvailableItems(items, 80);
+        for (auto* item : items) {
+            mFlusher->SendItem(item);
+        }
+    }
+    double elapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    APSARA_TEST_EQUAL(kGroupCnt * kEventCntPerGroup, mProducer->mMessageCnt);
+
+    size_t eventCnt = kGroupCnt * kEventCntPerGroup;
+    cout << "per event: " << eventCnt / perEventElapsed << " events/s" << endl;
+    cout << "FlusherKafka: " << eventCnt / elapsed << " events/s" << endl;
+}
+
+void FlusherKafkaBenchmark::TestSend_StaticTopic() {
+    TestSend("test_topic");
+}
+
+void FlusherKafkaBenchmark::TestSend_DynamicTopic() {
+    TestSend("test_%{content.application}");
+}
+
+UNIT_TEST_CASE(FlusherKafkaBenchmark, TestSend_StaticTopic)
+UNIT_TEST_CASE(FlusherKafkaBenchmark, TestSend_DynamicTopic)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -20,14 +20,17 @@
 #include <cassert>
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
 #include "collection_pipeline/serializer/JsonSerializer.h"
 #include "common/memory/SourceBuffer.h"
+#include "file_server/checkpoint/RangeCheckpoint.h"
 #include "models/LogEvent.h"
 #include "models/PipelineEventGroup.h"
 #include "plugin/flusher/kafka/FlusherKafka.h"
@@ -41,9 +44,9 @@ using namespace std;
 
 namespace logtail {
 
-class MockEventGroupSerializer : public EventGroupSerializer {
+class MockEventGroupSerializer : public JsonEventGroupSerializer {
 public:
-    MockEventGroupSerializer(Flusher* flusher) : EventGroupSerializer(flusher), mShouldFail(false) {}
+    MockEventGroupSerializer(Flusher* flusher) : JsonEventGroupSerializer(flusher), mShouldFail(false) {}
 
     bool Serialize(BatchedEvents&& group, std::string& res, std::string& errorMsg) override {
         if (mShouldFail) {
@@ -54,6 +57,21 @@ public:
         return true;
     }
 
+    bool SerializeEach(const BatchedEvents& group,
+                       std::string& res,
+                       std::vector<size_t>& offsets,
+                       std::string& errorMsg) override {
+        if (mShouldFail) {
+            errorMsg = "mock serialization error";
+            return false;
+        }
+        for (size_t i = 0; i < group.mEvents.size(); ++i) {
+            res += "serialized_data";
+            offsets.push_back(res.size());
+        }
+        return true;
+    }
+
     void SetShouldFail(bool fail) { mShouldFail = fail; }
 
 private:
@@ -110,12 +128,22 @@ public:
     void TestInitWithKerberosFull();
     void TestInitWithCompression();
     void TestInitWithCompressionAndLevel();
+    void TestSendBatch();
+    void TestSendBatchWithEmptyEvent();
+    void TestDynamicTopic_MultipleTopics();
+    void TestSendSlowBroker();
+    void TestSendExactlyOnceCheckpoint();
 
 protected:
     void SetUp();
     void TearDown();
 
 private:
+    // sends the items in the sender queue as the flusher runner does
+    vector<SenderQueueItem*> SendQueueItems();
+    // sends the item again at once instead of after the backoff
+    void RetryNow(SenderQueueItem* item);
+
     FlusherKafka* mFlusher = nullptr;
     CollectionPipelineContext* mContext = nullptr;
 
@@ -147,6 +175,22 @@ void FlusherKafkaUnittest::TearDown() {
         delete mContext;
         mContext = nullptr;
     }
+    SenderQueueManager::GetInstance()->Clear();
+}
+
+vector<SenderQueueItem*> FlusherKafkaUnittest::SendQueueItems() {
+    vector<SenderQueueItem*> items;
+    SenderQueueManager::GetInstance()->GetAvailableItems(items, 80);
+    vector<SenderQueueItem*> res(items);
+    for (auto* item : items) {
+        mFlusher->SendItem(item);
+    }
+    return res;
+}
+
+void FlusherKafkaUnittest::RetryNow(SenderQueueItem* item) {
+    item->mQuickFailNextRetryTime = item->mFirstEnqueTime;
+    SendQueueItems();
 }
 
 void FlusherKafkaUnittest::TestInitSuccess() {
@@ -188,6 +232,7 @@ void FlusherKafkaUnittest::TestSendSuccess() {
     event->SetContent(StringView("key"), StringView("value"));
 
     APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
 
     APSARA_TEST_EQUAL(1, mFlusher->mSendCnt->GetValue());
 }
@@ -205,6 +250,7 @@ void FlusherKafkaUnittest::TestSendFailure() {
 
     mMockProducer->SetAutoComplete(false);
     mFlusher->Send(std::move(group));
+    SendQueueItems();
     mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::OTHER_ERROR, "mock general error", -1});
 
 
@@ -212,6 +258,8 @@ void FlusherKafkaUnittest::TestSendFailure() {
     APSARA_TEST_EQUAL(1, mFlusher->mSendDoneCnt->GetValue());
     APSARA_TEST_EQUAL(0, mFlusher->mSuccessCnt->GetValue());
     APSARA_TEST_EQUAL(1, mFlusher->mOtherErrorCnt->GetValue());
+    APSARA_TEST_EQUAL(1, mFlusher->mDiscardCnt->GetValue());
+    APSARA_TEST_EQUAL(0U, SenderQueueManager::GetInstance()->GetQueue(mFlusher->GetQueueKey())->Size());
 }
 
 void FlusherKafkaUnittest::TestStartStop() {
@@ -261,12 +309,20 @@ void FlusherKafkaUnittest::TestSendNetworkError() {
 
     mMockProducer->SetAutoComplete(false);
     mFlusher->Send(std::move(group));
+    auto items = SendQueueItems();
     mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::NETWORK_ERROR, "mock network error", 0});
 
     APSARA_TEST_EQUAL(1, mFlusher->mSendCnt->GetValue());
     APSARA_TEST_EQUAL(1, mFlusher->mSendDoneCnt->GetValue());
     APSARA_TEST_EQUAL(0, mFlusher->mSuccessCnt->GetValue());
     APSARA_TEST_EQUAL(1, mFlusher->mNetworkErrorCnt->GetValue());
+    // the message is kept in the queue and sent again
+    APSARA_TEST_EQUAL(1, mFlusher->mRetryCnt->GetValue());
+    APSARA_TEST_EQUAL(0, mFlusher->mDiscardCnt->GetValue());
+    RetryNow(items[0]);
+    mMockProducer->CompleteLastRequest();
+    APSARA_TEST_EQUAL(2, mFlusher->mSendCnt->GetValue());
+    APSARA_TEST_EQUAL(1, mFlusher->mSuccessCnt->GetValue());
 }
 
 void FlusherKafkaUnittest::TestSendAuthError() {
@@ -281,6 +337,7 @@ void FlusherKafkaUnittest::TestSendAuthError() {
 
     mMockProducer->SetAutoComplete(false);
     mFlusher->Send(std::move(group));
+    SendQueueItems();
     mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::AUTH_ERROR, "mock auth error", 0});
 
     APSARA_TEST_EQUAL(1, mFlusher->mSendCnt->GetValue());
@@ -301,12 +358,20 @@ void FlusherKafkaUnittest::TestSendServerError() {
 
     mMockProducer->SetAutoComplete(false);
     mFlusher->Send(std::move(group));
+    auto items = SendQueueItems();
     mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::SERVER_ERROR, "mock server error", 0});
 
     APSARA_TEST_EQUAL(1, mFlusher->mSendCnt->GetValue());
     APSARA_TEST_EQUAL(1, mFlusher->mSendDoneCnt->GetValue());
     APSARA_TEST_EQUAL(0, mFlusher->mSuccessCnt->GetValue());
     APSARA_TEST_EQUAL(1, mFlusher->mServerErrorCnt->GetValue());
+    // the message is kept in the queue and sent again
+    APSARA_TEST_EQUAL(1, mFlusher->mRetryCnt->GetValue());
+    APSARA_TEST_EQUAL(0, mFlusher->mDiscardCnt->GetValue());
+    RetryNow(items[0]);
+    mMockProducer->CompleteLastRequest();
+    APSARA_TEST_EQUAL(2, mFlusher->mSendCnt->GetValue());
+    APSARA_TEST_EQUAL(1, mFlusher->mSuccessCnt->GetValue());
 }
 
 void FlusherKafkaUnittest::TestSendParamsError() {
@@ -321,6 +386,7 @@ void FlusherKafkaUnittest::TestSendParamsError() {
 
     mMockProducer->SetAutoComplete(false);
     mFlusher->Send(std::move(group));
+    SendQueueItems();
     mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::PARAMS_ERROR, "mock params error", 0});
 
     APSARA_TEST_EQUAL(1, mFlusher->mSendCnt->GetValue());
@@ -341,12 +407,24 @@ void FlusherKafkaUnittest::TestSendQueueFullError() {
 
     mMockProducer->SetAutoComplete(false);
     mFlusher->Send(std::move(group));
+    auto items = SendQueueItems();
     mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::QUEUE_FULL, "mock queue full error", 0});
 
     APSARA_TEST_EQUAL(1, mFlusher->mSendCnt->GetValue());
     APSARA_TEST_EQUAL(1, mFlusher->mSendDoneCnt->GetValue());
     APSARA_TEST_EQUAL(0, mFlusher->mSuccessCnt->GetValue());
-    APSARA_TEST_EQUAL(1, mFlusher->mDiscardCnt->GetValue());
+    // the data is not dropped but sent again after a backoff
+    APSARA_TEST_EQUAL(0, mFlusher->mDiscardCnt->GetValue());
+    APSARA_TEST_EQUAL(1, mFlusher->mRetryCnt->GetValue());
+    APSARA_TEST_EQUAL(1U, SenderQueueManager::GetInstance()->GetQueue(mFlusher->GetQueueKey())->Size());
+    APSARA_TEST_TRUE(SendQueueItems().empty());
+
+    RetryNow(items[0]);
+    mMockProducer->CompleteLastRequest();
+    APSARA_TEST_EQUAL(2, mFlusher->mSendCnt->GetValue());
+    APSARA_TEST_EQUAL(1, mFlusher->mSuccessCnt->GetValue());
+    APSARA_TEST_EQUAL(0, mFlusher->mDiscardCnt->GetValue());
+    APSARA_TEST_EQUAL(0U, SenderQueueManager::GetInstance()->GetQueue(mFlusher->GetQueueKey())->Size());
 }
 
 void FlusherKafkaUnittest::TestFlushFailure() {
@@ -401,6 +479,7 @@ void FlusherKafkaUnittest::TestDynamicTopic_Success() {
     event->SetContent(StringView("application"), StringView("user_behavior_log"));
 
     APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
     const auto& completed = mMockProducer->GetCompletedRequests();
     APSARA_TEST_EQUAL(1, completed.size());
     APSARA_TEST_EQUAL(std::string("test_user_behavior_log"), completed.back().Topic);
@@ -420,6 +499,7 @@ void FlusherKafkaUnittest::TestDynamicTopic_FallbackToStatic() {
     event->SetContent(StringView("key"), StringView("value"));
 
     APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
     const auto& completed = mMockProducer->GetCompletedRequests();
     APSARA_TEST_EQUAL(1, completed.size());
     APSARA_TEST_EQUAL(std::string("test_%{content.application}"), completed.back().Topic);
@@ -440,6 +520,7 @@ void FlusherKafkaUnittest::TestDynamicTopic_FromTags() {
     group.SetTag(StringView("namespace"), StringView("nginx_access_log"));
 
     APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
     const auto& completed = mMockProducer->GetCompletedRequests();
     APSARA_TEST_EQUAL(1, completed.size());
     APSARA_TEST_EQUAL(std::string("logs_nginx_access_log"), completed.back().Topic);
@@ -478,6 +559,7 @@ void FlusherKafkaUnittest::TestPartitionerHashKeySend() {
     e2->SetContent(StringView("application"), StringView("serviceB"));
 
     APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
     APSARA_TEST_EQUAL(2, mFlusher->mSendCnt->GetValue());
 
     const auto& reqs = mMockProducer->GetCompletedRequests();
@@ -515,6 +597,7 @@ void FlusherKafkaUnittest::TestHeadersConfigured_SendWithHeaders() {
     event->SetContent(StringView("k"), StringView("v"));
 
     APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
 
     const auto& completed = mMockProducer->GetCompletedRequests();
     APSARA_TEST_EQUAL(1U, completed.size());
@@ -670,6 +753,166 @@ void FlusherKafkaUnittest::TestInitWithCompressionAndLevel() {
     APSARA_TEST_EQUAL(2, mFlusher->mKafkaConfig.CompressionLevel);
 }
 
+void FlusherKafkaUnittest::TestSendBatch() {
+    Json::Value optionalGoPipeline;
+    Json::Value config = CreateKafkaTestConfig(mTopic);
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->Start());
+
+    PipelineEventGroup group(std::make_shared<SourceBuffer>());
+    group.SetTag(StringView("host"), StringView("host_1"));
+    for (int i = 0; i < 3; ++i) {
+        auto* event = group.AddLogEvent();
+        event->SetTimestamp(1700000000 + i);
+        event->SetContent(StringView("key"), StringView("value"));
+    }
+
+    APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
+    const auto& completed = mMockProducer->GetCompletedRequests();
+    APSARA_TEST_EQUAL(3U, completed.size());
+    for (int i = 0; i < 3; ++i) {
+        APSARA_TEST_EQUAL(mTopic, completed[i].Topic);
+        APSARA_TEST_EQUAL("{\"host\":\"host_1\",\"__time__\":" + to_string(1700000000 + i) + ",\"key\":\"value\"}\n",
+                          completed[i].Value);
+    }
+    APSARA_TEST_EQUAL(3, mFlusher->mSendCnt->GetValue());
+    APSARA_TEST_EQUAL(3, mFlusher->mSuccessCnt->GetValue());
+}
+
+void FlusherKafkaUnittest::TestSendBatchWithEmptyEvent() {
+    Json::Value optionalGoPipeline;
+    Json::Value config = CreateKafkaTestConfig(mTopic);
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->Start());
+
+    PipelineEventGroup group(std::make_shared<SourceBuffer>());
+    group.AddLogEvent();
+    auto* event = group.AddLogEvent();
+    event->SetContent(StringView("key"), StringView("value"));
+
+    APSARA_TEST_FALSE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
+    const auto& completed = mMockProducer->GetCompletedRequests();
+    APSARA_TEST_EQUAL(1U, completed.size());
+    APSARA_TEST_EQUAL(std::string("{\"__time__\":0,\"key\":\"value\"}\n"), completed[0].Value);
+    APSARA_TEST_EQUAL(1, mFlusher->mSendCnt->GetValue());
+    APSARA_TEST_EQUAL(1, mFlusher->mDiscardCnt->GetValue());
+}
+
+void FlusherKafkaUnittest::TestDynamicTopic_MultipleTopics() {
+    Json::Value optionalGoPipeline;
+    Json::Value config = CreateKafkaTestConfig("test_%{content.application}");
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->Start());
+
+    PipelineEventGroup group(std::make_shared<SourceBuffer>());
+    for (const char* app : {"a", "b", "a"}) {
+        auto* event = group.AddLogEvent();
+        event->SetContent(StringView("application"), StringView(app));
+    }
+
+    APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+    SendQueueItems();
+    const auto& completed = mMockProducer->GetCompletedRequests();
+    APSARA_TEST_EQUAL(3U, completed.size());
+    std::map<std::string, std::vector<std::string>> topicValues;
+    for (const auto& request : completed) {
+        topicValues[request.Topic].push_back(request.Value);
+    }
+    APSARA_TEST_EQUAL(2U, topicValues.size());
+    APSARA_TEST_EQUAL(2U, topicValues["test_a"].size());
+    APSARA_TEST_EQUAL(1U, topicValues["test_b"].size());
+    APSARA_TEST_EQUAL(std::string("{\"__time__\":0,\"application\":\"b\"}\n"), topicValues["test_b"][0]);
+    APSARA_TEST_EQUAL(3, mFlusher->mSendCnt->GetValue());
+}
+
+void FlusherKafkaUnittest::TestSendSlowBroker() {
+    Json::Value optionalGoPipeline;
+    Json::Value config = CreateKafkaTestConfig(mTopic);
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->Start());
+
+    // the broker does not acknowledge any message
+    mMockProducer->SetAutoComplete(false);
+    auto* queue = SenderQueueManager::GetInstance()->GetQueue(mFlusher->GetQueueKey());
+    size_t groupCnt = 0;
+    while (SenderQueueManager::GetInstance()->IsValidToPush(mFlusher->GetQueueKey())) {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        auto* event = group.AddLogEvent();
+        event->SetContent(StringView("key"), StringView("value"));
+        APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+        SendQueueItems();
+        APSARA_TEST_TRUE_FATAL(++groupCnt <= 1000);
+    }
+    // the queue is full of messages waiting for delivery reports, which holds back the process queue
+    APSARA_TEST_EQUAL(groupCnt, queue->Size());
+    size_t inflightCnt = mMockProducer->GetRequests().size();
+    APSARA_TEST_TRUE(inflightCnt > 0 && inflightCnt <= groupCnt);
+    APSARA_TEST_EQUAL(inflightCnt, static_cast<size_t>(mFlusher->mOutQueueMessages->GetValue()));
+    APSARA_TEST_EQUAL(0, mFlusher->mDiscardCnt->GetValue());
+
+    // items held back by the concurrency limiter are sent once the former ones are delivered
+    while (!mMockProducer->GetRequests().empty()) {
+        mMockProducer->CompleteAllRequests();
+        SendQueueItems();
+    }
+    APSARA_TEST_EQUAL(0U, queue->Size());
+    APSARA_TEST_TRUE(SenderQueueManager::GetInstance()->IsValidToPush(mFlusher->GetQueueKey()));
+    APSARA_TEST_EQUAL(groupCnt, static_cast<size_t>(mFlusher->mSuccessCnt->GetValue()));
+}
+
+void FlusherKafkaUnittest::TestSendExactlyOnceCheckpoint() {
+    Json::Value optionalGoPipeline;
+    Json::Value config = CreateKafkaTestConfig(mTopic);
+    APSARA_TEST_TRUE(mFlusher->Init(config, optionalGoPipeline));
+    APSARA_TEST_TRUE(mFlusher->Start());
+    mMockProducer->SetAutoComplete(false);
+    {
+        // committed when all messages are delivered
+        auto cpt = make_shared<RangeCheckpoint>();
+        cpt->index = 0;
+        cpt->data.set_hash_key("hash_key_0");
+        cpt->data.set_sequence_id(1);
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        for (int i = 0; i < 2; ++i) {
+            auto* event = group.AddLogEvent();
+            event->SetContent(StringView("key"), StringView("value"));
+        }
+        group.SetExactlyOnceCheckpoint(cpt);
+        APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+        auto items = SendQueueItems();
+        APSARA_TEST_EQUAL(2U, mMockProducer->GetRequests().size());
+
+        mMockProducer->CompleteLastRequest();
+        APSARA_TEST_FALSE(cpt->data.committed());
+        mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::NETWORK_ERROR, "mock network error", 0});
+        APSARA_TEST_FALSE(cpt->data.committed());
+        // only the failed message is sent again
+        RetryNow(items[0]);
+        APSARA_TEST_EQUAL(1U, mMockProducer->GetRequests().size());
+        mMockProducer->CompleteLastRequest();
+        APSARA_TEST_TRUE(cpt->data.committed());
+        APSARA_TEST_EQUAL(2U, cpt->data.sequence_id());
+    }
+    {
+        // not committed when any message is discarded, so that the range is read again on restart
+        auto cpt = make_shared<RangeCheckpoint>();
+        cpt->index = 1;
+        cpt->data.set_hash_key("hash_key_1");
+        cpt->data.set_sequence_id(1);
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        auto* event = group.AddLogEvent();
+        event->SetContent(StringView("key"), StringView("value"));
+        group.SetExactlyOnceCheckpoint(cpt);
+        APSARA_TEST_TRUE(mFlusher->Send(std::move(group)));
+        SendQueueItems();
+        mMockProducer->CompleteLastRequest(false, {KafkaProducer::ErrorType::PARAMS_ERROR, "mock params error", 0});
+        APSARA_TEST_FALSE(cpt->data.committed());
+        APSARA_TEST_EQUAL(1U, cpt->data.sequence_id());
+    }
+}
+
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitSuccess)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitMissingBrokers)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitMissingTopic)
@@ -705,6 +948,11 @@ UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitWithKerberosAndTLS)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitWithKerberosFull)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitWithCompression)
 UNIT_TEST_CASE(FlusherKafkaUnittest, TestInitWithCompressionAndLevel)
+UNIT_TEST_CASE(FlusherKafkaUnittest, TestSendBatch)
+UNIT_TEST_CASE(FlusherKafkaUnittest, TestSendBatchWithEmptyEvent)
+UNIT_TEST_CASE(FlusherKafkaUnittest, TestDynamicTopic_MultipleTopics)
+UNIT_TEST_CASE(FlusherKafkaUnittest, TestSendSlowBroker)
+UNIT_TEST_CASE(FlusherKafkaUnittest, TestSendExactlyOnceCheckpoint)
 
 } // namespace logtail
 
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef APSARA_UNIT_TEST_MAIN
+#define APSARA_UNIT_TEST_MAIN
+#endif
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "collection_pipeline/CollectionPipeline.h"
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/batch/BatchedEvents.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "collection_pipeline/serializer/OTLPSerializer.h"
+#include "common/StringTools.h"
+#include "common/http/Curl.h"
+#include "constants/TagConstants.h"
+#include "models/PipelineEventGroup.h"
+#include "plugin/flusher/otlp/FlusherOTLP.h"
+#include "protobuf/sls/sls_logs.pb.h"
+#include "unittest/Unittest.h"
+#include "unittest/flusher/StandInReceiver.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Compares FlusherOTLP sending groups of log events to a local stand-in receiver, with the part of the Go path done
+// in C++, i.e. building and serializing an sls LogGroup for each group before it is handed over to Go, where it is
+// parsed again, converted to OTLP and sent. The Go part is not measured here.
+class FlusherOTLPBenchmark : public ::testing::Test {
+public:
+    void TestSerialize();
+    void TestSend();
+
+protected:
+    void SetUp() override {
+        mContext.SetConfigName("test_config");
+        mContext.SetPipeline(mPipeline);
+        APSARA_TEST_TRUE_FATAL(mReceiver.Start());
+    }
+
+    void TearDown() override {
+        mReceiver.Stop();
+        SenderQueueManager::GetInstance()->Clear();
+    }
+
+private:
+    PipelineEventGroup CreateGroup();
+    double SerializeForGo(size_t& bytes);
+
+    static const size_t kGroupCnt = 1000;
+    static const size_t kEventCntPerGroup = 100;
+
+    CollectionPipeline mPipeline;
+    CollectionPipelineContext mContext;
+    StandInReceiver mReceiver;
+};
+
+PipelineEventGroup FlusherOTLPBenchmark::CreateGroup() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(string("host.name"), string("host-1"));
+    group.SetTag(string("log.file.path"), string("/var/log/app/access.log"));
+    for (size_t i = 0; i < kEventCntPerGroup; ++i) {
+        auto* event = group.AddLogEvent();
+        event->SetTimestamp(1700000000, 123);
+        event->SetContent(string("content"), "GET /api/v1/orders?id=" + to_string(i) + " 200 12ms");
+        event->SetContent(string("application"), string(i % 2 == 0 ? "order" : "payment"));
+        event->SetContent(string("method"), string("GET"));
+        event->SetContent(string("status"), string("200"));
+    }
+    return group;
+}
+
+// the same as ProcessorRunner::Serialize
+double FlusherOTLPBenchmark::SerializeForGo(size_t& bytes) {
+    bytes = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < kGroupCnt; ++i) {
+        auto group = CreateGroup();
+        sls_logs::LogGroup logGroup;
+        for (const auto& e : group.GetEvents()) {
+            const auto& logEvent = e.Cast<LogEvent>();
+            auto log = logGroup.add_logs();
+            for (const auto& kv : logEvent) {
+                auto contPtr = log->add_contents();
+                contPtr->set_key(kv.first.to_string());
+                contPtr->set_value(kv.second.to_string());
+            }
+            log->set_time(logEvent.GetTimestamp());
+            log->set_time_ns(logEvent.GetTimestampNanosecond().value());
+        }
+        for (const auto& tag : group.GetTags()) {
+            if (tag.first == LOG_RESERVED_KEY_TOPIC) {
+                logGroup.set_topic(tag.second.to_string());
+            } else {
+                auto logTag = logGroup.add_logtags();
+                logTag->set_key(tag.first.to_string());
+                logTag->set_value(tag.second.to_string());
+            }
+        }
+        bytes += logGroup.SerializeAsString().size();
+    }
+    return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+}
+
+void FlusherOTLPBenchmark::TestSerialize() {
+    size_t goBytes = 0;
+    double goElapsed = SerializeForGo(goBytes);
+
+    FlusherOTLP flusher;
+    OTLPEventGroupSerializer serializer(&flusher);
+    size_t otlpBytes = 0;
+    string res, errorMsg;
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < kGroupCnt; ++i) {
+        auto group = CreateGroup();
+        BatchedEvents batch(std::move(group.MutableEvents()),
+                            std::move(group.GetSizedTags()),
+                            std::move(group.GetSourceBuffer()),
+                            group.GetMetadata(EventGroupMetaKey::SOURCE_ID),
+                            std::move(group.GetExactlyOnceCheckpoint()));
+        APSARA_TEST_TRUE(serializer.DoSerialize(std::move(batch), res, errorMsg));
+        otlpBytes += res.size();
+    }
+    double otlpElapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+    size_t eventCnt = kGroupCnt * kEventCntPerGroup;
+    cout << "sls log group for go: " << eventCnt / goElapsed << " events/s, " << goBytes << " bytes" << endl;
+    cout << "otlp: " << eventCnt / otlpElapsed << " events/s, " << otlpBytes << " bytes" << endl;
+}
+
+void FlusherOTLPBenchmark::TestSend() {
+    Json::Value config, optionalGoPipeline;
+    config["Endpoint"] = "http://127.0.0.1:" + to_string(mReceiver.GetPort());
+    FlusherOTLP flusher;
+    flusher.SetContext(mContext);
+    flusher.CreateMetricsRecordRef(FlusherOTLP::sName, "1");
+    APSARA_TEST_TRUE_FATAL(flusher.Init(config, optionalGoPipeline));
+    flusher.CommitMetricsRecordRef();
+
+    size_t goBytes = 0;
+    double goElapsed = SerializeForGo(goBytes);
+
+    auto start = chrono::high_resolution_clock::now();
+    vector<SenderQueueItem*> items;
+    for (size_t i = 0; i < kGroupCnt; ++i) {
+        flusher.Send(CreateGroup());
+        flusher.FlushAll();
+        // sends the item as the flusher runner does, except that requests are sent one by one
+        items.clear();
+        SenderQueueManager::GetInstance()->GetAvailableItems(items, 80);
+        for (auto* item : items) {
+            unique_ptr<HttpSinkRequest> req;
+            bool keepItem = false;
+            string errMsg;
+            APSARA_TEST_TRUE(flusher.BuildRequest(item, req, &keepItem, &errMsg));
+            HttpResponse response;
+            SendHttpRequest(unique_ptr<HttpRequest>(req.release()), response);
+            flusher.OnSendDone(response, item);
+        }
+    }
+    double elapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    APSARA_TEST_EQUAL(kGroupCnt, mReceiver.mRequestCnt.load());
+
+    size_t eventCnt = kGroupCnt * kEventCntPerGroup;
+    cout << "sls log group for go (serialization only): " << eventCnt / goElapsed << " events/s" << endl;
+    cout << "FlusherOTLP (end to end): " << eventCnt / elapsed << " events/s, " << mReceiver.mBodyBytes.load()
+         << " bytes received" << endl;
+}
+
+UNIT_TEST_CASE(FlusherOTLPBenchmark, TestSerialize)
+UNIT_TEST_CASE(FlusherOTLPBenchmark, TestSend)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,310 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+
+#include "json/json.h"
+
+#include "collection_pipeline/CollectionPipeline.h"
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "common/JsonUtil.h"
+#include "common/http/Constant.h"
+#include "plugin/flusher/otlp/FlusherOTLP.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class FlusherOTLPUnittest : public testing::Test {
+public:
+    void OnSuccessfulInit();
+    void OnFailedInit();
+    void TestSend();
+    void TestBuildRequest();
+    void TestOnSendDone();
+
+protected:
+    void SetUp() override {
+        ctx.SetConfigName("test_config");
+        ctx.SetPipeline(pipeline);
+    }
+
+    void TearDown() override {
+        QueueKeyManager::GetInstance()->Clear();
+        SenderQueueManager::GetInstance()->Clear();
+    }
+
+private:
+    unique_ptr<FlusherOTLP> CreateFlusher(const string& configStr);
+    vector<SenderQueueItem*> SendLogs(FlusherOTLP& flusher, size_t groupCnt);
+
+    CollectionPipeline pipeline;
+    CollectionPipelineContext ctx;
+};
+
+unique_ptr<FlusherOTLP> FlusherOTLPUnittest::CreateFlusher(const string& configStr) {
+    Json::Value configJson, optionalGoPipeline;
+    string errorMsg;
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+    auto flusher = make_unique<FlusherOTLP>();
+    flusher->SetContext(ctx);
+    flusher->CreateMetricsRecordRef(FlusherOTLP::sName, "1");
+    if (!flusher->Init(configJson, optionalGoPipeline)) {
+        return nullptr;
+    }
+    flusher->CommitMetricsRecordRef();
+    APSARA_TEST_TRUE(optionalGoPipeline.isNull());
+    return flusher;
+}
+
+vector<SenderQueueItem*> FlusherOTLPUnittest::SendLogs(FlusherOTLP& flusher, size_t groupCnt) {
+    for (size_t i = 0; i < groupCnt; ++i) {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        group.SetTag(string("host.name"), "host-" + to_string(i));
+        auto e = group.AddLogEvent();
+        e->SetTimestamp(1234567890);
+        e->SetContent(string("content"), string("hello"));
+        flusher.Send(std::move(group));
+    }
+    flusher.FlushAll();
+    vector<SenderQueueItem*> res;
+    SenderQueueManager::GetInstance()->GetAvailableItems(res, 80);
+    return res;
+}
+
+void FlusherOTLPUnittest::OnSuccessfulInit() {
+    {
+        // only mandatory param
+        auto flusher = CreateFlusher(R"(
+            {
+                "Type": "flusher_otlp_native",
+                "Endpoint": "http://localhost:4318"
+            }
+        )");
+        APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+        APSARA_TEST_FALSE(flusher->mHttpsFlag);
+        APSARA_TEST_EQUAL("localhost", flusher->mHost);
+        APSARA_TEST_EQUAL(4318, flusher->mPort);
+        APSARA_TEST_EQUAL("/v1/logs", flusher->mLogsPath);
+        APSARA_TEST_EQUAL("/v1/metrics", flusher->mMetricsPath);
+        APSARA_TEST_EQUAL("/v1/traces", flusher->mTracesPath);
+        APSARA_TEST_TRUE(flusher->mHeaders.empty());
+        APSARA_TEST_EQUAL(CompressType::ZSTD, flusher->mCompressor->GetCompressType());
+        APSARA_TEST_EQUAL(0U, flusher->mMaxSendRate);
+        APSARA_TEST_NOT_EQUAL(nullptr, SenderQueueManager::GetInstance()->GetQueue(flusher->GetQueueKey()));
+    }
+    {
+        // all params
+        auto flusher = CreateFlusher(R"(
+            {
+                "Type": "flusher_otlp_native",
+                "Endpoint": "https://otel.example.com/otlp/",
+                "Headers": {
+                    "Authorization": "Bearer token"
+                },
+                "CompressType": "none",
+                "MaxSendRate": 1024
+            }
+        )");
+        APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+        APSARA_TEST_TRUE(flusher->mHttpsFlag);
+        APSARA_TEST_EQUAL("otel.example.com", flusher->mHost);
+        APSARA_TEST_EQUAL(443, flusher->mPort);
+        APSARA_TEST_EQUAL("/otlp/v1/logs", flusher->mLogsPath);
+        APSARA_TEST_EQUAL("Bearer token", flusher->mHeaders["Authorization"]);
+        APSARA_TEST_EQUAL(nullptr, flusher->mCompressor);
+        APSARA_TEST_EQUAL(1024U, flusher->mMaxSendRate);
+    }
+    {
+        // lz4 is replaced with zstd
+        auto flusher = CreateFlusher(R"(
+            {
+                "Type": "flusher_otlp_native",
+                "Endpoint": "localhost:4318",
+                "CompressType": "lz4"
+            }
+        )");
+        APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+        APSARA_TEST_FALSE(flusher->mHttpsFlag);
+        APSARA_TEST_EQUAL("localhost", flusher->mHost);
+        APSARA_TEST_EQUAL(CompressType::ZSTD, flusher->mCompressor->GetCompressType());
+    }
+}
+
+void FlusherOTLPUnittest::OnFailedInit() {
+    APSARA_TEST_EQUAL(nullptr, CreateFlusher(R"({"Type": "flusher_otlp_native"})"));
+    APSARA_TEST_EQUAL(nullptr, CreateFlusher(R"({"Type": "flusher_otlp_native", "Endpoint": true})"));
+    APSARA_TEST_EQUAL(nullptr, CreateFlusher(R"({"Type": "flusher_otlp_native", "Endpoint": "http://:4318"})"));
+    APSARA_TEST_EQUAL(nullptr,
+                      CreateFlusher(R"({"Type": "flusher_otlp_native", "Endpoint": "http://localhost:port"})"));
+}
+
+void FlusherOTLPUnittest::TestSend() {
+    auto flusher = CreateFlusher(R"(
+        {
+            "Type": "flusher_otlp_native",
+            "Endpoint": "http://localhost:4318"
+        }
+    )");
+    APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+
+    // groups with different tags are sent in different requests
+    auto items = SendLogs(*flusher, 2);
+    APSARA_TEST_EQUAL(2U, items.size());
+    for (auto* item : items) {
+        auto* otlpItem = static_cast<OTLPSenderQueueItem*>(item);
+        APSARA_TEST_EQUAL(OTLPSignalType::LOGS, otlpItem->mSignalType);
+        APSARA_TEST_FALSE(otlpItem->mData.empty());
+        APSARA_TEST_TRUE(otlpItem->mRawSize > 0);
+    }
+
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    auto e = group.AddMetricEvent();
+    e->SetName("cpu");
+    e->SetTimestamp(1234567890);
+    e->SetValue<UntypedSingleValue>(0.5);
+    flusher->Send(std::move(group));
+    flusher->FlushAll();
+    items.clear();
+    SenderQueueManager::GetInstance()->GetAvailableItems(items, 80);
+    APSARA_TEST_EQUAL(1U, items.size());
+    APSARA_TEST_EQUAL(OTLPSignalType::METRICS, static_cast<OTLPSenderQueueItem*>(items[0])->mSignalType);
+}
+
+void FlusherOTLPUnittest::TestBuildRequest() {
+    {
+        auto flusher = CreateFlusher(R"(
+            {
+                "Type": "flusher_otlp_native",
+                "Endpoint": "https://otel.example.com:4318/otlp",
+                "Headers": {
+                    "Authorization": "Bearer token"
+                }
+            }
+        )");
+        APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+        auto items = SendLogs(*flusher, 1);
+        APSARA_TEST_EQUAL(1U, items.size());
+
+        unique_ptr<HttpSinkRequest> req;
+        bool keepItem = false;
+        string errMsg;
+        APSARA_TEST_TRUE(flusher->BuildRequest(items[0], req, &keepItem, &errMsg));
+        APSARA_TEST_EQUAL(HTTP_POST, req->mMethod);
+        APSARA_TEST_TRUE(req->mHTTPSFlag);
+        APSARA_TEST_EQUAL("otel.example.com", req->mHost);
+        APSARA_TEST_EQUAL(4318, req->mPort);
+        APSARA_TEST_EQUAL("/otlp/v1/logs", req->mUrl);
+        APSARA_TEST_EQUAL("", req->mQueryString);
+        APSARA_TEST_EQUAL(3U, req->mHeader.size());
+        APSARA_TEST_EQUAL("Bearer token", req->mHeader["Authorization"]);
+        APSARA_TEST_EQUAL(TYPE_LOG_PROTOBUF, req->mHeader[CONTENT_TYPE]);
+        APSARA_TEST_EQUAL("zstd", req->mHeader["Content-Encoding"]);
+        APSARA_TEST_EQUAL(items[0]->mData, req->mBody);
+        APSARA_TEST_EQUAL(items[0], req->mItem);
+        APSARA_TEST_EQUAL(1, flusher->mSendCnt->GetValue());
+    }
+    {
+        auto flusher = CreateFlusher(R"(
+            {
+                "Type": "flusher_otlp_native",
+                "Endpoint": "http://localhost:4318",
+                "CompressType": "none"
+            }
+        )");
+        APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+        auto items = SendLogs(*flusher, 1);
+        APSARA_TEST_EQUAL(1U, items.size());
+        static_cast<OTLPSenderQueueItem*>(items[0])->mSignalType = OTLPSignalType::TRACES;
+
+        unique_ptr<HttpSinkRequest> req;
+        bool keepItem = false;
+        string errMsg;
+        APSARA_TEST_TRUE(flusher->BuildRequest(items[0], req, &keepItem, &errMsg));
+        APSARA_TEST_EQUAL("/v1/traces", req->mUrl);
+        APSARA_TEST_EQUAL(1U, req->mHeader.size());
+        APSARA_TEST_EQUAL(items[0]->mRawSize, req->mBody.size());
+    }
+}
+
+void FlusherOTLPUnittest::TestOnSendDone() {
+    auto flusher = CreateFlusher(R"(
+        {
+            "Type": "flusher_otlp_native",
+            "Endpoint": "http://localhost:4318"
+        }
+    )");
+    APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+    auto* queue = SenderQueueManager::GetInstance()->GetQueue(flusher->GetQueueKey());
+    {
+        // success
+        auto items = SendLogs(*flusher, 1);
+        APSARA_TEST_EQUAL(1U, items.size());
+        HttpResponse response;
+        response.SetStatusCode(200);
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_TRUE(queue->Empty());
+        APSARA_TEST_EQUAL(1, flusher->mSuccessCnt->GetValue());
+    }
+    {
+        // network error and retriable server errors
+        auto items = SendLogs(*flusher, 1);
+        APSARA_TEST_EQUAL(1U, items.size());
+        HttpResponse response;
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_EQUAL(SendingStatus::IDLE, items[0]->mStatus.load());
+        APSARA_TEST_EQUAL(2U, items[0]->mTryCnt);
+        APSARA_TEST_EQUAL(1, flusher->mNetworkErrorCnt->GetValue());
+
+        response.SetStatusCode(503);
+        items[0]->mStatus = SendingStatus::SENDING;
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_EQUAL(SendingStatus::IDLE, items[0]->mStatus.load());
+        APSARA_TEST_EQUAL(1, flusher->mServerErrorCnt->GetValue());
+        APSARA_TEST_EQUAL(2, flusher->mRetryCnt->GetValue());
+        APSARA_TEST_FALSE(queue->Empty());
+
+        // other errors are not retried
+        response.SetStatusCode(400);
+        items[0]->mStatus = SendingStatus::SENDING;
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_TRUE(queue->Empty());
+        APSARA_TEST_EQUAL(1, flusher->mParamsErrorCnt->GetValue());
+        APSARA_TEST_EQUAL(1, flusher->mDiscardCnt->GetValue());
+    }
+    {
+        auto items = SendLogs(*flusher, 1);
+        APSARA_TEST_EQUAL(1U, items.size());
+        HttpResponse response;
+        response.SetStatusCode(401);
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_TRUE(queue->Empty());
+        APSARA_TEST_EQUAL(1, flusher->mUnauthErrorCnt->GetValue());
+        APSARA_TEST_EQUAL(2, flusher->mDiscardCnt->GetValue());
+    }
+}
+
+UNIT_TEST_CASE(FlusherOTLPUnittest, OnSuccessfulInit)
+UNIT_TEST_CASE(FlusherOTLPUnittest, OnFailedInit)
+UNIT_TEST_CASE(FlusherOTLPUnittest, TestSend)
+UNIT_TEST_CASE(FlusherOTLPUnittest, TestBuildRequest)
+UNIT_TEST_CASE(FlusherOTLPUnittest, TestOnSendDone)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef APSARA_UNIT_TEST_MAIN
+#define APSARA_UNIT_TEST_MAIN
+#endif
+
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "collection_pipeline/CollectionPipeline.h"
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "common/http/Curl.h"
+#include "models/PipelineEventGroup.h"
+#include "plugin/flusher/prometheus/FlusherPrometheus.h"
+#include "unittest/Unittest.h"
+#include "unittest/flusher/StandInReceiver.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Sends several scrapes of 1M series through FlusherPrometheus to a local stand-in receiver, and reports the
+// throughput and the memory taken by the series cache for each scrape. The first scrape interns all series, while
+// the following ones find them in the cache.
+class FlusherPrometheusBenchmark : public ::testing::Test {
+public:
+    void TestSend();
+
+protected:
+    void SetUp() override {
+        mContext.SetConfigName("test_config");
+        mContext.SetPipeline(mPipeline);
+        APSARA_TEST_TRUE_FATAL(mReceiver.Start());
+    }
+
+    void TearDown() override {
+        mReceiver.Stop();
+        SenderQueueManager::GetInstance()->Clear();
+    }
+
+private:
+    PipelineEventGroup CreateGroup(size_t scrape, size_t idx);
+    // sends the items as the flusher runner does, except that requests are sent one by one
+    void SendAvailableItems(FlusherPrometheus& flusher);
+
+    static size_t GetRssBytes();
+
+    static const size_t kSeriesCnt = 1000000;
+    static const size_t kEventCntPerGroup = 1000;
+    static const size_t kScrapeCnt = 3;
+
+    CollectionPipeline mPipeline;
+    CollectionPipelineContext mContext;
+    StandInReceiver mReceiver;
+};
+
+PipelineEventGroup FlusherPrometheusBenchmark::CreateGroup(size_t scrape, size_t idx) {
+    static const vector<string> sMethods = {"GET", "POST", "PUT", "DELETE"};
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    string instance = "10.0." + to_string(idx / 256) + "." + to_string(idx % 256) + ":8080";
+    for (size_t i = 0; i < kEventCntPerGroup; ++i) {
+        auto* event = group.AddMetricEvent();
+        event->SetName("http_requests_total");
+        event->SetTimestamp(1700000000 + scrape * 15);
+        event->SetTag(string("instance"), instance);
+        event->SetTag(string("job"), string("app"));
+        event->SetTag(string("method"), sMethods[i % sMethods.size()]);
+        event->SetTag(string("path"), "/api/v1/resources/" + to_string(i / sMethods.size()));
+        event->SetValue<UntypedSingleValue>(static_cast<double>(scrape * 100 + i % 100));
+    }
+    return group;
+}
+
+void FlusherPrometheusBenchmark::SendAvailableItems(FlusherPrometheus& flusher) {
+    vector<SenderQueueItem*> items;
+    SenderQueueManager::GetInstance()->GetAvailableItems(items, 80);
+    for (auto* item : items) {
+        unique_ptr<HttpSinkRequest> req;
+        bool keepItem = false;
+        string errMsg;
+        APSARA_TEST_TRUE(flusher.BuildRequest(item, req, &keepItem, &errMsg));
+        HttpResponse response;
+        SendHttpRequest(unique_ptr<HttpRequest>(req.release()), response);
+        flusher.OnSendDone(response, item);
+    }
+}
+
+size_t FlusherPrometheusBenchmark::GetRssBytes() {
+    size_t size = 0, resident = 0;
+    ifstream fin("/proc/self/statm");
+    fin >> size >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+void FlusherPrometheusBenchmark::TestSend() {
+    Json::Value config, optionalGoPipeline;
+    config["Endpoint"] = "http://127.0.0.1:" + to_string(mReceiver.GetPort()) + "/api/v1/write";
+    FlusherPrometheus flusher;
+    flusher.SetContext(mContext);
+    flusher.CreateMetricsRecordRef(FlusherPrometheus::sName, "1");
+    APSARA_TEST_TRUE_FATAL(flusher.Init(config, optionalGoPipeline));
+    flusher.CommitMetricsRecordRef();
+
+    size_t initialRss = GetRssBytes();
+    for (size_t scrape = 0; scrape < kScrapeCnt; ++scrape) {
+        size_t requestCnt = mReceiver.mRequestCnt.load();
+        size_t bodyBytes = mReceiver.mBodyBytes.load();
+        double elapsed = 0;
+        for (size_t i = 0; i < kSeriesCnt / kEventCntPerGroup; ++i) {
+            // only the flusher is timed, not building the events
+            auto group = CreateGroup(scrape, i);
+            auto start = chrono::high_resolution_clock::now();
+            flusher.Send(std::move(group));
+            SendAvailableItems(flusher);
+            elapsed += chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        }
+        auto start = chrono::high_resolution_clock::now();
+        flusher.FlushAll();
+        SendAvailableItems(flusher);
+        elapsed += chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+        size_t seriesCnt = 0, labelBytes = 0;
+        for (const auto& shard : flusher.mShards) {
+            seriesCnt += shard->mSeriesCache.Size();
+            labelBytes += shard->mSeriesCache.DataSize();
+        }
+        APSARA_TEST_EQUAL(kSeriesCnt, seriesCnt);
+        cout << "scrape " << scrape << ": " << kSeriesCnt / elapsed << " samples/s, "
+             << mReceiver.mRequestCnt.load() - requestCnt << " requests, " << mReceiver.mBodyBytes.load() - bodyBytes
+             << " bytes received" << endl;
+        cout << "series cache: " << seriesCnt << " series, " << labelBytes << " bytes of labels, rss increased by "
+             << (GetRssBytes() - initialRss) / 1024 / 1024 << " MB" << endl;
+    }
+    APSARA_TEST_EQUAL(0, flusher.mDiscardCnt->GetValue());
+}
+
+UNIT_TEST_CASE(FlusherPrometheusBenchmark, TestSend)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
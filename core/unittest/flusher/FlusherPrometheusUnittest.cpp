@@ -0,0 +1,488 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "json/json.h"
+
+#include "collection_pipeline/CollectionPipeline.h"
+#include "collection_pipeline/CollectionPipelineContext.h"
+#include "collection_pipeline/queue/QueueKeyManager.h"
+#include "collection_pipeline/queue/SenderQueueManager.h"
+#include "common/JsonUtil.h"
+#include "common/http/Constant.h"
+#include "plugin/flusher/prometheus/FlusherPrometheus.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// a decoded TimeSeries, whose labels are kept in order
+struct TimeSeries {
+    vector<pair<string, string>> mLabels;
+    vector<pair<double, int64_t>> mSamples;
+};
+
+// a minimal protobuf decoder to check the wire format, since remote write protos are not compiled in
+static bool ReadVarint(const string& data, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (uint32_t shift = 0; pos < data.size() && shift < 64; shift += 7) {
+        uint8_t b = static_cast<uint8_t>(data[pos++]);
+        value |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// calls fn(number, value, bytes) for each field, where value is set for varint and fixed64 fields
+template <typename Fn>
+static bool Decode(const string& data, Fn fn) {
+    size_t pos = 0;
+    while (pos < data.size()) {
+        uint64_t tag = 0, value = 0;
+        if (!ReadVarint(data, pos, tag)) {
+            return false;
+        }
+        string bytes;
+        switch (tag & 0x7) {
+            case 0:
+                if (!ReadVarint(data, pos, value)) {
+                    return false;
+                }
+                break;
+            case 1:
+                if (pos + 8 > data.size()) {
+                    return false;
+                }
+                memcpy(&value, data.data() + pos, 8);
+                pos += 8;
+                break;
+            case 2: {
+                uint64_t len = 0;
+                if (!ReadVarint(data, pos, len) || pos + len > data.size()) {
+                    return false;
+                }
+                bytes = data.substr(pos, len);
+                pos += len;
+                break;
+            }
+            default:
+                return false;
+        }
+        fn(static_cast<uint32_t>(tag >> 3), value, bytes);
+    }
+    return true;
+}
+
+static vector<TimeSeries> DecodeWriteRequest(const string& data) {
+    vector<TimeSeries> res;
+    bool ok = Decode(data, [&](uint32_t number, uint64_t, const string& timeSeries) {
+        APSARA_TEST_EQUAL(1U, number);
+        res.emplace_back();
+        APSARA_TEST_TRUE(Decode(timeSeries, [&](uint32_t seriesField, uint64_t, const string& bytes) {
+            if (seriesField == 1) {
+                res.back().mLabels.emplace_back();
+                APSARA_TEST_TRUE(Decode(bytes, [&](uint32_t labelField, uint64_t, const string& str) {
+                    (labelField == 1 ? res.back().mLabels.back().first : res.back().mLabels.back().second) = str;
+                }));
+            } else {
+                APSARA_TEST_EQUAL(2U, seriesField);
+                res.back().mSamples.emplace_back();
+                APSARA_TEST_TRUE(Decode(bytes, [&](uint32_t sampleField, uint64_t value, const string&) {
+                    if (sampleField == 1) {
+                        memcpy(&res.back().mSamples.back().first, &value, sizeof(double));
+                    } else {
+                        res.back().mSamples.back().second = static_cast<int64_t>(value);
+                    }
+                }));
+            }
+        }));
+    });
+    APSARA_TEST_TRUE(ok);
+    return res;
+}
+
+class FlusherPrometheusUnittest : public testing::Test {
+public:
+    void OnSuccessfulInit();
+    void OnFailedInit();
+    void TestSend();
+    void TestSeriesCache();
+    void TestBuildRequest();
+    void TestOnSendDone();
+
+protected:
+    void SetUp() override {
+        ctx.SetConfigName("test_config");
+        ctx.SetPipeline(pipeline);
+    }
+
+    void TearDown() override {
+        QueueKeyManager::GetInstance()->Clear();
+        SenderQueueManager::GetInstance()->Clear();
+    }
+
+private:
+    unique_ptr<FlusherPrometheus> CreateFlusher(const string& configStr);
+    vector<SenderQueueItem*> SendMetrics(FlusherPrometheus& flusher, size_t groupCnt);
+    vector<TimeSeries> Decompress(FlusherPrometheus& flusher, SenderQueueItem* item);
+
+    CollectionPipeline pipeline;
+    CollectionPipelineContext ctx;
+};
+
+unique_ptr<FlusherPrometheus> FlusherPrometheusUnittest::CreateFlusher(const string& configStr) {
+    Json::Value configJson, optionalGoPipeline;
+    string errorMsg;
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+    auto flusher = make_unique<FlusherPrometheus>();
+    flusher->SetContext(ctx);
+    flusher->CreateMetricsRecordRef(FlusherPrometheus::sName, "1");
+    if (!flusher->Init(configJson, optionalGoPipeline)) {
+        return nullptr;
+    }
+    flusher->CommitMetricsRecordRef();
+    APSARA_TEST_TRUE(optionalGoPipeline.isNull());
+    return flusher;
+}
+
+// each group has one sample of series cpu{host="host-<i>"}, and one sample of cpu{host="host-0"} as well
+vector<SenderQueueItem*> FlusherPrometheusUnittest::SendMetrics(FlusherPrometheus& flusher, size_t groupCnt) {
+    for (size_t i = 0; i < groupCnt; ++i) {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        for (size_t j = 0; j < 2; ++j) {
+            auto e = group.AddMetricEvent();
+            e->SetName("cpu");
+            e->SetTimestamp(1234567890 + i, 500000000);
+            e->SetTag(string("host"), "host-" + to_string(j == 0 ? i : 0));
+            e->SetValue<UntypedSingleValue>(static_cast<double>(i));
+        }
+        flusher.Send(std::move(group));
+    }
+    flusher.FlushAll();
+    vector<SenderQueueItem*> res;
+    SenderQueueManager::GetInstance()->GetAvailableItems(res, 80);
+    return res;
+}
+
+vector<TimeSeries> FlusherPrometheusUnittest::Decompress(FlusherPrometheus& flusher, SenderQueueItem* item) {
+    string data, errorMsg;
+    data.resize(item->mRawSize);
+    APSARA_TEST_TRUE(flusher.mCompressor->UnCompress(item->mData, data, errorMsg));
+    return DecodeWriteRequest(data);
+}
+
+void FlusherPrometheusUnittest::OnSuccessfulInit() {
+    {
+        // only mandatory param
+        auto flusher = CreateFlusher(R"(
+            {
+                "Type": "flusher_prometheus_native",
+                "Endpoint": "http://localhost:9090/api/v1/write"
+            }
+        )");
+        APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+        APSARA_TEST_FALSE(flusher->mHttpsFlag);
+        APSARA_TEST_EQUAL("localhost", flusher->mHost);
+        APSARA_TEST_EQUAL(9090, flusher->mPort);
+        APSARA_TEST_EQUAL("/api/v1/write", flusher->mPath);
+        APSARA_TEST_TRUE(flusher->mHeaders.empty());
+        APSARA_TEST_EQUAL(CompressType::SNAPPY, flusher->mCompressor->GetCompressType());
+        APSARA_TEST_EQUAL(0U, flusher->mMaxSendRate);
+        APSARA_TEST_EQUAL(4U, flusher->mShardCnt);
+        auto keys = flusher->GetQueueKeys();
+        APSARA_TEST_EQUAL(4U, keys.size());
+        APSARA_TEST_EQUAL(flusher->GetQueueKey(), keys[0]);
+        for (auto key : keys) {
+            APSARA_TEST_NOT_EQUAL(nullptr, SenderQueueManager::GetInstance()->GetQueue(key));
+        }
+    }
+    {
+        // all params
+        auto flusher = CreateFlusher(R"(
+            {
+                "Type": "flusher_prometheus_native",
+                "Endpoint": "https://prometheus.example.com",
+                "Headers": {
+                    "Authorization": "Bearer token"
+                },
+                "ShardCount": 2,
+                "MaxSendRate": 1024
+            }
+        )");
+        APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+        APSARA_TEST_TRUE(flusher->mHttpsFlag);
+        APSARA_TEST_EQUAL("prometheus.example.com", flusher->mHost);
+        APSARA_TEST_EQUAL(443, flusher->mPort);
+        APSARA_TEST_EQUAL("/", flusher->mPath);
+        APSARA_TEST_EQUAL("Bearer token", flusher->mHeaders["Authorization"]);
+        APSARA_TEST_EQUAL(2U, flusher->mShardCnt);
+        APSARA_TEST_EQUAL(2U, flusher->GetQueueKeys().size());
+        APSARA_TEST_EQUAL(1024U, flusher->mMaxSendRate);
+    }
+    {
+        // invalid optional params
+        auto flusher = CreateFlusher(R"(
+            {
+                "Type": "flusher_prometheus_native",
+                "Endpoint": "http://localhost:9090/api/v1/write",
+                "ShardCount": 0
+            }
+        )");
+        APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+        APSARA_TEST_EQUAL(4U, flusher->mShardCnt);
+    }
+}
+
+void FlusherPrometheusUnittest::OnFailedInit() {
+    APSARA_TEST_EQUAL(nullptr, CreateFlusher(R"({"Type": "flusher_prometheus_native"})"));
+    APSARA_TEST_EQUAL(nullptr, CreateFlusher(R"({"Type": "flusher_prometheus_native", "Endpoint": true})"));
+    APSARA_TEST_EQUAL(nullptr,
+                      CreateFlusher(R"({"Type": "flusher_prometheus_native", "Endpoint": "http://:9090/write"})"));
+}
+
+void FlusherPrometheusUnittest::TestSend() {
+    auto flusher = CreateFlusher(R"(
+        {
+            "Type": "flusher_prometheus_native",
+            "Endpoint": "http://localhost:9090/api/v1/write"
+        }
+    )");
+    APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+    {
+        auto items = SendMetrics(*flusher, 10);
+        map<string, TimeSeries> allSeries;
+        map<QueueKey, size_t> seriesCntOfShard;
+        for (auto* item : items) {
+            for (auto& series : Decompress(*flusher, item)) {
+                // labels are sorted by name
+                APSARA_TEST_EQUAL(2U, series.mLabels.size());
+                APSARA_TEST_EQUAL("__name__", series.mLabels[0].first);
+                APSARA_TEST_EQUAL("cpu", series.mLabels[0].second);
+                APSARA_TEST_EQUAL("host", series.mLabels[1].first);
+                // each series is sent only once in the same batch
+                APSARA_TEST_EQUAL(0U, allSeries.count(series.mLabels[1].second));
+                ++seriesCntOfShard[item->mQueueKey];
+                allSeries[series.mLabels[1].second] = std::move(series);
+            }
+        }
+        APSARA_TEST_TRUE(seriesCntOfShard.size() > 1U);
+        APSARA_TEST_EQUAL(10U, allSeries.size());
+        // samples of the same series are grouped in order
+        const auto& samples = allSeries["host-0"].mSamples;
+        APSARA_TEST_EQUAL(11U, samples.size());
+        APSARA_TEST_EQUAL(0.0, samples[0].first);
+        APSARA_TEST_EQUAL(1234567890500, samples[0].second);
+        APSARA_TEST_EQUAL(9.0, samples.back().first);
+        APSARA_TEST_EQUAL(1234567899500, samples.back().second);
+        APSARA_TEST_EQUAL(1U, allSeries["host-5"].mSamples.size());
+        APSARA_TEST_EQUAL(5.0, allSeries["host-5"].mSamples[0].first);
+        for (auto* item : items) {
+            SenderQueueManager::GetInstance()->DecreaseConcurrencyLimiterInSendingCnt(item->mQueueKey);
+            SenderQueueManager::GetInstance()->RemoveItem(item->mQueueKey, item);
+        }
+    }
+    {
+        // multi-value metrics are sent as one series for each value, and other events are ignored
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        auto e = group.AddMetricEvent();
+        e->SetName("disk");
+        e->SetTimestamp(1234567890);
+        e->SetTag(string("device"), string("sda"));
+        e->SetTag(string("empty"), string(""));
+        e->SetValue(map<StringView, UntypedMultiDoubleValue>{
+            {"read_bytes", {UntypedValueMetricType::MetricTypeCounter, 1.0}},
+            {"write_bytes", {UntypedValueMetricType::MetricTypeCounter, 2.0}}});
+        group.AddLogEvent();
+        flusher->Send(std::move(group));
+        flusher->FlushAll();
+        vector<SenderQueueItem*> items;
+        SenderQueueManager::GetInstance()->GetAvailableItems(items, 80);
+        map<string, double> values;
+        for (auto* item : items) {
+            for (auto& series : Decompress(*flusher, item)) {
+                APSARA_TEST_EQUAL(2U, series.mLabels.size());
+                APSARA_TEST_EQUAL("device", series.mLabels[1].first);
+                APSARA_TEST_EQUAL(1U, series.mSamples.size());
+                values[series.mLabels[0].second] = series.mSamples[0].first;
+            }
+        }
+        APSARA_TEST_EQUAL(2U, values.size());
+        APSARA_TEST_EQUAL(1.0, values["disk_read_bytes"]);
+        APSARA_TEST_EQUAL(2.0, values["disk_write_bytes"]);
+    }
+}
+
+void FlusherPrometheusUnittest::TestSeriesCache() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    auto e1 = group.AddMetricEvent();
+    e1->SetName("cpu");
+    e1->SetTag(string("zone"), string("a"));
+    e1->SetTag(string("host"), string("host-1"));
+    auto e2 = group.AddMetricEvent();
+    e2->SetName("cpu");
+    e2->SetTag(string("host"), string("host-1"));
+    e2->SetTag(string("zone"), string("a"));
+    auto e3 = group.AddMetricEvent();
+    e3->SetName("cpu");
+    e3->SetTag(string("host"), string("host-2"));
+    e3->SetTag(string("zone"), string("a"));
+
+    // the order of tags does not matter
+    uint64_t hash = PrometheusSeriesCache::GetSeriesHash(*e1, StringView());
+    APSARA_TEST_EQUAL(hash, PrometheusSeriesCache::GetSeriesHash(*e2, StringView()));
+    APSARA_TEST_NOT_EQUAL(hash, PrometheusSeriesCache::GetSeriesHash(*e3, StringView()));
+    APSARA_TEST_NOT_EQUAL(hash, PrometheusSeriesCache::GetSeriesHash(*e1, StringView("total")));
+
+    PrometheusSeriesCache cache;
+    const auto* labels = cache.GetLabels(hash, *e1, StringView(), 100);
+    APSARA_TEST_NOT_EQUAL(nullptr, labels);
+    APSARA_TEST_EQUAL(labels, cache.GetLabels(hash, *e2, StringView(), 200));
+    APSARA_TEST_EQUAL(1U, cache.Size());
+    APSARA_TEST_EQUAL(labels->size(), cache.DataSize());
+    string expected;
+    PrometheusSeriesCache::EncodeLabels(*e2, StringView(), expected);
+    APSARA_TEST_EQUAL(expected, *labels);
+
+    // another series with the same hash is not interned
+    APSARA_TEST_EQUAL(nullptr, cache.GetLabels(hash, *e3, StringView(), 200));
+    APSARA_TEST_EQUAL(nullptr, cache.GetLabels(hash, *e1, StringView("total"), 200));
+    APSARA_TEST_EQUAL(1U, cache.Size());
+
+    APSARA_TEST_NOT_EQUAL(nullptr, cache.GetLabels(1, *e3, StringView(), 300));
+    APSARA_TEST_EQUAL(1U, cache.EvictExpired(350, 100));
+    APSARA_TEST_EQUAL(1U, cache.Size());
+    APSARA_TEST_EQUAL(0U, cache.EvictExpired(350, 100));
+    APSARA_TEST_EQUAL(1U, cache.EvictExpired(400, 100));
+    APSARA_TEST_EQUAL(0U, cache.Size());
+    APSARA_TEST_EQUAL(0U, cache.DataSize());
+}
+
+void FlusherPrometheusUnittest::TestBuildRequest() {
+    auto flusher = CreateFlusher(R"(
+        {
+            "Type": "flusher_prometheus_native",
+            "Endpoint": "https://prometheus.example.com:8443/api/v1/write",
+            "Headers": {
+                "Authorization": "Bearer token"
+            },
+            "ShardCount": 1
+        }
+    )");
+    APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+    auto items = SendMetrics(*flusher, 1);
+    APSARA_TEST_EQUAL(1U, items.size());
+
+    unique_ptr<HttpSinkRequest> req;
+    bool keepItem = false;
+    string errMsg;
+    APSARA_TEST_TRUE(flusher->BuildRequest(items[0], req, &keepItem, &errMsg));
+    APSARA_TEST_EQUAL(HTTP_POST, req->mMethod);
+    APSARA_TEST_TRUE(req->mHTTPSFlag);
+    APSARA_TEST_EQUAL("prometheus.example.com", req->mHost);
+    APSARA_TEST_EQUAL(8443, req->mPort);
+    APSARA_TEST_EQUAL("/api/v1/write", req->mUrl);
+    APSARA_TEST_EQUAL("", req->mQueryString);
+    APSARA_TEST_EQUAL(5U, req->mHeader.size());
+    APSARA_TEST_EQUAL("Bearer token", req->mHeader["Authorization"]);
+    APSARA_TEST_EQUAL(TYPE_LOG_PROTOBUF, req->mHeader[CONTENT_TYPE]);
+    APSARA_TEST_EQUAL("snappy", req->mHeader["Content-Encoding"]);
+    APSARA_TEST_EQUAL("0.1.0", req->mHeader["X-Prometheus-Remote-Write-Version"]);
+    APSARA_TEST_FALSE(req->mHeader[USER_AGENT].empty());
+    APSARA_TEST_EQUAL(items[0]->mData, req->mBody);
+    APSARA_TEST_EQUAL(items[0], req->mItem);
+    APSARA_TEST_EQUAL(1, flusher->mSendCnt->GetValue());
+}
+
+void FlusherPrometheusUnittest::TestOnSendDone() {
+    auto flusher = CreateFlusher(R"(
+        {
+            "Type": "flusher_prometheus_native",
+            "Endpoint": "http://localhost:9090/api/v1/write",
+            "ShardCount": 1
+        }
+    )");
+    APSARA_TEST_NOT_EQUAL(nullptr, flusher);
+    auto* queue = SenderQueueManager::GetInstance()->GetQueue(flusher->GetQueueKey());
+    {
+        // success
+        auto items = SendMetrics(*flusher, 1);
+        APSARA_TEST_EQUAL(1U, items.size());
+        HttpResponse response;
+        response.SetStatusCode(204);
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_TRUE(queue->Empty());
+        APSARA_TEST_EQUAL(1, flusher->mSuccessCnt->GetValue());
+    }
+    {
+        // network error and server errors are retried
+        auto items = SendMetrics(*flusher, 1);
+        APSARA_TEST_EQUAL(1U, items.size());
+        HttpResponse response;
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_EQUAL(SendingStatus::IDLE, items[0]->mStatus.load());
+        APSARA_TEST_EQUAL(2U, items[0]->mTryCnt);
+        APSARA_TEST_EQUAL(1, flusher->mNetworkErrorCnt->GetValue());
+
+        response.SetStatusCode(500);
+        items[0]->mStatus = SendingStatus::SENDING;
+        flusher->OnSendDone(response, items[0]);
+        response.SetStatusCode(429);
+        items[0]->mStatus = SendingStatus::SENDING;
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_EQUAL(SendingStatus::IDLE, items[0]->mStatus.load());
+        APSARA_TEST_EQUAL(2, flusher->mServerErrorCnt->GetValue());
+        APSARA_TEST_EQUAL(3, flusher->mRetryCnt->GetValue());
+        APSARA_TEST_FALSE(queue->Empty());
+
+        // other errors are not retried
+        response.SetStatusCode(400);
+        items[0]->mStatus = SendingStatus::SENDING;
+        flusher->OnSendDone(response, items[0]);
+        APSARA_TEST_TRUE(queue->Empty());
+        APSARA_TEST_EQUAL(1, flusher->mParamsErrorCnt->GetValue());
+        APSARA_TEST_EQUAL(1, flusher->mDiscardCnt->GetValue());
+    }
+    {
+        // the shard is in time fallback after failures, so the item is pushed directly instead of being fetched
+        auto item = make_unique<SenderQueueItem>("content", 7, flusher.get(), flusher->GetQueueKey());
+        auto* realItem = item.get();
+        APSARA_TEST_EQUAL(0, SenderQueueManager::GetInstance()->PushQueue(flusher->GetQueueKey(), std::move(item)));
+        HttpResponse response;
+        response.SetStatusCode(403);
+        flusher->OnSendDone(response, realItem);
+        APSARA_TEST_TRUE(queue->Empty());
+        APSARA_TEST_EQUAL(1, flusher->mUnauthErrorCnt->GetValue());
+        APSARA_TEST_EQUAL(2, flusher->mDiscardCnt->GetValue());
+    }
+}
+
+UNIT_TEST_CASE(FlusherPrometheusUnittest, OnSuccessfulInit)
+UNIT_TEST_CASE(FlusherPrometheusUnittest, OnFailedInit)
+UNIT_TEST_CASE(FlusherPrometheusUnittest, TestSend)
+UNIT_TEST_CASE(FlusherPrometheusUnittest, TestSeriesCache)
+UNIT_TEST_CASE(FlusherPrometheusUnittest, TestBuildRequest)
+UNIT_TEST_CASE(FlusherPrometheusUnittest, TestOnSendDone)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
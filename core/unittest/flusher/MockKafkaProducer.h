@@ -69,6 +69,20 @@ public:
         }
     }
 
+    void ProduceBatchAsync(const std::string& topic,
+                           const std::shared_ptr<std::string>& payload,
+                           const std::vector<BatchMessage>& messages,
+                           BatchCallback callback) override {
+        for (size_t i = 0; i < messages.size(); ++i) {
+            const auto& message = messages[i];
+            ProduceAsync(
+                topic,
+                payload->substr(message.offset, message.size),
+                [callback, i](bool success, const ErrorInfo& errorInfo) { callback(i, success, errorInfo); },
+                message.key);
+        }
+    }
+
     bool Flush(int timeoutMs) override {
         mFlushCalled = true;
 
@@ -80,6 +94,9 @@ public:
 
     void Close() override { mClosed = true; }
 
+    // requests not completed stand for messages waiting in the queue of the producer, e.g. when brokers are slow
+    size_t GetOutQueueLength() override { return mRequests.size(); }
+
     void SetInitSuccess(bool success) { mInitSuccess = success; }
     void SetFlushSuccess(bool success) { mFlushSuccess = success; }
     void SetAutoComplete(bool autoComplete) { mAutoComplete = autoComplete; }
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2025 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/StringTools.h"
+
+namespace logtail {
+
+// A local stand-in for an http receiver, which reads each request and answers 200 without decoding the body. Each
+// connection is served by its own thread.
+class StandInReceiver {
+public:
+    bool Start() {
+        mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (mListenFd < 0) {
+            return false;
+        }
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+        if (bind(mListenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(mListenFd, 128) != 0
+            || getsockname(mListenFd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            close(mListenFd);
+            return false;
+        }
+        mPort = ntohs(addr.sin_port);
+        mThread = std::thread(&StandInReceiver::Run, this);
+        return true;
+    }
+
+    void Stop() {
+        shutdown(mListenFd, SHUT_RDWR);
+        close(mListenFd);
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMux);
+            for (auto fd : mConnFds) {
+                shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (auto& t : mConnThreads) {
+            t.join();
+        }
+        for (auto fd : mConnFds) {
+            close(fd);
+        }
+        mConnThreads.clear();
+        mConnFds.clear();
+    }
+
+    int32_t GetPort() const { return mPort; }
+
+    std::atomic_size_t mRequestCnt{0};
+    std::atomic_size_t mBodyBytes{0};
+
+private:
+    void Run() {
+        while (true) {
+            int fd = accept(mListenFd, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mMux);
+            mConnFds.push_back(fd);
+            mConnThreads.emplace_back(&StandInReceiver::Serve, this, fd);
+        }
+    }
+
+    void Serve(int fd) {
+        static const std::string kContinue = "HTTP/1.1 100 Continue\r\n\r\n";
+        static const std::string kOK = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+        std::string buffer;
+        char tmp[64 * 1024];
+        while (true) {
+            auto headerEnd = buffer.find("\r\n\r\n");
+            while (headerEnd == std::string::npos) {
+                auto n = recv(fd, tmp, sizeof(tmp), 0);
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(tmp, n);
+                headerEnd = buffer.find("\r\n\r\n");
+            }
+            std::string header = ToLowerCaseString(buffer.substr(0, headerEnd));
+            size_t bodySize = 0;
+            auto pos = header.find("content-length:");
+            if (pos != std::string::npos) {
+                bodySize = std::stoul(header.substr(pos + strlen("content-length:")));
+            }
+            if (header.find("expect: 100-continue") != std::string::npos) {
+                send(fd, kContinue.data(), kContinue.size(), 0);
+            }
+            buffer.erase(0, headerEnd + 4);
+            while (buffer.size() < bodySize) {
+                auto n = recv(fd, tmp, sizeof(tmp), 0);
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(tmp, n);
+            }
+            buffer.erase(0, bodySize);
+            ++mRequestCnt;
+            mBodyBytes += bodySize;
+            send(fd, kOK.data(), kOK.size(), 0);
+        }
+    }
+
+    int mListenFd = -1;
+    int32_t mPort = 0;
+    std::thread mThread;
+    std::mutex mMux;
+    std::vector<int> mConnFds;
+    std::vector<std::thread> mConnThreads;
+};
+
+} // namespace logtail
@@ -0,0 +1,209 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ctime>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "host_monitor/Constants.h"
+#include "host_monitor/ProcessTable.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class FakeProcessEventSource : public ProcessEventSource {
+public:
+    bool Open() override { return mOpenResult; }
+    void Close() override { mClosed = true; }
+    bool Poll(std::vector<ProcessEvent>& events) override {
+        events.insert(events.end(), mPending.begin(), mPending.end());
+        mPending.clear();
+        return mPollResult;
+    }
+
+    bool mOpenResult = true;
+    bool mPollResult = true;
+    bool mClosed = false;
+    std::vector<ProcessEvent> mPending;
+};
+
+class ProcessTableUnittest : public testing::Test {
+public:
+    void TestPollingMode();
+    void TestEventMode();
+    void TestRescanOnLostEvents();
+    void TestFallbackWhenNotAvailable();
+    void TestFallbackWhenNoEventDelivered();
+    void TestFallbackOnPollFailures();
+
+protected:
+    void SetUp() override {
+        PROCESS_DIR = "./ProcessTableUnittestDir";
+        std::filesystem::create_directories(PROCESS_DIR / "1");
+        std::filesystem::create_directories(PROCESS_DIR / "2");
+        std::filesystem::create_directories(PROCESS_DIR / "self");
+        // process list is memoized by collect time, always ask for a newer one
+        mNow = time(nullptr) + 3600;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(PROCESS_DIR);
+        PROCESS_DIR = "/proc";
+    }
+
+    FakeProcessEventSource* createTable(std::unique_ptr<ProcessTable>& table) {
+        auto source = std::make_unique<FakeProcessEventSource>();
+        auto* ptr = source.get();
+        table = std::make_unique<ProcessTable>(std::move(source));
+        return ptr;
+    }
+
+    time_t mNow = 0;
+};
+
+void ProcessTableUnittest::TestPollingMode() {
+    ProcessTable table(nullptr);
+    APSARA_TEST_FALSE(table.IsEventDriven());
+    vector<pid_t> pids;
+    vector<pid_t> changed;
+    time_t collectTime = 0;
+    APSARA_TEST_TRUE(table.GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_TRUE(table.IsLastRescan());
+    std::sort(pids.begin(), pids.end());
+    APSARA_TEST_EQUAL(vector<pid_t>({1, 2}), pids);
+    APSARA_TEST_TRUE(changed.empty());
+
+    // the collect time of the memoized process list is returned instead of the requested time
+    time_t before = time(nullptr);
+    APSARA_TEST_TRUE(table.GetPids(mNow, pids, changed, collectTime));
+    APSARA_TEST_TRUE(collectTime >= before);
+    APSARA_TEST_TRUE(collectTime <= time(nullptr));
+}
+
+void ProcessTableUnittest::TestEventMode() {
+    std::unique_ptr<ProcessTable> table;
+    auto* source = createTable(table);
+    APSARA_TEST_TRUE(table->IsEventDriven());
+    vector<pid_t> pids;
+    vector<pid_t> changed;
+    time_t collectTime = 0;
+    // initial scan
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_TRUE(table->IsLastRescan());
+    APSARA_TEST_EQUAL(vector<pid_t>({1, 2}), pids);
+
+    // /proc is not scanned any more, the table follows events only
+    source->mPending = {{ProcessEventType::kFork, 3}, {ProcessEventType::kExit, 1}, {ProcessEventType::kExec, 2}};
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_FALSE(table->IsLastRescan());
+    APSARA_TEST_EQUAL(vector<pid_t>({2, 3}), pids);
+    std::sort(changed.begin(), changed.end());
+    APSARA_TEST_EQUAL(vector<pid_t>({2, 3}), changed);
+
+    // changed is reset after each call, a process created and exited in between is not reported
+    source->mPending = {{ProcessEventType::kFork, 4}, {ProcessEventType::kExit, 4}};
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_EQUAL(vector<pid_t>({2, 3}), pids);
+    APSARA_TEST_TRUE(changed.empty());
+
+    // periodic rescan fixes the drift
+    table->mLastRescanTime -= std::chrono::hours(1);
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_TRUE(table->IsLastRescan());
+    APSARA_TEST_TRUE(table->IsEventDriven());
+    APSARA_TEST_TRUE(table->mEventsVerified);
+    APSARA_TEST_EQUAL(vector<pid_t>({1, 2}), pids);
+}
+
+void ProcessTableUnittest::TestRescanOnLostEvents() {
+    std::unique_ptr<ProcessTable> table;
+    auto* source = createTable(table);
+    vector<pid_t> pids;
+    vector<pid_t> changed;
+    time_t collectTime = 0;
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+
+    std::filesystem::create_directories(PROCESS_DIR / "5");
+    source->mPollResult = false;
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_TRUE(table->IsLastRescan());
+    APSARA_TEST_TRUE(table->IsEventDriven());
+    APSARA_TEST_EQUAL(vector<pid_t>({1, 2, 5}), pids);
+
+    source->mPollResult = true;
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_FALSE(table->IsLastRescan());
+    APSARA_TEST_EQUAL(0, table->mPollFailures);
+}
+
+void ProcessTableUnittest::TestFallbackWhenNotAvailable() {
+    auto source = std::make_unique<FakeProcessEventSource>();
+    source->mOpenResult = false;
+    ProcessTable table(std::move(source));
+    APSARA_TEST_FALSE(table.IsEventDriven());
+    vector<pid_t> pids;
+    vector<pid_t> changed;
+    time_t collectTime = 0;
+    APSARA_TEST_TRUE(table.GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_EQUAL(2UL, pids.size());
+}
+
+void ProcessTableUnittest::TestFallbackWhenNoEventDelivered() {
+    std::unique_ptr<ProcessTable> table;
+    createTable(table);
+    vector<pid_t> pids;
+    vector<pid_t> changed;
+    time_t collectTime = 0;
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+
+    // e.g. the agent runs in a non-initial pid namespace, subscription succeeds but nothing is delivered
+    std::filesystem::create_directories(PROCESS_DIR / "6");
+    table->mLastRescanTime -= std::chrono::hours(1);
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_FALSE(table->IsEventDriven());
+    APSARA_TEST_TRUE(table->IsLastRescan());
+    APSARA_TEST_EQUAL(vector<pid_t>({1, 2, 6}), pids);
+}
+
+void ProcessTableUnittest::TestFallbackOnPollFailures() {
+    std::unique_ptr<ProcessTable> table;
+    auto* source = createTable(table);
+    vector<pid_t> pids;
+    vector<pid_t> changed;
+    time_t collectTime = 0;
+    source->mPollResult = false;
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_TRUE(table->IsEventDriven());
+    APSARA_TEST_TRUE(table->GetPids(++mNow, pids, changed, collectTime));
+    APSARA_TEST_FALSE(table->IsEventDriven());
+    std::sort(pids.begin(), pids.end());
+    APSARA_TEST_EQUAL(vector<pid_t>({1, 2}), pids);
+}
+
+UNIT_TEST_CASE(ProcessTableUnittest, TestPollingMode);
+UNIT_TEST_CASE(ProcessTableUnittest, TestEventMode);
+UNIT_TEST_CASE(ProcessTableUnittest, TestRescanOnLostEvents);
+UNIT_TEST_CASE(ProcessTableUnittest, TestFallbackWhenNotAvailable);
+UNIT_TEST_CASE(ProcessTableUnittest, TestFallbackWhenNoEventDelivered);
+UNIT_TEST_CASE(ProcessTableUnittest, TestFallbackOnPollFailures);
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -12,16 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "metadata/K8sMetadata.h"
 #include "models/PipelineEventGroup.h"
 #include "unittest/Unittest.h"
+#include "unittest/metadata/MockMetadataServer.h"
 
 using namespace std;
 
+DECLARE_FLAG_INT32(k8s_metadata_cache_ttl);
+DECLARE_FLAG_INT32(k8s_metadata_negative_cache_ttl);
+DECLARE_FLAG_INT32(k8s_metadata_max_batch_size);
+
 namespace logtail {
 class k8sMetadataUnittest : public ::testing::Test {
 protected:
@@ -33,6 +41,37 @@ protected:
         // Clean up after each test case if needed
     }
 
+    // points the metadata client to a local stand-in server
+    void useMockServer(const MockMetadataServer& server) {
+        auto& k8sMetadata = K8sMetadata::GetInstance();
+        mServiceHost = k8sMetadata.mServiceHost;
+        mServicePort = k8sMetadata.mServicePort;
+        k8sMetadata.mServiceHost = "127.0.0.1";
+        k8sMetadata.mServicePort = server.GetPort();
+        k8sMetadata.mSendRequestInUnitTest = true;
+        k8sMetadata.UpdateStatus(true);
+    }
+
+    void resetMockServer() {
+        auto& k8sMetadata = K8sMetadata::GetInstance();
+        k8sMetadata.mSendRequestInUnitTest = false;
+        k8sMetadata.mServiceHost = mServiceHost;
+        k8sMetadata.mServicePort = mServicePort;
+    }
+
+    static bool waitFor(const std::function<bool()>& pred) {
+        for (int i = 0; i < 100; ++i) {
+            if (pred()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        return false;
+    }
+
+    std::string mServiceHost;
+    int32_t mServicePort = 0;
+
 public:
     void TestAsyncQueryMetadata() {
         // AsyncQueryMetadata, will add to pending queue and batch keys
@@ -308,6 +347,117 @@ public:
         APSARA_TEST_EQUAL(req->mMethod, "GET");
         APSARA_TEST_EQUAL(req->mUrl, "/metadata/host");
     }
+
+    void TestSingleFlightAndNegativeCache() {
+        MockMetadataServer server({"cid-known"});
+        APSARA_TEST_TRUE_FATAL(server.Start());
+        useMockServer(server);
+        auto& k8sMetadata = K8sMetadata::GetInstance();
+
+        // concurrent misses of the same keys, as the ebpf handlers do
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&k8sMetadata]() {
+                for (int j = 0; j < 100; ++j) {
+                    for (const std::string cid : {"cid-known", "cid-missing"}) {
+                        if (k8sMetadata.GetInfoByContainerIdFromCache(cid) == nullptr) {
+                            k8sMetadata.AsyncQueryMetadata(PodInfoType::ContainerIdInfo, cid);
+                        }
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        APSARA_TEST_TRUE(waitFor([&]() {
+            return k8sMetadata.GetInfoByContainerIdFromCache("cid-known") != nullptr
+                && k8sMetadata.IsMissingContainerId("cid-missing");
+        }));
+        APSARA_TEST_EQUAL(1U, server.GetQueriedKeyCount("/metadata/containerid", "cid-known"));
+        APSARA_TEST_EQUAL(1U, server.GetQueriedKeyCount("/metadata/containerid", "cid-missing"));
+
+        // the unknown container id is not queried again within the ttl
+        auto negativeHits = k8sMetadata.mNegativeCacheHitTotal->GetValue();
+        k8sMetadata.AsyncQueryMetadata(PodInfoType::ContainerIdInfo, "cid-missing");
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        APSARA_TEST_EQUAL(negativeHits + 1, k8sMetadata.mNegativeCacheHitTotal->GetValue());
+        APSARA_TEST_EQUAL(1U, server.GetQueriedKeyCount("/metadata/containerid", "cid-missing"));
+
+        // and is queried again once expired
+        int32_t negativeTtl = INT32_FLAG(k8s_metadata_negative_cache_ttl);
+        INT32_FLAG(k8s_metadata_negative_cache_ttl) = 0;
+        k8sMetadata.AsyncQueryMetadata(PodInfoType::ContainerIdInfo, "cid-missing");
+        APSARA_TEST_TRUE(
+            waitFor([&]() { return server.GetQueriedKeyCount("/metadata/containerid", "cid-missing") == 2; }));
+        INT32_FLAG(k8s_metadata_negative_cache_ttl) = negativeTtl;
+        resetMockServer();
+    }
+
+    void TestMaxBatchSize() {
+        std::set<std::string> cids;
+        for (int i = 0; i < 35; ++i) {
+            cids.insert("cid-batch-" + std::to_string(i));
+        }
+        MockMetadataServer server(cids);
+        APSARA_TEST_TRUE_FATAL(server.Start());
+        useMockServer(server);
+        auto& k8sMetadata = K8sMetadata::GetInstance();
+        int32_t maxBatchSize = INT32_FLAG(k8s_metadata_max_batch_size);
+        INT32_FLAG(k8s_metadata_max_batch_size) = 10;
+
+        for (const auto& cid : cids) {
+            k8sMetadata.AsyncQueryMetadata(PodInfoType::ContainerIdInfo, cid);
+        }
+        APSARA_TEST_TRUE(waitFor([&]() {
+            for (const auto& cid : cids) {
+                if (k8sMetadata.GetInfoByContainerIdFromCache(cid) == nullptr) {
+                    return false;
+                }
+            }
+            return true;
+        }));
+        size_t keyCount = 0;
+        auto requests = server.GetRequests("/metadata/containerid");
+        for (const auto& request : requests) {
+            APSARA_TEST_TRUE(request.mKeys.size() <= 10U);
+            keyCount += request.mKeys.size();
+        }
+        APSARA_TEST_TRUE(requests.size() >= 4U);
+        APSARA_TEST_EQUAL(35U, keyCount);
+
+        INT32_FLAG(k8s_metadata_max_batch_size) = maxBatchSize;
+        resetMockServer();
+    }
+
+    void TestCacheTtl() {
+        MockMetadataServer server({"cid-stale"});
+        APSARA_TEST_TRUE_FATAL(server.Start());
+        useMockServer(server);
+        auto& k8sMetadata = K8sMetadata::GetInstance();
+
+        auto info = std::make_shared<K8sPodInfo>();
+        info->mNamespace = "stale";
+        info->mTimestamp = time(nullptr) - INT32_FLAG(k8s_metadata_cache_ttl) - 1;
+        k8sMetadata.SetContainerCache("cid-stale", info);
+
+        // the stale info is returned while it is refreshed in background
+        auto cached = k8sMetadata.GetInfoByContainerIdFromCache("cid-stale");
+        APSARA_TEST_TRUE_FATAL(cached != nullptr);
+        APSARA_TEST_EQUAL("stale", cached->mNamespace);
+        APSARA_TEST_TRUE(waitFor(
+            [&]() { return k8sMetadata.GetInfoByContainerIdFromCache("cid-stale")->mNamespace == "default"; }));
+        APSARA_TEST_EQUAL(1U, server.GetQueriedKeyCount("/metadata/containerid", "cid-stale"));
+
+        // a stale info whose container is gone is dropped once the refresh reports it as missing
+        k8sMetadata.SetContainerCache("cid-gone", info);
+        APSARA_TEST_TRUE(k8sMetadata.GetInfoByContainerIdFromCache("cid-gone") != nullptr);
+        APSARA_TEST_TRUE(waitFor([&]() { return k8sMetadata.GetInfoByContainerIdFromCache("cid-gone") == nullptr; }));
+        APSARA_TEST_TRUE(k8sMetadata.IsMissingContainerId("cid-gone"));
+        APSARA_TEST_EQUAL(1U, server.GetQueriedKeyCount("/metadata/containerid", "cid-gone"));
+        resetMockServer();
+    }
 };
 
 APSARA_UNIT_TEST_CASE(k8sMetadataUnittest, TestGetByContainerIds, 0);
@@ -316,6 +466,9 @@ APSARA_UNIT_TEST_CASE(k8sMetadataUnittest, TestExternalIpOperations, 2);
 APSARA_UNIT_TEST_CASE(k8sMetadataUnittest, TestAsyncQueryMetadata, 3);
 APSARA_UNIT_TEST_CASE(k8sMetadataUnittest, TestNetworkCheck, 4);
 APSARA_UNIT_TEST_CASE(k8sMetadataUnittest, TestBuildAsyncQuery, 5);
+APSARA_UNIT_TEST_CASE(k8sMetadataUnittest, TestSingleFlightAndNegativeCache, 6);
+APSARA_UNIT_TEST_CASE(k8sMetadataUnittest, TestMaxBatchSize, 7);
+APSARA_UNIT_TEST_CASE(k8sMetadataUnittest, TestCacheTtl, 8);
 
 } // end of namespace logtail
 
@@ -0,0 +1,190 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "json/json.h"
+
+namespace logtail {
+
+// Local stand-in of the k8s metadata server. Answers each request with the pod info of the known keys in its body,
+// one connection per request.
+class MockMetadataServer {
+public:
+    struct Request {
+        std::string mPath;
+        std::vector<std::string> mKeys;
+    };
+
+    explicit MockMetadataServer(std::set<std::string> knownKeys) : mKnownKeys(std::move(knownKeys)) {}
+    ~MockMetadataServer() { Stop(); }
+
+    bool Start() {
+        mListenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (mListenFd < 0) {
+            return false;
+        }
+        int opt = 1;
+        setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+        if (bind(mListenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(mListenFd, 64) != 0
+            || getsockname(mListenFd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            close(mListenFd);
+            mListenFd = -1;
+            return false;
+        }
+        mPort = ntohs(addr.sin_port);
+        mRunning = true;
+        mThread = std::thread(&MockMetadataServer::serve, this);
+        return true;
+    }
+
+    void Stop() {
+        mRunning = false;
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+        if (mListenFd >= 0) {
+            close(mListenFd);
+            mListenFd = -1;
+        }
+    }
+
+    int32_t GetPort() const { return mPort; }
+
+    std::vector<Request> GetRequests(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mMux);
+        std::vector<Request> res;
+        for (const auto& request : mRequests) {
+            if (request.mPath == path) {
+                res.push_back(request);
+            }
+        }
+        return res;
+    }
+
+    size_t GetQueriedKeyCount(const std::string& path, const std::string& key) {
+        size_t count = 0;
+        for (const auto& request : GetRequests(path)) {
+            for (const auto& k : request.mKeys) {
+                count += k == key;
+            }
+        }
+        return count;
+    }
+
+private:
+    void serve() {
+        while (mRunning) {
+            pollfd pfd{mListenFd, POLLIN, 0};
+            if (poll(&pfd, 1, 50) <= 0) {
+                continue;
+            }
+            int fd = accept(mListenFd, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            handle(fd);
+            close(fd);
+        }
+    }
+
+    void handle(int fd) {
+        std::string data;
+        char buf[4096];
+        size_t headerEnd = std::string::npos;
+        size_t contentLength = 0;
+        while (true) {
+            if (headerEnd != std::string::npos && data.size() >= headerEnd + 4 + contentLength) {
+                break;
+            }
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                return;
+            }
+            data.append(buf, n);
+            if (headerEnd == std::string::npos && (headerEnd = data.find("\r\n\r\n")) != std::string::npos) {
+                auto pos = data.find("Content-Length:");
+                if (pos != std::string::npos && pos < headerEnd) {
+                    contentLength = std::strtoul(data.c_str() + pos + 15, nullptr, 10);
+                }
+            }
+        }
+
+        Request request;
+        auto pathBegin = data.find(' ') + 1;
+        request.mPath = data.substr(pathBegin, data.find(' ', pathBegin) - pathBegin);
+        Json::Value root;
+        std::string reqBody = data.substr(headerEnd + 4, contentLength);
+        std::string errors;
+        Json::CharReaderBuilder readerBuilder;
+        std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+        reader->parse(reqBody.data(), reqBody.data() + reqBody.size(), &root, &errors);
+        Json::Value resp(Json::objectValue);
+        for (const auto& key : root["keys"]) {
+            request.mKeys.push_back(key.asString());
+            if (mKnownKeys.count(key.asString())) {
+                Json::Value info;
+                info["namespace"] = "default";
+                info["workloadName"] = "workload-" + key.asString();
+                info["workloadKind"] = "deployment";
+                info["labels"] = Json::Value(Json::objectValue);
+                info["images"] = Json::Value(Json::objectValue);
+                info["podIP"] = key.asString();
+                info["podName"] = "pod-" + key.asString();
+                resp[key.asString()] = info;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMux);
+            mRequests.push_back(std::move(request));
+        }
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        std::string body = Json::writeString(writer, resp);
+        std::string out = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: "
+            + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        send(fd, out.data(), out.size(), MSG_NOSIGNAL);
+    }
+
+    std::set<std::string> mKnownKeys;
+    int mListenFd = -1;
+    int32_t mPort = 0;
+    std::atomic_bool mRunning{false};
+    std::thread mThread;
+    std::mutex mMux;
+    std::vector<Request> mRequests;
+};
+
+} // namespace logtail
@@ -55,6 +55,10 @@ public:
         ClearRequests();
     }
 
+    bool AddRequest(std::unique_ptr<HttpSinkRequest>&& request) override {
+        return Sink<HttpSinkRequest>::AddRequest(std::move(request));
+    }
+
     void Run() {
         LOG_INFO(sLogger, ("http sink mock", "started"));
         while (true) {
@@ -94,6 +98,7 @@ private:
     HttpSinkMock() = default;
     ~HttpSinkMock() = default;
 
+    std::future<void> mThreadRes;
     std::atomic_bool mIsFlush = false;
     mutable std::mutex mMutex;
     std::vector<SenderQueueItem> mRequests;
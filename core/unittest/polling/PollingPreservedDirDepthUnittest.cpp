@@ -1,6 +1,7 @@
 
 #include <chrono> // Include the <chrono> header for sleep_for
 #include <filesystem>
+#include <fstream>
 #include <thread> // Include the <thread> header for this_thread
 
 #include "json/json.h"
@@ -331,6 +332,36 @@ public:
         // Should remain unregistered after checkpoint
         APSARA_TEST_FALSE_FATAL(isFileDirRegistered(testFile));
     }
+
+    void TestDirEntriesReuse() {
+        auto dirPath = gRootDir + "reuse";
+        bfs::create_directories(dirPath);
+        { ofstream(dirPath + PATH_SEPARATOR + "0.log"); }
+        filesystem::last_write_time(dirPath, filesystem::last_write_time(dirPath) - chrono::seconds(10));
+
+        auto listDir = [&]() -> shared_ptr<const vector<fsutil::Entry>> {
+            fsutil::PathStat statBuf;
+            APSARA_TEST_TRUE(fsutil::PathStat::stat(dirPath, statBuf));
+            fsutil::Dir dir(dirPath);
+            APSARA_TEST_TRUE(dir.Open());
+            return PollingDirFile::GetInstance()->ListDirEntries(dir, dirPath, &statBuf);
+        };
+        // unchanged dir, entries listed in the first round are reused
+        auto entries = listDir();
+        APSARA_TEST_EQUAL(1U, entries->size());
+        APSARA_TEST_EQUAL(entries.get(), listDir().get());
+
+        // new entry changes the mtime of the dir
+        { ofstream(dirPath + PATH_SEPARATOR + "1.log"); }
+        auto newEntries = listDir();
+        APSARA_TEST_EQUAL(2U, newEntries->size());
+        APSARA_TEST_NOT_EQUAL(entries.get(), newEntries.get());
+        // the dir is just changed, entries are not reused in case the mtime is not updated by following changes
+        APSARA_TEST_NOT_EQUAL(newEntries.get(), listDir().get());
+
+        PollingDirFile::GetInstance()->ClearCache();
+        APSARA_TEST_TRUE(PollingDirFile::GetInstance()->mDirEntriesCacheMap.empty());
+    }
 };
 
 UNIT_TEST_CASE(PollingPreservedDirDepthUnittest, TestPollingDirFile0);
@@ -340,6 +371,7 @@ UNIT_TEST_CASE(PollingPreservedDirDepthUnittest, TestPollingDirFile3);
 UNIT_TEST_CASE(PollingPreservedDirDepthUnittest, TestPollingDirFile4);
 UNIT_TEST_CASE(PollingPreservedDirDepthUnittest, TestPollingDirFile5);
 UNIT_TEST_CASE(PollingPreservedDirDepthUnittest, TestCheckpoint);
+UNIT_TEST_CASE(PollingPreservedDirDepthUnittest, TestDirEntriesReuse);
 
 std::string PollingPreservedDirDepthUnittest::gRootDir;
 std::string PollingPreservedDirDepthUnittest::gCheckpoint = "checkpoint";
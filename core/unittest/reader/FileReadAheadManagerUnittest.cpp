@@ -0,0 +1,166 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
+#include "file_server/reader/FileReadAheadManager.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_BOOL(enable_file_read_ahead);
+DECLARE_FLAG_INT32(file_read_ahead_max_inflight);
+
+using namespace std;
+
+namespace logtail {
+
+class FileReadAheadManagerUnittest : public ::testing::Test {
+public:
+    void TestReadAhead();
+    void TestInflightLimit();
+    void TestDisabled();
+    void TestFileClosedBeforeCompletion();
+    void TestConcurrentWait();
+
+protected:
+    void SetUp() override {
+        mFilePath = "file_read_ahead_unittest.log";
+        mContent.clear();
+        for (int i = 0; i < 10000; ++i) {
+            mContent += "line " + to_string(i) + "\n";
+        }
+        ofstream(mFilePath, ios::binary) << mContent;
+        mFd = open(mFilePath.c_str(), O_RDONLY);
+        BOOL_FLAG(enable_file_read_ahead) = true;
+        mManager = FileReadAheadManager::GetInstance();
+        if (!mManager->IsEnabled()) {
+            GTEST_SKIP() << "io_uring is unavailable";
+        }
+    }
+
+    void TearDown() override {
+        BOOL_FLAG(enable_file_read_ahead) = false;
+        INT32_FLAG(file_read_ahead_max_inflight) = 32;
+        close(mFd);
+        remove(mFilePath.c_str());
+    }
+
+    string mFilePath;
+    string mContent;
+    int mFd = -1;
+    FileReadAheadManager* mManager = nullptr;
+};
+
+void FileReadAheadManagerUnittest::TestReadAhead() {
+    auto readAhead = mManager->Submit(mFd, 100, 4096);
+    APSARA_TEST_TRUE_FATAL(readAhead != nullptr);
+    APSARA_TEST_EQUAL(4096, mManager->Wait(*readAhead));
+    APSARA_TEST_EQUAL(mContent.substr(100, 4096), string(readAhead->mBuffer.get(), 4096));
+
+    // short read at the end of file
+    readAhead = mManager->Submit(mFd, mContent.size() - 10, 4096);
+    APSARA_TEST_TRUE_FATAL(readAhead != nullptr);
+    APSARA_TEST_EQUAL(10, mManager->Wait(*readAhead));
+    APSARA_TEST_EQUAL(mContent.substr(mContent.size() - 10), string(readAhead->mBuffer.get(), 10));
+    APSARA_TEST_EQUAL(0U, mManager->GetInflightCount());
+}
+
+void FileReadAheadManagerUnittest::TestInflightLimit() {
+    INT32_FLAG(file_read_ahead_max_inflight) = 2;
+    // requests dropped by readers are kept until completed
+    mManager->Submit(mFd, 0, 1024);
+    auto readAhead = mManager->Submit(mFd, 1024, 1024);
+    APSARA_TEST_TRUE_FATAL(readAhead != nullptr);
+    if (mManager->GetInflightCount() == 2) {
+        APSARA_TEST_TRUE(mManager->Submit(mFd, 2048, 1024) == nullptr);
+    }
+    APSARA_TEST_EQUAL(1024, mManager->Wait(*readAhead));
+    while (mManager->GetInflightCount() > 0) {
+        usleep(1000);
+    }
+    readAhead = mManager->Submit(mFd, 2048, 1024);
+    APSARA_TEST_TRUE_FATAL(readAhead != nullptr);
+    APSARA_TEST_EQUAL(1024, mManager->Wait(*readAhead));
+    APSARA_TEST_EQUAL(mContent.substr(2048, 1024), string(readAhead->mBuffer.get(), 1024));
+}
+
+void FileReadAheadManagerUnittest::TestDisabled() {
+    BOOL_FLAG(enable_file_read_ahead) = false;
+    APSARA_TEST_FALSE(mManager->IsEnabled());
+    APSARA_TEST_TRUE(mManager->Submit(mFd, 0, 1024) == nullptr);
+}
+
+void FileReadAheadManagerUnittest::TestFileClosedBeforeCompletion() {
+    int fd = open(mFilePath.c_str(), O_RDONLY);
+    APSARA_TEST_TRUE_FATAL(fd >= 0);
+    auto readAhead = mManager->Submit(fd, 0, 4096);
+    APSARA_TEST_TRUE_FATAL(readAhead != nullptr);
+    // the reader closes its file and the fd number is reused by another file before the read completes
+    close(fd);
+    string otherPath = mFilePath + ".other";
+    ofstream(otherPath, ios::binary) << string(4096, 'x');
+    int otherFd = open(otherPath.c_str(), O_RDONLY);
+    APSARA_TEST_EQUAL(4096, mManager->Wait(*readAhead));
+    APSARA_TEST_EQUAL(mContent.substr(0, 4096), string(readAhead->mBuffer.get(), 4096));
+    // the duplicated fd is closed once the read completes
+    APSARA_TEST_EQUAL(-1, readAhead->mFd);
+    close(otherFd);
+    remove(otherPath.c_str());
+}
+
+void FileReadAheadManagerUnittest::TestConcurrentWait() {
+    const size_t threadCnt = 4;
+    const size_t readCnt = 100;
+    vector<thread> threads;
+    atomic_size_t failures = 0;
+    for (size_t i = 0; i < threadCnt; ++i) {
+        threads.emplace_back([&, i]() {
+            for (size_t j = 0; j < readCnt; ++j) {
+                int64_t offset = static_cast<int64_t>((i * readCnt + j) * 64 % (mContent.size() - 1024));
+                auto readAhead = mManager->Submit(mFd, offset, 1024);
+                if (readAhead == nullptr) {
+                    continue;
+                }
+                if (mManager->Wait(*readAhead) != 1024
+                    || string(readAhead->mBuffer.get(), 1024) != mContent.substr(offset, 1024)) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    APSARA_TEST_EQUAL(0U, failures.load());
+    APSARA_TEST_EQUAL(0U, mManager->GetInflightCount());
+}
+
+UNIT_TEST_CASE(FileReadAheadManagerUnittest, TestReadAhead)
+UNIT_TEST_CASE(FileReadAheadManagerUnittest, TestInflightLimit)
+UNIT_TEST_CASE(FileReadAheadManagerUnittest, TestDisabled)
+UNIT_TEST_CASE(FileReadAheadManagerUnittest, TestFileClosedBeforeCompletion)
+UNIT_TEST_CASE(FileReadAheadManagerUnittest, TestConcurrentWait)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -25,6 +25,7 @@
 #include "unittest/Unittest.h"
 
 DECLARE_FLAG_INT32(force_release_deleted_file_fd_timeout);
+DECLARE_FLAG_BOOL(enable_file_read_ahead);
 
 namespace logtail {
 
@@ -70,6 +71,7 @@ public:
     void TestReadGBK();
     void TestReadUTF8();
     void TestSetExpectedFileSize();
+    void TestReadUTF8WithReadAhead();
 
     std::unique_ptr<char[]> expectedContent;
     static std::string logPathDir;
@@ -86,6 +88,7 @@ protected:
 UNIT_TEST_CASE(LogFileReaderUnittest, TestReadGBK);
 UNIT_TEST_CASE(LogFileReaderUnittest, TestReadUTF8);
 UNIT_TEST_CASE(LogFileReaderUnittest, TestSetExpectedFileSize);
+UNIT_TEST_CASE(LogFileReaderUnittest, TestReadUTF8WithReadAhead);
 
 std::string LogFileReaderUnittest::logPathDir;
 std::string LogFileReaderUnittest::gbkFile;
@@ -727,6 +730,51 @@ void LogFileReaderUnittest::TestSetExpectedFileSize() {
     }
 }
 
+void LogFileReaderUnittest::TestReadUTF8WithReadAhead() {
+    // reads the file chunk by chunk the way ReadLog does, with the next chunk read ahead if there is more data
+    auto readAll = [&](bool& hasReadAhead) {
+        MultilineOptions multilineOpts;
+        FileReaderOptions readerOpts;
+        readerOpts.mInputType = FileReaderOptions::InputType::InputFile;
+        LogFileReader reader(logPathDir,
+                             utf8File,
+                             DevInode(),
+                             std::make_pair(&readerOpts, &ctx),
+                             std::make_pair(&multilineOpts, &ctx),
+                             std::make_pair(&fileTagOpts, &ctx));
+        LogFileReader::BUFFER_SIZE = 64;
+        reader.UpdateReaderManual();
+        reader.InitReader(true, LogFileReader::BACKWARD_TO_BEGINNING);
+        reader.CheckFileSignatureAndOffset(true);
+        int64_t fileSize = reader.mLogFileOp.GetFileSize();
+        std::string content;
+        bool moreData = true;
+        while (moreData) {
+            LogBuffer logBuffer;
+            reader.ReadUTF8(logBuffer, fileSize, moreData);
+            content.append(logBuffer.rawBuffer.data(), logBuffer.rawBuffer.size()).append("\n");
+            if (moreData) {
+                reader.submitReadAhead();
+                hasReadAhead |= reader.mReadAhead != nullptr;
+            }
+        }
+        return content;
+    };
+
+    bool hasReadAhead = false;
+    BOOL_FLAG(enable_file_read_ahead) = false;
+    std::string expected = readAll(hasReadAhead);
+    APSARA_TEST_FALSE(hasReadAhead);
+
+    BOOL_FLAG(enable_file_read_ahead) = true;
+    // io_uring may be unavailable, e.g. forbidden by seccomp, then reads fall back to pread
+    bool enabled = FileReadAheadManager::GetInstance()->IsEnabled();
+    std::string actual = readAll(hasReadAhead);
+    BOOL_FLAG(enable_file_read_ahead) = false;
+    APSARA_TEST_EQUAL(expected, actual);
+    APSARA_TEST_EQUAL(enabled, hasReadAhead);
+}
+
 class LogMultiBytesUnittest : public ::testing::Test {
 public:
     static void SetUpTestCase() {
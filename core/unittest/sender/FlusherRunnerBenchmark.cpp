@@ -0,0 +1,106 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef APSARA_UNIT_TEST_MAIN
+#define APSARA_UNIT_TEST_MAIN
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "runner/FlusherRunner.h"
+#include "runner/sink/http/HttpSink.h"
+#include "unittest/Unittest.h"
+#include "unittest/pipeline/HttpSinkMock.h"
+#include "unittest/plugin/PluginMock.h"
+
+using namespace std;
+
+namespace logtail {
+
+// records the latency from the time the item is handed to FlusherRunner to the time the request is done
+class FlusherHttpLatencyMock : public FlusherHttpMock {
+public:
+    bool BuildRequest(SenderQueueItem* item,
+                      unique_ptr<HttpSinkRequest>& req,
+                      [[maybe_unused]] bool* keepItem,
+                      [[maybe_unused]] string* errMsg) override {
+        req = make_unique<HttpSinkRequest>("", false, "", 80, "", "", map<string, string>(), "", item);
+        return true;
+    }
+
+    void OnSendDone([[maybe_unused]] const HttpResponse& response, SenderQueueItem* item) override {
+        auto latency = chrono::system_clock::now() - item->mFirstEnqueTime;
+        lock_guard<mutex> lock(mMux);
+        mLatencies.push_back(chrono::duration_cast<chrono::microseconds>(latency).count());
+    }
+
+    mutex mMux;
+    vector<int64_t> mLatencies;
+};
+
+// Measures the end-to-end latency of items pushed to http sink by FlusherRunner when the global send concurrency is
+// exceeded, i.e. the time the pusher waits for requests in flight to be done plus the time of sending. The http sink
+// is mocked, which completes each request at once, so that only the waiting in FlusherRunner is measured.
+class FlusherRunnerBenchmark : public ::testing::Test {
+public:
+    void TestPushToHttpSinkLatency();
+
+protected:
+    static void SetUpTestCase() { AppConfig::GetInstance()->mSendRequestGlobalConcurrency = kConcurrency; }
+
+    void SetUp() override { HttpSinkMock::GetInstance()->Init(); }
+
+    void TearDown() override { HttpSinkMock::GetInstance()->Stop(); }
+
+private:
+    static const int32_t kConcurrency = 16;
+    static const size_t kItemCnt = 20000;
+};
+
+void FlusherRunnerBenchmark::TestPushToHttpSinkLatency() {
+    FlusherHttpLatencyMock flusher;
+    vector<unique_ptr<SenderQueueItem>> items;
+    items.reserve(kItemCnt);
+    for (size_t i = 0; i < kItemCnt; ++i) {
+        items.emplace_back(make_unique<SenderQueueItem>("content", 7, &flusher, 0));
+    }
+
+    auto start = chrono::system_clock::now();
+    for (auto& item : items) {
+        item->mFirstEnqueTime = chrono::system_clock::now();
+        APSARA_TEST_TRUE(FlusherRunner::GetInstance()->PushToHttpSink(item.get()));
+    }
+    while (FlusherRunner::GetInstance()->GetSendingBufferCount() > 0) {
+        this_thread::yield();
+    }
+    double elapsed = chrono::duration<double>(chrono::system_clock::now() - start).count();
+
+    auto& latencies = flusher.mLatencies;
+    APSARA_TEST_EQUAL(kItemCnt, latencies.size());
+    sort(latencies.begin(), latencies.end());
+    cout << "items/s: " << kItemCnt / elapsed << ", latency p50: " << latencies[latencies.size() / 2]
+         << "us, p99: " << latencies[latencies.size() * 99 / 100] << "us, max: " << latencies.back() << "us" << endl;
+    HttpSinkMock::GetInstance()->ClearRequests();
+}
+
+UNIT_TEST_CASE(FlusherRunnerBenchmark, TestPushToHttpSinkLatency)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <future>
+
 #include "collection_pipeline/plugin/PluginRegistry.h"
 #include "collection_pipeline/queue/SenderQueueManager.h"
 #include "runner/FlusherRunner.h"
@@ -21,6 +23,7 @@
 #include "unittest/plugin/PluginMock.h"
 
 DECLARE_FLAG_INT32(discard_send_fail_interval);
+DECLARE_FLAG_INT32(flusher_runner_sending_cnt_wait_ms);
 
 using namespace std;
 
@@ -30,6 +33,7 @@ class FlusherRunnerUnittest : public ::testing::Test {
 public:
     void TestDispatch();
     void TestPushToHttpSink();
+    void TestPushToHttpSinkWithLimit();
 
 protected:
     static void SetUpTestCase() { AppConfig::GetInstance()->mSendRequestGlobalConcurrency = 10; }
@@ -142,8 +146,40 @@ void FlusherRunnerUnittest::TestPushToHttpSink() {
     }
 }
 
+void FlusherRunnerUnittest::TestPushToHttpSinkWithLimit() {
+    auto flusher = make_unique<FlusherHttpMock>();
+    Json::Value tmp;
+    CollectionPipelineContext ctx;
+    flusher->SetContext(ctx);
+    flusher->CreateMetricsRecordRef("name", "1");
+    flusher->Init(Json::Value(), tmp);
+    flusher->CommitMetricsRecordRef();
+
+    // make sure the pusher is woken up by the completion rather than the timeout
+    INT32_FLAG(flusher_runner_sending_cnt_wait_ms) = 60000;
+    auto runner = FlusherRunner::GetInstance();
+    runner->mHttpSendingCnt = AppConfig::GetInstance()->GetSendRequestGlobalConcurrency();
+
+    auto item = make_unique<SenderQueueItem>("content", 10, flusher.get(), flusher->GetQueueKey());
+    auto realItem = item.get();
+    flusher->PushToQueue(std::move(item));
+    auto res = async(launch::async, [&]() { return runner->PushToHttpSink(realItem); });
+    APSARA_TEST_EQUAL(future_status::timeout, res.wait_for(chrono::milliseconds(100)));
+    APSARA_TEST_TRUE(HttpSink::GetInstance()->mQueue.Empty());
+
+    runner->DecreaseHttpSendingCnt();
+    APSARA_TEST_EQUAL(future_status::ready, res.wait_for(chrono::seconds(5)));
+    APSARA_TEST_TRUE(res.get());
+    APSARA_TEST_FALSE(HttpSink::GetInstance()->mQueue.Empty());
+    APSARA_TEST_EQUAL(AppConfig::GetInstance()->GetSendRequestGlobalConcurrency(), runner->GetSendingBufferCount());
+
+    runner->mHttpSendingCnt = 0;
+    INT32_FLAG(flusher_runner_sending_cnt_wait_ms) = 100;
+}
+
 UNIT_TEST_CASE(FlusherRunnerUnittest, TestDispatch)
 UNIT_TEST_CASE(FlusherRunnerUnittest, TestPushToHttpSink)
+UNIT_TEST_CASE(FlusherRunnerUnittest, TestPushToHttpSinkWithLimit)
 
 } // namespace logtail
 
@@ -0,0 +1,122 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef APSARA_UNIT_TEST_MAIN
+#define APSARA_UNIT_TEST_MAIN
+#endif
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
+#include "runner/sink/http/HttpSink.h"
+#include "unittest/Unittest.h"
+#include "unittest/flusher/StandInReceiver.h"
+#include "unittest/plugin/PluginMock.h"
+
+DECLARE_FLAG_INT32(http_sink_event_loop_cnt);
+
+using namespace std;
+
+namespace logtail {
+
+// Measures the throughput of HttpSink with different counts of event loops, sending requests to several local
+// stand-in receivers, each of which is a different destination. At most kMaxSendingCnt requests are sent at the same
+// time, the same as the global send concurrency limit in FlusherRunner.
+class HttpSinkBenchmark : public ::testing::Test {
+public:
+    void TestSend();
+
+protected:
+    void SetUp() override {
+        for (size_t i = 0; i < kDestinationCnt; ++i) {
+            mReceivers.emplace_back(make_unique<StandInReceiver>());
+            APSARA_TEST_TRUE_FATAL(mReceivers.back()->Start());
+        }
+    }
+
+    void TearDown() override {
+        for (auto& receiver : mReceivers) {
+            receiver->Stop();
+        }
+        mReceivers.clear();
+    }
+
+private:
+    double Send(size_t loopCnt);
+
+    static const size_t kDestinationCnt = 8;
+    static const size_t kRequestCnt = 40000;
+    static const size_t kBodySize = 16 * 1024;
+    static const size_t kMaxSendingCnt = 256;
+
+    FlusherHttpMock mFlusher;
+    vector<unique_ptr<StandInReceiver>> mReceivers;
+};
+
+double HttpSinkBenchmark::Send(size_t loopCnt) {
+    INT32_FLAG(http_sink_event_loop_cnt) = loopCnt;
+    HttpSink sink;
+    APSARA_TEST_TRUE(sink.Init());
+
+    string body(kBodySize, 'a');
+    vector<unique_ptr<SenderQueueItem>> items;
+    items.reserve(kRequestCnt);
+    for (size_t i = 0; i < kRequestCnt; ++i) {
+        items.emplace_back(make_unique<SenderQueueItem>(string(), 0, &mFlusher, 0));
+    }
+    auto getDoneCnt = [&sink]() {
+        return sink.mOutSuccessfulItemsTotal->GetValue() + sink.mOutFailedItemsTotal->GetValue();
+    };
+
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < kRequestCnt; ++i) {
+        while (i - getDoneCnt() >= kMaxSendingCnt) {
+            this_thread::yield();
+        }
+        sink.AddRequest(make_unique<HttpSinkRequest>("POST",
+                                                     false,
+                                                     "127.0.0.1",
+                                                     mReceivers[i % kDestinationCnt]->GetPort(),
+                                                     "/",
+                                                     "",
+                                                     map<string, string>(),
+                                                     body,
+                                                     items[i].get()));
+    }
+    while (getDoneCnt() < kRequestCnt) {
+        this_thread::yield();
+    }
+    double elapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    APSARA_TEST_EQUAL(static_cast<uint64_t>(kRequestCnt), sink.mOutSuccessfulItemsTotal->GetValue());
+    sink.Stop();
+    return elapsed;
+}
+
+void HttpSinkBenchmark::TestSend() {
+    for (size_t loopCnt : {1, 2, 4}) {
+        double elapsed = Send(loopCnt);
+        cout << loopCnt << " event loop(s): " << kRequestCnt / elapsed << " requests/s, "
+             << kRequestCnt * kBodySize / elapsed / 1024 / 1024 << " MB/s" << endl;
+    }
+}
+
+UNIT_TEST_CASE(HttpSinkBenchmark, TestSend)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
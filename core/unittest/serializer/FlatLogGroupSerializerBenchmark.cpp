@@ -0,0 +1,96 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "collection_pipeline/serializer/FlatLogGroupSerializer.h"
+#include "runner/ProcessorRunner.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+// Compares the C++ half of handing log groups over to the Go pipeline, i.e. ProcessorRunner::Serialize building an
+// sls LogGroup against SerializeFlatLogGroup. The Go half is measured by BenchmarkDecodeFlatLogGroup in
+// pkg/protocol.
+class FlatLogGroupSerializerBenchmark : public ::testing::Test {
+public:
+    void TestSerialize();
+
+private:
+    PipelineEventGroup CreateGroup();
+
+    static const size_t kGroupCnt = 1000;
+    static const size_t kEventCntPerGroup = 100;
+    static const size_t kRoundCnt = 10;
+};
+
+PipelineEventGroup FlatLogGroupSerializerBenchmark::CreateGroup() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(string("host.name"), string("host-1"));
+    group.SetTag(string("log.file.path"), string("/var/log/app/access.log"));
+    for (size_t i = 0; i < kEventCntPerGroup; ++i) {
+        auto* event = group.AddLogEvent();
+        event->SetTimestamp(1700000000, 123);
+        event->SetContent(string("content"), "GET /api/v1/orders?id=" + to_string(i) + " 200 12ms");
+        event->SetContent(string("application"), string(i % 2 == 0 ? "order" : "payment"));
+        event->SetContent(string("method"), string("GET"));
+        event->SetContent(string("status"), string("200"));
+    }
+    return group;
+}
+
+void FlatLogGroupSerializerBenchmark::TestSerialize() {
+    vector<PipelineEventGroup> groups;
+    groups.reserve(kGroupCnt);
+    for (size_t i = 0; i < kGroupCnt; ++i) {
+        groups.emplace_back(CreateGroup());
+    }
+    auto* runner = ProcessorRunner::GetInstance();
+
+    size_t pbBytes = 0;
+    string res, errorMsg;
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        for (const auto& group : groups) {
+            APSARA_TEST_TRUE(runner->Serialize(group, true, "logstore", res, errorMsg));
+            pbBytes += res.size();
+        }
+    }
+    double pbElapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+    size_t flatBytes = 0;
+    start = chrono::high_resolution_clock::now();
+    for (size_t round = 0; round < kRoundCnt; ++round) {
+        for (const auto& group : groups) {
+            APSARA_TEST_TRUE(SerializeFlatLogGroup(group, true, "logstore", res, errorMsg));
+            flatBytes += res.size();
+        }
+    }
+    double flatElapsed = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+    size_t eventCnt = kRoundCnt * kGroupCnt * kEventCntPerGroup;
+    cout << "sls log group: " << eventCnt / pbElapsed << " events/s, " << pbBytes / kRoundCnt << " bytes" << endl;
+    cout << "flat log group: " << eventCnt / flatElapsed << " events/s, " << flatBytes / kRoundCnt << " bytes"
+         << endl;
+}
+
+UNIT_TEST_CASE(FlatLogGroupSerializerBenchmark, TestSerialize)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
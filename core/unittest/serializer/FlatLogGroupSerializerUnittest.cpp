@@ -0,0 +1,172 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utility>
+#include <vector>
+
+#include "collection_pipeline/serializer/FlatLogGroupSerializer.h"
+#include "common/Flags.h"
+#include "common/StringTools.h"
+#include "constants/TagConstants.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(max_send_log_group_size);
+
+using namespace std;
+
+namespace logtail {
+
+class FlatLogGroupSerializerUnittest : public ::testing::Test {
+public:
+    void TestSerializeLogs();
+    void TestSerializeEmptyGroup();
+    void TestSerializeWithoutNanosecond();
+    void TestUnsupportedEventType();
+    void TestExceedSizeLimit();
+    void TestSizeLimitOfProtobufSize();
+
+private:
+    static uint32_t ReadUint32(const string& data, size_t pos);
+    static string ReadString(const string& data, size_t pos);
+};
+
+uint32_t FlatLogGroupSerializerUnittest::ReadUint32(const string& data, size_t pos) {
+    const auto* p = reinterpret_cast<const uint8_t*>(data.data() + pos);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+string FlatLogGroupSerializerUnittest::ReadString(const string& data, size_t pos) {
+    uint32_t offset = ReadUint32(data, pos);
+    uint32_t len = ReadUint32(data, pos + 4);
+    if (offset + len > data.size()) {
+        return "<out of range>";
+    }
+    return data.substr(offset, len);
+}
+
+void FlatLogGroupSerializerUnittest::TestSerializeLogs() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(LOG_RESERVED_KEY_TOPIC, string("topic"));
+    group.SetTag(string("host"), string("host-1"));
+    {
+        auto* e = group.AddLogEvent();
+        e->SetTimestamp(1234567890, 1);
+        e->SetContent(string("key1"), string("value1"));
+        e->SetContent(string("key2"), string("value2"));
+        e->SetContent(string("deleted"), string("value"));
+        e->DelContent(string("deleted"));
+    }
+    {
+        auto* e = group.AddLogEvent();
+        e->SetTimestamp(1234567891);
+        e->SetContent(string("key3"), string(""));
+    }
+
+    string res, errorMsg;
+    APSARA_TEST_TRUE(SerializeFlatLogGroup(group, true, "logstore", res, errorMsg));
+    APSARA_TEST_EQUAL(kFlatLogGroupMagic, ReadUint32(res, 0));
+    APSARA_TEST_EQUAL(2U, ReadUint32(res, 4));
+    APSARA_TEST_EQUAL(3U, ReadUint32(res, 8));
+    APSARA_TEST_EQUAL(1U, ReadUint32(res, 12));
+    APSARA_TEST_EQUAL("logstore", ReadString(res, 16));
+    APSARA_TEST_EQUAL("topic", ReadString(res, 24));
+
+    size_t pos = kFlatLogGroupHeaderSize;
+    APSARA_TEST_EQUAL(1234567890U, ReadUint32(res, pos));
+    APSARA_TEST_EQUAL(1U, ReadUint32(res, pos + 4));
+    APSARA_TEST_EQUAL(kFlatLogFlagTimeNs, ReadUint32(res, pos + 8));
+    APSARA_TEST_EQUAL(2U, ReadUint32(res, pos + 12));
+    pos += kFlatLogSize;
+    APSARA_TEST_EQUAL(1234567891U, ReadUint32(res, pos));
+    APSARA_TEST_EQUAL(0U, ReadUint32(res, pos + 8));
+    APSARA_TEST_EQUAL(1U, ReadUint32(res, pos + 12));
+    pos += kFlatLogSize;
+
+    vector<pair<string, string>> expected
+        = {{"key1", "value1"}, {"key2", "value2"}, {"key3", ""}, {"host", "host-1"}};
+    for (const auto& kv : expected) {
+        APSARA_TEST_EQUAL(kv.first, ReadString(res, pos));
+        APSARA_TEST_EQUAL(kv.second, ReadString(res, pos + 8));
+        pos += kFlatFieldSize;
+    }
+    APSARA_TEST_EQUAL(res.size(), pos + string("logstoretopickey1value1key2value2key3hosthost-1").size());
+}
+
+void FlatLogGroupSerializerUnittest::TestSerializeEmptyGroup() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    string res, errorMsg;
+    APSARA_TEST_TRUE(SerializeFlatLogGroup(group, true, "", res, errorMsg));
+    APSARA_TEST_EQUAL(kFlatLogGroupHeaderSize, res.size());
+    APSARA_TEST_EQUAL(0U, ReadUint32(res, 4));
+    APSARA_TEST_EQUAL("", ReadString(res, 16));
+    APSARA_TEST_EQUAL("", ReadString(res, 24));
+}
+
+void FlatLogGroupSerializerUnittest::TestSerializeWithoutNanosecond() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    auto* e = group.AddLogEvent();
+    e->SetTimestamp(1234567890, 1);
+    string res, errorMsg;
+    APSARA_TEST_TRUE(SerializeFlatLogGroup(group, false, "logstore", res, errorMsg));
+    APSARA_TEST_EQUAL(0U, ReadUint32(res, kFlatLogGroupHeaderSize + 4));
+    APSARA_TEST_EQUAL(0U, ReadUint32(res, kFlatLogGroupHeaderSize + 8));
+}
+
+void FlatLogGroupSerializerUnittest::TestUnsupportedEventType() {
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.AddLogEvent();
+    group.AddMetricEvent();
+    string res, errorMsg;
+    APSARA_TEST_FALSE(SerializeFlatLogGroup(group, true, "logstore", res, errorMsg));
+    APSARA_TEST_EQUAL("unsupported event type in event group", errorMsg);
+}
+
+void FlatLogGroupSerializerUnittest::TestExceedSizeLimit() {
+    int32_t limit = INT32_FLAG(max_send_log_group_size);
+    INT32_FLAG(max_send_log_group_size) = 100;
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    auto* e = group.AddLogEvent();
+    e->SetContent(string("content"), string(100, 'a'));
+    string res, errorMsg;
+    APSARA_TEST_FALSE(SerializeFlatLogGroup(group, true, "logstore", res, errorMsg));
+    APSARA_TEST_TRUE(errorMsg.find("log group exceeds size limit") == 0);
+    INT32_FLAG(max_send_log_group_size) = limit;
+}
+
+void FlatLogGroupSerializerUnittest::TestSizeLimitOfProtobufSize() {
+    int32_t limit = INT32_FLAG(max_send_log_group_size);
+    INT32_FLAG(max_send_log_group_size) = 600;
+    // many short fields, about 520 bytes in protobuf but over 1000 bytes in the flat layout
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    auto* e = group.AddLogEvent();
+    e->SetTimestamp(1234567890);
+    for (int i = 10; i < 60; ++i) {
+        e->SetContent("k" + ToString(i), string("v"));
+    }
+    string res, errorMsg;
+    APSARA_TEST_TRUE(SerializeFlatLogGroup(group, true, "logstore", res, errorMsg));
+    APSARA_TEST_TRUE(res.size() > 1000U);
+    INT32_FLAG(max_send_log_group_size) = limit;
+}
+
+UNIT_TEST_CASE(FlatLogGroupSerializerUnittest, TestSerializeLogs)
+UNIT_TEST_CASE(FlatLogGroupSerializerUnittest, TestSerializeEmptyGroup)
+UNIT_TEST_CASE(FlatLogGroupSerializerUnittest, TestSerializeWithoutNanosecond)
+UNIT_TEST_CASE(FlatLogGroupSerializerUnittest, TestUnsupportedEventType)
+UNIT_TEST_CASE(FlatLogGroupSerializerUnittest, TestExceedSizeLimit)
+UNIT_TEST_CASE(FlatLogGroupSerializerUnittest, TestSizeLimitOfProtobufSize)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -27,6 +27,7 @@ namespace logtail {
 class JsonSerializerUnittest : public ::testing::Test {
 public:
     void TestSerializeEventGroup();
+    void TestSerializeEach();
 
 protected:
     static void SetUpTestCase() { sFlusher = make_unique<FlusherMock>(); }
@@ -280,6 +281,45 @@ void JsonSerializerUnittest::TestSerializeEventGroup() {
 }
 
 
+void JsonSerializerUnittest::TestSerializeEach() {
+    JsonEventGroupSerializer serializer(sFlusher.get());
+    const string line = "{\"__machine_uuid__\":\"machine_uuid\",\"__pack_id__\":\"pack_id\",\"__source__\":"
+                        "\"source\",\"__topic__\":\"topic\",\"__time__\":1234567890,\"key\":\"value\"}\n";
+    { // with empty event
+        string res = "prefix";
+        vector<size_t> offsets;
+        string errorMsg;
+        APSARA_TEST_TRUE(serializer.DoSerializeEach(createBatchedLogEvents(false, true, true), res, offsets, errorMsg));
+        APSARA_TEST_EQUAL("prefix" + line, res);
+        APSARA_TEST_EQUAL(2U, offsets.size());
+        APSARA_TEST_EQUAL(res.size(), offsets[0]);
+        // the empty event has an empty line
+        APSARA_TEST_EQUAL(res.size(), offsets[1]);
+    }
+    { // only empty event
+        string res;
+        vector<size_t> offsets;
+        string errorMsg;
+        APSARA_TEST_FALSE(
+            serializer.DoSerializeEach(createBatchedLogEvents(false, true, false), res, offsets, errorMsg));
+        APSARA_TEST_EQUAL("", res);
+        APSARA_TEST_EQUAL(1U, offsets.size());
+        APSARA_TEST_EQUAL(0U, offsets[0]);
+    }
+    { // same as DoSerialize
+        auto batch = createBatchedMetricEvents(false, 0, false, false, true);
+        string res;
+        vector<size_t> offsets;
+        string errorMsg;
+        APSARA_TEST_TRUE(serializer.DoSerializeEach(batch, res, offsets, errorMsg));
+        string expected;
+        APSARA_TEST_TRUE(serializer.DoSerialize(std::move(batch), expected, errorMsg));
+        APSARA_TEST_EQUAL(expected, res);
+        APSARA_TEST_EQUAL(1U, offsets.size());
+        APSARA_TEST_EQUAL(res.size(), offsets[0]);
+    }
+}
+
 BatchedEvents
 JsonSerializerUnittest::createBatchedLogEvents(bool enableNanosecond, bool withEmptyContent, bool withNonEmptyContent) {
     PipelineEventGroup group(make_shared<SourceBuffer>());
@@ -451,6 +491,7 @@ BatchedEvents JsonSerializerUnittest::createBatchedSpanEvents() {
 }
 
 UNIT_TEST_CASE(JsonSerializerUnittest, TestSerializeEventGroup)
+UNIT_TEST_CASE(JsonSerializerUnittest, TestSerializeEach)
 
 } // namespace logtail
 
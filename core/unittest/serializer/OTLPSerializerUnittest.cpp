@@ -0,0 +1,368 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include <map>
+
+#include "collection_pipeline/serializer/OTLPSerializer.h"
+#include "constants/Constants.h"
+#include "unittest/Unittest.h"
+#include "unittest/plugin/PluginMock.h"
+
+using namespace std;
+
+namespace logtail {
+
+// a minimal protobuf decoder to check the wire format, since opentelemetry protos are not compiled in
+struct ProtoField {
+    uint32_t mNumber = 0;
+    uint32_t mWireType = 0;
+    uint64_t mValue = 0;
+    string mBytes;
+};
+
+static bool ReadVarint(const string& data, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (uint32_t shift = 0; pos < data.size() && shift < 64; shift += 7) {
+        uint8_t b = static_cast<uint8_t>(data[pos++]);
+        value |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool Decode(const string& data, vector<ProtoField>& fields) {
+    fields.clear();
+    size_t pos = 0;
+    while (pos < data.size()) {
+        uint64_t tag = 0;
+        if (!ReadVarint(data, pos, tag)) {
+            return false;
+        }
+        ProtoField field;
+        field.mNumber = static_cast<uint32_t>(tag >> 3);
+        field.mWireType = static_cast<uint32_t>(tag & 0x7);
+        switch (field.mWireType) {
+            case 0:
+                if (!ReadVarint(data, pos, field.mValue)) {
+                    return false;
+                }
+                break;
+            case 1:
+                if (pos + 8 > data.size()) {
+                    return false;
+                }
+                memcpy(&field.mValue, data.data() + pos, 8);
+                pos += 8;
+                break;
+            case 2: {
+                uint64_t len = 0;
+                if (!ReadVarint(data, pos, len) || pos + len > data.size()) {
+                    return false;
+                }
+                field.mBytes = data.substr(pos, len);
+                pos += len;
+                break;
+            }
+            default:
+                return false;
+        }
+        fields.push_back(std::move(field));
+    }
+    return true;
+}
+
+static vector<ProtoField> DecodeOrEmpty(const string& data) {
+    vector<ProtoField> fields;
+    if (!Decode(data, fields)) {
+        fields.clear();
+    }
+    return fields;
+}
+
+static vector<ProtoField> GetFields(const vector<ProtoField>& fields, uint32_t number) {
+    vector<ProtoField> res;
+    for (const auto& field : fields) {
+        if (field.mNumber == number) {
+            res.push_back(field);
+        }
+    }
+    return res;
+}
+
+static ProtoField GetField(const vector<ProtoField>& fields, uint32_t number) {
+    auto res = GetFields(fields, number);
+    return res.empty() ? ProtoField() : res[0];
+}
+
+// repeated KeyValue with string values
+static map<string, string> GetAttributes(const vector<ProtoField>& fields, uint32_t number) {
+    map<string, string> res;
+    for (const auto& kv : GetFields(fields, number)) {
+        auto kvFields = DecodeOrEmpty(kv.mBytes);
+        res[GetField(kvFields, 1).mBytes] = GetField(DecodeOrEmpty(GetField(kvFields, 2).mBytes), 1).mBytes;
+    }
+    return res;
+}
+
+static double ToDouble(uint64_t bits) {
+    double value = 0;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+class OTLPSerializerUnittest : public ::testing::Test {
+public:
+    void TestSerializeLogs();
+    void TestSerializeMetrics();
+    void TestSerializeSpans();
+    void TestSerializeFailed();
+
+protected:
+    static void SetUpTestCase() { sFlusher = make_unique<FlusherMock>(); }
+
+    void SetUp() override {
+        mCtx.SetConfigName("test_config");
+        sFlusher->SetContext(mCtx);
+        sFlusher->CreateMetricsRecordRef(FlusherMock::sName, "1");
+        sFlusher->CommitMetricsRecordRef();
+    }
+
+private:
+    static BatchedEvents ToBatchedEvents(PipelineEventGroup& group) {
+        return BatchedEvents(std::move(group.MutableEvents()),
+                             std::move(group.GetSizedTags()),
+                             std::move(group.GetSourceBuffer()),
+                             group.GetMetadata(EventGroupMetaKey::SOURCE_ID),
+                             std::move(group.GetExactlyOnceCheckpoint()));
+    }
+    // returns the content of the only resource_xxx field of the request after checking its resource
+    static vector<ProtoField> CheckResource(const string& res);
+
+    static unique_ptr<FlusherMock> sFlusher;
+
+    CollectionPipelineContext mCtx;
+};
+
+unique_ptr<FlusherMock> OTLPSerializerUnittest::sFlusher;
+
+vector<ProtoField> OTLPSerializerUnittest::CheckResource(const string& res) {
+    auto request = DecodeOrEmpty(res);
+    APSARA_TEST_EQUAL(1U, request.size());
+    auto resourceData = DecodeOrEmpty(GetField(request, 1).mBytes);
+    auto attributes = GetAttributes(DecodeOrEmpty(GetField(resourceData, 1).mBytes), 1);
+    APSARA_TEST_EQUAL(1U, attributes.size());
+    APSARA_TEST_EQUAL("host-1", attributes["host.name"]);
+    return resourceData;
+}
+
+void OTLPSerializerUnittest::TestSerializeLogs() {
+    OTLPEventGroupSerializer serializer(sFlusher.get());
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(string("host.name"), string("host-1"));
+    {
+        auto e = group.AddLogEvent();
+        e->SetTimestamp(1234567890, 1);
+        e->SetLevel("INFO");
+        e->SetContent(DEFAULT_CONTENT_KEY, string("hello"));
+        e->SetContent(string("key"), string("value"));
+    }
+    {
+        auto e = group.AddRawEvent();
+        e->SetTimestamp(1234567891);
+        e->SetContent(string("raw content"));
+    }
+    string res, errorMsg;
+    APSARA_TEST_TRUE(serializer.DoSerialize(ToBatchedEvents(group), res, errorMsg));
+    APSARA_TEST_EQUAL("", errorMsg);
+
+    auto resourceLogs = CheckResource(res);
+    auto scopeLogs = DecodeOrEmpty(GetField(resourceLogs, 2).mBytes);
+    auto records = GetFields(scopeLogs, 2);
+    APSARA_TEST_EQUAL(2U, records.size());
+    {
+        auto record = DecodeOrEmpty(records[0].mBytes);
+        APSARA_TEST_EQUAL(1234567890000000001ULL, GetField(record, 1).mValue);
+        APSARA_TEST_EQUAL("INFO", GetField(record, 3).mBytes);
+        APSARA_TEST_EQUAL("hello", GetField(DecodeOrEmpty(GetField(record, 5).mBytes), 1).mBytes);
+        auto attributes = GetAttributes(record, 6);
+        APSARA_TEST_EQUAL(1U, attributes.size());
+        APSARA_TEST_EQUAL("value", attributes["key"]);
+    }
+    {
+        auto record = DecodeOrEmpty(records[1].mBytes);
+        APSARA_TEST_EQUAL(1234567891000000000ULL, GetField(record, 1).mValue);
+        APSARA_TEST_EQUAL(0U, GetFields(record, 3).size());
+        APSARA_TEST_EQUAL("raw content", GetField(DecodeOrEmpty(GetField(record, 5).mBytes), 1).mBytes);
+        APSARA_TEST_EQUAL(0U, GetFields(record, 6).size());
+    }
+}
+
+void OTLPSerializerUnittest::TestSerializeMetrics() {
+    OTLPEventGroupSerializer serializer(sFlusher.get());
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(string("host.name"), string("host-1"));
+    {
+        auto e = group.AddMetricEvent();
+        e->SetName("cpu");
+        e->SetTimestamp(1234567890);
+        e->SetTag(string("core"), string("0"));
+        e->SetValue<UntypedSingleValue>(0.5);
+    }
+    {
+        auto e = group.AddMetricEvent();
+        e->SetName("net");
+        e->SetTimestamp(1234567890);
+        UntypedMultiDoubleValues v({{"bytes", {UntypedValueMetricType::MetricTypeCounter, 10.0}},
+                                    {"speed", {UntypedValueMetricType::MetricTypeGauge, 2.0}}},
+                                   nullptr);
+        e->SetValue(v);
+    }
+    string res, errorMsg;
+    APSARA_TEST_TRUE(serializer.DoSerialize(ToBatchedEvents(group), res, errorMsg));
+
+    auto resourceMetrics = CheckResource(res);
+    auto metrics = GetFields(DecodeOrEmpty(GetField(resourceMetrics, 2).mBytes), 2);
+    APSARA_TEST_EQUAL(3U, metrics.size());
+    map<string, vector<ProtoField>> metricMap;
+    for (const auto& metric : metrics) {
+        auto fields = DecodeOrEmpty(metric.mBytes);
+        metricMap[GetField(fields, 1).mBytes] = fields;
+    }
+    {
+        const auto& metric = metricMap["cpu"];
+        auto gauge = DecodeOrEmpty(GetField(metric, 5).mBytes);
+        auto dataPoints = GetFields(gauge, 1);
+        APSARA_TEST_EQUAL(1U, dataPoints.size());
+        auto dataPoint = DecodeOrEmpty(dataPoints[0].mBytes);
+        APSARA_TEST_EQUAL(1234567890000000000ULL, GetField(dataPoint, 3).mValue);
+        APSARA_TEST_EQUAL(0.5, ToDouble(GetField(dataPoint, 4).mValue));
+        auto attributes = GetAttributes(dataPoint, 7);
+        APSARA_TEST_EQUAL(1U, attributes.size());
+        APSARA_TEST_EQUAL("0", attributes["core"]);
+    }
+    {
+        const auto& metric = metricMap["net_bytes"];
+        APSARA_TEST_EQUAL(0U, GetFields(metric, 5).size());
+        auto sum = DecodeOrEmpty(GetField(metric, 7).mBytes);
+        APSARA_TEST_EQUAL(2U, GetField(sum, 2).mValue);
+        APSARA_TEST_EQUAL(1U, GetField(sum, 3).mValue);
+        auto dataPoint = DecodeOrEmpty(GetField(sum, 1).mBytes);
+        APSARA_TEST_EQUAL(10.0, ToDouble(GetField(dataPoint, 4).mValue));
+    }
+    {
+        const auto& metric = metricMap["net_speed"];
+        auto gauge = DecodeOrEmpty(GetField(metric, 5).mBytes);
+        auto dataPoint = DecodeOrEmpty(GetField(gauge, 1).mBytes);
+        APSARA_TEST_EQUAL(2.0, ToDouble(GetField(dataPoint, 4).mValue));
+    }
+}
+
+void OTLPSerializerUnittest::TestSerializeSpans() {
+    OTLPEventGroupSerializer serializer(sFlusher.get());
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    group.SetTag(string("host.name"), string("host-1"));
+    for (size_t i = 0; i < 3; ++i) {
+        auto span = group.AddSpanEvent();
+        span->SetScopeTag(SpanEvent::OTLP_SCOPE_NAME, i < 2 ? string("scope-a") : string("scope-b"));
+        span->SetScopeTag(SpanEvent::OTLP_SCOPE_VERSION, string("1.0"));
+        span->SetTraceId("0102030405060708090a0b0c0d0e0f10");
+        span->SetSpanId("a1a2a3a4a5a6a7a8");
+        span->SetParentSpanId("not-hex");
+        span->SetName("span-" + to_string(i));
+        span->SetKind(SpanEvent::Kind::Client);
+        span->SetStatus(SpanEvent::StatusCode::Error);
+        span->SetStartTimeNs(1000);
+        span->SetEndTimeNs(2000);
+        span->SetTag(string("key"), string("value"));
+        auto innerEvent = span->AddEvent();
+        innerEvent->SetName("inner-event");
+        innerEvent->SetTimestampNs(1500);
+        auto link = span->AddLink();
+        link->SetTraceId("0102030405060708090a0b0c0d0e0f10");
+        link->SetSpanId("b1b2b3b4b5b6b7b8");
+    }
+    string res, errorMsg;
+    APSARA_TEST_TRUE(serializer.DoSerialize(ToBatchedEvents(group), res, errorMsg));
+
+    auto resourceSpans = CheckResource(res);
+    // adjacent spans with the same scope share one ScopeSpans
+    auto scopeSpansList = GetFields(resourceSpans, 2);
+    APSARA_TEST_EQUAL(2U, scopeSpansList.size());
+    {
+        auto scopeSpans = DecodeOrEmpty(scopeSpansList[0].mBytes);
+        auto scope = DecodeOrEmpty(GetField(scopeSpans, 1).mBytes);
+        APSARA_TEST_EQUAL("scope-a", GetField(scope, 1).mBytes);
+        APSARA_TEST_EQUAL("1.0", GetField(scope, 2).mBytes);
+        APSARA_TEST_EQUAL(2U, GetFields(scopeSpans, 2).size());
+    }
+    auto scopeSpans = DecodeOrEmpty(scopeSpansList[1].mBytes);
+    APSARA_TEST_EQUAL("scope-b", GetField(DecodeOrEmpty(GetField(scopeSpans, 1).mBytes), 1).mBytes);
+    auto spans = GetFields(scopeSpans, 2);
+    APSARA_TEST_EQUAL(1U, spans.size());
+    auto span = DecodeOrEmpty(spans[0].mBytes);
+    APSARA_TEST_EQUAL(string("\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f\x10", 16),
+                      GetField(span, 1).mBytes);
+    APSARA_TEST_EQUAL(string("\xa1\xa2\xa3\xa4\xa5\xa6\xa7\xa8", 8), GetField(span, 2).mBytes);
+    APSARA_TEST_EQUAL("not-hex", GetField(span, 4).mBytes);
+    APSARA_TEST_EQUAL("span-2", GetField(span, 5).mBytes);
+    APSARA_TEST_EQUAL(static_cast<uint64_t>(SpanEvent::Kind::Client), GetField(span, 6).mValue);
+    APSARA_TEST_EQUAL(1000U, GetField(span, 7).mValue);
+    APSARA_TEST_EQUAL(2000U, GetField(span, 8).mValue);
+    APSARA_TEST_EQUAL("value", GetAttributes(span, 9)["key"]);
+    {
+        auto innerEvent = DecodeOrEmpty(GetField(span, 11).mBytes);
+        APSARA_TEST_EQUAL(1500U, GetField(innerEvent, 1).mValue);
+        APSARA_TEST_EQUAL("inner-event", GetField(innerEvent, 2).mBytes);
+    }
+    {
+        auto link = DecodeOrEmpty(GetField(span, 13).mBytes);
+        APSARA_TEST_EQUAL(16U, GetField(link, 1).mBytes.size());
+        APSARA_TEST_EQUAL(string("\xb1\xb2\xb3\xb4\xb5\xb6\xb7\xb8", 8), GetField(link, 2).mBytes);
+    }
+    auto status = DecodeOrEmpty(GetField(span, 15).mBytes);
+    APSARA_TEST_EQUAL(static_cast<uint64_t>(SpanEvent::StatusCode::Error), GetField(status, 3).mValue);
+}
+
+void OTLPSerializerUnittest::TestSerializeFailed() {
+    OTLPEventGroupSerializer serializer(sFlusher.get());
+    {
+        // empty group
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        string res, errorMsg;
+        APSARA_TEST_FALSE(serializer.DoSerialize(ToBatchedEvents(group), res, errorMsg));
+        APSARA_TEST_EQUAL("empty event group", errorMsg);
+    }
+    {
+        // metric event without value
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        auto e = group.AddMetricEvent();
+        e->SetName("cpu");
+        string res, errorMsg;
+        APSARA_TEST_FALSE(serializer.DoSerialize(ToBatchedEvents(group), res, errorMsg));
+        APSARA_TEST_EQUAL("no event can be serialized", errorMsg);
+    }
+}
+
+UNIT_TEST_CASE(OTLPSerializerUnittest, TestSerializeLogs)
+UNIT_TEST_CASE(OTLPSerializerUnittest, TestSerializeMetrics)
+UNIT_TEST_CASE(OTLPSerializerUnittest, TestSerializeSpans)
+UNIT_TEST_CASE(OTLPSerializerUnittest, TestSerializeFailed)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,141 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package protocol
+
+import (
+	"encoding/binary"
+	"errors"
+	"unsafe"
+)
+
+// The flat layout of a log group passed by core, see core/collection_pipeline/serializer/FlatLogGroupSerializer.h.
+const (
+	flatLogGroupMagic      = 0x31474C46 // "FLG1"
+	flatLogGroupHeaderSize = 36
+	flatLogSize            = 16
+	flatFieldSize          = 16
+	flatLogFlagTimeNs      = 1
+)
+
+var errInvalidFlatLogGroup = errors.New("invalid flat log group")
+
+type flatLogGroupReader struct {
+	buf []byte
+}
+
+func (r *flatLogGroupReader) uint32(pos int) uint32 {
+	return binary.LittleEndian.Uint32(r.buf[pos:])
+}
+
+// string returns a string sharing memory with the buffer.
+func (r *flatLogGroupReader) string(pos int) (string, error) {
+	offset, length := uint64(r.uint32(pos)), uint64(r.uint32(pos+4))
+	if offset+length > uint64(len(r.buf)) {
+		return "", errInvalidFlatLogGroup
+	}
+	if length == 0 {
+		return "", nil
+	}
+	return unsafe.String(&r.buf[offset], int(length)), nil //nolint:gosec
+}
+
+func (r *flatLogGroupReader) field(pos int) (string, string, error) {
+	key, err := r.string(pos)
+	if err != nil {
+		return "", "", err
+	}
+	value, err := r.string(pos + 8)
+	return key, value, err
+}
+
+// DecodeFlatLogGroup decodes a log group in the flat layout. data is copied once and all strings of the log group
+// share the copy, so data can be released after the function returns. Logs, contents and tags are allocated in
+// batches instead of one by one.
+//
+// As every key and value points into the same copy, retaining any one of them, e.g. as a map key or in a cache,
+// keeps the whole log group buffer alive. Plugins that keep strings beyond the processing of the log group should
+// copy them with util.StringDeepCopy or strings.Clone.
+func DecodeFlatLogGroup(data []byte) (*LogGroup, error) {
+	if len(data) < flatLogGroupHeaderSize || binary.LittleEndian.Uint32(data) != flatLogGroupMagic {
+		return nil, errInvalidFlatLogGroup
+	}
+	logCnt := uint64(binary.LittleEndian.Uint32(data[4:]))
+	contentCnt := uint64(binary.LittleEndian.Uint32(data[8:]))
+	tagCnt := uint64(binary.LittleEndian.Uint32(data[12:]))
+	if flatLogGroupHeaderSize+logCnt*flatLogSize+(contentCnt+tagCnt)*flatFieldSize > uint64(len(data)) {
+		return nil, errInvalidFlatLogGroup
+	}
+
+	r := &flatLogGroupReader{buf: make([]byte, len(data))}
+	copy(r.buf, data)
+
+	var err error
+	logGroup := &LogGroup{}
+	if logGroup.Category, err = r.string(16); err != nil {
+		return nil, err
+	}
+	if logGroup.Topic, err = r.string(24); err != nil {
+		return nil, err
+	}
+
+	logs := make([]Log, logCnt)
+	timeNs := make([]uint32, logCnt)
+	contents := make([]Log_Content, contentCnt)
+	contentPtrs := make([]*Log_Content, contentCnt)
+	logGroup.Logs = make([]*Log, logCnt)
+	logPos := flatLogGroupHeaderSize
+	fieldPos := flatLogGroupHeaderSize + int(logCnt)*flatLogSize
+	next := 0
+	for i := range logs {
+		log := &logs[i]
+		log.Time = r.uint32(logPos)
+		if r.uint32(logPos+8)&flatLogFlagTimeNs != 0 {
+			timeNs[i] = r.uint32(logPos + 4)
+			log.TimeNs = &timeNs[i]
+		}
+		cnt := int(r.uint32(logPos + 12))
+		if cnt > len(contents)-next {
+			return nil, errInvalidFlatLogGroup
+		}
+		for j := next; j < next+cnt; j++ {
+			if contents[j].Key, contents[j].Value, err = r.field(fieldPos); err != nil {
+				return nil, err
+			}
+			contentPtrs[j] = &contents[j]
+			fieldPos += flatFieldSize
+		}
+		// limit the capacity so that appending to the contents of one log does not overwrite the next one
+		log.Contents = contentPtrs[next : next+cnt : next+cnt]
+		next += cnt
+		logGroup.Logs[i] = log
+		logPos += flatLogSize
+	}
+	if next != len(contents) {
+		return nil, errInvalidFlatLogGroup
+	}
+
+	if tagCnt > 0 {
+		tags := make([]LogTag, tagCnt)
+		logGroup.LogTags = make([]*LogTag, tagCnt)
+		for i := range tags {
+			if tags[i].Key, tags[i].Value, err = r.field(fieldPos); err != nil {
+				return nil, err
+			}
+			logGroup.LogTags[i] = &tags[i]
+			fieldPos += flatFieldSize
+		}
+	}
+	return logGroup, nil
+}
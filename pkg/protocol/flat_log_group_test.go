@@ -0,0 +1,199 @@
+// Copyright 2025 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package protocol
+
+import (
+	"encoding/binary"
+	"strconv"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+// encodeFlatLogGroup is the same as SerializeFlatLogGroup in core.
+func encodeFlatLogGroup(logGroup *LogGroup) []byte {
+	contentCnt, strSize := 0, len(logGroup.Category)+len(logGroup.Topic)
+	for _, log := range logGroup.Logs {
+		contentCnt += len(log.Contents)
+		for _, c := range log.Contents {
+			strSize += len(c.Key) + len(c.Value)
+		}
+	}
+	for _, tag := range logGroup.LogTags {
+		strSize += len(tag.Key) + len(tag.Value)
+	}
+	strOffset := flatLogGroupHeaderSize + len(logGroup.Logs)*flatLogSize + (contentCnt+len(logGroup.LogTags))*flatFieldSize
+	buf := make([]byte, 0, strOffset+strSize)
+	strs := make([]byte, 0, strSize)
+	putUint32 := func(v uint32) {
+		buf = binary.LittleEndian.AppendUint32(buf, v)
+	}
+	putString := func(s string) {
+		putUint32(uint32(strOffset + len(strs)))
+		putUint32(uint32(len(s)))
+		strs = append(strs, s...)
+	}
+
+	putUint32(flatLogGroupMagic)
+	putUint32(uint32(len(logGroup.Logs)))
+	putUint32(uint32(contentCnt))
+	putUint32(uint32(len(logGroup.LogTags)))
+	putString(logGroup.Category)
+	putString(logGroup.Topic)
+	putUint32(0)
+	for _, log := range logGroup.Logs {
+		putUint32(log.Time)
+		if log.TimeNs != nil {
+			putUint32(*log.TimeNs)
+			putUint32(flatLogFlagTimeNs)
+		} else {
+			putUint32(0)
+			putUint32(0)
+		}
+		putUint32(uint32(len(log.Contents)))
+	}
+	for _, log := range logGroup.Logs {
+		for _, c := range log.Contents {
+			putString(c.Key)
+			putString(c.Value)
+		}
+	}
+	for _, tag := range logGroup.LogTags {
+		putString(tag.Key)
+		putString(tag.Value)
+	}
+	return append(buf, strs...)
+}
+
+func newTestLogGroup(logCnt int) *LogGroup {
+	logGroup := &LogGroup{
+		Category: "logstore",
+		LogTags: []*LogTag{
+			{Key: "host.name", Value: "host-1"},
+			{Key: "log.file.path", Value: "/var/log/app/access.log"},
+		},
+	}
+	for i := 0; i < logCnt; i++ {
+		log := &Log{
+			Contents: []*Log_Content{
+				{Key: "content", Value: "GET /api/v1/orders?id=" + strconv.Itoa(i) + " 200 12ms"},
+				{Key: "application", Value: "order"},
+				{Key: "method", Value: "GET"},
+				{Key: "status", Value: "200"},
+			},
+		}
+		SetLogTimeWithNano(log, 1700000000, 123)
+		logGroup.Logs = append(logGroup.Logs, log)
+	}
+	return logGroup
+}
+
+func TestDecodeFlatLogGroup(t *testing.T) {
+	expected := newTestLogGroup(3)
+	expected.Topic = "topic"
+	expected.Logs[1].TimeNs = nil
+	expected.Logs[2].Contents = nil
+	data := encodeFlatLogGroup(expected)
+
+	logGroup, err := DecodeFlatLogGroup(data)
+	require.NoError(t, err)
+	// the log group must not refer to the input
+	for i := range data {
+		data[i] = 0
+	}
+	assert.Equal(t, expected.Category, logGroup.Category)
+	assert.Equal(t, expected.Topic, logGroup.Topic)
+	assert.Equal(t, expected.LogTags, logGroup.LogTags)
+	require.Len(t, logGroup.Logs, 3)
+	assert.Equal(t, expected.Logs[0], logGroup.Logs[0])
+	assert.Equal(t, expected.Logs[1], logGroup.Logs[1])
+	assert.Equal(t, expected.Logs[2].Time, logGroup.Logs[2].Time)
+	assert.Empty(t, logGroup.Logs[2].Contents)
+
+	// appending to the contents of one log leaves the others untouched
+	logGroup.Logs[0].Contents = append(logGroup.Logs[0].Contents, &Log_Content{Key: "k", Value: "v"})
+	assert.Equal(t, expected.Logs[1].Contents, logGroup.Logs[1].Contents)
+}
+
+func TestDecodeEmptyFlatLogGroup(t *testing.T) {
+	logGroup, err := DecodeFlatLogGroup(encodeFlatLogGroup(&LogGroup{}))
+	require.NoError(t, err)
+	assert.Empty(t, logGroup.Logs)
+	assert.Empty(t, logGroup.LogTags)
+	assert.Empty(t, logGroup.Category)
+}
+
+func TestDecodeInvalidFlatLogGroup(t *testing.T) {
+	data := encodeFlatLogGroup(newTestLogGroup(2))
+
+	_, err := DecodeFlatLogGroup(data[:flatLogGroupHeaderSize-1])
+	assert.Error(t, err)
+
+	// not flat log group
+	invalid := append([]byte{}, data...)
+	invalid[0] = 0
+	_, err = DecodeFlatLogGroup(invalid)
+	assert.Error(t, err)
+
+	// truncated
+	_, err = DecodeFlatLogGroup(data[:len(data)-1])
+	assert.Error(t, err)
+
+	// too many logs
+	invalid = append([]byte{}, data...)
+	binary.LittleEndian.PutUint32(invalid[4:], 1<<20)
+	_, err = DecodeFlatLogGroup(invalid)
+	assert.Error(t, err)
+
+	// content count of logs mismatches that of the group
+	invalid = append([]byte{}, data...)
+	binary.LittleEndian.PutUint32(invalid[flatLogGroupHeaderSize+12:], 3)
+	_, err = DecodeFlatLogGroup(invalid)
+	assert.Error(t, err)
+	binary.LittleEndian.PutUint32(invalid[flatLogGroupHeaderSize+12:], 5)
+	_, err = DecodeFlatLogGroup(invalid)
+	assert.Error(t, err)
+}
+
+const benchmarkLogCnt = 100
+
+// BenchmarkUnmarshalLogGroup is the Go half of the hop from core to Go pipelines in protobuf.
+func BenchmarkUnmarshalLogGroup(b *testing.B) {
+	data, err := newTestLogGroup(benchmarkLogCnt).Marshal()
+	require.NoError(b, err)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		logGroup := &LogGroup{}
+		if err := logGroup.Unmarshal(data); err != nil {
+			b.Fatal(err)
+		}
+	}
+	b.ReportMetric(float64(b.N*benchmarkLogCnt)/b.Elapsed().Seconds(), "events/s")
+}
+
+// BenchmarkDecodeFlatLogGroup is the Go half of the hop from core to Go pipelines in the flat layout.
+func BenchmarkDecodeFlatLogGroup(b *testing.B) {
+	data := encodeFlatLogGroup(newTestLogGroup(benchmarkLogCnt))
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if _, err := DecodeFlatLogGroup(data); err != nil {
+			b.Fatal(err)
+		}
+	}
+	b.ReportMetric(float64(b.N*benchmarkLogCnt)/b.Elapsed().Seconds(), "events/s")
+}
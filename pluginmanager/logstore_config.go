@@ -273,6 +273,23 @@ func (lc *LogstoreConfig) ProcessLogGroup(logByte []byte, packID string) int {
 	return 0
 }
 
+// ProcessFlatLogGroup is the same as ProcessLogGroup, except that the log group is in the flat layout, which is
+// decoded without allocating for each field. All strings of the log group share one buffer, see DecodeFlatLogGroup
+// for what this means for plugins retaining them.
+func (lc *LogstoreConfig) ProcessFlatLogGroup(logByte []byte, packID string) int {
+	logGroup, err := protocol.DecodeFlatLogGroup(logByte)
+	if err != nil {
+		logger.Error(lc.Context.GetRuntimeContext(), "WRONG_PROTOBUF_ALARM",
+			"cannot process flat log group passed by core, err", err)
+		return -1
+	}
+	lc.PluginRunner.ReceiveLogGroup(pipeline.LogGroupWithContext{
+		LogGroup: logGroup,
+		Context:  map[string]interface{}{ctxKeySource: packID}},
+	)
+	return 0
+}
+
 func hasDockerStdoutInput(plugins map[string]interface{}) bool {
 	inputs, exists := plugins["inputs"]
 	if !exists {